@@ -319,7 +319,28 @@ static struct net_pkt *prepare_non_vlan_pkt(struct eth_context *ctx,
 	return pkt;
 }
 
-static int read_data(struct eth_context *ctx, int fd)
+static void flush_burst(struct net_if *iface, sys_slist_t *burst)
+{
+	struct net_pkt *pkt;
+	sys_snode_t *node;
+
+	if (sys_slist_is_empty(burst)) {
+		return;
+	}
+
+	if (net_recv_data_list(iface, burst) < 0) {
+		while ((node = sys_slist_get(burst)) != NULL) {
+			pkt = CONTAINER_OF(node, struct net_pkt, burst);
+			net_pkt_unref(pkt);
+		}
+	}
+}
+
+/* Add the next frame to the burst of frames received by the same
+ * interface, the burst is passed up first if the frame is for another one.
+ */
+static int read_data(struct eth_context *ctx, int fd, sys_slist_t *burst,
+		     struct net_if **burst_iface)
 {
 	uint16_t vlan_tag = NET_VLAN_TAG_UNSPEC;
 	struct net_if *iface;
@@ -363,23 +384,46 @@ static int read_data(struct eth_context *ctx, int fd)
 
 	update_gptp(iface, pkt, false);
 
-	if (net_recv_data(iface, pkt) < 0) {
-		net_pkt_unref(pkt);
+	if (iface != *burst_iface) {
+		flush_burst(*burst_iface, burst);
+		*burst_iface = iface;
 	}
 
+	sys_slist_append(burst, &pkt->burst);
+
 	return 0;
 }
 
 static void eth_rx(struct eth_context *ctx)
 {
+	struct net_if *iface = NULL;
+	sys_slist_t burst;
+	int count;
+
 	LOG_DBG("Starting ZETH RX thread");
 
+	sys_slist_init(&burst);
+
 	while (1) {
 		if (net_if_is_up(ctx->iface)) {
+			count = 0;
+
+			/* Pass the frames up in bursts so that the RX thread
+			 * is woken up once per burst instead of once per frame.
+			 */
 			while (!eth_wait_data(ctx->dev_fd)) {
-				read_data(ctx, ctx->dev_fd);
+				read_data(ctx, ctx->dev_fd, &burst, &iface);
+
+				if (++count < CONFIG_ETH_NATIVE_POSIX_RX_BURST) {
+					continue;
+				}
+
+				flush_burst(iface, &burst);
+				count = 0;
 				k_yield();
 			}
+
+			flush_burst(iface, &burst);
 		}
 
 		if (IS_ENABLED(CONFIG_NET_GPTP)) {
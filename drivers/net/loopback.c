@@ -24,9 +24,21 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
 #include <net/dummy.h>
 
+struct loopback_context {
+	/* Copies of the sent packets held back while more packets follow
+	 * them, so that they are handed to the receiving side as one burst.
+	 */
+	sys_slist_t pending;
+	struct k_spinlock lock;
+};
+
+static struct loopback_context loopback_data;
+
 int loopback_dev_init(const struct device *dev)
 {
-	ARG_UNUSED(dev);
+	struct loopback_context *ctx = dev->data;
+
+	sys_slist_init(&ctx->pending);
 
 	return 0;
 }
@@ -38,12 +50,39 @@ static void loopback_init(struct net_if *iface)
 			     NET_LINK_DUMMY);
 }
 
+static void loopback_flush(struct net_if *iface)
+{
+	struct loopback_context *ctx = net_if_get_device(iface)->data;
+	k_spinlock_key_t key;
+	struct net_pkt *pkt;
+	sys_snode_t *node;
+	sys_slist_t list;
+
+	key = k_spin_lock(&ctx->lock);
+	list = ctx->pending;
+	sys_slist_init(&ctx->pending);
+	k_spin_unlock(&ctx->lock, key);
+
+	if (sys_slist_is_empty(&list)) {
+		return;
+	}
+
+	if (net_recv_data_list(iface, &list) < 0) {
+		LOG_ERR("Data receive failed.");
+
+		while ((node = sys_slist_get(&list)) != NULL) {
+			pkt = CONTAINER_OF(node, struct net_pkt, burst);
+			net_pkt_unref(pkt);
+		}
+	}
+}
+
 static int loopback_send(const struct device *dev, struct net_pkt *pkt)
 {
+	struct loopback_context *ctx = dev->data;
+	k_spinlock_key_t key;
 	struct net_pkt *cloned;
-	int res;
-
-	ARG_UNUSED(dev);
+	int res = 0;
 
 	if (!pkt->frags) {
 		LOG_ERR("No data to send");
@@ -76,17 +115,20 @@ static int loopback_send(const struct device *dev, struct net_pkt *pkt)
 	 * the packet is reference counted in various stages of sending.
 	 */
 	cloned = net_pkt_clone(pkt, K_MSEC(100));
-	if (!cloned) {
+	if (cloned) {
+		key = k_spin_lock(&ctx->lock);
+		sys_slist_append(&ctx->pending, &cloned->burst);
+		k_spin_unlock(&ctx->lock, key);
+	} else {
 		res = -ENOMEM;
-		goto out;
 	}
 
-	res = net_recv_data(net_pkt_iface(cloned), cloned);
-	if (res < 0) {
-		LOG_ERR("Data receive failed.");
+	if (net_pkt_tx_more(pkt)) {
+		return res;
 	}
 
-out:
+	loopback_flush(net_pkt_iface(pkt));
+
 	/* Let the receiving thread run now */
 	k_yield();
 
@@ -95,12 +137,13 @@ out:
 
 static struct dummy_api loopback_api = {
 	.iface_api.init = loopback_init,
+	.iface_api.tx_flush = loopback_flush,
 
 	.send = loopback_send,
 };
 
 NET_DEVICE_INIT(loopback, "lo",
-		loopback_dev_init, NULL, NULL, NULL,
+		loopback_dev_init, NULL, &loopback_data, NULL,
 		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
 		&loopback_api, DUMMY_L2,
 		NET_L2_GET_CTX_TYPE(DUMMY_L2), 536);
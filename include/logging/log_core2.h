@@ -44,6 +44,14 @@ struct log_msg2 *z_log_msg2_alloc(uint32_t wlen);
  */
 void z_log_msg2_commit(struct log_msg2 *msg);
 
+/** @brief Discard allocated log message instead of committing it.
+ *
+ * Message descriptor must be set since it determines message length.
+ *
+ * @param msg Message.
+ */
+void z_log_msg2_discard(struct log_msg2 *msg);
+
 /** @brief Get pending log message.
  *
  * @param[out] len Message length in bytes is written is @p len is not null.
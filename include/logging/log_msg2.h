@@ -57,6 +57,9 @@ struct log_msg2_desc {
 	uint32_t reserved:1;
 };
 
+/* Maximum package length which fits in the message descriptor. */
+#define Z_LOG_MSG2_MAX_PACKAGE_LEN BIT_MASK(10)
+
 struct log_msg2_trace_hdr {
 	LOG_MSG2_GENERIC_HDR;
 	uint32_t evt_id:5;
@@ -208,6 +211,15 @@ enum z_log_msg2_mode {
 #define Z_LOG_MSG2_ALIGN_OFFSET \
 	sizeof(struct log_msg2_hdr)
 
+/* Messages with string arguments can be statically packaged only if string
+ * locations can be recorded in the package at compile time.
+ */
+#define Z_LOG_MSG2_STATIC_STRINGS \
+	(IS_ENABLED(CONFIG_LOG2_STATIC_PACKAGE_STRINGS) && Z_C_GENERIC)
+
+#define Z_LOG_MSG2_PACKAGE_FLAGS \
+	(Z_LOG_MSG2_STATIC_STRINGS ? CBPRINTF_PACKAGE_ADD_RW_STR_POS : 0)
+
 #define Z_LOG_MSG2_LEN(pkg_len, data_len) \
 	(sizeof(struct log_msg2_hdr) + pkg_len + (data_len))
 
@@ -240,14 +252,14 @@ do { \
 		_plen = 0; \
 	} else { \
 		CBPRINTF_STATIC_PACKAGE(NULL, 0, _plen, Z_LOG_MSG2_ALIGN_OFFSET, \
-					0, __VA_ARGS__); \
+					Z_LOG_MSG2_PACKAGE_FLAGS, __VA_ARGS__); \
 	} \
 	struct log_msg2 *_msg; \
 	Z_LOG_MSG2_ON_STACK_ALLOC(_msg, Z_LOG_MSG2_LEN(_plen, 0)); \
 	if (_plen) { \
 		CBPRINTF_STATIC_PACKAGE(_msg->data, _plen, \
 					_plen, Z_LOG_MSG2_ALIGN_OFFSET, \
-					0, __VA_ARGS__);\
+					Z_LOG_MSG2_PACKAGE_FLAGS, __VA_ARGS__);\
 	} \
 	struct log_msg2_desc _desc = \
 		Z_LOG_MSG_DESC_INITIALIZER(_domain_id, _level, \
@@ -338,7 +350,10 @@ do { \
  *   it contains data or string arguments which are string pointers.
  * - at compile time message size is determined, string package is created on
  *   stack, message is created in function call. String package can only be
- *   created on stack if it does not contain unexpected pointers to strings.
+ *   created on stack if it does not contain unexpected pointers to strings,
+ *   unless CONFIG_LOG2_STATIC_PACKAGE_STRINGS is enabled in which case
+ *   locations of string arguments are recorded in the package and strings
+ *   are copied when the message is created.
  * - string package is created at runtime. This mode has no limitations but
  *   it is significantly slower.
  *
@@ -397,13 +412,15 @@ do { \
 			  _level, _data, _dlen, ...) \
 do { \
 	Z_LOG_MSG2_STR_VAR(_fmt, ##__VA_ARGS__); \
-	if (CBPRINTF_MUST_RUNTIME_PACKAGE(_cstr_cnt, __VA_ARGS__)) { \
+	bool _has_strs = CBPRINTF_MUST_RUNTIME_PACKAGE(_cstr_cnt, __VA_ARGS__); \
+	if (_has_strs && !Z_LOG_MSG2_STATIC_STRINGS) { \
 		LOG_MSG2_DBG("create runtime message\n");\
 		z_log_msg2_runtime_create(_domain_id, (void *)_source, \
 					  _level, (uint8_t *)_data, _dlen,\
 					  Z_LOG_FMT_ARGS(_fmt, ##__VA_ARGS__));\
 		_mode = Z_LOG_MSG2_MODE_RUNTIME; \
-	} else if (IS_ENABLED(CONFIG_LOG_SPEED) && _try_0cpy && ((_dlen) == 0)) {\
+	} else if (IS_ENABLED(CONFIG_LOG_SPEED) && _try_0cpy && \
+		   ((_dlen) == 0) && !_has_strs) {\
 		LOG_MSG2_DBG("create zero-copy message\n");\
 		Z_LOG_MSG2_SIMPLE_CREATE(_domain_id, _source, \
 					_level, Z_LOG_FMT_ARGS(_fmt, ##__VA_ARGS__)); \
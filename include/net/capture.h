@@ -195,22 +195,33 @@ static inline int net_capture_send(const struct device *dev,
 
 /** @cond INTERNAL_HIDDEN */
 
+#if defined(CONFIG_NET_CAPTURE)
+void net_capture_tunnel_pkt(struct net_if *iface, struct net_pkt *pkt);
+#endif
+
+#if defined(CONFIG_NET_CAPTURE_RING)
+void net_capture_ring_pkt(struct net_if *iface, struct net_pkt *pkt);
+#endif
+
 /**
  * @brief Check if the network packet needs to be captured or not.
- *        This is called for every network packet being sent.
+ *        This is called for every network packet being sent or received.
  *
  * @param iface Network interface the packet is being sent
  * @param pkt The network packet that is sent
  */
-#if defined(CONFIG_NET_CAPTURE)
-void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt);
-#else
 static inline void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt)
 {
+#if defined(CONFIG_NET_CAPTURE_RING)
+	/* Before the tunnel, which marks the packet as captured */
+	net_capture_ring_pkt(iface, pkt);
+#endif
+#if defined(CONFIG_NET_CAPTURE)
+	net_capture_tunnel_pkt(iface, pkt);
+#endif
 	ARG_UNUSED(iface);
 	ARG_UNUSED(pkt);
 }
-#endif
 
 struct net_capture_info {
 	const struct device *capture_dev;
@@ -252,6 +263,126 @@ static inline void net_capture_foreach(net_capture_cb_t cb, void *user_data)
 
 /** @endcond */
 
+/**
+ * @brief Statistics of the in-memory capture ring buffer.
+ */
+struct net_capture_ring_stats {
+	/** Packets stored in the ring since it was cleared */
+	uint32_t captured;
+
+	/** Packets that did not match the filter */
+	uint32_t filtered;
+
+	/** Oldest packets overwritten by newer ones */
+	uint32_t overwritten;
+
+	/** Packets currently in the ring */
+	uint32_t count;
+
+	/** Bytes of the ring in use */
+	uint32_t used;
+
+	/** Ring size in bytes */
+	uint32_t size;
+
+	/** Number of bytes stored of each packet at most */
+	uint16_t snaplen;
+
+	/** Is capturing to the ring enabled */
+	bool is_enabled;
+};
+
+/**
+ * @typedef net_capture_write_cb_t
+ * @brief Callback receiving the exported pcapng data.
+ *
+ * @param data Next bytes of the pcapng stream.
+ * @param len Number of bytes.
+ * @param user_data A valid pointer to user data or NULL
+ *
+ * @return 0 to continue, <0 to stop the export with this error.
+ */
+typedef int (*net_capture_write_cb_t)(const void *data, size_t len,
+				      void *user_data);
+
+#if defined(CONFIG_NET_CAPTURE_RING) || defined(__DOXYGEN__)
+/**
+ * @brief Start capturing network packets to the in-memory ring buffer.
+ *
+ * @details The packets sent and received by the interface are copied to
+ *          the ring, up to snaplen bytes of each, if they match the filter
+ *          set by net_capture_ring_filter(). When the ring is full, the
+ *          oldest packets are overwritten.
+ *
+ * @param iface Network interface to capture, NULL to capture all of them.
+ * @param snaplen Number of bytes to store of each packet at most, 0 for
+ *        CONFIG_NET_CAPTURE_RING_SNAPLEN.
+ *
+ * @return 0 if ok, -EINVAL if snaplen does not fit the ring.
+ */
+int net_capture_ring_start(struct net_if *iface, uint16_t snaplen);
+
+/**
+ * @brief Stop capturing network packets to the ring buffer. The captured
+ *        packets are kept until net_capture_ring_clear() is called.
+ */
+void net_capture_ring_stop(void);
+
+/**
+ * @brief Drop the packets in the ring buffer and reset its statistics.
+ */
+void net_capture_ring_clear(void);
+
+/**
+ * @brief Set the filter selecting the packets to capture.
+ *
+ * @details The filter is a subset of the pcap filter syntax. Primitives
+ *          are "ip", "ip6", "arp", "tcp", "udp", "icmp" and "icmp6",
+ *          "[src|dst] port <port>", "[src|dst] host <address>" and
+ *          "[src|dst] net <address>/<prefix length>". A primitive can be
+ *          negated with "not", and primitives are combined with "and" and
+ *          "or", "and" binding tighter. For example
+ *          "udp and dst port 53 or tcp and not port 22".
+ *
+ * @param expr Filter, NULL or empty to capture all the packets.
+ *
+ * @return 0 if ok, -EINVAL if the filter cannot be parsed, -ENOMEM if it
+ *         has more than CONFIG_NET_CAPTURE_RING_FILTER_TERMS primitives.
+ */
+int net_capture_ring_filter(const char *expr);
+
+/**
+ * @brief Get the statistics of the ring buffer.
+ *
+ * @param stats Statistics, filled by the function.
+ */
+void net_capture_ring_stats(struct net_capture_ring_stats *stats);
+
+/**
+ * @brief Export the captured packets in pcapng format.
+ *
+ * @details Capturing is paused during the export. The stream has one
+ *          interface description block per network interface, the
+ *          interface id of a packet being its interface index minus one.
+ *
+ * @param cb Callback receiving the data, called several times.
+ * @param user_data User supplied data
+ *
+ * @return Number of packets exported, <0 if the callback failed.
+ */
+int net_capture_ring_export(net_capture_write_cb_t cb, void *user_data);
+
+/**
+ * @brief Save the captured packets to a pcapng file.
+ *
+ * @param path File name, an existing file is replaced.
+ *
+ * @return Number of packets saved, <0 if the file could not be written,
+ *         -ENOTSUP without CONFIG_FILE_SYSTEM.
+ */
+int net_capture_ring_save(const char *path);
+#endif /* CONFIG_NET_CAPTURE_RING */
+
 /**
  * @}
  */
@@ -164,6 +164,11 @@ enum ethernet_hw_caps {
 
 	/** TXTIME supported */
 	ETHERNET_TXTIME			= BIT(19),
+
+	/** TCP segmentation offloading supported for IPv4 and IPv6, the
+	 * driver splits the packets that have net_pkt_gso_size() set.
+	 */
+	ETHERNET_HW_TX_TCP_SEG_OFFLOAD	= BIT(20),
 };
 
 /** @cond INTERNAL_HIDDEN */
@@ -281,6 +281,11 @@ __net_socket struct net_context {
 		/** Mutex used by condition variable */
 		struct k_mutex *lock;
 	} cond;
+
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+	/** epoll registrations watching this socket */
+	sys_slist_t epoll_items;
+#endif
 #endif /* CONFIG_NET_SOCKETS */
 
 #if defined(CONFIG_NET_OFFLOAD)
@@ -312,9 +317,26 @@ __net_socket struct net_context {
 #endif
 #if defined(CONFIG_NET_CONTEXT_SNDTIMEO)
 		k_timeout_t sndtimeo;
+#endif
+#if defined(CONFIG_NET_CONTEXT_REUSEPORT)
+		/** Share the local address and port with other contexts */
+		bool reuseport;
+#endif
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+		/** Receive buffer size in bytes, 0 if not limited */
+		int rcvbuf;
+#endif
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+		/** Send buffer size in bytes, 0 if not limited */
+		int sndbuf;
 #endif
 	} options;
 
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	/** Bytes of received datagrams queued and not read yet */
+	atomic_t rcvbuf_used;
+#endif
+
 	/** Protocol (UDP, TCP or IEEE 802.3 protocol value) */
 	uint16_t proto;
 
@@ -350,6 +372,24 @@ static inline bool net_context_is_bound_to_iface(struct net_context *context)
 	return context->flags & NET_CONTEXT_BOUND_TO_IFACE;
 }
 
+/**
+ * @brief Can this context share its local address and port.
+ *
+ * @param context Network context.
+ *
+ * @return True if the NET_OPT_REUSEPORT option is set, False otherwise.
+ */
+static inline bool net_context_is_reuseport_set(struct net_context *context)
+{
+#if defined(CONFIG_NET_CONTEXT_REUSEPORT)
+	return context->options.reuseport;
+#else
+	ARG_UNUSED(context);
+
+	return false;
+#endif
+}
+
 /**
  * @brief Is this context is accepting data now.
  *
@@ -990,6 +1030,33 @@ int net_context_sendmsg(struct net_context *context,
 			k_timeout_t timeout,
 			void *user_data);
 
+/**
+ * @brief Send a chain of network buffers without copying the data.
+ *
+ * @details The buffers in @a frags become the payload of the packet as
+ * they are, only the protocol headers are allocated by the stack. This
+ * is supported for UDP and TCP contexts that are not offloaded. For a
+ * connected context the dst_addr can be NULL.
+ *
+ * @param context The network context to use.
+ * @param frags The payload. The stack takes ownership of the buffers if
+ *        the call succeeds, on failure they are left with the caller.
+ * @param dst_addr Destination address, or NULL to use the remote address.
+ * @param addrlen Length of the address.
+ * @param cb Caller-supplied callback function.
+ * @param timeout Currently this value is not used.
+ * @param user_data Caller-supplied user data.
+ *
+ * @return numbers of bytes sent on success, a negative errno otherwise
+ */
+int net_context_send_buf(struct net_context *context,
+			 struct net_buf *frags,
+			 const struct sockaddr *dst_addr,
+			 socklen_t addrlen,
+			 net_context_send_cb_t cb,
+			 k_timeout_t timeout,
+			 void *user_data);
+
 /**
  * @brief Receive network data from a peer specified by context.
  *
@@ -1045,7 +1112,11 @@ int net_context_recv(struct net_context *context,
  * delta of -256. If a function extracts 10 bytes of the queued
  * data, it should call it with delta of 10.
  *
- * @param context The TCP network context to use.
+ * For a UDP or raw IP context, the queued data is counted against the
+ * receive buffer size set with NET_OPT_RCVBUF instead: datagrams are
+ * dropped while that much data is queued.
+ *
+ * @param context The network context to use.
  * @param delta Size, in bytes, by which to increase TCP receive
  * window (negative value to decrease).
  *
@@ -1060,6 +1131,11 @@ enum net_context_option {
 	NET_OPT_SOCKS5		= 3,
 	NET_OPT_RCVTIMEO        = 4,
 	NET_OPT_SNDTIMEO        = 5,
+	NET_OPT_TCP_NODELAY	= 6,
+	NET_OPT_TCP_CORK	= 7,
+	NET_OPT_REUSEPORT	= 8,
+	NET_OPT_RCVBUF		= 9,
+	NET_OPT_SNDBUF		= 10,
 };
 
 /**
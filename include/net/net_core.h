@@ -117,6 +117,22 @@ enum net_verdict {
  */
 int net_recv_data(struct net_if *iface, struct net_pkt *pkt);
 
+/**
+ * @brief Called by network device driver when a burst of network packets
+ * has been received. This is the same as calling net_recv_data() for each
+ * packet, but the packets going to the same traffic class are queued to the
+ * RX thread at once.
+ *
+ * @param iface Network interface where the packets were received.
+ * @param list List of network packets, chained through their burst node.
+ * The list is empty when the function returns successfully, and empty
+ * packets are dropped.
+ *
+ * @return Number of packets passed to the stack if ok, <0 if error, in
+ * which case the caller still owns the packets of the list.
+ */
+int net_recv_data_list(struct net_if *iface, sys_slist_t *list);
+
 /**
  * @brief Send data to network.
  *
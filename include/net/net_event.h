@@ -137,6 +137,8 @@ enum net_event_ipv4_cmd {
 	NET_EVENT_IPV4_CMD_DHCP_STOP,
 	NET_EVENT_IPV4_CMD_MCAST_JOIN,
 	NET_EVENT_IPV4_CMD_MCAST_LEAVE,
+	NET_EVENT_IPV4_CMD_ROUTE_ADD,
+	NET_EVENT_IPV4_CMD_ROUTE_DEL,
 };
 
 #define NET_EVENT_IPV4_ADDR_ADD					\
@@ -166,6 +168,12 @@ enum net_event_ipv4_cmd {
 #define NET_EVENT_IPV4_MCAST_LEAVE				\
 	(_NET_EVENT_IPV4_BASE |	NET_EVENT_IPV4_CMD_MCAST_LEAVE)
 
+#define NET_EVENT_IPV4_ROUTE_ADD				\
+	(_NET_EVENT_IPV4_BASE |	NET_EVENT_IPV4_CMD_ROUTE_ADD)
+
+#define NET_EVENT_IPV4_ROUTE_DEL				\
+	(_NET_EVENT_IPV4_BASE |	NET_EVENT_IPV4_CMD_ROUTE_DEL)
+
 
 /* L4 network events */
 #define _NET_L4_LAYER		NET_MGMT_LAYER_L4
@@ -239,6 +247,21 @@ struct net_event_ipv6_route {
 	uint8_t prefix_len;
 };
 
+/**
+ * @brief Network Management event information structure
+ * Used to pass information on network events like
+ *   NET_EVENT_IPV4_ROUTE_ADD and
+ *   NET_EVENT_IPV4_ROUTE_DEL
+ * when CONFIG_NET_MGMT_EVENT_INFO enabled and event generator pass the
+ * information.
+ * @Note: gw is unspecified for a route directly on the interface.
+ */
+struct net_event_ipv4_route {
+	struct in_addr gw;
+	struct in_addr addr; /* addr/prefix */
+	uint8_t prefix_len;
+};
+
 #endif /* CONFIG_NET_MGMT_EVENT_INFO */
 
 #ifdef __cplusplus
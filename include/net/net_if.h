@@ -484,6 +484,13 @@ struct net_if {
 	 */
 	int tx_pending;
 #endif
+
+#if CONFIG_NET_PKT_RX_IFACE_RESERVE > 0
+	/** Received packets held by this network interface, counted
+	 * against CONFIG_NET_PKT_RX_IFACE_RESERVE.
+	 */
+	atomic_t rx_pkts;
+#endif
 };
 
 /**
@@ -1964,6 +1971,16 @@ bool net_if_need_calc_rx_checksum(struct net_if *iface);
  */
 bool net_if_need_calc_tx_checksum(struct net_if *iface);
 
+/**
+ * @brief Check if a TCP packet built for several segments has to be split
+ * by the IP stack before it is sent, or if the device does it.
+ *
+ * @param iface Network interface
+ *
+ * @return True if the packet needs to be split, false otherwise.
+ */
+bool net_if_need_tcp_segmentation(struct net_if *iface);
+
 /**
  * @brief Get interface according to index
  *
@@ -2188,6 +2205,12 @@ bool net_if_is_suspended(struct net_if *iface);
 /** @cond INTERNAL_HIDDEN */
 struct net_if_api {
 	void (*init)(struct net_if *iface);
+
+	/* Optional, send the packets held back because they were marked
+	 * with net_pkt_tx_more(). Called after the last packet of a TX
+	 * batch, also when it was dropped before reaching the driver.
+	 */
+	void (*tx_flush)(struct net_if *iface);
 };
 
 #if defined(CONFIG_NET_DHCPV4) && defined(CONFIG_NET_NATIVE_IPV4)
@@ -60,11 +60,19 @@ struct net_pkt_cursor {
  * net_pkt_clone() function.
  */
 struct net_pkt {
-	/**
-	 * The fifo is used by RX/TX threads and by socket layer. The net_pkt
-	 * is queued via fifo to the processing thread.
-	 */
-	intptr_t fifo;
+	union {
+		/**
+		 * The fifo is used by RX/TX threads and by socket layer. The
+		 * net_pkt is queued via fifo to the processing thread.
+		 */
+		intptr_t fifo;
+		/**
+		 * Places the packet into a burst of received packets, see
+		 * net_recv_data_list(). Shares the fifo word so that a burst
+		 * can be queued to the processing thread in one go.
+		 */
+		sys_snode_t burst;
+	};
 
 	/** Slab pointer from where it belongs to */
 	struct k_mem_slab *slab;
@@ -90,6 +98,14 @@ struct net_pkt {
 	struct net_if *orig_iface; /* Original network interface */
 #endif
 
+#if CONFIG_NET_PKT_RX_IFACE_RESERVE > 0
+	struct net_if *rx_reserve_iface; /* Interface charged for the pkt */
+#endif
+
+#if defined(CONFIG_NET_TC_TX_CODEL)
+	uint32_t tx_queue_time; /* When the pkt was queued for TX, in us */
+#endif
+
 #if defined(CONFIG_NET_PKT_TIMESTAMP)
 	/** Timestamp if available. */
 	struct net_ptp_time timestamp;
@@ -192,6 +208,22 @@ struct net_pkt {
 				 * defined(CONFIG_NET_ETHERNET_BRIDGE).
 				 */
 
+#if defined(CONFIG_NET_IPV4_FRAGMENT)
+	uint8_t ipv4_reassembled : 1; /* Reassembled from IPv4 fragments so
+				       * it has no L2 header.
+				       */
+#endif
+
+	uint8_t tx_more : 1; /* More packets to the same interface follow
+			      * this one, see CONFIG_NET_TC_TX_BATCH.
+			      */
+
+#if defined(CONFIG_NET_TCP_GRO)
+	uint8_t tcp_gro : 1; /* Coalesced from several TCP segments whose
+			      * checksums were already verified.
+			      */
+#endif
+
 	union {
 		/* IPv6 hop limit or IPv4 ttl for this network packet.
 		 * The value is shared between IPv6 and IPv4.
@@ -223,6 +255,18 @@ struct net_pkt {
 	uint16_t vlan_tci;
 #endif /* CONFIG_NET_VLAN */
 
+#if defined(CONFIG_NET_TCP_GSO)
+	/* Size of the TCP segments this packet has to be split into before
+	 * it is sent, or 0 if it is sent as is.
+	 */
+	uint16_t gso_size;
+#endif /* CONFIG_NET_TCP_GSO */
+
+#if defined(CONFIG_NET_IPV4_FRAGMENT)
+	uint16_t ipv4_fragment_flags;	/* Fragment offset and MF flag */
+	uint16_t ipv4_fragment_id;	/* Fragment id */
+#endif /* CONFIG_NET_IPV4_FRAGMENT */
+
 #if defined(CONFIG_NET_IPV6)
 	/* Where is the start of the last header before payload data
 	 * in IPv6 packet. This is offset value from start of the IPv6
@@ -368,6 +412,58 @@ static inline void net_pkt_set_l2_bridged(struct net_pkt *pkt, bool is_l2_bridge
 	}
 }
 
+static inline uint16_t net_pkt_gso_size(struct net_pkt *pkt)
+{
+#if defined(CONFIG_NET_TCP_GSO)
+	return pkt->gso_size;
+#else
+	ARG_UNUSED(pkt);
+
+	return 0;
+#endif
+}
+
+static inline void net_pkt_set_gso_size(struct net_pkt *pkt, uint16_t size)
+{
+#if defined(CONFIG_NET_TCP_GSO)
+	pkt->gso_size = size;
+#else
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(size);
+#endif
+}
+
+static inline bool net_pkt_is_tcp_gro(struct net_pkt *pkt)
+{
+#if defined(CONFIG_NET_TCP_GRO)
+	return !!(pkt->tcp_gro);
+#else
+	ARG_UNUSED(pkt);
+
+	return false;
+#endif
+}
+
+static inline void net_pkt_set_tcp_gro(struct net_pkt *pkt, bool is_gro)
+{
+#if defined(CONFIG_NET_TCP_GRO)
+	pkt->tcp_gro = is_gro;
+#else
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(is_gro);
+#endif
+}
+
+static inline bool net_pkt_tx_more(struct net_pkt *pkt)
+{
+	return !!(pkt->tx_more);
+}
+
+static inline void net_pkt_set_tx_more(struct net_pkt *pkt, bool more)
+{
+	pkt->tx_more = more;
+}
+
 static inline uint8_t net_pkt_ip_hdr_len(struct net_pkt *pkt)
 {
 	return pkt->ip_hdr_len;
@@ -723,6 +819,96 @@ static inline void net_pkt_set_ipv6_fragment_id(struct net_pkt *pkt,
 }
 #endif /* CONFIG_NET_IPV6_FRAGMENT */
 
+#if defined(CONFIG_NET_IPV4_FRAGMENT)
+static inline uint16_t net_pkt_ipv4_fragment_offset(struct net_pkt *pkt)
+{
+	return (pkt->ipv4_fragment_flags & NET_IPV4_FRAGH_OFFSET_MASK) * 8;
+}
+
+static inline bool net_pkt_ipv4_fragment_more(struct net_pkt *pkt)
+{
+	/* More Fragments flag */
+	return (pkt->ipv4_fragment_flags & 0x2000) != 0;
+}
+
+static inline void net_pkt_set_ipv4_fragment_flags(struct net_pkt *pkt,
+						   uint16_t flags)
+{
+	pkt->ipv4_fragment_flags = flags;
+}
+
+static inline uint16_t net_pkt_ipv4_fragment_id(struct net_pkt *pkt)
+{
+	return pkt->ipv4_fragment_id;
+}
+
+static inline void net_pkt_set_ipv4_fragment_id(struct net_pkt *pkt,
+						uint16_t id)
+{
+	pkt->ipv4_fragment_id = id;
+}
+
+static inline bool net_pkt_ipv4_reassembled(struct net_pkt *pkt)
+{
+	return pkt->ipv4_reassembled;
+}
+
+static inline void net_pkt_set_ipv4_reassembled(struct net_pkt *pkt,
+						bool reassembled)
+{
+	pkt->ipv4_reassembled = reassembled;
+}
+#else /* CONFIG_NET_IPV4_FRAGMENT */
+static inline uint16_t net_pkt_ipv4_fragment_offset(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static inline bool net_pkt_ipv4_fragment_more(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static inline void net_pkt_set_ipv4_fragment_flags(struct net_pkt *pkt,
+						   uint16_t flags)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(flags);
+}
+
+static inline uint16_t net_pkt_ipv4_fragment_id(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static inline void net_pkt_set_ipv4_fragment_id(struct net_pkt *pkt,
+						uint16_t id)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(id);
+}
+
+static inline bool net_pkt_ipv4_reassembled(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return false;
+}
+
+static inline void net_pkt_set_ipv4_reassembled(struct net_pkt *pkt,
+						bool reassembled)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(reassembled);
+}
+#endif /* CONFIG_NET_IPV4_FRAGMENT */
+
 static inline uint8_t net_pkt_priority(struct net_pkt *pkt)
 {
 	return pkt->priority;
@@ -156,6 +156,14 @@ struct net_stats_tcp {
 	/** Number of retransmitted TCP segments. */
 	net_stats_t rexmit;
 
+	/** Number of TCP retransmission timeouts. */
+	net_stats_t rto;
+
+	/** Number of TCP segments retransmitted on duplicate or partial
+	 * ACKs, without waiting for the retransmission timeout.
+	 */
+	net_stats_t fast_rexmit;
+
 	/** Number of dropped connection attempts because too few connections
 	 * were available.
 	 */
@@ -182,6 +190,25 @@ struct net_stats_udp {
 	net_stats_t chkerr;
 };
 
+/**
+ * @brief Buffer limit statistics
+ */
+struct net_stats_buf_limits {
+	/** Number of datagrams dropped as the socket receive buffer was full */
+	net_stats_t rcvbuf_drop;
+
+	/** Number of times a TCP receive window was closed */
+	net_stats_t rcvwnd_zero;
+
+	/** Number of sends held back as the socket send buffer was full */
+	net_stats_t sndbuf_full;
+
+	/** Number of packets not received to keep the reservations of the
+	 * other interfaces.
+	 */
+	net_stats_t rx_reserve_drop;
+};
+
 /**
  * @brief IPv6 neighbor discovery statistics
  */
@@ -235,6 +262,25 @@ struct net_stats_rx_time {
 	net_stats_t count;
 };
 
+/**
+ * @brief TX queue statistics
+ */
+struct net_stats_tx_queue {
+	/** Time the sent packets waited in the TX queues, in microseconds */
+	struct net_stats_tx_time delay;
+
+	/** Longest time a sent packet waited in the TX queues, in
+	 * microseconds.
+	 */
+	uint32_t delay_max;
+
+	/** Number of packets dropped as the queue delay stayed too long */
+	net_stats_t codel_drop;
+
+	/** Number of packets dropped as the TX queue was full */
+	net_stats_t overlimit_drop;
+};
+
 #if NET_TC_TX_COUNT == 0
 #define NET_TC_TX_STATS_COUNT 1
 #else
@@ -327,6 +373,16 @@ struct net_stats {
 	struct net_stats_udp udp;
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_BUF_LIMITS)
+	/** Buffer limit statistics */
+	struct net_stats_buf_limits buf_limits;
+#endif
+
+#if defined(CONFIG_NET_STATISTICS_TX_QUEUE)
+	/** TX queue statistics */
+	struct net_stats_tx_queue tx_queue;
+#endif
+
 #if defined(CONFIG_NET_STATISTICS_IPV6_ND)
 	/** IPv6 neighbor discovery statistics */
 	struct net_stats_ipv6_nd ipv6_nd;
@@ -493,7 +549,9 @@ enum net_request_stats_cmd {
 	NET_REQUEST_STATS_CMD_GET_TCP,
 	NET_REQUEST_STATS_CMD_GET_ETHERNET,
 	NET_REQUEST_STATS_CMD_GET_PPP,
-	NET_REQUEST_STATS_CMD_GET_PM
+	NET_REQUEST_STATS_CMD_GET_PM,
+	NET_REQUEST_STATS_CMD_GET_BUF_LIMITS,
+	NET_REQUEST_STATS_CMD_GET_TX_QUEUE,
 };
 
 #define NET_REQUEST_STATS_GET_ALL				\
@@ -558,6 +616,20 @@ NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_UDP);
 NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_TCP);
 #endif /* CONFIG_NET_STATISTICS_TCP */
 
+#if defined(CONFIG_NET_STATISTICS_BUF_LIMITS)
+#define NET_REQUEST_STATS_GET_BUF_LIMITS			\
+	(_NET_STATS_BASE | NET_REQUEST_STATS_CMD_GET_BUF_LIMITS)
+
+NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_BUF_LIMITS);
+#endif /* CONFIG_NET_STATISTICS_BUF_LIMITS */
+
+#if defined(CONFIG_NET_STATISTICS_TX_QUEUE)
+#define NET_REQUEST_STATS_GET_TX_QUEUE				\
+	(_NET_STATS_BASE | NET_REQUEST_STATS_CMD_GET_TX_QUEUE)
+
+NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_TX_QUEUE);
+#endif /* CONFIG_NET_STATISTICS_TX_QUEUE */
+
 #if defined(CONFIG_NET_STATISTICS_ETHERNET)
 #define NET_REQUEST_STATS_GET_ETHERNET				\
 	(_NET_STATS_BASE | NET_REQUEST_STATS_CMD_GET_ETHERNET)
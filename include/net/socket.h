@@ -27,6 +27,7 @@
 #include <net/net_ip.h>
 #include <net/dns_resolve.h>
 #include <net/socket_select.h>
+#include <net/socket_epoll.h>
 #include <net/socket_ncs.h>
 #include <stdlib.h>
 
@@ -64,6 +65,8 @@ struct zsock_pollfd {
 #define ZSOCK_MSG_DONTWAIT 0x40
 /** zsock_recv: block until the full amount of data can be returned */
 #define ZSOCK_MSG_WAITALL 0x100
+/** zsock_recvmmsg: do not block after the first message has been received */
+#define ZSOCK_MSG_WAITFORONE 0x10000
 
 /* Well-known values, e.g. from Linux man 2 shutdown:
  * "The constants SHUT_RD, SHUT_WR, SHUT_RDWR have the value 0, 1, 2,
@@ -371,6 +374,28 @@ static inline ssize_t zsock_send(int sock, const void *buf, size_t len,
 __syscall ssize_t zsock_sendmsg(int sock, const struct msghdr *msg,
 				int flags);
 
+/**
+ * @brief Send multiple messages with a single call
+ *
+ * @details
+ * Each message of @a msgvec is sent like with zsock_sendmsg() and the
+ * number of bytes sent is stored in its @c msg_len field. The socket is
+ * locked only once for the whole batch.
+ *
+ * This function is also exposed as ``sendmmsg()``
+ * if :kconfig:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ *
+ * @param sock Socket
+ * @param msgvec Messages to send
+ * @param vlen Number of messages in @a msgvec
+ * @param flags Flags applied to every message
+ *
+ * @return Number of messages sent, or -1 and errno set if the first
+ * message could not be sent.
+ */
+__syscall int zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
 /**
  * @brief Receive data from an arbitrary network address
  *
@@ -405,6 +430,94 @@ static inline ssize_t zsock_recv(int sock, void *buf, size_t max_len,
 	return zsock_recvfrom(sock, buf, max_len, flags, NULL, NULL);
 }
 
+/**
+ * @brief Receive multiple messages with a single call
+ *
+ * @details
+ * Each message of @a msgvec is filled like with ``recvmsg()``: the data
+ * is scattered over its @c msg_iov, the source address is stored in
+ * @c msg_name if set, @c MSG_TRUNC is set in @c msg_flags if the datagram
+ * did not fit and the number of bytes received is stored in @c msg_len.
+ * No ancillary data is returned. The socket is locked only once for the
+ * whole batch.
+ *
+ * With @c ZSOCK_MSG_WAITFORONE, the call blocks only until the first
+ * message has been received. Unlike Linux there is no timeout argument,
+ * use the SO_RCVTIMEO socket option instead.
+ *
+ * This function is also exposed as ``recvmmsg()``
+ * if :kconfig:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ *
+ * @param sock Socket
+ * @param msgvec Messages to fill
+ * @param vlen Number of messages in @a msgvec
+ * @param flags Flags applied to every message
+ *
+ * @return Number of messages received, or -1 and errno set if no message
+ * could be received.
+ */
+__syscall int zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+struct net_buf;
+
+/**
+ * @brief Receive data without copying it
+ *
+ * @details
+ * The network buffers holding the data of the next datagram, or of the
+ * next received segment of a stream, are handed to the caller instead of
+ * being copied out. The protocol headers are already removed. The caller
+ * must give the buffers back with zsock_recv_zc_release() once done, they
+ * come from the network RX pool and holding them for long starves the
+ * receive path.
+ *
+ * Only native UDP and TCP sockets are supported, and only supervisor
+ * threads may call this function. @c ZSOCK_MSG_PEEK and
+ * @c ZSOCK_MSG_WAITALL are not supported.
+ *
+ * @param sock Socket
+ * @param frags Set to the received buffers, or to NULL if there is no
+ *        data (end of stream)
+ * @param flags Receive flags
+ * @param src_addr Filled with the source address of a datagram, can be NULL
+ * @param addrlen Length of @a src_addr, updated with the actual length
+ *
+ * @return Number of bytes in @a frags, or -1 and errno set on error.
+ */
+ssize_t zsock_recv_zc(int sock, struct net_buf **frags, int flags,
+		      struct sockaddr *src_addr, socklen_t *addrlen);
+
+/**
+ * @brief Release the buffers returned by zsock_recv_zc()
+ *
+ * @param frags Buffers to release, can be NULL
+ */
+void zsock_recv_zc_release(struct net_buf *frags);
+
+/**
+ * @brief Send data without copying it
+ *
+ * @details
+ * The network buffers in @a frags become the payload as they are. If
+ * the call succeeds the stack owns the buffers and frees them once sent.
+ * On failure they are left with the caller, who can retry or free them.
+ * For a UDP socket all of @a frags is sent as a single datagram.
+ *
+ * Only native UDP and TCP sockets are supported, and only supervisor
+ * threads may call this function.
+ *
+ * @param sock Socket
+ * @param frags Data to send
+ * @param flags Send flags
+ * @param dest_addr Destination address, or NULL for a connected socket
+ * @param addrlen Length of @a dest_addr
+ *
+ * @return Number of bytes sent, or -1 and errno set on error.
+ */
+ssize_t zsock_send_zc(int sock, struct net_buf *frags, int flags,
+		      const struct sockaddr *dest_addr, socklen_t addrlen);
+
 /**
  * @brief Control blocking/non-blocking mode of a socket
  *
@@ -725,6 +838,18 @@ static inline ssize_t recvfrom(int sock, void *buf, size_t max_len, int flags,
 	return zsock_recvfrom(sock, buf, max_len, flags, src_addr, addrlen);
 }
 
+static inline int sendmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg(sock, msgvec, vlen, flags);
+}
+
+static inline int recvmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_recvmmsg(sock, msgvec, vlen, flags);
+}
+
 static inline int poll(struct zsock_pollfd *fds, int nfds, int timeout)
 {
 	return zsock_poll(fds, nfds, timeout);
@@ -801,6 +926,7 @@ static inline char *inet_ntop(sa_family_t family, const void *src, char *dst,
 #define MSG_TRUNC ZSOCK_MSG_TRUNC
 #define MSG_DONTWAIT ZSOCK_MSG_DONTWAIT
 #define MSG_WAITALL ZSOCK_MSG_WAITALL
+#define MSG_WAITFORONE ZSOCK_MSG_WAITFORONE
 
 #define SHUT_RD ZSOCK_SHUT_RD
 #define SHUT_WR ZSOCK_SHUT_WR
@@ -835,6 +961,12 @@ struct ifreq {
 #define SO_TYPE 3
 /** sockopt: Async error (ignored, for compatibility) */
 #define SO_ERROR 4
+/** sockopt: Bytes of data queued for sending before send() blocks */
+#define SO_SNDBUF 7
+/** sockopt: Bytes of received data queued before the peer is held back */
+#define SO_RCVBUF 8
+/** sockopt: Share the address and port with other sockets setting it */
+#define SO_REUSEPORT 15
 
 /**
  * sockopt: Receive timeout
@@ -853,8 +985,10 @@ struct ifreq {
 #define SO_PROTOCOL 38
 
 /* Socket options for IPPROTO_TCP level */
-/** sockopt: Disable TCP buffering (ignored, for compatibility) */
+/** sockopt: Disable Nagle's algorithm, send small segments immediately */
 #define TCP_NODELAY 1
+/** sockopt: Only send full-sized segments until the option is cleared */
+#define TCP_CORK 3
 
 /* Socket options for IPPROTO_IPV6 level */
 /** sockopt: Don't support IPv4 access (ignored, for compatibility) */
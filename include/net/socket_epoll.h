@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+#define ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+
+/**
+ * @brief BSD Sockets compatible API
+ * @defgroup bsd_sockets BSD Sockets compatible API
+ * @ingroup networking
+ * @{
+ */
+
+#include <toolchain.h>
+#include <zephyr/types.h>
+#include <sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** zsock_epoll_ctl: socket has data to read */
+#define ZSOCK_EPOLLIN 0x001
+/** zsock_epoll_ctl: socket can be written to */
+#define ZSOCK_EPOLLOUT 0x004
+/** zsock_epoll_wait: error condition (output value only) */
+#define ZSOCK_EPOLLERR 0x008
+/** zsock_epoll_wait: hang up (output value only) */
+#define ZSOCK_EPOLLHUP 0x010
+/** zsock_epoll_ctl: report the socket once, until re-armed */
+#define ZSOCK_EPOLLONESHOT BIT(30)
+/** zsock_epoll_ctl: edge triggered, report only new events */
+#define ZSOCK_EPOLLET BIT(31)
+
+/** zsock_epoll_ctl: register a socket */
+#define ZSOCK_EPOLL_CTL_ADD 1
+/** zsock_epoll_ctl: unregister a socket */
+#define ZSOCK_EPOLL_CTL_DEL 2
+/** zsock_epoll_ctl: change the events of a registered socket */
+#define ZSOCK_EPOLL_CTL_MOD 3
+
+/** User data returned with the events of a socket */
+typedef union zsock_epoll_data {
+	void *ptr;
+	int fd;
+	uint32_t u32;
+	uint64_t u64;
+} zsock_epoll_data_t;
+
+/** Events of a socket */
+struct zsock_epoll_event {
+	/** ZSOCK_EPOLL* event mask and flags */
+	uint32_t events;
+	/** User data */
+	zsock_epoll_data_t data;
+};
+
+/**
+ * @brief Create an epoll instance
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <https://man7.org/linux/man-pages/man2/epoll_create.2.html>`__
+ * for the description. Sockets are registered once with
+ * :c:func:`zsock_epoll_ctl()` and report when they become ready, so
+ * :c:func:`zsock_epoll_wait()` only looks at the sockets that are ready
+ * instead of all of them as :c:func:`zsock_poll()` does.
+ * This function is also exposed as ``epoll_create1()``
+ * if :kconfig:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param flags Must be 0
+ *
+ * @return File descriptor of the instance, or -1 and errno set on error.
+ *         Close it with zsock_close().
+ */
+__syscall int zsock_epoll_create1(int flags);
+
+/**
+ * @brief Create an epoll instance
+ *
+ * @details
+ * Same as zsock_epoll_create1() with no flags, the size is only checked
+ * to be positive. This function is also exposed as ``epoll_create()``
+ * if :kconfig:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ */
+int zsock_epoll_create(int size);
+
+/**
+ * @brief Register, change or unregister a socket of an epoll instance
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <https://man7.org/linux/man-pages/man2/epoll_ctl.2.html>`__
+ * for the description. Only native sockets can be registered.
+ * A socket is always considered writable, as with :c:func:`zsock_poll()`,
+ * so with edge triggering ``ZSOCK_EPOLLOUT`` is only reported when the
+ * socket is registered or modified. A closed socket is unregistered
+ * from all the instances.
+ * This function is also exposed as ``epoll_ctl()``
+ * if :kconfig:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ */
+__syscall int zsock_epoll_ctl(int epfd, int op, int fd,
+			      struct zsock_epoll_event *event);
+
+/**
+ * @brief Wait for registered sockets to become ready
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <https://man7.org/linux/man-pages/man2/epoll_wait.2.html>`__
+ * for the description. The timeout is in milliseconds, -1 waits forever.
+ * ``ZSOCK_EPOLLHUP`` is reported together with ``ZSOCK_EPOLLIN`` once a
+ * TCP peer closed the connection and the received data was read.
+ * This function is also exposed as ``epoll_wait()``
+ * if :kconfig:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @return Number of events stored in @a events, 0 on timeout, or -1 and
+ *         errno set on error.
+ */
+__syscall int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+			       int maxevents, int timeout);
+
+#ifdef CONFIG_NET_SOCKETS_POSIX_NAMES
+
+#define epoll_event zsock_epoll_event
+#define epoll_data_t zsock_epoll_data_t
+
+#define EPOLLIN ZSOCK_EPOLLIN
+#define EPOLLOUT ZSOCK_EPOLLOUT
+#define EPOLLERR ZSOCK_EPOLLERR
+#define EPOLLHUP ZSOCK_EPOLLHUP
+#define EPOLLONESHOT ZSOCK_EPOLLONESHOT
+#define EPOLLET ZSOCK_EPOLLET
+
+#define EPOLL_CTL_ADD ZSOCK_EPOLL_CTL_ADD
+#define EPOLL_CTL_DEL ZSOCK_EPOLL_CTL_DEL
+#define EPOLL_CTL_MOD ZSOCK_EPOLL_CTL_MOD
+
+static inline int epoll_create(int size)
+{
+	return zsock_epoll_create(size);
+}
+
+static inline int epoll_create1(int flags)
+{
+	return zsock_epoll_create1(flags);
+}
+
+static inline int epoll_ctl(int epfd, int op, int fd,
+			    struct zsock_epoll_event *event)
+{
+	return zsock_epoll_ctl(epfd, op, fd, event);
+}
+
+static inline int epoll_wait(int epfd, struct zsock_epoll_event *events,
+			     int maxevents, int timeout)
+{
+	return zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+
+#endif /* CONFIG_NET_SOCKETS_POSIX_NAMES */
+
+#ifdef __cplusplus
+}
+#endif
+
+#include <syscalls/socket_epoll.h>
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_ */
@@ -26,12 +26,50 @@ struct sys_bitarray {
 	/* Bundle of bits */
 	uint32_t *bundles;
 
+	/* Index of the lowest bundle which may have cleared bits.
+	 * All bundles below this index are fully set.
+	 */
+	uint32_t first_free;
+
+#ifdef CONFIG_SYS_BITARRAY_SUMMARY
+	/* One bit per bundle, set when the bundle is fully set */
+	uint32_t *summary;
+#endif
+
 	/* Spinlock guarding access to this bit array */
 	struct k_spinlock lock;
 };
 
 typedef struct sys_bitarray sys_bitarray_t;
 
+/* Number of 32-bit bundles needed to hold @p total_bits */
+#define _SYS_BITARRAY_NUM_BUNDLES(total_bits)				\
+	((((total_bits + 8 - 1) / 8) + sizeof(uint32_t) - 1)		\
+	 / sizeof(uint32_t))
+
+#ifdef CONFIG_SYS_BITARRAY_SUMMARY
+#define _SYS_BITARRAY_SUMMARY_DEFINE(name, total_bits, sba_mod)		\
+	sba_mod uint32_t _sys_bitarray_summary_##name			\
+		[(_SYS_BITARRAY_NUM_BUNDLES(total_bits) + 32 - 1)	\
+		 / 32] = {0U};
+#define _SYS_BITARRAY_SUMMARY_INIT(name)				\
+	.summary = _sys_bitarray_summary_##name,
+#else
+#define _SYS_BITARRAY_SUMMARY_DEFINE(name, total_bits, sba_mod)
+#define _SYS_BITARRAY_SUMMARY_INIT(name)
+#endif
+
+#define _SYS_BITARRAY_DEFINE(name, total_bits, sba_mod)			\
+	sba_mod uint32_t _sys_bitarray_bundles_##name			\
+		[_SYS_BITARRAY_NUM_BUNDLES(total_bits)] = {0U};		\
+	_SYS_BITARRAY_SUMMARY_DEFINE(name, total_bits, sba_mod)		\
+	sba_mod sys_bitarray_t name = {					\
+		.num_bits = total_bits,					\
+		.num_bundles = _SYS_BITARRAY_NUM_BUNDLES(total_bits),	\
+		.bundles = _sys_bitarray_bundles_##name,		\
+		_SYS_BITARRAY_SUMMARY_INIT(name)			\
+	}
+
 /**
  * @def SYS_BITARRAY_DEFINE
  *
@@ -41,16 +79,18 @@ typedef struct sys_bitarray sys_bitarray_t;
  * @param total_bits Total number of bits in this bitarray object.
  */
 #define SYS_BITARRAY_DEFINE(name, total_bits)				\
-	uint32_t _sys_bitarray_bundles_##name				\
-		[(((total_bits + 8 - 1) / 8) + sizeof(uint32_t) - 1)	\
-		 / sizeof(uint32_t)] = {0U};				\
-	sys_bitarray_t name = {						\
-		.num_bits = total_bits,					\
-		.num_bundles = (((total_bits + 8 - 1) / 8)		\
-				+ sizeof(uint32_t) - 1)			\
-			       / sizeof(uint32_t),			\
-		.bundles = _sys_bitarray_bundles_##name,		\
-	}
+	_SYS_BITARRAY_DEFINE(name, total_bits,)
+
+/**
+ * @def SYS_BITARRAY_DEFINE_STATIC
+ *
+ * @brief Create a static bitarray object.
+ *
+ * @param name Name of the bitarray object.
+ * @param total_bits Total number of bits in this bitarray object.
+ */
+#define SYS_BITARRAY_DEFINE_STATIC(name, total_bits)			\
+	_SYS_BITARRAY_DEFINE(name, total_bits, static)
 
 /**
  * Set a bit in a bit array
@@ -123,6 +163,10 @@ int sys_bitarray_test_and_clear_bit(sys_bitarray_t *bitarray, size_t bit, int *p
  * marked as allocated and the offset to the start of this region is
  * returned via @p offset.
  *
+ * The lowest suitable region is always returned. The search skips
+ * fully allocated bundles, and with CONFIG_SYS_BITARRAY_SUMMARY
+ * enabled it skips them 32 bundles at a time.
+ *
  * @param[in]  bitarray Bitarray struct
  * @param[in]  num_bits Number of bits to allocate
  * @param[out] offset   Offset to the start of allocated region if
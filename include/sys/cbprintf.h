@@ -75,6 +75,18 @@ extern "C" {
  */
 #define CBPRINTF_PACKAGE_ADD_STRING_IDXS BIT(0)
 
+/** @brief Append locations of string arguments which may be transient.
+ *
+ * Only used by static packaging (@ref CBPRINTF_STATIC_PACKAGE). Every
+ * character pointer argument but the format string is assumed to be a string
+ * which may be transient and its location is recorded in the package instead
+ * of the string being copied. Such package is only valid as long as the
+ * strings are and must be converted with @ref cbprintf_package_copy before
+ * it is stored. Character pointers that are not strings (e.g. used with %p)
+ * must be cast to void pointers when this flag is used.
+ */
+#define CBPRINTF_PACKAGE_ADD_RW_STR_POS BIT(1)
+
 /**@} */
 
 /** @brief Signature for a cbprintf callback function.
@@ -267,6 +279,40 @@ int cbprintf_fsc_package(void *in_packaged,
 			 void *packaged,
 			 size_t len);
 
+/** @brief Copy a package appending transient strings.
+ *
+ * Converts a package created with @ref CBPRINTF_PACKAGE_ADD_RW_STR_POS into
+ * a package equivalent to the one @ref cbprintf_package would have created
+ * for the same arguments: strings which are not in read only memory are
+ * appended to the package. Unlike @ref cbprintf_package, the format string
+ * does not have to be parsed since string locations are already known.
+ * Packages without string locations are copied as is.
+ *
+ * @param in_packaged pointer to the original package.
+ *
+ * @param in_len @p in_packaged length.
+ *
+ * @param packaged pointer to location where the package will be written. Pass
+ * a null pointer to calculate space required.
+ *
+ * @param len must be set to the number of bytes available at @p packaged. Not
+ * used if @p packaged is null.
+ *
+ * @param flags option flags. Only @ref CBPRINTF_PACKAGE_ADD_STRING_IDXS is
+ * used, in which case locations of read only strings are kept in the package.
+ *
+ * @retval nonegative the number of bytes successfully stored at @p packaged.
+ * This will not exceed @p len. If @p packaged is null, calculated length.
+ * @retval -ENOSPC if @p packaged was not null and the space required to store
+ * exceed @p len.
+ * @retval -EINVAL if @p in_packaged is null.
+ */
+int cbprintf_package_copy(void *in_packaged,
+			  size_t in_len,
+			  void *packaged,
+			  size_t len,
+			  uint32_t flags);
+
 /** @brief Generate the output for a previously captured format
  * operation.
  *
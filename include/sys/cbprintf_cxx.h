@@ -8,49 +8,53 @@
 #define ZEPHYR_INCLUDE_SYS_CBPRINTF_CXX_H_
 #ifdef __cplusplus
 
+/* Helpers which depend only on the argument type are constexpr so that the
+ * static package layout can be resolved at compile time.
+ */
+
 /* C++ version for detecting a pointer to a string. */
-static inline int z_cbprintf_cxx_is_pchar(char *)
+static inline constexpr int z_cbprintf_cxx_is_pchar(char *)
 {
 	return 1;
 }
 
-static inline int z_cbprintf_cxx_is_pchar(const char *)
+static inline constexpr int z_cbprintf_cxx_is_pchar(const char *)
 {
 	return 1;
 }
 
-static inline int z_cbprintf_cxx_is_pchar(volatile char *)
+static inline constexpr int z_cbprintf_cxx_is_pchar(volatile char *)
 {
 	return 1;
 }
 
-static inline int z_cbprintf_cxx_is_pchar(const volatile char *)
+static inline constexpr int z_cbprintf_cxx_is_pchar(const volatile char *)
 {
 	return 1;
 }
 
-static inline int z_cbprintf_cxx_is_pchar(wchar_t *)
+static inline constexpr int z_cbprintf_cxx_is_pchar(wchar_t *)
 {
 	return 1;
 }
 
-static inline int z_cbprintf_cxx_is_pchar(const wchar_t *)
+static inline constexpr int z_cbprintf_cxx_is_pchar(const wchar_t *)
 {
 	return 1;
 }
 
-static inline int z_cbprintf_cxx_is_pchar(volatile wchar_t *)
+static inline constexpr int z_cbprintf_cxx_is_pchar(volatile wchar_t *)
 {
 	return 1;
 }
 
-static inline int z_cbprintf_cxx_is_pchar(const volatile wchar_t *)
+static inline constexpr int z_cbprintf_cxx_is_pchar(const volatile wchar_t *)
 {
 	return 1;
 }
 
 template < typename T >
-static inline int z_cbprintf_cxx_is_pchar(T arg)
+static inline constexpr int z_cbprintf_cxx_is_pchar(T)
 {
 	_Pragma("GCC diagnostic push")
 	_Pragma("GCC diagnostic ignored \"-Wpointer-arith\"")
@@ -59,22 +63,18 @@ static inline int z_cbprintf_cxx_is_pchar(T arg)
 }
 
 /* C++ version for calculating argument size. */
-static inline size_t z_cbprintf_cxx_arg_size(float f)
+static inline constexpr size_t z_cbprintf_cxx_arg_size(float)
 {
-	ARG_UNUSED(f);
-
 	return sizeof(double);
 }
 
-static inline size_t z_cbprintf_cxx_arg_size(void *p)
+static inline constexpr size_t z_cbprintf_cxx_arg_size(void *)
 {
-	ARG_UNUSED(p);
-
 	return sizeof(void *);
 }
 
 template < typename T >
-static inline size_t z_cbprintf_cxx_arg_size(T arg)
+static inline constexpr size_t z_cbprintf_cxx_arg_size(T arg)
 {
 	return sizeof(arg + 0);
 }
@@ -83,14 +83,13 @@ static inline size_t z_cbprintf_cxx_arg_size(T arg)
 static inline void z_cbprintf_cxx_store_arg(uint8_t *dst, float arg)
 {
 	double d = (double)arg;
-	void *p = &d;
 
-	z_cbprintf_wcpy((int *)dst, (int *)p, sizeof(d) / sizeof(int));
+	__builtin_memcpy(dst, &d, sizeof(d));
 }
 
 static inline void z_cbprintf_cxx_store_arg(uint8_t *dst, void *p)
 {
-	z_cbprintf_wcpy((int *)dst, (int *)&p, sizeof(p) / sizeof(int));
+	__builtin_memcpy(dst, &p, sizeof(p));
 }
 
 static inline void z_cbprintf_cxx_store_arg(uint8_t *dst, char arg)
@@ -131,65 +130,54 @@ static inline void z_cbprintf_cxx_store_arg(uint8_t *dst, unsigned short arg)
 template < typename T >
 static inline void z_cbprintf_cxx_store_arg(uint8_t *dst, T arg)
 {
-	size_t wlen = z_cbprintf_cxx_arg_size(arg) / sizeof(int);
-	void *p = &arg;
+	/* Copy bytes of the promoted value, accessing it through an int
+	 * pointer would break strict aliasing (e.g. for long on 64-bit).
+	 */
+	auto tmp = arg + 0;
 
-	z_cbprintf_wcpy((int *)dst, (int *)p, wlen);
+	__builtin_memcpy(dst, &tmp, sizeof(tmp));
 }
 
 /* C++ version for long double detection. */
-static inline int z_cbprintf_cxx_is_longdouble(long double arg)
+static inline constexpr int z_cbprintf_cxx_is_longdouble(long double)
 {
-	ARG_UNUSED(arg);
 	return 1;
 }
 
 template < typename T >
-static inline int z_cbprintf_cxx_is_longdouble(T arg)
+static inline constexpr int z_cbprintf_cxx_is_longdouble(T)
 {
-	ARG_UNUSED(arg);
-
 	return 0;
 }
 
 /* C++ version for caluculating argument alignment. */
-static inline size_t z_cbprintf_cxx_alignment(float arg)
+static inline constexpr size_t z_cbprintf_cxx_alignment(float)
 {
-	ARG_UNUSED(arg);
-
 	return VA_STACK_ALIGN(double);
 }
 
-static inline size_t z_cbprintf_cxx_alignment(double arg)
+static inline constexpr size_t z_cbprintf_cxx_alignment(double)
 {
-	ARG_UNUSED(arg);
-
 	return VA_STACK_ALIGN(double);
 }
 
-static inline size_t z_cbprintf_cxx_alignment(long double arg)
+static inline constexpr size_t z_cbprintf_cxx_alignment(long double)
 {
-	ARG_UNUSED(arg);
-
 	return VA_STACK_ALIGN(long double);
 }
 
-static inline size_t z_cbprintf_cxx_alignment(long long arg)
+static inline constexpr size_t z_cbprintf_cxx_alignment(long long)
 {
-	ARG_UNUSED(arg);
-
 	return VA_STACK_ALIGN(long long);
 }
 
-static inline size_t z_cbprintf_cxx_alignment(unsigned long long arg)
+static inline constexpr size_t z_cbprintf_cxx_alignment(unsigned long long)
 {
-	ARG_UNUSED(arg);
-
 	return VA_STACK_ALIGN(long long);
 }
 
 template < typename T >
-static inline size_t z_cbprintf_cxx_alignment(T arg)
+static inline constexpr size_t z_cbprintf_cxx_alignment(T arg)
 {
 	return MAX(__alignof__(arg), VA_STACK_MIN_ALIGN);
 }
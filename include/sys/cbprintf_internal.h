@@ -149,15 +149,12 @@ extern "C" {
 #ifdef __cplusplus
 #define Z_CBPRINTF_ARG_SIZE(v) z_cbprintf_cxx_arg_size(v)
 #else
-#define Z_CBPRINTF_ARG_SIZE(v) ({\
-	__auto_type _v = (v) + 0; \
-	size_t _arg_size = _Generic((v), \
+#define Z_CBPRINTF_ARG_SIZE(v) \
+	_Generic((v) + 0, \
 		float : sizeof(double), \
 		default : \
-			sizeof((_v)) \
-		); \
-	_arg_size; \
-})
+			sizeof((v) + 0) \
+		)
 #endif
 
 /** @brief Promote and store argument in the buffer.
@@ -244,63 +241,89 @@ extern "C" {
 	_Generic((x) + 0, long double : 1, default : 0)
 #endif
 
-/** @brief Safely package arguments to a buffer.
+/** @brief Return padding needed to store an argument at given offset.
  *
- * Argument is put into the buffer if capable buffer is provided. Length is
- * incremented even if data is not packaged.
+ * Alignment is a power of two and depends only on the argument type, so the
+ * padding is resolved at compile time when @p _offset is known.
  *
- * @param _buf buffer.
+ * @param _offset Offset (including alignment offset) at which argument would
+ * be stored.
  *
- * @param _idx index. Index is postincremented.
+ * @param _arg Argument.
  *
- * @param _align_offset Current index with alignment offset.
+ * @return Number of padding bytes.
+ */
+#define Z_CBPRINTF_ARG_PAD(_offset, _arg) \
+	((int)((0 - (size_t)(_offset)) & (Z_CBPRINTF_ALIGNMENT(_arg) - 1)))
+
+/** @brief Account for a single argument in the package layout.
  *
- * @param _max maximum index (buffer capacity).
+ * Macro is called for each argument in the string, including the format
+ * string. Only types of the arguments are used, so the package length and
+ * number of string locations are constant expressions for the compiler.
+ *
+ * @param _idx argument index.
  *
  * @param _arg argument.
  */
-#define Z_CBPRINTF_PACK_ARG2(_buf, _idx, _align_offset, _max, \
-			     _cfg_flags, _s_idx, _s_buf, _arg) \
+#define Z_CBPRINTF_PACK_LAYOUT(_idx, _arg) \
 do { \
 	BUILD_ASSERT(!((sizeof(double) < VA_STACK_ALIGN(long double)) && \
 			Z_CBPRINTF_IS_LONGDOUBLE(_arg) && \
 			!IS_ENABLED(CONFIG_CBPRINTF_PACKAGE_LONGDOUBLE)),\
 			"Packaging of long double not enabled in Kconfig."); \
-	while (_align_offset % Z_CBPRINTF_ALIGNMENT(_arg)) { \
-		_idx += sizeof(int); \
-		_align_offset += sizeof(int); \
-	} \
-	uint32_t _arg_size = Z_CBPRINTF_ARG_SIZE(_arg); \
+	_pkg_len += Z_CBPRINTF_ARG_PAD(_pkg_align + _pkg_len, _arg); \
+	_pkg_len += Z_CBPRINTF_ARG_SIZE(_arg); \
 	if (Z_CBPRINTF_IS_PCHAR(_arg)) { \
-		_s_buf[_s_idx++] = _idx / sizeof(int); \
-	} \
-	if (_buf && _idx < (int)_max) { \
-		Z_CBPRINTF_STORE_ARG(&_buf[_idx], _arg); \
+		if (((_idx) > 0) && _rw_strs) { \
+			_rw_cnt++; \
+		} else if (_str_idxs) { \
+			_ro_cnt++; \
+		} \
 	} \
-	_idx += _arg_size; \
-	_align_offset += _arg_size; \
 } while (0)
 
-/** @brief Package single argument.
+/** @brief Store a single argument in the package.
+ *
+ * Macro is called for each argument in the string after the layout is
+ * determined by @ref Z_CBPRINTF_PACK_LAYOUT. Location of a string argument
+ * is written directly to its place after the arguments.
  *
- * Macro is called in a loop for each argument in the string.
+ * @param _idx argument index.
  *
- * @param arg argument.
+ * @param _arg argument.
  */
-#define Z_CBPRINTF_PACK_ARG(arg) \
-	Z_CBPRINTF_PACK_ARG2(_pbuf, _pkg_len, _pkg_offset, _pmax, _flags, \
-			     _s_cnt, _s_buffer, arg)
+#define Z_CBPRINTF_PACK_STORE(_idx, _arg) \
+do { \
+	_pkg_len += Z_CBPRINTF_ARG_PAD(_pkg_align + _pkg_len, _arg); \
+	if (Z_CBPRINTF_IS_PCHAR(_arg)) { \
+		uint8_t _s_pos = (uint8_t)(_pkg_len / sizeof(int)); \
+		if (((_idx) > 0) && _rw_strs) { \
+			_pbuf[_args_len + _ro_cnt + _rw_idx++] = _s_pos; \
+		} else if (_str_idxs) { \
+			_pbuf[_args_len + _ro_idx++] = _s_pos; \
+		} \
+	} \
+	Z_CBPRINTF_STORE_ARG(&_pbuf[_pkg_len], _arg); \
+	_pkg_len += Z_CBPRINTF_ARG_SIZE(_arg); \
+} while (0)
 
 /** @brief Package descriptor.
  *
  * @param len Package length.
  *
  * @param str_cnt Number of strings stored in the package.
+ *
+ * @param ro_str_cnt Number of read only string locations in the package.
+ *
+ * @param rw_str_cnt Number of locations of possibly transient strings in the
+ * package, see @ref CBPRINTF_PACKAGE_ADD_RW_STR_POS.
  */
 struct z_cbprintf_desc {
 	uint8_t len;
 	uint8_t str_cnt;
 	uint8_t ro_str_cnt;
+	uint8_t rw_str_cnt;
 };
 
 /** @brief Package header. */
@@ -351,46 +374,42 @@ do { \
 	IF_ENABLED(CONFIG_CBPRINTF_STATIC_PACKAGE_CHECK_ALIGNMENT, \
 		(__ASSERT(!((uintptr_t)buf & (CBPRINTF_PACKAGE_ALIGNMENT - 1)), \
 			  "Buffer must be aligned.");)) \
-	bool str_idxs = _flags & CBPRINTF_PACKAGE_ADD_STRING_IDXS; \
+	bool _str_idxs = (_flags) & CBPRINTF_PACKAGE_ADD_STRING_IDXS; \
+	bool _rw_strs = (_flags) & CBPRINTF_PACKAGE_ADD_RW_STR_POS; \
 	uint8_t *_pbuf = buf; \
-	uint8_t _s_cnt = 0; \
-	uint16_t _s_buffer[16]; \
 	size_t _pmax = (buf != NULL) ? _inlen : INT32_MAX; \
-	int _pkg_len = 0; \
-	int _total_len = 0; \
-	int _pkg_offset = _align_offset; \
-	union z_cbprintf_hdr *_len_loc; \
-	/* package starts with string address and field with length */ \
-	if (_pmax < sizeof(union z_cbprintf_hdr)) { \
+	int _pkg_align = _align_offset; \
+	int _pkg_len = sizeof(union z_cbprintf_hdr); \
+	uint8_t _ro_cnt = 0; \
+	uint8_t _rw_cnt = 0; \
+	int _args_len; \
+	int _total_len; \
+	/* Layout depends only on argument types. */ \
+	FOR_EACH_IDX(Z_CBPRINTF_PACK_LAYOUT, (;), __VA_ARGS__); \
+	_args_len = _pkg_len; \
+	_total_len = _args_len + _ro_cnt + _rw_cnt; \
+	if (_total_len > (int)_pmax) { \
 		_outlen = -ENOSPC; \
 		break; \
 	} \
-	_len_loc = (union z_cbprintf_hdr *)_pbuf; \
-	_pkg_len += sizeof(union z_cbprintf_hdr); \
-	_pkg_offset += sizeof(union z_cbprintf_hdr); \
-	/* Pack remaining arguments */\
-	FOR_EACH(Z_CBPRINTF_PACK_ARG, (;), __VA_ARGS__);\
-	_total_len = _pkg_len; \
-	if (str_idxs) {\
-		_total_len += _s_cnt; \
-		if (_pbuf) { \
-			for (int i = 0; i < _s_cnt; i++) { \
-				_pbuf[_pkg_len + i] = _s_buffer[i]; \
-			} \
-		} \
-	} \
-	/* Store length */ \
-	_outlen = (_total_len > (int)_pmax) ? -ENOSPC : _total_len; \
-	/* Store length in the header, set number of dumped strings to 0 */ \
-	if (_pbuf) { \
-		union z_cbprintf_hdr hdr = { \
+	_outlen = _total_len; \
+	if (_pbuf != NULL) { \
+		/* package starts with a header followed by the arguments */ \
+		union z_cbprintf_hdr _hdr = { \
 			.desc = { \
-				.len = (uint8_t)(_pkg_len / sizeof(int)), \
+				.len = (uint8_t)(_args_len / sizeof(int)), \
 				.str_cnt = 0, \
-				.ro_str_cnt = str_idxs ? _s_cnt : (uint8_t)0, \
+				.ro_str_cnt = _ro_cnt, \
+				.rw_str_cnt = _rw_cnt, \
 			} \
 		}; \
-		*_len_loc = hdr; \
+		uint8_t _ro_idx = 0; \
+		uint8_t _rw_idx = 0; \
+		_pkg_len = sizeof(union z_cbprintf_hdr); \
+		FOR_EACH_IDX(Z_CBPRINTF_PACK_STORE, (;), __VA_ARGS__); \
+		*(union z_cbprintf_hdr *)_pbuf = _hdr; \
+		(void)_ro_idx; \
+		(void)_rw_idx; \
 	} \
 	_Pragma("GCC diagnostic pop") \
 } while (0)
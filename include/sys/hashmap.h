@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Open addressing hash map
+ *
+ * This implements an intrusive hash map using open addressing with
+ * linear probing.  As with the other Zephyr containers, the struct
+ * sys_hashmap_node handle is intended to be embedded in a user
+ * struct, and the map itself only stores pointers to those handles
+ * in its slot table.  Removal uses backward shift deletion, so the
+ * slot table never accumulates tombstones.
+ *
+ * The slot table is either a static array provided at definition
+ * time, in which case the map never grows, or is allocated from a
+ * sys_heap, in which case the map doubles its capacity when it gets
+ * 3/4 full.  Growing is incremental: the entries of the old table
+ * are moved to the new one a few slots at a time on each following
+ * insertion and removal, so no single operation has to rehash the
+ * whole map.
+ *
+ * Like the other data structures, the hash map is not synchronized.
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_HASHMAP_H_
+#define ZEPHYR_INCLUDE_SYS_HASHMAP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/sys_heap.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup hashmap_apis Hash Map
+ * @ingroup datastructure_apis
+ * @{
+ */
+
+/**
+ * @brief Hash map node
+ *
+ * Only the cached hash of the node's key is stored in the node, the
+ * key itself lives in the user struct containing the node.
+ */
+struct sys_hashmap_node {
+	uint32_t hash;
+};
+
+/**
+ * @typedef sys_hashmap_hash_t
+ * @brief Hash map hash function
+ *
+ * Computes the 32-bit hash of a key.  Slots are selected with the
+ * low bits of the hash, so these should be well distributed.  The
+ * sys_hash32_*() helpers below can be used to build hash functions.
+ */
+typedef uint32_t (*sys_hashmap_hash_t)(const void *key);
+
+/**
+ * @typedef sys_hashmap_key_eq_t
+ * @brief Hash map key comparison predicate
+ *
+ * Returns true if the key of the user struct containing @p node is
+ * equal to @p key.  It is only called for nodes with a matching hash.
+ */
+typedef bool (*sys_hashmap_key_eq_t)(const struct sys_hashmap_node *node,
+				     const void *key);
+
+/**
+ * @typedef sys_hashmap_visit_t
+ * @brief Hash map visitor callback
+ */
+typedef void (*sys_hashmap_visit_t)(struct sys_hashmap_node *node,
+				    void *cookie);
+
+/**
+ * @brief Hash map
+ */
+struct sys_hashmap {
+	/* Slot table, power of two number of entries */
+	struct sys_hashmap_node **slots;
+	uint32_t capacity;
+
+	/* Number of nodes in the map */
+	uint32_t size;
+
+	/* Table being migrated to the slot table while growing */
+	struct sys_hashmap_node **old_slots;
+	uint32_t old_capacity;
+	uint32_t old_size;
+	uint32_t migrate_idx;
+
+	sys_hashmap_hash_t hash_fn;
+	sys_hashmap_key_eq_t key_eq_fn;
+
+	/* Heap the slot tables come from, NULL for a static table */
+	struct sys_heap *heap;
+};
+
+/**
+ * @brief Statically define a hash map with a fixed slot table
+ *
+ * The map never grows.  It holds at most @p n_slots - 1 nodes, but
+ * lookups get slower as it fills up, so it should be sized to stay
+ * below 3/4 full.
+ *
+ * @param name Name of the hash map
+ * @param n_slots Number of slots, must be a power of two
+ * @param hash Hash function, see @ref sys_hashmap_hash_t
+ * @param key_eq Key comparison function, see @ref sys_hashmap_key_eq_t
+ */
+#define SYS_HASHMAP_DEFINE_STATIC(name, n_slots, hash, key_eq)		\
+	static struct sys_hashmap_node *_sys_hashmap_slots_##name[n_slots]; \
+	struct sys_hashmap name = {					\
+		.slots = _sys_hashmap_slots_##name,			\
+		.capacity = (n_slots),					\
+		.hash_fn = (hash),					\
+		.key_eq_fn = (key_eq),					\
+	}
+
+/**
+ * @brief Initialize a hash map backed by a heap
+ *
+ * The slot table is allocated from @p heap on first insertion and
+ * grown as needed.
+ *
+ * @param map Hash map to initialize
+ * @param hash_fn Hash function
+ * @param key_eq_fn Key comparison function
+ * @param heap Heap to allocate slot tables from
+ */
+void sys_hashmap_init(struct sys_hashmap *map, sys_hashmap_hash_t hash_fn,
+		      sys_hashmap_key_eq_t key_eq_fn, struct sys_heap *heap);
+
+/**
+ * @brief Initialize a hash map with a fixed slot table
+ *
+ * Same as SYS_HASHMAP_DEFINE_STATIC(), for slot tables provided at
+ * runtime.
+ *
+ * @param map Hash map to initialize
+ * @param hash_fn Hash function
+ * @param key_eq_fn Key comparison function
+ * @param slots Slot table
+ * @param n_slots Number of slots, must be a power of two
+ */
+void sys_hashmap_init_static(struct sys_hashmap *map,
+			     sys_hashmap_hash_t hash_fn,
+			     sys_hashmap_key_eq_t key_eq_fn,
+			     struct sys_hashmap_node **slots,
+			     uint32_t n_slots);
+
+/**
+ * @brief Insert a node into the hash map
+ *
+ * @param map Hash map
+ * @param node Node to insert, embedded in the struct holding @p key
+ * @param key Key of the node
+ *
+ * @retval 0 Node inserted
+ * @retval -EEXIST A node with an equal key is already in the map
+ * @retval -ENOMEM The map is full and cannot grow
+ */
+int sys_hashmap_insert(struct sys_hashmap *map, struct sys_hashmap_node *node,
+		       const void *key);
+
+/**
+ * @brief Look up a key in the hash map
+ *
+ * @param map Hash map
+ * @param key Key to look up
+ *
+ * @return The node with an equal key, or NULL if there is none
+ */
+struct sys_hashmap_node *sys_hashmap_get(struct sys_hashmap *map,
+					 const void *key);
+
+/**
+ * @brief Remove a key from the hash map
+ *
+ * @param map Hash map
+ * @param key Key to remove
+ *
+ * @return The removed node, or NULL if there was none
+ */
+struct sys_hashmap_node *sys_hashmap_remove(struct sys_hashmap *map,
+					    const void *key);
+
+/**
+ * @brief Remove a node from the hash map
+ *
+ * Unlike sys_hashmap_remove(), this does not call the key comparison
+ * function, the node is identified by its address.
+ *
+ * @param map Hash map
+ * @param node Node to remove
+ *
+ * @return true if the node was in the map, false otherwise
+ */
+bool sys_hashmap_remove_node(struct sys_hashmap *map,
+			     struct sys_hashmap_node *node);
+
+/**
+ * @brief Remove all nodes from the hash map
+ *
+ * Slot tables allocated from the heap are released.
+ *
+ * @param map Hash map
+ */
+void sys_hashmap_clear(struct sys_hashmap *map);
+
+/**
+ * @brief Walk all nodes of the hash map
+ *
+ * Nodes are visited in no particular order.  The map must not be
+ * modified from @p visit_fn.
+ *
+ * @param map Hash map
+ * @param visit_fn Function called for each node
+ * @param cookie Argument passed to @p visit_fn
+ */
+void sys_hashmap_walk(struct sys_hashmap *map, sys_hashmap_visit_t visit_fn,
+		      void *cookie);
+
+/**
+ * @brief Number of nodes in the hash map
+ */
+static inline uint32_t sys_hashmap_size(const struct sys_hashmap *map)
+{
+	return map->size;
+}
+
+/**
+ * @brief Hash a 32-bit integer
+ *
+ * Uses the MurmurHash3 finalizer, which mixes every input bit into
+ * the low bits of the result.
+ */
+static inline uint32_t sys_hash32_u32(uint32_t val)
+{
+	val ^= val >> 16;
+	val *= 0x85ebca6bU;
+	val ^= val >> 13;
+	val *= 0xc2b2ae35U;
+	val ^= val >> 16;
+
+	return val;
+}
+
+/**
+ * @brief Hash a buffer of bytes
+ *
+ * Uses the 32-bit FNV-1a hash.
+ */
+static inline uint32_t sys_hash32_fnv1a(const void *data, size_t len)
+{
+	const uint8_t *p = (const uint8_t *)data;
+	uint32_t hash = 2166136261U;
+
+	while (len-- > 0) {
+		hash ^= *p++;
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_HASHMAP_H_ */
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Least recently used cache
+ *
+ * An intrusive LRU cache combining a sys_hashmap for lookups with a
+ * dlist ordering the entries by last use.  The cache holds a bounded
+ * number of entries: inserting into a full cache evicts the least
+ * recently used entry and hands it back to the caller, who owns the
+ * memory of all entries and can reuse it for the new one.
+ *
+ * Like the other data structures, the cache is not synchronized.
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_LRU_CACHE_H_
+#define ZEPHYR_INCLUDE_SYS_LRU_CACHE_H_
+
+#include <sys/dlist.h>
+#include <sys/hashmap.h>
+#include <sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup lru_cache_apis LRU Cache
+ * @ingroup datastructure_apis
+ * @{
+ */
+
+/**
+ * @brief LRU cache entry
+ *
+ * The key comparison function of the cache is passed the @a hnode
+ * member of the entry.
+ */
+struct sys_lru_cache_node {
+	struct sys_hashmap_node hnode;
+	sys_dnode_t lnode;
+};
+
+/**
+ * @brief LRU cache
+ */
+struct sys_lru_cache {
+	struct sys_hashmap map;
+
+	/* Entries, most recently used first */
+	sys_dlist_t lru;
+
+	/* Maximum number of entries */
+	uint32_t max_entries;
+};
+
+/**
+ * @brief Statically define an LRU cache with a fixed slot table
+ *
+ * @param name Name of the cache
+ * @param n_slots Number of hash map slots, must be a power of two
+ * @param max Maximum number of entries, less than @p n_slots
+ * @param hash Hash function, see @ref sys_hashmap_hash_t
+ * @param key_eq Key comparison function, see @ref sys_hashmap_key_eq_t
+ */
+#define SYS_LRU_CACHE_DEFINE_STATIC(name, n_slots, max, hash, key_eq)	\
+	static struct sys_hashmap_node					\
+		*_sys_lru_cache_slots_##name[n_slots];			\
+	struct sys_lru_cache name = {					\
+		.map = {						\
+			.slots = _sys_lru_cache_slots_##name,		\
+			.capacity = (n_slots),				\
+			.hash_fn = (hash),				\
+			.key_eq_fn = (key_eq),				\
+		},							\
+		.lru = SYS_DLIST_STATIC_INIT(&name.lru),		\
+		.max_entries = (max),					\
+	}
+
+/**
+ * @brief Initialize an LRU cache backed by a heap
+ *
+ * @param cache Cache to initialize
+ * @param hash_fn Hash function
+ * @param key_eq_fn Key comparison function
+ * @param heap Heap to allocate hash map slot tables from
+ * @param max_entries Maximum number of entries
+ */
+void sys_lru_cache_init(struct sys_lru_cache *cache,
+			sys_hashmap_hash_t hash_fn,
+			sys_hashmap_key_eq_t key_eq_fn,
+			struct sys_heap *heap, uint32_t max_entries);
+
+/**
+ * @brief Look up an entry and mark it as most recently used
+ *
+ * @param cache Cache
+ * @param key Key to look up
+ *
+ * @return The entry with an equal key, or NULL if there is none
+ */
+struct sys_lru_cache_node *sys_lru_cache_get(struct sys_lru_cache *cache,
+					     const void *key);
+
+/**
+ * @brief Look up an entry without changing the usage order
+ *
+ * @param cache Cache
+ * @param key Key to look up
+ *
+ * @return The entry with an equal key, or NULL if there is none
+ */
+struct sys_lru_cache_node *sys_lru_cache_peek(struct sys_lru_cache *cache,
+					      const void *key);
+
+/**
+ * @brief Insert an entry as the most recently used one
+ *
+ * If the cache is full, the least recently used entry is removed and
+ * returned through @p evicted. Nothing is removed when the entry cannot
+ * be inserted.
+ *
+ * @param cache Cache
+ * @param node Entry to insert, embedded in the struct holding @p key
+ * @param key Key of the entry
+ * @param evicted Set to the evicted entry, or NULL if none was.
+ *                Can be NULL.
+ *
+ * @retval 0 Entry inserted
+ * @retval -EEXIST An entry with an equal key is already cached
+ * @retval -ENOMEM The hash map cannot hold the entry
+ */
+int sys_lru_cache_put(struct sys_lru_cache *cache,
+		      struct sys_lru_cache_node *node, const void *key,
+		      struct sys_lru_cache_node **evicted);
+
+/**
+ * @brief Remove an entry from the cache
+ *
+ * @param cache Cache
+ * @param key Key to remove
+ *
+ * @return The removed entry, or NULL if there was none
+ */
+struct sys_lru_cache_node *sys_lru_cache_remove(struct sys_lru_cache *cache,
+						const void *key);
+
+/**
+ * @brief Least recently used entry of the cache
+ *
+ * @param cache Cache
+ *
+ * @return The least recently used entry, or NULL if the cache is empty
+ */
+static inline struct sys_lru_cache_node *
+sys_lru_cache_oldest(struct sys_lru_cache *cache)
+{
+	sys_dnode_t *lnode = sys_dlist_peek_tail(&cache->lru);
+
+	return (lnode != NULL) ?
+		CONTAINER_OF(lnode, struct sys_lru_cache_node, lnode) : NULL;
+}
+
+/**
+ * @brief Number of entries in the cache
+ */
+static inline uint32_t sys_lru_cache_size(const struct sys_lru_cache *cache)
+{
+	return sys_hashmap_size(&cache->map);
+}
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_LRU_CACHE_H_ */
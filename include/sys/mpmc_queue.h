@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Lock-free bounded multi producer, multi consumer queue
+ *
+ * This is Dmitry Vyukov's bounded MPMC queue.  Every cell of the
+ * queue carries a sequence number telling whether it is ready to be
+ * written or read for a given lap around the queue.  Producers and
+ * consumers claim a position with a single compare-and-swap on the
+ * enqueue or dequeue index and then only touch their own cell, so
+ * there is no lock to hold and the queue can be used from ISRs and
+ * from any number of CPUs.
+ *
+ * The operations never block: enqueueing into a full queue and
+ * dequeueing from an empty one fail immediately.  A consumer which
+ * finds the cell at its position claimed but not yet written by a
+ * preempted producer also sees the queue as empty.
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_MPMC_QUEUE_H_
+#define ZEPHYR_INCLUDE_SYS_MPMC_QUEUE_H_
+
+#include <kernel.h>
+#include <sys/atomic.h>
+#include <sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup mpmc_queue_apis MPMC Queue
+ * @ingroup datastructure_apis
+ * @{
+ */
+
+/**
+ * @brief Multi producer, multi consumer queue
+ */
+struct mpmc_queue {
+	/* Read-only after initialization */
+	uint8_t *cells;
+	uint32_t mask;
+	uint32_t elem_size;
+	uint32_t cell_size;
+#ifdef CONFIG_POLL
+	struct k_poll_signal *signal;
+#endif
+
+	atomic_t enqueue_pos __aligned(CONFIG_LOCKFREE_INDEX_ALIGN);
+	atomic_t dequeue_pos __aligned(CONFIG_LOCKFREE_INDEX_ALIGN);
+};
+
+/* Size of a cell: the sequence number followed by the element */
+#define Z_MPMC_QUEUE_CELL_SIZE(esize) \
+	ROUND_UP(sizeof(atomic_t) + (esize), sizeof(atomic_t))
+
+/**
+ * @brief Statically define and initialize an MPMC queue
+ *
+ * @param name Name of the queue
+ * @param esize Size of an element in bytes
+ * @param n_elems Number of elements, must be a power of two
+ */
+#define MPMC_QUEUE_DEFINE(name, esize, n_elems)				\
+	BUILD_ASSERT(((n_elems) & ((n_elems) - 1)) == 0,		\
+		     "MPMC queue size must be a power of two");		\
+	static uint8_t _mpmc_queue_cells_##name				\
+		[Z_MPMC_QUEUE_CELL_SIZE(esize) * (n_elems)]		\
+		__aligned(sizeof(atomic_t));				\
+	struct mpmc_queue name = {					\
+		.cells = _mpmc_queue_cells_##name,			\
+		.mask = (n_elems) - 1,					\
+		.elem_size = (esize),					\
+		.cell_size = Z_MPMC_QUEUE_CELL_SIZE(esize),		\
+	}
+
+/**
+ * @brief Initialize an MPMC queue
+ *
+ * @param queue Queue to initialize
+ * @param buffer Storage for @p n_elems cells of
+ *               Z_MPMC_QUEUE_CELL_SIZE(@p elem_size) bytes, aligned
+ *               to sizeof(atomic_t)
+ * @param elem_size Size of an element in bytes
+ * @param n_elems Number of elements, must be a power of two
+ */
+void mpmc_queue_init(struct mpmc_queue *queue, void *buffer,
+		     uint32_t elem_size, uint32_t n_elems);
+
+/**
+ * @brief Add an element to the queue
+ *
+ * @param queue Queue
+ * @param data Element to copy into the queue
+ *
+ * @retval 0 Element added
+ * @retval -ENOMEM The queue is full
+ */
+int mpmc_queue_put(struct mpmc_queue *queue, const void *data);
+
+/**
+ * @brief Remove an element from the queue
+ *
+ * @param queue Queue
+ * @param data Buffer for the element
+ *
+ * @retval 0 Element removed
+ * @retval -EAGAIN The queue is empty
+ */
+int mpmc_queue_get(struct mpmc_queue *queue, void *data);
+
+/**
+ * @brief Approximate number of elements in the queue
+ */
+static inline uint32_t mpmc_queue_size_get(struct mpmc_queue *queue)
+{
+	return (uint32_t)atomic_get(&queue->enqueue_pos)
+		- (uint32_t)atomic_get(&queue->dequeue_pos);
+}
+
+#if defined(CONFIG_POLL) || defined(__DOXYGEN__)
+/**
+ * @brief Raise a poll signal when an element is added to an empty queue
+ *
+ * Consumers waiting with k_poll() on K_POLL_TYPE_SIGNAL must reset the
+ * signal before they start emptying the queue, as described for
+ * spsc_ring_signal_set().
+ *
+ * @param queue Queue
+ * @param signal Signal to raise, NULL to disable
+ */
+static inline void mpmc_queue_signal_set(struct mpmc_queue *queue,
+					 struct k_poll_signal *signal)
+{
+	queue->signal = signal;
+}
+#endif
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_MPMC_QUEUE_H_ */
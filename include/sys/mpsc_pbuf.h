@@ -168,6 +168,19 @@ union mpsc_pbuf_generic *mpsc_pbuf_alloc(struct mpsc_pbuf_buffer *buffer,
 void mpsc_pbuf_commit(struct mpsc_pbuf_buffer *buffer,
 			union mpsc_pbuf_generic *packet);
 
+/** @brief Discard a packet instead of committing it.
+ *
+ * The space is released to the consumer side as a skip packet, so the
+ * packet is never claimed. Its header must allow @ref mpsc_pbuf_get_wlen
+ * to return the length given to @ref mpsc_pbuf_alloc.
+ *
+ * @param buffer Buffer.
+ *
+ * @param packet Pointer to a packet allocated by @ref mpsc_pbuf_alloc.
+ */
+void mpsc_pbuf_discard(struct mpsc_pbuf_buffer *buffer,
+		       union mpsc_pbuf_generic *packet);
+
 /** @brief Put single word packet into a buffer.
  *
  * Function is optimized for storing a packet which fit into a single word.
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Lock-free single producer, single consumer ring
+ *
+ * The ring stores fixed size elements (use an element size of 1 for
+ * a byte stream) and needs no locking as long as there is only one
+ * producer and one consumer, e.g. an ISR and a thread, or threads on
+ * two CPUs.  Both put and get are wait-free.
+ *
+ * The producer only writes the head index and the consumer only
+ * writes the tail index.  Both are aligned to
+ * CONFIG_LOCKFREE_INDEX_ALIGN so they do not share a cache line, and
+ * each side keeps a cached copy of the other side's index so that it
+ * only has to read the shared one when the ring looks full or empty.
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_SPSC_RING_H_
+#define ZEPHYR_INCLUDE_SYS_SPSC_RING_H_
+
+#include <kernel.h>
+#include <sys/atomic.h>
+#include <sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup spsc_ring_apis SPSC Ring
+ * @ingroup datastructure_apis
+ * @{
+ */
+
+/**
+ * @brief Single producer, single consumer ring
+ */
+struct spsc_ring {
+	/* Read-only after initialization */
+	uint8_t *buffer;
+	uint32_t mask;
+	uint32_t elem_size;
+#ifdef CONFIG_POLL
+	struct k_poll_signal *signal;
+#endif
+
+	/* Producer side */
+	atomic_t head __aligned(CONFIG_LOCKFREE_INDEX_ALIGN);
+	uint32_t cached_tail;
+
+	/* Consumer side */
+	atomic_t tail __aligned(CONFIG_LOCKFREE_INDEX_ALIGN);
+	uint32_t cached_head;
+};
+
+/**
+ * @brief Statically define and initialize an SPSC ring
+ *
+ * @param name Name of the ring
+ * @param esize Size of an element in bytes
+ * @param n_elems Number of elements, must be a power of two
+ */
+#define SPSC_RING_DEFINE(name, esize, n_elems)				\
+	BUILD_ASSERT(((n_elems) & ((n_elems) - 1)) == 0,		\
+		     "SPSC ring size must be a power of two");		\
+	static uint8_t __noinit						\
+		_spsc_ring_buffer_##name[(esize) * (n_elems)];		\
+	struct spsc_ring name = {					\
+		.buffer = _spsc_ring_buffer_##name,			\
+		.mask = (n_elems) - 1,					\
+		.elem_size = (esize),					\
+	}
+
+/**
+ * @brief Initialize an SPSC ring
+ *
+ * @param ring Ring to initialize
+ * @param buffer Storage for @p n_elems elements
+ * @param elem_size Size of an element in bytes
+ * @param n_elems Number of elements, must be a power of two
+ */
+void spsc_ring_init(struct spsc_ring *ring, void *buffer, uint32_t elem_size,
+		    uint32_t n_elems);
+
+/**
+ * @brief Put elements into the ring
+ *
+ * Only to be called by the producer.
+ *
+ * @param ring Ring
+ * @param data Elements to put
+ * @param n Number of elements to put
+ *
+ * @return Number of elements put, less than @p n if the ring got full
+ */
+uint32_t spsc_ring_put(struct spsc_ring *ring, const void *data, uint32_t n);
+
+/**
+ * @brief Get elements from the ring
+ *
+ * Only to be called by the consumer.
+ *
+ * @param ring Ring
+ * @param data Buffer for the elements
+ * @param n Maximum number of elements to get
+ *
+ * @return Number of elements copied to @p data
+ */
+uint32_t spsc_ring_get(struct spsc_ring *ring, void *data, uint32_t n);
+
+/**
+ * @brief Number of elements in the ring
+ *
+ * The result is only a snapshot when called concurrently with the
+ * producer or the consumer.
+ */
+static inline uint32_t spsc_ring_size_get(struct spsc_ring *ring)
+{
+	return (uint32_t)atomic_get(&ring->head)
+		- (uint32_t)atomic_get(&ring->tail);
+}
+
+/**
+ * @brief Number of free elements in the ring
+ *
+ * The result is only a snapshot when called concurrently with the
+ * producer or the consumer.
+ */
+static inline uint32_t spsc_ring_space_get(struct spsc_ring *ring)
+{
+	return ring->mask + 1U - spsc_ring_size_get(ring);
+}
+
+#if defined(CONFIG_POLL) || defined(__DOXYGEN__)
+/**
+ * @brief Raise a poll signal when data is put into an empty ring
+ *
+ * The signal is raised by spsc_ring_put() whenever it finds that the
+ * consumer had emptied the ring, so a consumer can wait with
+ * k_poll() on K_POLL_TYPE_SIGNAL.  The consumer must reset the signal
+ * before it starts emptying the ring again, so that no wakeup is lost:
+ *
+ * @code
+ * for (;;) {
+ *	k_poll(&event, 1, K_FOREVER);
+ *	k_poll_signal_reset(&signal);
+ *	event.state = K_POLL_STATE_NOT_READY;
+ *	while (spsc_ring_get(&ring, &elem, 1) == 1) {
+ *		process(&elem);
+ *	}
+ * }
+ * @endcode
+ *
+ * @param ring Ring
+ * @param signal Signal to raise, NULL to disable
+ */
+static inline void spsc_ring_signal_set(struct spsc_ring *ring,
+					struct k_poll_signal *signal)
+{
+	ring->signal = signal;
+}
+#endif
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_SPSC_RING_H_ */
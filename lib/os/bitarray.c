@@ -45,6 +45,180 @@ static void setup_bundle_data(sys_bitarray_t *bitarray,
 	}
 }
 
+/*
+ * Update bookkeeping after bundles have been modified.
+ *
+ * @param bitarray Bitarray struct
+ * @param sidx     Index of the first modified bundle
+ * @param eidx     Index of the last modified bundle
+ * @param cleared  True if bits may have been cleared
+ */
+static void bundles_changed(sys_bitarray_t *bitarray, size_t sidx,
+			    size_t eidx, bool cleared)
+{
+	if (cleared && (sidx < bitarray->first_free)) {
+		bitarray->first_free = sidx;
+	}
+
+#ifdef CONFIG_SYS_BITARRAY_SUMMARY
+	size_t idx;
+
+	for (idx = sidx; idx <= eidx; idx++) {
+		if (bitarray->bundles[idx] == ~0U) {
+			bitarray->summary[idx / 32] |= BIT(idx % 32);
+		} else {
+			bitarray->summary[idx / 32] &= ~BIT(idx % 32);
+		}
+	}
+#else
+	ARG_UNUSED(eidx);
+#endif
+}
+
+/*
+ * Find the first bundle, starting from @p idx, which has cleared bits.
+ *
+ * @param bitarray Bitarray struct
+ * @param idx      Index of the bundle to start searching from
+ *
+ * @return Index of the bundle, or number of bundles if all are set.
+ */
+static size_t next_free_bundle(sys_bitarray_t *bitarray, size_t idx)
+{
+#ifdef CONFIG_SYS_BITARRAY_SUMMARY
+	uint32_t full;
+
+	while (idx < bitarray->num_bundles) {
+		/* Skip 32 fully set bundles at a time */
+		full = bitarray->summary[idx / 32] | (BIT(idx % 32) - 1);
+		if (full == ~0U) {
+			idx = ROUND_DOWN(idx, 32) + 32;
+			continue;
+		}
+
+		idx = ROUND_DOWN(idx, 32) + find_lsb_set(~full) - 1;
+		if (idx >= bitarray->num_bundles) {
+			break;
+		}
+
+		if (bitarray->bundles[idx] != ~0U) {
+			return idx;
+		}
+
+		/* Bundle was filled without going through the API
+		 * (e.g. pre-populated), so record it now.
+		 */
+		bitarray->summary[idx / 32] |= BIT(idx % 32);
+		idx++;
+	}
+
+	return bitarray->num_bundles;
+#else
+	while ((idx < bitarray->num_bundles)
+	       && (bitarray->bundles[idx] == ~0U)) {
+		idx++;
+	}
+
+	return idx;
+#endif
+}
+
+/*
+ * Find the first set bit in [from, to).
+ *
+ * @param bitarray Bitarray struct
+ * @param from     Starting bit location
+ * @param to       Bit location to stop at (at most num_bits)
+ *
+ * @return Offset to the first set bit, or @p to if there is none.
+ */
+static size_t next_set_bit(sys_bitarray_t *bitarray, size_t from, size_t to)
+{
+	size_t idx = from / bundle_bitness(bitarray);
+	uint32_t bundle;
+	size_t bit;
+
+	bundle = bitarray->bundles[idx]
+		 & ~(BIT(from % bundle_bitness(bitarray)) - 1);
+
+	/* Whole bundles of cleared bits are skipped in one step */
+	while (bundle == 0U) {
+		idx++;
+		if ((idx * bundle_bitness(bitarray)) >= to) {
+			return to;
+		}
+
+		bundle = bitarray->bundles[idx];
+	}
+
+	bit = idx * bundle_bitness(bitarray) + find_lsb_set(bundle) - 1;
+
+	return MIN(bit, to);
+}
+
+/*
+ * Find the lowest region of cleared bits large enough for an allocation.
+ *
+ * Instead of matching the region bit by bit, this works on whole
+ * bundles: the start of a candidate region is the lowest cleared bit
+ * in the first non-full bundle, and the candidate is rejected at the
+ * next set bit, which becomes the new search position.
+ *
+ * @param[in]  bitarray Bitarray struct
+ * @param[in]  num_bits Number of bits in the region
+ * @param[out] offset   Offset to the start of the region if found
+ *
+ * @retval     true     A region has been found
+ * @retval     false    No region is large enough
+ */
+static bool find_free_region(sys_bitarray_t *bitarray, size_t num_bits,
+			     size_t *offset)
+{
+	size_t idx, bit_idx, end;
+	uint32_t bundle;
+
+	/* All bundles up to the first non-full one are set, so
+	 * remember it as the starting point for later searches.
+	 */
+	idx = next_free_bundle(bitarray, bitarray->first_free);
+	bitarray->first_free = idx;
+
+	bit_idx = idx * bundle_bitness(bitarray);
+
+	while ((bit_idx + num_bits) <= bitarray->num_bits) {
+		/* Find the first cleared bit at or after bit_idx */
+		idx = bit_idx / bundle_bitness(bitarray);
+		bundle = bitarray->bundles[idx]
+			 | (BIT(bit_idx % bundle_bitness(bitarray)) - 1);
+
+		if (bundle == ~0U) {
+			idx = next_free_bundle(bitarray, idx + 1);
+			bit_idx = idx * bundle_bitness(bitarray);
+			continue;
+		}
+
+		bit_idx = idx * bundle_bitness(bitarray)
+			  + find_lsb_set(~bundle) - 1;
+
+		end = bit_idx + num_bits;
+		if (end > bitarray->num_bits) {
+			break;
+		}
+
+		/* Check if the run of cleared bits is long enough */
+		end = next_set_bit(bitarray, bit_idx, end);
+		if (end == (bit_idx + num_bits)) {
+			*offset = bit_idx;
+			return true;
+		}
+
+		/* Fast-forward to the bit just after the set bit */
+		bit_idx = end + 1;
+	}
+
+	return false;
+}
+
 /*
  * Find out if the bits in a region is all set or all clear.
  *
@@ -213,6 +387,8 @@ static void set_region(sys_bitarray_t *bitarray, size_t offset,
 			}
 		}
 	}
+
+	bundles_changed(bitarray, bd->sidx, bd->eidx, !to_set);
 }
 
 int sys_bitarray_set_bit(sys_bitarray_t *bitarray, size_t bit)
@@ -234,6 +410,7 @@ int sys_bitarray_set_bit(sys_bitarray_t *bitarray, size_t bit)
 	off = bit % bundle_bitness(bitarray);
 
 	bitarray->bundles[idx] |= BIT(off);
+	bundles_changed(bitarray, idx, idx, false);
 
 	ret = 0;
 
@@ -261,6 +438,7 @@ int sys_bitarray_clear_bit(sys_bitarray_t *bitarray, size_t bit)
 	off = bit % bundle_bitness(bitarray);
 
 	bitarray->bundles[idx] &= ~BIT(off);
+	bundles_changed(bitarray, idx, idx, true);
 
 	ret = 0;
 
@@ -335,6 +513,7 @@ int sys_bitarray_test_and_set_bit(sys_bitarray_t *bitarray, size_t bit, int *pre
 	}
 
 	bitarray->bundles[idx] |= BIT(off);
+	bundles_changed(bitarray, idx, idx, false);
 
 	ret = 0;
 
@@ -373,6 +552,7 @@ int sys_bitarray_test_and_clear_bit(sys_bitarray_t *bitarray, size_t bit, int *p
 	}
 
 	bitarray->bundles[idx] &= ~BIT(off);
+	bundles_changed(bitarray, idx, idx, true);
 
 	ret = 0;
 
@@ -385,11 +565,8 @@ int sys_bitarray_alloc(sys_bitarray_t *bitarray, size_t num_bits,
 		       size_t *offset)
 {
 	k_spinlock_key_t key;
-	uint32_t bit_idx;
+	size_t bit_idx;
 	int ret;
-	struct bundle_data bd;
-	size_t off_start, off_end;
-	size_t mismatch;
 
 	key = k_spin_lock(&bitarray->lock);
 
@@ -405,48 +582,13 @@ int sys_bitarray_alloc(sys_bitarray_t *bitarray, size_t num_bits,
 		goto out;
 	}
 
-	bit_idx = 0;
-
-	/* Find the first non-allocated bit by looking at bundles
-	 * instead of individual bits.
-	 *
-	 * On RISC-V 64-bit, it complains about undefined reference to `ffs`.
-	 * So don't use this on RISCV64.
-	 */
-	for (ret = 0; ret < bitarray->num_bundles; ret++) {
-		if (~bitarray->bundles[ret] == 0U) {
-			/* bundle is all 1s => all allocated, skip */
-			bit_idx += bundle_bitness(bitarray);
-			continue;
-		}
-
-		if (bitarray->bundles[ret] != 0U) {
-			/* Find the first free bit in bundle if not all free */
-			off_start = find_lsb_set(~bitarray->bundles[ret]) - 1;
-			bit_idx += off_start;
-		}
-
-		break;
-	}
-
-	off_end = bitarray->num_bits - num_bits;
-	ret = -ENOSPC;
-	while (bit_idx <= off_end) {
-		if (match_region(bitarray, bit_idx, num_bits, false,
-				 &bd, &mismatch)) {
-			off_end = bit_idx + num_bits - 1;
-
-			set_region(bitarray, bit_idx, num_bits, true, &bd);
-
-			*offset = bit_idx;
-			ret = 0;
-			break;
-		}
+	if (find_free_region(bitarray, num_bits, &bit_idx)) {
+		set_region(bitarray, bit_idx, num_bits, true, NULL);
 
-		/* Fast-forward to the bit just after
-		 * the mismatched bit.
-		 */
-		bit_idx = mismatch + 1;
+		*offset = bit_idx;
+		ret = 0;
+	} else {
+		ret = -ENOSPC;
 	}
 
 out:
@@ -739,6 +739,51 @@ static void _ldiv10(uint64_t *v)
 	_ldiv5(v);
 }
 
+/* High 64 bits of the 128-bit product of two 64-bit values */
+static inline uint64_t _umul64_hi(uint64_t a, uint64_t b)
+{
+#ifdef __SIZEOF_INT128__
+	return (uint64_t)(((unsigned __int128)a * b) >> 64);
+#else
+	uint32_t a_lo = a;
+	uint32_t a_hi = a >> 32;
+	uint32_t b_lo = b;
+	uint32_t b_hi = b >> 32;
+	uint64_t lo = (uint64_t)a_lo * b_lo;
+	uint64_t mid1 = (uint64_t)a_hi * b_lo + (lo >> 32);
+	uint64_t mid2 = (uint64_t)a_lo * b_hi + (uint32_t)mid1;
+
+	return (uint64_t)a_hi * b_hi + (mid1 >> 32) + (mid2 >> 32);
+#endif
+}
+
+/* Division by 10^8, used to split 64-bit values into 32-bit chunks
+ * of decimal digits.  On 32-bit architectures this multiplies by the
+ * reciprocal, (1 << 90) / 10^8 rounded up, which is exact for every
+ * 64-bit dividend, rather than pulling in the libgcc division.
+ */
+static inline uint64_t _ldiv1e8(uint64_t v)
+{
+	if (IS_ENABLED(CONFIG_64BIT)) {
+		return v / 100000000U;
+	}
+
+	return _umul64_hi(v, 0xabcc77118461cefdULL) >> 26;
+}
+
+/* Two-digit decimal conversion table */
+static const char digit_pairs[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
 /* Extract the next decimal character in the converted representation of a
  * fractional component.
  */
@@ -775,6 +820,55 @@ static inline size_t conversion_radix(char specifier)
 	}
 }
 
+/* Prepend the two decimal digits of a value below 100 to the buffer
+ * ending at bp.
+ */
+static inline char *put_digit_pair(char *bp, unsigned int v)
+{
+	bp -= 2;
+	bp[0] = digit_pairs[2U * v];
+	bp[1] = digit_pairs[2U * v + 1U];
+
+	return bp;
+}
+
+/* Writes the decimal representation of a value into the buffer ending
+ * at bp, two digits per division, and returns the first character.  The
+ * buffer must have room for all the digits of the value.
+ */
+static char *encode_uint_dec(uint_value_type value, char *bp)
+{
+	uint32_t v;
+
+#ifdef CONFIG_CBPRINTF_FULL_INTEGRAL
+	/* Split off chunks of eight digits until the rest fits 32 bits. */
+	while (value > UINT32_MAX) {
+		uint64_t q = _ldiv1e8(value);
+		uint32_t r = (uint32_t)(value - (q * 100000000U));
+
+		for (int i = 0; i < 4; i++) {
+			bp = put_digit_pair(bp, r % 100U);
+			r /= 100U;
+		}
+		value = q;
+	}
+#endif /* CONFIG_CBPRINTF_FULL_INTEGRAL */
+
+	v = (uint32_t)value;
+	while (v >= 100U) {
+		bp = put_digit_pair(bp, v % 100U);
+		v /= 100U;
+	}
+
+	if (v >= 10U) {
+		bp = put_digit_pair(bp, v);
+	} else {
+		*--bp = '0' + v;
+	}
+
+	return bp;
+}
+
 /* Writes the given value into the buffer in the specified base.
  *
  * Precision is applied *ONLY* within the space allowed.
@@ -794,13 +888,29 @@ static char *encode_uint(uint_value_type value,
 	const unsigned int radix = conversion_radix(conv->specifier);
 	char *bp = bps + (bpe - bps);
 
-	do {
-		unsigned int lsv = (unsigned int)(value % radix);
+	if (IS_ENABLED(CONFIG_CBPRINTF_FAST_CONVERSION)
+	    && (radix == 10) && ((size_t)(bpe - bps) >= CONVERTED_INT_BUFLEN)) {
+		bp = encode_uint_dec(value, bp);
+	} else if (IS_ENABLED(CONFIG_CBPRINTF_FAST_CONVERSION)
+		   && (radix != 10)) {
+		/* Octal and hexadecimal digits are plain bit fields. */
+		const unsigned int shift = (radix == 16) ? 4 : 3;
+		const char *digits = upcase ? "0123456789ABCDEF"
+					    : "0123456789abcdef";
+
+		do {
+			*--bp = digits[value & (radix - 1)];
+			value >>= shift;
+		} while ((value != 0) && (bps < bp));
+	} else {
+		do {
+			unsigned int lsv = (unsigned int)(value % radix);
 
-		*--bp = (lsv <= 9) ? ('0' + lsv)
-			: upcase ? ('A' + lsv - 10) : ('a' + lsv - 10);
-		value /= radix;
-	} while ((value != 0) && (bps < bp));
+			*--bp = (lsv <= 9) ? ('0' + lsv)
+				: upcase ? ('A' + lsv - 10) : ('a' + lsv - 10);
+			value /= radix;
+		} while ((value != 0) && (bps < bp));
+	}
 
 	/* Record required alternate forms.  This can be determined
 	 * from the radix without re-checking specifier.
@@ -843,6 +953,152 @@ static char *encode_uint(uint_value_type value,
  */
 #define BIT_63 BIT64(63)
 
+/* A power of ten approximated as m * 2^e, with the most significant bit
+ * of m set.
+ */
+struct pow10_cache {
+	uint64_t m;
+	int16_t e;
+};
+
+/* Powers of ten 10^(16 * i) for i in [-20, 20], covering the decimal
+ * exponents of all doubles in steps of 16.  Mantissas are rounded to
+ * nearest.
+ */
+static const struct pow10_cache pow10_coarse[] = {
+	{ 0xfd00b897478238d1ULL, -1127 },	/* 1e-320 */
+	{ 0x8c71dcd9ba0b4926ULL, -1073 },	/* 1e-304 */
+	{ 0x9becce62836ac577ULL, -1020 },	/* 1e-288 */
+	{ 0xad1c8eab5ee43b67ULL, -967 },	/* 1e-272 */
+	{ 0xc0314325637a193aULL, -914 },	/* 1e-256 */
+	{ 0xd5605fcdcf32e1d7ULL, -861 },	/* 1e-240 */
+	{ 0xece53cec4a314ebeULL, -808 },	/* 1e-224 */
+	{ 0x8380dea93da4bc60ULL, -754 },	/* 1e-208 */
+	{ 0x91ff83775423cc06ULL, -701 },	/* 1e-192 */
+	{ 0xa21727db38cb0030ULL, -648 },	/* 1e-176 */
+	{ 0xb3f4e093db73a093ULL, -595 },	/* 1e-160 */
+	{ 0xc7caba6e7c5382c9ULL, -542 },	/* 1e-144 */
+	{ 0xddd0467c64bce4a1ULL, -489 },	/* 1e-128 */
+	{ 0xf64335bcf065d37dULL, -436 },	/* 1e-112 */
+	{ 0x88b402f7fd75539bULL, -382 },	/* 1e-96 */
+	{ 0x97c560ba6b0919a6ULL, -329 },	/* 1e-80 */
+	{ 0xa87fea27a539e9a5ULL, -276 },	/* 1e-64 */
+	{ 0xbb127c53b17ec159ULL, -223 },	/* 1e-48 */
+	{ 0xcfb11ead453994baULL, -170 },	/* 1e-32 */
+	{ 0xe69594bec44de15bULL, -117 },	/* 1e-16 */
+	{ 0x8000000000000000ULL, -63 },	/* 1e0 */
+	{ 0x8e1bc9bf04000000ULL, -10 },	/* 1e16 */
+	{ 0x9dc5ada82b70b59eULL, 43 },	/* 1e32 */
+	{ 0xaf298d050e4395d7ULL, 96 },	/* 1e48 */
+	{ 0xc2781f49ffcfa6d5ULL, 149 },	/* 1e64 */
+	{ 0xd7e77a8f87daf7fcULL, 202 },	/* 1e80 */
+	{ 0xefb3ab16c59b14a3ULL, 255 },	/* 1e96 */
+	{ 0x850fadc09923329eULL, 309 },	/* 1e112 */
+	{ 0x93ba47c980e98ce0ULL, 362 },	/* 1e128 */
+	{ 0xa402b9c5a8d3a6e7ULL, 415 },	/* 1e144 */
+	{ 0xb616a12b7fe617aaULL, 468 },	/* 1e160 */
+	{ 0xca28a291859bbf93ULL, 521 },	/* 1e176 */
+	{ 0xe070f78d3927556bULL, 574 },	/* 1e192 */
+	{ 0xf92e0c3537826146ULL, 627 },	/* 1e208 */
+	{ 0x8a5296ffe33cc930ULL, 681 },	/* 1e224 */
+	{ 0x9991a6f3d6bf1766ULL, 734 },	/* 1e240 */
+	{ 0xaa7eebfb9df9de8eULL, 787 },	/* 1e256 */
+	{ 0xbd49d14aa79dbc82ULL, 840 },	/* 1e272 */
+	{ 0xd226fc195c6a2f8cULL, 893 },	/* 1e288 */
+	{ 0xe950df20247c83fdULL, 946 },	/* 1e304 */
+	{ 0x81842f29f2cce376ULL, 1000 },	/* 1e320 */
+};
+
+/* Powers of ten 10^j for j in [0, 15], all exact. */
+static const struct pow10_cache pow10_fine[] = {
+	{ 0x8000000000000000ULL, -63 },	/* 1e0 */
+	{ 0xa000000000000000ULL, -60 },	/* 1e1 */
+	{ 0xc800000000000000ULL, -57 },	/* 1e2 */
+	{ 0xfa00000000000000ULL, -54 },	/* 1e3 */
+	{ 0x9c40000000000000ULL, -50 },	/* 1e4 */
+	{ 0xc350000000000000ULL, -47 },	/* 1e5 */
+	{ 0xf424000000000000ULL, -44 },	/* 1e6 */
+	{ 0x9896800000000000ULL, -40 },	/* 1e7 */
+	{ 0xbebc200000000000ULL, -37 },	/* 1e8 */
+	{ 0xee6b280000000000ULL, -34 },	/* 1e9 */
+	{ 0x9502f90000000000ULL, -30 },	/* 1e10 */
+	{ 0xba43b74000000000ULL, -27 },	/* 1e11 */
+	{ 0xe8d4a51000000000ULL, -24 },	/* 1e12 */
+	{ 0x9184e72a00000000ULL, -20 },	/* 1e13 */
+	{ 0xb5e620f480000000ULL, -17 },	/* 1e14 */
+	{ 0xe35fa931a0000000ULL, -14 },	/* 1e15 */
+};
+
+/* Rounding offsets 0.5 * 10^-n for n in [0, 16], as fractions scaled by
+ * 2^60.  These are the values repeated division by 10 yields.
+ */
+static const uint64_t round_offset[] = {
+	0x0800000000000000ULL,
+	0x00ccccccccccccccULL,
+	0x00147ae147ae147aULL,
+	0x00020c49ba5e353fULL,
+	0x0000346dc5d63886ULL,
+	0x0000053e2d6238daULL,
+	0x0000008637bd05afULL,
+	0x0000000d6bf94d5eULL,
+	0x000000015798ee23ULL,
+	0x00000000225c17d0ULL,
+	0x00000000036f9bfbULL,
+	0x000000000057f5ffULL,
+	0x000000000008cbccULL,
+	0x000000000000e12eULL,
+	0x0000000000001684ULL,
+	0x0000000000000240ULL,
+	0x0000000000000039ULL
+};
+
+/* Multiply the normalized fraction of value = fract * 2^(expo - 64) by a
+ * cached power of ten, keeping it normalized.
+ */
+static void _mul_pow10(uint64_t *fract, int *expo,
+		       const struct pow10_cache *p)
+{
+	*fract = _umul64_hi(*fract, p->m);
+	*expo += p->e + 64;
+
+	if ((*fract & BIT_63) == 0) {
+		*fract <<= 1;
+		--*expo;
+	}
+}
+
+/* Scale the normalized fraction of a non-zero value to within about one
+ * decade of 1 with at most two multiplications, rather than one
+ * multiplication or division by 10 per decade.
+ *
+ * Returns the decimal exponent of the scaled value.
+ */
+static int _scale_pow10(uint64_t *fract, int *expo)
+{
+	/* Decimal exponent of the value, off by at most one:
+	 * 1233 / 4096 approximates log10(2).
+	 */
+	int decexp = (*expo * 1233) / 4096;
+	int n = 320 - decexp;
+
+	if ((n / 16) != 20) {
+		_mul_pow10(fract, expo, &pow10_coarse[n / 16]);
+	}
+	if ((n % 16) != 0) {
+		_mul_pow10(fract, expo, &pow10_fine[n % 16]);
+	}
+
+	/* The division by 5 below rounds up, which would overflow a
+	 * product just below 1.0.  It renormalizes the fraction anyway.
+	 */
+	if (*expo > 0) {
+		*fract >>= 1;
+		++*expo;
+	}
+
+	return decexp;
+}
+
 /* Convert the IEEE 754-2008 double to text format.
  *
  * @param value the 64-bit floating point value.
@@ -1082,6 +1338,10 @@ static char *encode_float(double value,
 	 */
 	int decexp = 0;
 
+	if (IS_ENABLED(CONFIG_CBPRINTF_FAST_CONVERSION) && (fract != 0)) {
+		decexp = _scale_pow10(&fract, &expo);
+	}
+
 	while (expo < -2) {
 		/*
 		 * Make roon to allow a multiplication by 5 without overflow.
@@ -1160,8 +1420,13 @@ static char *encode_float(double value,
 
 	/* Round the value to the last digit being printed. */
 	uint64_t round = BIT64(59); /* 0.5 */
-	while (decimals--) {
-		_ldiv10(&round);
+
+	if (IS_ENABLED(CONFIG_CBPRINTF_FAST_CONVERSION)) {
+		round = round_offset[decimals];
+	} else {
+		while (decimals--) {
+			_ldiv10(&round);
+		}
 	}
 	fract += round;
 	/* Make sure rounding didn't make fract >= 1.0 */
@@ -681,3 +681,109 @@ int cbprintf_fsc_package(void *in_packaged,
 
 	return out_len;
 }
+
+int cbprintf_package_copy(void *in_packaged,
+			  size_t in_len,
+			  void *packaged,
+			  size_t len,
+			  uint32_t flags)
+{
+	uint8_t *buf = in_packaged, *out = packaged;
+	unsigned int args_size, s_nbr, ros_nbr, rws_nbr, strs_len;
+	unsigned int out_s_nbr, out_ros_nbr;
+	bool str_idxs = flags & CBPRINTF_PACKAGE_ADD_STRING_IDXS;
+	const uint8_t *rw_pos;
+	size_t out_len;
+	size_t slen;
+	char *s;
+
+	if (!buf) {
+		return -EINVAL;
+	}
+
+	/* Retrieve the size of the arg list and number of strings. */
+	args_size = buf[0] * sizeof(int);
+	s_nbr     = buf[1];
+	ros_nbr   = buf[2];
+	rws_nbr   = buf[3];
+
+	if (rws_nbr == 0) {
+		if (packaged) {
+			if (len < in_len) {
+				return -ENOSPC;
+			}
+			memcpy(out, buf, in_len);
+		}
+
+		return in_len;
+	}
+
+	rw_pos = &buf[args_size + ros_nbr];
+	strs_len = in_len - (args_size + ros_nbr + rws_nbr);
+
+	/* Read only string locations are kept only if requested. */
+	out_ros_nbr = str_idxs ? ros_nbr : 0;
+	out_s_nbr = s_nbr;
+	out_len = args_size + out_ros_nbr + strs_len;
+
+	for (unsigned int i = 0; i < rws_nbr; i++) {
+		s = *(char **)(buf + rw_pos[i] * sizeof(int));
+		if (ptr_in_rodata(s)) {
+			out_ros_nbr += str_idxs ? 1 : 0;
+			out_len += str_idxs ? 1 : 0;
+		} else {
+			/* Location prefix, string and terminating '\0'. */
+			out_s_nbr++;
+			out_len += 1 + strlen(s) + 1;
+		}
+	}
+
+	if (!packaged) {
+		return out_len;
+	}
+
+	if (out_len > len) {
+		return -ENOSPC;
+	}
+
+	memcpy(out, buf, args_size);
+	out[1] = out_s_nbr;
+	out[2] = out_ros_nbr;
+	out[3] = 0;
+	out += args_size;
+
+	/* Locations of read only strings. */
+	if (str_idxs) {
+		memcpy(out, &buf[args_size], ros_nbr);
+		out += ros_nbr;
+
+		for (unsigned int i = 0; i < rws_nbr; i++) {
+			s = *(char **)(buf + rw_pos[i] * sizeof(int));
+			if (ptr_in_rodata(s)) {
+				*out++ = rw_pos[i];
+			}
+		}
+	}
+
+	/* Strings that were already part of the package. */
+	memcpy(out, &rw_pos[rws_nbr], strs_len);
+	out += strs_len;
+
+	/* Append transient strings prefixed by their pointer location. */
+	for (unsigned int i = 0; i < rws_nbr; i++) {
+		s = *(char **)(buf + rw_pos[i] * sizeof(int));
+		if (ptr_in_rodata(s)) {
+			continue;
+		}
+
+		/* clear the pointer like cbvprintf_package() does */
+		*(char **)((uint8_t *)packaged + rw_pos[i] * sizeof(int)) = NULL;
+
+		slen = strlen(s) + 1;
+		*out++ = rw_pos[i];
+		memcpy(out, s, slen);
+		out += slen;
+	}
+
+	return out_len;
+}
@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/__assert.h>
+#include <sys/hashmap.h>
+#include <sys/util.h>
+
+/* Number of slots of the first table of a heap backed map */
+#define INITIAL_CAPACITY 8
+
+/* Number of old table slots moved per insertion or removal while
+ * growing.  With tables doubling at 3/4 load, moving 4 slots per
+ * operation empties the old table well before the new one fills up.
+ */
+#define MIGRATE_STEP 4
+
+/* Marks old table slots whose node has been removed or moved.  Nodes
+ * are never inserted into the old table, so rather than shifting
+ * entries back, probe sequences simply run through these.
+ */
+static struct sys_hashmap_node tombstone;
+#define TOMBSTONE (&tombstone)
+
+/* Number of nodes in the current table */
+static inline uint32_t cur_size(struct sys_hashmap *map)
+{
+	return map->size - map->old_size;
+}
+
+/*
+ * Find the slot holding a node.
+ *
+ * If @p node is NULL, the node is looked up by key, otherwise by
+ * address.
+ *
+ * @return Slot index, or -1 if not found
+ */
+static int find_slot(struct sys_hashmap *map, struct sys_hashmap_node **slots,
+		     uint32_t capacity, uint32_t hash, const void *key,
+		     const struct sys_hashmap_node *node)
+{
+	uint32_t mask = capacity - 1;
+	uint32_t idx = hash & mask;
+	struct sys_hashmap_node *n;
+	uint32_t i;
+
+	if (slots == NULL) {
+		return -1;
+	}
+
+	for (i = 0; i < capacity; i++) {
+		n = slots[idx];
+		if (n == NULL) {
+			break;
+		}
+
+		if (n != TOMBSTONE) {
+			if (node != NULL) {
+				if (n == node) {
+					return idx;
+				}
+			} else if ((n->hash == hash) && map->key_eq_fn(n, key)) {
+				return idx;
+			}
+		}
+
+		idx = (idx + 1) & mask;
+	}
+
+	return -1;
+}
+
+/* Put a node into the first free slot of its probe sequence */
+static void place(struct sys_hashmap_node **slots, uint32_t capacity,
+		  struct sys_hashmap_node *node)
+{
+	uint32_t mask = capacity - 1;
+	uint32_t idx = node->hash & mask;
+
+	while (slots[idx] != NULL) {
+		idx = (idx + 1) & mask;
+	}
+
+	slots[idx] = node;
+}
+
+/*
+ * Empty a slot of the current table.
+ *
+ * Following nodes of the same cluster are shifted back so that no
+ * probe sequence crosses the emptied slot, unless that would move a
+ * node before its home slot.
+ */
+static void empty_slot(struct sys_hashmap_node **slots, uint32_t capacity,
+		       uint32_t idx)
+{
+	uint32_t mask = capacity - 1;
+	uint32_t next = idx;
+	uint32_t home;
+	struct sys_hashmap_node *n;
+
+	for (;;) {
+		next = (next + 1) & mask;
+		n = slots[next];
+		if (n == NULL) {
+			break;
+		}
+
+		home = n->hash & mask;
+
+		/* The node can fill the hole unless its home lies
+		 * cyclically in (idx, next].
+		 */
+		if (((next - home) & mask) >= ((next - idx) & mask)) {
+			slots[idx] = n;
+			idx = next;
+		}
+	}
+
+	slots[idx] = NULL;
+}
+
+/* Move up to @p steps slots of the old table into the current one */
+static void migrate(struct sys_hashmap *map, uint32_t steps)
+{
+	struct sys_hashmap_node *n;
+
+	while ((map->old_slots != NULL) && (steps > 0U)) {
+		n = map->old_slots[map->migrate_idx];
+		if ((n != NULL) && (n != TOMBSTONE)) {
+			place(map->slots, map->capacity, n);
+			map->old_slots[map->migrate_idx] = TOMBSTONE;
+			map->old_size--;
+		}
+
+		map->migrate_idx++;
+		steps--;
+
+		if ((map->old_size == 0U)
+		    || (map->migrate_idx == map->old_capacity)) {
+			__ASSERT_NO_MSG(map->old_size == 0U);
+			sys_heap_free(map->heap, map->old_slots);
+			map->old_slots = NULL;
+			map->old_capacity = 0U;
+			map->migrate_idx = 0U;
+		}
+	}
+}
+
+/* Allocate a bigger table and start migrating to it */
+static void grow(struct sys_hashmap *map)
+{
+	struct sys_hashmap_node **slots;
+	uint32_t capacity;
+
+	/* Only one migration at a time */
+	migrate(map, map->old_capacity);
+
+	capacity = (map->capacity == 0U) ? INITIAL_CAPACITY
+					 : (map->capacity * 2U);
+	slots = sys_heap_alloc(map->heap, capacity * sizeof(*slots));
+	if (slots == NULL) {
+		/* Keep filling the current table */
+		return;
+	}
+
+	(void)memset(slots, 0, capacity * sizeof(*slots));
+
+	if (map->slots != NULL) {
+		map->old_slots = map->slots;
+		map->old_capacity = map->capacity;
+		map->old_size = map->size;
+		map->migrate_idx = 0U;
+	}
+
+	map->slots = slots;
+	map->capacity = capacity;
+}
+
+static struct sys_hashmap_node *remove_slot(struct sys_hashmap *map,
+					    uint32_t hash, const void *key,
+					    struct sys_hashmap_node *node)
+{
+	struct sys_hashmap_node *n = NULL;
+	int idx;
+
+	idx = find_slot(map, map->slots, map->capacity, hash, key, node);
+	if (idx >= 0) {
+		n = map->slots[idx];
+		empty_slot(map->slots, map->capacity, idx);
+	} else {
+		idx = find_slot(map, map->old_slots, map->old_capacity,
+				hash, key, node);
+		if (idx >= 0) {
+			n = map->old_slots[idx];
+			map->old_slots[idx] = TOMBSTONE;
+			map->old_size--;
+		}
+	}
+
+	if (n != NULL) {
+		map->size--;
+		migrate(map, MIGRATE_STEP);
+	}
+
+	return n;
+}
+
+void sys_hashmap_init(struct sys_hashmap *map, sys_hashmap_hash_t hash_fn,
+		      sys_hashmap_key_eq_t key_eq_fn, struct sys_heap *heap)
+{
+	(void)memset(map, 0, sizeof(*map));
+	map->hash_fn = hash_fn;
+	map->key_eq_fn = key_eq_fn;
+	map->heap = heap;
+}
+
+void sys_hashmap_init_static(struct sys_hashmap *map,
+			     sys_hashmap_hash_t hash_fn,
+			     sys_hashmap_key_eq_t key_eq_fn,
+			     struct sys_hashmap_node **slots,
+			     uint32_t n_slots)
+{
+	__ASSERT((n_slots != 0U) && ((n_slots & (n_slots - 1U)) == 0U),
+		 "hash map slots must be a power of two");
+
+	(void)memset(map, 0, sizeof(*map));
+	(void)memset(slots, 0, n_slots * sizeof(*slots));
+	map->slots = slots;
+	map->capacity = n_slots;
+	map->hash_fn = hash_fn;
+	map->key_eq_fn = key_eq_fn;
+}
+
+int sys_hashmap_insert(struct sys_hashmap *map, struct sys_hashmap_node *node,
+		       const void *key)
+{
+	uint32_t hash = map->hash_fn(key);
+
+	if (sys_hashmap_get(map, key) != NULL) {
+		return -EEXIST;
+	}
+
+	if ((map->heap != NULL)
+	    && (cur_size(map) >= (map->capacity - map->capacity / 4U))) {
+		grow(map);
+	}
+
+	/* Always leave an empty slot to terminate probe sequences */
+	if ((cur_size(map) + 1U) >= map->capacity) {
+		return -ENOMEM;
+	}
+
+	node->hash = hash;
+	place(map->slots, map->capacity, node);
+	map->size++;
+
+	migrate(map, MIGRATE_STEP);
+
+	return 0;
+}
+
+struct sys_hashmap_node *sys_hashmap_get(struct sys_hashmap *map,
+					 const void *key)
+{
+	uint32_t hash;
+	int idx;
+
+	if (map->size == 0U) {
+		return NULL;
+	}
+
+	hash = map->hash_fn(key);
+
+	idx = find_slot(map, map->slots, map->capacity, hash, key, NULL);
+	if (idx >= 0) {
+		return map->slots[idx];
+	}
+
+	idx = find_slot(map, map->old_slots, map->old_capacity, hash, key,
+			NULL);
+	if (idx >= 0) {
+		return map->old_slots[idx];
+	}
+
+	return NULL;
+}
+
+struct sys_hashmap_node *sys_hashmap_remove(struct sys_hashmap *map,
+					    const void *key)
+{
+	if (map->size == 0U) {
+		return NULL;
+	}
+
+	return remove_slot(map, map->hash_fn(key), key, NULL);
+}
+
+bool sys_hashmap_remove_node(struct sys_hashmap *map,
+			     struct sys_hashmap_node *node)
+{
+	if (map->size == 0U) {
+		return false;
+	}
+
+	return remove_slot(map, node->hash, NULL, node) != NULL;
+}
+
+void sys_hashmap_clear(struct sys_hashmap *map)
+{
+	if (map->heap != NULL) {
+		if (map->old_slots != NULL) {
+			sys_heap_free(map->heap, map->old_slots);
+		}
+
+		if (map->slots != NULL) {
+			sys_heap_free(map->heap, map->slots);
+		}
+
+		map->slots = NULL;
+		map->capacity = 0U;
+	} else if (map->slots != NULL) {
+		(void)memset(map->slots, 0,
+			     map->capacity * sizeof(*map->slots));
+	}
+
+	map->old_slots = NULL;
+	map->old_capacity = 0U;
+	map->old_size = 0U;
+	map->migrate_idx = 0U;
+	map->size = 0U;
+}
+
+void sys_hashmap_walk(struct sys_hashmap *map, sys_hashmap_visit_t visit_fn,
+		      void *cookie)
+{
+	struct sys_hashmap_node *n;
+	uint32_t i;
+
+	for (i = 0; i < map->capacity; i++) {
+		n = map->slots[i];
+		if (n != NULL) {
+			visit_fn(n, cookie);
+		}
+	}
+
+	for (i = map->migrate_idx; i < map->old_capacity; i++) {
+		n = map->old_slots[i];
+		if ((n != NULL) && (n != TOMBSTONE)) {
+			visit_fn(n, cookie);
+		}
+	}
+}
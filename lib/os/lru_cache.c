@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <sys/__assert.h>
+#include <sys/lru_cache.h>
+
+static inline struct sys_lru_cache_node *to_entry(struct sys_hashmap_node *hnode)
+{
+	return (hnode != NULL) ?
+		CONTAINER_OF(hnode, struct sys_lru_cache_node, hnode) : NULL;
+}
+
+void sys_lru_cache_init(struct sys_lru_cache *cache,
+			sys_hashmap_hash_t hash_fn,
+			sys_hashmap_key_eq_t key_eq_fn,
+			struct sys_heap *heap, uint32_t max_entries)
+{
+	sys_hashmap_init(&cache->map, hash_fn, key_eq_fn, heap);
+	sys_dlist_init(&cache->lru);
+	cache->max_entries = max_entries;
+}
+
+struct sys_lru_cache_node *sys_lru_cache_get(struct sys_lru_cache *cache,
+					     const void *key)
+{
+	struct sys_lru_cache_node *node;
+
+	node = to_entry(sys_hashmap_get(&cache->map, key));
+	if (node != NULL) {
+		sys_dlist_remove(&node->lnode);
+		sys_dlist_prepend(&cache->lru, &node->lnode);
+	}
+
+	return node;
+}
+
+struct sys_lru_cache_node *sys_lru_cache_peek(struct sys_lru_cache *cache,
+					      const void *key)
+{
+	return to_entry(sys_hashmap_get(&cache->map, key));
+}
+
+int sys_lru_cache_put(struct sys_lru_cache *cache,
+		      struct sys_lru_cache_node *node, const void *key,
+		      struct sys_lru_cache_node **evicted)
+{
+	struct sys_lru_cache_node *oldest = NULL;
+	int ret;
+
+	if (evicted != NULL) {
+		*evicted = NULL;
+	}
+
+	/* Insert before evicting, so that a failed put loses nothing */
+	ret = sys_hashmap_insert(&cache->map, &node->hnode, key);
+	if ((ret == -ENOMEM) &&
+	    (sys_lru_cache_size(cache) >= cache->max_entries)) {
+		/* The table is full at the cache size, the slot of the
+		 * oldest entry is the one that was missing.
+		 */
+		oldest = sys_lru_cache_oldest(cache);
+		if (oldest != NULL) {
+			(void)sys_hashmap_remove_node(&cache->map,
+						      &oldest->hnode);
+			sys_dlist_remove(&oldest->lnode);
+
+			ret = sys_hashmap_insert(&cache->map, &node->hnode,
+						 key);
+			__ASSERT(ret == 0, "no room after eviction");
+		}
+	} else if ((ret == 0) &&
+		   (sys_lru_cache_size(cache) > cache->max_entries)) {
+		oldest = sys_lru_cache_oldest(cache);
+		(void)sys_hashmap_remove_node(&cache->map, &oldest->hnode);
+		sys_dlist_remove(&oldest->lnode);
+	}
+
+	if (ret != 0) {
+		return ret;
+	}
+
+	sys_dnode_init(&node->lnode);
+	sys_dlist_prepend(&cache->lru, &node->lnode);
+
+	if (evicted != NULL) {
+		*evicted = oldest;
+	}
+
+	return 0;
+}
+
+struct sys_lru_cache_node *sys_lru_cache_remove(struct sys_lru_cache *cache,
+						const void *key)
+{
+	struct sys_lru_cache_node *node;
+
+	node = to_entry(sys_hashmap_remove(&cache->map, key));
+	if (node != NULL) {
+		sys_dlist_remove(&node->lnode);
+	}
+
+	return node;
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/__assert.h>
+#include <sys/mpmc_queue.h>
+
+/*
+ * Each cell starts with its sequence number.  A cell at position pos
+ * is ready to be written when its sequence is pos, and ready to be
+ * read when it is pos + 1.  Reading it sets the sequence for the
+ * next lap, pos + number of cells.
+ *
+ * The sequence is stored relative to the cell index, so that a
+ * zeroed buffer is a valid empty queue and MPMC_QUEUE_DEFINE() needs
+ * no runtime initialization.
+ */
+static inline atomic_t *cell_seq(struct mpmc_queue *queue, uint32_t idx)
+{
+	return (atomic_t *)&queue->cells[idx * queue->cell_size];
+}
+
+static inline void *cell_data(struct mpmc_queue *queue, uint32_t idx)
+{
+	return &queue->cells[idx * queue->cell_size + sizeof(atomic_t)];
+}
+
+void mpmc_queue_init(struct mpmc_queue *queue, void *buffer,
+		     uint32_t elem_size, uint32_t n_elems)
+{
+	__ASSERT((n_elems != 0U) && ((n_elems & (n_elems - 1U)) == 0U),
+		 "MPMC queue size must be a power of two");
+
+	(void)memset(queue, 0, sizeof(*queue));
+	queue->cells = buffer;
+	queue->mask = n_elems - 1U;
+	queue->elem_size = elem_size;
+	queue->cell_size = Z_MPMC_QUEUE_CELL_SIZE(elem_size);
+
+	(void)memset(buffer, 0, n_elems * queue->cell_size);
+}
+
+int mpmc_queue_put(struct mpmc_queue *queue, const void *data)
+{
+	uint32_t pos = (uint32_t)atomic_get(&queue->enqueue_pos);
+	uint32_t idx, seq;
+	int32_t diff;
+
+	for (;;) {
+		idx = pos & queue->mask;
+		seq = (uint32_t)atomic_get(cell_seq(queue, idx)) + idx;
+		diff = (int32_t)(seq - pos);
+
+		if (diff == 0) {
+			/* Cell is free for this lap, try to claim it */
+			if (atomic_cas(&queue->enqueue_pos, (atomic_val_t)pos,
+				       (atomic_val_t)(pos + 1U))) {
+				break;
+			}
+		} else if (diff < 0) {
+			/* Cell still holds an element from the
+			 * previous lap
+			 */
+			return -ENOMEM;
+		}
+
+		/* Another producer got there first */
+		pos = (uint32_t)atomic_get(&queue->enqueue_pos);
+	}
+
+	memcpy(cell_data(queue, idx), data, queue->elem_size);
+	(void)atomic_set(cell_seq(queue, idx), (atomic_val_t)(pos + 1U - idx));
+
+#ifdef CONFIG_POLL
+	/* Consumers have caught up with this element and may be waiting */
+	if ((queue->signal != NULL)
+	    && ((uint32_t)atomic_get(&queue->dequeue_pos) == pos)) {
+		k_poll_signal_raise(queue->signal, 0);
+	}
+#endif
+
+	return 0;
+}
+
+int mpmc_queue_get(struct mpmc_queue *queue, void *data)
+{
+	uint32_t pos = (uint32_t)atomic_get(&queue->dequeue_pos);
+	uint32_t idx, seq;
+	int32_t diff;
+
+	for (;;) {
+		idx = pos & queue->mask;
+		seq = (uint32_t)atomic_get(cell_seq(queue, idx)) + idx;
+		diff = (int32_t)(seq - (pos + 1U));
+
+		if (diff == 0) {
+			/* Cell holds an element, try to claim it */
+			if (atomic_cas(&queue->dequeue_pos, (atomic_val_t)pos,
+				       (atomic_val_t)(pos + 1U))) {
+				break;
+			}
+		} else if (diff < 0) {
+			/* Cell not written yet */
+			return -EAGAIN;
+		}
+
+		/* Another consumer got there first */
+		pos = (uint32_t)atomic_get(&queue->dequeue_pos);
+	}
+
+	memcpy(data, cell_data(queue, idx), queue->elem_size);
+	(void)atomic_set(cell_seq(queue, idx),
+			 (atomic_val_t)(pos + queue->mask + 1U - idx));
+
+	return 0;
+}
@@ -304,6 +304,21 @@ void mpsc_pbuf_commit(struct mpsc_pbuf_buffer *buffer,
 	MPSC_PBUF_DBG(buffer, "committed %p ", item);
 }
 
+void mpsc_pbuf_discard(struct mpsc_pbuf_buffer *buffer,
+		       union mpsc_pbuf_generic *item)
+{
+	uint32_t wlen = buffer->get_wlen(item);
+
+	k_spinlock_key_t key = k_spin_lock(&buffer->lock);
+
+	item->skip.valid = 0;
+	item->skip.busy = 1;
+	item->skip.len = wlen;
+	buffer->wr_idx = idx_inc(buffer, buffer->wr_idx, wlen);
+	k_spin_unlock(&buffer->lock, key);
+	MPSC_PBUF_DBG(buffer, "discarded %p ", item);
+}
+
 void mpsc_pbuf_put_word_ext(struct mpsc_pbuf_buffer *buffer,
 			    const union mpsc_pbuf_generic item,
 			    const void *data)
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <sys/__assert.h>
+#include <sys/spsc_ring.h>
+
+void spsc_ring_init(struct spsc_ring *ring, void *buffer, uint32_t elem_size,
+		    uint32_t n_elems)
+{
+	__ASSERT((n_elems != 0U) && ((n_elems & (n_elems - 1U)) == 0U),
+		 "SPSC ring size must be a power of two");
+
+	(void)memset(ring, 0, sizeof(*ring));
+	ring->buffer = buffer;
+	ring->mask = n_elems - 1U;
+	ring->elem_size = elem_size;
+}
+
+/* Copy elements between the ring and a linear buffer, wrapping around
+ * the end of the ring if needed.
+ */
+static void copy_elems(struct spsc_ring *ring, uint32_t idx, uint8_t *data,
+		       uint32_t n, bool to_ring)
+{
+	uint32_t first = MIN(n, ring->mask + 1U - idx);
+	uint8_t *slot = &ring->buffer[idx * ring->elem_size];
+
+	if (to_ring) {
+		memcpy(slot, data, first * ring->elem_size);
+		memcpy(ring->buffer, data + first * ring->elem_size,
+		       (n - first) * ring->elem_size);
+	} else {
+		memcpy(data, slot, first * ring->elem_size);
+		memcpy(data + first * ring->elem_size, ring->buffer,
+		       (n - first) * ring->elem_size);
+	}
+}
+
+uint32_t spsc_ring_put(struct spsc_ring *ring, const void *data, uint32_t n)
+{
+	uint32_t head = (uint32_t)atomic_get(&ring->head);
+	uint32_t space = ring->mask + 1U - (head - ring->cached_tail);
+
+	if (space < n) {
+		/* Only look at the consumer's cache line when the
+		 * ring appears too full.
+		 */
+		ring->cached_tail = (uint32_t)atomic_get(&ring->tail);
+		space = ring->mask + 1U - (head - ring->cached_tail);
+		n = MIN(n, space);
+	}
+
+	if (n == 0U) {
+		return 0;
+	}
+
+	copy_elems(ring, head & ring->mask, (uint8_t *)data, n, true);
+
+	/* Publish the elements */
+	(void)atomic_set(&ring->head, (atomic_val_t)(head + n));
+
+#ifdef CONFIG_POLL
+	/* If the consumer had caught up with the old head, it may be
+	 * waiting. Checking after publishing the head ensures that a
+	 * consumer seeing an empty ring gets signaled.
+	 */
+	if ((ring->signal != NULL)
+	    && ((uint32_t)atomic_get(&ring->tail) == head)) {
+		k_poll_signal_raise(ring->signal, 0);
+	}
+#endif
+
+	return n;
+}
+
+uint32_t spsc_ring_get(struct spsc_ring *ring, void *data, uint32_t n)
+{
+	uint32_t tail = (uint32_t)atomic_get(&ring->tail);
+	uint32_t avail = ring->cached_head - tail;
+
+	if (avail < n) {
+		ring->cached_head = (uint32_t)atomic_get(&ring->head);
+		avail = ring->cached_head - tail;
+		n = MIN(n, avail);
+	}
+
+	if (n == 0U) {
+		return 0;
+	}
+
+	copy_elems(ring, tail & ring->mask, data, n, false);
+
+	/* Release the slots to the producer */
+	(void)atomic_set(&ring->tail, (atomic_val_t)(tail + n));
+
+	return n;
+}
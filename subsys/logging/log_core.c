@@ -1231,6 +1231,11 @@ void z_log_msg2_commit(struct log_msg2 *msg)
 	}
 }
 
+void z_log_msg2_discard(struct log_msg2 *msg)
+{
+	mpsc_pbuf_discard(&log_buffer, (union mpsc_pbuf_generic *)msg);
+}
+
 union log_msg2_generic *z_log_msg2_claim(void)
 {
 	return (union log_msg2_generic *)mpsc_pbuf_claim(&log_buffer);
@@ -33,14 +33,52 @@ void z_impl_z_log_msg2_static_create(const void *source,
 			      const struct log_msg2_desc desc,
 			      uint8_t *package, const void *data)
 {
-	uint32_t msg_wlen = log_msg2_get_total_wlen(desc);
-	struct log_msg2 *msg = z_log_msg2_alloc(msg_wlen);
+	struct log_msg2_desc out_desc = desc;
+	union z_cbprintf_hdr *hdr = (union z_cbprintf_hdr *)package;
+	bool copy_strs = IS_ENABLED(CONFIG_LOG2_STATIC_PACKAGE_STRINGS) &&
+			 (desc.package_len > 0) && (hdr->desc.rw_str_cnt > 0);
+	uint32_t msg_wlen;
+	struct log_msg2 *msg;
+	int plen;
+
+	if (copy_strs) {
+		/* Transient strings must be appended to the message. */
+		plen = cbprintf_package_copy(package, desc.package_len,
+					     NULL, 0, 0);
+		if (plen < 0 || plen > Z_LOG_MSG2_MAX_PACKAGE_LEN) {
+			/* Package with strings does not fit in the message. */
+			z_log_dropped();
+
+			return;
+		}
+
+		out_desc.package_len = plen;
+	}
+
+	msg_wlen = log_msg2_get_total_wlen(out_desc);
+	msg = z_log_msg2_alloc(msg_wlen);
 
 	if (msg) {
-		memcpy(msg->data, package, desc.package_len);
+		if (copy_strs) {
+			plen = cbprintf_package_copy(package, desc.package_len,
+						     msg->data,
+						     out_desc.package_len, 0);
+			if (plen < 0) {
+				/* Strings grew since they were measured and
+				 * no longer fit in the message.
+				 */
+				msg->hdr.desc = out_desc;
+				z_log_msg2_discard(msg);
+				z_log_dropped();
+
+				return;
+			}
+		} else {
+			memcpy(msg->data, package, desc.package_len);
+		}
 	}
 
-	z_log_msg2_finalize(msg, source, desc, data);
+	z_log_msg2_finalize(msg, source, out_desc, data);
 }
 
 #ifdef CONFIG_USERSPACE
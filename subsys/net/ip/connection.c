@@ -54,11 +54,25 @@ LOG_MODULE_REGISTER(net_conn, CONFIG_NET_CONN_LOG_LEVEL);
 
 #define NET_CONN_RANK(_flags)		(_flags & 0x78)
 
+/** Handlers that must match all of these are hashed by them */
+#define NET_CONN_HASH_TUPLE (NET_CONN_REMOTE_ADDR_SPEC |	\
+			     NET_CONN_REMOTE_PORT_SPEC |	\
+			     NET_CONN_LOCAL_PORT_SPEC)
+
 static struct net_conn conns[CONFIG_NET_MAX_CONN];
 
 static sys_slist_t conn_unused;
 static sys_slist_t conn_used;
 
+/* Unicast UDP and TCP packets are not matched against all the handlers
+ * but only against the ones in two buckets of the hash table and the
+ * ones without a local port. A handler with a remote address and port
+ * is hashed by them and its local port, a handler with only a local port
+ * by the local port.
+ */
+static sys_slist_t conn_hash[CONFIG_NET_MAX_CONN];
+static sys_slist_t conn_wildcard;
+
 #if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG)
 static inline
 void conn_register_debug(struct net_conn *conn,
@@ -113,6 +127,68 @@ void conn_register_debug(struct net_conn *conn,
 #define conn_register_debug(...)
 #endif /* (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG) */
 
+static inline uint32_t conn_hash_mix(uint32_t hash, uint32_t val)
+{
+	/* FNV-1a, a 32-bit word at a time */
+	return (hash ^ val) * 16777619U;
+}
+
+uint32_t net_conn_hash(uint8_t proto, sa_family_t family,
+		       const void *remote_addr, uint16_t remote_port,
+		       uint16_t local_port)
+{
+	const uint32_t *addr = remote_addr;
+	uint32_t hash = 2166136261U;
+	int i, words = 0;
+
+	if (remote_addr) {
+		words = family == AF_INET6 ? sizeof(struct in6_addr) / 4 :
+			sizeof(struct in_addr) / 4;
+	}
+
+	hash = conn_hash_mix(hash, ((uint32_t)proto << 16) | family);
+
+	for (i = 0; i < words; i++) {
+		hash = conn_hash_mix(hash, UNALIGNED_GET(&addr[i]));
+	}
+
+	hash = conn_hash_mix(hash, ((uint32_t)remote_port << 16) | local_port);
+
+	/* FNV-1a only spreads a word into the higher bits, and the ports
+	 * mostly differ in their high byte when in network byte order, so
+	 * finish with the murmur3 avalanche to let them reach the low bits
+	 * used to pick a bucket or a SO_REUSEPORT socket.
+	 */
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bU;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35U;
+
+	return hash ^ (hash >> 16);
+}
+
+static sys_slist_t *conn_hash_list(struct net_conn *conn)
+{
+	struct sockaddr *remote = &conn->remote_addr;
+	uint16_t local_port = net_sin(&conn->local_addr)->sin_port;
+	uint32_t hash;
+
+	if ((conn->flags & NET_CONN_HASH_TUPLE) == NET_CONN_HASH_TUPLE) {
+		hash = net_conn_hash(conn->proto, remote->sa_family,
+				     remote->sa_family == AF_INET6 ?
+				     (void *)&net_sin6(remote)->sin6_addr :
+				     (void *)&net_sin(remote)->sin_addr,
+				     net_sin(remote)->sin_port, local_port);
+	} else if (conn->flags & NET_CONN_LOCAL_PORT_SPEC) {
+		hash = net_conn_hash(conn->proto, AF_UNSPEC, NULL, 0U,
+				     local_port);
+	} else {
+		return &conn_wildcard;
+	}
+
+	return &conn_hash[hash % ARRAY_SIZE(conn_hash)];
+}
+
 static struct net_conn *conn_get_unused(void)
 {
 	sys_snode_t *node;
@@ -132,6 +208,7 @@ static void conn_set_used(struct net_conn *conn)
 	conn->flags |= NET_CONN_IN_USE;
 
 	sys_slist_prepend(&conn_used, &conn->node);
+	sys_slist_prepend(conn_hash_list(conn), &conn->hash_node);
 }
 
 static void conn_set_unused(struct net_conn *conn)
@@ -141,6 +218,12 @@ static void conn_set_unused(struct net_conn *conn)
 	sys_slist_prepend(&conn_unused, &conn->node);
 }
 
+static inline bool conn_is_reuseport(struct net_conn *conn)
+{
+	return conn->context != NULL &&
+	       net_context_is_reuseport_set(conn->context);
+}
+
 /* Check if we already have identical connection handler installed. */
 static struct net_conn *conn_find_handler(uint16_t proto, uint8_t family,
 					  const struct sockaddr *remote_addr,
@@ -255,7 +338,8 @@ int net_conn_register(uint16_t proto, uint8_t family,
 
 	conn = conn_find_handler(proto, family, remote_addr, local_addr,
 				 remote_port, local_port);
-	if (conn) {
+	if (conn && !(conn_is_reuseport(conn) && context != NULL &&
+		      net_context_is_reuseport_set(context))) {
 		NET_ERR("Identical connection handler %p already found.", conn);
 		return -EALREADY;
 	}
@@ -380,6 +464,7 @@ int net_conn_unregister(struct net_conn_handle *handle)
 	NET_DBG("Connection handler %p removed", conn);
 
 	sys_slist_find_and_remove(&conn_used, &conn->node);
+	sys_slist_find_and_remove(conn_hash_list(conn), &conn->hash_node);
 
 	conn_set_unused(conn);
 
@@ -459,6 +544,175 @@ static bool conn_addr_cmp(struct net_pkt *pkt,
 	return true;
 }
 
+/* Check the ports and addresses of a UDP or TCP handler */
+static bool conn_end_points_match(struct net_conn *conn,
+				  struct net_pkt *pkt,
+				  union net_ip_header *ip_hdr,
+				  uint16_t src_port,
+				  uint16_t dst_port)
+{
+	if (net_sin(&conn->remote_addr)->sin_port) {
+		if (net_sin(&conn->remote_addr)->sin_port != src_port) {
+			return false;
+		}
+	}
+
+	if (net_sin(&conn->local_addr)->sin_port) {
+		if (net_sin(&conn->local_addr)->sin_port != dst_port) {
+			return false;
+		}
+	}
+
+	if (conn->flags & NET_CONN_REMOTE_ADDR_SET) {
+		if (!conn_addr_cmp(pkt, ip_hdr, &conn->remote_addr, true)) {
+			return false;
+		}
+	}
+
+	if (conn->flags & NET_CONN_LOCAL_ADDR_SET) {
+		if (!conn_addr_cmp(pkt, ip_hdr, &conn->local_addr, false)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool conn_iface_match(struct net_conn *conn, struct net_pkt *pkt)
+{
+	return conn->context == NULL ||
+	       !net_context_is_bound_to_iface(conn->context) ||
+	       net_pkt_iface(pkt) == net_context_get_iface(conn->context);
+}
+
+static bool conn_reuseport_peer(struct net_conn *conn,
+				struct net_conn *best_match,
+				struct net_pkt *pkt,
+				union net_ip_header *ip_hdr,
+				uint16_t src_port,
+				uint16_t dst_port)
+{
+	return conn->flags == best_match->flags &&
+	       conn->proto == best_match->proto &&
+	       conn->family == best_match->family &&
+	       conn_is_reuseport(conn) && conn_iface_match(conn, pkt) &&
+	       conn_end_points_match(conn, pkt, ip_hdr, src_port, dst_port);
+}
+
+/* The handlers of the contexts sharing a port with NET_OPT_REUSEPORT are
+ * registered identically, so they all are in the same bucket. Pick one
+ * of them by the hash of the remote end point: the packets of a flow keep
+ * going to the same handler as long as the group does not change.
+ */
+static struct net_conn *conn_select_reuseport(struct net_conn *best_match,
+					      sys_slist_t *list,
+					      struct net_pkt *pkt,
+					      union net_ip_header *ip_hdr,
+					      uint16_t src_port,
+					      uint16_t dst_port,
+					      uint32_t hash)
+{
+	struct net_conn *conn;
+	uint32_t count = 0U;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(list, conn, hash_node) {
+		if (conn_reuseport_peer(conn, best_match, pkt, ip_hdr,
+					src_port, dst_port)) {
+			count++;
+		}
+	}
+
+	if (count <= 1U) {
+		return best_match;
+	}
+
+	count = hash % count;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(list, conn, hash_node) {
+		if (conn_reuseport_peer(conn, best_match, pkt, ip_hdr,
+					src_port, dst_port)) {
+			if (count-- == 0U) {
+				return conn;
+			}
+		}
+	}
+
+	return best_match;
+}
+
+/* Find the handler of a unicast UDP or TCP packet from the hash table.
+ * A handler with a remote port is taken as soon as it matches, otherwise
+ * the most specific one is.
+ */
+static struct net_conn *conn_find_unicast(struct net_pkt *pkt,
+					  union net_ip_header *ip_hdr,
+					  uint8_t proto,
+					  uint16_t src_port,
+					  uint16_t dst_port)
+{
+	sa_family_t family = net_pkt_family(pkt);
+	struct net_conn *best_match = NULL;
+	int16_t best_rank = -1;
+	sys_slist_t *lists[3];
+	struct net_conn *conn;
+	const void *src;
+	uint32_t hash;
+	int i;
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && family == AF_INET6) {
+		src = &ip_hdr->ipv6->src;
+	} else {
+		src = &ip_hdr->ipv4->src;
+	}
+
+	hash = net_conn_hash(proto, family, src, src_port, dst_port);
+
+	lists[0] = &conn_hash[hash % ARRAY_SIZE(conn_hash)];
+	lists[1] = &conn_hash[net_conn_hash(proto, AF_UNSPEC, NULL, 0U,
+					    dst_port) % ARRAY_SIZE(conn_hash)];
+	lists[2] = &conn_wildcard;
+
+	for (i = 0; i < ARRAY_SIZE(lists); i++) {
+		SYS_SLIST_FOR_EACH_CONTAINER(lists[i], conn, hash_node) {
+			if (!conn_iface_match(conn, pkt)) {
+				continue;
+			}
+
+			if (conn->proto != proto) {
+				continue;
+			}
+
+			if (conn->family != AF_UNSPEC &&
+			    conn->family != family) {
+				continue;
+			}
+
+			if (!conn_end_points_match(conn, pkt, ip_hdr,
+						   src_port, dst_port)) {
+				continue;
+			}
+
+			if (conn->flags & NET_CONN_REMOTE_PORT_SPEC) {
+				return conn;
+			}
+
+			if (best_rank < NET_CONN_RANK(conn->flags)) {
+				best_rank = NET_CONN_RANK(conn->flags);
+				best_match = conn;
+			}
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_NET_CONTEXT_REUSEPORT) && best_match != NULL &&
+	    (best_match->flags & NET_CONN_LOCAL_PORT_SPEC) &&
+	    conn_is_reuseport(best_match)) {
+		return conn_select_reuseport(best_match, lists[1], pkt, ip_hdr,
+					     src_port, dst_port, hash);
+	}
+
+	return best_match;
+}
+
 static inline void conn_send_icmp_error(struct net_pkt *pkt)
 {
 	if (IS_ENABLED(CONFIG_NET_DISABLE_ICMP_DESTINATION_UNREACHABLE)) {
@@ -627,6 +881,19 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	}
 
+	/* Unicast and broadcast packets are delivered to at most one
+	 * handler which is looked up in the hash table, only multicast
+	 * packets walk the full list.
+	 */
+	if (((IS_ENABLED(CONFIG_NET_UDP) && proto == IPPROTO_UDP) ||
+	     (IS_ENABLED(CONFIG_NET_TCP) && proto == IPPROTO_TCP)) &&
+	    (net_pkt_family(pkt) == AF_INET ||
+	     net_pkt_family(pkt) == AF_INET6) && !is_mcast_pkt) {
+		best_match = conn_find_unicast(pkt, ip_hdr, proto, src_port,
+					       dst_port);
+		goto deliver;
+	}
+
 	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
 		if (conn->context != NULL &&
 		    net_context_is_bound_to_iface(conn->context) &&
@@ -697,34 +964,9 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 
 		if (IS_ENABLED(CONFIG_NET_UDP) ||
 		    IS_ENABLED(CONFIG_NET_TCP)) {
-			if (net_sin(&conn->remote_addr)->sin_port) {
-				if (net_sin(&conn->remote_addr)->sin_port !=
-				    src_port) {
-					continue;
-				}
-			}
-
-			if (net_sin(&conn->local_addr)->sin_port) {
-				if (net_sin(&conn->local_addr)->sin_port !=
-				    dst_port) {
-					continue;
-				}
-			}
-
-			if (conn->flags & NET_CONN_REMOTE_ADDR_SET) {
-				if (!conn_addr_cmp(pkt, ip_hdr,
-						   &conn->remote_addr,
-						   true)) {
-					continue;
-				}
-			}
-
-			if (conn->flags & NET_CONN_LOCAL_ADDR_SET) {
-				if (!conn_addr_cmp(pkt, ip_hdr,
-						   &conn->local_addr,
-						   false)) {
-					continue;
-				}
+			if (!conn_end_points_match(conn, pkt, ip_hdr,
+						   src_port, dst_port)) {
+				continue;
 			}
 
 			/* If we have an existing best_match, and that one
@@ -800,6 +1042,7 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	}
 
+deliver:
 	conn = best_match;
 	if (conn) {
 		NET_DBG("[%p] match found cb %p ud %p rank 0x%02x",
@@ -859,6 +1102,11 @@ void net_conn_init(void)
 
 	sys_slist_init(&conn_unused);
 	sys_slist_init(&conn_used);
+	sys_slist_init(&conn_wildcard);
+
+	for (i = 0; i < ARRAY_SIZE(conn_hash); i++) {
+		sys_slist_init(&conn_hash[i]);
+	}
 
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
 		sys_slist_prepend(&conn_unused, &conns[i].node);
@@ -51,6 +51,9 @@ struct net_conn {
 	/** Internal slist node */
 	sys_snode_t node;
 
+	/** Internal node in the lookup hash table */
+	sys_snode_t hash_node;
+
 	/** Remote IP address */
 	struct sockaddr remote_addr;
 
@@ -189,6 +192,24 @@ static inline enum net_verdict net_conn_input(struct net_pkt *pkt,
 }
 #endif /* CONFIG_NET_UDP || CONFIG_NET_TCP  || CONFIG_NET_SOCKETS_PACKET */
 
+/**
+ * @brief Hash the end points of a connection.
+ *
+ * Used to index connection lookup tables. The ports are in network byte
+ * order, and the remote address can be NULL to hash the ports only.
+ *
+ * @param proto Protocol of the connection
+ * @param family Address family of the remote address
+ * @param remote_addr Remote IPv4 or IPv6 address, can be unaligned
+ * @param remote_port Remote port
+ * @param local_port Local port
+ *
+ * @return Hash value
+ */
+uint32_t net_conn_hash(uint8_t proto, sa_family_t family,
+		       const void *remote_addr, uint16_t remote_port,
+		       uint16_t local_port);
+
 /**
  * @typedef net_conn_foreach_cb_t
  * @brief Callback used while iterating over network connection
@@ -315,6 +315,18 @@ enum net_verdict net_ipv4_input(struct net_pkt *pkt)
 
 	net_pkt_set_family(pkt, PF_INET);
 
+	if (IS_ENABLED(CONFIG_NET_IPV4_FRAGMENT) &&
+	    ((hdr->offset[0] << 8 | hdr->offset[1]) &
+	     ((NET_IPV4_MF << 13) | NET_IPV4_FRAGH_OFFSET_MASK))) {
+		/* The fragment is kept until the whole packet is received */
+		verdict = net_ipv4_handle_fragment_hdr(pkt, hdr);
+		if (verdict == NET_DROP) {
+			goto drop;
+		}
+
+		return verdict;
+	}
+
 	NET_DBG("IPv4 packet received from %s to %s",
 		log_strdup(net_sprint_ipv4_addr(&hdr->src)),
 		log_strdup(net_sprint_ipv4_addr(&hdr->dst)));
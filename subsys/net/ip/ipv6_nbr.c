@@ -97,6 +97,8 @@ NET_NBR_TABLE_INIT(NET_NBR_GLOBAL,
 		   net_neighbor_pool,
 		   net_neighbor_table_clear);
 
+NET_NBR_HASH_INIT(net_neighbor_hash, CONFIG_NET_IPV6_NBR_HASH_SIZE);
+
 const char *net_ipv6_nbr_state2str(enum net_ipv6_nbr_state state)
 {
 	switch (state) {
@@ -259,20 +261,24 @@ static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 				  struct net_if *iface,
 				  const struct in6_addr *addr)
 {
-	int i;
+	struct net_ipv6_nbr_data *data;
+	sys_slist_t *bucket;
 
-	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
-		struct net_nbr *nbr = get_nbr(i);
+	ARG_UNUSED(table);
 
-		if (!nbr->ref) {
-			continue;
-		}
+	bucket = net_nbr_hash_bucket(&net_neighbor_hash, addr,
+				     sizeof(struct in6_addr));
+
+	SYS_SLIST_FOR_EACH_CONTAINER(bucket, data, node) {
+		/* The data is stored right after the neighbor */
+		struct net_nbr *nbr = CONTAINER_OF((uint8_t *)data,
+						   struct net_nbr, __nbr);
 
 		if (iface && nbr->iface != iface) {
 			continue;
 		}
 
-		if (net_ipv6_addr_cmp(&net_ipv6_nbr_data(nbr)->addr, addr)) {
+		if (net_ipv6_addr_cmp(&data->addr, addr)) {
 			return nbr;
 		}
 	}
@@ -408,6 +414,8 @@ static void nbr_init(struct net_nbr *nbr, struct net_if *iface,
 	nbr->iface = iface;
 
 	net_ipaddr_copy(&net_ipv6_nbr_data(nbr)->addr, addr);
+	net_nbr_hash_add(&net_neighbor_hash, addr, sizeof(struct in6_addr),
+			 &net_ipv6_nbr_data(nbr)->node);
 	ipv6_nbr_set_state(nbr, state);
 	net_ipv6_nbr_data(nbr)->is_router = is_router;
 	net_ipv6_nbr_data(nbr)->pending = NULL;
@@ -653,6 +661,11 @@ void net_neighbor_data_remove(struct net_nbr *nbr)
 {
 	NET_DBG("Neighbor %p removed", nbr);
 
+	(void)net_nbr_hash_del(&net_neighbor_hash,
+			       &net_ipv6_nbr_data(nbr)->addr,
+			       sizeof(struct in6_addr),
+			       &net_ipv6_nbr_data(nbr)->node);
+
 	return;
 }
 
@@ -787,9 +800,11 @@ enum net_verdict net_ipv6_prepare_for_send(struct net_pkt *pkt)
 
 #if defined(CONFIG_NET_IPV6_FRAGMENT)
 	/* If we have already fragmented the packet, the fragment id will
-	 * contain a proper value and we can skip other checks.
+	 * contain a proper value and we can skip other checks. The device
+	 * splits the TCP packets built for several segments.
 	 */
-	if (net_pkt_ipv6_fragment_id(pkt) == 0U) {
+	if (net_pkt_ipv6_fragment_id(pkt) == 0U &&
+	    net_pkt_gso_size(pkt) == 0U) {
 		uint16_t mtu = net_if_get_mtu(net_pkt_iface(pkt));
 		size_t pkt_len = net_pkt_get_len(pkt);
 
@@ -2486,6 +2501,7 @@ static struct net_icmpv6_handler ra_input_handler = {
 void net_ipv6_nbr_init(void)
 {
 #if defined(CONFIG_NET_IPV6_NBR_CACHE)
+	net_nbr_hash_init(&net_neighbor_hash);
 	net_icmpv6_register_handler(&ns_input_handler);
 	net_icmpv6_register_handler(&na_input_handler);
 	k_work_init_delayable(&ipv6_ns_reply_timer, ipv6_ns_reply_timeout);
@@ -13,6 +13,7 @@
 #include <stddef.h>
 #include <zephyr/types.h>
 #include <stdbool.h>
+#include <sys/slist.h>
 
 #include <net/net_if.h>
 
@@ -217,6 +218,103 @@ void net_nbr_clear_table(struct net_nbr_table *table);
  */
 void net_nbr_print(struct net_nbr_table *table);
 
+/**
+ * @brief Hash index of neighbors by protocol address.
+ *
+ * @details Every neighbor is linked in the bucket of its address, so a
+ * lookup only walks the neighbors sharing that bucket instead of the
+ * whole table. This is used by both the ARP cache and the IPv6 neighbor
+ * cache.
+ */
+struct net_nbr_hash {
+	/** Buckets, each one a list of neighbors */
+	sys_slist_t *buckets;
+
+	/** Number of buckets, a power of two */
+	const uint16_t bucket_count;
+};
+
+/**
+ * @brief Statically define a neighbor hash index.
+ *
+ * @param _name Name of the hash index.
+ * @param _count Number of buckets, must be a power of two.
+ */
+#define NET_NBR_HASH_INIT(_name, _count)				\
+	BUILD_ASSERT(((_count) & ((_count) - 1)) == 0,			\
+		     "Number of buckets must be a power of two");	\
+	static sys_slist_t _name##_buckets[_count];			\
+	static struct net_nbr_hash _name = {				\
+		.buckets = _name##_buckets,				\
+		.bucket_count = _count,					\
+	}
+
+/**
+ * @brief Empty all the buckets of a hash index.
+ * @param hash Hash index
+ */
+static inline void net_nbr_hash_init(struct net_nbr_hash *hash)
+{
+	int i;
+
+	for (i = 0; i < hash->bucket_count; i++) {
+		sys_slist_init(&hash->buckets[i]);
+	}
+}
+
+/**
+ * @brief Get the bucket of an address.
+ * @param hash Hash index
+ * @param addr Protocol address
+ * @param len Length of the address
+ * @return Pointer to the list of neighbors of the bucket
+ */
+static inline sys_slist_t *net_nbr_hash_bucket(struct net_nbr_hash *hash,
+					       const void *addr, size_t len)
+{
+	const uint8_t *ptr = addr;
+	uint32_t value = 2166136261U;
+
+	/* FNV-1a, its low bits are well mixed even for addresses which
+	 * only differ in their last byte.
+	 */
+	while (len--) {
+		value = (value ^ *ptr++) * 16777619U;
+	}
+
+	return &hash->buckets[value & (hash->bucket_count - 1)];
+}
+
+/**
+ * @brief Link a neighbor in the bucket of its address.
+ * @param hash Hash index
+ * @param addr Protocol address of the neighbor
+ * @param len Length of the address
+ * @param node Node of the neighbor
+ */
+static inline void net_nbr_hash_add(struct net_nbr_hash *hash,
+				    const void *addr, size_t len,
+				    sys_snode_t *node)
+{
+	sys_slist_prepend(net_nbr_hash_bucket(hash, addr, len), node);
+}
+
+/**
+ * @brief Unlink a neighbor added with net_nbr_hash_add().
+ * @param hash Hash index
+ * @param addr Protocol address of the neighbor
+ * @param len Length of the address
+ * @param node Node of the neighbor
+ * @return True if the neighbor was found in its bucket
+ */
+static inline bool net_nbr_hash_del(struct net_nbr_hash *hash,
+				    const void *addr, size_t len,
+				    sys_snode_t *node)
+{
+	return sys_slist_find_and_remove(net_nbr_hash_bucket(hash, addr, len),
+					 node);
+}
+
 #ifdef __cplusplus
 }
 #endif
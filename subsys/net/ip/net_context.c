@@ -1213,6 +1213,54 @@ static int get_context_txtime(struct net_context *context,
 #endif
 }
 
+static int get_context_reuseport(struct net_context *context,
+				 void *value, size_t *len)
+{
+#if defined(CONFIG_NET_CONTEXT_REUSEPORT)
+	*((bool *)value) = context->options.reuseport;
+
+	if (len) {
+		*len = sizeof(bool);
+	}
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+static int get_context_rcvbuf(struct net_context *context,
+			      void *value, size_t *len)
+{
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	*((int *)value) = context->options.rcvbuf;
+
+	if (len) {
+		*len = sizeof(int);
+	}
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+static int get_context_sndbuf(struct net_context *context,
+			      void *value, size_t *len)
+{
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+	*((int *)value) = context->options.sndbuf;
+
+	if (len) {
+		*len = sizeof(int);
+	}
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
 static int get_context_rcvtimeo(struct net_context *context,
 				void *value, size_t *len)
 {
@@ -1245,6 +1293,17 @@ static int get_context_sndtimeo(struct net_context *context,
 #endif
 }
 
+static int get_context_tcp_option(struct net_context *context,
+				  enum net_context_option option,
+				  void *value, size_t *len)
+{
+	if (net_context_get_ip_proto(context) != IPPROTO_TCP) {
+		return -EINVAL;
+	}
+
+	return net_tcp_get_option(context, option, value, len);
+}
+
 /* If buf is not NULL, then use it. Otherwise read the data to be written
  * to net_pkt from msghdr.
  */
@@ -1403,9 +1462,29 @@ static void set_pkt_txtime(struct net_pkt *pkt, const struct msghdr *msghdr)
 	}
 }
 
+/* Give the caller's buffers back from a packet that failed to be sent */
+static void context_return_frags(struct net_pkt *pkt, struct net_buf *frags)
+{
+	struct net_buf *buf = pkt->buffer;
+
+	if (buf == frags) {
+		pkt->buffer = NULL;
+		return;
+	}
+
+	while (buf && buf->frags != frags) {
+		buf = buf->frags;
+	}
+
+	if (buf) {
+		buf->frags = NULL;
+	}
+}
+
 static int context_sendto(struct net_context *context,
 			  const void *buf,
 			  size_t len,
+			  struct net_buf *frags,
 			  const struct sockaddr *dst_addr,
 			  socklen_t addrlen,
 			  net_context_send_cb_t cb,
@@ -1621,15 +1700,27 @@ static int context_sendto(struct net_context *context,
 		return -ENETDOWN;
 	}
 
-	pkt = context_alloc_pkt(context, len, PKT_WAIT_TIME);
-	if (!pkt) {
-		return -ENOBUFS;
-	}
+	if (frags) {
+		/* Only the headers are allocated, the payload is the
+		 * caller's buffers.
+		 */
+		len = net_buf_frags_len(frags);
+
+		pkt = context_alloc_pkt(context, 0, PKT_WAIT_TIME);
+		if (!pkt) {
+			return -ENOBUFS;
+		}
+	} else {
+		pkt = context_alloc_pkt(context, len, PKT_WAIT_TIME);
+		if (!pkt) {
+			return -ENOBUFS;
+		}
 
-	tmp_len = net_pkt_available_payload_buffer(
+		tmp_len = net_pkt_available_payload_buffer(
 				pkt, net_context_get_ip_proto(context));
-	if (tmp_len < len) {
-		len = tmp_len;
+		if (tmp_len < len) {
+			len = tmp_len;
+		}
 	}
 
 	context->send_cb = cb;
@@ -1675,21 +1766,36 @@ static int context_sendto(struct net_context *context,
 		}
 	} else if (IS_ENABLED(CONFIG_NET_UDP) &&
 	    net_context_get_ip_proto(context) == IPPROTO_UDP) {
-		ret = context_setup_udp_packet(context, pkt, buf, len, msghdr,
+		ret = context_setup_udp_packet(context, pkt, buf,
+					       frags ? 0 : len, msghdr,
 					       dst_addr, addrlen);
 		if (ret < 0) {
 			goto fail;
 		}
 
+		if (frags) {
+			net_pkt_append_buffer(pkt, frags);
+		}
+
 		context_finalize_packet(context, pkt);
 
 		ret = net_send_data(pkt);
 	} else if (IS_ENABLED(CONFIG_NET_TCP) &&
 		   net_context_get_ip_proto(context) == IPPROTO_TCP) {
 
-		ret = context_write_data(pkt, buf, len, msghdr);
-		if (ret < 0) {
-			goto fail;
+		if (frags) {
+			/* TCP makes its own segments, queue only the payload */
+			if (pkt->buffer) {
+				net_pkt_frag_unref(pkt->buffer);
+				pkt->buffer = NULL;
+			}
+
+			net_pkt_append_buffer(pkt, frags);
+		} else {
+			ret = context_write_data(pkt, buf, len, msghdr);
+			if (ret < 0) {
+				goto fail;
+			}
 		}
 
 		net_pkt_cursor_init(pkt);
@@ -1737,6 +1843,10 @@ static int context_sendto(struct net_context *context,
 
 	return len;
 fail:
+	if (frags) {
+		context_return_frags(pkt, frags);
+	}
+
 	net_pkt_unref(pkt);
 
 	return ret;
@@ -1777,7 +1887,7 @@ int net_context_send(struct net_context *context,
 		addrlen = 0;
 	}
 
-	ret = context_sendto(context, buf, len, &context->remote,
+	ret = context_sendto(context, buf, len, NULL, &context->remote,
 			     addrlen, cb, timeout, user_data, false);
 unlock:
 	k_mutex_unlock(&context->lock);
@@ -1796,7 +1906,7 @@ int net_context_sendmsg(struct net_context *context,
 
 	k_mutex_lock(&context->lock, K_FOREVER);
 
-	ret = context_sendto(context, msghdr, 0, NULL, 0,
+	ret = context_sendto(context, msghdr, 0, NULL, NULL, 0,
 			     cb, timeout, user_data, true);
 
 	k_mutex_unlock(&context->lock);
@@ -1817,7 +1927,7 @@ int net_context_sendto(struct net_context *context,
 
 	k_mutex_lock(&context->lock, K_FOREVER);
 
-	ret = context_sendto(context, buf, len, dst_addr, addrlen,
+	ret = context_sendto(context, buf, len, NULL, dst_addr, addrlen,
 			     cb, timeout, user_data, true);
 
 	k_mutex_unlock(&context->lock);
@@ -1825,6 +1935,52 @@ int net_context_sendto(struct net_context *context,
 	return ret;
 }
 
+int net_context_send_buf(struct net_context *context,
+			 struct net_buf *frags,
+			 const struct sockaddr *dst_addr,
+			 socklen_t addrlen,
+			 net_context_send_cb_t cb,
+			 k_timeout_t timeout,
+			 void *user_data)
+{
+	int ret;
+
+	if (!frags) {
+		return -EINVAL;
+	}
+
+	if ((net_context_get_family(context) != AF_INET &&
+	     net_context_get_family(context) != AF_INET6) ||
+	    (net_context_get_ip_proto(context) != IPPROTO_UDP &&
+	     net_context_get_ip_proto(context) != IPPROTO_TCP) ||
+	    (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+	     net_if_is_ip_offloaded(net_context_get_iface(context)))) {
+		return -EOPNOTSUPP;
+	}
+
+	k_mutex_lock(&context->lock, K_FOREVER);
+
+	if (!dst_addr) {
+		if (!(context->flags & NET_CONTEXT_REMOTE_ADDR_SET) ||
+		    !net_sin(&context->remote)->sin_port) {
+			ret = -EDESTADDRREQ;
+			goto unlock;
+		}
+
+		dst_addr = &context->remote;
+		addrlen = net_context_get_family(context) == AF_INET6 ?
+			  sizeof(struct sockaddr_in6) :
+			  sizeof(struct sockaddr_in);
+	}
+
+	ret = context_sendto(context, NULL, 0, frags, dst_addr, addrlen,
+			     cb, timeout, user_data, true);
+unlock:
+	k_mutex_unlock(&context->lock);
+
+	return ret;
+}
+
 enum net_verdict net_context_packet_received(struct net_conn *conn,
 					     struct net_pkt *pkt,
 					     union net_ip_header *ip_hdr,
@@ -1853,6 +2009,15 @@ enum net_verdict net_context_packet_received(struct net_conn *conn,
 		net_stats_update_tcp_recv(net_pkt_iface(pkt),
 					  net_pkt_remaining_data(pkt));
 	}
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	else if (context->options.rcvbuf &&
+		 atomic_get(&context->rcvbuf_used) >=
+		 context->options.rcvbuf) {
+		/* The reader is behind, do not let it hold more packets */
+		net_stats_update_rcvbuf_drop(net_pkt_iface(pkt));
+		goto unlock;
+	}
+#endif
 
 #if defined(CONFIG_NET_CONTEXT_SYNC_RECV)
 	k_sem_give(&context->recv_data_wait);
@@ -2117,6 +2282,14 @@ int net_context_update_recv_wnd(struct net_context *context,
 		return 0;
 	}
 
+	if (net_context_get_ip_proto(context) != IPPROTO_TCP) {
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+		/* The datagrams are counted by the receive buffer instead */
+		atomic_sub(&context->rcvbuf_used, delta);
+#endif
+		return 0;
+	}
+
 	k_mutex_lock(&context->lock, K_FOREVER);
 
 	ret = net_tcp_update_recv_wnd(context, delta);
@@ -2213,6 +2386,85 @@ static int set_context_sndtimeo(struct net_context *context,
 #endif
 }
 
+static int set_context_reuseport(struct net_context *context,
+				 const void *value, size_t len)
+{
+#if defined(CONFIG_NET_CONTEXT_REUSEPORT)
+	if (len > sizeof(bool)) {
+		return -EINVAL;
+	}
+
+	context->options.reuseport = *((bool *)value);
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+static int set_context_rcvbuf(struct net_context *context,
+			      const void *value, size_t len)
+{
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	int rcvbuf;
+
+	if (len != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	rcvbuf = *((int *)value);
+	if (rcvbuf < 0) {
+		return -EINVAL;
+	}
+
+	context->options.rcvbuf = rcvbuf;
+
+	/* A connected TCP context also limits the window it advertises */
+	if (net_context_get_ip_proto(context) == IPPROTO_TCP &&
+	    context->tcp) {
+		return net_tcp_set_option(context, NET_OPT_RCVBUF, value, len);
+	}
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+static int set_context_sndbuf(struct net_context *context,
+			      const void *value, size_t len)
+{
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+	int sndbuf;
+
+	if (len != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	sndbuf = *((int *)value);
+	if (sndbuf < 0) {
+		return -EINVAL;
+	}
+
+	context->options.sndbuf = sndbuf;
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+static int set_context_tcp_option(struct net_context *context,
+				  enum net_context_option option,
+				  const void *value, size_t len)
+{
+	if (net_context_get_ip_proto(context) != IPPROTO_TCP) {
+		return -EINVAL;
+	}
+
+	return net_tcp_set_option(context, option, value, len);
+}
+
 int net_context_set_option(struct net_context *context,
 			   enum net_context_option option,
 			   const void *value, size_t len)
@@ -2243,6 +2495,19 @@ int net_context_set_option(struct net_context *context,
 	case NET_OPT_SNDTIMEO:
 		ret = set_context_sndtimeo(context, value, len);
 		break;
+	case NET_OPT_TCP_NODELAY:
+	case NET_OPT_TCP_CORK:
+		ret = set_context_tcp_option(context, option, value, len);
+		break;
+	case NET_OPT_REUSEPORT:
+		ret = set_context_reuseport(context, value, len);
+		break;
+	case NET_OPT_RCVBUF:
+		ret = set_context_rcvbuf(context, value, len);
+		break;
+	case NET_OPT_SNDBUF:
+		ret = set_context_sndbuf(context, value, len);
+		break;
 	}
 
 	k_mutex_unlock(&context->lock);
@@ -2280,6 +2545,19 @@ int net_context_get_option(struct net_context *context,
 	case NET_OPT_SNDTIMEO:
 		ret = get_context_sndtimeo(context, value, len);
 		break;
+	case NET_OPT_TCP_NODELAY:
+	case NET_OPT_TCP_CORK:
+		ret = get_context_tcp_option(context, option, value, len);
+		break;
+	case NET_OPT_REUSEPORT:
+		ret = get_context_reuseport(context, value, len);
+		break;
+	case NET_OPT_RCVBUF:
+		ret = get_context_rcvbuf(context, value, len);
+		break;
+	case NET_OPT_SNDBUF:
+		ret = get_context_sndbuf(context, value, len);
+		break;
 	}
 
 	k_mutex_unlock(&context->lock);
@@ -42,6 +42,7 @@ LOG_MODULE_REGISTER(net_core, CONFIG_NET_CORE_LOG_LEVEL);
 #include "ipv6.h"
 
 #include "icmpv4.h"
+#include "ipv4.h"
 
 #include "dhcpv4.h"
 
@@ -57,9 +58,60 @@ LOG_MODULE_REGISTER(net_core, CONFIG_NET_CORE_LOG_LEVEL);
 
 #include "net_stats.h"
 
+#if defined(CONFIG_NET_TCP_GRO)
+/* TCP segments held back for coalescing, one slot per RX thread */
+static struct net_tcp_gro gro_state[NET_TC_RX_COUNT];
+#endif
+
+static bool is_loopback_iface(struct net_if *iface)
+{
+#if defined(CONFIG_NET_LOOPBACK) && defined(CONFIG_NET_L2_DUMMY)
+	return net_if_l2(iface) == &NET_L2_GET_NAME(DUMMY);
+#else
+	ARG_UNUSED(iface);
+
+	return false;
+#endif
+}
+
+static enum net_verdict process_ip(struct net_pkt *pkt, bool is_loopback)
+{
+	/* IP version and header length. */
+	switch (NET_IPV6_HDR(pkt)->vtc & 0xf0) {
+#if defined(CONFIG_NET_IPV6)
+	case 0x60:
+		return net_ipv6_input(pkt, is_loopback);
+#endif
+#if defined(CONFIG_NET_IPV4)
+	case 0x40:
+		return net_ipv4_input(pkt);
+#endif
+	}
+
+	NET_DBG("Unknown IP family packet (0x%x)",
+		NET_IPV6_HDR(pkt)->vtc & 0xf0);
+	net_stats_update_ip_errors_protoerr(net_pkt_iface(pkt));
+	net_stats_update_ip_errors_vhlerr(net_pkt_iface(pkt));
+
+	return NET_DROP;
+}
+
+/* Pass up a packet that was held back for coalescing */
+static void process_coalesced(struct net_pkt *pkt)
+{
+	net_pkt_cursor_init(pkt);
+
+	if (process_ip(pkt, is_loopback_iface(net_pkt_iface(pkt))) != NET_OK) {
+		NET_DBG("Dropping pkt %p", pkt);
+		net_pkt_unref(pkt);
+	}
+}
+
 static inline enum net_verdict process_data(struct net_pkt *pkt,
-					    bool is_loopback)
+					    bool is_loopback,
+					    struct net_tcp_gro *gro)
 {
+	struct net_pkt *flush;
 	int ret;
 	bool locally_routed = false;
 
@@ -78,6 +130,11 @@ static inline enum net_verdict process_data(struct net_pkt *pkt,
 	}
 #endif
 
+	/* Same for a reassembled IPv4 packet */
+	if (net_pkt_ipv4_reassembled(pkt)) {
+		locally_routed = true;
+	}
+
 	/* If there is no data, then drop the packet. */
 	if (!pkt->frags) {
 		NET_DBG("Corrupted packet (frags %p)", pkt->frags);
@@ -115,30 +172,29 @@ static inline enum net_verdict process_data(struct net_pkt *pkt,
 	 */
 	net_pkt_cursor_init(pkt);
 
-	/* IP version and header length. */
-	switch (NET_IPV6_HDR(pkt)->vtc & 0xf0) {
-#if defined(CONFIG_NET_IPV6)
-	case 0x60:
-		return net_ipv6_input(pkt, is_loopback);
-#endif
-#if defined(CONFIG_NET_IPV4)
-	case 0x40:
-		return net_ipv4_input(pkt);
-#endif
-	}
+	if (IS_ENABLED(CONFIG_NET_TCP_GRO) && gro) {
+		ret = net_tcp_gro_receive(gro, pkt, &flush);
 
-	NET_DBG("Unknown IP family packet (0x%x)",
-		NET_IPV6_HDR(pkt)->vtc & 0xf0);
-	net_stats_update_ip_errors_protoerr(net_pkt_iface(pkt));
-	net_stats_update_ip_errors_vhlerr(net_pkt_iface(pkt));
+		/* The packet held back so far goes first */
+		if (flush) {
+			process_coalesced(flush);
+		}
 
-	return NET_DROP;
+		if (ret == NET_OK) {
+			return NET_OK;
+		}
+
+		net_pkt_cursor_init(pkt);
+	}
+
+	return process_ip(pkt, is_loopback);
 }
 
-static void processing_data(struct net_pkt *pkt, bool is_loopback)
+static void processing_data(struct net_pkt *pkt, bool is_loopback,
+			    struct net_tcp_gro *gro)
 {
 again:
-	switch (process_data(pkt, is_loopback)) {
+	switch (process_data(pkt, is_loopback, gro)) {
 	case NET_CONTINUE:
 		if (IS_ENABLED(CONFIG_NET_L2_VIRTUAL)) {
 			/* If we have a tunneling packet, feed it back
@@ -306,6 +362,12 @@ int net_send_data(struct net_pkt *pkt)
 		return -EINVAL;
 	}
 
+	/* The segments come back through here */
+	if (net_pkt_gso_size(pkt) &&
+	    net_if_need_tcp_segmentation(net_pkt_iface(pkt))) {
+		return net_tcp_gso_segment(pkt);
+	}
+
 #if defined(CONFIG_NET_STATISTICS)
 	switch (net_pkt_family(pkt)) {
 	case AF_INET:
@@ -328,10 +390,17 @@ int net_send_data(struct net_pkt *pkt)
 		 * to RX processing.
 		 */
 		NET_DBG("Loopback pkt %p back to us", pkt);
-		processing_data(pkt, true);
+		processing_data(pkt, true, NULL);
 		return 0;
 	}
 
+	/* Let the sender know rather than drop the packet silently */
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET &&
+	    net_ipv4_df_exceeds_mtu(pkt)) {
+		NET_DBG("Pkt %p too large and DF is set", pkt);
+		return -EMSGSIZE;
+	}
+
 	if (net_if_send_data(net_pkt_iface(pkt), pkt) == NET_DROP) {
 		return -EIO;
 	}
@@ -339,9 +408,9 @@ int net_send_data(struct net_pkt *pkt)
 	return 0;
 }
 
-static void net_rx(struct net_if *iface, struct net_pkt *pkt)
+static void net_rx(struct net_if *iface, struct net_pkt *pkt,
+		   struct net_tcp_gro *gro)
 {
-	bool is_loopback = false;
 	size_t pkt_len;
 
 	pkt_len = net_pkt_get_len(pkt);
@@ -350,33 +419,52 @@ static void net_rx(struct net_if *iface, struct net_pkt *pkt)
 
 	net_stats_update_bytes_recv(iface, pkt_len);
 
-	if (IS_ENABLED(CONFIG_NET_LOOPBACK)) {
-#ifdef CONFIG_NET_L2_DUMMY
-		if (net_if_l2(iface) == &NET_L2_GET_NAME(DUMMY)) {
-			is_loopback = true;
-		}
-#endif
-	}
-
-	processing_data(pkt, is_loopback);
+	processing_data(pkt, is_loopback_iface(iface), gro);
 
 	net_print_statistics();
 	net_pkt_print();
 }
 
-void net_process_rx_packet(struct net_pkt *pkt)
+void net_process_rx_packet(struct net_pkt *pkt, uint8_t tc)
 {
+	struct net_tcp_gro *gro = NULL;
+
+#if defined(CONFIG_NET_TCP_GRO)
+	gro = &gro_state[tc];
+#else
+	ARG_UNUSED(tc);
+#endif
+
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
 
 	net_capture_pkt(net_pkt_iface(pkt), pkt);
 
-	net_rx(net_pkt_iface(pkt), pkt);
+	net_rx(net_pkt_iface(pkt), pkt, gro);
 }
 
-static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
+void net_process_rx_flush(uint8_t tc)
+{
+#if defined(CONFIG_NET_TCP_GRO)
+	struct net_pkt *pkt = net_tcp_gro_flush(&gro_state[tc]);
+
+	if (pkt) {
+		process_coalesced(pkt);
+	}
+#else
+	ARG_UNUSED(tc);
+#endif
+}
+
+static uint8_t net_rx_classify(struct net_if *iface, struct net_pkt *pkt)
 {
 	uint8_t prio = net_pkt_priority(pkt);
-	uint8_t tc = net_rx_priority2tc(prio);
+	uint8_t tc;
+
+#if defined(CONFIG_NET_TC_RX_RSS)
+	tc = net_rx_flow2tc(iface, pkt);
+#else
+	tc = net_rx_priority2tc(prio);
+#endif
 
 #if defined(CONFIG_NET_STATISTICS)
 	net_stats_update_tc_recv_pkt(iface, tc);
@@ -388,13 +476,35 @@ static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 	NET_DBG("TC %d with prio %d pkt %p", tc, prio, pkt);
 #endif
 
+	return tc;
+}
+
+static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
+{
+	uint8_t tc = net_rx_classify(iface, pkt);
+
 	if (NET_TC_RX_COUNT == 0) {
-		net_process_rx_packet(pkt);
+		net_process_rx_packet(pkt, tc);
 	} else {
 		net_tc_submit_to_rx_queue(tc, pkt);
 	}
 }
 
+static void net_recv_prepare(struct net_if *iface, struct net_pkt *pkt)
+{
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_cursor_init(pkt);
+
+	NET_DBG("prio %d iface %p pkt %p len %zu", net_pkt_priority(pkt),
+		iface, pkt, net_pkt_get_len(pkt));
+
+	if (IS_ENABLED(CONFIG_NET_ROUTING)) {
+		net_pkt_set_orig_iface(pkt, iface);
+	}
+
+	net_pkt_set_iface(pkt, iface);
+}
+
 /* Called by driver when an IP packet has been received */
 int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 {
@@ -410,21 +520,67 @@ int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 		return -ENETDOWN;
 	}
 
-	net_pkt_set_overwrite(pkt, true);
-	net_pkt_cursor_init(pkt);
+	net_recv_prepare(iface, pkt);
 
-	NET_DBG("prio %d iface %p pkt %p len %zu", net_pkt_priority(pkt),
-		iface, pkt, net_pkt_get_len(pkt));
+	net_queue_rx(iface, pkt);
 
-	if (IS_ENABLED(CONFIG_NET_ROUTING)) {
-		net_pkt_set_orig_iface(pkt, iface);
+	return 0;
+}
+
+/* Called by driver when a burst of packets has been received */
+int net_recv_data_list(struct net_if *iface, sys_slist_t *list)
+{
+#if NET_TC_RX_COUNT > 0
+	sys_slist_t queues[NET_TC_RX_COUNT];
+#endif
+	struct net_pkt *pkt;
+	sys_snode_t *node;
+	int count = 0;
+	uint8_t tc;
+
+	if (!list || !iface) {
+		return -EINVAL;
 	}
 
-	net_pkt_set_iface(pkt, iface);
+	if (!net_if_flag_is_set(iface, NET_IF_UP)) {
+		return -ENETDOWN;
+	}
 
-	net_queue_rx(iface, pkt);
+#if NET_TC_RX_COUNT > 0
+	for (tc = 0; tc < NET_TC_RX_COUNT; tc++) {
+		sys_slist_init(&queues[tc]);
+	}
+#endif
 
-	return 0;
+	while ((node = sys_slist_get(list)) != NULL) {
+		pkt = CONTAINER_OF(node, struct net_pkt, burst);
+
+		if (net_pkt_is_empty(pkt)) {
+			net_pkt_unref(pkt);
+			continue;
+		}
+
+		net_recv_prepare(iface, pkt);
+
+		tc = net_rx_classify(iface, pkt);
+		count++;
+
+#if NET_TC_RX_COUNT > 0
+		sys_slist_append(&queues[tc], &pkt->burst);
+#else
+		net_process_rx_packet(pkt, tc);
+#endif
+	}
+
+#if NET_TC_RX_COUNT > 0
+	for (tc = 0; tc < NET_TC_RX_COUNT; tc++) {
+		if (!sys_slist_is_empty(&queues[tc])) {
+			net_tc_submit_list_to_rx_queue(tc, &queues[tc]);
+		}
+	}
+#endif
+
+	return count;
 }
 
 static inline void l3_init(void)
@@ -446,6 +602,8 @@ static inline void l3_init(void)
 
 	net_route_init();
 
+	net_route_ipv4_init();
+
 	NET_DBG("Network L3 init done");
 }
 
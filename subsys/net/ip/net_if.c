@@ -23,7 +23,9 @@ LOG_MODULE_REGISTER(net_if, CONFIG_NET_IF_LOG_LEVEL);
 
 #include "net_private.h"
 #include "ipv6.h"
+#include "ipv4.h"
 #include "ipv4_autoconf_internal.h"
+#include "route.h"
 
 #include "net_stats.h"
 
@@ -331,6 +333,52 @@ void net_process_tx_packet(struct net_pkt *pkt)
 #endif
 }
 
+void net_process_tx_drop(struct net_pkt *pkt, int status)
+{
+	struct net_linkaddr ll_dst = {
+		.addr = NULL
+	};
+	struct net_linkaddr_storage ll_dst_storage;
+	struct net_context *context = net_pkt_context(pkt);
+	struct net_if *iface = net_pkt_iface(pkt);
+
+	if (!sys_slist_is_empty(&link_callbacks)) {
+		if (net_linkaddr_set(&ll_dst_storage,
+				     net_pkt_lladdr_dst(pkt)->addr,
+				     net_pkt_lladdr_dst(pkt)->len) == 0) {
+			ll_dst.addr = ll_dst_storage.addr;
+			ll_dst.len = ll_dst_storage.len;
+			ll_dst.type = net_pkt_lladdr_dst(pkt)->type;
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_NET_TCP) && net_pkt_family(pkt) != AF_UNSPEC) {
+		net_pkt_set_queued(pkt, false);
+	}
+
+	net_pkt_unref(pkt);
+
+	/* The sender learns about the drop as if the driver had failed */
+	net_context_send_cb(context, status);
+
+	if (ll_dst.addr) {
+		net_if_call_link_cb(iface, &ll_dst, status);
+	}
+
+#if defined(CONFIG_NET_POWER_MANAGEMENT)
+	iface->tx_pending--;
+#endif
+}
+
+void net_process_tx_flush(struct net_if *iface)
+{
+	const struct net_if_api *api = net_if_get_device(iface)->api;
+
+	if (api && api->tx_flush) {
+		api->tx_flush(iface);
+	}
+}
+
 void net_if_queue_tx(struct net_if *iface, struct net_pkt *pkt)
 {
 	uint8_t prio = net_pkt_priority(pkt);
@@ -347,6 +395,7 @@ void net_if_queue_tx(struct net_if *iface, struct net_pkt *pkt)
 	if ((IS_ENABLED(CONFIG_NET_TC_SKIP_FOR_HIGH_PRIO) &&
 	     prio == NET_PRIORITY_CA) || NET_TC_TX_COUNT == 0) {
 		net_pkt_set_tx_stats_tick(pkt, k_cycle_get_32());
+		net_pkt_set_tx_more(pkt, false);
 
 		net_if_tx(net_pkt_iface(pkt), pkt);
 		return;
@@ -475,6 +524,10 @@ enum net_verdict net_if_send_data(struct net_if *iface, struct net_pkt *pkt)
 		verdict = net_ipv6_prepare_for_send(pkt);
 	}
 
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		verdict = net_ipv4_prepare_for_send(pkt);
+	}
+
 done:
 	/*   NET_OK in which case packet has checked successfully. In this case
 	 *   the net_context callback is called after successful delivery in
@@ -3065,6 +3118,16 @@ struct net_if *net_if_ipv4_select_src_iface(const struct in_addr *dst)
 		}
 	}
 
+	if (IS_ENABLED(CONFIG_NET_IPV4_ROUTE)) {
+		struct net_route_entry_ipv4 *route;
+
+		route = net_route_ipv4_lookup(NULL, dst);
+		if (route) {
+			selected = route->iface;
+			goto out;
+		}
+	}
+
 	if (selected == NULL) {
 		selected = net_if_get_default();
 	}
@@ -3938,6 +4001,11 @@ bool net_if_need_calc_rx_checksum(struct net_if *iface)
 	return need_calc_checksum(iface, ETHERNET_HW_RX_CHKSUM_OFFLOAD);
 }
 
+bool net_if_need_tcp_segmentation(struct net_if *iface)
+{
+	return need_calc_checksum(iface, ETHERNET_HW_TX_TCP_SEG_OFFLOAD);
+}
+
 int net_if_get_by_iface(struct net_if *iface)
 {
 	if (!(iface >= _net_if_list_start && iface < _net_if_list_end)) {
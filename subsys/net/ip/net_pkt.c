@@ -40,6 +40,7 @@ LOG_MODULE_REGISTER(net_pkt, CONFIG_NET_PKT_LOG_LEVEL);
 
 #include "net_private.h"
 #include "tcp_internal.h"
+#include "net_stats.h"
 
 /* Find max header size of IP protocol (IPv4 or IPv6) */
 #if defined(CONFIG_NET_IPV6) || defined(CONFIG_NET_RAW_MODE) || \
@@ -595,6 +596,12 @@ done:
 		net_pkt_cursor_init(pkt);
 	}
 
+#if CONFIG_NET_PKT_RX_IFACE_RESERVE > 0
+	if (pkt->rx_reserve_iface) {
+		atomic_dec(&pkt->rx_reserve_iface->rx_pkts);
+	}
+#endif
+
 	k_mem_slab_free(pkt->slab, (void **)&pkt);
 }
 
@@ -963,15 +970,26 @@ static size_t pkt_buffer_length(struct net_pkt *pkt,
 
 	/* Family vs iface MTU */
 	if (IS_ENABLED(CONFIG_NET_IPV6) && family == AF_INET6) {
-		if (IS_ENABLED(CONFIG_NET_IPV6_FRAGMENT) && (size > max_len)) {
-			/* We support larger packets if IPv6 fragmentation is
-			 * enabled.
+		if ((IS_ENABLED(CONFIG_NET_IPV6_FRAGMENT) ||
+		     (IS_ENABLED(CONFIG_NET_TCP_GSO) &&
+		      proto == IPPROTO_TCP)) && (size > max_len)) {
+			/* We support larger packets if IPv6 fragmentation or
+			 * TCP segmentation offload is enabled.
 			 */
 			max_len = size;
 		}
 
 		max_len = MAX(max_len, NET_IPV6_MTU);
 	} else if (IS_ENABLED(CONFIG_NET_IPV4) && family == AF_INET) {
+		if ((IS_ENABLED(CONFIG_NET_IPV4_FRAGMENT) ||
+		     (IS_ENABLED(CONFIG_NET_TCP_GSO) &&
+		      proto == IPPROTO_TCP)) && (size > max_len)) {
+			/* We support larger packets if IPv4 fragmentation or
+			 * TCP segmentation offload is enabled.
+			 */
+			max_len = size;
+		}
+
 		max_len = MAX(max_len, NET_IPV4_MTU);
 	} else { /* family == AF_UNSPEC */
 #if defined (CONFIG_NET_L2_ETHERNET)
@@ -993,6 +1011,27 @@ static size_t pkt_buffer_length(struct net_pkt *pkt,
 	return MIN(size, max_len);
 }
 
+static size_t pkt_l2_headroom(struct net_pkt *pkt)
+{
+#if defined(CONFIG_NET_PKT_L2_HEADROOM)
+	sa_family_t family = net_pkt_family(pkt);
+
+	/* Only the first buffer of a packet to be sent gets room for the
+	 * Ethernet header, see ethernet_fill_header().
+	 */
+	if (pkt->buffer || pkt->slab == &rx_pkts || !net_pkt_iface(pkt) ||
+	    (family != AF_INET && family != AF_INET6)) {
+		return 0;
+	}
+
+	if (net_if_l2(net_pkt_iface(pkt)) == &NET_L2_GET_NAME(ETHERNET)) {
+		return ROUND_UP(NET_ETH_MAX_HDR_SIZE, sizeof(uint32_t));
+	}
+#endif /* CONFIG_NET_PKT_L2_HEADROOM */
+
+	return 0;
+}
+
 static size_t pkt_estimate_headers_length(struct net_pkt *pkt,
 					  sa_family_t family,
 					  enum net_ip_protocol proto)
@@ -1141,6 +1180,7 @@ int net_pkt_alloc_buffer(struct net_pkt *pkt,
 	struct net_buf_pool *pool = NULL;
 	size_t alloc_len = 0;
 	size_t hdr_len = 0;
+	size_t headroom;
 	struct net_buf *buf;
 
 	if (!size && proto == 0 && net_pkt_family(pkt) == AF_UNSPEC) {
@@ -1165,6 +1205,8 @@ int net_pkt_alloc_buffer(struct net_pkt *pkt,
 	/* Calculate the maximum that can be allocated depending on size */
 	alloc_len = pkt_buffer_length(pkt, size + hdr_len, proto, alloc_len);
 
+	headroom = pkt_l2_headroom(pkt);
+
 	NET_DBG("Data allocation maximum size %zu (requested %zu)",
 		alloc_len, size);
 
@@ -1188,9 +1230,10 @@ int net_pkt_alloc_buffer(struct net_pkt *pkt,
 	}
 
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
-	buf = pkt_alloc_buffer(pool, alloc_len, timeout, caller, line);
+	buf = pkt_alloc_buffer(pool, alloc_len + headroom, timeout,
+			       caller, line);
 #else
-	buf = pkt_alloc_buffer(pool, alloc_len, timeout);
+	buf = pkt_alloc_buffer(pool, alloc_len + headroom, timeout);
 #endif
 
 	if (!buf) {
@@ -1203,6 +1246,10 @@ int net_pkt_alloc_buffer(struct net_pkt *pkt,
 		return -ENOMEM;
 	}
 
+	if (headroom && headroom < buf->size) {
+		net_buf_reserve(buf, headroom);
+	}
+
 	net_pkt_append_buffer(pkt, buf);
 
 	return 0;
@@ -1326,6 +1373,37 @@ struct net_pkt *net_pkt_rx_alloc(k_timeout_t timeout)
 #endif
 }
 
+#if CONFIG_NET_PKT_RX_IFACE_RESERVE > 0
+/* An interface can always have its reserved packets. It gets more only
+ * if the free packets still cover what the other interfaces have not
+ * used of their reservation.
+ */
+static bool rx_reserve_charge(struct net_pkt *pkt, struct net_if *iface)
+{
+	const int reserve = CONFIG_NET_PKT_RX_IFACE_RESERVE;
+	int needed = 0;
+
+	if (atomic_get(&iface->rx_pkts) >= reserve) {
+		STRUCT_SECTION_FOREACH(net_if, tmp) {
+			if (tmp != iface) {
+				needed += MAX(reserve -
+					      (int)atomic_get(&tmp->rx_pkts),
+					      0);
+			}
+		}
+
+		if (k_mem_slab_num_free_get(&rx_pkts) < needed) {
+			return false;
+		}
+	}
+
+	atomic_inc(&iface->rx_pkts);
+	pkt->rx_reserve_iface = iface;
+
+	return true;
+}
+#endif
+
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 static struct net_pkt *pkt_alloc_on_iface(struct k_mem_slab *slab,
 					  struct net_if *iface,
@@ -1350,6 +1428,15 @@ static struct net_pkt *pkt_alloc_on_iface(struct k_mem_slab *slab,
 		net_pkt_set_iface(pkt, iface);
 	}
 
+#if CONFIG_NET_PKT_RX_IFACE_RESERVE > 0
+	if (pkt && slab == &rx_pkts && iface &&
+	    !rx_reserve_charge(pkt, iface)) {
+		net_stats_update_rx_reserve_drop(iface);
+		net_pkt_unref(pkt);
+		pkt = NULL;
+	}
+#endif
+
 	return pkt;
 }
 
@@ -1774,6 +1861,7 @@ static void clone_pkt_attributes(struct net_pkt *pkt, struct net_pkt *clone_pkt)
 	net_pkt_set_orig_iface(clone_pkt, net_pkt_orig_iface(pkt));
 	net_pkt_set_captured(clone_pkt, net_pkt_is_captured(pkt));
 	net_pkt_set_l2_bridged(clone_pkt, net_pkt_is_l2_bridged(pkt));
+	net_pkt_set_gso_size(clone_pkt, net_pkt_gso_size(pkt));
 
 	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
 		net_pkt_set_ipv4_ttl(clone_pkt, net_pkt_ipv4_ttl(pkt));
@@ -2013,7 +2101,8 @@ size_t net_pkt_get_contiguous_len(struct net_pkt *pkt)
 		size_t len;
 
 		len = net_pkt_is_being_overwritten(pkt) ?
-			pkt->cursor.buf->len : pkt->cursor.buf->size;
+			pkt->cursor.buf->len :
+			net_buf_max_len(pkt->cursor.buf);
 		len -= pkt->cursor.pos - pkt->cursor.buf->data;
 		return len;
 	}
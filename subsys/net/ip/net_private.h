@@ -47,8 +47,11 @@ extern void net_if_post_init(void);
 extern void net_if_carrier_down(struct net_if *iface);
 extern void net_if_stats_reset(struct net_if *iface);
 extern void net_if_stats_reset_all(void);
-extern void net_process_rx_packet(struct net_pkt *pkt);
+extern void net_process_rx_packet(struct net_pkt *pkt, uint8_t tc);
+extern void net_process_rx_flush(uint8_t tc);
 extern void net_process_tx_packet(struct net_pkt *pkt);
+extern void net_process_tx_drop(struct net_pkt *pkt, int status);
+extern void net_process_tx_flush(struct net_if *iface);
 
 #if defined(CONFIG_NET_NATIVE) || defined(CONFIG_NET_OFFLOAD)
 extern void net_context_init(void);
@@ -90,6 +93,8 @@ static inline enum net_verdict net_ipv6_input(struct net_pkt *pkt,
 #endif
 extern bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt);
 extern void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt);
+extern void net_tc_submit_list_to_rx_queue(uint8_t tc, sys_slist_t *list);
+extern int net_rx_flow2tc(struct net_if *iface, struct net_pkt *pkt);
 extern enum net_verdict net_promisc_mode_input(struct net_pkt *pkt);
 
 char *net_sprint_addr(sa_family_t af, const void *addr);
@@ -203,6 +208,49 @@ static inline uint16_t net_calc_chksum_tcp(struct net_pkt *pkt)
 	return net_calc_chksum(pkt, IPPROTO_TCP);
 }
 
+/**
+ * @brief Update a checksum after a 16-bit word of the data it covers
+ * changed, without summing the data again (RFC 1624).
+ *
+ * @details The checksum and the values are taken in the same byte order,
+ * so header fields can be passed as they are in the packet.
+ *
+ * @param chksum Checksum covering the old value
+ * @param from Old value of the word
+ * @param to New value of the word
+ *
+ * @return Checksum covering the new value
+ */
+static inline uint16_t net_chksum_update16(uint16_t chksum, uint16_t from,
+					   uint16_t to)
+{
+	/* HC' = ~(~HC + ~m + m') */
+	uint32_t sum = (uint16_t)~chksum + (uint16_t)~from + (uint32_t)to;
+
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return ~sum;
+}
+
+/**
+ * @brief Update a checksum after a 32-bit word of the data it covers,
+ * like an IPv4 address, changed (RFC 1624).
+ *
+ * @param chksum Checksum covering the old value
+ * @param from Old value of the word
+ * @param to New value of the word
+ *
+ * @return Checksum covering the new value
+ */
+static inline uint16_t net_chksum_update32(uint16_t chksum, uint32_t from,
+					   uint32_t to)
+{
+	chksum = net_chksum_update16(chksum, from >> 16, to >> 16);
+
+	return net_chksum_update16(chksum, from & 0xffff, to & 0xffff);
+}
+
 static inline char *net_sprint_ll_addr(const uint8_t *ll, uint8_t ll_len)
 {
 	static char buf[sizeof("xx:xx:xx:xx:xx:xx:xx:xx")];
@@ -37,6 +37,7 @@ LOG_MODULE_REGISTER(net_shell, LOG_LEVEL_DBG);
 #include <sys/slist.h>
 #endif
 
+#include "ipv4.h"
 #include "ipv6.h"
 
 #if defined(CONFIG_NET_ARP)
@@ -766,6 +767,45 @@ static void iface_per_route_cb(struct net_if *iface, void *user_data)
 }
 #endif /* CONFIG_NET_ROUTE */
 
+#if defined(CONFIG_NET_IPV4_ROUTE) && defined(CONFIG_NET_NATIVE)
+static void route_ipv4_cb(struct net_route_entry_ipv4 *entry,
+			  void *user_data)
+{
+	struct net_shell_user_data *data = user_data;
+	const struct shell *shell = data->shell;
+	struct net_if *iface = data->user_data;
+
+	if (entry->iface != iface) {
+		return;
+	}
+
+	PR("IPv4 prefix : %s/%d\t", net_sprint_ipv4_addr(&entry->addr),
+	   entry->prefix_len);
+
+	if (net_ipv4_is_addr_unspecified(&entry->gw)) {
+		PR("gateway : <none>\n");
+	} else {
+		PR("gateway : %s\n", net_sprint_ipv4_addr(&entry->gw));
+	}
+}
+
+static void iface_per_route_ipv4_cb(struct net_if *iface, void *user_data)
+{
+	struct net_shell_user_data *data = user_data;
+	const struct shell *shell = data->shell;
+	const char *extra;
+
+	PR("\nIPv4 routes for interface %d (%p) (%s)\n",
+	   net_if_get_by_iface(iface), iface,
+	   iface2str(iface, &extra));
+	PR("=========================================%s\n", extra);
+
+	data->user_data = iface;
+
+	net_route_ipv4_foreach(route_ipv4_cb, data);
+}
+#endif /* CONFIG_NET_IPV4_ROUTE */
+
 #if defined(CONFIG_NET_ROUTE_MCAST) && defined(CONFIG_NET_NATIVE)
 static void route_mcast_cb(struct net_route_entry_mcast *entry,
 			   void *user_data)
@@ -1273,9 +1313,32 @@ static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 	PR("TCP conn drop  %d\tconnrst\t%d\n",
 	   GET_STAT(iface, tcp.conndrop),
 	   GET_STAT(iface, tcp.connrst));
+	PR("TCP timeouts   %d\tfast re-xmit\t%d\n",
+	   GET_STAT(iface, tcp.rto),
+	   GET_STAT(iface, tcp.fast_rexmit));
 	PR("TCP pkt drop   %d\n", GET_STAT(iface, tcp.drop));
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_BUF_LIMITS)
+	PR("Buf rcvbuf drop %d\trcvwnd zero\t%d\n",
+	   GET_STAT(iface, buf_limits.rcvbuf_drop),
+	   GET_STAT(iface, buf_limits.rcvwnd_zero));
+	PR("Buf sndbuf full %d\trx reserve drop\t%d\n",
+	   GET_STAT(iface, buf_limits.sndbuf_full),
+	   GET_STAT(iface, buf_limits.rx_reserve_drop));
+#endif
+
+#if defined(CONFIG_NET_STATISTICS_TX_QUEUE)
+	PR("TX queue delay avg %u us\tmax\t%u us\n",
+	   GET_STAT(iface, tx_queue.delay.count) ?
+	   (uint32_t)(GET_STAT(iface, tx_queue.delay.sum) /
+		      GET_STAT(iface, tx_queue.delay.count)) : 0,
+	   GET_STAT(iface, tx_queue.delay_max));
+	PR("TX queue codel drop %d\toverlimit drop\t%d\n",
+	   GET_STAT(iface, tx_queue.codel_drop),
+	   GET_STAT(iface, tx_queue.overlimit_drop));
+#endif
+
 	PR("Bytes received %u\n", GET_STAT(iface, bytes.received));
 	PR("Bytes sent     %u\n", GET_STAT(iface, bytes.sent));
 	PR("Processing err %d\n", GET_STAT(iface, processing_error));
@@ -1470,12 +1533,22 @@ static void tcp_cb(struct tcp *conn, void *user_data)
 	int *count = data->user_data;
 	uint16_t recv_mss = net_tcp_get_recv_mss(conn);
 
-	PR("%p %p   %5u    %5u %10u %10u %5u   %s\n",
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	PR("%p %p   %5u    %5u %10u %10u %5u %5u %5u %10u %10u   %s\n",
+	   conn, conn->context,
+	   ntohs(net_sin6_ptr(&conn->context->local)->sin6_port),
+	   ntohs(net_sin6(&conn->context->remote)->sin6_port),
+	   conn->seq, conn->ack, recv_mss, conn->srtt >> 3, conn->rto,
+	   conn->cc.cwnd, conn->cc.ssthresh,
+	   net_tcp_state_str(net_tcp_get_state(conn)));
+#else
+	PR("%p %p   %5u    %5u %10u %10u %5u %5u %5u   %s\n",
 	   conn, conn->context,
 	   ntohs(net_sin6_ptr(&conn->context->local)->sin6_port),
 	   ntohs(net_sin6(&conn->context->remote)->sin6_port),
-	   conn->seq, conn->ack, recv_mss,
+	   conn->seq, conn->ack, recv_mss, conn->srtt >> 3, conn->rto,
 	   net_tcp_state_str(net_tcp_get_state(conn)));
+#endif
 
 	(*count)++;
 }
@@ -1600,6 +1673,49 @@ static void ipv6_frag_cb(struct net_ipv6_reassembly *reass,
 }
 #endif /* CONFIG_NET_IPV6_FRAGMENT */
 
+#if defined(CONFIG_NET_IPV4_FRAGMENT)
+static void ipv4_frag_cb(struct net_ipv4_reassembly *reass,
+			 void *user_data)
+{
+	struct net_shell_user_data *data = user_data;
+	const struct shell *shell = data->shell;
+	int *count = data->user_data;
+	char src[ADDR_LEN];
+	int i;
+
+	if (!*count) {
+		PR("\nIPv4 reassembly Id     Remain Src             \tDst\n");
+	}
+
+	snprintk(src, ADDR_LEN, "%s", net_sprint_ipv4_addr(&reass->src));
+
+	PR("%p      0x%04x  %5d %16s\t%16s\n", reass, reass->id,
+	   k_ticks_to_ms_ceil32(k_work_delayable_remaining_get(&reass->timer)),
+	   src, net_sprint_ipv4_addr(&reass->dst));
+
+	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT; i++) {
+		if (reass->pkt[i]) {
+			struct net_buf *frag = reass->pkt[i]->frags;
+
+			PR("[%d] pkt %p->", i, reass->pkt[i]);
+
+			while (frag) {
+				PR("%p", frag);
+
+				frag = frag->frags;
+				if (frag) {
+					PR("->");
+				}
+			}
+
+			PR("\n");
+		}
+	}
+
+	(*count)++;
+}
+#endif /* CONFIG_NET_IPV4_FRAGMENT */
+
 #if defined(CONFIG_NET_DEBUG_NET_PKT_ALLOC)
 static void allocs_cb(struct net_pkt *pkt,
 		      struct net_buf *buf,
@@ -1695,13 +1811,13 @@ static void arp_cb(struct arp_entry *entry, void *user_data)
 	int *count = data->user_data;
 
 	if (*count == 0) {
-		PR("     Interface  Link              Address\n");
+		PR("     Interface  Link              Hits       Address\n");
 	}
 
-	PR("[%2d] %d          %s %s\n", *count,
+	PR("[%2d] %d          %s %-10u %s\n", *count,
 	   net_if_get_by_iface(entry->iface),
 	   net_sprint_ll_addr(entry->eth.addr, sizeof(struct net_eth_addr)),
-	   net_sprint_ipv4_addr(&entry->ip));
+	   entry->hits, net_sprint_ipv4_addr(&entry->ip));
 
 	(*count)++;
 }
@@ -1815,6 +1931,41 @@ static void capture_cb(struct net_capture_info *info, void *user_data)
 }
 #endif
 
+#if defined(CONFIG_NET_CAPTURE_RING)
+static void print_capture_ring(const struct shell *shell)
+{
+	struct net_capture_ring_stats stats;
+
+	net_capture_ring_stats(&stats);
+
+	PR_INFO("Capture ring %s\n", stats.is_enabled ? "enabled" : "disabled");
+	PR("Packets %u, %u of %u bytes used, snaplen %u\n", stats.count,
+	   stats.used, stats.size, stats.snaplen);
+	PR("Captured %u, filtered out %u, overwritten %u\n", stats.captured,
+	   stats.filtered, stats.overwritten);
+}
+
+static int capture_dump_cb(const void *data, size_t len, void *user_data)
+{
+	const struct shell *shell = user_data;
+	const uint8_t *ptr = data;
+	char line[2 * 32 + 1];
+	size_t count;
+
+	while (len > 0) {
+		count = MIN(len, 32);
+
+		bin2hex(ptr, count, line, sizeof(line));
+		PR("%s\n", line);
+
+		ptr += count;
+		len -= count;
+	}
+
+	return 0;
+}
+#endif
+
 static int cmd_net_capture(const struct shell *shell, size_t argc,
 			   char *argv[])
 {
@@ -1836,7 +1987,13 @@ static int cmd_net_capture(const struct shell *shell, size_t argc,
 
 		net_capture_foreach(capture_cb, &user_data);
 	}
-#else
+#endif
+
+#if defined(CONFIG_NET_CAPTURE_RING)
+	print_capture_ring(shell);
+#endif
+
+#if !defined(CONFIG_NET_CAPTURE) && !defined(CONFIG_NET_CAPTURE_RING)
 	ARG_UNUSED(argc);
 	ARG_UNUSED(argv);
 
@@ -1995,6 +2152,169 @@ static int cmd_net_capture_disable(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+static int cmd_net_capture_start(const struct shell *shell, size_t argc,
+				 char *argv[])
+{
+#if defined(CONFIG_NET_CAPTURE_RING)
+	struct net_if *iface = NULL;
+	int if_index, snaplen = 0;
+	int ret;
+
+	if (argc > 1) {
+		if_index = atoi(argv[1]);
+		if (if_index != 0) {
+			iface = net_if_get_by_index(if_index);
+			if (iface == NULL) {
+				PR_WARNING("No such interface with index %d\n",
+					   if_index);
+				return -ENOEXEC;
+			}
+		}
+	}
+
+	if (argc > 2) {
+		snaplen = atoi(argv[2]);
+		if (snaplen <= 0 || snaplen > UINT16_MAX) {
+			PR_WARNING("Invalid snaplen %s\n", argv[2]);
+			return -ENOEXEC;
+		}
+	}
+
+	ret = net_capture_ring_start(iface, snaplen);
+	if (ret < 0) {
+		PR_WARNING("Capture %s failed (%d)\n", "start", ret);
+		return -ENOEXEC;
+	}
+#else
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_RING", "network packet capture ring");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_capture_stop(const struct shell *shell, size_t argc,
+				char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_NET_CAPTURE_RING)
+	net_capture_ring_stop();
+#else
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_RING", "network packet capture ring");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_capture_clear(const struct shell *shell, size_t argc,
+				 char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_NET_CAPTURE_RING)
+	net_capture_ring_clear();
+#else
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_RING", "network packet capture ring");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_capture_filter(const struct shell *shell, size_t argc,
+				  char *argv[])
+{
+#if defined(CONFIG_NET_CAPTURE_RING)
+	char expr[128];
+	int i, len = 0;
+	int ret;
+
+	expr[0] = '\0';
+
+	/* The shell splits the filter to words, put it back together */
+	for (i = 1; i < argc; i++) {
+		len += snprintk(expr + len, sizeof(expr) - len, "%s%s",
+				i > 1 ? " " : "", argv[i]);
+		if (len >= sizeof(expr)) {
+			PR_WARNING("Filter too long\n");
+			return -ENOEXEC;
+		}
+	}
+
+	ret = net_capture_ring_filter(expr);
+	if (ret < 0) {
+		PR_WARNING("Invalid filter \"%s\" (%d)\n", expr, ret);
+		return -ENOEXEC;
+	}
+#else
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_RING", "network packet capture ring");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_capture_dump(const struct shell *shell, size_t argc,
+				char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_NET_CAPTURE_RING)
+	int ret;
+
+	ret = net_capture_ring_export(capture_dump_cb, (void *)shell);
+	if (ret < 0) {
+		PR_WARNING("Capture %s failed (%d)\n", "dump", ret);
+		return -ENOEXEC;
+	}
+#else
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_RING", "network packet capture ring");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_capture_save(const struct shell *shell, size_t argc,
+				char *argv[])
+{
+#if defined(CONFIG_NET_CAPTURE_RING)
+	int ret;
+
+	if (argc < 2) {
+		PR_WARNING("File name is missing.\n");
+		return -ENOEXEC;
+	}
+
+	ret = net_capture_ring_save(argv[1]);
+	if (ret < 0) {
+		PR_WARNING("Capture %s failed (%d)\n", "save", ret);
+		return -ENOEXEC;
+	}
+
+	PR("Saved %d packets to %s\n", ret, argv[1]);
+#else
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_RING", "network packet capture ring");
+#endif
+
+	return 0;
+}
+
 static int cmd_net_conn(const struct shell *shell, size_t argc, char *argv[])
 {
 	ARG_UNUSED(argc);
@@ -2028,8 +2348,14 @@ static int cmd_net_conn(const struct shell *shell, size_t argc, char *argv[])
 #endif
 
 #if defined(CONFIG_NET_TCP)
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	PR("\nTCP        Context   Src port Dst port   "
+	   "Send-Seq   Send-Ack  MSS  Srtt   RTO       Cwnd   Ssthresh    "
+	   "State\n");
+#else
 	PR("\nTCP        Context   Src port Dst port   "
-	   "Send-Seq   Send-Ack  MSS    State\n");
+	   "Send-Seq   Send-Ack  MSS  Srtt   RTO    State\n");
+#endif
 
 	count = 0;
 
@@ -2074,6 +2400,12 @@ static int cmd_net_conn(const struct shell *shell, size_t argc, char *argv[])
 	/* Do not print anything if no fragments are pending atm */
 #endif
 
+#if defined(CONFIG_NET_IPV4_FRAGMENT)
+	count = 0;
+
+	net_ipv4_frag_foreach(ipv4_frag_cb, &user_data);
+#endif
+
 #else
 	PR_INFO("Set %s to enable %s support.\n",
 		"CONFIG_NET_OFFLOAD or CONFIG_NET_NATIVE",
@@ -4419,17 +4751,25 @@ static int cmd_net_route(const struct shell *shell, size_t argc, char *argv[])
 	ARG_UNUSED(argv);
 
 #if defined(CONFIG_NET_NATIVE)
-#if defined(CONFIG_NET_ROUTE) || defined(CONFIG_NET_ROUTE_MCAST)
+#if defined(CONFIG_NET_ROUTE) || defined(CONFIG_NET_ROUTE_MCAST) || \
+	defined(CONFIG_NET_IPV4_ROUTE)
 	struct net_shell_user_data user_data;
 #endif
 
-#if defined(CONFIG_NET_ROUTE) || defined(CONFIG_NET_ROUTE_MCAST)
+#if defined(CONFIG_NET_ROUTE) || defined(CONFIG_NET_ROUTE_MCAST) || \
+	defined(CONFIG_NET_IPV4_ROUTE)
 	user_data.shell = shell;
 #endif
 
 #if defined(CONFIG_NET_ROUTE)
 	net_if_foreach(iface_per_route_cb, &user_data);
-#else
+#endif
+
+#if defined(CONFIG_NET_IPV4_ROUTE)
+	net_if_foreach(iface_per_route_ipv4_cb, &user_data);
+#endif
+
+#if !defined(CONFIG_NET_ROUTE) && !defined(CONFIG_NET_IPV4_ROUTE)
 	PR_INFO("Set %s to enable %s support.\n", "CONFIG_NET_ROUTE",
 		"network route");
 #endif
@@ -5682,6 +6022,28 @@ SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_capture,
 		  cmd_net_capture_enable),
 	SHELL_CMD(disable, NULL, "Disable network packet capture.",
 		  cmd_net_capture_disable),
+	SHELL_CMD(start, NULL, "Start network packet capture to memory.\n"
+		  "'net capture start [<interface index>] [<snaplen>]'\n"
+		  "All the interfaces are captured if the index is missing "
+		  "or 0.",
+		  cmd_net_capture_start),
+	SHELL_CMD(stop, NULL, "Stop network packet capture to memory.",
+		  cmd_net_capture_stop),
+	SHELL_CMD(clear, NULL, "Drop the packets captured to memory.",
+		  cmd_net_capture_clear),
+	SHELL_CMD(filter, NULL, "Set the filter of capture to memory.\n"
+		  "'net capture filter [<expression>]'\n"
+		  "like 'udp and dst port 53 or tcp and not host 192.0.2.1'.\n"
+		  "Without expression all the packets are captured.",
+		  cmd_net_capture_filter),
+	SHELL_CMD(dump, NULL, "Print the packets captured to memory as "
+		  "pcapng data in hex.\n"
+		  "Convert the output to a file with 'xxd -r -p'.",
+		  cmd_net_capture_dump),
+	SHELL_CMD(save, NULL, "Save the packets captured to memory to a "
+		  "pcapng file.\n"
+		  "'net capture save <file>'",
+		  cmd_net_capture_save),
 	SHELL_SUBCMD_SET_END
 );
 
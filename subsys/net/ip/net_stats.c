@@ -152,6 +152,29 @@ static inline void stats(struct net_if *iface)
 		NET_INFO("TCP conn drop  %d\tconnrst\t%d",
 			 GET_STAT(iface, tcp.conndrop),
 			 GET_STAT(iface, tcp.connrst));
+		NET_INFO("TCP timeouts   %d\tfast re-xmit\t%d",
+			 GET_STAT(iface, tcp.rto),
+			 GET_STAT(iface, tcp.fast_rexmit));
+#endif
+
+#if defined(CONFIG_NET_STATISTICS_BUF_LIMITS)
+		NET_INFO("Buf rcvbuf drop %d\trcvwnd zero\t%d",
+			 GET_STAT(iface, buf_limits.rcvbuf_drop),
+			 GET_STAT(iface, buf_limits.rcvwnd_zero));
+		NET_INFO("Buf sndbuf full %d\trx reserve drop\t%d",
+			 GET_STAT(iface, buf_limits.sndbuf_full),
+			 GET_STAT(iface, buf_limits.rx_reserve_drop));
+#endif
+
+#if defined(CONFIG_NET_STATISTICS_TX_QUEUE)
+		NET_INFO("TX queue delay avg %u us\tmax\t%u us",
+			 GET_STAT(iface, tx_queue.delay.count) ?
+			 (uint32_t)(GET_STAT(iface, tx_queue.delay.sum) /
+				    GET_STAT(iface, tx_queue.delay.count)) : 0,
+			 GET_STAT(iface, tx_queue.delay_max));
+		NET_INFO("TX queue codel drop %d\toverlimit drop\t%d",
+			 GET_STAT(iface, tx_queue.codel_drop),
+			 GET_STAT(iface, tx_queue.overlimit_drop));
 #endif
 
 		NET_INFO("Bytes received %u", GET_STAT(iface, bytes.received));
@@ -297,6 +320,18 @@ static int net_stats_get(uint32_t mgmt_request, struct net_if *iface,
 		src = GET_STAT_ADDR(iface, tcp);
 		break;
 #endif
+#if defined(CONFIG_NET_STATISTICS_BUF_LIMITS)
+	case NET_REQUEST_STATS_CMD_GET_BUF_LIMITS:
+		len_chk = sizeof(struct net_stats_buf_limits);
+		src = GET_STAT_ADDR(iface, buf_limits);
+		break;
+#endif
+#if defined(CONFIG_NET_STATISTICS_TX_QUEUE)
+	case NET_REQUEST_STATS_CMD_GET_TX_QUEUE:
+		len_chk = sizeof(struct net_stats_tx_queue);
+		src = GET_STAT_ADDR(iface, tx_queue);
+		break;
+#endif
 #if defined(CONFIG_NET_STATISTICS_POWER_MANAGEMENT)
 	case NET_REQUEST_STATS_GET_PM:
 		len_chk = sizeof(struct net_stats_pm);
@@ -356,6 +391,16 @@ NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_TCP,
 				  net_stats_get);
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_BUF_LIMITS)
+NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_BUF_LIMITS,
+				  net_stats_get);
+#endif
+
+#if defined(CONFIG_NET_STATISTICS_TX_QUEUE)
+NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_TX_QUEUE,
+				  net_stats_get);
+#endif
+
 #if defined(CONFIG_NET_STATISTICS_POWER_MANAGEMENT)
 NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PM,
 				  net_stats_get);
@@ -48,6 +48,11 @@ static inline void net_stats_update_ip_errors_vhlerr(struct net_if *iface)
 	UPDATE_STAT(iface, stats.ip_errors.vhlerr++);
 }
 
+static inline void net_stats_update_ip_errors_fragerr(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.ip_errors.fragerr++);
+}
+
 static inline void net_stats_update_bytes_recv(struct net_if *iface,
 					       uint32_t bytes)
 {
@@ -63,6 +68,7 @@ static inline void net_stats_update_bytes_sent(struct net_if *iface,
 #define net_stats_update_processing_error(iface)
 #define net_stats_update_ip_errors_protoerr(iface)
 #define net_stats_update_ip_errors_vhlerr(iface)
+#define net_stats_update_ip_errors_fragerr(iface)
 #define net_stats_update_bytes_recv(iface, bytes)
 #define net_stats_update_bytes_sent(iface, bytes)
 #endif /* CONFIG_NET_STATISTICS */
@@ -258,6 +264,16 @@ static inline void net_stats_update_tcp_seg_rexmit(struct net_if *iface)
 {
 	UPDATE_STAT(iface, stats.tcp.rexmit++);
 }
+
+static inline void net_stats_update_tcp_rto(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.tcp.rto++);
+}
+
+static inline void net_stats_update_tcp_fast_rexmit(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.tcp.fast_rexmit++);
+}
 #else
 #define net_stats_update_tcp_sent(iface, bytes)
 #define net_stats_update_tcp_resent(iface, bytes)
@@ -273,8 +289,73 @@ static inline void net_stats_update_tcp_seg_rexmit(struct net_if *iface)
 #define net_stats_update_tcp_seg_ackerr(iface)
 #define net_stats_update_tcp_seg_rsterr(iface)
 #define net_stats_update_tcp_seg_rexmit(iface)
+#define net_stats_update_tcp_rto(iface)
+#define net_stats_update_tcp_fast_rexmit(iface)
 #endif /* CONFIG_NET_STATISTICS_TCP */
 
+#if defined(CONFIG_NET_STATISTICS_BUF_LIMITS) && defined(CONFIG_NET_NATIVE)
+/* Buffer limit stats */
+static inline void net_stats_update_rcvbuf_drop(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.buf_limits.rcvbuf_drop++);
+}
+
+static inline void net_stats_update_rcvwnd_zero(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.buf_limits.rcvwnd_zero++);
+}
+
+static inline void net_stats_update_sndbuf_full(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.buf_limits.sndbuf_full++);
+}
+
+static inline void net_stats_update_rx_reserve_drop(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.buf_limits.rx_reserve_drop++);
+}
+#else
+#define net_stats_update_rcvbuf_drop(iface)
+#define net_stats_update_rcvwnd_zero(iface)
+#define net_stats_update_sndbuf_full(iface)
+#define net_stats_update_rx_reserve_drop(iface)
+#endif /* CONFIG_NET_STATISTICS_BUF_LIMITS */
+
+#if defined(CONFIG_NET_STATISTICS_TX_QUEUE) && defined(CONFIG_NET_NATIVE)
+/* TX queue stats */
+static inline void net_stats_update_tx_queue_delay(struct net_if *iface,
+						   uint32_t delay_us)
+{
+	UPDATE_STAT(iface, stats.tx_queue.delay.sum += delay_us);
+	UPDATE_STAT(iface, stats.tx_queue.delay.count += 1);
+
+	if (delay_us > net_stats.tx_queue.delay_max) {
+		net_stats.tx_queue.delay_max = delay_us;
+	}
+
+#if defined(CONFIG_NET_STATISTICS_PER_INTERFACE)
+	if (delay_us > iface->stats.tx_queue.delay_max) {
+		iface->stats.tx_queue.delay_max = delay_us;
+	}
+#endif
+}
+
+static inline void net_stats_update_tx_queue_codel_drop(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.tx_queue.codel_drop++);
+}
+
+static inline void net_stats_update_tx_queue_overlimit_drop(
+							struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.tx_queue.overlimit_drop++);
+}
+#else
+#define net_stats_update_tx_queue_delay(iface, delay_us)
+#define net_stats_update_tx_queue_codel_drop(iface)
+#define net_stats_update_tx_queue_overlimit_drop(iface)
+#endif /* CONFIG_NET_STATISTICS_TX_QUEUE */
+
 static inline void net_stats_update_per_proto_recv(struct net_if *iface,
 						   enum net_ip_protocol proto)
 {
@@ -9,14 +9,17 @@ LOG_MODULE_REGISTER(net_tc, CONFIG_NET_TC_LOG_LEVEL);
 
 #include <zephyr.h>
 #include <string.h>
+#include <sys/byteorder.h>
 
 #include <net/net_core.h>
 #include <net/net_pkt.h>
 #include <net/net_stats.h>
+#include <net/ethernet.h>
 
 #include "net_private.h"
 #include "net_stats.h"
 #include "net_tc_mapping.h"
+#include "ipv4.h"
 
 /* Template for thread name. The "xx" is either "TX" denoting transmit thread,
  * or "RX" denoting receive thread. The "q[y]" denotes the traffic class queue
@@ -47,12 +50,434 @@ static void submit_to_queue(struct k_fifo *queue, struct net_pkt *pkt)
 }
 #endif
 
+#if defined(CONFIG_NET_TC_TX_CODEL)
+/* FQ-CoDel (RFC 8290) in front of each TX thread. The packets are hashed
+ * to flow queues that take turns sending up to a quantum of bytes, the
+ * flows that just became active going before the old ones. Each flow queue
+ * runs CoDel (RFC 8289) on the time its packets waited. The TX queues are
+ * shared by all the interfaces, so the interface is part of the flow.
+ */
+#define CODEL_FLOWS CONFIG_NET_TC_TX_CODEL_FLOWS
+#define CODEL_QUANTUM CONFIG_NET_TC_TX_CODEL_QUANTUM
+#define CODEL_TARGET CONFIG_NET_TC_TX_CODEL_TARGET
+#define CODEL_INTERVAL CONFIG_NET_TC_TX_CODEL_INTERVAL
+
+/* The control law would not drop any faster past this */
+#define CODEL_MAX_COUNT 4095U
+
+struct codel_flow {
+	/* In the new or the old flows list while active */
+	sys_snode_t node;
+
+	/* Queued packets, linked through their burst node */
+	sys_slist_t pkts;
+	uint32_t bytes;
+	int32_t deficit;
+
+	/* CoDel state, times in microseconds */
+	uint32_t first_above_time;
+	uint32_t drop_next;
+	uint32_t count;
+	uint32_t lastcount;
+	bool dropping : 1;
+	bool active : 1;
+};
+
+struct codel_queue {
+	struct k_spinlock lock;
+
+	/* Given when packets are queued, the TX thread waits on it */
+	struct k_sem sem;
+
+	sys_slist_t new_flows;
+	sys_slist_t old_flows;
+	int pkts;
+
+	struct codel_flow flows[CODEL_FLOWS];
+};
+
+static struct codel_queue tx_queues[NET_TC_TX_COUNT];
+
+/* The uptime in microseconds, from the 64-bit tick count so that it wraps
+ * around only every 71 minutes whatever the cycle counter rate is. The
+ * intervals compared stay well below half of that.
+ */
+static inline uint32_t codel_now(void)
+{
+	return (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+static inline bool codel_time_after_eq(uint32_t a, uint32_t b)
+{
+	return (int32_t)(a - b) >= 0;
+}
+
+static uint32_t codel_isqrt(uint32_t val)
+{
+	uint32_t root = 0U;
+	uint32_t bit = 1U << 30;
+
+	while (bit > val) {
+		bit >>= 2;
+	}
+
+	while (bit) {
+		if (val >= root + bit) {
+			val -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+
+		bit >>= 2;
+	}
+
+	return root;
+}
+
+/* When to drop next: the interval shrinks with the square root of the
+ * number of drops since the dropping started.
+ */
+static uint32_t codel_control_law(uint32_t t, uint32_t count)
+{
+	uint32_t root = codel_isqrt(MIN(count, CODEL_MAX_COUNT) << 20);
+
+	return t + (uint32_t)(((uint64_t)CODEL_INTERVAL << 10) / root);
+}
+
+/* Hash the flow of a packet going out, packets without ports are hashed
+ * on their destination address only.
+ */
+static uint32_t codel_flow_hash(struct net_pkt *pkt)
+{
+	struct net_pkt_cursor backup;
+	uint16_t ports[2] = { 0U, 0U };
+	sa_family_t family = net_pkt_family(pkt);
+	const void *dst = NULL;
+	uint8_t proto = 0U;
+	uint32_t hash;
+
+	if (pkt->buffer == NULL) {
+		family = AF_UNSPEC;
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) && family == AF_INET &&
+		   pkt->buffer->len >= sizeof(struct net_ipv4_hdr)) {
+		struct net_ipv4_hdr *hdr = NET_IPV4_HDR(pkt);
+
+		dst = &hdr->dst;
+
+		if (!(sys_get_be16(hdr->offset) &
+		      ((NET_IPV4_MF << 13) | NET_IPV4_FRAGH_OFFSET_MASK))) {
+			proto = hdr->proto;
+		}
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) && family == AF_INET6 &&
+		   pkt->buffer->len >= sizeof(struct net_ipv6_hdr)) {
+		struct net_ipv6_hdr *hdr = NET_IPV6_HDR(pkt);
+
+		dst = &hdr->dst;
+
+		if (!net_pkt_ipv6_ext_len(pkt)) {
+			proto = hdr->nexthdr;
+		}
+	} else {
+		family = AF_UNSPEC;
+	}
+
+	if (proto == IPPROTO_TCP || proto == IPPROTO_UDP) {
+		net_pkt_cursor_backup(pkt, &backup);
+		net_pkt_cursor_init(pkt);
+
+		if (net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt)) ||
+		    net_pkt_read(pkt, ports, sizeof(ports))) {
+			ports[0] = ports[1] = 0U;
+		}
+
+		net_pkt_cursor_restore(pkt, &backup);
+	} else {
+		proto = 0U;
+	}
+
+	hash = net_conn_hash(proto, family, dst, ports[1], ports[0]);
+
+	/* Keep the interfaces apart */
+	return hash ^ ((uint32_t)net_if_get_by_iface(net_pkt_iface(pkt)) *
+		       2654435761U);
+}
+
+static struct net_pkt *codel_flow_pop(struct codel_queue *q,
+				      struct codel_flow *flow)
+{
+	sys_snode_t *node = sys_slist_get(&flow->pkts);
+	struct net_pkt *pkt;
+
+	if (node == NULL) {
+		return NULL;
+	}
+
+	pkt = CONTAINER_OF(node, struct net_pkt, burst);
+
+	flow->bytes -= net_pkt_get_len(pkt);
+	q->pkts--;
+
+	return pkt;
+}
+
+/* Take the head packet of a flow queue and tell whether it waited long
+ * enough to be dropped.
+ */
+static struct net_pkt *codel_dodequeue(struct codel_queue *q,
+				       struct codel_flow *flow, uint32_t now,
+				       bool *ok_to_drop)
+{
+	struct net_pkt *pkt = codel_flow_pop(q, flow);
+	uint32_t sojourn;
+
+	*ok_to_drop = false;
+
+	if (pkt == NULL) {
+		flow->first_above_time = 0U;
+		return NULL;
+	}
+
+	sojourn = now - pkt->tx_queue_time;
+
+	if (sojourn < CODEL_TARGET ||
+	    flow->bytes <= net_if_get_mtu(net_pkt_iface(pkt))) {
+		/* Went below the target, or too little queued to drop */
+		flow->first_above_time = 0U;
+	} else if (flow->first_above_time == 0U) {
+		/* Zero means not above, keep off it on wrap around */
+		flow->first_above_time = (now + CODEL_INTERVAL) | 1U;
+	} else if (codel_time_after_eq(now, flow->first_above_time)) {
+		*ok_to_drop = true;
+	}
+
+	return pkt;
+}
+
+/* CoDel dequeue of a flow queue, the dropped packets are added to drops
+ * to be freed without the lock held.
+ */
+static struct net_pkt *codel_flow_dequeue(struct codel_queue *q,
+					  struct codel_flow *flow,
+					  uint32_t now, sys_slist_t *drops)
+{
+	struct net_pkt *pkt;
+	bool ok_to_drop;
+	uint32_t delta;
+
+	pkt = codel_dodequeue(q, flow, now, &ok_to_drop);
+	if (pkt == NULL) {
+		flow->dropping = false;
+		return NULL;
+	}
+
+	if (flow->dropping) {
+		if (!ok_to_drop) {
+			flow->dropping = false;
+		}
+
+		while (flow->dropping &&
+		       codel_time_after_eq(now, flow->drop_next)) {
+			sys_slist_append(drops, &pkt->burst);
+			flow->count++;
+
+			pkt = codel_dodequeue(q, flow, now, &ok_to_drop);
+			if (pkt == NULL || !ok_to_drop) {
+				flow->dropping = false;
+			} else {
+				flow->drop_next =
+					codel_control_law(flow->drop_next,
+							  flow->count);
+			}
+		}
+	} else if (ok_to_drop) {
+		sys_slist_append(drops, &pkt->burst);
+
+		pkt = codel_dodequeue(q, flow, now, &ok_to_drop);
+		flow->dropping = true;
+
+		/* Start from the drop rate that was last needed if the
+		 * dropping stopped only a moment ago.
+		 */
+		delta = flow->count - flow->lastcount;
+		if (delta > 1U &&
+		    (int64_t)(int32_t)(now - flow->drop_next) <
+		    16 * (int64_t)CODEL_INTERVAL) {
+			flow->count = delta;
+		} else {
+			flow->count = 1U;
+		}
+
+		flow->lastcount = flow->count;
+		flow->drop_next = codel_control_law(now, flow->count);
+	}
+
+	return pkt;
+}
+
+static void codel_enqueue(struct codel_queue *q, struct net_pkt *pkt)
+{
+	struct net_pkt *drop = NULL;
+	struct codel_flow *flow;
+	k_spinlock_key_t key;
+	uint32_t idx = 0U;
+	int i;
+
+	if (CODEL_FLOWS > 1) {
+		idx = codel_flow_hash(pkt) % CODEL_FLOWS;
+	}
+
+	pkt->tx_queue_time = codel_now();
+
+	key = k_spin_lock(&q->lock);
+
+	flow = &q->flows[idx];
+
+	sys_slist_append(&flow->pkts, &pkt->burst);
+	flow->bytes += net_pkt_get_len(pkt);
+	q->pkts++;
+
+	if (!flow->active) {
+		flow->active = true;
+		flow->deficit = CODEL_QUANTUM;
+		sys_slist_append(&q->new_flows, &flow->node);
+	}
+
+	if (q->pkts > CONFIG_NET_TC_TX_CODEL_LIMIT) {
+		/* Make room at the expense of the longest flow queue */
+		for (i = 0; i < CODEL_FLOWS; i++) {
+			if (q->flows[i].bytes > flow->bytes) {
+				flow = &q->flows[i];
+			}
+		}
+
+		drop = codel_flow_pop(q, flow);
+	}
+
+	k_spin_unlock(&q->lock, key);
+
+	if (drop) {
+		net_stats_update_tx_queue_overlimit_drop(net_pkt_iface(drop));
+		net_process_tx_drop(drop, -ENOBUFS);
+	}
+
+	k_sem_give(&q->sem);
+}
+
+static struct net_pkt *codel_dequeue(struct codel_queue *q)
+{
+	struct net_pkt *pkt = NULL;
+	struct codel_flow *flow;
+	k_spinlock_key_t key;
+	sys_slist_t *list;
+	sys_slist_t drops;
+	sys_snode_t *node;
+	uint32_t now;
+
+	sys_slist_init(&drops);
+
+	key = k_spin_lock(&q->lock);
+
+	/* Not before the lock, a packet queued meanwhile would look old */
+	now = codel_now();
+
+	while (pkt == NULL) {
+		list = &q->new_flows;
+		node = sys_slist_peek_head(list);
+		if (node == NULL) {
+			list = &q->old_flows;
+			node = sys_slist_peek_head(list);
+			if (node == NULL) {
+				break;
+			}
+		}
+
+		flow = CONTAINER_OF(node, struct codel_flow, node);
+
+		if (flow->deficit <= 0) {
+			flow->deficit += CODEL_QUANTUM;
+			sys_slist_get(list);
+			sys_slist_append(&q->old_flows, node);
+			continue;
+		}
+
+		pkt = codel_flow_dequeue(q, flow, now, &drops);
+		if (pkt == NULL) {
+			/* A new flow that emptied goes through the old list
+			 * once, so that it cannot keep its priority by
+			 * sending one packet at a time.
+			 */
+			sys_slist_get(list);
+
+			if (list == &q->new_flows &&
+			    !sys_slist_is_empty(&q->old_flows)) {
+				sys_slist_append(&q->old_flows, node);
+			} else {
+				flow->active = false;
+			}
+
+			continue;
+		}
+
+		flow->deficit -= net_pkt_get_len(pkt);
+	}
+
+	k_spin_unlock(&q->lock, key);
+
+	while ((node = sys_slist_get(&drops)) != NULL) {
+		struct net_pkt *drop = CONTAINER_OF(node, struct net_pkt,
+						    burst);
+
+		net_stats_update_tx_queue_codel_drop(net_pkt_iface(drop));
+		net_process_tx_drop(drop, -ENOBUFS);
+	}
+
+	if (pkt) {
+		net_stats_update_tx_queue_delay(net_pkt_iface(pkt),
+						now - pkt->tx_queue_time);
+	}
+
+	return pkt;
+}
+
+static void codel_init(struct codel_queue *q)
+{
+	k_sem_init(&q->sem, 0, 1);
+	sys_slist_init(&q->new_flows);
+	sys_slist_init(&q->old_flows);
+}
+#endif /* CONFIG_NET_TC_TX_CODEL */
+
+#if NET_TC_TX_COUNT > 0
+static struct net_pkt *tx_queue_get(uint8_t tc, k_timeout_t timeout)
+{
+#if defined(CONFIG_NET_TC_TX_CODEL)
+	struct net_pkt *pkt;
+
+	while (1) {
+		pkt = codel_dequeue(&tx_queues[tc]);
+		if (pkt || K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			return pkt;
+		}
+
+		k_sem_take(&tx_queues[tc].sem, timeout);
+	}
+#else
+	return k_fifo_get(&tx_classes[tc].fifo, timeout);
+#endif
+}
+#endif
+
 bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt)
 {
 #if NET_TC_TX_COUNT > 0
 	net_pkt_set_tx_stats_tick(pkt, k_cycle_get_32());
 
+#if defined(CONFIG_NET_TC_TX_CODEL)
+	codel_enqueue(&tx_queues[tc], pkt);
+#else
 	submit_to_queue(&tx_classes[tc].fifo, pkt);
+#endif
 #else
 	ARG_UNUSED(tc);
 	ARG_UNUSED(pkt);
@@ -72,6 +497,25 @@ void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt)
 #endif
 }
 
+void net_tc_submit_list_to_rx_queue(uint8_t tc, sys_slist_t *list)
+{
+#if NET_TC_RX_COUNT > 0
+	struct net_pkt *pkt;
+
+	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
+		SYS_SLIST_FOR_EACH_CONTAINER(list, pkt, burst) {
+			net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
+		}
+	}
+
+	/* One wakeup of the RX thread for the whole burst */
+	k_fifo_put_slist(&rx_classes[tc].fifo, list);
+#else
+	ARG_UNUSED(tc);
+	ARG_UNUSED(list);
+#endif
+}
+
 int net_tx_priority2tc(enum net_priority prio)
 {
 #if NET_TC_TX_COUNT > 0
@@ -104,6 +548,116 @@ int net_rx_priority2tc(enum net_priority prio)
 #endif
 }
 
+#if defined(CONFIG_NET_TC_RX_RSS)
+/* Read the ethertype of a packet that has not been through L2 yet and
+ * leave the cursor at the start of the IP header, or return 0 if it is
+ * not known.
+ */
+static uint16_t rss_ethertype(struct net_if *iface, struct net_pkt *pkt)
+{
+	uint16_t type = 0U;
+
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET)) {
+		if (net_pkt_skip(pkt, 2 * sizeof(struct net_eth_addr)) ||
+		    net_pkt_read_be16(pkt, &type)) {
+			return 0U;
+		}
+
+		if (type == NET_ETH_PTYPE_VLAN &&
+		    (net_pkt_skip(pkt, sizeof(uint16_t)) ||
+		     net_pkt_read_be16(pkt, &type))) {
+			return 0U;
+		}
+	}
+#endif
+
+#if defined(CONFIG_NET_L2_DUMMY)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(DUMMY)) {
+		uint8_t vhl;
+
+		/* No link layer header, go by the IP version */
+		if (net_pkt_read_u8(pkt, &vhl)) {
+			return 0U;
+		}
+
+		type = (vhl & 0xf0) == 0x60 ? NET_ETH_PTYPE_IPV6 :
+			NET_ETH_PTYPE_IP;
+		net_pkt_cursor_init(pkt);
+	}
+#endif
+
+	return type;
+}
+
+/* Hash the flow of a received packet, packets without ports (fragments,
+ * ICMP, IPv6 extension headers) are hashed on their source address only.
+ */
+static uint32_t rss_hash(struct net_if *iface, struct net_pkt *pkt)
+{
+	union {
+		struct net_ipv4_hdr ipv4;
+		struct net_ipv6_hdr ipv6;
+	} hdr;
+	uint16_t ports[2] = { 0U, 0U };
+	sa_family_t family;
+	uint16_t type;
+	uint8_t proto;
+	void *src;
+
+	type = rss_ethertype(iface, pkt);
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && type == NET_ETH_PTYPE_IP) {
+		if (net_pkt_read(pkt, &hdr.ipv4, sizeof(hdr.ipv4))) {
+			return 0U;
+		}
+
+		family = AF_INET;
+		proto = hdr.ipv4.proto;
+		src = &hdr.ipv4.src;
+
+		if ((sys_get_be16(hdr.ipv4.offset) &
+		     ((NET_IPV4_MF << 13) | NET_IPV4_FRAGH_OFFSET_MASK)) ||
+		    net_pkt_skip(pkt, (hdr.ipv4.vhl & 0x0f) * 4U -
+				 sizeof(hdr.ipv4))) {
+			proto = 0U;
+		}
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) && type == NET_ETH_PTYPE_IPV6) {
+		if (net_pkt_read(pkt, &hdr.ipv6, sizeof(hdr.ipv6))) {
+			return 0U;
+		}
+
+		family = AF_INET6;
+		proto = hdr.ipv6.nexthdr;
+		src = &hdr.ipv6.src;
+	} else {
+		return 0U;
+	}
+
+	if (proto != IPPROTO_TCP && proto != IPPROTO_UDP) {
+		proto = 0U;
+	} else if (net_pkt_read(pkt, ports, sizeof(ports))) {
+		ports[0] = ports[1] = 0U;
+	}
+
+	return net_conn_hash(proto, family, src, ports[0], ports[1]);
+}
+
+int net_rx_flow2tc(struct net_if *iface, struct net_pkt *pkt)
+{
+	struct net_pkt_cursor backup;
+	uint32_t hash;
+
+	net_pkt_cursor_backup(pkt, &backup);
+	net_pkt_cursor_init(pkt);
+
+	hash = rss_hash(iface, pkt);
+
+	net_pkt_cursor_restore(pkt, &backup);
+
+	return hash % NET_TC_RX_COUNT;
+}
+#endif /* CONFIG_NET_TC_RX_RSS */
 
 #if IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE)
 #define BASE_PRIO_TX (CONFIG_NET_TC_NUM_PRIORITIES - 1)
@@ -239,6 +793,8 @@ static void net_tc_rx_stats_priority_setup(struct net_if *iface,
 #if NET_TC_RX_COUNT > 0
 static void tc_rx_handler(struct k_fifo *fifo)
 {
+	uint8_t tc = CONTAINER_OF(fifo, struct net_traffic_class, fifo) -
+		     rx_classes;
 	struct net_pkt *pkt;
 
 	while (1) {
@@ -247,7 +803,12 @@ static void tc_rx_handler(struct k_fifo *fifo)
 			continue;
 		}
 
-		net_process_rx_packet(pkt);
+		net_process_rx_packet(pkt, tc);
+
+		/* Nothing else to coalesce the held back segments with */
+		if (IS_ENABLED(CONFIG_NET_TCP_GRO) && k_fifo_is_empty(fifo)) {
+			net_process_rx_flush(tc);
+		}
 	}
 }
 #endif
@@ -255,15 +816,46 @@ static void tc_rx_handler(struct k_fifo *fifo)
 #if NET_TC_TX_COUNT > 0
 static void tc_tx_handler(struct k_fifo *fifo)
 {
-	struct net_pkt *pkt;
+	uint8_t tc = CONTAINER_OF(fifo, struct net_traffic_class, fifo) -
+		     tx_classes;
+	struct net_pkt *pkt, *next;
+	struct net_if *iface;
+	bool more, held;
+	int count;
 
 	while (1) {
-		pkt = k_fifo_get(fifo, K_FOREVER);
+		pkt = tx_queue_get(tc, K_FOREVER);
 		if (pkt == NULL) {
 			continue;
 		}
 
-		net_process_tx_packet(pkt);
+		/* Look one packet ahead so that the driver knows whether it
+		 * can wait for more before flushing what it was given.
+		 */
+		for (count = 1, held = false; pkt != NULL; count++) {
+			next = NULL;
+
+			if (count < CONFIG_NET_TC_TX_BATCH) {
+				next = tx_queue_get(tc, K_NO_WAIT);
+			}
+
+			iface = net_pkt_iface(pkt);
+			more = next != NULL && net_pkt_iface(next) == iface;
+
+			net_pkt_set_tx_more(pkt, more);
+			net_process_tx_packet(pkt);
+
+			/* The last packet of the run may have been dropped
+			 * before reaching the driver, which then still holds
+			 * the previous ones.
+			 */
+			if (held && !more) {
+				net_process_tx_flush(iface);
+			}
+
+			held = more;
+			pkt = next;
+		}
 	}
 }
 #endif
@@ -307,6 +899,10 @@ void net_tc_tx_init(void)
 
 		k_fifo_init(&tx_classes[i].fifo);
 
+#if defined(CONFIG_NET_TC_TX_CODEL)
+		codel_init(&tx_queues[i]);
+#endif
+
 		tid = k_thread_create(&tx_classes[i].handler, tx_stack[i],
 				      K_KERNEL_STACK_SIZEOF(tx_stack[i]),
 				      (k_thread_entry_t)tc_tx_handler,
@@ -348,7 +944,9 @@ void net_tc_rx_init(void)
 		int priority;
 		k_tid_t tid;
 
-		thread_priority = rx_tc2thread(i);
+		/* The flows are spread evenly so no queue goes first */
+		thread_priority = rx_tc2thread(
+			IS_ENABLED(CONFIG_NET_TC_RX_RSS) ? 0 : i);
 
 		priority = IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE) ?
 			K_PRIO_COOP(thread_priority) :
@@ -382,6 +980,11 @@ void net_tc_rx_init(void)
 			k_thread_name_set(tid, name);
 		}
 
+#if defined(CONFIG_NET_TC_RX_RSS) && defined(CONFIG_SCHED_CPU_MASK)
+		k_thread_cpu_mask_clear(tid);
+		k_thread_cpu_mask_enable(tid, i % CONFIG_MP_NUM_CPUS);
+#endif
+
 		k_thread_start(tid);
 	}
 #endif
@@ -28,6 +28,7 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 #include "icmpv6.h"
 #include "nbr.h"
 #include "route.h"
+#include "route_trie.h"
 
 #if !defined(NET_ROUTE_EXTRA_DATA_SIZE)
 #define NET_ROUTE_EXTRA_DATA_SIZE 0
@@ -36,7 +37,12 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 /* We keep track of the routes in a separate list so that we can remove
  * the oldest routes (at tail) if needed.
  */
-static sys_slist_t routes;
+static sys_dlist_t routes = SYS_DLIST_STATIC_INIT(&routes);
+
+#if defined(CONFIG_NET_ROUTE_TRIE)
+NET_ROUTE_TRIE_DEFINE(route_trie, 128,
+		      NET_ROUTE_TRIE_NODES(CONFIG_NET_MAX_ROUTES));
+#endif
 
 static void net_route_nexthop_remove(struct net_nbr *nbr)
 {
@@ -253,14 +259,35 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
-	sys_slist_find_and_remove(&routes, &route->node);
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_remove(&route->node);
+	sys_dlist_prepend(&routes, &route->node);
 }
 
+#if defined(CONFIG_NET_ROUTE_TRIE)
+static bool route_iface_match(sys_snode_t *entry, void *user_data)
+{
+	struct net_route_entry *route = CONTAINER_OF(entry,
+						     struct net_route_entry,
+						     trie_node);
+
+	return route->iface == user_data;
+}
+#endif
+
 struct net_route_entry *net_route_lookup(struct net_if *iface,
 					 struct in6_addr *dst)
 {
-	struct net_route_entry *route, *found = NULL;
+	struct net_route_entry *found = NULL;
+#if defined(CONFIG_NET_ROUTE_TRIE)
+	sys_snode_t *entry;
+
+	entry = net_route_trie_lookup(&route_trie, dst->s6_addr,
+				      iface ? route_iface_match : NULL, iface);
+	if (entry) {
+		found = CONTAINER_OF(entry, struct net_route_entry, trie_node);
+	}
+#else
+	struct net_route_entry *route;
 	uint8_t longest_match = 0U;
 	int i;
 
@@ -285,6 +312,7 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 			longest_match = route->prefix_len;
 		}
 	}
+#endif /* CONFIG_NET_ROUTE_TRIE */
 
 	if (found) {
 		net_route_info("Found", found, dst);
@@ -295,6 +323,38 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 	return found;
 }
 
+/* Route to exactly the given prefix, unlike net_route_lookup() */
+static struct net_route_entry *route_find(struct net_if *iface,
+					  struct in6_addr *addr,
+					  uint8_t prefix_len)
+{
+#if defined(CONFIG_NET_ROUTE_TRIE)
+	sys_snode_t *entry;
+
+	entry = net_route_trie_find(&route_trie, addr->s6_addr, prefix_len,
+				    route_iface_match, iface);
+	if (entry) {
+		return CONTAINER_OF(entry, struct net_route_entry, trie_node);
+	}
+#else
+	int i;
+
+	for (i = 0; i < CONFIG_NET_MAX_ROUTES; i++) {
+		struct net_nbr *nbr = get_nbr(i);
+		struct net_route_entry *route = net_route_data(nbr);
+
+		if (nbr->ref && nbr->iface == iface &&
+		    route->prefix_len == prefix_len &&
+		    net_ipv6_is_prefix(addr->s6_addr, route->addr.s6_addr,
+				       prefix_len)) {
+			return route;
+		}
+	}
+#endif
+
+	return NULL;
+}
+
 struct net_route_entry *net_route_add(struct net_if *iface,
 				      struct in6_addr *addr,
 				      uint8_t prefix_len,
@@ -333,7 +393,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 		log_strdup(net_sprint_ll_addr(nexthop_lladdr->addr,
 					      nexthop_lladdr->len)));
 
-	route = net_route_lookup(iface, addr);
+	route = route_find(iface, addr, prefix_len);
 	if (route) {
 		/* Update nexthop if not the same */
 		struct in6_addr *nexthop_addr;
@@ -353,9 +413,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	nbr = nbr_new(iface, addr, prefix_len);
 	if (!nbr) {
 		/* Remove the oldest route and try again */
-		sys_snode_t *last = sys_slist_peek_tail(&routes);
-
-		sys_slist_find_and_remove(&routes, last);
+		sys_dnode_t *last = sys_dlist_peek_tail(&routes);
 
 		route = CONTAINER_OF(last,
 				     struct net_route_entry,
@@ -401,7 +459,17 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	route = net_route_data(nbr);
 	route->iface = iface;
 
-	sys_slist_prepend(&routes, &route->node);
+#if defined(CONFIG_NET_ROUTE_TRIE)
+	if (net_route_trie_add(&route_trie, route->addr.s6_addr, prefix_len,
+			       &route->trie_node) < 0) {
+		NET_ERR("No route trie node available!");
+		nbr_free(tmp);
+		nbr_free(nbr);
+		return NULL;
+	}
+#endif
+
+	sys_dlist_prepend(&routes, &route->node);
 
 	tmp = nbr_nexthop_get(iface, nexthop);
 
@@ -432,7 +500,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 int net_route_del(struct net_route_entry *route)
 {
 	struct net_nbr *nbr;
-	struct net_route_nexthop *nexthop_route;
+	struct net_route_nexthop *nexthop_route, *tmp;
 #if defined(CONFIG_NET_MGMT_EVENT_INFO)
        struct net_event_ipv6_route info;
 #endif
@@ -454,21 +522,34 @@ int net_route_del(struct net_route_entry *route)
 	net_mgmt_event_notify(NET_EVENT_IPV6_ROUTE_DEL, route->iface);
 #endif
 
-	sys_slist_find_and_remove(&routes, &route->node);
+	if (sys_dnode_is_linked(&route->node)) {
+		sys_dlist_remove(&route->node);
+	}
 
 	nbr = net_route_get_nbr(route);
 	if (!nbr) {
 		return -ENOENT;
 	}
 
+#if defined(CONFIG_NET_ROUTE_TRIE)
+	(void)net_route_trie_del(&route_trie, route->addr.s6_addr,
+				 route->prefix_len, &route->trie_node);
+#endif
+
 	net_route_info("Deleted", route, &route->addr);
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&route->nexthop, nexthop_route, node) {
+	/* The nexthop entries are freed while walking their list */
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&route->nexthop, nexthop_route, tmp,
+					  node) {
 		if (!nexthop_route->nbr) {
 			continue;
 		}
 
 		nbr_nexthop_put(nexthop_route->nbr);
+
+		/* Give the nexthop entry back to its pool */
+		nbr_free(CONTAINER_OF((uint8_t *)nexthop_route,
+				      struct net_nbr, __nbr));
 	}
 
 	nbr_free(nbr);
@@ -910,6 +991,13 @@ int net_route_packet_if(struct net_pkt *pkt, struct net_if *iface)
 
 void net_route_init(void)
 {
+#if defined(CONFIG_NET_ROUTE_TRIE)
+	net_route_trie_init(&route_trie);
+
+	NET_DBG("Allocated %d route trie nodes (%zu bytes)",
+		route_trie.node_count, sizeof(route_trie_nodes));
+#endif
+
 	NET_DBG("Allocated %d routing entries (%zu bytes)",
 		CONFIG_NET_MAX_ROUTES, sizeof(net_route_entries_pool));
 
@@ -0,0 +1,189 @@
+/** @file
+ * @brief IPv4 route handling.
+ *
+ */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_route_ipv4, CONFIG_NET_ROUTE_LOG_LEVEL);
+
+#include <kernel.h>
+#include <errno.h>
+#include <zephyr/types.h>
+#include <sys/slist.h>
+
+#include <net/net_core.h>
+#include <net/net_mgmt.h>
+#include <net/net_ip.h>
+#include <net/net_if.h>
+
+#include "net_private.h"
+#include "route.h"
+#include "route_trie.h"
+
+/*
+ * This array contains IPv4 routing table entries.
+ */
+static
+struct net_route_entry_ipv4 route_ipv4_entries[CONFIG_NET_IPV4_MAX_ROUTES];
+
+NET_ROUTE_TRIE_DEFINE(route_ipv4_trie, 32,
+		      NET_ROUTE_TRIE_NODES(CONFIG_NET_IPV4_MAX_ROUTES));
+
+static bool route_iface_match(sys_snode_t *entry, void *user_data)
+{
+	struct net_route_entry_ipv4 *route =
+		CONTAINER_OF(entry, struct net_route_entry_ipv4, node);
+
+	return user_data == NULL || route->iface == user_data;
+}
+
+static void route_ipv4_notify(struct net_route_entry_ipv4 *route,
+			      uint32_t event)
+{
+#if defined(CONFIG_NET_MGMT_EVENT_INFO)
+	struct net_event_ipv4_route info;
+
+	net_ipaddr_copy(&info.addr, &route->addr);
+	net_ipaddr_copy(&info.gw, &route->gw);
+	info.prefix_len = route->prefix_len;
+
+	net_mgmt_event_notify_with_info(event, route->iface, (void *)&info,
+					sizeof(struct net_event_ipv4_route));
+#else
+	net_mgmt_event_notify(event, route->iface);
+#endif
+}
+
+struct net_route_entry_ipv4 *net_route_ipv4_lookup(struct net_if *iface,
+						   const struct in_addr *dst)
+{
+	sys_snode_t *entry;
+
+	entry = net_route_trie_lookup(&route_ipv4_trie, dst->s4_addr,
+				      route_iface_match, iface);
+	if (!entry) {
+		return NULL;
+	}
+
+	return CONTAINER_OF(entry, struct net_route_entry_ipv4, node);
+}
+
+struct net_route_entry_ipv4 *net_route_ipv4_add(struct net_if *iface,
+						const struct in_addr *addr,
+						uint8_t prefix_len,
+						const struct in_addr *gw)
+{
+	struct net_route_entry_ipv4 *route = NULL;
+	sys_snode_t *entry;
+	int i;
+
+	NET_ASSERT(iface);
+	NET_ASSERT(addr);
+
+	if (prefix_len > 32) {
+		NET_DBG("Invalid prefix length %d", prefix_len);
+		return NULL;
+	}
+
+	entry = net_route_trie_find(&route_ipv4_trie, addr->s4_addr,
+				    prefix_len, route_iface_match, iface);
+	if (entry) {
+		route = CONTAINER_OF(entry, struct net_route_entry_ipv4, node);
+
+		NET_DBG("Old route to %s/%d found",
+			log_strdup(net_sprint_ipv4_addr(&route->addr)),
+			prefix_len);
+	} else {
+		for (i = 0; i < CONFIG_NET_IPV4_MAX_ROUTES; i++) {
+			if (!route_ipv4_entries[i].is_used) {
+				route = &route_ipv4_entries[i];
+				break;
+			}
+		}
+
+		if (!route) {
+			NET_DBG("No free IPv4 route entry");
+			return NULL;
+		}
+
+		if (net_route_trie_add(&route_ipv4_trie, addr->s4_addr,
+				       prefix_len, &route->node) < 0) {
+			NET_ERR("No route trie node available!");
+			return NULL;
+		}
+
+		route->addr.s_addr = addr->s_addr &
+			(prefix_len ? htonl(UINT32_MAX << (32 - prefix_len)) : 0);
+		route->prefix_len = prefix_len;
+		route->iface = iface;
+		route->is_used = true;
+	}
+
+	if (gw) {
+		net_ipaddr_copy(&route->gw, gw);
+	} else {
+		route->gw.s_addr = INADDR_ANY;
+	}
+
+	NET_DBG("Added route to %s/%d via %s (iface %p)",
+		log_strdup(net_sprint_ipv4_addr(&route->addr)), prefix_len,
+		log_strdup(net_sprint_ipv4_addr(&route->gw)), iface);
+
+	route_ipv4_notify(route, NET_EVENT_IPV4_ROUTE_ADD);
+
+	return route;
+}
+
+int net_route_ipv4_del(struct net_route_entry_ipv4 *route)
+{
+	if (!route || !route->is_used) {
+		return -EINVAL;
+	}
+
+	if (net_route_trie_del(&route_ipv4_trie, route->addr.s4_addr,
+			       route->prefix_len, &route->node) < 0) {
+		return -ENOENT;
+	}
+
+	route->is_used = false;
+
+	NET_DBG("Deleted route to %s/%d (iface %p)",
+		log_strdup(net_sprint_ipv4_addr(&route->addr)),
+		route->prefix_len, route->iface);
+
+	route_ipv4_notify(route, NET_EVENT_IPV4_ROUTE_DEL);
+
+	return 0;
+}
+
+int net_route_ipv4_foreach(net_route_ipv4_cb_t cb, void *user_data)
+{
+	int i, ret = 0;
+
+	for (i = 0; i < CONFIG_NET_IPV4_MAX_ROUTES; i++) {
+		if (!route_ipv4_entries[i].is_used) {
+			continue;
+		}
+
+		cb(&route_ipv4_entries[i], user_data);
+
+		ret++;
+	}
+
+	return ret;
+}
+
+void net_route_ipv4_init(void)
+{
+	net_route_trie_init(&route_ipv4_trie);
+
+	NET_DBG("Allocated %d IPv4 routing entries (%zu bytes)",
+		CONFIG_NET_IPV4_MAX_ROUTES,
+		sizeof(route_ipv4_entries) + sizeof(route_ipv4_trie_nodes));
+}
@@ -0,0 +1,262 @@
+/** @file
+ * @brief Prefix trie for the routing tables.
+ *
+ * The routes are kept in a path compressed binary trie: every node holds
+ * a prefix, and its children hold longer prefixes that differ from each
+ * other in the bit that follows it. Nodes with only one child are not
+ * kept unless they hold routes, so a trie of N prefixes needs less than
+ * 2 * N nodes, and a lookup visits at most one node per address bit.
+ */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/math_extras.h>
+
+#include "route_trie.h"
+
+static inline uint8_t addr_bit(const uint8_t *addr, uint8_t bit)
+{
+	return (addr[bit / 8] >> (7 - bit % 8)) & 1;
+}
+
+/* Number of leading bits, at most len, which are the same in a and b */
+static uint8_t common_len(const uint8_t *a, const uint8_t *b, uint8_t len)
+{
+	uint8_t diff;
+	int i;
+
+	for (i = 0; i < len; i += 8) {
+		diff = a[i / 8] ^ b[i / 8];
+		if (diff) {
+			return MIN(i + u32_count_leading_zeros(diff) - 24, len);
+		}
+	}
+
+	return len;
+}
+
+static inline bool node_matches(struct net_route_trie_node *node,
+				const uint8_t *addr)
+{
+	return common_len(node->prefix, addr, node->prefix_len) ==
+		node->prefix_len;
+}
+
+static struct net_route_trie_node *node_alloc(struct net_route_trie *trie,
+					      const uint8_t *prefix,
+					      uint8_t prefix_len)
+{
+	struct net_route_trie_node *node = trie->free;
+	uint8_t len = (prefix_len + 7) / 8;
+
+	if (!node) {
+		return NULL;
+	}
+
+	trie->free = node->child[0];
+	trie->free_count--;
+
+	node->child[0] = NULL;
+	node->child[1] = NULL;
+	sys_slist_init(&node->entries);
+
+	memcpy(node->prefix, prefix, len);
+	(void)memset(node->prefix + len, 0, sizeof(node->prefix) - len);
+
+	if (prefix_len % 8) {
+		node->prefix[len - 1] &= 0xff << (8 - prefix_len % 8);
+	}
+
+	node->prefix_len = prefix_len;
+
+	return node;
+}
+
+static void node_free(struct net_route_trie *trie,
+		      struct net_route_trie_node *node)
+{
+	node->child[0] = trie->free;
+	trie->free = node;
+	trie->free_count++;
+}
+
+/* Remove the node linked from *link if it is not needed anymore */
+static void node_collapse(struct net_route_trie *trie,
+			  struct net_route_trie_node **link)
+{
+	struct net_route_trie_node *node = *link;
+
+	if (!sys_slist_is_empty(&node->entries) ||
+	    (node->child[0] && node->child[1])) {
+		return;
+	}
+
+	*link = node->child[0] ? node->child[0] : node->child[1];
+
+	node_free(trie, node);
+}
+
+static sys_snode_t *node_entry(struct net_route_trie_node *node,
+			       net_route_trie_match_t cb, void *user_data)
+{
+	sys_snode_t *entry;
+
+	SYS_SLIST_FOR_EACH_NODE(&node->entries, entry) {
+		if (!cb || cb(entry, user_data)) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+void net_route_trie_init(struct net_route_trie *trie)
+{
+	int i;
+
+	trie->root = NULL;
+	trie->free = NULL;
+
+	for (i = 0; i < trie->node_count; i++) {
+		trie->nodes[i].child[0] = trie->free;
+		trie->free = &trie->nodes[i];
+	}
+
+	trie->free_count = trie->node_count;
+}
+
+int net_route_trie_add(struct net_route_trie *trie, const uint8_t *prefix,
+		       uint8_t prefix_len, sys_snode_t *entry)
+{
+	struct net_route_trie_node **link = &trie->root;
+	struct net_route_trie_node *node, *leaf, *branch;
+	uint8_t len = 0U;
+
+	if (prefix_len > trie->addr_len) {
+		return -EINVAL;
+	}
+
+	while ((node = *link) != NULL) {
+		len = common_len(node->prefix, prefix,
+				 MIN(node->prefix_len, prefix_len));
+		if (len < node->prefix_len) {
+			break;
+		}
+
+		if (len == prefix_len) {
+			sys_slist_append(&node->entries, entry);
+			return 0;
+		}
+
+		link = &node->child[addr_bit(prefix, len)];
+	}
+
+	if (!node) {
+		leaf = node_alloc(trie, prefix, prefix_len);
+		if (!leaf) {
+			return -ENOMEM;
+		}
+	} else if (len == prefix_len) {
+		/* The new prefix is the start of the one in node */
+		leaf = node_alloc(trie, prefix, prefix_len);
+		if (!leaf) {
+			return -ENOMEM;
+		}
+
+		leaf->child[addr_bit(node->prefix, len)] = node;
+	} else {
+		/* The prefixes differ after len bits, branch there */
+		if (trie->free_count < 2) {
+			return -ENOMEM;
+		}
+
+		branch = node_alloc(trie, prefix, len);
+		leaf = node_alloc(trie, prefix, prefix_len);
+
+		branch->child[addr_bit(node->prefix, len)] = node;
+
+		*link = branch;
+		link = &branch->child[addr_bit(prefix, len)];
+	}
+
+	*link = leaf;
+	sys_slist_append(&leaf->entries, entry);
+
+	return 0;
+}
+
+int net_route_trie_del(struct net_route_trie *trie, const uint8_t *prefix,
+		       uint8_t prefix_len, sys_snode_t *entry)
+{
+	struct net_route_trie_node **link = &trie->root;
+	struct net_route_trie_node **parent = NULL;
+	struct net_route_trie_node *node;
+
+	while ((node = *link) != NULL && node->prefix_len < prefix_len) {
+		parent = link;
+		link = &node->child[addr_bit(prefix, node->prefix_len)];
+	}
+
+	if (!node || node->prefix_len != prefix_len ||
+	    !node_matches(node, prefix) ||
+	    !sys_slist_find_and_remove(&node->entries, entry)) {
+		return -ENOENT;
+	}
+
+	node_collapse(trie, link);
+
+	/* The parent may now be a branch with a single child */
+	if (parent) {
+		node_collapse(trie, parent);
+	}
+
+	return 0;
+}
+
+sys_snode_t *net_route_trie_lookup(struct net_route_trie *trie,
+				   const uint8_t *addr,
+				   net_route_trie_match_t cb, void *user_data)
+{
+	struct net_route_trie_node *node = trie->root;
+	sys_snode_t *found = NULL, *entry;
+
+	while (node && node_matches(node, addr)) {
+		entry = node_entry(node, cb, user_data);
+		if (entry) {
+			found = entry;
+		}
+
+		if (node->prefix_len == trie->addr_len) {
+			break;
+		}
+
+		node = node->child[addr_bit(addr, node->prefix_len)];
+	}
+
+	return found;
+}
+
+sys_snode_t *net_route_trie_find(struct net_route_trie *trie,
+				 const uint8_t *prefix, uint8_t prefix_len,
+				 net_route_trie_match_t cb, void *user_data)
+{
+	struct net_route_trie_node *node = trie->root;
+
+	while (node && node->prefix_len < prefix_len) {
+		node = node->child[addr_bit(prefix, node->prefix_len)];
+	}
+
+	if (!node || node->prefix_len != prefix_len ||
+	    !node_matches(node, prefix)) {
+		return NULL;
+	}
+
+	return node_entry(node, cb, user_data);
+}
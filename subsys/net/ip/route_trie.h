@@ -0,0 +1,166 @@
+/** @file
+ * @brief Prefix trie for the routing tables
+ *
+ * This is not to be included by the application.
+ */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __ROUTE_TRIE_H
+#define __ROUTE_TRIE_H
+
+#include <kernel.h>
+#include <sys/slist.h>
+
+#include <net/net_ip.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Node of a path compressed binary trie. A node either holds the
+ * routes to its prefix, or only branches to two longer prefixes.
+ */
+struct net_route_trie_node {
+	/** Longer prefixes, indexed by the bit that follows this prefix */
+	struct net_route_trie_node *child[2];
+
+	/** Routes to this prefix */
+	sys_slist_t entries;
+
+	/** Prefix, the bits after prefix_len are zero */
+	uint8_t prefix[sizeof(struct in6_addr)];
+
+	/** Prefix length in bits */
+	uint8_t prefix_len;
+};
+
+/**
+ * @brief Routes of one address family, by prefix.
+ */
+struct net_route_trie {
+	/** Shortest prefix, NULL if there are no routes */
+	struct net_route_trie_node *root;
+
+	/** Unused nodes, linked through child[0] */
+	struct net_route_trie_node *free;
+
+	/** All the nodes */
+	struct net_route_trie_node *nodes;
+
+	/** Number of nodes */
+	uint16_t node_count;
+
+	/** Number of unused nodes */
+	uint16_t free_count;
+
+	/** Address length in bits */
+	uint8_t addr_len;
+};
+
+/** Number of nodes needed to hold the given number of routes */
+#define NET_ROUTE_TRIE_NODES(routes) (2 * (routes))
+
+/**
+ * @brief Statically define a prefix trie.
+ *
+ * @param _name Name of the trie.
+ * @param _addr_len Address length in bits, 32 or 128.
+ * @param _node_count Number of nodes, see NET_ROUTE_TRIE_NODES().
+ */
+#define NET_ROUTE_TRIE_DEFINE(_name, _addr_len, _node_count)		\
+	static struct net_route_trie_node _name##_nodes[_node_count];	\
+	static struct net_route_trie _name = {				\
+		.nodes = _name##_nodes,					\
+		.node_count = _node_count,				\
+		.addr_len = _addr_len,					\
+	}
+
+/**
+ * @brief Callback telling if a route matches the lookup.
+ *
+ * @param entry Route, as added to the trie.
+ * @param user_data User specified data.
+ *
+ * @return True if the route can be returned.
+ */
+typedef bool (*net_route_trie_match_t)(sys_snode_t *entry, void *user_data);
+
+/**
+ * @brief Empty the trie.
+ *
+ * @param trie Prefix trie.
+ */
+void net_route_trie_init(struct net_route_trie *trie);
+
+/**
+ * @brief Add a route to a prefix.
+ *
+ * @param trie Prefix trie.
+ * @param prefix Address of the route, only its first prefix_len bits are
+ * looked at.
+ * @param prefix_len Prefix length in bits.
+ * @param entry Route, linked in the trie until it is deleted.
+ *
+ * @return 0 if ok, -EINVAL if the prefix is too long, -ENOMEM if there are
+ * no free nodes.
+ */
+int net_route_trie_add(struct net_route_trie *trie, const uint8_t *prefix,
+		       uint8_t prefix_len, sys_snode_t *entry);
+
+/**
+ * @brief Delete a route added with net_route_trie_add().
+ *
+ * @param trie Prefix trie.
+ * @param prefix Address of the route.
+ * @param prefix_len Prefix length in bits.
+ * @param entry Route.
+ *
+ * @return 0 if ok, -ENOENT if the route is not in the trie.
+ */
+int net_route_trie_del(struct net_route_trie *trie, const uint8_t *prefix,
+		       uint8_t prefix_len, sys_snode_t *entry);
+
+/**
+ * @brief Find the longest prefix matching an address.
+ *
+ * @details Of the prefixes that the address starts with, the longest one
+ * holding a route accepted by the callback is taken, and the first such
+ * route of it is returned.
+ *
+ * @param trie Prefix trie.
+ * @param addr Destination address.
+ * @param cb Callback matching the routes, NULL to accept any route.
+ * @param user_data User specified data.
+ *
+ * @return Route, NULL if no route matches.
+ */
+sys_snode_t *net_route_trie_lookup(struct net_route_trie *trie,
+				   const uint8_t *addr,
+				   net_route_trie_match_t cb, void *user_data);
+
+/**
+ * @brief Find a route to exactly the given prefix.
+ *
+ * @param trie Prefix trie.
+ * @param prefix Address of the route.
+ * @param prefix_len Prefix length in bits.
+ * @param cb Callback matching the routes, NULL to accept any route.
+ * @param user_data User specified data.
+ *
+ * @return Route, NULL if there is no such route.
+ */
+sys_snode_t *net_route_trie_find(struct net_route_trie *trie,
+				 const uint8_t *prefix, uint8_t prefix_len,
+				 net_route_trie_match_t cb, void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ROUTE_TRIE_H */
@@ -24,7 +24,8 @@ LOG_MODULE_REGISTER(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
 #include "connection.h"
 #include "net_stats.h"
 #include "net_private.h"
-#include "tcp2_priv.h"
+#include "tcp_internal.h"
+#include "tcp2_cc.h"
 
 #define ACK_TIMEOUT_MS CONFIG_NET_TCP_ACK_TIMEOUT
 #define ACK_TIMEOUT K_MSEC(ACK_TIMEOUT_MS)
@@ -33,10 +34,14 @@ LOG_MODULE_REGISTER(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
 
 static int tcp_rto = CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
 static int tcp_retries = CONFIG_NET_TCP_RETRY_COUNT;
-static int tcp_window = NET_IPV6_MTU;
+static int tcp_window = CONFIG_NET_TCP_MAX_RECV_WINDOW_SIZE ?
+	CONFIG_NET_TCP_MAX_RECV_WINDOW_SIZE : NET_IPV6_MTU;
 
 static sys_slist_t tcp_conns = SYS_SLIST_STATIC_INIT(&tcp_conns);
 
+/* Connections with their end points set, hashed by them */
+static sys_slist_t tcp_conn_hash[CONFIG_NET_MAX_CONTEXTS];
+
 static K_MUTEX_DEFINE(tcp_lock);
 
 static K_MEM_SLAB_DEFINE(tcp_conns_slab, sizeof(struct tcp),
@@ -203,6 +208,30 @@ static int tcp_endpoint_set(union tcp_endpoint *ep, struct net_pkt *pkt,
 	return ret;
 }
 
+static sys_slist_t *tcp_conn_hash_list(union tcp_endpoint *src,
+				       union tcp_endpoint *dst)
+{
+	uint32_t hash;
+
+	/* Same hash as the one of the connection handlers */
+	hash = net_conn_hash(IPPROTO_TCP, dst->sa.sa_family,
+			     dst->sa.sa_family == AF_INET6 ?
+			     (void *)&dst->sin6.sin6_addr :
+			     (void *)&dst->sin.sin_addr,
+			     dst->sin.sin_port, src->sin.sin_port);
+
+	return &tcp_conn_hash[hash % ARRAY_SIZE(tcp_conn_hash)];
+}
+
+/* Called once the end points of a new connection are set */
+static void tcp_conn_hash_add(struct tcp *conn)
+{
+	k_mutex_lock(&tcp_lock, K_FOREVER);
+	sys_slist_prepend(tcp_conn_hash_list(&conn->src, &conn->dst),
+			  &conn->hash_node);
+	k_mutex_unlock(&tcp_lock);
+}
+
 static const char *tcp_flags(uint8_t flags)
 {
 #define BUF_SIZE 25 /* 6 * 4 + 1 */
@@ -422,8 +451,14 @@ static int tcp_conn_unref(struct tcp *conn)
 
 	k_work_cancel_delayable(&conn->timewait_timer);
 	k_work_cancel_delayable(&conn->fin_timer);
+	k_work_cancel_delayable(&conn->ack_timer);
 
 	sys_slist_find_and_remove(&tcp_conns, &conn->next);
+	if (conn->dst.sa.sa_family != AF_UNSPEC) {
+		sys_slist_find_and_remove(tcp_conn_hash_list(&conn->src,
+							     &conn->dst),
+					  &conn->hash_node);
+	}
 
 	memset(conn, 0, sizeof(*conn));
 
@@ -498,7 +533,7 @@ static bool tcp_send_process_no_lock(struct tcp *conn)
 
 	if (conn->in_retransmission) {
 		k_work_reschedule_for_queue(&tcp_work_q, &conn->send_timer,
-					    K_MSEC(tcp_rto));
+					    K_MSEC(conn->rto));
 	}
 
 out:
@@ -543,7 +578,7 @@ static void tcp_send_timer_cancel(struct tcp *conn)
 	} else {
 		conn->send_retries = tcp_retries;
 		k_work_reschedule_for_queue(&tcp_work_q, &conn->send_timer,
-					    K_MSEC(tcp_rto));
+					    K_MSEC(conn->rto));
 	}
 }
 
@@ -613,9 +648,6 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 
 	NET_DBG("len=%zd", len);
 
-	recv_options->mss_found = false;
-	recv_options->wnd_found = false;
-
 	for ( ; options && len >= 1; options += opt_len, len -= opt_len) {
 		opt = options[0];
 
@@ -649,6 +681,9 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 
 			recv_options->mss =
 				ntohs(UNALIGNED_GET((uint16_t *)(options + 2)));
+			/* A tiny MSS would only multiply the segments */
+			recv_options->mss = MAX(recv_options->mss,
+						TCP_MIN_MSS);
 			recv_options->mss_found = true;
 			NET_DBG("MSS=%hu", recv_options->mss);
 			break;
@@ -658,9 +693,52 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 				goto end;
 			}
 
-			recv_options->window = opt;
+			recv_options->window = options[2];
 			recv_options->wnd_found = true;
 			break;
+		case TCPOPT_SACK_PERM:
+			if (opt_len != 2) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->sack_perm_found = true;
+			break;
+		case TCPOPT_TIMESTAMP:
+			if (opt_len != TCPOPT_TIMESTAMP_LEN) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->tsval =
+				ntohl(UNALIGNED_GET((uint32_t *)(options + 2)));
+			recv_options->tsecr =
+				ntohl(UNALIGNED_GET((uint32_t *)(options + 6)));
+			recv_options->ts_found = true;
+			break;
+#if defined(CONFIG_NET_TCP_SACK)
+		case TCPOPT_SACK: {
+			int i, count = (opt_len - 2) / 8;
+
+			if (opt_len != 2 + count * 8 || count == 0 ||
+			    count > TCP_SACK_MAX_BLOCKS) {
+				result = false;
+				goto end;
+			}
+
+			for (i = 0; i < count; i++) {
+				recv_options->sacks[i].left = ntohl(
+					UNALIGNED_GET((uint32_t *)
+						      (options + 2 + i * 8)));
+				recv_options->sacks[i].right = ntohl(
+					UNALIGNED_GET((uint32_t *)
+						      (options + 6 + i * 8)));
+			}
+
+			recv_options->sack_count = count;
+			break;
+		}
+#endif
 		default:
 			continue;
 		}
@@ -755,11 +833,160 @@ static int tcp_finalize_pkt(struct net_pkt *pkt)
 	return -EINVAL;
 }
 
+/* Window scale to offer, the smallest shift that covers our window */
+static uint8_t tcp_rcv_wscale(struct tcp *conn)
+{
+	uint8_t shift = 0U;
+
+	while ((conn->recv_win_max >> shift) > UINT16_MAX &&
+	       shift < TCP_MAX_WINDOW_SHIFT) {
+		shift++;
+	}
+
+	return shift;
+}
+
+/* Enable the options that both ends sent in the SYN exchange */
+static void tcp_options_negotiate(struct tcp *conn)
+{
+	struct tcp_options *opts = &conn->recv_options;
+
+	if (IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE) && opts->wnd_found) {
+		conn->wscale_ok = true;
+		conn->snd_wscale = MIN(opts->window, TCP_MAX_WINDOW_SHIFT);
+		conn->rcv_wscale = tcp_rcv_wscale(conn);
+	}
+
+	if (IS_ENABLED(CONFIG_NET_TCP_TIMESTAMPS) && opts->ts_found) {
+		conn->ts_ok = true;
+		conn->ts_recent = opts->tsval;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_TCP_SACK) && opts->sack_perm_found) {
+		conn->sack_ok = true;
+	}
+
+	NET_DBG("conn: %p wscale %d/%d ts %d sack %d", conn,
+		conn->wscale_ok ? conn->snd_wscale : -1,
+		conn->wscale_ok ? conn->rcv_wscale : -1,
+		conn->ts_ok, conn->sack_ok);
+}
+
+static size_t tcp_option_timestamp_add(struct tcp *conn, uint8_t *opts)
+{
+	opts[0] = TCPOPT_NOP;
+	opts[1] = TCPOPT_NOP;
+	opts[2] = TCPOPT_TIMESTAMP;
+	opts[3] = TCPOPT_TIMESTAMP_LEN;
+	UNALIGNED_PUT(htonl(k_uptime_get_32()), (uint32_t *)(opts + 4));
+	UNALIGNED_PUT(htonl(conn->ts_recent), (uint32_t *)(opts + 8));
+
+	return TCPOPT_TIMESTAMP_SPACE;
+}
+
+/* Options of a SYN. A SYN-ACK only carries the options of the SYN that
+ * were negotiated.
+ */
+static size_t tcp_options_syn_add(struct tcp *conn, uint8_t flags,
+				  uint8_t *opts)
+{
+	bool syn_ack = flags & ACK;
+	bool wscale = syn_ack ? conn->wscale_ok :
+		IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE);
+	bool ts = syn_ack ? conn->ts_ok : IS_ENABLED(CONFIG_NET_TCP_TIMESTAMPS);
+	bool sack = syn_ack ? conn->sack_ok : IS_ENABLED(CONFIG_NET_TCP_SACK);
+	size_t len = 0;
+
+	if (!wscale && !ts && !sack) {
+		return 0;
+	}
+
+	opts[len++] = TCPOPT_MAXSEG;
+	opts[len++] = 4U;
+	UNALIGNED_PUT(htons(net_tcp_get_recv_mss(conn)),
+		      (uint16_t *)(opts + len));
+	len += 2U;
+
+	if (ts) {
+		len += tcp_option_timestamp_add(conn, opts + len);
+
+		if (sack) {
+			/* Use the NOPs in front of the timestamps */
+			opts[len - TCPOPT_TIMESTAMP_SPACE] = TCPOPT_SACK_PERM;
+			opts[len - TCPOPT_TIMESTAMP_SPACE + 1] = 2U;
+		}
+	} else if (sack) {
+		opts[len++] = TCPOPT_NOP;
+		opts[len++] = TCPOPT_NOP;
+		opts[len++] = TCPOPT_SACK_PERM;
+		opts[len++] = 2U;
+	}
+
+	if (wscale) {
+		opts[len++] = TCPOPT_NOP;
+		opts[len++] = TCPOPT_WINDOW;
+		opts[len++] = 3U;
+		opts[len++] = tcp_rcv_wscale(conn);
+	}
+
+	return len;
+}
+
+/* Build the TCP options of a segment, opts must have room for
+ * TCPOPT_MAX_LEN bytes. Returns the length, a multiple of four.
+ */
+static size_t tcp_options_add(struct tcp *conn, uint8_t flags,
+			      uint8_t *opts)
+{
+	size_t len = 0;
+
+	if (flags & SYN) {
+		return tcp_options_syn_add(conn, flags, opts);
+	}
+
+	if (conn->ts_ok) {
+		len += tcp_option_timestamp_add(conn, opts + len);
+	}
+
+#if defined(CONFIG_NET_TCP_SACK)
+	/* Report the queued out-of-order data, it is one contiguous block */
+	if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT && conn->sack_ok &&
+	    (flags & ACK) && !net_pkt_is_empty(conn->queue_recv_data)) {
+		uint32_t left = tcp_get_seq(conn->queue_recv_data->buffer);
+		uint32_t right = left +
+			net_pkt_get_len(conn->queue_recv_data);
+
+		opts[len++] = TCPOPT_NOP;
+		opts[len++] = TCPOPT_NOP;
+		opts[len++] = TCPOPT_SACK;
+		opts[len++] = 2U + sizeof(struct tcp_sack_block);
+		UNALIGNED_PUT(htonl(left), (uint32_t *)(opts + len));
+		UNALIGNED_PUT(htonl(right), (uint32_t *)(opts + len + 4));
+		len += sizeof(struct tcp_sack_block);
+	}
+#endif
+
+	return len;
+}
+
+/* The window in a SYN is never scaled, RFC 7323 chapter 2.2 */
+static uint16_t tcp_window_field(struct tcp *conn, uint8_t flags)
+{
+	uint32_t win = conn->recv_win;
+
+	if (!(flags & SYN)) {
+		win >>= conn->rcv_wscale;
+	}
+
+	return MIN(win, UINT16_MAX);
+}
+
 static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
-			  uint32_t seq)
+			  uint32_t seq, const uint8_t *opts, size_t opts_len)
 {
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
 	struct tcphdr *th;
+	int ret;
 
 	th = (struct tcphdr *)net_pkt_get_data(pkt, &tcp_access);
 	if (!th) {
@@ -770,16 +997,21 @@ static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
 
 	UNALIGNED_PUT(conn->src.sin.sin_port, &th->th_sport);
 	UNALIGNED_PUT(conn->dst.sin.sin_port, &th->th_dport);
-	th->th_off = 5;
+	th->th_off = 5 + opts_len / 4;
 	UNALIGNED_PUT(flags, &th->th_flags);
-	UNALIGNED_PUT(htons(conn->recv_win), &th->th_win);
+	UNALIGNED_PUT(htons(tcp_window_field(conn, flags)), &th->th_win);
 	UNALIGNED_PUT(htonl(seq), &th->th_seq);
 
 	if (ACK & flags) {
 		UNALIGNED_PUT(htonl(conn->ack), &th->th_ack);
 	}
 
-	return net_pkt_set_data(pkt, &tcp_access);
+	ret = net_pkt_set_data(pkt, &tcp_access);
+	if (ret < 0 || opts_len == 0) {
+		return ret;
+	}
+
+	return net_pkt_write(pkt, opts, opts_len);
 }
 
 static int ip_header_add(struct tcp *conn, struct net_pkt *pkt)
@@ -802,16 +1034,25 @@ static int ip_header_add(struct tcp *conn, struct net_pkt *pkt)
 static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		       uint32_t seq)
 {
+	uint8_t opts[TCPOPT_MAX_LEN];
+	size_t opts_len;
 	struct net_pkt *pkt;
 	int ret = 0;
 
-	pkt = tcp_pkt_alloc(conn, sizeof(struct tcphdr));
+	opts_len = tcp_options_add(conn, flags, opts);
+
+	pkt = tcp_pkt_alloc(conn, sizeof(struct tcphdr) + opts_len);
 	if (!pkt) {
 		ret = -ENOBUFS;
 		goto out;
 	}
 
 	if (data) {
+		/* Leave it to net_send_data() to split it in segments */
+		if (net_pkt_get_len(data) > conn_mss(conn)) {
+			net_pkt_set_gso_size(pkt, conn_mss(conn));
+		}
+
 		/* Append the data buffer to the pkt */
 		net_pkt_append_buffer(pkt, data->buffer);
 		data->buffer = NULL;
@@ -823,7 +1064,7 @@ static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		goto out;
 	}
 
-	ret = tcp_header_add(conn, pkt, flags, seq);
+	ret = tcp_header_add(conn, pkt, flags, seq, opts, opts_len);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
 		goto out;
@@ -837,6 +1078,12 @@ static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 
 	NET_DBG("%s", log_strdup(tcp_th(pkt)));
 
+	if (flags & ACK) {
+		/* This acknowledges everything received so far */
+		conn->rcv_unacked = 0U;
+		k_work_cancel_delayable(&conn->ack_timer);
+	}
+
 	if (tcp_send_cb) {
 		ret = tcp_send_cb(pkt);
 		goto out;
@@ -856,6 +1103,58 @@ static void tcp_out(struct tcp *conn, uint8_t flags)
 	(void)tcp_out_ext(conn, flags, NULL /* no data */, conn->seq);
 }
 
+static void tcp_ack_timeout(struct k_work *work)
+{
+	struct tcp *conn = CONTAINER_OF(work, struct tcp, ack_timer);
+
+	k_mutex_lock(&conn->lock, K_FOREVER);
+
+	if (conn->rcv_unacked > 0U) {
+		NET_DBG("conn: %p delayed ACK of %u bytes", conn,
+			conn->rcv_unacked);
+		tcp_out(conn, ACK);
+	}
+
+	k_mutex_unlock(&conn->lock);
+}
+
+/* Acknowledge the next segments without delay, so that the peer can
+ * open its congestion window or recover from a loss quickly.
+ */
+static void tcp_quickack_enter(struct tcp *conn)
+{
+	conn->quickacks = CLAMP(conn->recv_win /
+				(2U * net_tcp_get_recv_mss(conn)),
+				1U, TCP_MAX_QUICKACKS);
+}
+
+/* Acknowledge received data. The ACK is delayed until a second
+ * full-sized segment arrives or the delayed ACK timer expires (RFC 1122
+ * chapter 4.2.3.2), unless we are in quick ACK mode or the segment
+ * fills a gap in the received data (RFC 5681 chapter 4.2).
+ */
+static void tcp_ack_data(struct tcp *conn, size_t len, bool quick)
+{
+	conn->rcv_unacked += len;
+
+	if (CONFIG_NET_TCP_DELAYED_ACK_TIMEOUT == 0 || quick ||
+	    conn->quickacks > 0U ||
+	    conn->rcv_unacked >= 2U * net_tcp_get_recv_mss(conn)) {
+		if (conn->quickacks > 0U) {
+			conn->quickacks--;
+		}
+
+		tcp_out(conn, ACK);
+		return;
+	}
+
+	if (!k_work_delayable_is_pending(&conn->ack_timer)) {
+		k_work_reschedule_for_queue(
+			&tcp_work_q, &conn->ack_timer,
+			K_MSEC(CONFIG_NET_TCP_DELAYED_ACK_TIMEOUT));
+	}
+}
+
 static int tcp_pkt_pull(struct net_pkt *pkt, size_t len)
 {
 	int total = net_pkt_get_len(pkt);
@@ -897,6 +1196,21 @@ static bool tcp_window_full(struct tcp *conn)
 	return window_full;
 }
 
+/* Check if the congestion window leaves room for the next segment */
+static bool tcp_cwnd_full(struct tcp *conn)
+{
+	size_t len;
+
+	if (!IS_ENABLED(CONFIG_NET_TCP_CONGESTION_CONTROL)) {
+		return false;
+	}
+
+	len = MIN(conn->send_data_total - conn->unacked_len,
+		  (size_t)conn_mss(conn));
+
+	return conn->unacked_len + len > conn->cc.cwnd;
+}
+
 static int tcp_unsent_len(struct tcp *conn)
 {
 	int unsent_len;
@@ -915,61 +1229,347 @@ static int tcp_unsent_len(struct tcp *conn)
 	return unsent_len;
 }
 
-static int tcp_send_data(struct tcp *conn)
+/* Send len bytes at offset pos of the send_data */
+static int tcp_send_segment(struct tcp *conn, int pos, int len)
 {
-	int ret = 0;
-	int pos, len;
 	struct net_pkt *pkt;
-
-	pos = conn->unacked_len;
-	len = MIN3(conn->send_data_total - conn->unacked_len,
-		   conn->send_win - conn->unacked_len,
-		   conn_mss(conn));
-	if (len == 0) {
-		NET_DBG("conn: %p no data to send", conn);
-		ret = -ENODATA;
-		goto out;
-	}
+	int ret;
 
 	pkt = tcp_pkt_alloc(conn, len);
 	if (!pkt) {
 		NET_ERR("conn: %p packet allocation failed, len=%d", conn, len);
-		ret = -ENOBUFS;
-		goto out;
+		return -ENOBUFS;
 	}
 
 	ret = tcp_pkt_peek(pkt, conn->send_data, pos, len);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
-		ret = -ENOBUFS;
+		return -ENOBUFS;
+	}
+
+	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + pos);
+
+	/* The data we want to send, has been moved to the send queue so we
+	 * can unref the head net_pkt. If there was an error, we need to remove
+	 * the packet anyway.
+	 */
+	tcp_pkt_unref(pkt);
+
+	return ret;
+}
+
+/* Update the smoothed RTT and the retransmission timeout with a new
+ * measurement, RFC 6298 chapter 2.
+ */
+static void tcp_rtt_update(struct tcp *conn, uint32_t rtt)
+{
+	int32_t delta;
+
+	/* Below the resolution of the clock */
+	rtt = MAX(rtt, 1U);
+
+	if (conn->srtt == 0U) {
+		conn->srtt = rtt << 3;
+		conn->rttvar = rtt << 1;
+	} else {
+		delta = (int32_t)rtt - (int32_t)(conn->srtt >> 3);
+		conn->srtt += delta;
+		if (delta < 0) {
+			delta = -delta;
+		}
+
+		conn->rttvar += delta - (conn->rttvar >> 2);
+	}
+
+	conn->rtt = rtt;
+	conn->rto = CLAMP((conn->srtt >> 3) + MAX(conn->rttvar, 1U),
+			  CONFIG_NET_TCP_MIN_RETRANSMISSION_TIMEOUT,
+			  CONFIG_NET_TCP_MAX_RETRANSMISSION_TIMEOUT);
+
+	NET_DBG("conn: %p rtt=%u srtt=%u rttvar=%u rto=%u", conn, rtt,
+		conn->srtt >> 3, conn->rttvar >> 2, conn->rto);
+}
+
+/* Take an RTT sample from an ACK of new data. With timestamps every ACK
+ * gives one, otherwise one segment at a time is timed and retransmitted
+ * segments are never used (Karn's algorithm).
+ */
+static void tcp_rtt_sample(struct tcp *conn, uint32_t ack)
+{
+	if (conn->ts_ok && conn->recv_options.ts_found &&
+	    conn->recv_options.tsecr) {
+		conn->rtt_pending = false;
+		tcp_rtt_update(conn,
+			       k_uptime_get_32() - conn->recv_options.tsecr);
+	} else if (conn->rtt_pending &&
+		   net_tcp_seq_cmp(ack, conn->rtt_seq) >= 0) {
+		conn->rtt_pending = false;
+		tcp_rtt_update(conn, k_uptime_get_32() - conn->rtt_start);
+	}
+}
+
+/* Number of full segments that can go out in one packet split by
+ * net_tcp_gso_segment(), or 0 if sending them one by one is as good.
+ */
+static int tcp_gso_segs(struct tcp *conn)
+{
+#if defined(CONFIG_NET_TCP_GSO)
+	int mss = conn_mss(conn);
+	int segs;
+
+	if (conn->data_mode == TCP_DATA_MODE_RESEND) {
+		return 0;
+	}
+
+	segs = MIN3(CONFIG_NET_TCP_GSO_MAX_SEGS,
+		    (int)(conn->send_data_total - conn->unacked_len) / mss,
+		    (int)(conn->send_win - conn->unacked_len) / mss);
+
+	if (IS_ENABLED(CONFIG_NET_TCP_CONGESTION_CONTROL)) {
+		segs = MIN(segs,
+			   (int)(conn->cc.cwnd - conn->unacked_len) / mss);
+	}
+
+	return segs >= 2 ? segs : 0;
+#else
+	ARG_UNUSED(conn);
+
+	return 0;
+#endif
+}
+
+static int tcp_send_data(struct tcp *conn)
+{
+	int ret = 0;
+	int len, segs;
+
+	segs = tcp_gso_segs(conn);
+	if (segs) {
+		len = segs * conn_mss(conn);
+
+		ret = tcp_send_segment(conn, conn->unacked_len, len);
+		if (ret == 0) {
+			goto sent;
+		}
+
+		/* Out of buffers for the large packet, try a single one */
+		segs = 0;
+	}
+
+	len = MIN3(conn->send_data_total - conn->unacked_len,
+		   conn->send_win - conn->unacked_len,
+		   conn_mss(conn));
+	if (len == 0) {
+		NET_DBG("conn: %p no data to send", conn);
+		ret = -ENODATA;
 		goto out;
 	}
 
-	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + conn->unacked_len);
+	ret = tcp_send_segment(conn, conn->unacked_len, len);
+sent:
 	if (ret == 0) {
 		conn->unacked_len += len;
+		segs = MAX(segs, 1);
 
 		if (conn->data_mode == TCP_DATA_MODE_RESEND) {
 			net_stats_update_tcp_resent(conn->iface, len);
 			net_stats_update_tcp_seg_rexmit(conn->iface);
 		} else {
 			net_stats_update_tcp_sent(conn->iface, len);
-			net_stats_update_tcp_seg_sent(conn->iface);
+
+			while (segs--) {
+				net_stats_update_tcp_seg_sent(conn->iface);
+			}
+
+			if (!conn->rtt_pending) {
+				conn->rtt_pending = true;
+				conn->rtt_seq = conn->seq + conn->unacked_len;
+				conn->rtt_start = k_uptime_get_32();
+			}
 		}
 	}
 
-	/* The data we want to send, has been moved to the send queue so we
-	 * can unref the head net_pkt. If there was an error, we need to remove
-	 * the packet anyway.
-	 */
-	tcp_pkt_unref(pkt);
-
 	conn_send_data_dump(conn);
 
  out:
 	return ret;
 }
 
+#if defined(CONFIG_NET_TCP_SACK)
+/* Add a block to the SACK scoreboard, merging it with the blocks it
+ * overlaps or touches.
+ */
+static void tcp_sack_add(struct tcp *conn, uint32_t left, uint32_t right)
+{
+	struct tcp_sack_block *sacked = conn->sacked;
+	int i, j;
+
+	for (i = 0, j = 0; i < conn->sacked_count; i++) {
+		if (net_tcp_seq_cmp(right, sacked[i].left) >= 0 &&
+		    net_tcp_seq_cmp(left, sacked[i].right) <= 0) {
+			if (net_tcp_seq_cmp(sacked[i].left, left) < 0) {
+				left = sacked[i].left;
+			}
+
+			if (net_tcp_seq_cmp(sacked[i].right, right) > 0) {
+				right = sacked[i].right;
+			}
+
+			continue;
+		}
+
+		sacked[j++] = sacked[i];
+	}
+
+	conn->sacked_count = j;
+
+	for (i = 0; i < conn->sacked_count; i++) {
+		if (net_tcp_seq_cmp(left, sacked[i].left) < 0) {
+			break;
+		}
+	}
+
+	if (i == ARRAY_SIZE(conn->sacked)) {
+		return;
+	}
+
+	if (conn->sacked_count == ARRAY_SIZE(conn->sacked)) {
+		conn->sacked_count--;
+	}
+
+	memmove(&sacked[i + 1], &sacked[i],
+		(conn->sacked_count - i) * sizeof(sacked[0]));
+	sacked[i].left = left;
+	sacked[i].right = right;
+	conn->sacked_count++;
+}
+
+/* Update the scoreboard with the cumulative ACK and the SACK blocks of a
+ * received segment, RFC 2018 chapter 4.
+ */
+static void tcp_sack_update(struct tcp *conn, uint32_t ack)
+{
+	struct tcp_options *opts = &conn->recv_options;
+	uint32_t snd_max = conn->seq + conn->send_data_total;
+	int i, j;
+
+	for (i = 0, j = 0; i < conn->sacked_count; i++) {
+		if (net_tcp_seq_cmp(conn->sacked[i].right, ack) <= 0) {
+			continue;
+		}
+
+		if (net_tcp_seq_cmp(conn->sacked[i].left, ack) < 0) {
+			conn->sacked[i].left = ack;
+		}
+
+		conn->sacked[j++] = conn->sacked[i];
+	}
+
+	conn->sacked_count = j;
+
+	for (i = 0; i < opts->sack_count; i++) {
+		struct tcp_sack_block *block = &opts->sacks[i];
+
+		/* Ignore blocks of data that is acked or was never sent */
+		if (net_tcp_seq_cmp(block->left, ack) < 0 ||
+		    net_tcp_seq_cmp(block->right, block->left) <= 0 ||
+		    net_tcp_seq_cmp(block->right, snd_max) > 0) {
+			continue;
+		}
+
+		tcp_sack_add(conn, block->left, block->right);
+	}
+}
+
+/* Find the first segment below the highest SACKed data that is neither
+ * SACKed nor already retransmitted in this recovery (RFC 6675 chapter 4,
+ * NextSeg rule 1).
+ */
+static bool tcp_sack_next_hole(struct tcp *conn, int *pos, int *len)
+{
+	uint32_t start = conn->seq;
+	int i;
+
+	if (net_tcp_seq_greater(conn->sack_rexmit, start)) {
+		start = conn->sack_rexmit;
+	}
+
+	for (i = 0; i < conn->sacked_count; i++) {
+		if (net_tcp_seq_cmp(conn->sacked[i].right, start) <= 0) {
+			continue;
+		}
+
+		if (net_tcp_seq_cmp(start, conn->sacked[i].left) < 0) {
+			*pos = start - conn->seq;
+			if (*pos >= conn->unacked_len) {
+				return false;
+			}
+
+			*len = MIN3((int)(conn->sacked[i].left - start),
+				    conn_mss(conn), conn->unacked_len - *pos);
+
+			return true;
+		}
+
+		start = conn->sacked[i].right;
+	}
+
+	return false;
+}
+#endif /* CONFIG_NET_TCP_SACK */
+
+/* Resend the first unacknowledged segment, or with SACK the next one the
+ * peer is missing, without waiting for the retransmission timer.
+ */
+static int tcp_fast_retransmit(struct tcp *conn)
+{
+	int len = MIN(conn->unacked_len, conn_mss(conn));
+	int pos = 0;
+	int ret;
+
+#if defined(CONFIG_NET_TCP_SACK)
+	if (conn->sack_ok && conn->sacked_count > 0 &&
+	    !tcp_sack_next_hole(conn, &pos, &len)) {
+		return -ENODATA;
+	}
+#endif
+
+	if (len == 0) {
+		return -ENODATA;
+	}
+
+	ret = tcp_send_segment(conn, pos, len);
+	if (ret == 0) {
+#if defined(CONFIG_NET_TCP_SACK)
+		conn->sack_rexmit = conn->seq + pos + len;
+#endif
+		conn->rtt_pending = false;
+		net_stats_update_tcp_resent(conn->iface, len);
+		net_stats_update_tcp_seg_rexmit(conn->iface);
+		net_stats_update_tcp_fast_rexmit(conn->iface);
+	}
+
+	return ret;
+}
+
+/* Hold back a segment smaller than the MSS while earlier data is
+ * unacknowledged, Nagle's algorithm (RFC 896, RFC 1122 chapter
+ * 4.2.3.4). With TCP_CORK it is held back until the option is cleared.
+ */
+static bool tcp_nagle_hold(struct tcp *conn)
+{
+	if (conn->in_close ||
+	    tcp_unsent_len(conn) >= conn_mss(conn)) {
+		return false;
+	}
+
+	if (conn->cork) {
+		return true;
+	}
+
+	return !conn->nodelay && conn->unacked_len > 0;
+}
+
 /* Send all queued but unsent data from the send_data packet by packet
  * until the receiver's window is full. */
 static int tcp_send_queued_data(struct tcp *conn)
@@ -983,11 +1583,15 @@ static int tcp_send_queued_data(struct tcp *conn)
 
 	while (tcp_unsent_len(conn) > 0) {
 
-		if (tcp_window_full(conn)) {
+		if (tcp_window_full(conn) || tcp_cwnd_full(conn)) {
 			subscribe = true;
 			break;
 		}
 
+		if (tcp_nagle_hold(conn)) {
+			break;
+		}
+
 		ret = tcp_send_data(conn);
 		if (ret < 0) {
 			break;
@@ -1013,7 +1617,7 @@ static int tcp_send_queued_data(struct tcp *conn)
 	if (subscribe) {
 		conn->send_data_retries = 0;
 		k_work_reschedule_for_queue(&tcp_work_q, &conn->send_data_timer,
-					    K_MSEC(tcp_rto));
+					    K_MSEC(conn->rto));
 	}
  out:
 	return ret;
@@ -1051,6 +1655,23 @@ static void tcp_resend_data(struct k_work *work)
 		goto out;
 	}
 
+	/* Only the first timeout of the same data is a congestion signal */
+	if (IS_ENABLED(CONFIG_NET_TCP_CONGESTION_CONTROL) &&
+	    conn->data_mode == TCP_DATA_MODE_SEND &&
+	    conn->send_data_total > 0) {
+		tcp_cc_timeout(conn);
+	}
+
+#if defined(CONFIG_NET_TCP_SACK)
+	/* The peer may have discarded the data it SACKed, RFC 2018
+	 * chapter 8.
+	 */
+	conn->sacked_count = 0U;
+#endif
+
+	/* Karn's algorithm, retransmitted data is not timed */
+	conn->rtt_pending = false;
+
 	conn->data_mode = TCP_DATA_MODE_RESEND;
 	conn->unacked_len = 0;
 
@@ -1058,6 +1679,11 @@ static void tcp_resend_data(struct k_work *work)
 	if (ret == 0) {
 		conn->send_data_retries++;
 
+		/* Back off the timer, RFC 6298 chapter 5.5 */
+		net_stats_update_tcp_rto(conn->iface);
+		conn->rto = MIN(conn->rto * 2U,
+				CONFIG_NET_TCP_MAX_RETRANSMISSION_TIMEOUT);
+
 		if (conn->in_close && conn->send_data_total == 0) {
 			NET_DBG("TCP connection in active close, "
 				"not disposing yet (waiting %dms)",
@@ -1081,7 +1707,7 @@ static void tcp_resend_data(struct k_work *work)
 	}
 
 	k_work_reschedule_for_queue(&tcp_work_q, &conn->send_data_timer,
-				    K_MSEC(tcp_rto));
+				    K_MSEC(conn->rto));
 
  out:
 	k_mutex_unlock(&conn->lock);
@@ -1167,6 +1793,12 @@ static struct tcp *tcp_conn_alloc(void)
 	conn->in_connect = false;
 	conn->state = TCP_LISTEN;
 	conn->recv_win = tcp_window;
+	conn->recv_win_max = tcp_window;
+	conn->rto = tcp_rto;
+
+	if (IS_ENABLED(CONFIG_NET_TCP_CONGESTION_CONTROL)) {
+		tcp_cc_init(conn);
+	}
 
 	/* The ISN value will be set when we get the connection attempt or
 	 * when trying to create a connection.
@@ -1180,6 +1812,7 @@ static struct tcp *tcp_conn_alloc(void)
 	k_work_init_delayable(&conn->fin_timer, tcp_fin_timeout);
 	k_work_init_delayable(&conn->send_data_timer, tcp_resend_data);
 	k_work_init_delayable(&conn->recv_queue_timer, tcp_cleanup_recv_queue);
+	k_work_init_delayable(&conn->ack_timer, tcp_ack_timeout);
 
 	tcp_conn_ref(conn);
 
@@ -1221,40 +1854,46 @@ out:
 	return ret;
 }
 
-static bool tcp_endpoint_cmp(union tcp_endpoint *ep, struct net_pkt *pkt,
-			     enum pkt_addr which)
+/* The end points of the packet are the other way round: its source is
+ * the destination of the connection.
+ */
+static bool tcp_conn_cmp(struct tcp *conn, union tcp_endpoint *pkt_src,
+			 union tcp_endpoint *pkt_dst)
 {
-	union tcp_endpoint ep_tmp;
-
-	if (tcp_endpoint_set(&ep_tmp, pkt, which) < 0) {
-		return false;
-	}
+	size_t len = tcp_endpoint_len(pkt_src->sa.sa_family);
 
-	return !memcmp(ep, &ep_tmp, tcp_endpoint_len(ep->sa.sa_family));
+	return !memcmp(&conn->dst, pkt_src, len) &&
+		!memcmp(&conn->src, pkt_dst, len);
 }
 
-static bool tcp_conn_cmp(struct tcp *conn, struct net_pkt *pkt)
+static struct tcp *tcp_conn_search_ep(union tcp_endpoint *pkt_src,
+				      union tcp_endpoint *pkt_dst)
 {
-	return tcp_endpoint_cmp(&conn->src, pkt, TCP_EP_DST) &&
-		tcp_endpoint_cmp(&conn->dst, pkt, TCP_EP_SRC);
+	struct tcp *conn;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(tcp_conn_hash_list(pkt_dst, pkt_src),
+				     conn, hash_node) {
+		if (tcp_conn_cmp(conn, pkt_src, pkt_dst)) {
+			return conn;
+		}
+	}
+
+	return NULL;
 }
 
+#if defined(CONFIG_NET_TEST_PROTOCOL)
 static struct tcp *tcp_conn_search(struct net_pkt *pkt)
 {
-	bool found = false;
-	struct tcp *conn;
-	struct tcp *tmp;
-
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp_conns, conn, tmp, next) {
+	union tcp_endpoint src, dst;
 
-		found = tcp_conn_cmp(conn, pkt);
-		if (found) {
-			break;
-		}
+	if (tcp_endpoint_set(&src, pkt, TCP_EP_SRC) < 0 ||
+	    tcp_endpoint_set(&dst, pkt, TCP_EP_DST) < 0) {
+		return NULL;
 	}
 
-	return found ? conn : NULL;
+	return tcp_conn_search_ep(&src, &dst);
 }
+#endif
 
 static struct tcp *tcp_conn_new(struct net_pkt *pkt);
 
@@ -1264,13 +1903,25 @@ static enum net_verdict tcp_recv(struct net_conn *net_conn,
 				 union net_proto_header *proto,
 				 void *user_data)
 {
-	struct tcp *conn;
+	struct tcp *conn = ((struct net_context *)user_data)->tcp;
+	union tcp_endpoint src, dst;
 	struct tcphdr *th;
 
 	ARG_UNUSED(net_conn);
 	ARG_UNUSED(proto);
 
-	conn = tcp_conn_search(pkt);
+	if (tcp_endpoint_set(&src, pkt, TCP_EP_SRC) < 0 ||
+	    tcp_endpoint_set(&dst, pkt, TCP_EP_DST) < 0) {
+		conn = NULL;
+		goto in;
+	}
+
+	/* The handler of a connected context is most likely the one */
+	if (conn && tcp_conn_cmp(conn, &src, &dst)) {
+		goto in;
+	}
+
+	conn = tcp_conn_search_ep(&src, &dst);
 	if (conn) {
 		goto in;
 	}
@@ -1288,6 +1939,20 @@ static enum net_verdict tcp_recv(struct net_conn *net_conn,
 
 		net_ipaddr_copy(&conn_old->context->remote, &conn->dst.sa);
 
+		/* Inherit the options of the listening socket */
+		conn->nodelay = conn_old->nodelay;
+		conn->cork = conn_old->cork;
+		conn->recv_win = conn_old->recv_win_max;
+		conn->recv_win_max = conn_old->recv_win_max;
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+		conn->context->options.rcvbuf =
+			conn_old->context->options.rcvbuf;
+#endif
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+		conn->context->options.sndbuf =
+			conn_old->context->options.sndbuf;
+#endif
+
 		conn->accepted_conn = conn_old;
 	}
  in:
@@ -1430,6 +2095,8 @@ static struct tcp *tcp_conn_new(struct net_pkt *pkt)
 		goto err;
 	}
 
+	tcp_conn_hash_add(conn);
+
 	NET_DBG("conn: src: %s, dst: %s",
 		log_strdup(net_sprint_addr(conn->src.sa.sa_family,
 				(const void *)&conn->src.sin.sin_addr)),
@@ -1598,13 +2265,16 @@ static void tcp_queue_recv_data(struct tcp *conn, struct net_pkt *pkt,
 static bool tcp_data_received(struct tcp *conn, struct net_pkt *pkt,
 			      size_t *len)
 {
+	bool gap = CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT &&
+		!net_pkt_is_empty(conn->queue_recv_data);
+
 	if (tcp_data_get(conn, pkt, len) < 0) {
 		return false;
 	}
 
 	net_stats_update_tcp_seg_recv(conn->iface);
 	conn_ack(conn, *len);
-	tcp_out(conn, ACK);
+	tcp_ack_data(conn, *len, gap);
 
 	return true;
 }
@@ -1624,6 +2294,8 @@ static void tcp_out_of_order_data(struct tcp *conn, struct net_pkt *pkt,
 	/* We received out-of-order data. Try to queue it.
 	 */
 	tcp_queue_recv_data(conn, pkt, data_len, seq);
+
+	tcp_quickack_enter(conn);
 }
 
 /* TCP state machine, everything happens here */
@@ -1638,6 +2310,7 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 	struct net_pkt *recv_pkt;
 	void *recv_user_data;
 	struct k_fifo *recv_data_fifo;
+	uint32_t prev_send_win = 0;
 	size_t len;
 	int ret;
 
@@ -1669,6 +2342,12 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		goto next_state;
 	}
 
+	/* These options are only valid for the segment they came with */
+	conn->recv_options.ts_found = false;
+#if defined(CONFIG_NET_TCP_SACK)
+	conn->recv_options.sack_count = 0U;
+#endif
+
 	if (tcp_options_len && !tcp_options_check(&conn->recv_options, pkt,
 						  tcp_options_len)) {
 		NET_DBG("DROP: Invalid TCP option list");
@@ -1677,10 +2356,34 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		goto next_state;
 	}
 
+	if (th && conn->ts_ok && conn->recv_options.ts_found &&
+	    !(fl & (SYN | RST))) {
+		/* Protection against wrapped sequence numbers, RFC 7323
+		 * chapter 5.3. An RST is never rejected for its timestamp.
+		 */
+		if ((int32_t)(conn->recv_options.tsval -
+			      conn->ts_recent) < 0) {
+			NET_DBG("DROP: Old timestamp %u (recent %u)",
+				conn->recv_options.tsval, conn->ts_recent);
+			net_stats_update_tcp_seg_drop(conn->iface);
+			tcp_out(conn, ACK);
+			k_mutex_unlock(&conn->lock);
+			return;
+		}
+
+		if (net_tcp_seq_cmp(th_seq(th), conn->ack) <= 0) {
+			conn->ts_recent = conn->recv_options.tsval;
+		}
+	}
+
 	if (th) {
 		size_t max_win;
 
+		prev_send_win = conn->send_win;
 		conn->send_win = ntohs(th_win(th));
+		if (!(fl & SYN)) {
+			conn->send_win <<= conn->snd_wscale;
+		}
 
 #if defined(CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE)
 		if (CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE) {
@@ -1711,6 +2414,7 @@ next_state:
 	case TCP_LISTEN:
 		if (FL(&fl, ==, SYN)) {
 			conn_ack(conn, th_seq(th) + 1); /* capture peer's isn */
+			tcp_options_negotiate(conn);
 			tcp_out(conn, SYN | ACK);
 			conn_seq(conn, + 1);
 			next = TCP_SYN_RECEIVED;
@@ -1735,6 +2439,12 @@ next_state:
 			net_context_set_state(conn->context,
 					      NET_CONTEXT_CONNECTED);
 
+			if (IS_ENABLED(CONFIG_NET_TCP_CONGESTION_CONTROL)) {
+				tcp_cc_init(conn);
+			}
+
+			tcp_quickack_enter(conn);
+
 			if (conn->accepted_conn) {
 				conn->accepted_conn->accept_cb(
 					conn->context,
@@ -1763,6 +2473,7 @@ next_state:
 		 */
 		if (FL(&fl, &, SYN | ACK, th && th_ack(th) == conn->seq)) {
 			tcp_send_timer_cancel(conn);
+			tcp_options_negotiate(conn);
 			conn_ack(conn, th_seq(th) + 1);
 			if (len) {
 				if (tcp_data_get(conn, pkt, &len) < 0) {
@@ -1776,6 +2487,12 @@ next_state:
 					      NET_CONTEXT_CONNECTED);
 			tcp_out(conn, ACK);
 
+			if (IS_ENABLED(CONFIG_NET_TCP_CONGESTION_CONTROL)) {
+				tcp_cc_init(conn);
+			}
+
+			tcp_quickack_enter(conn);
+
 			/* The connection semaphore is released *after*
 			 * we have changed the connection state. This way
 			 * the application can send data and it is queued
@@ -1817,11 +2534,19 @@ next_state:
 			break;
 		}
 
+#if defined(CONFIG_NET_TCP_SACK)
+		if (th && conn->sack_ok) {
+			tcp_sack_update(conn, th_ack(th));
+		}
+#endif
+
 		if (th && net_tcp_seq_cmp(th_ack(th), conn->seq) > 0) {
 			uint32_t len_acked = th_ack(th) - conn->seq;
 
 			NET_DBG("conn: %p len_acked=%u", conn, len_acked);
 
+			tcp_rtt_sample(conn, th_ack(th));
+
 			if ((conn->send_data_total < len_acked) ||
 					(tcp_pkt_pull(conn->send_data,
 						      len_acked) < 0)) {
@@ -1843,6 +2568,14 @@ next_state:
 			conn_seq(conn, + len_acked);
 			net_stats_update_tcp_seg_recv(conn->iface);
 
+			if (IS_ENABLED(CONFIG_NET_TCP_CONGESTION_CONTROL) &&
+			    tcp_cc_ack(conn, len_acked)) {
+				/* Partial ACK in fast recovery, the next
+				 * hole is known to be lost as well.
+				 */
+				(void)tcp_fast_retransmit(conn);
+			}
+
 			conn_send_data_dump(conn);
 
 			if (!k_work_delayable_remaining_get(
@@ -1868,6 +2601,40 @@ next_state:
 				break;
 			}
 
+			ret = tcp_send_queued_data(conn);
+			if (ret < 0 && ret != -ENOBUFS) {
+				tcp_out(conn, RST);
+				conn_state(conn, TCP_CLOSED);
+				break;
+			}
+		} else if (IS_ENABLED(CONFIG_NET_TCP_CONGESTION_CONTROL) &&
+			   th && len == 0 && th_ack(th) == conn->seq &&
+			   conn->unacked_len > 0 &&
+			   conn->send_win == prev_send_win &&
+			   conn->data_mode == TCP_DATA_MODE_SEND) {
+			/* Duplicate ACK, RFC 5681 chapter 2 */
+			if (tcp_cc_dup_ack(conn)) {
+#if defined(CONFIG_NET_TCP_SACK)
+				conn->sack_rexmit = conn->seq;
+#endif
+				(void)tcp_fast_retransmit(conn);
+			} else if (conn->cc.in_recovery && conn->sack_ok) {
+				/* The SACK blocks tell what else is missing */
+				(void)tcp_fast_retransmit(conn);
+			}
+
+			if (conn->cc.in_recovery) {
+				ret = tcp_send_queued_data(conn);
+				if (ret < 0 && ret != -ENOBUFS) {
+					tcp_out(conn, RST);
+					conn_state(conn, TCP_CLOSED);
+					break;
+				}
+			}
+		} else if (th && conn->send_win > prev_send_win &&
+			   conn->send_data_total > conn->unacked_len &&
+			   conn->data_mode == TCP_DATA_MODE_SEND) {
+			/* Window update, the peer has read some data */
 			ret = tcp_send_queued_data(conn);
 			if (ret < 0 && ret != -ENOBUFS) {
 				tcp_out(conn, RST);
@@ -1888,6 +2655,13 @@ next_state:
 			} else if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT) {
 				tcp_out_of_order_data(conn, pkt, len,
 						      th_seq(th));
+
+				/* With SACK the duplicate ACK tells the sender
+				 * what was received, RFC 5681 chapter 4.2
+				 */
+				if (conn->sack_ok) {
+					tcp_out(conn, ACK);
+				}
 			}
 		}
 		break;
@@ -2023,11 +2797,14 @@ int net_tcp_put(struct net_context *context)
 				conn->send_data_total);
 			conn->in_close = true;
 
+			/* Do not hold back the last segment any longer */
+			(void)tcp_send_queued_data(conn);
+
 			/* How long to wait until all the data has been sent?
 			 */
 			k_work_reschedule_for_queue(&tcp_work_q,
 						    &conn->send_data_timer,
-						    K_MSEC(tcp_rto));
+						    K_MSEC(conn->rto));
 		} else {
 			int ret;
 
@@ -2068,10 +2845,143 @@ int net_tcp_listen(struct net_context *context)
 
 int net_tcp_update_recv_wnd(struct net_context *context, int32_t delta)
 {
-	ARG_UNUSED(context);
-	ARG_UNUSED(delta);
+	struct tcp *conn = context->tcp;
+	uint32_t thresh;
+	int32_t win;
+
+	if (!conn) {
+		return -ENOTCONN;
+	}
 
-	return -EPROTONOSUPPORT;
+	k_mutex_lock(&conn->lock, K_FOREVER);
+
+	win = CLAMP((int32_t)conn->recv_win + delta, 0,
+		    (int32_t)conn->recv_win_max);
+
+	if (win == 0 && conn->recv_win > 0) {
+		net_stats_update_rcvwnd_zero(conn->iface);
+	}
+
+	/* Tell the peer when the window opens again by a full segment or
+	 * half of the buffer, a smaller update would only make it send
+	 * small segments (RFC 1122 chapter 4.2.3.3).
+	 */
+	thresh = MIN(net_tcp_get_recv_mss(conn), conn->recv_win_max / 2U);
+
+	if (conn->recv_win < thresh && win >= thresh) {
+		conn->recv_win = win;
+
+		if (conn->state == TCP_ESTABLISHED) {
+			tcp_out(conn, ACK);
+		}
+	} else {
+		conn->recv_win = win;
+	}
+
+	k_mutex_unlock(&conn->lock);
+
+	return 0;
+}
+
+/* Changing the receive buffer size moves the window by as much */
+static void tcp_recv_win_set_max(struct tcp *conn, int rcvbuf)
+{
+	uint32_t max = rcvbuf ? rcvbuf : tcp_window;
+	int32_t used = conn->recv_win_max - conn->recv_win;
+
+	conn->recv_win_max = max;
+	conn->recv_win = MAX((int32_t)max - used, 0);
+}
+
+int net_tcp_set_option(struct net_context *context,
+		       enum net_context_option option,
+		       const void *value, size_t len)
+{
+	struct tcp *conn = context->tcp;
+	bool enable;
+
+	if (!conn) {
+		return -ENOTCONN;
+	}
+
+	if (len != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	enable = *(const int *)value != 0;
+
+	k_mutex_lock(&conn->lock, K_FOREVER);
+
+	switch (option) {
+	case NET_OPT_RCVBUF:
+		tcp_recv_win_set_max(conn, *(const int *)value);
+		k_mutex_unlock(&conn->lock);
+		return 0;
+	case NET_OPT_TCP_NODELAY:
+		conn->nodelay = enable;
+		break;
+	case NET_OPT_TCP_CORK:
+		conn->cork = enable;
+		break;
+	default:
+		k_mutex_unlock(&conn->lock);
+		return -EINVAL;
+	}
+
+	/* Send what is no longer held back, whatever cannot be sent now
+	 * goes out with the next ACK. Clearing TCP_CORK pushes the data out
+	 * regardless of Nagle's algorithm.
+	 */
+	if (conn->state == TCP_ESTABLISHED &&
+	    (option == NET_OPT_TCP_NODELAY) == enable) {
+		bool nodelay = conn->nodelay;
+
+		conn->nodelay = true;
+		(void)tcp_send_queued_data(conn);
+		conn->nodelay = nodelay;
+	}
+
+	k_mutex_unlock(&conn->lock);
+
+	return 0;
+}
+
+int net_tcp_get_option(struct net_context *context,
+		       enum net_context_option option,
+		       void *value, size_t *len)
+{
+	struct tcp *conn = context->tcp;
+	int ret = 0;
+
+	if (!conn) {
+		return -ENOTCONN;
+	}
+
+	if (len && *len < sizeof(int)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&conn->lock, K_FOREVER);
+
+	switch (option) {
+	case NET_OPT_TCP_NODELAY:
+		*(int *)value = conn->nodelay;
+		break;
+	case NET_OPT_TCP_CORK:
+		*(int *)value = conn->cork;
+		break;
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	k_mutex_unlock(&conn->lock);
+
+	if (ret == 0 && len) {
+		*len = sizeof(int);
+	}
+
+	return ret;
 }
 
 /* net_context queues the outgoing data for the TCP connection */
@@ -2119,6 +3029,27 @@ int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 		goto out;
 	}
 
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+	/* The data queued, sent or not, is limited by the send buffer */
+	if (context->options.sndbuf &&
+	    conn->send_data_total >= context->options.sndbuf) {
+		net_stats_update_sndbuf_full(conn->iface);
+		ret = -EAGAIN;
+		goto out;
+	}
+#endif
+
+	/* Do not queue more than a window worth of data while the
+	 * congestion window or a retransmission holds it back, the ACKs
+	 * of the data in flight will let it go again.
+	 */
+	if (conn->send_data_total >= conn->send_win &&
+	    (tcp_cwnd_full(conn) ||
+	     conn->data_mode == TCP_DATA_MODE_RESEND)) {
+		ret = -EAGAIN;
+		goto out;
+	}
+
 	len = net_pkt_get_len(pkt);
 
 	if (conn->send_data->buffer) {
@@ -2132,14 +3063,11 @@ int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 	pkt->buffer = NULL;
 
 	ret = tcp_send_queued_data(conn);
-	if (ret < 0 && ret != -ENOBUFS) {
-		tcp_conn_unref(conn);
-		goto out;
-	}
-
-	if (ret == -ENOBUFS) {
+	if (ret < 0) {
 		/* Restore the original data so that we do not resend the pkt
-		 * data multiple times.
+		 * data multiple times, and so that the buffers go back to the
+		 * caller whatever the error. We should not free the pkt, it
+		 * will be freed in net_context.c:context_sendto()
 		 */
 		conn->send_data_total -= len;
 
@@ -2150,12 +3078,15 @@ int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 			pkt->buffer = conn->send_data->buffer;
 			conn->send_data->buffer = NULL;
 		}
-	} else {
-		/* We should not free the pkt if there was an error. It will be
-		 * freed in net_context.c:context_sendto()
-		 */
-		tcp_pkt_unref(pkt);
+
+		if (ret != -ENOBUFS) {
+			tcp_conn_unref(conn);
+		}
+
+		goto out;
 	}
+
+	tcp_pkt_unref(pkt);
 out:
 	k_mutex_unlock(&conn->lock);
 
@@ -2246,6 +3177,10 @@ int net_tcp_connect(struct net_context *context,
 		ret = -EPROTONOSUPPORT;
 	}
 
+	if (ret == 0) {
+		tcp_conn_hash_add(conn);
+	}
+
 	if (!(IS_ENABLED(CONFIG_NET_TEST_PROTOCOL) ||
 	      IS_ENABLED(CONFIG_NET_TEST))) {
 		conn->seq = tcp_init_isn(&conn->src.sa, &conn->dst.sa);
@@ -2395,7 +3330,9 @@ int net_tcp_finalize(struct net_pkt *pkt)
 
 	tcp_hdr->chksum = 0U;
 
-	if (net_if_need_calc_tx_checksum(net_pkt_iface(pkt))) {
+	/* Each segment gets its own checksum once the packet is split */
+	if (net_if_need_calc_tx_checksum(net_pkt_iface(pkt)) &&
+	    !net_pkt_gso_size(pkt)) {
 		tcp_hdr->chksum = net_calc_chksum_tcp(pkt);
 	}
 
@@ -2409,6 +3346,7 @@ struct net_tcp_hdr *net_tcp_input(struct net_pkt *pkt,
 
 	if (IS_ENABLED(CONFIG_NET_TCP_CHECKSUM) &&
 			net_if_need_calc_rx_checksum(net_pkt_iface(pkt)) &&
+			!net_pkt_is_tcp_gro(pkt) &&
 			net_calc_chksum_tcp(pkt) != 0U) {
 		NET_DBG("DROP: checksum mismatch");
 		goto drop;
@@ -2444,6 +3382,7 @@ static enum net_verdict tcp_input(struct net_conn *net_conn,
 			conn = context->tcp;
 			tcp_endpoint_set(&conn->dst, pkt, TCP_EP_SRC);
 			tcp_endpoint_set(&conn->src, pkt, TCP_EP_DST);
+			tcp_conn_hash_add(conn);
 			/* Make an extra reference, the sanity check suite
 			 * will delete the connection explicitly
 			 */
@@ -2565,6 +3504,7 @@ enum net_verdict tp_input(struct net_conn *net_conn,
 				conn = context->tcp;
 				tcp_endpoint_set(&conn->dst, pkt, TCP_EP_SRC);
 				tcp_endpoint_set(&conn->src, pkt, TCP_EP_DST);
+				tcp_conn_hash_add(conn);
 				conn->iface = pkt->iface;
 				tcp_conn_ref(conn);
 			}
@@ -2707,6 +3647,9 @@ uint16_t net_tcp_get_recv_mss(const struct tcp *conn)
 			 */
 			return net_if_get_mtu(iface) - NET_IPV4TCPH_LEN;
 		}
+
+		/* Default MSS when the MTU is not known, RFC 9293 */
+		return NET_IPV4_MTU - NET_IPV4TCPH_LEN;
 #else
 		return 0;
 #endif /* CONFIG_NET_IPV4 */
@@ -2714,20 +3657,17 @@ uint16_t net_tcp_get_recv_mss(const struct tcp *conn)
 #if defined(CONFIG_NET_IPV6)
 	else if (family == AF_INET6) {
 		struct net_if *iface = net_context_get_iface(conn->context);
-		int mss = 0;
 
 		if (iface && net_if_get_mtu(iface) >= NET_IPV6TCPH_LEN) {
 			/* Detect MSS based on interface MTU minus "TCP,IP
-			 * header size"
+			 * header size". It is not raised to the IPv6
+			 * minimum MTU as segments must fit in the MTU of
+			 * links below it too, e.g. the loopback one.
 			 */
-			mss = net_if_get_mtu(iface) - NET_IPV6TCPH_LEN;
-		}
-
-		if (mss < NET_IPV6_MTU) {
-			mss = NET_IPV6_MTU;
+			return net_if_get_mtu(iface) - NET_IPV6TCPH_LEN;
 		}
 
-		return mss;
+		return NET_IPV6_MTU;
 	}
 #endif /* CONFIG_NET_IPV6 */
 
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <string.h>
+#include <zephyr.h>
+#include <net/net_pkt.h>
+#include <net/net_context.h>
+#include "net_private.h"
+#include "tcp_internal.h"
+#include "tcp2_cc.h"
+
+static const struct tcp_cc_ops *const tcp_cc_algorithms[] = {
+#if defined(CONFIG_NET_TCP_CC_DEFAULT_CUBIC)
+	&tcp_cc_cubic,
+	&tcp_cc_newreno,
+#else
+	&tcp_cc_newreno,
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+	&tcp_cc_cubic,
+#endif
+#endif
+};
+
+const struct tcp_cc_ops *tcp_cc_find(const char *name)
+{
+	int i;
+
+	if (name == NULL) {
+		return tcp_cc_algorithms[0];
+	}
+
+	for (i = 0; i < ARRAY_SIZE(tcp_cc_algorithms); i++) {
+		if (strcmp(tcp_cc_algorithms[i]->name, name) == 0) {
+			return tcp_cc_algorithms[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Initial window, RFC 3390 chapter 1 */
+static uint32_t tcp_cc_initial_window(uint32_t mss)
+{
+	/* conn_mss() keeps it there, a zero window would never open */
+	NET_ASSERT(mss >= TCP_MIN_MSS, "Invalid MSS %u", mss);
+
+	if (mss > 2190) {
+		return 2 * mss;
+	} else if (mss > 1095) {
+		return 3 * mss;
+	}
+
+	return 4 * mss;
+}
+
+void tcp_cc_init(struct tcp *conn)
+{
+	struct tcp_cc *cc = &conn->cc;
+
+	if (cc->ops == NULL) {
+		cc->ops = tcp_cc_find(NULL);
+	}
+
+	cc->cwnd = tcp_cc_initial_window(conn_mss(conn));
+	cc->ssthresh = UINT32_MAX;
+	cc->recover = conn->seq;
+	cc->bytes_acked = 0U;
+	cc->dup_acks = 0U;
+	cc->in_recovery = false;
+
+	if (cc->ops->init) {
+		cc->ops->init(conn);
+	}
+
+	NET_DBG("conn: %p %s cwnd=%u", conn, cc->ops->name, cc->cwnd);
+}
+
+bool tcp_cc_ack(struct tcp *conn, uint32_t acked)
+{
+	struct tcp_cc *cc = &conn->cc;
+	uint32_t mss = conn_mss(conn);
+	uint32_t flight = conn->unacked_len + acked;
+
+	cc->dup_acks = 0U;
+
+	if (cc->in_recovery) {
+		if (net_tcp_seq_cmp(conn->seq, cc->recover) >= 0) {
+			/* Full acknowledgment, RFC 6582 chapter 3.2 step 3 */
+			cc->cwnd = MIN(cc->ssthresh,
+				       MAX((uint32_t)conn->unacked_len, mss) +
+				       mss);
+			cc->in_recovery = false;
+			cc->bytes_acked = 0U;
+
+			NET_DBG("conn: %p recovered cwnd=%u", conn, cc->cwnd);
+
+			return false;
+		}
+
+		/* Partial acknowledgment, deflate the window by the amount
+		 * of new data acked and add back one segment for the
+		 * retransmission (RFC 6582 chapter 3.2 step 4).
+		 */
+		cc->cwnd -= MIN(acked, cc->cwnd);
+		if (acked >= mss) {
+			cc->cwnd += mss;
+		}
+
+		cc->cwnd = MAX(cc->cwnd, mss);
+
+		return true;
+	}
+
+	/* Only grow the window if it was what limited the sender */
+	if (flight + mss <= cc->cwnd) {
+		return false;
+	}
+
+	if (cc->cwnd < cc->ssthresh) {
+		/* Slow start, RFC 5681 chapter 3.1 */
+		cc->cwnd += MIN(acked, mss);
+	} else {
+		cc->ops->cong_avoid(conn, acked);
+	}
+
+	return false;
+}
+
+bool tcp_cc_dup_ack(struct tcp *conn)
+{
+	struct tcp_cc *cc = &conn->cc;
+	uint32_t mss = conn_mss(conn);
+
+	if (cc->in_recovery) {
+		/* Each duplicate ACK means a segment has left the network */
+		cc->cwnd += mss;
+		return false;
+	}
+
+	if (++cc->dup_acks != TCP_CC_DUP_ACK_THRESHOLD) {
+		return false;
+	}
+
+	/* Do not enter fast recovery again for losses of data that was
+	 * outstanding when the previous loss was detected.
+	 */
+	if (net_tcp_seq_cmp(conn->seq, cc->recover) < 0) {
+		return false;
+	}
+
+	cc->ssthresh = cc->ops->ssthresh(conn);
+	cc->recover = conn->seq + conn->unacked_len;
+	cc->cwnd = cc->ssthresh + TCP_CC_DUP_ACK_THRESHOLD * mss;
+	cc->in_recovery = true;
+
+	NET_DBG("conn: %p fast retransmit, ssthresh=%u cwnd=%u", conn,
+		cc->ssthresh, cc->cwnd);
+
+	return true;
+}
+
+void tcp_cc_timeout(struct tcp *conn)
+{
+	struct tcp_cc *cc = &conn->cc;
+
+	/* RFC 5681 chapter 3.1, equation (4) and loss window */
+	cc->ssthresh = cc->ops->ssthresh(conn);
+	cc->cwnd = conn_mss(conn);
+	cc->recover = conn->seq + conn->unacked_len;
+	cc->bytes_acked = 0U;
+	cc->dup_acks = 0U;
+	cc->in_recovery = false;
+
+	NET_DBG("conn: %p timeout, ssthresh=%u", conn, cc->ssthresh);
+}
+
+/* NewReno, RFC 5681 and RFC 6582 */
+
+static void newreno_cong_avoid(struct tcp *conn, uint32_t acked)
+{
+	struct tcp_cc *cc = &conn->cc;
+
+	/* One segment per window worth of acked data */
+	cc->bytes_acked += acked;
+	if (cc->bytes_acked >= cc->cwnd) {
+		cc->bytes_acked -= cc->cwnd;
+		cc->cwnd += conn_mss(conn);
+	}
+}
+
+static uint32_t newreno_ssthresh(struct tcp *conn)
+{
+	return MAX((uint32_t)conn->unacked_len / 2U, 2U * conn_mss(conn));
+}
+
+const struct tcp_cc_ops tcp_cc_newreno = {
+	.name = "newreno",
+	.cong_avoid = newreno_cong_avoid,
+	.ssthresh = newreno_ssthresh,
+};
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief TCP congestion control
+ *
+ * The generic part implements slow start, fast retransmit and NewReno
+ * fast recovery (RFC 5681, RFC 6582) on top of the congestion window
+ * in struct tcp_cc. How the window grows in congestion avoidance and
+ * how much it is reduced on a loss is delegated to a pluggable
+ * algorithm described by struct tcp_cc_ops.
+ *
+ * All functions are called with the connection lock held, and the
+ * window is counted in bytes. This header is to be included after
+ * tcp2_priv.h.
+ */
+
+#ifndef TCP2_CC_H
+#define TCP2_CC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of duplicate ACKs that trigger a fast retransmit */
+#define TCP_CC_DUP_ACK_THRESHOLD 3
+
+struct tcp_cc_ops {
+	const char *name;
+
+	/** Connection is established, cwnd and ssthresh are set. Optional. */
+	void (*init)(struct tcp *conn);
+
+	/** Grow cwnd in congestion avoidance, acked bytes were acked */
+	void (*cong_avoid)(struct tcp *conn, uint32_t acked);
+
+	/** Loss detected, return the new slow start threshold */
+	uint32_t (*ssthresh)(struct tcp *conn);
+};
+
+extern const struct tcp_cc_ops tcp_cc_newreno;
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+extern const struct tcp_cc_ops tcp_cc_cubic;
+#endif
+
+/**
+ * @brief Find a congestion control algorithm
+ *
+ * @param name Algorithm name, NULL for the configured default
+ *
+ * @return Algorithm, or NULL if there is none with that name
+ */
+const struct tcp_cc_ops *tcp_cc_find(const char *name);
+
+/**
+ * @brief Reset the congestion state of a connection
+ *
+ * Sets the initial window of RFC 3390 for the current MSS and keeps
+ * the selected algorithm, or selects the default one.
+ *
+ * @param conn TCP connection
+ */
+void tcp_cc_init(struct tcp *conn);
+
+/**
+ * @brief Account for newly acknowledged data
+ *
+ * Called after the acknowledged data has been removed from the send
+ * queue.
+ *
+ * @param conn TCP connection
+ * @param acked Number of newly acknowledged bytes
+ *
+ * @return true if this was a partial ACK during fast recovery and the
+ *         first unacknowledged segment must be retransmitted
+ */
+bool tcp_cc_ack(struct tcp *conn, uint32_t acked);
+
+/**
+ * @brief Account for a duplicate ACK
+ *
+ * @param conn TCP connection
+ *
+ * @return true if the first unacknowledged segment must be fast
+ *         retransmitted
+ */
+bool tcp_cc_dup_ack(struct tcp *conn);
+
+/**
+ * @brief Account for a retransmission timeout
+ *
+ * Must only be called for the first timeout of the same data, before
+ * the unacknowledged data is queued for resending.
+ *
+ * @param conn TCP connection
+ */
+void tcp_cc_timeout(struct tcp *conn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TCP2_CC_H */
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* CUBIC congestion control, RFC 8312.
+ *
+ * The window is a cubic function of the time t since the last
+ * congestion event:
+ *
+ *   W(t) = C * (t - K)^3 + W_max,  K = cbrt(W_max * (1 - beta) / C)
+ *
+ * with C = 0.4 segments/s^3 and beta = 0.7. All of it is computed in
+ * integer arithmetic with t in milliseconds and windows in bytes.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <string.h>
+#include <zephyr.h>
+#include <net/net_pkt.h>
+#include <net/net_context.h>
+#include "net_private.h"
+#include "tcp_internal.h"
+#include "tcp2_cc.h"
+
+/* beta = 7/10 */
+#define CUBIC_BETA_NUM 7U
+#define CUBIC_BETA_DEN 10U
+
+/* 1 / C in ms^3 per segment: 1 / 0.4 * 1000^3 */
+#define CUBIC_INV_C_MS3 2500000000ULL
+
+/* Keeps (t - K)^3 * mss within 63 bits */
+#define CUBIC_MAX_DELTA_MS 50000
+
+static uint32_t cubic_cbrt(uint64_t x)
+{
+	uint64_t b;
+	uint32_t y = 0U;
+	int s;
+
+	for (s = 63; s >= 0; s -= 3) {
+		y <<= 1;
+		b = 3U * (uint64_t)y * (y + 1U) + 1U;
+		if ((x >> s) >= b) {
+			x -= b << s;
+			y++;
+		}
+	}
+
+	return y;
+}
+
+static void cubic_init(struct tcp *conn)
+{
+	memset(&conn->cc.cubic, 0, sizeof(conn->cc.cubic));
+}
+
+static void cubic_epoch_start(struct tcp *conn, uint32_t now)
+{
+	struct tcp_cubic *cubic = &conn->cc.cubic;
+	uint32_t cwnd = conn->cc.cwnd;
+	uint32_t mss = conn_mss(conn);
+
+	NET_ASSERT(mss >= TCP_MIN_MSS, "Invalid MSS %u", mss);
+
+	cubic->epoch_start = MAX(now, 1U);
+	cubic->w_est = cwnd;
+	conn->cc.bytes_acked = 0U;
+
+	if (cwnd < cubic->w_max) {
+		/* K = cbrt((W_max - cwnd) / C), in segments and ms */
+		cubic->k = cubic_cbrt((uint64_t)(cubic->w_max - cwnd) *
+				      CUBIC_INV_C_MS3 / mss);
+		cubic->origin = cubic->w_max;
+	} else {
+		cubic->k = 0U;
+		cubic->origin = cwnd;
+	}
+}
+
+static void cubic_cong_avoid(struct tcp *conn, uint32_t acked)
+{
+	struct tcp_cubic *cubic = &conn->cc.cubic;
+	struct tcp_cc *cc = &conn->cc;
+	uint32_t now = k_uptime_get_32();
+	uint32_t mss = conn_mss(conn);
+	int64_t delta, target;
+	uint32_t inc;
+
+	if (cubic->epoch_start == 0U) {
+		cubic_epoch_start(conn, now);
+	}
+
+	delta = (int64_t)(now - cubic->epoch_start) - cubic->k;
+	delta = CLAMP(delta, -CUBIC_MAX_DELTA_MS, CUBIC_MAX_DELTA_MS);
+
+	target = (int64_t)cubic->origin +
+		 delta * delta * delta * mss / (int64_t)CUBIC_INV_C_MS3;
+
+	/* Do not grow by more than half a window per RTT */
+	target = CLAMP(target, (int64_t)cc->cwnd,
+		       (int64_t)cc->cwnd + cc->cwnd / 2U);
+
+	/* TCP friendly region, RFC 8312 chapter 4.2: a Reno sender with
+	 * the same beta grows by 3 * (1 - beta) / (1 + beta) segments per
+	 * window.
+	 */
+	cubic->w_est += (uint32_t)((uint64_t)acked * mss *
+				   3U * (CUBIC_BETA_DEN - CUBIC_BETA_NUM) /
+				   ((CUBIC_BETA_DEN + CUBIC_BETA_NUM) *
+				    (uint64_t)cc->cwnd));
+	if ((int64_t)cubic->w_est > target) {
+		target = cubic->w_est;
+	}
+
+	/* Spread the increase over the ACKs of one window */
+	cc->bytes_acked += acked;
+	inc = (uint32_t)((target - cc->cwnd) * cc->bytes_acked / cc->cwnd);
+	if (inc > 0U) {
+		cc->cwnd += inc;
+		cc->bytes_acked = 0U;
+	}
+}
+
+static uint32_t cubic_ssthresh(struct tcp *conn)
+{
+	struct tcp_cubic *cubic = &conn->cc.cubic;
+	uint32_t cwnd = conn->cc.cwnd;
+
+	cubic->epoch_start = 0U;
+
+	/* Fast convergence, RFC 8312 chapter 4.6 */
+	if (cwnd < cubic->w_max) {
+		cubic->w_max = (uint32_t)((uint64_t)cwnd *
+					  (CUBIC_BETA_DEN + CUBIC_BETA_NUM) /
+					  (2U * CUBIC_BETA_DEN));
+	} else {
+		cubic->w_max = cwnd;
+	}
+
+	return MAX((uint32_t)((uint64_t)cwnd * CUBIC_BETA_NUM /
+			      CUBIC_BETA_DEN),
+		   2U * conn_mss(conn));
+}
+
+const struct tcp_cc_ops tcp_cc_cubic = {
+	.name = "cubic",
+	.init = cubic_init,
+	.cong_avoid = cubic_cong_avoid,
+	.ssthresh = cubic_ssthresh,
+};
@@ -0,0 +1,455 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <string.h>
+#include <zephyr.h>
+#include <sys/byteorder.h>
+#include <net/net_pkt.h>
+#include <net/net_if.h>
+#include "net_private.h"
+#include "ipv4.h"
+#include "ipv6.h"
+#include "tcp_internal.h"
+
+#define BUF_ALLOC_TIMEOUT K_MSEC(100)
+
+#if defined(CONFIG_NET_TCP_GSO)
+/* Cut the payload off the headers of the packet, so that the packet can be
+ * cloned for every segment and the payload buffers handed over to them.
+ */
+static struct net_buf *gso_cut_payload(struct net_pkt *pkt, size_t hdr_len)
+{
+	struct net_buf *buf = pkt->buffer;
+	struct net_buf *payload;
+
+	while (buf && hdr_len > buf->len) {
+		hdr_len -= buf->len;
+		buf = buf->frags;
+	}
+
+	if (!buf) {
+		return NULL;
+	}
+
+	if (hdr_len == buf->len) {
+		payload = buf->frags;
+		buf->frags = NULL;
+
+		return payload;
+	}
+
+	/* The payload starts in the middle of this buffer */
+	payload = net_pkt_get_frag(pkt, BUF_ALLOC_TIMEOUT);
+	if (!payload) {
+		return NULL;
+	}
+
+	if (net_buf_tailroom(payload) < buf->len - hdr_len) {
+		net_buf_unref(payload);
+		return NULL;
+	}
+
+	net_buf_add_mem(payload, buf->data + hdr_len, buf->len - hdr_len);
+	payload->frags = buf->frags;
+	buf->frags = NULL;
+	buf->len = hdr_len;
+
+	return payload;
+}
+
+/* Move len bytes from the head of the payload to the segment. Only the
+ * buffer the segment ends in is copied from.
+ */
+static int gso_move_payload(struct net_pkt *seg, struct net_buf **payload,
+			    size_t len)
+{
+	struct net_buf *buf;
+
+	while (len > 0U && *payload) {
+		buf = *payload;
+
+		if (buf->len <= len) {
+			*payload = buf->frags;
+			buf->frags = NULL;
+			len -= buf->len;
+		} else {
+			buf = net_pkt_get_frag(seg, BUF_ALLOC_TIMEOUT);
+			if (!buf) {
+				return -ENOBUFS;
+			}
+
+			net_buf_add_mem(buf, (*payload)->data, len);
+			net_buf_pull(*payload, len);
+			len = 0U;
+		}
+
+		net_pkt_append_buffer(seg, buf);
+	}
+
+	return len ? -EINVAL : 0;
+}
+
+static int gso_finalize(struct net_pkt *seg, uint32_t seq, uint8_t flags)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
+	struct net_tcp_hdr *tcp_hdr;
+	int ret;
+
+	net_pkt_cursor_init(seg);
+	net_pkt_set_overwrite(seg, true);
+
+	if (net_pkt_skip(seg, net_pkt_ip_hdr_len(seg) +
+			 net_pkt_ip_opts_len(seg))) {
+		return -ENOBUFS;
+	}
+
+	tcp_hdr = (struct net_tcp_hdr *)net_pkt_get_data(seg, &tcp_access);
+	if (!tcp_hdr) {
+		return -ENOBUFS;
+	}
+
+	sys_put_be32(seq, tcp_hdr->seq);
+	tcp_hdr->flags = flags;
+
+	ret = net_pkt_set_data(seg, &tcp_access);
+	if (ret < 0) {
+		return ret;
+	}
+
+	net_pkt_cursor_init(seg);
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(seg) == AF_INET) {
+		NET_IPV4_HDR(seg)->chksum = 0U;
+		ret = net_ipv4_finalize(seg, IPPROTO_TCP);
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   net_pkt_family(seg) == AF_INET6) {
+		ret = net_ipv6_finalize(seg, IPPROTO_TCP);
+	} else {
+		ret = -EINVAL;
+	}
+
+	net_pkt_set_overwrite(seg, false);
+	net_pkt_cursor_init(seg);
+
+	return ret;
+}
+
+int net_tcp_gso_segment(struct net_pkt *pkt)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
+	uint16_t mss = net_pkt_gso_size(pkt);
+	struct net_tcp_hdr *tcp_hdr;
+	struct net_buf *payload;
+	struct net_pkt *seg;
+	size_t hdr_len, len, seg_len;
+	uint32_t seq;
+	uint8_t flags;
+	int ret;
+
+	net_pkt_trim_buffer(pkt);
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	hdr_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt);
+	if (net_pkt_skip(pkt, hdr_len)) {
+		return -EINVAL;
+	}
+
+	tcp_hdr = (struct net_tcp_hdr *)net_pkt_get_data(pkt, &tcp_access);
+	if (!tcp_hdr) {
+		return -ENOBUFS;
+	}
+
+	hdr_len += (tcp_hdr->offset >> 4) * 4U;
+	seq = sys_get_be32(tcp_hdr->seq);
+	flags = tcp_hdr->flags;
+
+	len = net_pkt_get_len(pkt);
+	if (len <= hdr_len) {
+		return -EINVAL;
+	}
+
+	len -= hdr_len;
+
+	payload = gso_cut_payload(pkt, hdr_len);
+	if (!payload) {
+		return -ENOBUFS;
+	}
+
+	net_pkt_set_overwrite(pkt, false);
+	net_pkt_set_gso_size(pkt, 0U);
+
+	NET_DBG("pkt %p split into %zu segments", pkt,
+		(len + mss - 1U) / mss);
+
+	while (len > 0U) {
+		seg_len = MIN(len, (size_t)mss);
+
+		/* Only the headers are left in the packet */
+		seg = net_pkt_clone(pkt, BUF_ALLOC_TIMEOUT);
+		if (!seg) {
+			ret = -ENOMEM;
+			goto out;
+		}
+
+		ret = gso_move_payload(seg, &payload, seg_len);
+		if (ret < 0) {
+			goto fail;
+		}
+
+		len -= seg_len;
+
+		/* PSH and FIN belong to the last segment */
+		ret = gso_finalize(seg, seq, len ? flags & ~(PSH | FIN) : flags);
+		if (ret < 0) {
+			goto fail;
+		}
+
+		ret = net_send_data(seg);
+		if (ret < 0) {
+			goto fail;
+		}
+
+		seq += seg_len;
+	}
+
+	/* Like a driver does once the packet is sent */
+	net_pkt_unref(pkt);
+
+	return 0;
+
+fail:
+	net_pkt_unref(seg);
+out:
+	NET_DBG("Cannot send segment (%d)", ret);
+
+	if (payload) {
+		net_buf_unref(payload);
+	}
+
+	return ret;
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
+#if defined(CONFIG_NET_TCP_GRO)
+/* Headers of a segment that can be coalesced, they are all in the first
+ * buffer.
+ */
+struct gro_hdrs {
+	union {
+		struct net_ipv4_hdr *ipv4;
+		struct net_ipv6_hdr *ipv6;
+	};
+	struct net_tcp_hdr *tcp;
+	uint16_t hdr_len;
+	uint16_t len;
+};
+
+/* Read the headers of a packet that passed gro_hdrs_check() */
+static void gro_hdrs_get(struct net_pkt *pkt, struct gro_hdrs *hdrs)
+{
+	uint8_t *data = pkt->buffer->data;
+	uint16_t total;
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		hdrs->ipv4 = (struct net_ipv4_hdr *)data;
+		hdrs->tcp = (struct net_tcp_hdr *)(hdrs->ipv4 + 1);
+		total = ntohs(hdrs->ipv4->len);
+		hdrs->hdr_len = sizeof(struct net_ipv4_hdr);
+	} else {
+		hdrs->ipv6 = (struct net_ipv6_hdr *)data;
+		hdrs->tcp = (struct net_tcp_hdr *)(hdrs->ipv6 + 1);
+		total = ntohs(hdrs->ipv6->len) + sizeof(struct net_ipv6_hdr);
+		hdrs->hdr_len = sizeof(struct net_ipv6_hdr);
+	}
+
+	hdrs->hdr_len += (hdrs->tcp->offset >> 4) * 4U;
+	hdrs->len = total - hdrs->hdr_len;
+}
+
+/* Only data segments without IP options, IP extension headers or TCP
+ * flags other than ACK and PSH are coalesced.
+ */
+static bool gro_hdrs_check(struct net_pkt *pkt, struct gro_hdrs *hdrs)
+{
+	struct net_buf *buf = pkt->buffer;
+	size_t ip_len, total, tcp_len;
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		struct net_ipv4_hdr *hdr = (struct net_ipv4_hdr *)buf->data;
+
+		ip_len = sizeof(struct net_ipv4_hdr);
+		if (buf->len < ip_len || hdr->vhl != 0x45 ||
+		    hdr->proto != IPPROTO_TCP || hdr->offset[1] ||
+		    (hdr->offset[0] & ~(NET_IPV4_DF << 5))) {
+			return false;
+		}
+
+		total = ntohs(hdr->len);
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   net_pkt_family(pkt) == AF_INET6) {
+		struct net_ipv6_hdr *hdr = (struct net_ipv6_hdr *)buf->data;
+
+		ip_len = sizeof(struct net_ipv6_hdr);
+		if (buf->len < ip_len || (hdr->vtc & 0xf0) != 0x60 ||
+		    hdr->nexthdr != IPPROTO_TCP) {
+			return false;
+		}
+
+		total = ntohs(hdr->len) + ip_len;
+	} else {
+		return false;
+	}
+
+	if (buf->len < ip_len + sizeof(struct net_tcp_hdr)) {
+		return false;
+	}
+
+	hdrs->tcp = (struct net_tcp_hdr *)(buf->data + ip_len);
+	tcp_len = (hdrs->tcp->offset >> 4) * 4U;
+
+	if (tcp_len < sizeof(struct net_tcp_hdr) ||
+	    buf->len < ip_len + tcp_len || total <= ip_len + tcp_len ||
+	    total > net_pkt_get_len(pkt) ||
+	    (hdrs->tcp->flags & ~PSH) != ACK) {
+		return false;
+	}
+
+	/* Drop the link layer padding, if any */
+	if (total < net_pkt_get_len(pkt)) {
+		net_pkt_update_length(pkt, total);
+		net_pkt_trim_buffer(pkt);
+	}
+
+	net_pkt_set_ip_hdr_len(pkt, ip_len);
+	gro_hdrs_get(pkt, hdrs);
+
+	return true;
+}
+
+static bool gro_chksum_ok(struct net_pkt *pkt)
+{
+	if (!net_if_need_calc_rx_checksum(net_pkt_iface(pkt))) {
+		return true;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET &&
+	    net_calc_chksum_ipv4(pkt) != 0U) {
+		return false;
+	}
+
+	return !IS_ENABLED(CONFIG_NET_TCP_CHECKSUM) ||
+	       net_calc_chksum_tcp(pkt) == 0U;
+}
+
+static bool gro_can_append(struct net_pkt *held, struct gro_hdrs *h,
+			   struct net_pkt *pkt, struct gro_hdrs *n)
+{
+	if (net_pkt_iface(held) != net_pkt_iface(pkt) ||
+	    net_pkt_family(held) != net_pkt_family(pkt) ||
+	    h->hdr_len != n->hdr_len) {
+		return false;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		if (h->ipv4->tos != n->ipv4->tos ||
+		    h->ipv4->ttl != n->ipv4->ttl ||
+		    memcmp(&h->ipv4->src, &n->ipv4->src,
+			   2 * sizeof(struct in_addr))) {
+			return false;
+		}
+	} else if (memcmp(h->ipv6, n->ipv6, sizeof(uint32_t)) ||
+		   h->ipv6->hop_limit != n->ipv6->hop_limit ||
+		   memcmp(&h->ipv6->src, &n->ipv6->src,
+			  2 * sizeof(struct in6_addr))) {
+		return false;
+	}
+
+	/* Same ports, ACK and options, and the next data in sequence */
+	return h->tcp->src_port == n->tcp->src_port &&
+	       h->tcp->dst_port == n->tcp->dst_port &&
+	       !memcmp(h->tcp->ack, n->tcp->ack, sizeof(h->tcp->ack)) &&
+	       !memcmp(h->tcp->optdata, n->tcp->optdata,
+		       (h->tcp->offset >> 4) * 4U -
+		       sizeof(struct net_tcp_hdr)) &&
+	       sys_get_be32(n->tcp->seq) == sys_get_be32(h->tcp->seq) + h->len &&
+	       (size_t)h->hdr_len + h->len + n->len <= UINT16_MAX;
+}
+
+static void gro_append(struct net_pkt *held, struct gro_hdrs *h,
+		       struct net_pkt *pkt, struct gro_hdrs *n)
+{
+	uint16_t len = h->len + n->len;
+	struct net_buf *buf = pkt->buffer;
+
+	net_buf_pull(buf, n->hdr_len);
+	if (!buf->len) {
+		buf = net_buf_frag_del(NULL, buf);
+	}
+
+	pkt->buffer = NULL;
+	net_pkt_append_buffer(held, buf);
+	net_pkt_unref(pkt);
+
+	h->tcp->flags |= n->tcp->flags;
+	memcpy(h->tcp->wnd, n->tcp->wnd, sizeof(h->tcp->wnd));
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(held) == AF_INET) {
+		uint16_t total = htons(h->hdr_len + len);
+
+		h->ipv4->chksum = net_chksum_update16(h->ipv4->chksum,
+						      h->ipv4->len, total);
+		h->ipv4->len = total;
+	} else {
+		h->ipv6->len = htons(h->hdr_len - sizeof(struct net_ipv6_hdr) +
+				     len);
+	}
+
+	h->len = len;
+}
+
+enum net_verdict net_tcp_gro_receive(struct net_tcp_gro *gro,
+				     struct net_pkt *pkt,
+				     struct net_pkt **flush)
+{
+	struct gro_hdrs h, n;
+
+	*flush = NULL;
+
+	if (!gro_hdrs_check(pkt, &n) || !gro_chksum_ok(pkt)) {
+		/* Keep the order of the segments of a connection */
+		*flush = net_tcp_gro_flush(gro);
+		return NET_CONTINUE;
+	}
+
+	/* The TCP checksum is verified, the coalesced one would be wrong */
+	net_pkt_set_tcp_gro(pkt, true);
+
+	if (gro->pkt) {
+		gro_hdrs_get(gro->pkt, &h);
+
+		if (gro_can_append(gro->pkt, &h, pkt, &n)) {
+			gro_append(gro->pkt, &h, pkt, &n);
+
+			if (++gro->segs >= CONFIG_NET_TCP_GRO_MAX_SEGS) {
+				*flush = net_tcp_gro_flush(gro);
+			}
+
+			return NET_OK;
+		}
+
+		*flush = net_tcp_gro_flush(gro);
+	}
+
+	gro->pkt = pkt;
+	gro->segs = 1U;
+
+	return NET_OK;
+}
+#endif /* CONFIG_NET_TCP_GRO */
@@ -110,10 +110,6 @@
 #define conn_ack(_conn, _req) (_conn)->ack += (_req)
 #endif
 
-#define conn_mss(_conn)					\
-	((_conn)->recv_options.mss_found ?		\
-	 (_conn)->recv_options.mss : (uint16_t)NET_IPV6_MTU)
-
 #define conn_state(_conn, _s)						\
 ({									\
 	NET_DBG("%s->%s",						\
@@ -125,7 +121,7 @@
 #define conn_send_data_dump(_conn)                                             \
 	({                                                                     \
 		NET_DBG("conn: %p total=%zd, unacked_len=%d, "                 \
-			"send_win=%hu, mss=%hu",                               \
+			"send_win=%u, mss=%hu",                                \
 			(_conn), net_pkt_get_len((_conn)->send_data),          \
 			conn->unacked_len, conn->send_win,                     \
 			(uint16_t)conn_mss((_conn)));                          \
@@ -141,6 +137,22 @@
 #define TCPOPT_NOP	1
 #define TCPOPT_MAXSEG	2
 #define TCPOPT_WINDOW	3
+#define TCPOPT_SACK_PERM	4
+#define TCPOPT_SACK	5
+#define TCPOPT_TIMESTAMP	8
+
+#define TCPOPT_TIMESTAMP_LEN	10
+#define TCPOPT_TIMESTAMP_SPACE	12 /* With two NOPs for alignment */
+#define TCPOPT_MAX_LEN	40
+
+/* Smallest MSS used whatever the peer announces or the MTU allows, the
+ * segment counts and the congestion window are divided by the MSS.
+ */
+#define TCP_MIN_MSS	64
+
+#define TCP_MAX_WINDOW_SHIFT	14 /* RFC 7323 chapter 2.3 */
+#define TCP_SACK_MAX_BLOCKS	4  /* As many as fit in the options */
+#define TCP_MAX_QUICKACKS	16 /* Segments acked without delay */
 
 enum pkt_addr {
 	TCP_EP_SRC = 1,
@@ -202,15 +214,52 @@ union tcp_endpoint {
 	struct sockaddr_in6 sin6;
 };
 
+struct tcp_sack_block {
+	uint32_t left;  /* First sequence number of the block */
+	uint32_t right; /* Sequence number following the block */
+};
+
 struct tcp_options {
 	uint16_t mss;
 	uint16_t window;
+	uint32_t tsval;
+	uint32_t tsecr;
+#if defined(CONFIG_NET_TCP_SACK)
+	struct tcp_sack_block sacks[TCP_SACK_MAX_BLOCKS];
+	uint8_t sack_count;
+#endif
 	bool mss_found : 1;
 	bool wnd_found : 1;
+	bool sack_perm_found : 1;
+	bool ts_found : 1;
+};
+
+struct tcp_cc_ops;
+
+struct tcp_cubic {
+	uint32_t w_max;       /* Window before the last reduction */
+	uint32_t origin;      /* Window the cubic function plateaus at */
+	uint32_t w_est;       /* Window a Reno sender would have */
+	uint32_t epoch_start; /* Start of the current epoch (ms), 0 if none */
+	uint32_t k;           /* Time from epoch start to origin (ms) */
+};
+
+struct tcp_cc { /* Congestion control state, see tcp2_cc.h */
+	const struct tcp_cc_ops *ops;
+	union {
+		struct tcp_cubic cubic;
+	};
+	uint32_t cwnd;
+	uint32_t ssthresh;
+	uint32_t recover;     /* Highest seq sent when loss was detected */
+	uint32_t bytes_acked; /* Bytes acked since the last window increase */
+	uint8_t dup_acks;
+	bool in_recovery : 1;
 };
 
 struct tcp { /* TCP connection */
 	sys_snode_t next;
+	sys_snode_t hash_node; /* In the lookup table once the ends are set */
 	struct net_context *context;
 	struct net_pkt *send_data;
 	struct net_pkt *queue_recv_data;
@@ -225,10 +274,12 @@ struct tcp { /* TCP connection */
 	struct k_sem connect_sem; /* semaphore for blocking connect */
 	struct k_fifo recv_data;  /* temp queue before passing data to app */
 	struct tcp_options recv_options;
+	struct tcp_cc cc;
 	struct k_work_delayable send_timer;
 	struct k_work_delayable recv_queue_timer;
 	struct k_work_delayable send_data_timer;
 	struct k_work_delayable timewait_timer;
+	struct k_work_delayable ack_timer;
 	union {
 		/* Because FIN and establish timers are never happening
 		 * at the same time, share the timer between them to
@@ -247,12 +298,36 @@ struct tcp { /* TCP connection */
 	enum tcp_data_mode data_mode;
 	uint32_t seq;
 	uint32_t ack;
-	uint16_t recv_win;
-	uint16_t send_win;
+	uint32_t recv_win;
+	uint32_t recv_win_max; /* Receive buffer size, SO_RCVBUF */
+	uint32_t send_win;
+	uint32_t ts_recent;   /* Peer timestamp to echo, RFC 7323 */
+	uint32_t rtt;         /* Last RTT measurement (ms) */
+	uint32_t srtt;        /* Smoothed RTT (ms << 3), 0 if not measured */
+	uint32_t rttvar;      /* RTT variation (ms << 2) */
+	uint32_t rto;         /* Retransmission timeout (ms) */
+	uint32_t rtt_seq;     /* ACK of this seq ends the RTT measurement */
+	uint32_t rtt_start;   /* When the measured segment was sent (ms) */
+	uint32_t rcv_unacked; /* Received bytes we have not acked yet */
+#if defined(CONFIG_NET_TCP_SACK)
+	/* Data the peer has selectively acked, sorted and not overlapping */
+	struct tcp_sack_block sacked[CONFIG_NET_TCP_SACK_SCOREBOARD_SIZE];
+	uint32_t sack_rexmit; /* Data below was retransmitted in recovery */
+	uint8_t sacked_count;
+#endif
 	uint8_t send_data_retries;
+	uint8_t snd_wscale;   /* Shift of the windows the peer sends */
+	uint8_t rcv_wscale;   /* Shift of the windows we send */
+	uint8_t quickacks;    /* ACKs to send without delay */
 	bool in_retransmission : 1;
 	bool in_connect : 1;
 	bool in_close : 1;
+	bool wscale_ok : 1;
+	bool ts_ok : 1;
+	bool sack_ok : 1;
+	bool rtt_pending : 1; /* Measuring RTT of the segment ending at rtt_seq */
+	bool nodelay : 1;     /* Nagle's algorithm disabled */
+	bool cork : 1;        /* Only send full-sized segments */
 };
 
 #define _flags(_fl, _op, _mask, _cond)					\
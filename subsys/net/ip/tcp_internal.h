@@ -47,6 +47,36 @@ static inline uint16_t net_tcp_get_recv_mss(const struct tcp *conn)
 }
 #endif
 
+/**
+ * @brief Returns the size of the data in the segments sent on a connection
+ *
+ * @details Segments must fit in the MTU of our interface whatever the peer
+ * MSS. The timestamps option is in every segment and reduces the data.
+ *
+ * @param conn TCP connection
+ *
+ * @return Maximum Segment Size, at least TCP_MIN_MSS
+ */
+static inline uint16_t conn_mss(const struct tcp *conn)
+{
+	uint16_t mss = NET_IPV6_MTU;
+
+	if (conn->recv_options.mss_found) {
+		mss = conn->recv_options.mss;
+	}
+
+	/* Not known before the connection gets its context */
+	if (conn->context) {
+		mss = MIN(mss, net_tcp_get_recv_mss(conn));
+	}
+
+	if (conn->ts_ok) {
+		mss -= MIN(mss, TCPOPT_TIMESTAMP_SPACE);
+	}
+
+	return MAX(mss, TCP_MIN_MSS);
+}
+
 const char *net_tcp_state_str(enum tcp_state state);
 
 /**
@@ -338,6 +368,66 @@ static inline int net_tcp_update_recv_wnd(struct net_context *context,
 }
 #endif
 
+/**
+ * @brief Set a TCP option of the connection
+ *
+ * @param context Network context
+ * @param option NET_OPT_TCP_NODELAY or NET_OPT_TCP_CORK
+ * @param value Option value, an int that enables the option if non-zero
+ * @param len Option length
+ *
+ * @return 0 on success, -ENOTCONN if there is no TCP context, -EINVAL
+ *         if the option or its length is invalid, -EPROTONOSUPPORT if TCP
+ *         is not supported
+ */
+#if defined(CONFIG_NET_NATIVE_TCP)
+int net_tcp_set_option(struct net_context *context,
+		       enum net_context_option option,
+		       const void *value, size_t len);
+#else
+static inline int net_tcp_set_option(struct net_context *context,
+				     enum net_context_option option,
+				     const void *value, size_t len)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(option);
+	ARG_UNUSED(value);
+	ARG_UNUSED(len);
+
+	return -EPROTONOSUPPORT;
+}
+#endif
+
+/**
+ * @brief Get a TCP option of the connection
+ *
+ * @param context Network context
+ * @param option NET_OPT_TCP_NODELAY or NET_OPT_TCP_CORK
+ * @param value Option value, an int
+ * @param len Option length (returned to caller)
+ *
+ * @return 0 on success, -ENOTCONN if there is no TCP context, -EINVAL
+ *         if the option or its length is invalid, -EPROTONOSUPPORT if TCP
+ *         is not supported
+ */
+#if defined(CONFIG_NET_NATIVE_TCP)
+int net_tcp_get_option(struct net_context *context,
+		       enum net_context_option option,
+		       void *value, size_t *len);
+#else
+static inline int net_tcp_get_option(struct net_context *context,
+				     enum net_context_option option,
+				     void *value, size_t *len)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(option);
+	ARG_UNUSED(value);
+	ARG_UNUSED(len);
+
+	return -EPROTONOSUPPORT;
+}
+#endif
+
 /**
  * @brief Queue a TCP FIN packet if needed to close the socket
  *
@@ -359,6 +449,78 @@ static inline int net_tcp_put(struct net_context *context)
 }
 #endif
 
+/**
+ * @brief Split a TCP packet built for several segments, see
+ * net_pkt_gso_size(), and send the segments with net_send_data().
+ *
+ * @param pkt Network packet, released on success
+ *
+ * @return 0 on success, <0 if not all the segments could be sent
+ */
+#if defined(CONFIG_NET_TCP_GSO)
+int net_tcp_gso_segment(struct net_pkt *pkt);
+#else
+static inline int net_tcp_gso_segment(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return -ENOTSUP;
+}
+#endif
+
+/** TCP segments held back for coalescing by one RX thread */
+struct net_tcp_gro {
+	/** Packet the next segments are appended to */
+	struct net_pkt *pkt;
+	/** Number of segments in it */
+	uint8_t segs;
+};
+
+/**
+ * @brief Coalesce a received TCP segment with the ones held back.
+ *
+ * @param gro Segments held back by the calling RX thread
+ * @param pkt Network packet, after L2 processing
+ * @param flush Set to the packet to pass up before pkt, or NULL
+ *
+ * @return NET_OK if pkt is now held back, NET_CONTINUE if it has to be
+ *         passed up as is
+ */
+#if defined(CONFIG_NET_TCP_GRO)
+enum net_verdict net_tcp_gro_receive(struct net_tcp_gro *gro,
+				     struct net_pkt *pkt,
+				     struct net_pkt **flush);
+#else
+static inline enum net_verdict net_tcp_gro_receive(struct net_tcp_gro *gro,
+						   struct net_pkt *pkt,
+						   struct net_pkt **flush)
+{
+	ARG_UNUSED(gro);
+	ARG_UNUSED(pkt);
+
+	*flush = NULL;
+
+	return NET_CONTINUE;
+}
+#endif
+
+/**
+ * @brief Take the packet held back for coalescing.
+ *
+ * @param gro Segments held back by the calling RX thread
+ *
+ * @return Packet to pass up, or NULL
+ */
+static inline struct net_pkt *net_tcp_gro_flush(struct net_tcp_gro *gro)
+{
+	struct net_pkt *pkt = gro->pkt;
+
+	gro->pkt = NULL;
+	gro->segs = 0U;
+
+	return pkt;
+}
+
 #define NET_TCP_MAX_OPT_SIZE  8
 
 #if defined(CONFIG_NET_NATIVE_TCP)
@@ -487,32 +487,60 @@ int z_vrfy_net_addr_pton(sa_family_t family, const char *src,
 #include <syscalls/net_addr_pton_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+static inline uint32_t chksum_fold(uint64_t sum)
+{
+	sum = (sum & UINT32_MAX) + (sum >> 32);
+	sum = (sum & UINT32_MAX) + (sum >> 32);
+	sum = (sum & UINT16_MAX) + (sum >> 16);
+	sum = (sum & UINT16_MAX) + (sum >> 16);
+
+	return (uint32_t)sum;
+}
+
 static uint16_t calc_chksum(uint16_t sum, const uint8_t *data, size_t len)
 {
-	const uint8_t *end;
-	uint16_t tmp;
+	uint64_t acc = 0U;
+	uint8_t tail[2];
 
-	end = data + len - 1;
+	/* The data is summed as 32-bit words in host byte order, in a
+	 * 64-bit accumulator which cannot overflow for any packet size,
+	 * so the carries are only folded back once at the end. The one's
+	 * complement sum does not depend on the byte order (RFC 1071),
+	 * it is swapped to network byte order once folded.
+	 */
+	while (len >= 16) {
+		acc += UNALIGNED_GET((uint32_t *)data);
+		acc += UNALIGNED_GET((uint32_t *)(data + 4));
+		acc += UNALIGNED_GET((uint32_t *)(data + 8));
+		acc += UNALIGNED_GET((uint32_t *)(data + 12));
 
-	while (data < end) {
-		tmp = (data[0] << 8) + data[1];
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+		data += 16;
+		len -= 16;
+	}
+
+	while (len >= 4) {
+		acc += UNALIGNED_GET((uint32_t *)data);
+
+		data += 4;
+		len -= 4;
+	}
+
+	if (len >= 2) {
+		acc += UNALIGNED_GET((uint16_t *)data);
 
 		data += 2;
+		len -= 2;
 	}
 
-	if (data == end) {
-		tmp = data[0] << 8;
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+	if (len) {
+		/* The last byte is padded with zero */
+		tail[0] = data[0];
+		tail[1] = 0U;
+
+		acc += UNALIGNED_GET((uint16_t *)tail);
 	}
 
-	return sum;
+	return chksum_fold((uint64_t)sum + ntohs(chksum_fold(acc)));
 }
 
 static inline uint16_t pkt_calc_chksum(struct net_pkt *pkt, uint16_t sum)
@@ -18,17 +18,24 @@ LOG_MODULE_REGISTER(net_arp, CONFIG_NET_ARP_LOG_LEVEL);
 #include <net/net_stats.h>
 
 #include "arp.h"
+#include "nbr.h"
 #include "net_private.h"
+#include "route.h"
 
 #define NET_BUF_TIMEOUT K_MSEC(100)
 #define ARP_REQUEST_TIMEOUT (2 * MSEC_PER_SEC)
+#define ARP_ENTRY_TIMEOUT (CONFIG_NET_ARP_ENTRY_TIMEOUT * MSEC_PER_SEC)
+#define ARP_ENTRY_REFRESH_TIME (MIN(CONFIG_NET_ARP_ENTRY_REFRESH_TIME, \
+				    CONFIG_NET_ARP_ENTRY_TIMEOUT) * \
+				MSEC_PER_SEC)
 
 static bool arp_cache_initialized;
 static struct arp_entry arp_entries[CONFIG_NET_ARP_TABLE_SIZE];
 
 static sys_slist_t arp_free_entries;
 static sys_slist_t arp_pending_entries;
-static sys_slist_t arp_table;
+
+NET_NBR_HASH_INIT(arp_table, CONFIG_NET_ARP_HASH_SIZE);
 
 struct k_work_delayable arp_request_timer;
 
@@ -74,28 +81,46 @@ static struct arp_entry *arp_entry_find(sys_slist_t *list,
 	return NULL;
 }
 
-static inline struct arp_entry *arp_entry_find_move_first(struct net_if *iface,
-							  struct in_addr *dst)
+static inline struct arp_entry *arp_entry_find_table(struct net_if *iface,
+						     struct in_addr *dst)
 {
-	sys_snode_t *prev = NULL;
-	struct arp_entry *entry;
-
 	NET_DBG("dst %s", log_strdup(net_sprint_ipv4_addr(dst)));
 
-	entry = arp_entry_find(&arp_table, iface, dst, &prev);
-	if (entry) {
-		/* Let's assume the target is going to be accessed
-		 * more than once here in a short time frame. So we
-		 * place the entry first in position into the table
-		 * in order to reduce subsequent find.
-		 */
-		if (&entry->node != sys_slist_peek_head(&arp_table)) {
-			sys_slist_remove(&arp_table, prev, &entry->node);
-			sys_slist_prepend(&arp_table, &entry->node);
-		}
-	}
+	return arp_entry_find(net_nbr_hash_bucket(&arp_table, dst,
+						  sizeof(struct in_addr)),
+			      iface, dst, NULL);
+}
 
-	return entry;
+static void arp_entry_add_to_table(struct arp_entry *entry)
+{
+	entry->req_start = k_uptime_get_32();
+	entry->probes = 0U;
+	entry->hits = 0U;
+
+	net_nbr_hash_add(&arp_table, &entry->ip, sizeof(struct in_addr),
+			 &entry->node);
+}
+
+static void arp_entry_del_from_table(struct arp_entry *entry)
+{
+	net_nbr_hash_del(&arp_table, &entry->ip, sizeof(struct in_addr),
+			 &entry->node);
+
+	arp_entry_cleanup(entry, false);
+
+	sys_slist_prepend(&arp_free_entries, &entry->node);
+}
+
+static inline bool arp_entry_expired(struct arp_entry *entry, uint32_t now)
+{
+	return ARP_ENTRY_TIMEOUT > 0 &&
+		now - entry->req_start >= ARP_ENTRY_TIMEOUT;
+}
+
+static inline void arp_entry_confirm(struct arp_entry *entry)
+{
+	entry->req_start = k_uptime_get_32();
+	entry->probes = 0U;
 }
 
 static inline
@@ -143,22 +168,32 @@ static struct arp_entry *arp_entry_get_free(void)
 	return CONTAINER_OF(node, struct arp_entry, node);
 }
 
-static struct arp_entry *arp_entry_get_last_from_table(void)
+static struct arp_entry *arp_entry_get_oldest_from_table(void)
 {
-	sys_snode_t *node;
+	uint32_t now = k_uptime_get_32();
+	struct arp_entry *entry, *oldest = NULL;
+	int i;
 
-	/* We assume last entry is the oldest one,
-	 * so is the preferred one to be taken out.
+	/* The entries in use are refreshed before they expire, so the
+	 * one confirmed the longest time ago is the preferred one to be
+	 * taken out.
 	 */
-
-	node = sys_slist_peek_tail(&arp_table);
-	if (!node) {
-		return NULL;
+	for (i = 0; i < arp_table.bucket_count; i++) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&arp_table.buckets[i],
+					     entry, node) {
+			if (!oldest || now - entry->req_start >
+				       now - oldest->req_start) {
+				oldest = entry;
+			}
+		}
 	}
 
-	sys_slist_find_and_remove(&arp_table, node);
+	if (oldest) {
+		net_nbr_hash_del(&arp_table, &oldest->ip,
+				 sizeof(struct in_addr), &oldest->node);
+	}
 
-	return CONTAINER_OF(node, struct arp_entry, node);
+	return oldest;
 }
 
 
@@ -318,10 +353,56 @@ static inline struct net_pkt *arp_prepare(struct net_if *iface,
 	return pkt;
 }
 
+/* Ask the neighbor of an entry close to its expiry to confirm it with a
+ * request sent to its known hardware address. The entry is used as is
+ * meanwhile, so the packets to the neighbor are not held back.
+ */
+static void arp_entry_refresh(struct arp_entry *entry, struct net_pkt *pkt,
+			      uint32_t now)
+{
+	struct net_arp_hdr *hdr;
+	struct in_addr *my_addr;
+	struct net_pkt *req;
+
+	if (ARP_ENTRY_TIMEOUT == 0 ||
+	    now - entry->req_start < ARP_ENTRY_TIMEOUT - ARP_ENTRY_REFRESH_TIME) {
+		return;
+	}
+
+	if (entry->probes &&
+	    now - entry->probe_start < ARP_REQUEST_TIMEOUT) {
+		return;
+	}
+
+	req = arp_prepare(entry->iface, &entry->ip, NULL, pkt, NULL);
+	if (!req) {
+		return;
+	}
+
+	hdr = NET_ARP_HDR(req);
+
+	memcpy(&hdr->dst_hwaddr, &entry->eth, sizeof(struct net_eth_addr));
+	net_pkt_lladdr_dst(req)->addr = hdr->dst_hwaddr.addr;
+
+	my_addr = if_get_addr(entry->iface, NULL);
+	if (my_addr) {
+		net_ipaddr_copy(&hdr->src_ipaddr, my_addr);
+	}
+
+	entry->probe_start = now;
+	entry->probes++;
+
+	NET_DBG("Refreshing ARP entry for %s (request %d)",
+		log_strdup(net_sprint_ipv4_addr(&entry->ip)), entry->probes);
+
+	net_if_queue_tx(entry->iface, req);
+}
+
 struct net_pkt *net_arp_prepare(struct net_pkt *pkt,
 				struct in_addr *request_ip,
 				struct in_addr *current_ip)
 {
+	uint32_t now = k_uptime_get_32();
 	struct arp_entry *entry;
 	struct in_addr *addr;
 
@@ -335,8 +416,13 @@ struct net_pkt *net_arp_prepare(struct net_pkt *pkt,
 	if (!current_ip &&
 	    !net_if_ipv4_addr_mask_cmp(net_pkt_iface(pkt), request_ip)) {
 		struct net_if_ipv4 *ipv4 = net_pkt_iface(pkt)->config.ip.ipv4;
+		struct net_route_entry_ipv4 *route;
 
-		if (ipv4) {
+		route = net_route_ipv4_lookup(net_pkt_iface(pkt), request_ip);
+		if (route) {
+			addr = net_ipv4_is_addr_unspecified(&route->gw) ?
+				request_ip : &route->gw;
+		} else if (ipv4) {
 			addr = &ipv4->gw;
 			if (net_ipv4_is_addr_unspecified(addr)) {
 				NET_ERR("Gateway not set for iface %p",
@@ -354,7 +440,15 @@ struct net_pkt *net_arp_prepare(struct net_pkt *pkt,
 	/* If the destination address is already known, we do not need
 	 * to send any ARP packet.
 	 */
-	entry = arp_entry_find_move_first(net_pkt_iface(pkt), addr);
+	entry = arp_entry_find_table(net_pkt_iface(pkt), addr);
+	if (entry && arp_entry_expired(entry, now)) {
+		NET_DBG("ARP entry for %s expired",
+			log_strdup(net_sprint_ipv4_addr(addr)));
+
+		arp_entry_del_from_table(entry);
+		entry = NULL;
+	}
+
 	if (!entry) {
 		struct net_pkt *req;
 
@@ -364,7 +458,7 @@ struct net_pkt *net_arp_prepare(struct net_pkt *pkt,
 			entry = arp_entry_get_free();
 			if (!entry) {
 				/* Then let's take one from table? */
-				entry = arp_entry_get_last_from_table();
+				entry = arp_entry_get_oldest_from_table();
 			}
 		} else {
 			/* There is a pending already */
@@ -385,6 +479,12 @@ struct net_pkt *net_arp_prepare(struct net_pkt *pkt,
 		return req;
 	}
 
+	entry->hits++;
+
+	if (!current_ip) {
+		arp_entry_refresh(entry, pkt, now);
+	}
+
 	net_pkt_lladdr_src(pkt)->addr =
 		(uint8_t *)net_if_get_link_addr(entry->iface)->addr;
 	net_pkt_lladdr_src(pkt)->len = sizeof(struct net_eth_addr);
@@ -404,10 +504,9 @@ static void arp_gratuitous(struct net_if *iface,
 			   struct in_addr *src,
 			   struct net_eth_addr *hwaddr)
 {
-	sys_snode_t *prev = NULL;
 	struct arp_entry *entry;
 
-	entry = arp_entry_find(&arp_table, iface, src, &prev);
+	entry = arp_entry_find_table(iface, src);
 	if (entry) {
 		NET_DBG("Gratuitous ARP hwaddr %s -> %s",
 			log_strdup(net_sprint_ll_addr(
@@ -434,35 +533,43 @@ static void arp_update(struct net_if *iface,
 
 	entry = arp_entry_get_pending(iface, src);
 	if (!entry) {
-		if (IS_ENABLED(CONFIG_NET_ARP_GRATUITOUS) && gratuitous) {
-			arp_gratuitous(iface, src, hwaddr);
-		}
+		if (gratuitous) {
+			if (IS_ENABLED(CONFIG_NET_ARP_GRATUITOUS)) {
+				arp_gratuitous(iface, src, hwaddr);
+			}
 
-		if (force) {
-			sys_snode_t *prev = NULL;
-			struct arp_entry *entry;
+			return;
+		}
 
-			entry = arp_entry_find(&arp_table, iface, src, &prev);
-			if (entry) {
+		entry = arp_entry_find_table(iface, src);
+		if (entry) {
+			/* The neighbor asked for our address, or replied to
+			 * a refresh request, so it is still there. Any other
+			 * reply is unsolicited and ignored as before, it
+			 * must not redirect the cached address.
+			 */
+			if (force || entry->probes > 0U ||
+			    memcmp(&entry->eth, hwaddr,
+				   sizeof(struct net_eth_addr)) == 0) {
 				memcpy(&entry->eth, hwaddr,
 				       sizeof(struct net_eth_addr));
-			} else {
-				/* Add new entry as it was not found and force
-				 * was set.
-				 */
-				entry = arp_entry_get_free();
-				if (!entry) {
-					/* Then let's take one from table? */
-					entry = arp_entry_get_last_from_table();
-				}
-
-				if (entry) {
-					entry->req_start = k_uptime_get_32();
-					entry->iface = iface;
-					net_ipaddr_copy(&entry->ip, src);
-					memcpy(&entry->eth, hwaddr, sizeof(entry->eth));
-					sys_slist_prepend(&arp_table, &entry->node);
-				}
+				arp_entry_confirm(entry);
+			}
+		} else if (force) {
+			/* Add new entry as it was not found and force
+			 * was set.
+			 */
+			entry = arp_entry_get_free();
+			if (!entry) {
+				/* Then let's take one from table? */
+				entry = arp_entry_get_oldest_from_table();
+			}
+
+			if (entry) {
+				entry->iface = iface;
+				net_ipaddr_copy(&entry->ip, src);
+				memcpy(&entry->eth, hwaddr, sizeof(entry->eth));
+				arp_entry_add_to_table(entry);
 			}
 		}
 
@@ -484,7 +591,7 @@ static void arp_update(struct net_if *iface,
 	memcpy(&entry->eth, hwaddr, sizeof(struct net_eth_addr));
 
 	/* Inserting entry into the table */
-	sys_slist_prepend(&arp_table, &entry->node);
+	arp_entry_add_to_table(entry);
 
 	net_if_queue_tx(iface, pkt);
 }
@@ -674,21 +781,28 @@ enum net_verdict net_arp_input(struct net_pkt *pkt,
 
 void net_arp_clear_cache(struct net_if *iface)
 {
-	sys_snode_t *prev = NULL;
+	sys_snode_t *prev;
 	struct arp_entry *entry, *next;
+	int i;
 
 	NET_DBG("Flushing ARP table");
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&arp_table, entry, next, node) {
-		if (iface && iface != entry->iface) {
-			prev = &entry->node;
-			continue;
-		}
+	for (i = 0; i < arp_table.bucket_count; i++) {
+		sys_slist_t *bucket = &arp_table.buckets[i];
 
-		arp_entry_cleanup(entry, false);
+		prev = NULL;
 
-		sys_slist_remove(&arp_table, prev, &entry->node);
-		sys_slist_prepend(&arp_free_entries, &entry->node);
+		SYS_SLIST_FOR_EACH_CONTAINER_SAFE(bucket, entry, next, node) {
+			if (iface && iface != entry->iface) {
+				prev = &entry->node;
+				continue;
+			}
+
+			arp_entry_cleanup(entry, false);
+
+			sys_slist_remove(bucket, prev, &entry->node);
+			sys_slist_prepend(&arp_free_entries, &entry->node);
+		}
 	}
 
 	prev = NULL;
@@ -717,10 +831,14 @@ int net_arp_foreach(net_arp_cb_t cb, void *user_data)
 {
 	int ret = 0;
 	struct arp_entry *entry;
+	int i;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&arp_table, entry, node) {
-		ret++;
-		cb(entry, user_data);
+	for (i = 0; i < arp_table.bucket_count; i++) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&arp_table.buckets[i],
+					     entry, node) {
+			ret++;
+			cb(entry, user_data);
+		}
 	}
 
 	return ret;
@@ -736,7 +854,7 @@ void net_arp_init(void)
 
 	sys_slist_init(&arp_free_entries);
 	sys_slist_init(&arp_pending_entries);
-	sys_slist_init(&arp_table);
+	net_nbr_hash_init(&arp_table);
 
 	for (i = 0; i < CONFIG_NET_ARP_TABLE_SIZE; i++) {
 		/* Inserting entry as free */
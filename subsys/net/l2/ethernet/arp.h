@@ -51,13 +51,22 @@ enum net_verdict net_arp_input(struct net_pkt *pkt,
 
 struct arp_entry {
 	sys_snode_t node;
+	/* Time of the request while pending, of the last confirmation
+	 * by the neighbor once in the table.
+	 */
 	uint32_t req_start;
+	/* Time of the last unicast request refreshing the entry */
+	uint32_t probe_start;
+	/* Number of packets sent using the entry */
+	uint32_t hits;
 	struct net_if *iface;
 	struct in_addr ip;
 	union {
 		struct net_pkt *pending;
 		struct net_eth_addr eth;
 	};
+	/* Refresh requests sent since the last confirmation */
+	uint8_t probes;
 };
 
 typedef void (*net_arp_cb_t)(struct arp_entry *entry,
@@ -502,20 +502,44 @@ static void set_vlan_priority(struct ethernet_context *ctx,
 #define set_vlan_priority(...)
 #endif /* CONFIG_NET_VLAN */
 
+static size_t ethernet_hdr_len(struct ethernet_context *ctx,
+			       struct net_pkt *pkt)
+{
+	if (IS_ENABLED(CONFIG_NET_VLAN) &&
+	    net_eth_is_vlan_enabled(ctx, net_pkt_iface(pkt))) {
+		return sizeof(struct net_eth_vlan_hdr);
+	}
+
+	return sizeof(struct net_eth_hdr);
+}
+
 static struct net_buf *ethernet_fill_header(struct ethernet_context *ctx,
 					    struct net_pkt *pkt,
 					    uint32_t ptype)
 {
+	size_t hdr_len = ethernet_hdr_len(ctx, pkt);
 	struct net_buf *hdr_frag;
 	struct net_eth_hdr *hdr;
 
-	hdr_frag = net_pkt_get_frag(pkt, NET_BUF_TIMEOUT);
-	if (!hdr_frag) {
-		return NULL;
+	/* Write the header in the headroom of the first buffer if there is
+	 * some, unless the buffer is shared with another packet.
+	 */
+	if (IS_ENABLED(CONFIG_NET_PKT_L2_HEADROOM) && pkt->buffer &&
+	    pkt->buffer->ref == 1 &&
+	    net_buf_headroom(pkt->buffer) >= hdr_len) {
+		hdr_frag = pkt->buffer;
+		net_buf_push(hdr_frag, hdr_len);
+	} else {
+		hdr_frag = net_pkt_get_frag(pkt, NET_BUF_TIMEOUT);
+		if (!hdr_frag) {
+			return NULL;
+		}
+
+		net_buf_add(hdr_frag, hdr_len);
+		net_pkt_frag_insert(pkt, hdr_frag);
 	}
 
-	if (IS_ENABLED(CONFIG_NET_VLAN) &&
-	    net_eth_is_vlan_enabled(ctx, net_pkt_iface(pkt))) {
+	if (hdr_len == sizeof(struct net_eth_vlan_hdr)) {
 		struct net_eth_vlan_hdr *hdr_vlan;
 
 		hdr_vlan = (struct net_eth_vlan_hdr *)(hdr_frag->data);
@@ -533,11 +557,10 @@ static struct net_buf *ethernet_fill_header(struct ethernet_context *ctx,
 		hdr_vlan->type = ptype;
 		hdr_vlan->vlan.tpid = htons(NET_ETH_PTYPE_VLAN);
 		hdr_vlan->vlan.tci = htons(net_pkt_vlan_tci(pkt));
-		net_buf_add(hdr_frag, sizeof(struct net_eth_vlan_hdr));
 
 		print_vlan_ll_addrs(pkt, ntohs(hdr_vlan->type),
 				    net_pkt_vlan_tci(pkt),
-				    hdr_frag->len,
+				    hdr_len,
 				    &hdr_vlan->src, &hdr_vlan->dst, false);
 	} else {
 		hdr = (struct net_eth_hdr *)(hdr_frag->data);
@@ -553,14 +576,11 @@ static struct net_buf *ethernet_fill_header(struct ethernet_context *ctx,
 		       sizeof(struct net_eth_addr));
 
 		hdr->type = ptype;
-		net_buf_add(hdr_frag, sizeof(struct net_eth_hdr));
 
 		print_ll_addrs(pkt, ntohs(hdr->type),
-			       hdr_frag->len, &hdr->src, &hdr->dst);
+			       hdr_len, &hdr->src, &hdr->dst);
 	}
 
-	net_pkt_frag_insert(pkt, hdr_frag);
-
 	return hdr_frag;
 }
 
@@ -582,12 +602,22 @@ static void ethernet_update_tx_stats(struct net_if *iface, struct net_pkt *pkt)
 #define ethernet_update_tx_stats(...)
 #endif /* CONFIG_NET_STATISTICS_ETHERNET */
 
-static void ethernet_remove_l2_header(struct net_pkt *pkt)
+static void ethernet_remove_l2_header(struct ethernet_context *ctx,
+				      struct net_pkt *pkt)
 {
+	size_t hdr_len = ethernet_hdr_len(ctx, pkt);
 	struct net_buf *buf;
 
-	/* Remove the buffer added in ethernet_fill_header() */
+	/* The header was either written in front of the data of the first
+	 * buffer, which then holds more than the header, or in a buffer of
+	 * its own added in ethernet_fill_header().
+	 */
 	buf = pkt->buffer;
+	if (IS_ENABLED(CONFIG_NET_PKT_L2_HEADROOM) && buf->len > hdr_len) {
+		net_buf_pull(buf, hdr_len);
+		return;
+	}
+
 	pkt->buffer = buf->frags;
 	buf->frags = NULL;
 
@@ -713,14 +743,14 @@ send:
 	ret = net_l2_send(api->send, net_if_get_device(iface), iface, pkt);
 	if (ret != 0) {
 		eth_stats_update_errors_tx(iface);
-		ethernet_remove_l2_header(pkt);
+		ethernet_remove_l2_header(ctx, pkt);
 		goto error;
 	}
 
 	ethernet_update_tx_stats(iface, pkt);
 
 	ret = net_pkt_get_len(pkt);
-	ethernet_remove_l2_header(pkt);
+	ethernet_remove_l2_header(ctx, pkt);
 
 	net_pkt_unref(pkt);
 error:
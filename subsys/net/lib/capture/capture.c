@@ -509,7 +509,7 @@ static int capture_disable(const struct device *dev)
 	return 0;
 }
 
-void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt)
+void net_capture_tunnel_pkt(struct net_if *iface, struct net_pkt *pkt)
 {
 	struct k_mem_slab *orig_slab;
 	struct net_pkt *captured;
@@ -0,0 +1,903 @@
+/** @file
+ * @brief Network packet capture to a ring buffer in memory.
+ *
+ * The captured packets are stored one after the other in a byte ring,
+ * each after a small header, and the oldest ones are overwritten when the
+ * ring is full. The filter is compiled once to a list of primitives that
+ * are evaluated on the packet headers before anything is copied.
+ */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_capture_ring, CONFIG_NET_CAPTURE_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/byteorder.h>
+#include <net/net_core.h>
+#include <net/net_ip.h>
+#include <net/net_if.h>
+#include <net/net_l2.h>
+#include <net/net_pkt.h>
+#include <net/ethernet.h>
+#include <net/capture.h>
+
+#if defined(CONFIG_FILE_SYSTEM)
+#include <fs/fs.h>
+#endif
+
+/* pcapng block types, see draft-ietf-opsawg-pcapng */
+#define PCAPNG_SHB		0x0A0D0D0AU
+#define PCAPNG_IDB		0x00000001U
+#define PCAPNG_EPB		0x00000006U
+#define PCAPNG_BYTE_ORDER_MAGIC	0x1A2B3C4DU
+
+#define LINKTYPE_ETHERNET		1
+#define LINKTYPE_RAW			101
+#define LINKTYPE_IEEE802_15_4_NOFCS	230
+
+#define RING_SIZE ROUND_DOWN(CONFIG_NET_CAPTURE_RING_SIZE, 4)
+
+/* Ethernet header with a VLAN tag, IPv4 header with options, ports */
+#define FILTER_HDR_LEN (sizeof(struct net_eth_hdr) + 4 + 60 + 4)
+
+#define DIR_SRC BIT(0)
+#define DIR_DST BIT(1)
+
+struct capture_rec {
+	/** Capture time in microseconds */
+	uint32_t ts_high;
+	uint32_t ts_low;
+
+	/** Length of the packet */
+	uint32_t len;
+
+	/** Number of bytes stored after this header */
+	uint16_t caplen;
+
+	/** Network interface index */
+	uint8_t ifindex;
+
+	uint8_t reserved;
+};
+
+enum capture_prim {
+	PRIM_ARP,
+	PRIM_FAMILY,
+	PRIM_PROTO,
+	PRIM_PORT,
+	PRIM_NET,
+};
+
+struct capture_term {
+	/** Address of PRIM_NET, the bits after prefix_len are zero */
+	uint8_t addr[sizeof(struct in6_addr)];
+
+	/** Port of PRIM_PORT, protocol of PRIM_PROTO */
+	uint16_t value;
+
+	/** Primitive, enum capture_prim */
+	uint8_t type;
+
+	/** DIR_SRC and / or DIR_DST */
+	uint8_t dir;
+
+	/** Address family, AF_UNSPEC if any */
+	uint8_t family;
+
+	uint8_t prefix_len;
+
+	/** Is the result of the primitive inverted */
+	uint8_t negate : 1;
+
+	/** Does this start an alternative, after "or" */
+	uint8_t alt : 1;
+};
+
+/* What the filter looks at in a packet */
+struct capture_hdrs {
+	const uint8_t *src;
+	const uint8_t *dst;
+	uint16_t src_port;
+	uint16_t dst_port;
+	uint8_t family;
+	uint8_t proto;
+	bool is_arp : 1;
+	bool has_ports : 1;
+};
+
+static const struct {
+	const char *name;
+	uint8_t type;
+	uint8_t family;
+	uint8_t proto;
+} keywords[] = {
+	{ "ip", PRIM_FAMILY, AF_INET, 0 },
+	{ "ip6", PRIM_FAMILY, AF_INET6, 0 },
+	{ "arp", PRIM_ARP, AF_UNSPEC, 0 },
+	{ "tcp", PRIM_PROTO, AF_UNSPEC, IPPROTO_TCP },
+	{ "udp", PRIM_PROTO, AF_UNSPEC, IPPROTO_UDP },
+	{ "icmp", PRIM_PROTO, AF_INET, IPPROTO_ICMP },
+	{ "icmp6", PRIM_PROTO, AF_INET6, IPPROTO_ICMPV6 },
+};
+
+/* Serializes the API calls, the packets are captured under the spinlock */
+static K_MUTEX_DEFINE(lock);
+static struct k_spinlock ring_lock;
+
+static uint8_t ring[RING_SIZE] __aligned(4);
+
+/* Oldest record, next record and end of the records before the ring
+ * wrapped around. The records are in [head, tail) if tail > head, else in
+ * [head, wrap) and [0, tail).
+ */
+static uint32_t ring_head;
+static uint32_t ring_tail;
+static uint32_t ring_wrap = RING_SIZE;
+
+static struct capture_term filter[CONFIG_NET_CAPTURE_RING_FILTER_TERMS];
+static uint8_t filter_count;
+
+static struct net_if *capture_iface;
+static struct net_capture_ring_stats stats = {
+	.snaplen = CONFIG_NET_CAPTURE_RING_SNAPLEN,
+};
+
+static inline uint32_t rec_size(uint16_t caplen)
+{
+	return ROUND_UP(sizeof(struct capture_rec) + caplen, 4);
+}
+
+static uint32_t ring_next(uint32_t offset)
+{
+	struct capture_rec *rec = (struct capture_rec *)&ring[offset];
+
+	offset += rec_size(rec->caplen);
+	if (offset == ring_wrap) {
+		offset = 0U;
+	}
+
+	return offset;
+}
+
+static void ring_drop_oldest(void)
+{
+	struct capture_rec *rec = (struct capture_rec *)&ring[ring_head];
+
+	stats.used -= rec_size(rec->caplen);
+	stats.count--;
+	stats.overwritten++;
+
+	ring_head = ring_next(ring_head);
+	if (ring_head == 0U) {
+		ring_wrap = RING_SIZE;
+	}
+}
+
+/* Room for a record at the tail, the oldest records are dropped if needed */
+static struct capture_rec *ring_reserve(uint32_t size)
+{
+	struct capture_rec *rec;
+
+	while (true) {
+		if (stats.count == 0U) {
+			ring_head = 0U;
+			ring_tail = 0U;
+			ring_wrap = RING_SIZE;
+		}
+
+		if (stats.count == 0U || ring_tail > ring_head) {
+			if (ring_tail + size <= RING_SIZE) {
+				break;
+			}
+
+			ring_wrap = ring_tail;
+			ring_tail = 0U;
+		}
+
+		if (ring_tail + size <= ring_head) {
+			break;
+		}
+
+		ring_drop_oldest();
+	}
+
+	rec = (struct capture_rec *)&ring[ring_tail];
+
+	ring_tail += size;
+	stats.used += size;
+	stats.count++;
+
+	return rec;
+}
+
+static void ring_clear(void)
+{
+	ring_head = 0U;
+	ring_tail = 0U;
+	ring_wrap = RING_SIZE;
+
+	stats.captured = 0U;
+	stats.filtered = 0U;
+	stats.overwritten = 0U;
+	stats.count = 0U;
+	stats.used = 0U;
+}
+
+static uint16_t link_type(struct net_if *iface)
+{
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET)) {
+		return LINKTYPE_ETHERNET;
+	}
+#endif
+
+#if defined(CONFIG_NET_L2_IEEE802154)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(IEEE802154)) {
+		return LINKTYPE_IEEE802_15_4_NOFCS;
+	}
+#endif
+
+	return LINKTYPE_RAW;
+}
+
+static void parse_hdrs(struct net_if *iface, struct net_pkt *pkt,
+		       uint8_t *buf, struct capture_hdrs *hdrs)
+{
+	size_t len, offset = 0;
+	uint16_t type;
+
+	(void)memset(hdrs, 0, sizeof(*hdrs));
+
+	len = net_buf_linearize(buf, FILTER_HDR_LEN, pkt->buffer, 0,
+				FILTER_HDR_LEN);
+
+	switch (link_type(iface)) {
+	case LINKTYPE_ETHERNET:
+		offset = sizeof(struct net_eth_hdr);
+		if (len < offset) {
+			return;
+		}
+
+		type = sys_get_be16(&buf[offset - 2]);
+		if (type == NET_ETH_PTYPE_VLAN) {
+			offset += 4;
+			if (len < offset) {
+				return;
+			}
+
+			type = sys_get_be16(&buf[offset - 2]);
+		}
+
+		if (type == NET_ETH_PTYPE_ARP) {
+			hdrs->is_arp = true;
+			return;
+		}
+
+		if (type != NET_ETH_PTYPE_IP && type != NET_ETH_PTYPE_IPV6) {
+			return;
+		}
+
+		break;
+	case LINKTYPE_RAW:
+		break;
+	default:
+		return;
+	}
+
+	if (len < offset + sizeof(struct net_ipv4_hdr)) {
+		return;
+	}
+
+	switch (buf[offset] >> 4) {
+	case 4:
+		hdrs->family = AF_INET;
+		hdrs->proto = buf[offset + 9];
+		hdrs->src = &buf[offset + 12];
+		hdrs->dst = &buf[offset + 16];
+
+		/* Only the first fragment has the ports */
+		if (sys_get_be16(&buf[offset + 6]) &
+		    NET_IPV4_FRAGH_OFFSET_MASK) {
+			return;
+		}
+
+		offset += (buf[offset] & 0x0f) * 4U;
+		break;
+	case 6:
+		if (len < offset + sizeof(struct net_ipv6_hdr)) {
+			return;
+		}
+
+		hdrs->family = AF_INET6;
+		hdrs->proto = buf[offset + 6];
+		hdrs->src = &buf[offset + 8];
+		hdrs->dst = &buf[offset + 24];
+
+		offset += sizeof(struct net_ipv6_hdr);
+		break;
+	default:
+		return;
+	}
+
+	if ((hdrs->proto == IPPROTO_TCP || hdrs->proto == IPPROTO_UDP) &&
+	    len >= offset + 4) {
+		hdrs->src_port = sys_get_be16(&buf[offset]);
+		hdrs->dst_port = sys_get_be16(&buf[offset + 2]);
+		hdrs->has_ports = true;
+	}
+}
+
+static bool prefix_match(const uint8_t *addr, const uint8_t *prefix,
+			 uint8_t prefix_len)
+{
+	uint8_t len = prefix_len / 8U;
+
+	if (memcmp(addr, prefix, len)) {
+		return false;
+	}
+
+	if (prefix_len % 8U == 0U) {
+		return true;
+	}
+
+	return (addr[len] & (0xff << (8 - prefix_len % 8U))) == prefix[len];
+}
+
+static bool term_match(const struct capture_term *term,
+		       const struct capture_hdrs *hdrs)
+{
+	switch (term->type) {
+	case PRIM_ARP:
+		return hdrs->is_arp;
+	case PRIM_FAMILY:
+		return hdrs->family == term->family;
+	case PRIM_PROTO:
+		return hdrs->family != AF_UNSPEC && hdrs->proto == term->value &&
+			(term->family == AF_UNSPEC ||
+			 term->family == hdrs->family);
+	case PRIM_PORT:
+		return hdrs->has_ports &&
+			(((term->dir & DIR_SRC) &&
+			  hdrs->src_port == term->value) ||
+			 ((term->dir & DIR_DST) &&
+			  hdrs->dst_port == term->value));
+	case PRIM_NET:
+		return hdrs->family == term->family &&
+			(((term->dir & DIR_SRC) &&
+			  prefix_match(hdrs->src, term->addr,
+				       term->prefix_len)) ||
+			 ((term->dir & DIR_DST) &&
+			  prefix_match(hdrs->dst, term->addr,
+				       term->prefix_len)));
+	}
+
+	return false;
+}
+
+/* The alternatives are separated by "or", their primitives are and'ed */
+static bool filter_match(const struct capture_hdrs *hdrs)
+{
+	bool match = true;
+	int i;
+
+	for (i = 0; i < filter_count; i++) {
+		if (filter[i].alt) {
+			if (match) {
+				return true;
+			}
+
+			match = true;
+		}
+
+		if (match && term_match(&filter[i], hdrs) == filter[i].negate) {
+			match = false;
+		}
+	}
+
+	return match;
+}
+
+void net_capture_ring_pkt(struct net_if *iface, struct net_pkt *pkt)
+{
+	uint8_t buf[FILTER_HDR_LEN];
+	struct capture_hdrs hdrs;
+	struct capture_rec *rec;
+	k_spinlock_key_t key;
+	uint64_t timestamp;
+	size_t len;
+
+	/* Do not capture the packets sent by the capture tunnel */
+	if (!stats.is_enabled || net_pkt_is_captured(pkt)) {
+		return;
+	}
+
+	key = k_spin_lock(&ring_lock);
+
+	if (!stats.is_enabled || (capture_iface && capture_iface != iface)) {
+		goto out;
+	}
+
+	if (filter_count) {
+		parse_hdrs(iface, pkt, buf, &hdrs);
+
+		if (!filter_match(&hdrs)) {
+			stats.filtered++;
+			goto out;
+		}
+	}
+
+	len = net_pkt_get_len(pkt);
+	timestamp = k_ticks_to_us_floor64(k_uptime_ticks());
+
+	rec = ring_reserve(rec_size(MIN(len, stats.snaplen)));
+
+	rec->ts_high = timestamp >> 32;
+	rec->ts_low = (uint32_t)timestamp;
+	rec->len = len;
+	rec->caplen = MIN(len, stats.snaplen);
+	rec->ifindex = net_if_get_by_iface(iface);
+
+	(void)net_buf_linearize(rec + 1, rec->caplen, pkt->buffer, 0,
+				rec->caplen);
+
+	stats.captured++;
+
+out:
+	k_spin_unlock(&ring_lock, key);
+}
+
+int net_capture_ring_start(struct net_if *iface, uint16_t snaplen)
+{
+	k_spinlock_key_t key;
+
+	if (snaplen == 0U) {
+		snaplen = CONFIG_NET_CAPTURE_RING_SNAPLEN;
+	}
+
+	if (rec_size(snaplen) > RING_SIZE) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&lock, K_FOREVER);
+	key = k_spin_lock(&ring_lock);
+
+	capture_iface = iface;
+	stats.snaplen = snaplen;
+	stats.is_enabled = true;
+
+	k_spin_unlock(&ring_lock, key);
+	k_mutex_unlock(&lock);
+
+	return 0;
+}
+
+void net_capture_ring_stop(void)
+{
+	k_spinlock_key_t key;
+
+	k_mutex_lock(&lock, K_FOREVER);
+	key = k_spin_lock(&ring_lock);
+
+	stats.is_enabled = false;
+
+	k_spin_unlock(&ring_lock, key);
+	k_mutex_unlock(&lock);
+}
+
+void net_capture_ring_clear(void)
+{
+	k_spinlock_key_t key;
+
+	k_mutex_lock(&lock, K_FOREVER);
+	key = k_spin_lock(&ring_lock);
+
+	ring_clear();
+
+	k_spin_unlock(&ring_lock, key);
+	k_mutex_unlock(&lock);
+}
+
+static const char *next_token(const char **expr, char *token, size_t size)
+{
+	const char *start = *expr;
+	size_t len;
+
+	while (*start == ' ' || *start == '\t') {
+		start++;
+	}
+
+	len = strcspn(start, " \t");
+	*expr = start + len;
+
+	if (len == 0) {
+		return NULL;
+	}
+
+	/* A token too long to be valid is returned empty */
+	if (len >= size) {
+		len = 0;
+	}
+
+	memcpy(token, start, len);
+	token[len] = '\0';
+
+	return token;
+}
+
+static int parse_net(char *str, bool is_host, struct capture_term *term)
+{
+	char *prefix_len = strchr(str, '/');
+	char *end;
+	unsigned long len;
+
+	if (*str == '\0') {
+		return -EINVAL;
+	}
+
+	if (prefix_len) {
+		if (is_host) {
+			return -EINVAL;
+		}
+
+		*prefix_len++ = '\0';
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) &&
+	    net_addr_pton(AF_INET, str, term->addr) == 0) {
+		term->family = AF_INET;
+		term->prefix_len = 32U;
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   net_addr_pton(AF_INET6, str, term->addr) == 0) {
+		term->family = AF_INET6;
+		term->prefix_len = 128U;
+	} else {
+		return -EINVAL;
+	}
+
+	if (prefix_len) {
+		len = strtoul(prefix_len, &end, 10);
+		if (*prefix_len == '\0' || *end != '\0' ||
+		    len > term->prefix_len) {
+			return -EINVAL;
+		}
+
+		term->prefix_len = len;
+
+		/* Only the prefix is compared */
+		if (len % 8U) {
+			term->addr[len / 8U] &= 0xff << (8 - len % 8U);
+			len += 8U;
+		}
+
+		(void)memset(&term->addr[len / 8U], 0,
+			     sizeof(term->addr) - len / 8U);
+	}
+
+	return 0;
+}
+
+static int parse_term(const char **expr, char *token, size_t size,
+		      struct capture_term *term)
+{
+	const char *tok = token;
+	unsigned long port;
+	char *end;
+	int i;
+
+	(void)memset(term, 0, sizeof(*term));
+	term->dir = DIR_SRC | DIR_DST;
+
+	if (!strcmp(tok, "not")) {
+		term->negate = true;
+		tok = next_token(expr, token, size);
+	}
+
+	if (tok && (!strcmp(tok, "src") || !strcmp(tok, "dst"))) {
+		term->dir = tok[0] == 's' ? DIR_SRC : DIR_DST;
+		tok = next_token(expr, token, size);
+	}
+
+	if (!tok) {
+		return -EINVAL;
+	}
+
+	if (!strcmp(tok, "port")) {
+		tok = next_token(expr, token, size);
+		if (!tok) {
+			return -EINVAL;
+		}
+
+		port = strtoul(tok, &end, 10);
+		if (*tok == '\0' || *end != '\0' || port == 0 ||
+		    port > UINT16_MAX) {
+			return -EINVAL;
+		}
+
+		term->type = PRIM_PORT;
+		term->value = port;
+
+		return 0;
+	}
+
+	if (!strcmp(tok, "host") || !strcmp(tok, "net")) {
+		bool is_host = tok[0] == 'h';
+
+		if (!next_token(expr, token, size)) {
+			return -EINVAL;
+		}
+
+		term->type = PRIM_NET;
+
+		return parse_net(token, is_host, term);
+	}
+
+	/* The protocols have no direction */
+	if (term->dir != (DIR_SRC | DIR_DST)) {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(keywords); i++) {
+		if (!strcmp(tok, keywords[i].name)) {
+			term->type = keywords[i].type;
+			term->family = keywords[i].family;
+			term->value = keywords[i].proto;
+
+			return 0;
+		}
+	}
+
+	return -EINVAL;
+}
+
+int net_capture_ring_filter(const char *expr)
+{
+	struct capture_term terms[CONFIG_NET_CAPTURE_RING_FILTER_TERMS];
+	char token[NET_IPV6_ADDR_LEN + sizeof("/128")];
+	k_spinlock_key_t key;
+	int count = 0;
+	bool alt;
+	int ret;
+
+	while (expr && next_token(&expr, token, sizeof(token))) {
+		alt = false;
+
+		if (count > 0) {
+			/* An operator between the primitives */
+			if (!strcmp(token, "or")) {
+				alt = true;
+			} else if (strcmp(token, "and")) {
+				return -EINVAL;
+			}
+
+			if (!next_token(&expr, token, sizeof(token))) {
+				return -EINVAL;
+			}
+		}
+
+		if (count == ARRAY_SIZE(terms)) {
+			return -ENOMEM;
+		}
+
+		ret = parse_term(&expr, token, sizeof(token), &terms[count]);
+		if (ret < 0) {
+			return ret;
+		}
+
+		terms[count++].alt = alt;
+	}
+
+	k_mutex_lock(&lock, K_FOREVER);
+	key = k_spin_lock(&ring_lock);
+
+	memcpy(filter, terms, count * sizeof(terms[0]));
+	filter_count = count;
+
+	k_spin_unlock(&ring_lock, key);
+	k_mutex_unlock(&lock);
+
+	return 0;
+}
+
+void net_capture_ring_stats(struct net_capture_ring_stats *ring_stats)
+{
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&ring_lock);
+
+	*ring_stats = stats;
+	ring_stats->size = RING_SIZE;
+
+	k_spin_unlock(&ring_lock, key);
+}
+
+static int write_block_hdr(net_capture_write_cb_t cb, void *user_data,
+			   uint32_t type, uint32_t len)
+{
+	uint32_t hdr[2] = { type, len };
+
+	return cb(hdr, sizeof(hdr), user_data);
+}
+
+static int write_shb(net_capture_write_cb_t cb, void *user_data)
+{
+	struct {
+		uint32_t magic;
+		uint16_t major;
+		uint16_t minor;
+		uint32_t section_len[2];
+		uint32_t len;
+	} shb = {
+		.magic = PCAPNG_BYTE_ORDER_MAGIC,
+		.major = 1U,
+		.minor = 0U,
+		/* Not specified */
+		.section_len = { UINT32_MAX, UINT32_MAX },
+		.len = 8 + sizeof(shb),
+	};
+	int ret;
+
+	ret = write_block_hdr(cb, user_data, PCAPNG_SHB, shb.len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return cb(&shb, sizeof(shb), user_data);
+}
+
+static int write_idb(net_capture_write_cb_t cb, void *user_data,
+		     struct net_if *iface)
+{
+	struct {
+		uint16_t link_type;
+		uint16_t reserved;
+		uint32_t snaplen;
+		uint32_t len;
+	} idb = {
+		.link_type = link_type(iface),
+		/* The packets may have been captured with different lengths */
+		.snaplen = 0U,
+		.len = 8 + sizeof(idb),
+	};
+	int ret;
+
+	ret = write_block_hdr(cb, user_data, PCAPNG_IDB, idb.len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return cb(&idb, sizeof(idb), user_data);
+}
+
+static int write_epb(net_capture_write_cb_t cb, void *user_data,
+		     struct capture_rec *rec)
+{
+	static const uint8_t padding[3];
+	uint32_t len = 8 + 20 + ROUND_UP(rec->caplen, 4) + 4;
+	uint32_t hdr[5] = {
+		rec->ifindex - 1U,
+		rec->ts_high,
+		rec->ts_low,
+		rec->caplen,
+		rec->len,
+	};
+	int ret;
+
+	ret = write_block_hdr(cb, user_data, PCAPNG_EPB, len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = cb(hdr, sizeof(hdr), user_data);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = cb(rec + 1, rec->caplen, user_data);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (rec->caplen % 4U) {
+		ret = cb(padding, 4 - rec->caplen % 4U, user_data);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return cb(&len, sizeof(len), user_data);
+}
+
+int net_capture_ring_export(net_capture_write_cb_t cb, void *user_data)
+{
+	struct net_if *iface;
+	k_spinlock_key_t key;
+	bool was_enabled;
+	uint32_t offset;
+	int i, ret;
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	/* The ring is not modified while capturing is paused, and the API
+	 * calls that could modify it are waiting for the mutex.
+	 */
+	key = k_spin_lock(&ring_lock);
+	was_enabled = stats.is_enabled;
+	stats.is_enabled = false;
+	k_spin_unlock(&ring_lock, key);
+
+	ret = write_shb(cb, user_data);
+
+	for (i = 1; ret >= 0 && (iface = net_if_get_by_index(i)); i++) {
+		ret = write_idb(cb, user_data, iface);
+	}
+
+	offset = ring_head;
+
+	for (i = 0; ret >= 0 && i < stats.count; i++) {
+		ret = write_epb(cb, user_data,
+				(struct capture_rec *)&ring[offset]);
+		offset = ring_next(offset);
+	}
+
+	key = k_spin_lock(&ring_lock);
+	stats.is_enabled = was_enabled;
+	k_spin_unlock(&ring_lock, key);
+
+	k_mutex_unlock(&lock);
+
+	return ret < 0 ? ret : stats.count;
+}
+
+#if defined(CONFIG_FILE_SYSTEM)
+static int file_write(const void *data, size_t len, void *user_data)
+{
+	ssize_t ret;
+
+	ret = fs_write(user_data, data, len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return ret == len ? 0 : -ENOSPC;
+}
+#endif
+
+int net_capture_ring_save(const char *path)
+{
+#if defined(CONFIG_FILE_SYSTEM)
+	struct fs_file_t file;
+	int ret, err;
+
+	/* There is no way to truncate the file when opening it */
+	(void)fs_unlink(path);
+
+	fs_file_t_init(&file);
+
+	ret = fs_open(&file, path, FS_O_CREATE | FS_O_WRITE);
+	if (ret < 0) {
+		NET_DBG("Cannot open %s (%d)", log_strdup(path), ret);
+		return ret;
+	}
+
+	ret = net_capture_ring_export(file_write, &file);
+
+	err = fs_close(&file);
+	if (ret >= 0 && err < 0) {
+		ret = err;
+	}
+
+	return ret;
+#else
+	ARG_UNUSED(path);
+
+	return -ENOTSUP;
+#endif
+}
@@ -255,6 +255,8 @@ int zsock_close_ctx(struct net_context *ctx)
 
 	zsock_flush_queue(ctx);
 
+	sock_epoll_release(ctx);
+
 	SET_ERRNO(net_context_put(ctx));
 
 	return 0;
@@ -331,6 +333,8 @@ static void zsock_accepted_cb(struct net_context *new_ctx,
 		k_condvar_init(&new_ctx->cond.recv);
 
 		k_fifo_put(&parent->accept_q, new_ctx);
+
+		sock_epoll_notify(parent);
 	}
 }
 
@@ -371,9 +375,10 @@ static void zsock_received_cb(struct net_context *ctx,
 	/* Normal packet */
 	net_pkt_set_eof(pkt, false);
 
-	if (net_context_get_type(ctx) == SOCK_STREAM) {
-		net_context_update_recv_wnd(ctx, -net_pkt_remaining_data(pkt));
-	}
+	/* The data counts against the TCP window or the receive buffer
+	 * until it is read.
+	 */
+	net_context_update_recv_wnd(ctx, -net_pkt_remaining_data(pkt));
 
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
 
@@ -386,6 +391,8 @@ unlock:
 
 	/* Let reader to wake if it was sleeping */
 	(void)k_condvar_signal(&ctx->cond.recv);
+
+	sock_epoll_notify(ctx);
 }
 
 int zsock_bind_ctx(struct net_context *ctx, const struct sockaddr *addr,
@@ -615,9 +622,13 @@ static inline int z_vrfy_zsock_accept(int sock, struct sockaddr *addr,
 #define WAIT_BUFS K_MSEC(100)
 #define MAX_WAIT_BUFS K_SECONDS(10)
 
-ssize_t zsock_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
-			 int flags,
-			 const struct sockaddr *dest_addr, socklen_t addrlen)
+/* Send either the data in buf, or the network buffers in frags as they
+ * are, retrying while the stack is short of buffers.
+ */
+static ssize_t zsock_send_ctx(struct net_context *ctx, const void *buf,
+			      size_t len, struct net_buf *frags, int flags,
+			      const struct sockaddr *dest_addr,
+			      socklen_t addrlen)
 {
 	k_timeout_t timeout = K_FOREVER;
 	uint64_t buf_timeout = 0;
@@ -641,7 +652,11 @@ ssize_t zsock_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
 	}
 
 	while (1) {
-		if (dest_addr) {
+		if (frags) {
+			status = net_context_send_buf(ctx, frags, dest_addr,
+						      addrlen, NULL, timeout,
+						      ctx->user_data);
+		} else if (dest_addr) {
 			status = net_context_sendto(ctx, buf, len, dest_addr,
 						    addrlen, NULL, timeout,
 						    ctx->user_data);
@@ -686,6 +701,13 @@ ssize_t zsock_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
 	return status;
 }
 
+ssize_t zsock_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
+			 int flags,
+			 const struct sockaddr *dest_addr, socklen_t addrlen)
+{
+	return zsock_send_ctx(ctx, buf, len, NULL, flags, dest_addr, addrlen);
+}
+
 ssize_t z_impl_zsock_sendto(int sock, const void *buf, size_t len, int flags,
 			   const struct sockaddr *dest_addr, socklen_t addrlen)
 {
@@ -739,92 +761,202 @@ ssize_t z_impl_zsock_sendmsg(int sock, const struct msghdr *msg, int flags)
 }
 
 #ifdef CONFIG_USERSPACE
-static inline ssize_t z_vrfy_zsock_sendmsg(int sock,
-					   const struct msghdr *msg,
-					   int flags)
+static void user_msghdr_free(struct msghdr *msg_copy)
 {
-	struct msghdr msg_copy;
 	size_t i;
-	int ret;
 
-	Z_OOPS(z_user_from_copy(&msg_copy, (void *)msg, sizeof(msg_copy)));
+	k_free(msg_copy->msg_name);
+	k_free(msg_copy->msg_control);
 
-	msg_copy.msg_name = NULL;
-	msg_copy.msg_control = NULL;
+	if (msg_copy->msg_iov) {
+		for (i = 0; i < msg_copy->msg_iovlen; i++) {
+			k_free(msg_copy->msg_iov[i].iov_base);
+		}
 
-	msg_copy.msg_iov = z_user_alloc_from_copy(msg->msg_iov,
-				       msg->msg_iovlen * sizeof(struct iovec));
-	if (!msg_copy.msg_iov) {
-		errno = ENOMEM;
-		goto fail;
+		k_free(msg_copy->msg_iov);
 	}
+}
 
-	for (i = 0; i < msg->msg_iovlen; i++) {
-		msg_copy.msg_iov[i].iov_base =
-			z_user_alloc_from_copy(msg->msg_iov[i].iov_base,
-					       msg->msg_iov[i].iov_len);
-		if (!msg_copy.msg_iov[i].iov_base) {
-			errno = ENOMEM;
-			goto fail;
+/* Copy a message to send and the buffers it points to from user memory.
+ * The copy is released with user_msghdr_free(), also on failure. -EFAULT
+ * is returned for invalid user memory, the caller oopses after releasing
+ * the copy.
+ */
+static int user_sendmsg_copy(struct msghdr *msg_copy, const struct msghdr *msg)
+{
+	struct msghdr msg_user;
+	size_t iov_size;
+	size_t i;
+
+	memset(msg_copy, 0, sizeof(*msg_copy));
+
+	if (z_user_from_copy(&msg_user, (void *)msg, sizeof(msg_user)) ||
+	    size_mul_overflow(msg_user.msg_iovlen, sizeof(struct iovec),
+			      &iov_size)) {
+		return -EFAULT;
+	}
+
+	*msg_copy = msg_user;
+	msg_copy->msg_name = NULL;
+	msg_copy->msg_control = NULL;
+	msg_copy->msg_iovlen = 0;
+
+	msg_copy->msg_iov = z_user_alloc_from_copy(msg_user.msg_iov, iov_size);
+	if (!msg_copy->msg_iov) {
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < msg_user.msg_iovlen; i++) {
+		void *base = z_user_alloc_from_copy(
+					msg_copy->msg_iov[i].iov_base,
+					msg_copy->msg_iov[i].iov_len);
+
+		if (!base) {
+			return -ENOMEM;
 		}
 
-		msg_copy.msg_iov[i].iov_len = msg->msg_iov[i].iov_len;
+		msg_copy->msg_iov[i].iov_base = base;
+		msg_copy->msg_iovlen++;
 	}
 
-	if (msg->msg_namelen > 0) {
-		msg_copy.msg_name = z_user_alloc_from_copy(msg->msg_name,
-							   msg->msg_namelen);
-		if (!msg_copy.msg_name) {
-			errno = ENOMEM;
-			goto fail;
+	if (msg_user.msg_namelen > 0) {
+		msg_copy->msg_name = z_user_alloc_from_copy(msg_user.msg_name,
+							msg_user.msg_namelen);
+		if (!msg_copy->msg_name) {
+			return -ENOMEM;
 		}
 	}
 
-	if (msg->msg_controllen > 0) {
-		msg_copy.msg_control = z_user_alloc_from_copy(msg->msg_control,
-							  msg->msg_controllen);
-		if (!msg_copy.msg_control) {
-			errno = ENOMEM;
-			goto fail;
+	if (msg_user.msg_controllen > 0) {
+		msg_copy->msg_control =
+			z_user_alloc_from_copy(msg_user.msg_control,
+					       msg_user.msg_controllen);
+		if (!msg_copy->msg_control) {
+			return -ENOMEM;
 		}
 	}
 
-	ret = z_impl_zsock_sendmsg(sock, (const struct msghdr *)&msg_copy,
-				   flags);
+	return 0;
+}
 
-	k_free(msg_copy.msg_name);
-	k_free(msg_copy.msg_control);
+static inline ssize_t z_vrfy_zsock_sendmsg(int sock,
+					   const struct msghdr *msg,
+					   int flags)
+{
+	struct msghdr msg_copy;
+	bool fault;
+	ssize_t ret;
 
-	for (i = 0; i < msg_copy.msg_iovlen; i++) {
-		k_free(msg_copy.msg_iov[i].iov_base);
+	ret = user_sendmsg_copy(&msg_copy, msg);
+	fault = ret == -EFAULT;
+	if (ret < 0) {
+		errno = -ret;
+		ret = -1;
+	} else {
+		ret = z_impl_zsock_sendmsg(sock,
+					   (const struct msghdr *)&msg_copy,
+					   flags);
 	}
 
-	k_free(msg_copy.msg_iov);
+	user_msghdr_free(&msg_copy);
+
+	Z_OOPS(fault);
 
 	return ret;
+}
+#include <syscalls/zsock_sendmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
 
-fail:
-	if (msg_copy.msg_name) {
-		k_free(msg_copy.msg_name);
+/* Same limit for the number of messages per call as in Linux */
+#define MMSG_MAX_VLEN 1024
+
+int z_impl_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	ssize_t ret = 0;
+	unsigned int i;
+	void *obj;
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL || vtable->sendmsg == NULL) {
+		errno = EBADF;
+		return -1;
 	}
 
-	if (msg_copy.msg_control) {
-		k_free(msg_copy.msg_control);
+	vlen = MIN(vlen, MMSG_MAX_VLEN);
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	for (i = 0; i < vlen; i++) {
+		ret = vtable->sendmsg(obj, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[i].msg_len = ret;
 	}
 
-	if (msg_copy.msg_iov) {
-		for (i = 0; i < msg_copy.msg_iovlen; i++) {
-			if (msg_copy.msg_iov[i].iov_base) {
-				k_free(msg_copy.msg_iov[i].iov_base);
-			}
+	k_mutex_unlock(lock);
+
+	/* The error is only reported if no message was sent */
+	return (i > 0 || ret >= 0) ? i : -1;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	struct mmsghdr *msgvec_copy;
+	unsigned int i, copied;
+	bool fault = false;
+	int ret;
+
+	vlen = MIN(vlen, MMSG_MAX_VLEN);
+	if (vlen == 0) {
+		return 0;
+	}
+
+	msgvec_copy = k_calloc(vlen, sizeof(*msgvec_copy));
+	if (!msgvec_copy) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	for (copied = 0; copied < vlen; copied++) {
+		ret = user_sendmsg_copy(&msgvec_copy[copied].msg_hdr,
+					&msgvec[copied].msg_hdr);
+		if (ret < 0) {
+			/* Partially copied, released below */
+			fault = ret == -EFAULT;
+			copied++;
+			errno = -ret;
+			ret = -1;
+			goto out;
 		}
+	}
 
-		k_free(msg_copy.msg_iov);
+	ret = z_impl_zsock_sendmmsg(sock, msgvec_copy, vlen, flags);
+
+	for (i = 0; ret > 0 && i < ret; i++) {
+		fault |= z_user_to_copy(&msgvec[i].msg_len,
+					&msgvec_copy[i].msg_len,
+					sizeof(msgvec[i].msg_len)) != 0;
 	}
 
-	return -1;
+out:
+	for (i = 0; i < copied; i++) {
+		user_msghdr_free(&msgvec_copy[i].msg_hdr);
+	}
+
+	k_free(msgvec_copy);
+
+	Z_OOPS(fault);
+
+	return ret;
 }
-#include <syscalls/zsock_sendmsg_mrsh.c>
+#include <syscalls/zsock_sendmmsg_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
 static int sock_get_pkt_src_addr(struct net_pkt *pkt,
@@ -981,18 +1113,67 @@ static int wait_data(struct net_context *ctx, k_timeout_t *timeout)
 	return 0;
 }
 
+/* Take the unread data out of a received packet for a zero-copy
+ * receive, dropping the headers and anything already read. Buffers that
+ * are shared with another packet are copied first.
+ */
+static int pkt_detach_data(struct net_pkt *pkt, struct net_buf **frags)
+{
+	struct net_pkt *owner = pkt;
+	struct net_buf *frag;
+
+	for (frag = pkt->buffer; frag; frag = frag->frags) {
+		if (frag->ref > 1 || atomic_get(&pkt->atomic_ref) > 1) {
+			owner = net_pkt_clone(pkt, K_NO_WAIT);
+			if (!owner) {
+				return -ENOBUFS;
+			}
+
+			break;
+		}
+	}
+
+	frag = owner->cursor.buf;
+
+	while (owner->buffer != frag) {
+		owner->buffer = net_buf_frag_del(NULL, owner->buffer);
+	}
+
+	if (frag) {
+		net_buf_pull(frag, owner->cursor.pos - frag->data);
+	}
+
+	while (frag && frag->len == 0U) {
+		frag = net_buf_frag_del(NULL, frag);
+	}
+
+	owner->buffer = NULL;
+	net_pkt_cursor_init(owner);
+
+	if (owner != pkt) {
+		net_pkt_unref(owner);
+	}
+
+	*frags = frag;
+
+	return 0;
+}
+
 static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
-				       void *buf,
-				       size_t max_len,
+				       const struct iovec *iov,
+				       size_t iovlen,
+				       struct net_buf **frags,
 				       int flags,
 				       struct sockaddr *src_addr,
-				       socklen_t *addrlen)
+				       socklen_t *addrlen,
+				       int *msg_flags)
 {
 	k_timeout_t timeout = K_FOREVER;
 	size_t recv_len = 0;
-	size_t read_len;
+	size_t read_len = 0;
 	struct net_pkt_cursor backup;
 	struct net_pkt *pkt;
+	size_t i;
 
 	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
 		timeout = K_NO_WAIT;
@@ -1021,6 +1202,10 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 		pkt = k_fifo_peek_head(&ctx->recv_q);
 	} else {
 		pkt = k_fifo_get(&ctx->recv_q, timeout);
+		if (pkt) {
+			net_context_update_recv_wnd(
+				ctx, net_pkt_remaining_data(pkt));
+		}
 	}
 
 	if (!pkt) {
@@ -1072,11 +1257,31 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 	}
 
 	recv_len = net_pkt_remaining_data(pkt);
-	read_len = MIN(recv_len, max_len);
 
-	if (net_pkt_read(pkt, buf, read_len)) {
-		errno = ENOBUFS;
-		goto fail;
+	if (frags) {
+		int ret = pkt_detach_data(pkt, frags);
+
+		if (ret < 0) {
+			errno = -ret;
+			goto fail;
+		}
+
+		read_len = recv_len;
+	}
+
+	for (i = 0; i < iovlen && read_len < recv_len; i++) {
+		size_t len = MIN(recv_len - read_len, iov[i].iov_len);
+
+		if (net_pkt_read(pkt, iov[i].iov_base, len)) {
+			errno = ENOBUFS;
+			goto fail;
+		}
+
+		read_len += len;
+	}
+
+	if (msg_flags && read_len < recv_len) {
+		*msg_flags |= ZSOCK_MSG_TRUNC;
 	}
 
 	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS) &&
@@ -1103,6 +1308,7 @@ fail:
 static inline ssize_t zsock_recv_stream(struct net_context *ctx,
 					void *buf,
 					size_t max_len,
+					struct net_buf **frags,
 					int flags)
 {
 	k_timeout_t timeout = K_FOREVER;
@@ -1173,8 +1379,16 @@ static inline ssize_t zsock_recv_stream(struct net_context *ctx,
 			release_pkt = false;
 		}
 
-		/* Actually copy data to application buffer */
-		if (net_pkt_read(pkt, (uint8_t *)buf + recv_len, read_len)) {
+		if (frags) {
+			/* Hand over the rest of the packet as it is */
+			res = pkt_detach_data(pkt, frags);
+			if (res < 0) {
+				errno = -res;
+				return -1;
+			}
+		} else if (net_pkt_read(pkt, (uint8_t *)buf + recv_len,
+					read_len)) {
+			/* Actually copy data to application buffer */
 			errno = ENOBUFS;
 			return -1;
 		}
@@ -1182,6 +1396,11 @@ static inline ssize_t zsock_recv_stream(struct net_context *ctx,
 		recv_len += read_len;
 
 		if (!(flags & ZSOCK_MSG_PEEK)) {
+			/* Open the window as we go, a MSG_WAITALL read can
+			 * be larger than the window.
+			 */
+			net_context_update_recv_wnd(ctx, read_len);
+
 			if (release_pkt) {
 				/* Finished processing head pkt in
 				 * the fifo. Drop it from there.
@@ -1215,10 +1434,6 @@ static inline ssize_t zsock_recv_stream(struct net_context *ctx,
 		}
 	} while ((recv_len == 0) || (waitall && (recv_len < max_len)));
 
-	if (!(flags & ZSOCK_MSG_PEEK)) {
-		net_context_update_recv_wnd(ctx, recv_len);
-	}
-
 	return recv_len;
 }
 
@@ -1233,9 +1448,12 @@ ssize_t zsock_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
 	}
 
 	if (sock_type == SOCK_DGRAM) {
-		return zsock_recv_dgram(ctx, buf, max_len, flags, src_addr, addrlen);
+		struct iovec iov = { .iov_base = buf, .iov_len = max_len };
+
+		return zsock_recv_dgram(ctx, &iov, 1, NULL, flags, src_addr,
+					addrlen, NULL);
 	} else if (sock_type == SOCK_STREAM) {
-		return zsock_recv_stream(ctx, buf, max_len, flags);
+		return zsock_recv_stream(ctx, buf, max_len, NULL, flags);
 	} else {
 		__ASSERT(0, "Unknown socket type");
 	}
@@ -1243,6 +1461,29 @@ ssize_t zsock_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
 	return 0;
 }
 
+ssize_t zsock_recvmsg_ctx(struct net_context *ctx, struct msghdr *msg,
+			  int flags)
+{
+	msg->msg_controllen = 0;
+	msg->msg_flags = 0;
+
+	if (net_context_get_type(ctx) == SOCK_DGRAM) {
+		return zsock_recv_dgram(ctx, msg->msg_iov, msg->msg_iovlen,
+					NULL, flags, msg->msg_name,
+					msg->msg_name ? &msg->msg_namelen :
+							NULL,
+					&msg->msg_flags);
+	}
+
+	/* Stream data is only received into the first buffer */
+	if (msg->msg_iovlen == 0 || msg->msg_iov[0].iov_len == 0) {
+		return 0;
+	}
+
+	return zsock_recv_stream(ctx, msg->msg_iov[0].iov_base,
+				 msg->msg_iov[0].iov_len, NULL, flags);
+}
+
 ssize_t z_impl_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 			     struct sockaddr *src_addr, socklen_t *addrlen)
 {
@@ -1281,6 +1522,266 @@ ssize_t z_vrfy_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 #include <syscalls/zsock_recvfrom_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+static ssize_t sock_recvmsg(const struct socket_op_vtable *vtable, void *obj,
+			    struct msghdr *msg, int flags)
+{
+	if (vtable->recvmsg) {
+		return vtable->recvmsg(obj, msg, flags);
+	}
+
+	/* Other sockets can only receive into a single buffer */
+	if (msg->msg_iovlen != 1) {
+		errno = ENOTSUP;
+		return -1;
+	}
+
+	msg->msg_controllen = 0;
+	msg->msg_flags = 0;
+
+	return vtable->recvfrom(obj, msg->msg_iov[0].iov_base,
+				msg->msg_iov[0].iov_len, flags, msg->msg_name,
+				msg->msg_name ? &msg->msg_namelen : NULL);
+}
+
+int z_impl_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	ssize_t ret = 0;
+	unsigned int i;
+	void *obj;
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL || vtable->recvfrom == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	vlen = MIN(vlen, MMSG_MAX_VLEN);
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	for (i = 0; i < vlen; i++) {
+		ret = sock_recvmsg(vtable, obj, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[i].msg_len = ret;
+
+		if (flags & ZSOCK_MSG_WAITFORONE) {
+			flags |= ZSOCK_MSG_DONTWAIT;
+		}
+	}
+
+	k_mutex_unlock(lock);
+
+	/* The error is only reported if no message was received */
+	return (i > 0 || ret >= 0) ? i : -1;
+}
+
+#ifdef CONFIG_USERSPACE
+/* Copy a message header to fill from user memory and verify that the
+ * buffers it points to are writable. Only the iovec array is allocated.
+ * -EFAULT is returned for invalid user memory, the caller oopses after
+ * releasing the copy.
+ */
+static int user_recvmsg_copy(struct msghdr *msg_copy, const struct msghdr *msg)
+{
+	struct iovec *iov;
+	size_t iov_size;
+	size_t i;
+
+	if (z_user_from_copy(msg_copy, (void *)msg, sizeof(*msg_copy))) {
+		return -EFAULT;
+	}
+
+	msg_copy->msg_control = NULL;
+
+	if (msg_copy->msg_iovlen == 0) {
+		msg_copy->msg_iov = NULL;
+		return 0;
+	}
+
+	if (size_mul_overflow(msg_copy->msg_iovlen, sizeof(*iov),
+			      &iov_size)) {
+		msg_copy->msg_iov = NULL;
+		return -EFAULT;
+	}
+
+	iov = z_user_alloc_from_copy(msg_copy->msg_iov, iov_size);
+	msg_copy->msg_iov = iov;
+	if (!iov) {
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < msg_copy->msg_iovlen; i++) {
+		if (Z_SYSCALL_MEMORY_WRITE(iov[i].iov_base, iov[i].iov_len)) {
+			return -EFAULT;
+		}
+	}
+
+	if (msg_copy->msg_name &&
+	    Z_SYSCALL_MEMORY_WRITE(msg_copy->msg_name,
+				   msg_copy->msg_namelen)) {
+		return -EFAULT;
+	}
+
+	return 0;
+}
+
+static inline int z_vrfy_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	struct mmsghdr *msgvec_copy;
+	unsigned int i, copied;
+	bool fault = false;
+	int ret;
+
+	vlen = MIN(vlen, MMSG_MAX_VLEN);
+	if (vlen == 0) {
+		return 0;
+	}
+
+	msgvec_copy = k_calloc(vlen, sizeof(*msgvec_copy));
+	if (!msgvec_copy) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	for (copied = 0; copied < vlen; copied++) {
+		ret = user_recvmsg_copy(&msgvec_copy[copied].msg_hdr,
+					&msgvec[copied].msg_hdr);
+		if (ret < 0) {
+			/* Partially copied, released below */
+			fault = ret == -EFAULT;
+			copied++;
+			errno = -ret;
+			ret = -1;
+			goto out;
+		}
+	}
+
+	ret = z_impl_zsock_recvmmsg(sock, msgvec_copy, vlen, flags);
+
+	for (i = 0; ret > 0 && i < ret; i++) {
+		struct msghdr *hdr = &msgvec_copy[i].msg_hdr;
+
+		fault |= z_user_to_copy(&msgvec[i].msg_len,
+					&msgvec_copy[i].msg_len,
+					sizeof(msgvec[i].msg_len)) != 0;
+		fault |= z_user_to_copy(&msgvec[i].msg_hdr.msg_namelen,
+					&hdr->msg_namelen,
+					sizeof(hdr->msg_namelen)) != 0;
+		fault |= z_user_to_copy(&msgvec[i].msg_hdr.msg_controllen,
+					&hdr->msg_controllen,
+					sizeof(hdr->msg_controllen)) != 0;
+		fault |= z_user_to_copy(&msgvec[i].msg_hdr.msg_flags,
+					&hdr->msg_flags,
+					sizeof(hdr->msg_flags)) != 0;
+	}
+
+out:
+	for (i = 0; i < copied; i++) {
+		k_free(msgvec_copy[i].msg_hdr.msg_iov);
+	}
+
+	k_free(msgvec_copy);
+
+	Z_OOPS(fault);
+
+	return ret;
+}
+#include <syscalls/zsock_recvmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+/* The zero-copy calls hand network buffers across, so they only work on
+ * native sockets and are not offered to user mode.
+ */
+static struct net_context *get_native_sock(int sock, struct k_mutex **lock)
+{
+	const struct socket_op_vtable *vtable;
+	void *obj;
+
+	obj = get_sock_vtable(sock, &vtable, lock);
+	if (obj == NULL) {
+		errno = EBADF;
+		return NULL;
+	}
+
+	if (vtable != &sock_fd_op_vtable) {
+		errno = EOPNOTSUPP;
+		return NULL;
+	}
+
+	return obj;
+}
+
+ssize_t zsock_recv_zc(int sock, struct net_buf **frags, int flags,
+		      struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	struct net_context *ctx;
+	struct k_mutex *lock;
+	ssize_t ret;
+
+	*frags = NULL;
+
+	if (flags & (ZSOCK_MSG_PEEK | ZSOCK_MSG_WAITALL)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	ctx = get_native_sock(sock, &lock);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	if (net_context_get_type(ctx) == SOCK_DGRAM) {
+		ret = zsock_recv_dgram(ctx, NULL, 0, frags, flags, src_addr,
+				       addrlen, NULL);
+	} else if (net_context_get_type(ctx) == SOCK_STREAM) {
+		ret = zsock_recv_stream(ctx, NULL, SIZE_MAX, frags, flags);
+	} else {
+		errno = EOPNOTSUPP;
+		ret = -1;
+	}
+
+	k_mutex_unlock(lock);
+
+	return ret;
+}
+
+void zsock_recv_zc_release(struct net_buf *frags)
+{
+	if (frags) {
+		net_buf_unref(frags);
+	}
+}
+
+ssize_t zsock_send_zc(int sock, struct net_buf *frags, int flags,
+		      const struct sockaddr *dest_addr, socklen_t addrlen)
+{
+	struct net_context *ctx;
+	struct k_mutex *lock;
+	ssize_t ret;
+
+	ctx = get_native_sock(sock, &lock);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	ret = zsock_send_ctx(ctx, NULL, 0, frags, flags, dest_addr, addrlen);
+
+	k_mutex_unlock(lock);
+
+	return ret;
+}
+
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
  */
@@ -1680,6 +2181,95 @@ int zsock_getsockopt_ctx(struct net_context *ctx, int level, int optname,
 
 			return 0;
 		}
+
+		case SO_REUSEPORT:
+			if (IS_ENABLED(CONFIG_NET_CONTEXT_REUSEPORT)) {
+				bool reuseport;
+
+				if (*optlen != sizeof(int)) {
+					errno = EINVAL;
+					return -1;
+				}
+
+				ret = net_context_get_option(ctx,
+							     NET_OPT_REUSEPORT,
+							     &reuseport, NULL);
+				if (ret < 0) {
+					errno = -ret;
+					return -1;
+				}
+
+				*(int *)optval = reuseport;
+
+				return 0;
+			}
+
+			break;
+
+		case SO_RCVBUF:
+			if (IS_ENABLED(CONFIG_NET_CONTEXT_RCVBUF)) {
+				if (*optlen != sizeof(int)) {
+					errno = EINVAL;
+					return -1;
+				}
+
+				ret = net_context_get_option(ctx,
+							     NET_OPT_RCVBUF,
+							     optval, NULL);
+				if (ret < 0) {
+					errno = -ret;
+					return -1;
+				}
+
+				return 0;
+			}
+
+			break;
+
+		case SO_SNDBUF:
+			if (IS_ENABLED(CONFIG_NET_CONTEXT_SNDBUF)) {
+				if (*optlen != sizeof(int)) {
+					errno = EINVAL;
+					return -1;
+				}
+
+				ret = net_context_get_option(ctx,
+							     NET_OPT_SNDBUF,
+							     optval, NULL);
+				if (ret < 0) {
+					errno = -ret;
+					return -1;
+				}
+
+				return 0;
+			}
+
+			break;
+		}
+
+		break;
+
+	case IPPROTO_TCP:
+		switch (optname) {
+		case TCP_NODELAY:
+			ret = net_context_get_option(ctx, NET_OPT_TCP_NODELAY,
+						     optval, optlen);
+			if (ret < 0) {
+				errno = -ret;
+				return -1;
+			}
+
+			return 0;
+
+		case TCP_CORK:
+			ret = net_context_get_option(ctx, NET_OPT_TCP_CORK,
+						     optval, optlen);
+			if (ret < 0) {
+				errno = -ret;
+				return -1;
+			}
+
+			return 0;
 		}
 
 		break;
@@ -1740,6 +2330,61 @@ int zsock_setsockopt_ctx(struct net_context *ctx, int level, int optname,
 			 */
 			return 0;
 
+		case SO_REUSEPORT:
+			if (IS_ENABLED(CONFIG_NET_CONTEXT_REUSEPORT)) {
+				bool reuseport;
+
+				if (optlen != sizeof(int)) {
+					errno = EINVAL;
+					return -1;
+				}
+
+				reuseport = *(int *)optval != 0;
+
+				ret = net_context_set_option(ctx,
+							     NET_OPT_REUSEPORT,
+							     &reuseport,
+							     sizeof(reuseport));
+				if (ret < 0) {
+					errno = -ret;
+					return -1;
+				}
+
+				return 0;
+			}
+
+			break;
+
+		case SO_RCVBUF:
+			if (IS_ENABLED(CONFIG_NET_CONTEXT_RCVBUF)) {
+				ret = net_context_set_option(ctx,
+							     NET_OPT_RCVBUF,
+							     optval, optlen);
+				if (ret < 0) {
+					errno = -ret;
+					return -1;
+				}
+
+				return 0;
+			}
+
+			break;
+
+		case SO_SNDBUF:
+			if (IS_ENABLED(CONFIG_NET_CONTEXT_SNDBUF)) {
+				ret = net_context_set_option(ctx,
+							     NET_OPT_SNDBUF,
+							     optval, optlen);
+				if (ret < 0) {
+					errno = -ret;
+					return -1;
+				}
+
+				return 0;
+			}
+
+			break;
+
 		case SO_PRIORITY:
 			if (IS_ENABLED(CONFIG_NET_CONTEXT_PRIORITY)) {
 				ret = net_context_set_option(ctx,
@@ -1900,9 +2545,23 @@ int zsock_setsockopt_ctx(struct net_context *ctx, int level, int optname,
 	case IPPROTO_TCP:
 		switch (optname) {
 		case TCP_NODELAY:
-			/* Ignore for now. Provided to let port
-			 * existing apps.
-			 */
+			ret = net_context_set_option(ctx, NET_OPT_TCP_NODELAY,
+						     optval, optlen);
+			if (ret < 0) {
+				errno = -ret;
+				return -1;
+			}
+
+			return 0;
+
+		case TCP_CORK:
+			ret = net_context_set_option(ctx, NET_OPT_TCP_CORK,
+						     optval, optlen);
+			if (ret < 0) {
+				errno = -ret;
+				return -1;
+			}
+
 			return 0;
 		}
 		break;
@@ -2165,6 +2824,11 @@ static ssize_t sock_recvfrom_vmeth(void *obj, void *buf, size_t max_len,
 				  src_addr, addrlen);
 }
 
+static ssize_t sock_recvmsg_vmeth(void *obj, struct msghdr *msg, int flags)
+{
+	return zsock_recvmsg_ctx(obj, msg, flags);
+}
+
 static int sock_getsockopt_vmeth(void *obj, int level, int optname,
 				 void *optval, socklen_t *optlen)
 {
@@ -2202,6 +2866,7 @@ const struct socket_op_vtable sock_fd_op_vtable = {
 	.sendto = sock_sendto_vmeth,
 	.sendmsg = sock_sendmsg_vmeth,
 	.recvfrom = sock_recvfrom_vmeth,
+	.recvmsg = sock_recvmsg_vmeth,
 	.getsockopt = sock_getsockopt_vmeth,
 	.setsockopt = sock_setsockopt_vmeth,
 	.getsockname = sock_getsockname_vmeth,
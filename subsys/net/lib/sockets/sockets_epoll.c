@@ -0,0 +1,558 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <syscall_handler.h>
+#include <sys/dlist.h>
+#include <sys/slist.h>
+#include <net/socket.h>
+#include "sockets_internal.h"
+
+/* An epoll instance keeps the registered sockets which may have events in
+ * a ready list. Sockets put themselves on it when they receive data (see
+ * sock_epoll_notify()), so epoll_wait() never looks at idle sockets.
+ *
+ * The registrations and ready lists of all the instances are protected
+ * by a single lock. It is taken after the socket lock, never before.
+ */
+__net_socket struct epoll_instance {
+	/* Registrations that may have events to report */
+	sys_dlist_t ready;
+	/* Given when a registration is put on the ready list */
+	struct k_sem wake;
+	bool in_use;
+};
+
+struct epoll_item {
+	/* Node in the epoll_items list of the socket */
+	sys_snode_t ctx_node;
+	/* Node in the ready list of the instance */
+	sys_dnode_t ready_node;
+	/* Owning instance, NULL if the item is free */
+	struct epoll_instance *ep;
+	struct net_context *ctx;
+	struct zsock_epoll_event event;
+};
+
+static struct epoll_instance instances[CONFIG_NET_SOCKETS_EPOLL_INSTANCES];
+static struct epoll_item items[CONFIG_NET_SOCKETS_EPOLL_MAX_FDS];
+
+static K_MUTEX_DEFINE(epoll_lock);
+
+static const struct fd_op_vtable epoll_fd_op_vtable;
+
+#define EPOLL_EVENTS (ZSOCK_EPOLLIN | ZSOCK_EPOLLOUT)
+
+/* Same readiness rules as zsock_poll(). A TCP peer closing the connection
+ * also closes it in our direction, so end of file is a hang up.
+ */
+static uint32_t epoll_ready_events(struct net_context *ctx)
+{
+	/* For now, assume that socket is always writable */
+	uint32_t events = ZSOCK_EPOLLOUT;
+
+	if (!k_fifo_is_empty(&ctx->recv_q)) {
+		events |= ZSOCK_EPOLLIN;
+	}
+
+	if (sock_is_eof(ctx)) {
+		events |= ZSOCK_EPOLLIN | ZSOCK_EPOLLHUP;
+	}
+
+	return events;
+}
+
+/* Events reported for a registration, a hang up is reported without
+ * being requested unless the registration is disabled.
+ */
+static uint32_t epoll_item_events(struct epoll_item *item)
+{
+	if (!(item->event.events & EPOLL_EVENTS)) {
+		return 0U;
+	}
+
+	return (item->event.events & EPOLL_EVENTS) | ZSOCK_EPOLLHUP;
+}
+
+/* Called with epoll_lock held */
+static void epoll_item_arm(struct epoll_item *item)
+{
+	if (!(item->event.events & EPOLL_EVENTS)) {
+		return;
+	}
+
+	if (!sys_dnode_is_linked(&item->ready_node)) {
+		sys_dlist_append(&item->ep->ready, &item->ready_node);
+	}
+
+	k_sem_give(&item->ep->wake);
+}
+
+/* Called with epoll_lock held */
+static void epoll_item_free(struct epoll_item *item)
+{
+	if (sys_dnode_is_linked(&item->ready_node)) {
+		sys_dlist_remove(&item->ready_node);
+	}
+
+	item->ep = NULL;
+	item->ctx = NULL;
+}
+
+static struct epoll_item *epoll_item_find(struct epoll_instance *ep,
+					  struct net_context *ctx)
+{
+	struct epoll_item *item;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&ctx->epoll_items, item, ctx_node) {
+		if (item->ep == ep) {
+			return item;
+		}
+	}
+
+	return NULL;
+}
+
+static struct epoll_item *epoll_item_alloc(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(items); i++) {
+		if (items[i].ep == NULL) {
+			return &items[i];
+		}
+	}
+
+	return NULL;
+}
+
+void sock_epoll_notify(struct net_context *ctx)
+{
+	struct epoll_item *item;
+
+	/* Unwatched sockets are the common case, don't take the lock for
+	 * them. A registration racing with this check looks at the socket
+	 * readiness itself once it is linked.
+	 */
+	if (sys_slist_is_empty(&ctx->epoll_items)) {
+		return;
+	}
+
+	(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&ctx->epoll_items, item, ctx_node) {
+		epoll_item_arm(item);
+	}
+
+	k_mutex_unlock(&epoll_lock);
+}
+
+void sock_epoll_release(struct net_context *ctx)
+{
+	struct epoll_item *item, *next;
+
+	if (sys_slist_is_empty(&ctx->epoll_items)) {
+		return;
+	}
+
+	(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&ctx->epoll_items, item, next,
+					  ctx_node) {
+		epoll_item_free(item);
+	}
+
+	sys_slist_init(&ctx->epoll_items);
+
+	k_mutex_unlock(&epoll_lock);
+}
+
+int z_impl_zsock_epoll_create1(int flags)
+{
+	struct epoll_instance *ep = NULL;
+	int fd, i;
+
+	if (flags != 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	fd = z_reserve_fd();
+	if (fd < 0) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(instances); i++) {
+		if (!instances[i].in_use) {
+			ep = &instances[i];
+			break;
+		}
+	}
+
+	if (ep == NULL) {
+		k_mutex_unlock(&epoll_lock);
+		z_free_fd(fd);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	sys_dlist_init(&ep->ready);
+	k_sem_init(&ep->wake, 0, 1);
+	ep->in_use = true;
+
+	k_mutex_unlock(&epoll_lock);
+
+	z_finalize_fd(fd, ep, &epoll_fd_op_vtable);
+
+	return fd;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_create1(int flags)
+{
+	return z_impl_zsock_epoll_create1(flags);
+}
+#include <syscalls/zsock_epoll_create1_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+int zsock_epoll_create(int size)
+{
+	if (size <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	return zsock_epoll_create1(0);
+}
+
+static int epoll_ctl_add(struct epoll_instance *ep, struct net_context *ctx,
+			 struct zsock_epoll_event *event)
+{
+	struct epoll_item *item;
+
+	if (epoll_item_find(ep, ctx) != NULL) {
+		return -EEXIST;
+	}
+
+	item = epoll_item_alloc();
+	if (item == NULL) {
+		return -ENOMEM;
+	}
+
+	item->ep = ep;
+	item->ctx = ctx;
+	item->event = *event;
+	sys_dnode_init(&item->ready_node);
+	sys_slist_append(&ctx->epoll_items, &item->ctx_node);
+
+	if (epoll_ready_events(ctx) & epoll_item_events(item)) {
+		epoll_item_arm(item);
+	}
+
+	return 0;
+}
+
+static int epoll_ctl_mod(struct epoll_instance *ep, struct net_context *ctx,
+			 struct zsock_epoll_event *event)
+{
+	struct epoll_item *item;
+
+	item = epoll_item_find(ep, ctx);
+	if (item == NULL) {
+		return -ENOENT;
+	}
+
+	item->event = *event;
+
+	if (epoll_ready_events(ctx) & epoll_item_events(item)) {
+		epoll_item_arm(item);
+	}
+
+	return 0;
+}
+
+static int epoll_ctl_del(struct epoll_instance *ep, struct net_context *ctx)
+{
+	struct epoll_item *item;
+
+	item = epoll_item_find(ep, ctx);
+	if (item == NULL) {
+		return -ENOENT;
+	}
+
+	sys_slist_find_and_remove(&ctx->epoll_items, &item->ctx_node);
+	epoll_item_free(item);
+
+	return 0;
+}
+
+int z_impl_zsock_epoll_ctl(int epfd, int op, int fd,
+			   struct zsock_epoll_event *event)
+{
+	const struct fd_op_vtable *vtable;
+	struct epoll_instance *ep;
+	struct net_context *ctx;
+	int ret;
+
+	ep = z_get_fd_obj(epfd, &epoll_fd_op_vtable, EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	ctx = z_get_fd_obj_and_vtable(fd, &vtable, NULL);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	/* Only native sockets report their events */
+	if (vtable != &sock_fd_op_vtable.fd_vtable) {
+		errno = (fd == epfd) ? EINVAL : EPERM;
+		return -1;
+	}
+
+	if (op != ZSOCK_EPOLL_CTL_DEL && event == NULL) {
+		errno = EFAULT;
+		return -1;
+	}
+
+	(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+	switch (op) {
+	case ZSOCK_EPOLL_CTL_ADD:
+		ret = epoll_ctl_add(ep, ctx, event);
+		break;
+	case ZSOCK_EPOLL_CTL_MOD:
+		ret = epoll_ctl_mod(ep, ctx, event);
+		break;
+	case ZSOCK_EPOLL_CTL_DEL:
+		ret = epoll_ctl_del(ep, ctx);
+		break;
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	k_mutex_unlock(&epoll_lock);
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_ctl(int epfd, int op, int fd,
+					 struct zsock_epoll_event *event)
+{
+	struct zsock_epoll_event event_copy;
+
+	if (z_impl_zsock_get_context_object(epfd) == NULL ||
+	    z_impl_zsock_get_context_object(fd) == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (op != ZSOCK_EPOLL_CTL_DEL) {
+		Z_OOPS(z_user_from_copy(&event_copy, event,
+					sizeof(event_copy)));
+		event = &event_copy;
+	}
+
+	return z_impl_zsock_epoll_ctl(epfd, op, fd, event);
+}
+#include <syscalls/zsock_epoll_ctl_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+/* Called with epoll_lock held. Level triggered registrations which had
+ * events go back to the tail of the ready list, so a busy socket cannot
+ * starve the others when maxevents is small. Registrations without
+ * events are dropped until they are notified again.
+ */
+static int epoll_collect(struct epoll_instance *ep,
+			 struct zsock_epoll_event *events, int maxevents)
+{
+	struct epoll_item *item;
+	sys_dlist_t requeue;
+	sys_dnode_t *node;
+	uint32_t revents;
+	int count = 0;
+
+	sys_dlist_init(&requeue);
+
+	while (count < maxevents) {
+		node = sys_dlist_get(&ep->ready);
+		if (node == NULL) {
+			break;
+		}
+
+		item = CONTAINER_OF(node, struct epoll_item, ready_node);
+
+		revents = epoll_ready_events(item->ctx) &
+			  epoll_item_events(item);
+		if (revents == 0U) {
+			continue;
+		}
+
+		events[count].events = revents;
+		events[count].data = item->event.data;
+		count++;
+
+		if (item->event.events & ZSOCK_EPOLLONESHOT) {
+			/* Disabled until re-armed with ZSOCK_EPOLL_CTL_MOD */
+			item->event.events = 0U;
+		} else if (!(item->event.events & ZSOCK_EPOLLET)) {
+			sys_dlist_append(&requeue, node);
+		}
+	}
+
+	while ((node = sys_dlist_get(&requeue)) != NULL) {
+		sys_dlist_append(&ep->ready, node);
+	}
+
+	return count;
+}
+
+int z_impl_zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+			    int maxevents, int timeout)
+{
+	struct epoll_instance *ep;
+	int64_t end = 0;
+	int count;
+
+	ep = z_get_fd_obj(epfd, &epoll_fd_op_vtable, EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	if (maxevents <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (timeout > 0) {
+		end = k_uptime_get() + timeout;
+	}
+
+	/* Events posted from now on are picked up by the next collect or
+	 * make the wait below return immediately.
+	 */
+	k_sem_reset(&ep->wake);
+
+	while (true) {
+		k_timeout_t wait;
+
+		(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+		count = epoll_collect(ep, events, maxevents);
+		k_mutex_unlock(&epoll_lock);
+
+		if (count > 0 || timeout == 0) {
+			break;
+		}
+
+		if (timeout < 0) {
+			wait = K_FOREVER;
+		} else {
+			int64_t left = end - k_uptime_get();
+
+			if (left <= 0) {
+				break;
+			}
+
+			wait = K_MSEC(left);
+		}
+
+		if (k_sem_take(&ep->wake, wait) < 0 && timeout > 0) {
+			break;
+		}
+	}
+
+	return count;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_wait(int epfd,
+					  struct zsock_epoll_event *events,
+					  int maxevents, int timeout)
+{
+	if (z_impl_zsock_get_context_object(epfd) == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (maxevents > 0) {
+		Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(events, maxevents,
+						    sizeof(*events)));
+	}
+
+	return z_impl_zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+#include <syscalls/zsock_epoll_wait_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+static ssize_t epoll_read_vmeth(void *obj, void *buffer, size_t count)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(count);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static ssize_t epoll_write_vmeth(void *obj, const void *buffer, size_t count)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(count);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static int epoll_close_vmeth(void *obj)
+{
+	struct epoll_instance *ep = obj;
+	int i;
+
+	(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(items); i++) {
+		if (items[i].ep != ep) {
+			continue;
+		}
+
+		sys_slist_find_and_remove(&items[i].ctx->epoll_items,
+					  &items[i].ctx_node);
+		epoll_item_free(&items[i]);
+	}
+
+	ep->in_use = false;
+
+	k_mutex_unlock(&epoll_lock);
+
+	return 0;
+}
+
+static int epoll_ioctl_vmeth(void *obj, unsigned int request, va_list args)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(request);
+	ARG_UNUSED(args);
+
+	errno = EOPNOTSUPP;
+	return -1;
+}
+
+static const struct fd_op_vtable epoll_fd_op_vtable = {
+	.read = epoll_read_vmeth,
+	.write = epoll_write_vmeth,
+	.close = epoll_close_vmeth,
+	.ioctl = epoll_ioctl_vmeth,
+};
@@ -47,6 +47,23 @@ static inline bool net_socket_is_tls(void *obj)
 #define sock_set_eof(ctx) sock_set_flag(ctx, SOCK_EOF, SOCK_EOF)
 #define sock_is_nonblock(ctx) sock_get_flag(ctx, SOCK_NONBLOCK)
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+/* Wake up the epoll instances watching a socket that got data */
+void sock_epoll_notify(struct net_context *ctx);
+/* Drop the epoll registrations of a socket being closed */
+void sock_epoll_release(struct net_context *ctx);
+#else
+static inline void sock_epoll_notify(struct net_context *ctx)
+{
+	ARG_UNUSED(ctx);
+}
+
+static inline void sock_epoll_release(struct net_context *ctx)
+{
+	ARG_UNUSED(ctx);
+}
+#endif
+
 struct socket_op_vtable {
 	struct fd_op_vtable fd_vtable;
 	int (*bind)(void *obj, const struct sockaddr *addr, socklen_t addrlen);
@@ -63,8 +80,11 @@ struct socket_op_vtable {
 	int (*setsockopt)(void *obj, int level, int optname,
 			  const void *optval, socklen_t optlen);
 	ssize_t (*sendmsg)(void *obj, const struct msghdr *msg, int flags);
+	ssize_t (*recvmsg)(void *obj, struct msghdr *msg, int flags);
 	int (*getsockname)(void *obj, struct sockaddr *addr,
 			   socklen_t *addrlen);
 };
 
+extern const struct socket_op_vtable sock_fd_op_vtable;
+
 #endif /* _SOCKETS_INTERNAL_H_ */
@@ -196,13 +196,14 @@ ssize_t zpacket_sendmsg_ctx(struct net_context *ctx, const struct msghdr *msg,
 	return status;
 }
 
-ssize_t zpacket_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
-			     int flags, struct sockaddr *src_addr,
-			     socklen_t *addrlen)
+static ssize_t zpacket_recv(struct net_context *ctx, const struct iovec *iov,
+			    size_t iovlen, int flags, int *msg_flags)
 {
 	size_t recv_len = 0;
+	size_t pkt_len;
 	k_timeout_t timeout = K_FOREVER;
 	struct net_pkt *pkt;
+	size_t i;
 
 	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
 		timeout = K_NO_WAIT;
@@ -233,16 +234,22 @@ ssize_t zpacket_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
 	/* We do not handle any headers here,
 	 * just pass the whole packet to caller.
 	 */
-	recv_len = net_pkt_get_len(pkt);
-	if (recv_len > max_len) {
-		recv_len = max_len;
-	}
+	pkt_len = net_pkt_get_len(pkt);
 
-	if (net_pkt_read(pkt, buf, recv_len)) {
-		errno = ENOBUFS;
-		return -1;
+	for (i = 0; i < iovlen && recv_len < pkt_len; i++) {
+		size_t len = MIN(pkt_len - recv_len, iov[i].iov_len);
+
+		if (net_pkt_read(pkt, iov[i].iov_base, len)) {
+			errno = ENOBUFS;
+			return -1;
+		}
+
+		recv_len += len;
 	}
 
+	if (msg_flags && recv_len < pkt_len) {
+		*msg_flags |= ZSOCK_MSG_TRUNC;
+	}
 
 	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS) &&
 	    !(flags & ZSOCK_MSG_PEEK)) {
@@ -258,6 +265,27 @@ ssize_t zpacket_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
 	return recv_len;
 }
 
+ssize_t zpacket_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
+			     int flags, struct sockaddr *src_addr,
+			     socklen_t *addrlen)
+{
+	struct iovec iov = { .iov_base = buf, .iov_len = max_len };
+
+	return zpacket_recv(ctx, &iov, 1, flags, NULL);
+}
+
+ssize_t zpacket_recvmsg_ctx(struct net_context *ctx, struct msghdr *msg,
+			    int flags)
+{
+	/* No source address nor ancillary data is provided */
+	msg->msg_namelen = 0;
+	msg->msg_controllen = 0;
+	msg->msg_flags = 0;
+
+	return zpacket_recv(ctx, msg->msg_iov, msg->msg_iovlen, flags,
+			    &msg->msg_flags);
+}
+
 int zpacket_getsockopt_ctx(struct net_context *ctx, int level, int optname,
 			   void *optval, socklen_t *optlen)
 {
@@ -348,6 +376,12 @@ static ssize_t packet_sock_recvfrom_vmeth(void *obj, void *buf, size_t max_len,
 				    src_addr, addrlen);
 }
 
+static ssize_t packet_sock_recvmsg_vmeth(void *obj, struct msghdr *msg,
+					 int flags)
+{
+	return zpacket_recvmsg_ctx(obj, msg, flags);
+}
+
 static int packet_sock_getsockopt_vmeth(void *obj, int level, int optname,
 					void *optval, socklen_t *optlen)
 {
@@ -379,6 +413,7 @@ static const struct socket_op_vtable packet_sock_fd_op_vtable = {
 	.sendto = packet_sock_sendto_vmeth,
 	.sendmsg = packet_sock_sendmsg_vmeth,
 	.recvfrom = packet_sock_recvfrom_vmeth,
+	.recvmsg = packet_sock_recvmsg_vmeth,
 	.getsockopt = packet_sock_getsockopt_vmeth,
 	.setsockopt = packet_sock_setsockopt_vmeth,
 };
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief bit array allocation performance tests
+ *
+ * @defgroup lib_bitarray_perf_tests Bitarray performance
+ */
+
+#include <ztest.h>
+#include <sys/bitarray.h>
+#include <timing/timing.h>
+
+/* Number of allocations measured for each size and fill ratio */
+#define ALLOC_COUNT 64
+
+SYS_BITARRAY_DEFINE_STATIC(ba_1k, 1024);
+SYS_BITARRAY_DEFINE_STATIC(ba_8k, 8192);
+SYS_BITARRAY_DEFINE_STATIC(ba_64k, 65536);
+
+static sys_bitarray_t *const bitarrays[] = {
+	&ba_1k, &ba_8k, &ba_64k,
+};
+
+/* Percentage of bits allocated before measuring */
+static const uint32_t fill_ratios[] = { 0, 50, 90, 99 };
+
+/* Region sizes to allocate */
+static const size_t region_sizes[] = { 1, 8, 33 };
+
+static size_t offsets[ALLOC_COUNT];
+
+/*
+ * Fill the bit array so that @p ratio percent of the bits are set,
+ * packed at the low end the way a long-running allocator looks.
+ * Single free bits are left in the filled part, and single set bits
+ * are scattered over the free part, so both have to be skipped.
+ */
+static void fill_bitarray(sys_bitarray_t *ba, uint32_t ratio)
+{
+	size_t packed = ba->num_bits * ratio / 100U;
+	size_t bit;
+
+	zassert_equal(sys_bitarray_clear_region(ba, ba->num_bits, 0), 0,
+		      "cannot clear bit array");
+
+	if (packed > 0) {
+		zassert_equal(sys_bitarray_set_region(ba, packed, 0), 0,
+			      "cannot fill bit array");
+	}
+
+	for (bit = 100U; bit < packed; bit += 101U) {
+		sys_bitarray_clear_bit(ba, bit);
+	}
+
+	for (bit = packed + 50U; bit < ba->num_bits; bit += 64U) {
+		sys_bitarray_set_bit(ba, bit);
+	}
+}
+
+/* Reference first-fit search, matching one candidate at a time */
+static int ref_find(sys_bitarray_t *ba, size_t num_bits, size_t *offset)
+{
+	size_t off;
+
+	for (off = 0; (off + num_bits) <= ba->num_bits; off++) {
+		if (sys_bitarray_is_region_cleared(ba, num_bits, off)) {
+			*offset = off;
+			return 0;
+		}
+	}
+
+	return -ENOSPC;
+}
+
+/**
+ * @brief Verify bit array allocation against a bit-by-bit search
+ *
+ * @details Fill bit arrays of several sizes to several ratios and
+ * check that each allocation returns the lowest free region.
+ *
+ * @ingroup lib_bitarray_perf_tests
+ *
+ * @see sys_bitarray_alloc()
+ */
+void test_bitarray_alloc_first_fit(void)
+{
+	size_t offset, expected = 0;
+	int i, f, s, n;
+	int ret, expected_ret;
+
+	for (i = 0; i < ARRAY_SIZE(bitarrays); i++) {
+		for (f = 0; f < ARRAY_SIZE(fill_ratios); f++) {
+			for (s = 0; s < ARRAY_SIZE(region_sizes); s++) {
+				fill_bitarray(bitarrays[i], fill_ratios[f]);
+
+				for (n = 0; n < 8; n++) {
+					expected_ret = ref_find(bitarrays[i],
+								region_sizes[s],
+								&expected);
+					ret = sys_bitarray_alloc(bitarrays[i],
+								 region_sizes[s],
+								 &offset);
+					zassert_equal(ret, expected_ret,
+						      "alloc returned %d, expected %d",
+						      ret, expected_ret);
+					if (ret != 0) {
+						break;
+					}
+
+					zassert_equal(offset, expected,
+						      "offset %zu, expected %zu",
+						      offset, expected);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * @brief Measure bit array allocation and free
+ *
+ * @details Sweep bit array sizes, fill ratios and region sizes, and
+ * report the average cycles for sys_bitarray_alloc() and
+ * sys_bitarray_free().
+ *
+ * @ingroup lib_bitarray_perf_tests
+ *
+ * @see sys_bitarray_alloc(), sys_bitarray_free()
+ */
+void test_bitarray_alloc_perf(void)
+{
+	timing_t start, end;
+	uint64_t alloc_cycles, free_cycles;
+	int i, f, s, n, count;
+
+	timing_init();
+	timing_start();
+
+	for (i = 0; i < ARRAY_SIZE(bitarrays); i++) {
+		for (f = 0; f < ARRAY_SIZE(fill_ratios); f++) {
+			for (s = 0; s < ARRAY_SIZE(region_sizes); s++) {
+				fill_bitarray(bitarrays[i], fill_ratios[f]);
+
+				start = timing_counter_get();
+				for (count = 0; count < ALLOC_COUNT; count++) {
+					if (sys_bitarray_alloc(bitarrays[i],
+							       region_sizes[s],
+							       &offsets[count]) != 0) {
+						break;
+					}
+				}
+				end = timing_counter_get();
+				alloc_cycles = timing_cycles_get(&start, &end);
+
+				start = timing_counter_get();
+				for (n = 0; n < count; n++) {
+					sys_bitarray_free(bitarrays[i],
+							  region_sizes[s],
+							  offsets[n]);
+				}
+				end = timing_counter_get();
+				free_cycles = timing_cycles_get(&start, &end);
+
+				TC_PRINT("bits %6u fill %2u%% size %2zu: "
+					 "%2d allocs, alloc %u cycles, "
+					 "free %u cycles\n",
+					 bitarrays[i]->num_bits, fill_ratios[f],
+					 region_sizes[s], count,
+					 (uint32_t)(count ? alloc_cycles / count : 0),
+					 (uint32_t)(count ? free_cycles / count : 0));
+			}
+		}
+	}
+
+	timing_stop();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(bitarray_perf,
+			 ztest_unit_test(test_bitarray_alloc_first_fit),
+			 ztest_unit_test(test_bitarray_alloc_perf)
+			 );
+	ztest_run_test_suite(bitarray_perf);
+}
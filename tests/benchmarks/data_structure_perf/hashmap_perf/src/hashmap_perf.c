@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief hash map and LRU cache tests
+ *
+ * @defgroup lib_hashmap_tests Hashmap
+ */
+
+#include <ztest.h>
+#include <sys/hashmap.h>
+#include <sys/lru_cache.h>
+#include <sys/slist.h>
+#include <sys/sys_heap.h>
+#include <timing/timing.h>
+
+#define NODE_COUNT 1024
+
+struct container_node {
+	struct sys_hashmap_node node;
+	sys_snode_t snode;
+	uint32_t key;
+};
+
+struct cache_entry {
+	struct sys_lru_cache_node node;
+	uint32_t key;
+};
+
+static struct container_node nodes[NODE_COUNT];
+
+static char heap_mem[NODE_COUNT * 8 * sizeof(void *)];
+static struct sys_heap heap;
+
+static uint32_t node_hash(const void *key)
+{
+	return sys_hash32_u32(*(const uint32_t *)key);
+}
+
+static bool node_key_eq(const struct sys_hashmap_node *node, const void *key)
+{
+	const struct container_node *cnode =
+		CONTAINER_OF(node, struct container_node, node);
+
+	return cnode->key == *(const uint32_t *)key;
+}
+
+static bool entry_key_eq(const struct sys_hashmap_node *node, const void *key)
+{
+	const struct cache_entry *entry =
+		CONTAINER_OF(node, struct cache_entry, node.hnode);
+
+	return entry->key == *(const uint32_t *)key;
+}
+
+SYS_HASHMAP_DEFINE_STATIC(static_map, 16, node_hash, node_key_eq);
+
+static void init_nodes(void)
+{
+	int i;
+
+	for (i = 0; i < NODE_COUNT; i++) {
+		/* Keys with a common stride to exercise the hash mixing */
+		nodes[i].key = i * 64U;
+	}
+}
+
+static void count_node(struct sys_hashmap_node *node, void *cookie)
+{
+	(*(int *)cookie)++;
+}
+
+/**
+ * @brief Test a hash map with a fixed slot table
+ *
+ * @details Fill a static hash map, look up, replace and remove keys,
+ * and check that it refuses keys once full.
+ *
+ * @ingroup lib_hashmap_tests
+ *
+ * @see SYS_HASHMAP_DEFINE_STATIC(), sys_hashmap_insert(),
+ * sys_hashmap_get(), sys_hashmap_remove()
+ */
+void test_hashmap_static(void)
+{
+	uint32_t key;
+	int i, ret;
+
+	init_nodes();
+	sys_hashmap_clear(&static_map);
+
+	for (i = 0; i < 15; i++) {
+		ret = sys_hashmap_insert(&static_map, &nodes[i].node,
+					 &nodes[i].key);
+		zassert_equal(ret, 0, "insert %d failed: %d", i, ret);
+	}
+
+	ret = sys_hashmap_insert(&static_map, &nodes[15].node, &nodes[15].key);
+	zassert_equal(ret, -ENOMEM, "full map accepted a node");
+
+	ret = sys_hashmap_insert(&static_map, &nodes[16].node, &nodes[3].key);
+	zassert_equal(ret, -EEXIST, "duplicate key accepted");
+
+	zassert_equal(sys_hashmap_size(&static_map), 15, "wrong size");
+
+	for (i = 0; i < 15; i++) {
+		zassert_equal_ptr(sys_hashmap_get(&static_map, &nodes[i].key),
+				  &nodes[i].node, "lookup %d failed", i);
+	}
+
+	key = 1U;
+	zassert_is_null(sys_hashmap_get(&static_map, &key),
+			"found a key never inserted");
+
+	/* Remove every other node, the rest must stay reachable */
+	for (i = 0; i < 15; i += 2) {
+		zassert_equal_ptr(sys_hashmap_remove(&static_map,
+						     &nodes[i].key),
+				  &nodes[i].node, "remove %d failed", i);
+	}
+
+	for (i = 0; i < 15; i++) {
+		if ((i % 2) == 0) {
+			zassert_is_null(sys_hashmap_get(&static_map,
+							&nodes[i].key),
+					"removed node %d found", i);
+		} else {
+			zassert_equal_ptr(sys_hashmap_get(&static_map,
+							  &nodes[i].key),
+					  &nodes[i].node, "lookup %d failed", i);
+		}
+	}
+
+	zassert_true(sys_hashmap_remove_node(&static_map, &nodes[1].node),
+		     "remove by node failed");
+	zassert_false(sys_hashmap_remove_node(&static_map, &nodes[1].node),
+		      "node removed twice");
+	zassert_equal(sys_hashmap_size(&static_map), 6, "wrong size");
+}
+
+/**
+ * @brief Test a heap backed hash map growing incrementally
+ *
+ * @details Insert nodes one by one and check after each insertion
+ * that all nodes are reachable, including while nodes are being
+ * migrated to a bigger table.
+ *
+ * @ingroup lib_hashmap_tests
+ *
+ * @see sys_hashmap_init(), sys_hashmap_walk(), sys_hashmap_clear()
+ */
+void test_hashmap_grow(void)
+{
+	struct sys_hashmap map;
+	int i, j, ret, count;
+
+	init_nodes();
+	sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+	sys_hashmap_init(&map, node_hash, node_key_eq, &heap);
+
+	for (i = 0; i < NODE_COUNT; i++) {
+		ret = sys_hashmap_insert(&map, &nodes[i].node, &nodes[i].key);
+		zassert_equal(ret, 0, "insert %d failed: %d", i, ret);
+
+		/* Checking all nodes each time is quadratic, so only
+		 * check the ones which could have moved recently.
+		 */
+		for (j = (i > 64) ? (i - 64) : 0; j <= i; j++) {
+			zassert_equal_ptr(sys_hashmap_get(&map, &nodes[j].key),
+					  &nodes[j].node, "lookup %d failed", j);
+		}
+	}
+
+	for (i = 0; i < NODE_COUNT; i++) {
+		zassert_equal_ptr(sys_hashmap_get(&map, &nodes[i].key),
+				  &nodes[i].node, "lookup %d failed", i);
+	}
+
+	sys_hashmap_clear(&map);
+
+	/* Stop shortly after the table grew from 128 to 256 slots, and
+	 * remove nodes while they are still being migrated.
+	 */
+	for (i = 0; i < 100; i++) {
+		ret = sys_hashmap_insert(&map, &nodes[i].node, &nodes[i].key);
+		zassert_equal(ret, 0, "insert %d failed: %d", i, ret);
+	}
+
+	for (i = 0; i < 100; i += 3) {
+		zassert_true(sys_hashmap_remove_node(&map, &nodes[i].node),
+			     "remove %d failed", i);
+		for (j = 0; j < 100; j++) {
+			zassert_equal_ptr(sys_hashmap_get(&map, &nodes[j].key),
+					  (((j % 3) == 0) && (j <= i)) ?
+					  NULL : &nodes[j].node,
+					  "lookup %d failed", j);
+		}
+	}
+
+	for (i = 100; i < NODE_COUNT; i++) {
+		ret = sys_hashmap_insert(&map, &nodes[i].node, &nodes[i].key);
+		zassert_equal(ret, 0, "insert %d failed: %d", i, ret);
+	}
+
+	for (i = 0; i < 100; i += 3) {
+		ret = sys_hashmap_insert(&map, &nodes[i].node, &nodes[i].key);
+		zassert_equal(ret, 0, "insert %d failed: %d", i, ret);
+	}
+
+	for (i = 0; i < NODE_COUNT; i += 2) {
+		zassert_equal_ptr(sys_hashmap_remove(&map, &nodes[i].key),
+				  &nodes[i].node, "remove %d failed", i);
+	}
+
+	count = 0;
+	sys_hashmap_walk(&map, count_node, &count);
+	zassert_equal(count, NODE_COUNT / 2, "walked %d nodes", count);
+
+	for (i = 1; i < NODE_COUNT; i += 2) {
+		zassert_equal_ptr(sys_hashmap_get(&map, &nodes[i].key),
+				  &nodes[i].node, "lookup %d failed", i);
+	}
+
+	sys_hashmap_clear(&map);
+	zassert_equal(sys_hashmap_size(&map), 0, "map not empty");
+	zassert_is_null(sys_hashmap_get(&map, &nodes[1].key),
+			"lookup in cleared map succeeded");
+}
+
+/**
+ * @brief Test LRU cache eviction order
+ *
+ * @details Fill an LRU cache, touch some entries, and check that
+ * inserting more entries evicts the least recently used ones.
+ *
+ * @ingroup lib_hashmap_tests
+ *
+ * @see sys_lru_cache_put(), sys_lru_cache_get()
+ */
+void test_lru_cache(void)
+{
+	static struct cache_entry entries[8];
+	struct sys_lru_cache_node *evicted;
+	struct sys_lru_cache cache;
+	int i, ret;
+
+	sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+	sys_lru_cache_init(&cache, node_hash, entry_key_eq, &heap, 4);
+
+	for (i = 0; i < ARRAY_SIZE(entries); i++) {
+		entries[i].key = i;
+	}
+
+	for (i = 0; i < 4; i++) {
+		ret = sys_lru_cache_put(&cache, &entries[i].node,
+					&entries[i].key, &evicted);
+		zassert_equal(ret, 0, "put %d failed: %d", i, ret);
+		zassert_is_null(evicted, "eviction before cache is full");
+	}
+
+	/* Use 0 and 1 so that 2 is the least recently used */
+	zassert_equal_ptr(sys_lru_cache_get(&cache, &entries[0].key),
+			  &entries[0].node, "get failed");
+	zassert_equal_ptr(sys_lru_cache_get(&cache, &entries[1].key),
+			  &entries[1].node, "get failed");
+
+	/* Peeking must not change the order */
+	zassert_equal_ptr(sys_lru_cache_peek(&cache, &entries[2].key),
+			  &entries[2].node, "peek failed");
+
+	ret = sys_lru_cache_put(&cache, &entries[4].node, &entries[4].key,
+				&evicted);
+	zassert_equal(ret, 0, "put failed: %d", ret);
+	zassert_equal_ptr(evicted, &entries[2].node, "wrong entry evicted");
+
+	ret = sys_lru_cache_put(&cache, &entries[5].node, &entries[5].key,
+				&evicted);
+	zassert_equal(ret, 0, "put failed: %d", ret);
+	zassert_equal_ptr(evicted, &entries[3].node, "wrong entry evicted");
+
+	zassert_is_null(sys_lru_cache_get(&cache, &entries[2].key),
+			"evicted entry found");
+	zassert_equal(sys_lru_cache_size(&cache), 4, "wrong size");
+	zassert_equal_ptr(sys_lru_cache_oldest(&cache), &entries[0].node,
+			  "wrong oldest entry");
+
+	ret = sys_lru_cache_put(&cache, &entries[6].node, &entries[0].key,
+				&evicted);
+	zassert_equal(ret, -EEXIST, "duplicate key accepted");
+	zassert_is_null(evicted, "failed put evicted an entry");
+	zassert_equal(sys_lru_cache_size(&cache), 4, "wrong size");
+
+	zassert_equal_ptr(sys_lru_cache_remove(&cache, &entries[0].key),
+			  &entries[0].node, "remove failed");
+	zassert_equal_ptr(sys_lru_cache_oldest(&cache), &entries[1].node,
+			  "wrong oldest entry");
+}
+
+/**
+ * @brief Measure hash map lookups against a linear list
+ *
+ * @details For growing numbers of nodes, report the average cycles
+ * of sys_hashmap_insert() and sys_hashmap_get(), and of a lookup in
+ * an slist holding the same nodes.
+ *
+ * @ingroup lib_hashmap_tests
+ */
+void test_hashmap_perf(void)
+{
+	static const int sizes[] = { 16, 64, 256, NODE_COUNT };
+	struct sys_hashmap map;
+	struct container_node *cnode;
+	sys_slist_t list;
+	timing_t start, end;
+	uint64_t insert_cycles, get_cycles, list_cycles;
+	int i, s, found;
+
+	init_nodes();
+	timing_init();
+	timing_start();
+
+	for (s = 0; s < ARRAY_SIZE(sizes); s++) {
+		sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+		sys_hashmap_init(&map, node_hash, node_key_eq, &heap);
+		sys_slist_init(&list);
+
+		start = timing_counter_get();
+		for (i = 0; i < sizes[s]; i++) {
+			sys_hashmap_insert(&map, &nodes[i].node, &nodes[i].key);
+		}
+		end = timing_counter_get();
+		insert_cycles = timing_cycles_get(&start, &end);
+
+		for (i = 0; i < sizes[s]; i++) {
+			sys_slist_append(&list, &nodes[i].snode);
+		}
+
+		found = 0;
+		start = timing_counter_get();
+		for (i = 0; i < sizes[s]; i++) {
+			if (sys_hashmap_get(&map, &nodes[i].key) != NULL) {
+				found++;
+			}
+		}
+		end = timing_counter_get();
+		get_cycles = timing_cycles_get(&start, &end);
+		zassert_equal(found, sizes[s], "hash map lookups failed");
+
+		found = 0;
+		start = timing_counter_get();
+		for (i = 0; i < sizes[s]; i++) {
+			SYS_SLIST_FOR_EACH_CONTAINER(&list, cnode, snode) {
+				if (cnode->key == nodes[i].key) {
+					found++;
+					break;
+				}
+			}
+		}
+		end = timing_counter_get();
+		list_cycles = timing_cycles_get(&start, &end);
+		zassert_equal(found, sizes[s], "list lookups failed");
+
+		TC_PRINT("nodes %4d: insert %u cycles, get %u cycles, "
+			 "list lookup %u cycles\n", sizes[s],
+			 (uint32_t)(insert_cycles / sizes[s]),
+			 (uint32_t)(get_cycles / sizes[s]),
+			 (uint32_t)(list_cycles / sizes[s]));
+	}
+
+	timing_stop();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(hashmap,
+			 ztest_unit_test(test_hashmap_static),
+			 ztest_unit_test(test_hashmap_grow),
+			 ztest_unit_test(test_lru_cache),
+			 ztest_unit_test(test_hashmap_perf)
+			 );
+	ztest_run_test_suite(hashmap);
+}
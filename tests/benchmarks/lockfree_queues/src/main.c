@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/spsc_ring.h>
+#include <sys/mpmc_queue.h>
+
+/* Cross-CPU throughput of the lock-free queues.  A producer thread
+ * and a consumer thread, at the same priority so that each gets its
+ * own CPU, pass N_ELEMS 32-bit elements through the queue under test.
+ * The consumer checks the sequence and the main thread reports the
+ * elements per second for each queue type.
+ */
+
+#define N_ELEMS 200000
+#define QUEUE_ELEMS 256
+#define BATCH 16
+#define STACK_SIZE 1024
+
+SPSC_RING_DEFINE(ring, sizeof(uint32_t), QUEUE_ELEMS);
+MPMC_QUEUE_DEFINE(queue, sizeof(uint32_t), QUEUE_ELEMS);
+K_MSGQ_DEFINE(msgq, sizeof(uint32_t), QUEUE_ELEMS, sizeof(uint32_t));
+
+static K_THREAD_STACK_DEFINE(producer_stack, STACK_SIZE);
+static K_THREAD_STACK_DEFINE(consumer_stack, STACK_SIZE);
+static struct k_thread producer_thread;
+static struct k_thread consumer_thread;
+
+enum queue_type {
+	SPSC_RING,
+	MPMC_QUEUE,
+	MSGQ,
+};
+
+static const char *const names[] = {
+	"spsc_ring", "mpmc_queue", "k_msgq",
+};
+
+static volatile bool sequence_error;
+
+static void producer(void *p1, void *p2, void *p3)
+{
+	enum queue_type type = POINTER_TO_UINT(p1);
+	uint32_t batch[BATCH];
+	uint32_t val = 0;
+	uint32_t n, i;
+
+	while (val < N_ELEMS) {
+		switch (type) {
+		case SPSC_RING:
+			for (i = 0; i < BATCH; i++) {
+				batch[i] = val + i;
+			}
+
+			n = MIN(BATCH, N_ELEMS - val);
+			val += spsc_ring_put(&ring, batch, n);
+			break;
+		case MPMC_QUEUE:
+			if (mpmc_queue_put(&queue, &val) == 0) {
+				val++;
+			}
+			break;
+		case MSGQ:
+			if (k_msgq_put(&msgq, &val, K_NO_WAIT) == 0) {
+				val++;
+			}
+			break;
+		}
+	}
+}
+
+static void consumer(void *p1, void *p2, void *p3)
+{
+	enum queue_type type = POINTER_TO_UINT(p1);
+	uint32_t batch[BATCH];
+	uint32_t expected = 0;
+	uint32_t n, i;
+
+	while (expected < N_ELEMS) {
+		switch (type) {
+		case SPSC_RING:
+			n = spsc_ring_get(&ring, batch, BATCH);
+			break;
+		case MPMC_QUEUE:
+			n = (mpmc_queue_get(&queue, batch) == 0) ? 1 : 0;
+			break;
+		case MSGQ:
+		default:
+			n = (k_msgq_get(&msgq, batch, K_NO_WAIT) == 0) ? 1 : 0;
+			break;
+		}
+
+		for (i = 0; i < n; i++) {
+			if (batch[i] != expected) {
+				sequence_error = true;
+			}
+			expected++;
+		}
+	}
+}
+
+static void run(enum queue_type type)
+{
+	uint32_t start, cycles;
+	uint64_t rate;
+	int prio = k_thread_priority_get(k_current_get()) + 1;
+
+	sequence_error = false;
+	start = k_cycle_get_32();
+
+	k_thread_create(&consumer_thread, consumer_stack, STACK_SIZE,
+			consumer, UINT_TO_POINTER(type), NULL, NULL,
+			prio, 0, K_NO_WAIT);
+	k_thread_create(&producer_thread, producer_stack, STACK_SIZE,
+			producer, UINT_TO_POINTER(type), NULL, NULL,
+			prio, 0, K_NO_WAIT);
+
+	k_thread_join(&producer_thread, K_FOREVER);
+	k_thread_join(&consumer_thread, K_FOREVER);
+
+	cycles = k_cycle_get_32() - start;
+	rate = (uint64_t)N_ELEMS * sys_clock_hw_cycles_per_sec()
+	       / MAX(cycles, 1U);
+
+	printk("%-10s %8u elems/s%s\n", names[type], (uint32_t)rate,
+	       sequence_error ? " SEQUENCE ERROR" : "");
+}
+
+void main(void)
+{
+	printk("%d CPUs, %d elements per run\n",
+	       CONFIG_MP_NUM_CPUS, N_ELEMS);
+
+	run(SPSC_RING);
+	run(MPMC_QUEUE);
+	run(MSGQ);
+
+	printk("fin\n");
+}
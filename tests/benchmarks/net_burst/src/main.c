@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/dummy.h>
+#include <net/socket.h>
+
+/* Small packet rate over the loopback interface, using a documentation
+ * address (RFC 5737) as both endpoints.  N_PKTS datagrams are sent BATCH
+ * at a time with sendmmsg() from a cooperative thread, so that they are
+ * all queued to the TX thread before it runs, and received with
+ * recvmmsg() before the next batch is sent.
+ */
+
+#define N_PKTS 16384
+#define PKT_LEN 16
+#define BATCH 32
+#define RX_PORT 4242
+#define TX_PORT 4243
+
+static uint8_t tx_buf[PKT_LEN];
+static uint8_t rx_bufs[BATCH][PKT_LEN];
+static struct iovec tx_iov;
+static struct iovec rx_iov[BATCH];
+static struct mmsghdr tx_msgs[BATCH];
+static struct mmsghdr rx_msgs[BATCH];
+
+static struct sockaddr_in rx_addr = {
+	.sin_family = AF_INET,
+	.sin_port = htons(RX_PORT),
+	.sin_addr = { { { 192, 0, 2, 1 } } },
+};
+
+static struct sockaddr_in tx_addr = {
+	.sin_family = AF_INET,
+	.sin_port = htons(TX_PORT),
+	.sin_addr = { { { 192, 0, 2, 1 } } },
+};
+
+static void init_msgs(void)
+{
+	int i;
+
+	tx_iov.iov_base = tx_buf;
+	tx_iov.iov_len = sizeof(tx_buf);
+
+	for (i = 0; i < BATCH; i++) {
+		tx_msgs[i].msg_hdr.msg_name = &rx_addr;
+		tx_msgs[i].msg_hdr.msg_namelen = sizeof(rx_addr);
+		tx_msgs[i].msg_hdr.msg_iov = &tx_iov;
+		tx_msgs[i].msg_hdr.msg_iovlen = 1;
+
+		rx_iov[i].iov_base = rx_bufs[i];
+		rx_iov[i].iov_len = PKT_LEN;
+		rx_msgs[i].msg_hdr.msg_iov = &rx_iov[i];
+		rx_msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+}
+
+/* Returns the cycles spent, or 0 on failure */
+static uint64_t run(int tx_sock, int rx_sock)
+{
+	uint64_t cycles = 0U;
+	int sent, received, ret;
+	uint32_t start;
+
+	for (sent = 0; sent < N_PKTS; sent += BATCH) {
+		start = k_cycle_get_32();
+
+		ret = sendmmsg(tx_sock, tx_msgs, BATCH, 0);
+		if (ret != BATCH) {
+			printk("Send failed (%d)\n", errno);
+			return 0;
+		}
+
+		for (received = 0; received < BATCH; received += ret) {
+			ret = recvmmsg(rx_sock, rx_msgs, BATCH - received,
+				       MSG_WAITFORONE);
+			if (ret <= 0) {
+				printk("Receive failed (%d)\n", errno);
+				return 0;
+			}
+		}
+
+		cycles += k_cycle_get_32() - start;
+	}
+
+	return MAX(cycles, 1U);
+}
+
+void main(void)
+{
+	struct net_if *iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	struct timeval timeo = { .tv_sec = 1 };
+	int tx_sock, rx_sock;
+	uint64_t cycles;
+
+	if (!iface ||
+	    !net_if_ipv4_addr_add(iface, &rx_addr.sin_addr, NET_ADDR_MANUAL,
+				  0)) {
+		printk("Cannot set up the loopback interface\n");
+		return;
+	}
+
+	tx_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	rx_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+	if (tx_sock < 0 || rx_sock < 0 ||
+	    bind(tx_sock, (struct sockaddr *)&tx_addr, sizeof(tx_addr)) < 0 ||
+	    bind(rx_sock, (struct sockaddr *)&rx_addr, sizeof(rx_addr)) < 0 ||
+	    setsockopt(rx_sock, SOL_SOCKET, SO_RCVTIMEO, &timeo,
+		       sizeof(timeo)) < 0) {
+		printk("Cannot set up the sockets (%d)\n", errno);
+		return;
+	}
+
+	init_msgs();
+
+	/* The TX thread only runs once a whole batch has been queued */
+	k_thread_priority_set(k_current_get(), K_PRIO_COOP(8));
+
+	printk("TX batch of %d packets\n", CONFIG_NET_TC_TX_BATCH);
+
+	cycles = run(tx_sock, rx_sock);
+	if (!cycles) {
+		return;
+	}
+
+	printk("%d packets of %d bytes: %u pkts/s\n", N_PKTS, PKT_LEN,
+	       (uint32_t)((uint64_t)N_PKTS * sys_clock_hw_cycles_per_sec() /
+			  cycles));
+
+	close(tx_sock);
+	close(rx_sock);
+
+	printk("fin\n");
+}
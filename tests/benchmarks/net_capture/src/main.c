@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_capture_bench, LOG_LEVEL_INF);
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/byteorder.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+#include <net/dummy.h>
+#include <net/capture.h>
+
+#include "net_private.h"
+
+/* Packets per second through an interface with the capture to memory off
+ * and on.  The packets are sent synchronously (no TX thread) to a driver
+ * that drops them, so the time is that of the stack from net_if_send_data()
+ * to the driver, which includes the capture hook.
+ */
+
+#define N_PKTS 100000
+
+#define LOCAL_PORT 4242
+#define PEER_PORT 4343
+
+static const int pkt_sizes[] = { 64, 1500 };
+
+static const struct {
+	const char *name;
+	const char *filter;
+	uint16_t snaplen;
+	bool capture;
+} cases[] = {
+	{ "off", NULL, 0, false },
+	{ "all, snaplen 128", NULL, 128, true },
+	{ "all, snaplen 1500", NULL, 1500, true },
+	{ "not matching", "tcp and port 80", 128, true },
+	{ "matching", "udp and dst port 4343", 128, true },
+};
+
+static struct net_if *iface;
+
+static uint8_t data[1500];
+
+static int bench_dev_init(const struct device *dev)
+{
+	return 0;
+}
+
+static void bench_iface_init(struct net_if *iface)
+{
+	static uint8_t mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_ETHERNET);
+}
+
+static int bench_send(const struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static struct dummy_api bench_iface_api = {
+	.iface_api.init = bench_iface_init,
+	.send = bench_send,
+};
+
+NET_DEVICE_INIT(net_capture_bench, "net_capture_bench",
+		bench_dev_init, NULL, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&bench_iface_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), 1500);
+
+/* IPv4 UDP packet from 192.0.2.1 to 192.0.2.2 */
+static void prepare_data(int size)
+{
+	static const uint8_t addrs[] = { 192, 0, 2, 1, 192, 0, 2, 2 };
+
+	(void)memset(data, 0, sizeof(data));
+
+	data[0] = 0x45;
+	sys_put_be16(size, &data[2]);
+	data[8] = 64;
+	data[9] = IPPROTO_UDP;
+	memcpy(&data[12], addrs, sizeof(addrs));
+
+	sys_put_be16(LOCAL_PORT, &data[20]);
+	sys_put_be16(PEER_PORT, &data[22]);
+	sys_put_be16(size - 20, &data[24]);
+}
+
+static int run(int size)
+{
+	struct net_pkt *pkt;
+	uint32_t start, cycles;
+	int i;
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < N_PKTS; i++) {
+		pkt = net_pkt_alloc_with_buffer(iface, size, AF_INET,
+						IPPROTO_UDP, K_NO_WAIT);
+		if (!pkt) {
+			return -ENOMEM;
+		}
+
+		if (net_pkt_write(pkt, data, size) < 0) {
+			net_pkt_unref(pkt);
+			return -ENOMEM;
+		}
+
+		if (net_if_send_data(iface, pkt) == NET_DROP) {
+			net_pkt_unref(pkt);
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	return k_cyc_to_ns_floor64(cycles) / N_PKTS;
+}
+
+void main(void)
+{
+	struct net_capture_ring_stats stats;
+	int i, j, ns;
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	if (!iface) {
+		printk("Cannot find the interface\n");
+		return;
+	}
+
+	printk("%d packets per case\n", N_PKTS);
+
+	for (i = 0; i < ARRAY_SIZE(pkt_sizes); i++) {
+		prepare_data(pkt_sizes[i]);
+
+		for (j = 0; j < ARRAY_SIZE(cases); j++) {
+			net_capture_ring_clear();
+
+			if (cases[j].capture) {
+				(void)net_capture_ring_filter(cases[j].filter);
+				(void)net_capture_ring_start(iface,
+							     cases[j].snaplen);
+			}
+
+			ns = run(pkt_sizes[i]);
+
+			net_capture_ring_stop();
+			net_capture_ring_stats(&stats);
+
+			if (ns < 0) {
+				printk("Cannot allocate packet\n");
+				return;
+			}
+
+			printk("capture %-17s %4d bytes: %u ns per packet, "
+			       "%u packets/s, %u captured\n", cases[j].name,
+			       pkt_sizes[i], ns,
+			       ns ? NSEC_PER_SEC / ns : 0U, stats.captured);
+		}
+	}
+
+	printk("fin\n");
+}
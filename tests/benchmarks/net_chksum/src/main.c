@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_chksum_bench, LOG_LEVEL_INF);
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+
+#include "net_private.h"
+
+/* Checksum time for packets of growing size.  The packets are IPv4 UDP
+ * packets of random content, split in network buffers the way they are
+ * received.  The 16 bits at a time checksum is the one used before the
+ * 32-bit word summing, kept here for comparison.
+ */
+
+#define N_ROUNDS 4096
+
+static const int pkt_sizes[] = { 64, 576, 1500 };
+
+static uint8_t data[1500];
+
+static volatile uint16_t result;
+
+static uint32_t seed = 1U;
+
+static uint32_t bench_rand(void)
+{
+	seed = seed * 1103515245U + 12345U;
+
+	return seed >> 8;
+}
+
+static uint16_t chksum_16bit(uint16_t sum, const uint8_t *ptr, size_t len)
+{
+	const uint8_t *end = ptr + len - 1;
+	uint16_t tmp;
+
+	while (ptr < end) {
+		tmp = (ptr[0] << 8) + ptr[1];
+		sum += tmp;
+		if (sum < tmp) {
+			sum++;
+		}
+
+		ptr += 2;
+	}
+
+	if (ptr == end) {
+		tmp = ptr[0] << 8;
+		sum += tmp;
+		if (sum < tmp) {
+			sum++;
+		}
+	}
+
+	return sum;
+}
+
+static struct net_pkt *prepare_pkt(int size)
+{
+	struct net_pkt *pkt;
+	struct net_buf *buf;
+	int pos = 0, len;
+
+	pkt = net_pkt_alloc(K_NO_WAIT);
+	if (!pkt) {
+		return NULL;
+	}
+
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, NET_IPV4H_LEN);
+
+	while (pos < size) {
+		buf = net_pkt_get_reserve_tx_data(K_NO_WAIT);
+		if (!buf) {
+			net_pkt_unref(pkt);
+			return NULL;
+		}
+
+		len = MIN(net_buf_tailroom(buf), size - pos);
+		memcpy(net_buf_add(buf, len), data + pos, len);
+		net_pkt_append_buffer(pkt, buf);
+
+		pos += len;
+	}
+
+	return pkt;
+}
+
+static uint32_t ns_per_round(uint32_t cycles)
+{
+	return (uint32_t)(k_cyc_to_ns_floor64(cycles) / N_ROUNDS);
+}
+
+static int run_udp(int size)
+{
+	uint32_t start, cycles, cycles_16bit;
+	struct net_pkt *pkt;
+	int i;
+
+	pkt = prepare_pkt(size);
+	if (!pkt) {
+		return -1;
+	}
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < N_ROUNDS; i++) {
+		result = net_calc_chksum_udp(pkt);
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < N_ROUNDS; i++) {
+		result = chksum_16bit(0U, data, size);
+	}
+
+	cycles_16bit = k_cycle_get_32() - start;
+
+	net_pkt_unref(pkt);
+
+	printk("UDP: %4d bytes, %u ns per packet, %u ns 16 bits at a time\n",
+	       size, ns_per_round(cycles), ns_per_round(cycles_16bit));
+
+	return 0;
+}
+
+static int run_ipv4_hdr(void)
+{
+	uint32_t start, cycles, cycles_update;
+	struct net_ipv4_hdr *hdr;
+	struct net_pkt *pkt;
+	uint16_t word;
+	int i;
+
+	pkt = prepare_pkt(NET_IPV4H_LEN);
+	if (!pkt) {
+		return -1;
+	}
+
+	hdr = NET_IPV4_HDR(pkt);
+	hdr->vhl = 0x45;
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < N_ROUNDS; i++) {
+		hdr->ttl--;
+		hdr->chksum = 0U;
+		hdr->chksum = net_calc_chksum_ipv4(pkt);
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < N_ROUNDS; i++) {
+		word = UNALIGNED_GET((uint16_t *)&hdr->ttl);
+		hdr->ttl--;
+		hdr->chksum = net_chksum_update16(hdr->chksum, word,
+					UNALIGNED_GET((uint16_t *)&hdr->ttl));
+	}
+
+	cycles_update = k_cycle_get_32() - start;
+
+	result = net_calc_chksum_ipv4(pkt);
+
+	net_pkt_unref(pkt);
+
+	printk("IPv4 header TTL decrement: %u ns recomputed, "
+	       "%u ns updated%s\n", ns_per_round(cycles),
+	       ns_per_round(cycles_update), result ? " (invalid)" : "");
+
+	return 0;
+}
+
+void main(void)
+{
+	int i;
+
+	for (i = 0; i < sizeof(data); i++) {
+		data[i] = bench_rand();
+	}
+
+	printk("%d rounds, %d byte buffers\n", N_ROUNDS,
+	       CONFIG_NET_BUF_DATA_SIZE);
+
+	for (i = 0; i < ARRAY_SIZE(pkt_sizes); i++) {
+		if (run_udp(pkt_sizes[i]) < 0) {
+			printk("Cannot allocate the packet\n");
+			return;
+		}
+	}
+
+	if (run_ipv4_hdr() < 0) {
+		printk("Cannot allocate the packet\n");
+		return;
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+#include <net/dummy.h>
+#include <net/udp.h>
+
+#include "ipv6.h"
+#include "udp_internal.h"
+#include "connection.h"
+
+/* Connection handler lookup of received UDP packets.  For each number
+ * of registered handlers, N_PKTS packets from the connected peer and
+ * N_PKTS packets from another peer are passed to net_conn_input() and
+ * the main thread reports the packets per second of both.
+ */
+
+#define N_PKTS 20000
+#define LOCAL_PORT 4242
+#define PEER_PORT 1000
+#define OTHER_PORT 999
+
+static const int n_conns[] = { 2, 8, 32, 128 };
+
+static struct in6_addr local_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					  0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+static struct in6_addr peer_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					 0, 0, 0, 0, 0, 0, 0, 0x2 } } };
+
+static struct net_conn_handle *handles[CONFIG_NET_MAX_CONN];
+static uint32_t matched;
+static void *expected;
+
+static int bench_dev_init(const struct device *dev)
+{
+	return 0;
+}
+
+static void bench_iface_init(struct net_if *iface)
+{
+	static uint8_t mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_ETHERNET);
+}
+
+static int bench_send(const struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static struct dummy_api bench_if_api = {
+	.iface_api.init = bench_iface_init,
+	.send = bench_send,
+};
+
+NET_DEVICE_INIT(net_conn_bench, "net_conn_bench", bench_dev_init, NULL,
+		NULL, NULL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&bench_if_api, DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+/* Keeps the packet, it is fed again to the next lookup */
+static enum net_verdict bench_cb(struct net_conn *conn,
+				 struct net_pkt *pkt,
+				 union net_ip_header *ip_hdr,
+				 union net_proto_header *proto_hdr,
+				 void *user_data)
+{
+	if (user_data == expected) {
+		matched++;
+	}
+
+	return NET_OK;
+}
+
+static int bench_register(int idx, uint16_t remote_port, void *user_data)
+{
+	struct sockaddr_in6 remote = {
+		.sin6_family = AF_INET6,
+		.sin6_addr = peer_addr,
+	};
+	struct sockaddr_in6 local = {
+		.sin6_family = AF_INET6,
+		.sin6_addr = local_addr,
+	};
+
+	return net_conn_register(IPPROTO_UDP, AF_INET6,
+				 remote_port ? (struct sockaddr *)&remote :
+				 NULL,
+				 (struct sockaddr *)&local, remote_port,
+				 LOCAL_PORT, NULL, bench_cb, user_data,
+				 &handles[idx]);
+}
+
+static uint32_t bench_lookup(struct net_if *iface, uint16_t src_port,
+			     void *user_data)
+{
+	union net_proto_header proto_hdr;
+	union net_ip_header ip_hdr;
+	uint32_t start, cycles;
+	struct net_pkt *pkt;
+	int i;
+
+	pkt = net_pkt_alloc_with_buffer(iface, 0, AF_INET6, IPPROTO_UDP,
+					K_NO_WAIT);
+	if (!pkt) {
+		printk("Cannot allocate packet\n");
+		return 0;
+	}
+
+	if (net_ipv6_create(pkt, &peer_addr, &local_addr) ||
+	    net_udp_create(pkt, htons(src_port), htons(LOCAL_PORT))) {
+		printk("Cannot create packet\n");
+		net_pkt_unref(pkt);
+		return 0;
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_ipv6_finalize(pkt, IPPROTO_UDP);
+
+	ip_hdr.ipv6 = NET_IPV6_HDR(pkt);
+	proto_hdr.udp = (struct net_udp_hdr *)(pkt->buffer->data +
+					       sizeof(struct net_ipv6_hdr));
+
+	expected = user_data;
+	matched = 0U;
+	start = k_cycle_get_32();
+
+	for (i = 0; i < N_PKTS; i++) {
+		net_conn_input(pkt, &ip_hdr, IPPROTO_UDP, &proto_hdr);
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	net_pkt_unref(pkt);
+
+	if (matched != N_PKTS) {
+		printk("Only %u of %u packets matched\n", matched, N_PKTS);
+	}
+
+	return (uint64_t)N_PKTS * sys_clock_hw_cycles_per_sec() /
+	       MAX(cycles, 1U);
+}
+
+static void run(struct net_if *iface, int count)
+{
+	static int listener, connected;
+	uint32_t connected_rate, listener_rate;
+	int i;
+
+	/* The handlers of the test packets are the oldest ones */
+	if (bench_register(0, PEER_PORT, &connected) < 0 ||
+	    bench_register(1, 0, &listener) < 0) {
+		printk("Cannot register handlers\n");
+		return;
+	}
+
+	for (i = 2; i < count; i++) {
+		if (bench_register(i, PEER_PORT + i, NULL) < 0) {
+			printk("Cannot register handler %d\n", i);
+			count = i;
+			break;
+		}
+	}
+
+	connected_rate = bench_lookup(iface, PEER_PORT, &connected);
+	listener_rate = bench_lookup(iface, OTHER_PORT, &listener);
+
+	printk("%3d conns: connected %8u pkts/s, listener %8u pkts/s\n",
+	       count, connected_rate, listener_rate);
+
+	for (i = 0; i < count; i++) {
+		net_conn_unregister(handles[i]);
+	}
+}
+
+void main(void)
+{
+	struct net_if *iface = net_if_get_default();
+	int i;
+
+	printk("%d packets per run\n", N_PKTS);
+
+	for (i = 0; i < ARRAY_SIZE(n_conns); i++) {
+		run(iface, MIN(n_conns[i], CONFIG_NET_MAX_CONN));
+	}
+
+	printk("fin\n");
+}
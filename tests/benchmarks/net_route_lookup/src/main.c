@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/dummy.h>
+
+#include "ipv6.h"
+#include "route.h"
+
+/* Route lookup time for routing tables of growing size.  The routes are
+ * random prefixes of 48 to 128 bits within the IPv6 documentation prefix
+ * (RFC 3849), and of 8 to 32 bits for IPv4, via a few neighbors.  Most of
+ * the destinations looked up are within one of the routes, the others
+ * only share the first 32 (IPv6) or 4 (IPv4) bits of one.
+ */
+
+#define N_LOOKUPS 65536
+#define N_DESTS 1024
+#define N_NEIGHBORS 8
+
+static const int table_sizes[] = { 16, 64, 256, 1024 };
+
+static struct net_if *iface;
+
+static struct in6_addr nexthops[N_NEIGHBORS];
+static struct in6_addr prefixes6[CONFIG_NET_MAX_ROUTES];
+static uint8_t prefix_lens6[CONFIG_NET_MAX_ROUTES];
+static struct net_route_entry *routes6[CONFIG_NET_MAX_ROUTES];
+static struct in6_addr dests6[N_DESTS];
+
+#if defined(CONFIG_NET_IPV4_ROUTE)
+static struct in_addr gateways[N_NEIGHBORS];
+static struct in_addr prefixes4[CONFIG_NET_IPV4_MAX_ROUTES];
+static uint8_t prefix_lens4[CONFIG_NET_IPV4_MAX_ROUTES];
+static struct net_route_entry_ipv4 *routes4[CONFIG_NET_IPV4_MAX_ROUTES];
+static struct in_addr dests4[N_DESTS];
+#endif
+
+static uint32_t seed = 1U;
+
+static uint32_t bench_rand(void)
+{
+	/* The same tables and destinations for every configuration */
+	seed = seed * 1103515245U + 12345U;
+
+	return seed >> 8;
+}
+
+/* Random address starting with the given prefix */
+static void random_addr(uint8_t *addr, const uint8_t *prefix,
+			int prefix_len, int size)
+{
+	uint8_t mask;
+	int i;
+
+	for (i = 0; i < size; i++) {
+		if (prefix_len >= (i + 1) * 8) {
+			mask = 0xff;
+		} else if (prefix_len > i * 8) {
+			mask = 0xff << (8 - prefix_len % 8);
+		} else {
+			mask = 0U;
+		}
+
+		addr[i] = (prefix[i] & mask) | (bench_rand() & ~mask);
+	}
+}
+
+/* Destination within route idx, or only close to it */
+static int dest_prefix_len(uint8_t prefix_len, int short_len)
+{
+	return bench_rand() % 8 ? prefix_len : short_len;
+}
+
+static void print_result(const char *family, int count, uint32_t cycles,
+			 int found)
+{
+	printk("%s: %4d routes, %u ns per lookup, %d%% found\n", family,
+	       count, (uint32_t)(k_cyc_to_ns_floor64(cycles) / N_LOOKUPS),
+	       found * 100 / N_LOOKUPS);
+}
+
+static int add_neighbors(void)
+{
+	static uint8_t lladdrs[N_NEIGHBORS][6];
+	struct net_linkaddr lladdr;
+	int i;
+
+	for (i = 0; i < N_NEIGHBORS; i++) {
+		/* 00-00-5E-00-53-xx Documentation RFC 7042 */
+		lladdrs[i][2] = 0x5e;
+		lladdrs[i][4] = 0x53;
+		lladdrs[i][5] = i + 1;
+
+		lladdr.addr = lladdrs[i];
+		lladdr.len = sizeof(lladdrs[i]);
+		lladdr.type = NET_LINK_ETHERNET;
+
+		nexthops[i].s6_addr[0] = 0xfe;
+		nexthops[i].s6_addr[1] = 0x80;
+		nexthops[i].s6_addr[15] = i + 1;
+
+		if (!net_ipv6_nbr_add(iface, &nexthops[i], &lladdr, false,
+				      NET_IPV6_NBR_STATE_REACHABLE)) {
+			return -1;
+		}
+
+#if defined(CONFIG_NET_IPV4_ROUTE)
+		gateways[i].s4_addr[0] = 192;
+		gateways[i].s4_addr[2] = 2;
+		gateways[i].s4_addr[3] = i + 1;
+#endif
+	}
+
+	return 0;
+}
+
+static int run_ipv6(int count)
+{
+	static const uint8_t base[16] = { 0x20, 0x01, 0x0d, 0xb8 };
+	uint32_t start, cycles;
+	int i, idx, found = 0;
+
+	for (i = 0; i < count; i++) {
+		prefix_lens6[i] = 48 + bench_rand() % 81;
+		random_addr(prefixes6[i].s6_addr, base, 32, sizeof(base));
+
+		routes6[i] = net_route_add(iface, &prefixes6[i],
+					   prefix_lens6[i],
+					   &nexthops[i % N_NEIGHBORS]);
+		if (!routes6[i]) {
+			return -1;
+		}
+	}
+
+	for (i = 0; i < N_DESTS; i++) {
+		idx = bench_rand() % count;
+		random_addr(dests6[i].s6_addr, prefixes6[idx].s6_addr,
+			    dest_prefix_len(prefix_lens6[idx], 32),
+			    sizeof(dests6[i]));
+	}
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < N_LOOKUPS; i++) {
+		if (net_route_lookup(iface, &dests6[i % N_DESTS])) {
+			found++;
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	for (i = 0; i < count; i++) {
+		/* A prefix drawn twice is only one route */
+		(void)net_route_del(routes6[i]);
+	}
+
+	print_result("IPv6", count, cycles, found);
+
+	return 0;
+}
+
+#if defined(CONFIG_NET_IPV4_ROUTE)
+static int run_ipv4(int count)
+{
+	static const uint8_t base[4];
+	uint32_t start, cycles;
+	int i, idx, found = 0;
+
+	for (i = 0; i < count; i++) {
+		prefix_lens4[i] = 8 + bench_rand() % 25;
+		random_addr(prefixes4[i].s4_addr, base, 0, sizeof(base));
+
+		routes4[i] = net_route_ipv4_add(iface, &prefixes4[i],
+						prefix_lens4[i],
+						&gateways[i % N_NEIGHBORS]);
+		if (!routes4[i]) {
+			return -1;
+		}
+	}
+
+	for (i = 0; i < N_DESTS; i++) {
+		idx = bench_rand() % count;
+		random_addr(dests4[i].s4_addr, prefixes4[idx].s4_addr,
+			    dest_prefix_len(prefix_lens4[idx], 4),
+			    sizeof(dests4[i]));
+	}
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < N_LOOKUPS; i++) {
+		if (net_route_ipv4_lookup(iface, &dests4[i % N_DESTS])) {
+			found++;
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	for (i = 0; i < count; i++) {
+		(void)net_route_ipv4_del(routes4[i]);
+	}
+
+	print_result("IPv4", count, cycles, found);
+
+	return 0;
+}
+#endif
+
+void main(void)
+{
+	int i;
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+
+	if (!iface || add_neighbors() < 0) {
+		printk("Cannot set up the interface\n");
+		return;
+	}
+
+	printk("%d lookups, %s\n", N_LOOKUPS,
+	       IS_ENABLED(CONFIG_NET_ROUTE_TRIE) ? "prefix trie" :
+	       "linear search");
+
+	for (i = 0; i < ARRAY_SIZE(table_sizes); i++) {
+		if (table_sizes[i] > CONFIG_NET_MAX_ROUTES) {
+			break;
+		}
+
+		if (run_ipv6(table_sizes[i]) < 0) {
+			printk("Cannot add IPv6 route\n");
+			return;
+		}
+	}
+
+#if defined(CONFIG_NET_IPV4_ROUTE)
+	for (i = 0; i < ARRAY_SIZE(table_sizes); i++) {
+		if (table_sizes[i] > CONFIG_NET_IPV4_MAX_ROUTES) {
+			break;
+		}
+
+		if (run_ipv4(table_sizes[i]) < 0) {
+			printk("Cannot add IPv4 route\n");
+			return;
+		}
+	}
+#endif
+
+	printk("fin\n");
+}
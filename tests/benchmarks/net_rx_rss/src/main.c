@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/ethernet.h>
+#include <net/dummy.h>
+#include <net/socket.h>
+#include <net/net_stats.h>
+
+/* Multi-flow receive rate over the loopback interface, using a
+ * documentation address (RFC 5737).  N_FLOWS UDP flows, then N_FLOWS TCP
+ * connections, are each read by their own thread.  The UDP datagrams are
+ * sent round robin by the main thread, the TCP data by one thread per
+ * connection.  The packets handled by each Rx queue are printed after
+ * each run.
+ */
+
+#define N_FLOWS 4
+#define UDP_PKTS 8192
+#define UDP_LEN 64
+#define TCP_LEN (256 * 1024)
+#define CHUNK_LEN 1024
+#define BASE_PORT 4242
+#define STACK_SIZE 2048
+
+static struct sockaddr_in addr = {
+	.sin_family = AF_INET,
+	.sin_addr = { { { 192, 0, 2, 1 } } },
+};
+
+K_THREAD_STACK_ARRAY_DEFINE(rx_stacks, N_FLOWS, STACK_SIZE);
+K_THREAD_STACK_ARRAY_DEFINE(tx_stacks, N_FLOWS, STACK_SIZE);
+static struct k_thread rx_threads[N_FLOWS];
+static struct k_thread tx_threads[N_FLOWS];
+
+static int rx_socks[N_FLOWS];
+static int tx_socks[N_FLOWS];
+static size_t received[N_FLOWS];
+static size_t expected;
+
+static struct net_if *iface;
+static net_stats_t queue_pkts[NET_TC_RX_COUNT];
+
+static void receiver(void *p1, void *p2, void *p3)
+{
+	int idx = POINTER_TO_INT(p1);
+	bool datagrams = POINTER_TO_INT(p2);
+	char buf[CHUNK_LEN];
+	ssize_t ret;
+
+	ARG_UNUSED(p3);
+
+	while (received[idx] < expected) {
+		ret = recv(rx_socks[idx], buf, sizeof(buf), 0);
+		if (ret <= 0) {
+			break;
+		}
+
+		received[idx] += datagrams ? 1 : ret;
+	}
+}
+
+static void tcp_sender(void *p1, void *p2, void *p3)
+{
+	static const char buf[CHUNK_LEN];
+	int idx = POINTER_TO_INT(p1);
+	size_t sent = 0;
+	ssize_t ret;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (sent < TCP_LEN) {
+		ret = send(tx_socks[idx], buf, sizeof(buf), 0);
+		if (ret < 0 && errno == ENOMEM) {
+			/* Out of TX buffers until the data in flight is acked */
+			k_msleep(1);
+			continue;
+		}
+
+		if (ret < 0) {
+			break;
+		}
+
+		sent += ret;
+	}
+}
+
+/* Datagrams are counted, stream data in bytes */
+static void start_receivers(size_t count, bool datagrams)
+{
+	int i;
+
+	expected = count;
+
+	for (i = 0; i < N_FLOWS; i++) {
+		received[i] = 0;
+		k_thread_create(&rx_threads[i], rx_stacks[i], STACK_SIZE,
+				receiver, INT_TO_POINTER(i),
+				INT_TO_POINTER(datagrams), NULL,
+				K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+	}
+}
+
+/* Returns the amount received by all the flows */
+static size_t join_receivers(void)
+{
+	size_t total = 0;
+	int i;
+
+	for (i = 0; i < N_FLOWS; i++) {
+		k_thread_join(&rx_threads[i], K_FOREVER);
+		total += received[i];
+	}
+
+	return total;
+}
+
+static void print_queues(void)
+{
+	struct net_stats stats;
+	int i;
+
+	if (net_mgmt(NET_REQUEST_STATS_GET_ALL, iface, &stats,
+		     sizeof(stats)) < 0) {
+		return;
+	}
+
+	printk("  packets per Rx queue:");
+
+	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+		printk(" %u", stats.tc.recv[i].pkts - queue_pkts[i]);
+		queue_pkts[i] = stats.tc.recv[i].pkts;
+	}
+
+	printk("\n");
+}
+
+static int run_udp(void)
+{
+	struct timeval timeo = { .tv_sec = 1 };
+	static const char buf[UDP_LEN];
+	uint32_t start, cycles;
+	size_t total;
+	int i;
+
+	for (i = 0; i < N_FLOWS; i++) {
+		rx_socks[i] = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		tx_socks[i] = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		addr.sin_port = htons(BASE_PORT + i);
+
+		if (rx_socks[i] < 0 || tx_socks[i] < 0 ||
+		    bind(rx_socks[i], (struct sockaddr *)&addr,
+			 sizeof(addr)) < 0 ||
+		    setsockopt(rx_socks[i], SOL_SOCKET, SO_RCVTIMEO, &timeo,
+			       sizeof(timeo)) < 0 ||
+		    connect(tx_socks[i], (struct sockaddr *)&addr,
+			    sizeof(addr)) < 0) {
+			return -1;
+		}
+	}
+
+	start_receivers(UDP_PKTS / N_FLOWS, true);
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < UDP_PKTS; i++) {
+		if (send(tx_socks[i % N_FLOWS], buf, sizeof(buf), 0) < 0) {
+			printk("Send failed (%d)\n", errno);
+			break;
+		}
+	}
+
+	total = join_receivers();
+
+	cycles = k_cycle_get_32() - start;
+
+	for (i = 0; i < N_FLOWS; i++) {
+		close(rx_socks[i]);
+		close(tx_socks[i]);
+	}
+
+	printk("UDP: %u pkts/s, %zu of %d received\n",
+	       (uint32_t)((uint64_t)total * sys_clock_hw_cycles_per_sec() /
+			  MAX(cycles, 1U)), total, UDP_PKTS);
+
+	print_queues();
+
+	return 0;
+}
+
+static int run_tcp(void)
+{
+	uint32_t start, cycles;
+	int listener, i;
+	size_t total;
+
+	addr.sin_port = htons(BASE_PORT);
+
+	listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (listener < 0 ||
+	    bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    listen(listener, N_FLOWS) < 0) {
+		return -1;
+	}
+
+	for (i = 0; i < N_FLOWS; i++) {
+		tx_socks[i] = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if (tx_socks[i] < 0 ||
+		    connect(tx_socks[i], (struct sockaddr *)&addr,
+			    sizeof(addr)) < 0) {
+			return -1;
+		}
+
+		rx_socks[i] = accept(listener, NULL, NULL);
+		if (rx_socks[i] < 0) {
+			return -1;
+		}
+	}
+
+	close(listener);
+
+	start_receivers(TCP_LEN, false);
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < N_FLOWS; i++) {
+		k_thread_create(&tx_threads[i], tx_stacks[i], STACK_SIZE,
+				tcp_sender, INT_TO_POINTER(i), NULL, NULL,
+				K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+	}
+
+	total = join_receivers();
+
+	cycles = k_cycle_get_32() - start;
+
+	for (i = 0; i < N_FLOWS; i++) {
+		k_thread_join(&tx_threads[i], K_FOREVER);
+		close(tx_socks[i]);
+		close(rx_socks[i]);
+	}
+
+	printk("TCP: %u KB/s, %zu of %d bytes received\n",
+	       (uint32_t)((uint64_t)total * sys_clock_hw_cycles_per_sec() /
+			  1024U / MAX(cycles, 1U)), total, N_FLOWS * TCP_LEN);
+
+	print_queues();
+
+	return 0;
+}
+
+void main(void)
+{
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+
+	if (!iface ||
+	    !net_if_ipv4_addr_add(iface, &addr.sin_addr, NET_ADDR_MANUAL, 0)) {
+		printk("Cannot set up the loopback interface\n");
+		return;
+	}
+
+	/* Segments as large as on an Ethernet link */
+	net_if_set_mtu(iface, NET_ETH_MTU);
+
+	printk("%d flows, %d Rx queues, RSS %s, %d CPUs\n", N_FLOWS,
+	       NET_TC_RX_COUNT, IS_ENABLED(CONFIG_NET_TC_RX_RSS) ? "on" : "off",
+	       CONFIG_MP_NUM_CPUS);
+
+	if (run_udp() < 0 || run_tcp() < 0) {
+		printk("Cannot set up the sockets (%d)\n", errno);
+		return;
+	}
+
+	printk("fin\n");
+}
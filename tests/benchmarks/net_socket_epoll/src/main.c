@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/dummy.h>
+#include <net/socket.h>
+
+/* Cost of waiting for data on a set of mostly idle UDP sockets over the
+ * loopback interface, using a documentation address (RFC 5737).  In each
+ * round one datagram is sent to the next socket of the set, then the
+ * receiver waits for it with poll() over the whole set or with
+ * epoll_wait(), and reads it.  Only the wait is timed.
+ */
+
+#define N_ROUNDS 2048
+#define MAX_SOCKS 512
+#define BASE_PORT 5000
+#define TX_PORT 4243
+#define WAIT_MS 1000
+
+static const int set_sizes[] = { 16, 32, 64, 128, 256, 512 };
+
+static int socks[MAX_SOCKS];
+static struct zsock_pollfd pfds[MAX_SOCKS];
+
+static struct sockaddr_in rx_addr = {
+	.sin_family = AF_INET,
+	.sin_addr = { { { 192, 0, 2, 1 } } },
+};
+
+static struct sockaddr_in tx_addr = {
+	.sin_family = AF_INET,
+	.sin_port = htons(TX_PORT),
+	.sin_addr = { { { 192, 0, 2, 1 } } },
+};
+
+static int send_to(int tx_sock, int idx)
+{
+	static const char payload[] = "ping";
+
+	rx_addr.sin_port = htons(BASE_PORT + idx);
+
+	return sendto(tx_sock, payload, sizeof(payload), 0,
+		      (struct sockaddr *)&rx_addr, sizeof(rx_addr));
+}
+
+static int wait_poll(int count)
+{
+	int i;
+
+	if (poll(pfds, count, WAIT_MS) != 1) {
+		return -1;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (pfds[i].revents & POLLIN) {
+			return pfds[i].fd;
+		}
+	}
+
+	return -1;
+}
+
+static int wait_epoll(int epfd)
+{
+	struct epoll_event ev;
+
+	if (epoll_wait(epfd, &ev, 1, WAIT_MS) != 1) {
+		return -1;
+	}
+
+	return ev.data.fd;
+}
+
+static uint32_t rate(uint64_t cycles)
+{
+	return (uint64_t)N_ROUNDS * sys_clock_hw_cycles_per_sec() /
+	       MAX(cycles, 1U);
+}
+
+/* Returns the cycles spent waiting, or 0 on failure */
+static uint64_t run(int tx_sock, int epfd, int count)
+{
+	uint64_t cycles = 0U;
+	char buf[8];
+	uint32_t start;
+	int i, fd;
+
+	for (i = 0; i < N_ROUNDS; i++) {
+		if (send_to(tx_sock, i % count) < 0) {
+			printk("Send failed (%d)\n", errno);
+			return 0;
+		}
+
+		start = k_cycle_get_32();
+		fd = (epfd < 0) ? wait_poll(count) : wait_epoll(epfd);
+		cycles += k_cycle_get_32() - start;
+
+		if (fd != socks[i % count] ||
+		    recv(fd, buf, sizeof(buf), 0) < 0) {
+			printk("Wait failed (%d)\n", errno);
+			return 0;
+		}
+	}
+
+	return MAX(cycles, 1U);
+}
+
+void main(void)
+{
+	struct net_if *iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	uint64_t poll_cycles, epoll_cycles;
+	int tx_sock, epfd;
+	int i, j;
+
+	if (!iface ||
+	    !net_if_ipv4_addr_add(iface, &rx_addr.sin_addr, NET_ADDR_MANUAL,
+				  0)) {
+		printk("Cannot set up the loopback interface\n");
+		return;
+	}
+
+	tx_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (tx_sock < 0 ||
+	    bind(tx_sock, (struct sockaddr *)&tx_addr, sizeof(tx_addr)) < 0) {
+		printk("Cannot set up the sockets (%d)\n", errno);
+		return;
+	}
+
+	for (i = 0; i < MAX_SOCKS; i++) {
+		socks[i] = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		rx_addr.sin_port = htons(BASE_PORT + i);
+
+		if (socks[i] < 0 ||
+		    bind(socks[i], (struct sockaddr *)&rx_addr,
+			 sizeof(rx_addr)) < 0) {
+			printk("Cannot set up the sockets (%d)\n", errno);
+			return;
+		}
+
+		pfds[i].fd = socks[i];
+		pfds[i].events = POLLIN;
+	}
+
+	printk("%d rounds per run\n", N_ROUNDS);
+
+	for (i = 0; i < ARRAY_SIZE(set_sizes); i++) {
+		epfd = epoll_create1(0);
+		if (epfd < 0) {
+			printk("Cannot create the epoll instance (%d)\n",
+			       errno);
+			return;
+		}
+
+		for (j = 0; j < set_sizes[i]; j++) {
+			struct epoll_event ev = {
+				.events = EPOLLIN,
+				.data.fd = socks[j],
+			};
+
+			if (epoll_ctl(epfd, EPOLL_CTL_ADD, socks[j], &ev) < 0) {
+				printk("Cannot register socket (%d)\n", errno);
+				return;
+			}
+		}
+
+		poll_cycles = run(tx_sock, -1, set_sizes[i]);
+		epoll_cycles = run(tx_sock, epfd, set_sizes[i]);
+
+		close(epfd);
+
+		if (!poll_cycles || !epoll_cycles) {
+			return;
+		}
+
+		printk("%3d sockets: poll %8u waits/s, epoll %8u waits/s\n",
+		       set_sizes[i], rate(poll_cycles), rate(epoll_cycles));
+	}
+
+	for (i = 0; i < MAX_SOCKS; i++) {
+		close(socks[i]);
+	}
+
+	close(tx_sock);
+
+	printk("fin\n");
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/dummy.h>
+#include <net/socket.h>
+
+/* UDP throughput over the loopback interface, using a documentation
+ * address (RFC 5737) as both endpoints.  For each batch size,
+ * N_PKTS datagrams are sent and received, BATCH at a time.  A batch of
+ * one uses sendto() and recvfrom(), larger ones sendmmsg() and
+ * recvmmsg().
+ */
+
+#define N_PKTS 4096
+#define PKT_LEN 64
+#define MAX_BATCH 32
+#define RX_PORT 4242
+#define TX_PORT 4243
+
+static const int batches[] = { 1, 8, 32 };
+
+static uint8_t tx_buf[PKT_LEN];
+static uint8_t rx_bufs[MAX_BATCH][PKT_LEN];
+static struct iovec tx_iov[MAX_BATCH];
+static struct iovec rx_iov[MAX_BATCH];
+static struct mmsghdr tx_msgs[MAX_BATCH];
+static struct mmsghdr rx_msgs[MAX_BATCH];
+
+static struct sockaddr_in rx_addr = {
+	.sin_family = AF_INET,
+	.sin_port = htons(RX_PORT),
+	.sin_addr = { { { 192, 0, 2, 1 } } },
+};
+
+static struct sockaddr_in tx_addr = {
+	.sin_family = AF_INET,
+	.sin_port = htons(TX_PORT),
+	.sin_addr = { { { 192, 0, 2, 1 } } },
+};
+
+static int send_batch(int sock, int batch)
+{
+	int i;
+
+	if (batch == 1) {
+		return sendto(sock, tx_buf, sizeof(tx_buf), 0,
+			      (struct sockaddr *)&rx_addr,
+			      sizeof(rx_addr)) == sizeof(tx_buf) ? 1 : -1;
+	}
+
+	for (i = 0; i < batch; i++) {
+		tx_iov[i].iov_base = tx_buf;
+		tx_iov[i].iov_len = sizeof(tx_buf);
+		tx_msgs[i].msg_hdr.msg_name = &rx_addr;
+		tx_msgs[i].msg_hdr.msg_namelen = sizeof(rx_addr);
+		tx_msgs[i].msg_hdr.msg_iov = &tx_iov[i];
+		tx_msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	return sendmmsg(sock, tx_msgs, batch, 0);
+}
+
+static int recv_batch(int sock, int batch)
+{
+	int i;
+
+	if (batch == 1) {
+		return recvfrom(sock, rx_bufs[0], PKT_LEN, 0, NULL,
+				NULL) == PKT_LEN ? 1 : -1;
+	}
+
+	for (i = 0; i < batch; i++) {
+		rx_iov[i].iov_base = rx_bufs[i];
+		rx_iov[i].iov_len = PKT_LEN;
+		rx_msgs[i].msg_hdr.msg_name = NULL;
+		rx_msgs[i].msg_hdr.msg_iov = &rx_iov[i];
+		rx_msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	return recvmmsg(sock, rx_msgs, batch, MSG_WAITFORONE);
+}
+
+static uint32_t rate(uint64_t cycles)
+{
+	return (uint64_t)N_PKTS * sys_clock_hw_cycles_per_sec() /
+	       MAX(cycles, 1U);
+}
+
+static void run(int tx_sock, int rx_sock, int batch)
+{
+	uint64_t tx_cycles = 0U, rx_cycles = 0U;
+	uint32_t start;
+	int sent, received, ret;
+
+	for (sent = 0; sent < N_PKTS; ) {
+		start = k_cycle_get_32();
+		ret = send_batch(tx_sock, batch);
+		tx_cycles += k_cycle_get_32() - start;
+
+		if (ret <= 0) {
+			printk("Send failed (%d)\n", errno);
+			return;
+		}
+
+		sent += ret;
+
+		/* Receive what was sent before the next batch */
+		for (received = 0; received < ret; ) {
+			int count;
+
+			start = k_cycle_get_32();
+			count = recv_batch(rx_sock, ret - received);
+			rx_cycles += k_cycle_get_32() - start;
+
+			if (count <= 0) {
+				printk("Receive failed (%d)\n", errno);
+				return;
+			}
+
+			received += count;
+		}
+	}
+
+	printk("%2d per call: send %8u pkts/s, recv %8u pkts/s\n",
+	       batch, rate(tx_cycles), rate(rx_cycles));
+}
+
+void main(void)
+{
+	struct net_if *iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	struct timeval timeo = { .tv_sec = 1 };
+	int tx_sock, rx_sock;
+	int i;
+
+	if (!iface ||
+	    !net_if_ipv4_addr_add(iface, &rx_addr.sin_addr, NET_ADDR_MANUAL,
+				  0)) {
+		printk("Cannot set up the loopback interface\n");
+		return;
+	}
+
+	tx_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	rx_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+	if (tx_sock < 0 || rx_sock < 0 ||
+	    bind(tx_sock, (struct sockaddr *)&tx_addr, sizeof(tx_addr)) < 0 ||
+	    bind(rx_sock, (struct sockaddr *)&rx_addr, sizeof(rx_addr)) < 0 ||
+	    setsockopt(rx_sock, SOL_SOCKET, SO_RCVTIMEO, &timeo,
+		       sizeof(timeo)) < 0) {
+		printk("Cannot set up the sockets (%d)\n", errno);
+		return;
+	}
+
+	printk("%d packets of %d bytes per run\n", N_PKTS, PKT_LEN);
+
+	for (i = 0; i < ARRAY_SIZE(batches); i++) {
+		run(tx_sock, rx_sock, batches[i]);
+	}
+
+	close(tx_sock);
+	close(rx_sock);
+
+	printk("fin\n");
+}
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <fcntl.h>
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/dummy.h>
+#include <net/socket.h>
+
+/* TCP accept/echo rate over the loopback interface, using a documentation
+ * address (RFC 5737).  N_CLIENTS threads connect, send REQ_LEN bytes, wait
+ * for them to be echoed and close, until N_CONNS connections were made.
+ * N_SERVERS threads accept and echo them, either all from one listening
+ * socket or each from its own one sharing the port with SO_REUSEPORT.
+ */
+
+#define N_CONNS 256
+#define N_SERVERS 2
+#define N_CLIENTS 2
+#define REQ_LEN 64
+#define PORT 4242
+#define STACK_SIZE 2048
+#define POLL_MS 100
+
+static struct sockaddr_in addr = {
+	.sin_family = AF_INET,
+	.sin_port = htons(PORT),
+	.sin_addr = { { { 192, 0, 2, 1 } } },
+};
+
+K_THREAD_STACK_ARRAY_DEFINE(server_stacks, N_SERVERS, STACK_SIZE);
+K_THREAD_STACK_ARRAY_DEFINE(client_stacks, N_CLIENTS, STACK_SIZE);
+static struct k_thread server_threads[N_SERVERS];
+static struct k_thread client_threads[N_CLIENTS];
+
+static int listeners[N_SERVERS];
+static int handled[N_SERVERS];
+static atomic_t conns_left;
+static atomic_t failures;
+static volatile bool done;
+
+static int recv_all(int sock, char *buf)
+{
+	int len = 0, ret;
+
+	while (len < REQ_LEN) {
+		ret = recv(sock, buf + len, REQ_LEN - len, 0);
+		if (ret <= 0) {
+			return -1;
+		}
+
+		len += ret;
+	}
+
+	return 0;
+}
+
+static void server(void *p1, void *p2, void *p3)
+{
+	int idx = POINTER_TO_INT(p1);
+	struct zsock_pollfd pfd = {
+		.fd = listeners[idx],
+		.events = POLLIN,
+	};
+	char buf[REQ_LEN];
+	int sock;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (!done) {
+		if (poll(&pfd, 1, POLL_MS) <= 0) {
+			continue;
+		}
+
+		/* Another thread may have taken it from a shared listener */
+		sock = accept(pfd.fd, NULL, NULL);
+		if (sock < 0) {
+			continue;
+		}
+
+		if (recv_all(sock, buf) < 0 ||
+		    send(sock, buf, REQ_LEN, 0) != REQ_LEN) {
+			atomic_inc(&failures);
+		}
+
+		close(sock);
+		handled[idx]++;
+	}
+}
+
+static void client(void *p1, void *p2, void *p3)
+{
+	char buf[REQ_LEN] = { 0 };
+	int sock;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (atomic_dec(&conns_left) > 0) {
+		sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if (sock < 0) {
+			atomic_inc(&failures);
+			continue;
+		}
+
+		if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+		    send(sock, buf, REQ_LEN, 0) != REQ_LEN ||
+		    recv_all(sock, buf) < 0) {
+			atomic_inc(&failures);
+		}
+
+		close(sock);
+	}
+}
+
+static int listener(bool reuseport)
+{
+	int optval = 1;
+	int sock;
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (sock < 0) {
+		return -1;
+	}
+
+	if ((reuseport &&
+	     setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &optval,
+			sizeof(optval)) < 0) ||
+	    bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    listen(sock, N_CLIENTS) < 0 ||
+	    fcntl(sock, F_SETFL, O_NONBLOCK) < 0) {
+		close(sock);
+		return -1;
+	}
+
+	return sock;
+}
+
+static void run(const char *name, bool reuseport)
+{
+	uint32_t start, cycles;
+	int i;
+
+	for (i = 0; i < N_SERVERS; i++) {
+		if (i == 0 || reuseport) {
+			listeners[i] = listener(reuseport);
+			if (listeners[i] < 0) {
+				printk("Cannot set up the listener (%d)\n",
+				       errno);
+				return;
+			}
+		} else {
+			listeners[i] = listeners[0];
+		}
+
+		handled[i] = 0;
+	}
+
+	atomic_set(&conns_left, N_CONNS);
+	atomic_set(&failures, 0);
+	done = false;
+
+	for (i = 0; i < N_SERVERS; i++) {
+		k_thread_create(&server_threads[i], server_stacks[i],
+				STACK_SIZE, server, INT_TO_POINTER(i), NULL,
+				NULL, K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+	}
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < N_CLIENTS; i++) {
+		k_thread_create(&client_threads[i], client_stacks[i],
+				STACK_SIZE, client, NULL, NULL, NULL,
+				K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+	}
+
+	for (i = 0; i < N_CLIENTS; i++) {
+		k_thread_join(&client_threads[i], K_FOREVER);
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	done = true;
+
+	for (i = 0; i < N_SERVERS; i++) {
+		k_thread_join(&server_threads[i], K_FOREVER);
+
+		if (i == 0 || reuseport) {
+			close(listeners[i]);
+		}
+	}
+
+	if (atomic_get(&failures)) {
+		printk("%s: %d connections failed\n", name,
+		       (int)atomic_get(&failures));
+		return;
+	}
+
+	printk("%9s: %6u conns/s, per thread", name,
+	       (uint32_t)((uint64_t)N_CONNS * sys_clock_hw_cycles_per_sec() /
+			  MAX(cycles, 1U)));
+
+	for (i = 0; i < N_SERVERS; i++) {
+		printk(" %d", handled[i]);
+	}
+
+	printk("\n");
+}
+
+void main(void)
+{
+	struct net_if *iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+
+	if (!iface ||
+	    !net_if_ipv4_addr_add(iface, &addr.sin_addr, NET_ADDR_MANUAL, 0)) {
+		printk("Cannot set up the loopback interface\n");
+		return;
+	}
+
+	printk("%d connections, %d server and %d client threads\n",
+	       N_CONNS, N_SERVERS, N_CLIENTS);
+
+	run("shared", false);
+	run("reuseport", true);
+
+	printk("fin\n");
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+#include <net/dummy.h>
+#include <net/socket.h>
+
+/* UDP throughput over the loopback interface, using a documentation
+ * address (RFC 5737) as both endpoints.  The sender writes every payload
+ * byte once, either into its own buffer that sendto() copies, or straight
+ * into network buffers for zsock_send_zc().  The receiver reads every
+ * byte once, either from the buffer recvfrom() copied into, or from the
+ * network buffers returned by zsock_recv_zc().  The datagrams fit in the
+ * 536 byte MTU of the loopback interface.
+ */
+
+#define N_PKTS 8192
+#define PKT_LEN 500
+#define RX_PORT 4242
+#define TX_PORT 4243
+
+static uint8_t tx_buf[PKT_LEN];
+static uint8_t rx_buf[PKT_LEN];
+
+static struct sockaddr_in rx_addr = {
+	.sin_family = AF_INET,
+	.sin_port = htons(RX_PORT),
+	.sin_addr = { { { 192, 0, 2, 1 } } },
+};
+
+static struct sockaddr_in tx_addr = {
+	.sin_family = AF_INET,
+	.sin_port = htons(TX_PORT),
+	.sin_addr = { { { 192, 0, 2, 1 } } },
+};
+
+static uint32_t checksum;
+
+static void consume(const uint8_t *data, size_t len)
+{
+	while (len--) {
+		checksum += *data++;
+	}
+}
+
+static int send_copy(int sock, uint8_t seq)
+{
+	memset(tx_buf, seq, sizeof(tx_buf));
+
+	return sendto(sock, tx_buf, sizeof(tx_buf), 0,
+		      (struct sockaddr *)&rx_addr, sizeof(rx_addr));
+}
+
+static int recv_copy(int sock)
+{
+	int ret;
+
+	ret = recvfrom(sock, rx_buf, sizeof(rx_buf), 0, NULL, NULL);
+	if (ret > 0) {
+		consume(rx_buf, ret);
+	}
+
+	return ret;
+}
+
+static int send_zc(int sock, uint8_t seq)
+{
+	struct net_buf *frags = NULL;
+	size_t len = 0;
+	int ret;
+
+	while (len < PKT_LEN) {
+		struct net_buf *frag;
+		size_t frag_len;
+
+		frag = net_pkt_get_reserve_tx_data(K_FOREVER);
+		frag_len = MIN(PKT_LEN - len, net_buf_tailroom(frag));
+		memset(net_buf_add(frag, frag_len), seq, frag_len);
+		len += frag_len;
+
+		if (frags) {
+			net_buf_frag_add(frags, frag);
+		} else {
+			frags = frag;
+		}
+	}
+
+	ret = zsock_send_zc(sock, frags, 0, (struct sockaddr *)&rx_addr,
+			    sizeof(rx_addr));
+	if (ret < 0) {
+		net_buf_unref(frags);
+	}
+
+	return ret;
+}
+
+static int recv_zc(int sock)
+{
+	struct net_buf *frags, *frag;
+	int ret;
+
+	ret = zsock_recv_zc(sock, &frags, 0, NULL, NULL);
+
+	for (frag = frags; frag; frag = frag->frags) {
+		consume(frag->data, frag->len);
+	}
+
+	zsock_recv_zc_release(frags);
+
+	return ret;
+}
+
+static uint32_t rate(uint64_t cycles)
+{
+	return (uint64_t)N_PKTS * PKT_LEN * sys_clock_hw_cycles_per_sec() /
+	       1024U / MAX(cycles, 1U);
+}
+
+static void run(const char *name, int tx_sock, int rx_sock,
+		int (*send_fn)(int sock, uint8_t seq),
+		int (*recv_fn)(int sock))
+{
+	uint64_t tx_cycles = 0U, rx_cycles = 0U;
+	uint32_t start;
+	int i, ret;
+
+	checksum = 0U;
+
+	for (i = 0; i < N_PKTS; i++) {
+		start = k_cycle_get_32();
+		ret = send_fn(tx_sock, i);
+		tx_cycles += k_cycle_get_32() - start;
+
+		if (ret != PKT_LEN) {
+			printk("Send failed (%d)\n", errno);
+			return;
+		}
+
+		start = k_cycle_get_32();
+		ret = recv_fn(rx_sock);
+		rx_cycles += k_cycle_get_32() - start;
+
+		if (ret != PKT_LEN) {
+			printk("Receive failed (%d)\n", errno);
+			return;
+		}
+	}
+
+	printk("%s: send %8u KiB/s, recv %8u KiB/s (sum %u)\n", name,
+	       rate(tx_cycles), rate(rx_cycles), checksum);
+}
+
+void main(void)
+{
+	struct net_if *iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	struct timeval timeo = { .tv_sec = 1 };
+	int tx_sock, rx_sock;
+
+	if (!iface ||
+	    !net_if_ipv4_addr_add(iface, &rx_addr.sin_addr, NET_ADDR_MANUAL,
+				  0)) {
+		printk("Cannot set up the loopback interface\n");
+		return;
+	}
+
+	tx_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	rx_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+	if (tx_sock < 0 || rx_sock < 0 ||
+	    bind(tx_sock, (struct sockaddr *)&tx_addr, sizeof(tx_addr)) < 0 ||
+	    bind(rx_sock, (struct sockaddr *)&rx_addr, sizeof(rx_addr)) < 0 ||
+	    setsockopt(rx_sock, SOL_SOCKET, SO_RCVTIMEO, &timeo,
+		       sizeof(timeo)) < 0) {
+		printk("Cannot set up the sockets (%d)\n", errno);
+		return;
+	}
+
+	printk("%d datagrams of %d bytes per run\n", N_PKTS, PKT_LEN);
+
+	run("copy", tx_sock, rx_sock, send_copy, recv_copy);
+	run("zero-copy", tx_sock, rx_sock, send_zc, recv_zc);
+
+	close(tx_sock);
+	close(rx_sock);
+
+	printk("fin\n");
+}
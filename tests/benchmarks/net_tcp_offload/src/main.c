@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/dummy.h>
+#include <net/socket.h>
+#include <net/net_stats.h>
+
+/* Bulk TCP transfer over the loopback interface, using a documentation
+ * address (RFC 5737).  The main thread sends TOTAL_LEN bytes in chunks of
+ * CHUNK_LEN bytes, a receiver thread reads them.  The CPU cycles spent
+ * for the whole transfer are reported per MB, along with the number of
+ * segments TCP sent and received, which shows how often the send and
+ * receive paths were taken with segmentation offload and receive
+ * coalescing enabled or not.
+ */
+
+#define MB_LEN (1024 * 1024)
+#define TOTAL_LEN (4 * MB_LEN)
+#define CHUNK_LEN 4096
+#define PORT 4242
+#define STACK_SIZE 2048
+
+static struct sockaddr_in addr = {
+	.sin_family = AF_INET,
+	.sin_port = htons(PORT),
+	.sin_addr = { { { 192, 0, 2, 1 } } },
+};
+
+K_THREAD_STACK_DEFINE(receiver_stack, STACK_SIZE);
+static struct k_thread receiver_thread;
+
+static char tx_buf[CHUNK_LEN];
+static char rx_buf[CHUNK_LEN];
+static size_t received;
+
+static void receiver(void *p1, void *p2, void *p3)
+{
+	int sock = POINTER_TO_INT(p1);
+	ssize_t ret;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (received < TOTAL_LEN) {
+		ret = recv(sock, rx_buf, sizeof(rx_buf), 0);
+		if (ret <= 0) {
+			break;
+		}
+
+		received += ret;
+	}
+
+	close(sock);
+}
+
+static int setup(int *client, int *server)
+{
+	int listener;
+
+	listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (listener < 0 ||
+	    bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    listen(listener, 1) < 0) {
+		return -1;
+	}
+
+	*client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (*client < 0 ||
+	    connect(*client, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		return -1;
+	}
+
+	*server = accept(listener, NULL, NULL);
+	close(listener);
+
+	return *server < 0 ? -1 : 0;
+}
+
+void main(void)
+{
+	struct net_if *iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	struct net_stats stats;
+	uint32_t start, cycles;
+	size_t sent = 0;
+	int client, server;
+	ssize_t ret;
+
+	if (!iface ||
+	    !net_if_ipv4_addr_add(iface, &addr.sin_addr, NET_ADDR_MANUAL, 0)) {
+		printk("Cannot set up the loopback interface\n");
+		return;
+	}
+
+	if (setup(&client, &server) < 0) {
+		printk("Cannot set up the connection (%d)\n", errno);
+		return;
+	}
+
+	printk("%d MB in %d byte chunks, GSO %s, GRO %s\n", TOTAL_LEN / MB_LEN,
+	       CHUNK_LEN, IS_ENABLED(CONFIG_NET_TCP_GSO) ? "on" : "off",
+	       IS_ENABLED(CONFIG_NET_TCP_GRO) ? "on" : "off");
+
+	k_thread_create(&receiver_thread, receiver_stack, STACK_SIZE,
+			receiver, INT_TO_POINTER(server), NULL, NULL,
+			K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+
+	start = k_cycle_get_32();
+
+	while (sent < TOTAL_LEN) {
+		ret = send(client, tx_buf, MIN(sizeof(tx_buf), TOTAL_LEN - sent),
+			   0);
+		if (ret < 0 && errno == ENOMEM) {
+			/* Out of TX buffers until the data in flight is acked */
+			k_msleep(1);
+			continue;
+		}
+
+		if (ret < 0) {
+			printk("Send failed (%d)\n", errno);
+			return;
+		}
+
+		sent += ret;
+	}
+
+	k_thread_join(&receiver_thread, K_FOREVER);
+
+	cycles = k_cycle_get_32() - start;
+
+	close(client);
+
+	if (received != TOTAL_LEN) {
+		printk("Only %zu bytes received\n", received);
+		return;
+	}
+
+	net_mgmt(NET_REQUEST_STATS_GET_TCP, iface, &stats.tcp,
+		 sizeof(stats.tcp));
+
+	printk("%u cycles/MB, TCP segments: %u sent, %u received\n",
+	       cycles / (TOTAL_LEN / MB_LEN), stats.tcp.sent, stats.tcp.recv);
+
+	printk("fin\n");
+}
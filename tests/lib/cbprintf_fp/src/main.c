@@ -4,10 +4,13 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <kernel.h>
+
 #if defined(CONFIG_APP_FORMATTER_PRINTK)
 #include <sys/printk.h>
 #define PRINT_S "printk"
 #define PRINT(...) printk(__VA_ARGS__)
+#define SNPRINT(...) snprintk(__VA_ARGS__)
 #elif defined(CONFIG_APP_FORMATTER_PRINTF)
 #include <stdio.h>
 #ifdef CONFIG_NEWLIB_LIBC
@@ -16,6 +19,7 @@
 #define PRINT_S "printf"
 #endif /* NEWLIB_LIBC */
 #define PRINT(...) printf(__VA_ARGS__)
+#define SNPRINT(...) snprintf(__VA_ARGS__)
 #elif defined(CONFIG_APP_FORMATTER_PRINTFCB)
 #include <sys/cbprintf.h>
 #ifdef CONFIG_NEWLIB_LIBC
@@ -24,19 +28,51 @@
 #define PRINT_S "printfcb"
 #endif /* NEWLIB_LIBC */
 #define PRINT(...) printfcb(__VA_ARGS__)
+#define SNPRINT(...) snprintfcb(__VA_ARGS__)
 #elif defined(CONFIG_APP_FORMATTER_FPRINTF)
 #include <stdio.h>
 #define PRINT_S "fprintf"
 #define PRINT(...) fprintf(stdout, __VA_ARGS__)
+#define SNPRINT(...) snprintf(__VA_ARGS__)
 #elif defined(CONFIG_APP_FORMATTER_FPRINTFCB)
 #include <sys/cbprintf.h>
 #define PRINT_S "fprintfcb"
 #define PRINT(...) fprintfcb(stdout, __VA_ARGS__)
+#define SNPRINT(...) snprintfcb(__VA_ARGS__)
 #else
 #error Unsupported configuration
 #endif
 
+#define CYCLES_ROUNDS 100
+
+static const double values[] = {
+	0.0, 1.5, -273.15, 3.14159265358979, 6.02214076e23,
+	1.602176634e-19, 1e300, 2.2250738585072014e-308,
+};
+
+/* Average cycles spent converting a floating point value, to compare
+ * formatter configurations such as CONFIG_CBPRINTF_FAST_CONVERSION.
+ */
+static uint32_t conversion_cycles(void)
+{
+	char buf[32];
+	uint32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < CYCLES_ROUNDS; i++) {
+		for (int j = 0; j < ARRAY_SIZE(values); j++) {
+			SNPRINT(buf, sizeof(buf), "%g", values[j]);
+			SNPRINT(buf, sizeof(buf), "%.3f", values[j]);
+		}
+	}
+
+	return (k_cycle_get_32() - start)
+		/ (uint32_t)(2 * CYCLES_ROUNDS * ARRAY_SIZE(values));
+}
+
 void main(void)
 {
-	PRINT("Hello with %s on %s\nComplete\n", PRINT_S, CONFIG_BOARD);
+	uint32_t cycles = conversion_cycles();
+
+	PRINT("Hello with %s on %s\n", PRINT_S, CONFIG_BOARD);
+	PRINT("Conversion: %u cycles\nComplete\n", cycles);
 }
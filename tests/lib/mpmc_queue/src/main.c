@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+#include <sys/mpmc_queue.h>
+
+#define QUEUE_ELEMS 8
+#define N_PRODUCERS 3
+#define N_CONSUMERS 2
+#define PER_PRODUCER 2000
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+struct elem {
+	uint16_t producer;
+	uint16_t seq;
+	uint32_t payload;
+};
+
+MPMC_QUEUE_DEFINE(queue, sizeof(struct elem), QUEUE_ELEMS);
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, N_PRODUCERS + N_CONSUMERS,
+				   STACK_SIZE);
+static struct k_thread threads[N_PRODUCERS + N_CONSUMERS];
+static struct k_poll_signal signal;
+static atomic_t received;
+static atomic_t received_sum;
+static atomic_t errors;
+
+/**
+ * @brief Test adding and removing elements in a single thread
+ *
+ * @see mpmc_queue_put(), mpmc_queue_get()
+ */
+void test_mpmc_queue_basic(void)
+{
+	struct elem in = { 0 }, out;
+	int i, lap;
+
+	for (lap = 0; lap < 4; lap++) {
+		for (i = 0; i < QUEUE_ELEMS; i++) {
+			in.seq = i;
+			in.payload = lap;
+			zassert_equal(mpmc_queue_put(&queue, &in), 0,
+				      "put %d failed", i);
+		}
+
+		zassert_equal(mpmc_queue_put(&queue, &in), -ENOMEM,
+			      "put into full queue");
+		zassert_equal(mpmc_queue_size_get(&queue), QUEUE_ELEMS,
+			      "wrong size");
+
+		for (i = 0; i < QUEUE_ELEMS; i++) {
+			zassert_equal(mpmc_queue_get(&queue, &out), 0,
+				      "get %d failed", i);
+			zassert_equal(out.seq, i, "got %u, expected %d",
+				      out.seq, i);
+			zassert_equal(out.payload, lap, "wrong payload");
+		}
+
+		zassert_equal(mpmc_queue_get(&queue, &out), -EAGAIN,
+			      "get from empty queue");
+	}
+}
+
+static void isr_put(const void *arg)
+{
+	zassert_equal(mpmc_queue_put(&queue, arg), 0, "put from ISR failed");
+}
+
+/**
+ * @brief Test adding elements from an ISR
+ *
+ * @see mpmc_queue_put()
+ */
+void test_mpmc_queue_isr(void)
+{
+	struct elem in = { .producer = 1, .seq = 2, .payload = 3 }, out;
+
+	irq_offload(isr_put, &in);
+
+	zassert_equal(mpmc_queue_get(&queue, &out), 0, "get failed");
+	zassert_mem_equal(&in, &out, sizeof(in), "data mismatch");
+}
+
+static void producer(void *p1, void *p2, void *p3)
+{
+	struct elem in = { .producer = POINTER_TO_UINT(p1) };
+
+	while (in.seq < PER_PRODUCER) {
+		in.payload = in.producer * PER_PRODUCER + in.seq;
+		if (mpmc_queue_put(&queue, &in) == 0) {
+			in.seq++;
+		} else {
+			k_yield();
+		}
+	}
+}
+
+static void consumer(void *p1, void *p2, void *p3)
+{
+	struct k_poll_event event = K_POLL_EVENT_INITIALIZER(
+		K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &signal);
+	int last_seq[N_PRODUCERS] = { -1, -1, -1 };
+	struct elem out;
+
+	while (atomic_get(&received) < N_PRODUCERS * PER_PRODUCER) {
+		if (mpmc_queue_get(&queue, &out) != 0) {
+			/* Bounded wait, the other consumer may take the
+			 * last elements after the signal was reset.
+			 */
+			(void)k_poll(&event, 1, K_MSEC(10));
+			k_poll_signal_reset(&signal);
+			event.state = K_POLL_STATE_NOT_READY;
+			continue;
+		}
+
+		/* Elements of one producer are dequeued in order */
+		if ((out.producer >= N_PRODUCERS)
+		    || ((int)out.seq <= last_seq[out.producer])
+		    || (out.payload != out.producer * PER_PRODUCER + out.seq)) {
+			atomic_inc(&errors);
+		} else {
+			last_seq[out.producer] = out.seq;
+		}
+
+		atomic_add(&received_sum, out.payload);
+		atomic_inc(&received);
+	}
+}
+
+/**
+ * @brief Test several producers and consumers running concurrently
+ *
+ * @details Check that each element is received exactly once and that
+ * elements from one producer are received in order.
+ *
+ * @see mpmc_queue_signal_set()
+ */
+void test_mpmc_queue_concurrent(void)
+{
+	int prio = K_PRIO_PREEMPT(k_thread_priority_get(k_current_get()) + 1);
+	uint32_t expected_sum = 0;
+	int i;
+
+	k_poll_signal_init(&signal);
+	mpmc_queue_signal_set(&queue, &signal);
+
+	for (i = 0; i < N_PRODUCERS * PER_PRODUCER; i++) {
+		expected_sum += i;
+	}
+
+	for (i = 0; i < N_CONSUMERS; i++) {
+		k_thread_create(&threads[N_PRODUCERS + i], stacks[N_PRODUCERS + i],
+				STACK_SIZE, consumer, NULL, NULL, NULL,
+				prio, 0, K_NO_WAIT);
+	}
+
+	for (i = 0; i < N_PRODUCERS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE, producer,
+				UINT_TO_POINTER(i), NULL, NULL,
+				prio, 0, K_NO_WAIT);
+	}
+
+	for (i = 0; i < N_PRODUCERS + N_CONSUMERS; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+	}
+
+	mpmc_queue_signal_set(&queue, NULL);
+
+	zassert_equal(atomic_get(&errors), 0, "out of order elements");
+	zassert_equal(atomic_get(&received), N_PRODUCERS * PER_PRODUCER,
+		      "wrong number of elements");
+	zassert_equal((uint32_t)atomic_get(&received_sum), expected_sum,
+		      "elements lost or duplicated");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(mpmc_queue,
+			 ztest_unit_test(test_mpmc_queue_basic),
+			 ztest_unit_test(test_mpmc_queue_isr),
+			 ztest_unit_test(test_mpmc_queue_concurrent)
+			 );
+	ztest_run_test_suite(mpmc_queue);
+}
@@ -548,6 +548,46 @@ void test_item_alloc_commit(void)
 	item_alloc_commit(false);
 }
 
+void item_alloc_discard(bool pow2)
+{
+	struct mpsc_pbuf_buffer buffer;
+
+	init(&buffer, false, pow2);
+
+	struct test_data_var *packet;
+	uint32_t len = 5;
+	int repeat = 1024;
+
+	for (int i = 0; i < repeat; i++) {
+		packet = (struct test_data_var *)mpsc_pbuf_alloc(&buffer, len,
+								 K_NO_WAIT);
+		zassert_true(packet, NULL);
+		packet->hdr.len = len;
+		mpsc_pbuf_discard(&buffer, (union mpsc_pbuf_generic *)packet);
+
+		packet = (struct test_data_var *)mpsc_pbuf_alloc(&buffer, len,
+								 K_NO_WAIT);
+		zassert_true(packet, NULL);
+		packet->hdr.len = len;
+		packet->data[0] = i;
+		mpsc_pbuf_commit(&buffer, (union mpsc_pbuf_generic *)packet);
+
+		/* Discarded packet is skipped. */
+		packet = (struct test_data_var *)mpsc_pbuf_claim(&buffer);
+		zassert_true(packet, NULL);
+		zassert_equal(packet->data[0], i, NULL);
+
+		mpsc_pbuf_free(&buffer, (union mpsc_pbuf_generic *)packet);
+		zassert_equal(mpsc_pbuf_claim(&buffer), NULL, NULL);
+	}
+}
+
+void test_item_alloc_discard(void)
+{
+	item_alloc_discard(true);
+	item_alloc_discard(false);
+}
+
 void item_max_alloc(bool overwrite)
 {
 	struct mpsc_pbuf_buffer buffer;
@@ -1074,6 +1114,7 @@ void test_main(void)
 		ztest_unit_test(test_benchmark_item_put_ext),
 		ztest_unit_test(test_benchmark_item_put_data),
 		ztest_unit_test(test_item_alloc_commit),
+		ztest_unit_test(test_item_alloc_discard),
 		ztest_unit_test(test_item_max_alloc),
 		ztest_unit_test(test_item_alloc_commit_saturate),
 		ztest_unit_test(test_item_alloc_preemption),
@@ -700,6 +700,67 @@ void test_sprintf_integer(void)
 
 }
 
+/**
+ *
+ * @brief Measure the cost of numeric conversions
+ *
+ * @details Formats a mix of integer and floating point values and
+ * reports the average number of cycles per call, so that formatter
+ * configurations such as CONFIG_CBPRINTF_FAST_CONVERSION can be
+ * compared by running the test variants on the same platform.
+ */
+#define CYCLES_ROUNDS 100
+
+void test_sprintf_cycles(void)
+{
+	static const unsigned int uvals[] = {
+		0, 7, 42, 1234, 65535, 1000000, 123456789, DEADBEEF,
+	};
+	static const double dvals[] = {
+		0.0, 1.5, -273.15, 3.14159265358979, 6.02214076e23,
+		1.602176634e-19, 1e300, 2.2250738585072014e-308,
+	};
+	char buffer[100];
+	uint32_t start;
+	uint32_t cycles;
+	int i, j;
+
+	start = k_cycle_get_32();
+	for (i = 0; i < CYCLES_ROUNDS; i++) {
+		for (j = 0; j < ARRAY_SIZE(uvals); j++) {
+			snprintf(buffer, sizeof(buffer), "%u %d %x",
+				 uvals[j], -(int)uvals[j], uvals[j]);
+		}
+	}
+	cycles = k_cycle_get_32() - start;
+
+	zassert_true((strcmp(buffer, DEADBEEF_UNSIGNED_STR " 559038737 "
+			     DEADBEEF_LHEX_STR) == 0),
+		     "snprintf(%%u %%d %%x).  Got '%s'", buffer);
+	TC_PRINT(" integer conversion: %u cycles per call\n",
+		 cycles / (uint32_t)(CYCLES_ROUNDS * ARRAY_SIZE(uvals)));
+
+	if (IS_MINIMAL_LIBC_NOFP) {
+		TC_PRINT(" MINIMAL_LIBC+CBPRINTF without FP support\n");
+		return;
+	}
+
+	start = k_cycle_get_32();
+	for (i = 0; i < CYCLES_ROUNDS; i++) {
+		for (j = 0; j < ARRAY_SIZE(dvals); j++) {
+			snprintf(buffer, sizeof(buffer), "%f %e %g",
+				 dvals[j], dvals[j], dvals[j]);
+		}
+	}
+	cycles = k_cycle_get_32() - start;
+
+	zassert_true((strcmp(buffer, "0.000000 2.225074e-308 2.22507e-308")
+		      == 0),
+		     "snprintf(%%f %%e %%g).  Got '%s'", buffer);
+	TC_PRINT(" floating point conversion: %u cycles per call\n",
+		 cycles / (uint32_t)(CYCLES_ROUNDS * ARRAY_SIZE(dvals)));
+}
+
 /**
  *
  * @brief Test sprintf with strings
@@ -957,6 +1018,7 @@ void test_main(void)
 			 ztest_unit_test(test_sprintf_misc),
 			 ztest_unit_test(test_sprintf_double),
 			 ztest_unit_test(test_sprintf_integer),
+			 ztest_unit_test(test_sprintf_cycles),
 			 ztest_unit_test(test_vsprintf),
 			 ztest_unit_test(test_vsnprintf),
 			 ztest_unit_test(test_sprintf_string),
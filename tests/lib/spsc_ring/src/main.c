@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/spsc_ring.h>
+
+#define RING_ELEMS 16
+#define STREAM_LEN 10000
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+SPSC_RING_DEFINE(byte_ring, 1, RING_ELEMS);
+SPSC_RING_DEFINE(word_ring, sizeof(uint32_t), RING_ELEMS);
+
+static K_THREAD_STACK_DEFINE(producer_stack, STACK_SIZE);
+static struct k_thread producer_thread;
+static struct k_poll_signal signal;
+
+/**
+ * @brief Test putting and getting bytes, including wrap-around
+ *
+ * @see spsc_ring_put(), spsc_ring_get()
+ */
+void test_spsc_ring_bytes(void)
+{
+	uint8_t in[RING_ELEMS + 4];
+	uint8_t out[RING_ELEMS + 4];
+	uint32_t n;
+	int i, lap;
+
+	for (i = 0; i < sizeof(in); i++) {
+		in[i] = i;
+	}
+
+	n = spsc_ring_put(&byte_ring, in, sizeof(in));
+	zassert_equal(n, RING_ELEMS, "put %u bytes into full ring", n);
+	zassert_equal(spsc_ring_space_get(&byte_ring), 0, "ring not full");
+	zassert_equal(spsc_ring_put(&byte_ring, in, 1), 0, "put into full ring");
+
+	n = spsc_ring_get(&byte_ring, out, sizeof(out));
+	zassert_equal(n, RING_ELEMS, "got %u bytes", n);
+	zassert_mem_equal(in, out, RING_ELEMS, "data mismatch");
+	zassert_equal(spsc_ring_get(&byte_ring, out, 1), 0, "got from empty ring");
+
+	/* Uneven chunks so that copies wrap around the end */
+	for (lap = 0; lap < 3 * RING_ELEMS; lap++) {
+		n = spsc_ring_put(&byte_ring, in, 7);
+		zassert_equal(n, 7, "put %u bytes", n);
+		zassert_equal(spsc_ring_size_get(&byte_ring), 7, "wrong size");
+
+		(void)memset(out, 0, sizeof(out));
+		n = spsc_ring_get(&byte_ring, out, sizeof(out));
+		zassert_equal(n, 7, "got %u bytes", n);
+		zassert_mem_equal(in, out, 7, "data mismatch at lap %d", lap);
+	}
+}
+
+static void producer(void *p1, void *p2, void *p3)
+{
+	uint32_t val = 0;
+
+	while (val < STREAM_LEN) {
+		if (spsc_ring_put(&word_ring, &val, 1) == 1) {
+			val++;
+		} else {
+			k_yield();
+		}
+	}
+}
+
+/**
+ * @brief Test streaming elements between two threads with k_poll()
+ *
+ * @details The consumer waits on the poll signal raised by the
+ * producer and checks that the elements arrive complete and in order.
+ *
+ * @see spsc_ring_signal_set()
+ */
+void test_spsc_ring_poll(void)
+{
+	struct k_poll_event event = K_POLL_EVENT_INITIALIZER(
+		K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &signal);
+	uint32_t expected = 0;
+	uint32_t val;
+	int ret;
+
+	k_poll_signal_init(&signal);
+	spsc_ring_signal_set(&word_ring, &signal);
+
+	k_thread_create(&producer_thread, producer_stack, STACK_SIZE,
+			producer, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(k_thread_priority_get(k_current_get())),
+			0, K_NO_WAIT);
+
+	while (expected < STREAM_LEN) {
+		ret = k_poll(&event, 1, K_MSEC(1000));
+		zassert_equal(ret, 0, "no signal, %u elements received",
+			      expected);
+
+		k_poll_signal_reset(&signal);
+		event.state = K_POLL_STATE_NOT_READY;
+
+		while (spsc_ring_get(&word_ring, &val, 1) == 1) {
+			zassert_equal(val, expected, "got %u, expected %u",
+				      val, expected);
+			expected++;
+		}
+	}
+
+	k_thread_join(&producer_thread, K_FOREVER);
+	spsc_ring_signal_set(&word_ring, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(spsc_ring,
+			 ztest_unit_test(test_spsc_ring_bytes),
+			 ztest_unit_test(test_spsc_ring_poll)
+			 );
+	ztest_run_test_suite(spsc_ring);
+}
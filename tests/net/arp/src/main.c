@@ -45,6 +45,10 @@ static struct net_eth_addr hwaddr = { { 0x42, 0x11, 0x69, 0xde, 0xfa, 0xec } };
 
 static int send_status = -EINVAL;
 
+/* Unicast ARP requests refreshing a cache entry */
+static int refresh_count;
+static struct net_eth_addr refresh_hwaddr;
+
 struct net_arp_context {
 	uint8_t mac_addr[sizeof(struct net_eth_addr)];
 	struct net_linkaddr ll_addr;
@@ -94,6 +98,19 @@ static int tester_send(const struct device *dev, struct net_pkt *pkt)
 
 	hdr = (struct net_eth_hdr *)net_pkt_data(pkt);
 
+	if (ntohs(hdr->type) == NET_ETH_PTYPE_ARP && pkt->frags->frags &&
+	    memcmp(&hdr->dst, net_eth_broadcast_addr(),
+		   sizeof(struct net_eth_addr))) {
+		struct net_arp_hdr *arp_hdr =
+			(struct net_arp_hdr *)pkt->frags->frags->data;
+
+		if (ntohs(arp_hdr->opcode) == NET_ARP_REQUEST) {
+			memcpy(&refresh_hwaddr, &arp_hdr->dst_hwaddr,
+			       sizeof(struct net_eth_addr));
+			refresh_count++;
+		}
+	}
+
 	if (ntohs(hdr->type) == NET_ETH_PTYPE_ARP) {
 		/* First frag has eth hdr */
 		struct net_arp_hdr *arp_hdr =
@@ -306,6 +323,8 @@ NET_DEVICE_INIT(net_arp_test, "net_arp_test",
 		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
 		&net_arp_if_api, _ETH_L2_LAYER, _ETH_L2_CTX_TYPE, 127);
 
+static uint32_t entry_hits;
+
 static void arp_cb(struct arp_entry *entry, void *user_data)
 {
 	struct in_addr *addr = user_data;
@@ -314,6 +333,7 @@ static void arp_cb(struct arp_entry *entry, void *user_data)
 	    memcmp(&entry->eth, expected_hwaddr,
 		   sizeof(struct net_eth_addr)) == 0) {
 		entry_found = true;
+		entry_hits = entry->hits;
 	}
 }
 
@@ -647,9 +667,165 @@ void test_arp(void)
 	}
 }
 
+static void feed_arp(struct net_if *iface, uint16_t opcode,
+		     struct net_eth_addr *src_hwaddr, struct in_addr *src_ip,
+		     struct in_addr *dst_ip)
+{
+	struct net_eth_hdr *eth_hdr;
+	struct net_arp_hdr *arp_hdr;
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(iface, sizeof(struct net_eth_hdr) +
+					sizeof(struct net_arp_hdr),
+					AF_UNSPEC, 0, K_SECONDS(1));
+	zassert_not_null(pkt, "out of mem");
+
+	eth_hdr = (struct net_eth_hdr *)net_pkt_data(pkt);
+	memcpy(&eth_hdr->dst, net_if_get_link_addr(iface)->addr,
+	       sizeof(struct net_eth_addr));
+	memcpy(&eth_hdr->src, src_hwaddr, sizeof(struct net_eth_addr));
+	eth_hdr->type = htons(NET_ETH_PTYPE_ARP);
+
+	net_buf_add(pkt->buffer, sizeof(struct net_eth_hdr));
+	net_buf_pull(pkt->buffer, sizeof(struct net_eth_hdr));
+	arp_hdr = NET_ARP_HDR(pkt);
+
+	arp_hdr->hwtype = htons(NET_ARP_HTYPE_ETH);
+	arp_hdr->protocol = htons(NET_ETH_PTYPE_IP);
+	arp_hdr->hwlen = sizeof(struct net_eth_addr);
+	arp_hdr->protolen = sizeof(struct in_addr);
+	arp_hdr->opcode = htons(opcode);
+	memcpy(&arp_hdr->src_hwaddr, src_hwaddr, sizeof(struct net_eth_addr));
+	(void)memset(&arp_hdr->dst_hwaddr, 0, sizeof(struct net_eth_addr));
+	net_ipaddr_copy(&arp_hdr->src_ipaddr, src_ip);
+	net_ipaddr_copy(&arp_hdr->dst_ipaddr, dst_ip);
+
+	net_buf_add(pkt->buffer, sizeof(struct net_arp_hdr));
+
+	zassert_equal(net_arp_input(pkt, eth_hdr), NET_OK,
+		      "ARP packet dropped");
+}
+
+/* Return true if the neighbor address is known, false if the packet
+ * has to wait for an ARP reply.
+ */
+static bool send_ipv4(struct net_if *iface, struct in_addr *src,
+		      struct in_addr *dst)
+{
+	struct net_ipv4_hdr *ipv4;
+	struct net_pkt *pkt, *ret;
+
+	pkt = net_pkt_alloc_with_buffer(iface, sizeof(struct net_ipv4_hdr),
+					AF_INET, 0, K_SECONDS(1));
+	zassert_not_null(pkt, "out of mem");
+
+	ipv4 = (struct net_ipv4_hdr *)net_buf_add(pkt->buffer,
+						  sizeof(struct net_ipv4_hdr));
+	net_ipaddr_copy(&ipv4->src, src);
+	net_ipaddr_copy(&ipv4->dst, dst);
+
+	ret = net_arp_prepare(pkt, &ipv4->dst, NULL);
+	zassert_not_null(ret, "ARP prepare failed");
+
+	/* Let the TX thread send any refresh request */
+	k_msleep(10);
+
+	if (ret != pkt) {
+		/* The ARP cache holds the packet until the reply */
+		net_pkt_unref(ret);
+		net_pkt_unref(pkt);
+
+		return false;
+	}
+
+	net_pkt_unref(pkt);
+
+	return true;
+}
+
+void test_arp_refresh(void)
+{
+	struct net_eth_addr nbr_hwaddr = {
+		{ 0x00, 0x00, 0x5e, 0x00, 0x53, 0x42 }
+	};
+	struct net_eth_addr spoof_hwaddr = {
+		{ 0x00, 0x00, 0x5e, 0x00, 0x53, 0x66 }
+	};
+	struct in_addr nbr_ip = { { { 192, 168, 0, 3 } } };
+	struct in_addr src = { { { 192, 168, 0, 1 } } };
+	struct net_if *iface;
+
+	if (CONFIG_NET_ARP_ENTRY_TIMEOUT == 0) {
+		ztest_test_skip();
+	}
+
+	iface = net_if_lookup_by_dev(DEVICE_GET(net_arp_test));
+
+	net_arp_clear_cache(iface);
+	req_test = true;
+
+	/* The neighbor asks for our address, so we learn its address */
+	feed_arp(iface, NET_ARP_REQUEST, &nbr_hwaddr, &nbr_ip, &src);
+	k_msleep(10);
+
+	zassert_true(send_ipv4(iface, &src, &nbr_ip),
+		     "Neighbor not in cache");
+	zassert_true(send_ipv4(iface, &src, &nbr_ip),
+		     "Neighbor not in cache");
+	zassert_equal(refresh_count, 0, "Fresh entry refreshed");
+
+	entry_found = false;
+	expected_hwaddr = &nbr_hwaddr;
+	net_arp_foreach(arp_cb, &nbr_ip);
+	zassert_true(entry_found, "Entry not found");
+	zassert_equal(entry_hits, 2, "Invalid hit count %u", entry_hits);
+
+	/* An unsolicited reply does not redirect the entry */
+	feed_arp(iface, NET_ARP_REPLY, &spoof_hwaddr, &nbr_ip, &src);
+
+	entry_found = false;
+	net_arp_foreach(arp_cb, &nbr_ip);
+	zassert_true(entry_found, "Entry changed by an unsolicited reply");
+
+	/* Close to its expiry the entry keeps being used, and the neighbor
+	 * is asked to confirm it, only once per request timeout.
+	 */
+	k_msleep((CONFIG_NET_ARP_ENTRY_TIMEOUT -
+		  CONFIG_NET_ARP_ENTRY_REFRESH_TIME) * MSEC_PER_SEC + 100);
+
+	zassert_true(send_ipv4(iface, &src, &nbr_ip),
+		     "Entry not used while refreshed");
+	zassert_true(send_ipv4(iface, &src, &nbr_ip),
+		     "Entry not used while refreshed");
+	zassert_equal(refresh_count, 1, "Invalid refresh count %d",
+		      refresh_count);
+	zassert_mem_equal(&refresh_hwaddr, &nbr_hwaddr,
+			  sizeof(struct net_eth_addr),
+			  "Refresh request not sent to the neighbor");
+
+	/* The reply confirms the entry for a whole new lifetime */
+	feed_arp(iface, NET_ARP_REPLY, &nbr_hwaddr, &nbr_ip, &src);
+
+	k_msleep((CONFIG_NET_ARP_ENTRY_TIMEOUT -
+		  CONFIG_NET_ARP_ENTRY_REFRESH_TIME) * MSEC_PER_SEC - 100);
+
+	zassert_true(send_ipv4(iface, &src, &nbr_ip),
+		     "Confirmed entry not used");
+	zassert_equal(refresh_count, 1, "Confirmed entry refreshed");
+
+	/* Without any reply the entry expires */
+	k_msleep(CONFIG_NET_ARP_ENTRY_TIMEOUT * MSEC_PER_SEC);
+
+	zassert_false(send_ipv4(iface, &src, &nbr_ip),
+		      "Expired entry used");
+
+	net_arp_clear_cache(iface);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_arp_fn,
-		ztest_unit_test(test_arp));
+		ztest_unit_test(test_arp),
+		ztest_unit_test(test_arp_refresh));
 	ztest_run_test_suite(test_arp_fn);
 }
@@ -0,0 +1,362 @@
+/* main.c - Application main entry point */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_CORE_LOG_LEVEL);
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/printk.h>
+#include <linker/sections.h>
+#include <random/rand32.h>
+
+#include <ztest.h>
+
+#include <net/ethernet.h>
+#include <net/dummy.h>
+#include <net/buf.h>
+#include <net/net_ip.h>
+#include <net/net_if.h>
+
+#define NET_LOG_ENABLED 1
+#include "net_private.h"
+
+#include "ipv4.h"
+#include "udp_internal.h"
+
+static struct in_addr my_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+
+#define LOCAL_PORT 4242
+#define PEER_PORT 4343
+
+#define HDRS_LEN (sizeof(struct net_ipv4_hdr) + sizeof(struct net_udp_hdr))
+
+/* More than one TX batch of CONFIG_NET_TC_TX_BATCH packets */
+#define BURST_LEN 6
+
+#define WAIT_TIME K_SECONDS(1)
+
+#define ALLOC_TIMEOUT K_MSEC(500)
+
+static struct net_if *iface1;
+
+/* The packets seen by the driver, and whether more were announced */
+static bool sent_more[BURST_LEN];
+static int sent_count;
+static struct k_sem wait_sent;
+
+/* Number of times the driver was told to send what it held back */
+static int flush_count;
+static struct k_sem wait_flush;
+
+/* Payload byte of the packets received by the UDP handler, in order */
+static uint8_t recv_idx[BURST_LEN];
+static int recv_count;
+static struct k_sem wait_recv;
+
+struct net_if_test {
+	uint8_t mac_addr[sizeof(struct net_eth_addr)];
+};
+
+static int net_iface_dev_init(const struct device *dev)
+{
+	return 0;
+}
+
+static uint8_t *net_iface_get_mac(const struct device *dev)
+{
+	struct net_if_test *data = dev->data;
+
+	if (data->mac_addr[2] == 0x00) {
+		/* 00-00-5E-00-53-xx Documentation RFC 7042 */
+		data->mac_addr[0] = 0x00;
+		data->mac_addr[1] = 0x00;
+		data->mac_addr[2] = 0x5E;
+		data->mac_addr[3] = 0x00;
+		data->mac_addr[4] = 0x53;
+		data->mac_addr[5] = sys_rand32_get();
+	}
+
+	return data->mac_addr;
+}
+
+static void net_iface_init(struct net_if *iface)
+{
+	uint8_t *mac = net_iface_get_mac(net_if_get_device(iface));
+
+	net_if_set_link_addr(iface, mac, sizeof(struct net_eth_addr),
+			     NET_LINK_ETHERNET);
+}
+
+static int sender_iface(const struct device *dev, struct net_pkt *pkt)
+{
+	if (!pkt->buffer) {
+		NET_DBG("No data to send!");
+		return -ENODATA;
+	}
+
+	if (sent_count < BURST_LEN) {
+		sent_more[sent_count++] = net_pkt_tx_more(pkt);
+	}
+
+	k_sem_give(&wait_sent);
+
+	return 0;
+}
+
+static void flush_iface(struct net_if *iface)
+{
+	flush_count++;
+	k_sem_give(&wait_flush);
+}
+
+struct net_if_test net_iface1_data;
+
+static struct dummy_api net_iface_api = {
+	.iface_api.init = net_iface_init,
+	.iface_api.tx_flush = flush_iface,
+	.send = sender_iface,
+};
+
+NET_DEVICE_INIT_INSTANCE(net_iface1_test,
+			 "iface1",
+			 iface1,
+			 net_iface_dev_init,
+			 NULL,
+			 &net_iface1_data,
+			 NULL,
+			 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+			 &net_iface_api,
+			 DUMMY_L2,
+			 NET_L2_GET_CTX_TYPE(DUMMY_L2),
+			 127);
+
+static enum net_verdict udp_handler(struct net_conn *conn,
+				    struct net_pkt *pkt,
+				    union net_ip_header *ip_hdr,
+				    union net_proto_header *proto_hdr,
+				    void *user_data)
+{
+	uint8_t idx;
+
+	net_pkt_cursor_init(pkt);
+
+	if (net_pkt_skip(pkt, HDRS_LEN) == 0 &&
+	    net_pkt_read_u8(pkt, &idx) == 0 && recv_count < BURST_LEN) {
+		recv_idx[recv_count++] = idx;
+	}
+
+	net_pkt_unref(pkt);
+	k_sem_give(&wait_recv);
+
+	return NET_OK;
+}
+
+/* Create a datagram sent by the peer, its payload is its index */
+static struct net_pkt *create_datagram(uint8_t idx)
+{
+	struct net_ipv4_hdr hdr = { 0 };
+	struct net_udp_hdr udp_hdr = { 0 };
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface1, HDRS_LEN + 1, AF_UNSPEC, 0,
+					   ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "Cannot allocate datagram");
+
+	hdr.vhl = 0x45;
+	hdr.len = htons(HDRS_LEN + 1);
+	hdr.ttl = 64U;
+	hdr.proto = IPPROTO_UDP;
+	net_ipaddr_copy(&hdr.src, &peer_addr);
+	net_ipaddr_copy(&hdr.dst, &my_addr);
+
+	udp_hdr.src_port = htons(PEER_PORT);
+	udp_hdr.dst_port = htons(LOCAL_PORT);
+	udp_hdr.len = htons(sizeof(udp_hdr) + 1);
+
+	zassert_equal(net_pkt_write(pkt, &hdr, sizeof(hdr)), 0,
+		      "IPv4 header append failed");
+	zassert_equal(net_pkt_write(pkt, &udp_hdr, sizeof(udp_hdr)), 0,
+		      "UDP header append failed");
+	zassert_equal(net_pkt_write_u8(pkt, idx), 0, "Cannot write payload");
+
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(hdr));
+	net_pkt_set_ipv4_opts_len(pkt, 0);
+
+	NET_IPV4_HDR(pkt)->chksum = net_calc_chksum_ipv4(pkt);
+	((struct net_udp_hdr *)(pkt->buffer->data + sizeof(hdr)))->chksum =
+		net_calc_chksum_udp(pkt);
+
+	return pkt;
+}
+
+static void test_setup(void)
+{
+	struct net_conn_handle *handle;
+	struct sockaddr_in local = {
+		.sin_family = AF_INET,
+	};
+	struct net_if_addr *ifaddr;
+	int ret;
+
+	k_sem_init(&wait_sent, 0, UINT_MAX);
+	k_sem_init(&wait_recv, 0, UINT_MAX);
+	k_sem_init(&wait_flush, 0, UINT_MAX);
+
+	iface1 = net_if_get_by_index(1);
+	zassert_not_null(iface1, "Interface 1");
+
+	ifaddr = net_if_ipv4_addr_add(iface1, &my_addr, NET_ADDR_MANUAL, 0);
+	zassert_not_null(ifaddr, "Cannot add IPv4 address");
+
+	net_ipaddr_copy(&local.sin_addr, &my_addr);
+
+	ret = net_udp_register(AF_INET, NULL, (struct sockaddr *)&local, 0,
+			       LOCAL_PORT, NULL, udp_handler, NULL, &handle);
+	zassert_equal(ret, 0, "Cannot register UDP handler (%d)", ret);
+}
+
+static void test_recv_burst(void)
+{
+	sys_slist_t list;
+	struct net_pkt *pkt;
+	int i, ret;
+
+	sys_slist_init(&list);
+	recv_count = 0;
+
+	for (i = 0; i < BURST_LEN; i++) {
+		pkt = create_datagram(i);
+		sys_slist_append(&list, &pkt->burst);
+	}
+
+	ret = net_recv_data_list(iface1, &list);
+	zassert_equal(ret, BURST_LEN, "Invalid count %d", ret);
+	zassert_true(sys_slist_is_empty(&list), "List not consumed");
+
+	for (i = 0; i < BURST_LEN; i++) {
+		zassert_equal(k_sem_take(&wait_recv, WAIT_TIME), 0,
+			      "Datagram %d not received", i);
+	}
+
+	for (i = 0; i < BURST_LEN; i++) {
+		zassert_equal(recv_idx[i], i, "Datagram %d out of order", i);
+	}
+}
+
+static void test_recv_burst_empty_pkt(void)
+{
+	sys_slist_t list;
+	struct net_pkt *pkt;
+	int ret;
+
+	sys_slist_init(&list);
+	recv_count = 0;
+
+	pkt = net_pkt_rx_alloc(ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "Cannot allocate packet");
+	sys_slist_append(&list, &pkt->burst);
+
+	pkt = create_datagram(0);
+	sys_slist_append(&list, &pkt->burst);
+
+	/* The empty packet is dropped, the other one goes through */
+	ret = net_recv_data_list(iface1, &list);
+	zassert_equal(ret, 1, "Invalid count %d", ret);
+	zassert_equal(k_sem_take(&wait_recv, WAIT_TIME), 0,
+		      "Datagram not received");
+}
+
+static void test_recv_burst_iface_down(void)
+{
+	sys_slist_t list;
+	struct net_pkt *pkt;
+	int ret;
+
+	sys_slist_init(&list);
+
+	pkt = create_datagram(0);
+	sys_slist_append(&list, &pkt->burst);
+
+	zassert_equal(net_if_down(iface1), 0, "Cannot take iface down");
+
+	ret = net_recv_data_list(iface1, &list);
+	zassert_equal(ret, -ENETDOWN, "Invalid result %d", ret);
+	zassert_equal(sys_slist_peek_head(&list), &pkt->burst,
+		      "Caller should still own the packet");
+
+	zassert_equal(net_if_up(iface1), 0, "Cannot take iface up");
+
+	net_pkt_unref(pkt);
+}
+
+static void test_tx_batch(void)
+{
+	struct net_pkt *pkt;
+	int i;
+
+	sent_count = 0;
+	flush_count = 0;
+
+	/* Queue the packets before the TX thread gets to run */
+	k_sched_lock();
+
+	for (i = 0; i < BURST_LEN; i++) {
+		pkt = net_pkt_alloc_with_buffer(iface1, 1, AF_UNSPEC, 0,
+						ALLOC_TIMEOUT);
+		zassert_not_null(pkt, "Cannot allocate packet");
+		zassert_equal(net_pkt_write_u8(pkt, i), 0,
+			      "Cannot write payload");
+
+		net_if_queue_tx(iface1, pkt);
+	}
+
+	k_sched_unlock();
+
+	for (i = 0; i < BURST_LEN; i++) {
+		zassert_equal(k_sem_take(&wait_sent, WAIT_TIME), 0,
+			      "Packet %d not sent", i);
+	}
+
+	/* Only the last packet of each batch has nothing following it */
+	for (i = 0; i < BURST_LEN; i++) {
+		bool last = (i % CONFIG_NET_TC_TX_BATCH ==
+			     CONFIG_NET_TC_TX_BATCH - 1) || i == BURST_LEN - 1;
+
+		zassert_equal(sent_more[i], !last, "Packet %d: invalid flag",
+			      i);
+	}
+
+	/* Every batch held packets back, each one ends with a flush */
+	for (i = 0; i < ceiling_fraction(BURST_LEN, CONFIG_NET_TC_TX_BATCH);
+	     i++) {
+		zassert_equal(k_sem_take(&wait_flush, WAIT_TIME), 0,
+			      "Batch %d not flushed", i);
+	}
+
+	zassert_equal(k_sem_take(&wait_flush, K_MSEC(100)), -EAGAIN,
+		      "Too many flushes (%d)", flush_count);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_burst_test,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_recv_burst),
+			 ztest_unit_test(test_recv_burst_empty_pkt),
+			 ztest_unit_test(test_recv_burst_iface_down),
+			 ztest_unit_test(test_tx_batch)
+			 );
+
+	ztest_run_test_suite(net_burst_test);
+}
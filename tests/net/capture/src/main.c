@@ -0,0 +1,624 @@
+/* main.c - Application main entry point */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_CAPTURE_LOG_LEVEL);
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/byteorder.h>
+
+#include <ztest.h>
+
+#include <net/ethernet.h>
+#include <net/dummy.h>
+#include <net/buf.h>
+#include <net/net_ip.h>
+#include <net/net_if.h>
+#include <net/net_context.h>
+#include <net/capture.h>
+
+#define NET_LOG_ENABLED 1
+#include "net_private.h"
+
+static struct in_addr my_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+static struct in_addr other_addr = { { { 198, 51, 100, 1 } } };
+static struct in_addr netmask = { { { 255, 255, 255, 0 } } };
+
+static struct in6_addr my_addr6 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+static struct in6_addr peer_addr6 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					  0, 0, 0, 0, 0, 0, 0, 0x2 } } };
+static struct in6_addr ll_addr6 = { { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+					0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+
+#define TEST_PORT 4242
+
+#define LINKTYPE_ETHERNET 1
+#define LINKTYPE_RAW 101
+
+/* Every test packet has a different length, telling which one it is */
+#define PKT_BASE_LEN 60
+
+enum test_pkt {
+	UDP4,		/* 192.0.2.1:1000 -> 192.0.2.2:53 */
+	TCP4,		/* 192.0.2.1:1000 -> 192.0.2.2:80 */
+	ICMP4,		/* 198.51.100.1 -> 192.0.2.1 */
+	UDP6,		/* [2001:db8::1]:53 -> [2001:db8::2]:1000 */
+	TCP6,		/* [fe80::1]:22 -> [2001:db8::1]:2000 */
+	ICMP6,		/* 2001:db8::1 -> 2001:db8::2 */
+	FRAG4,		/* Second fragment of a UDP datagram, no ports */
+	ETH_UDP4,	/* VLAN tagged 192.0.2.1:1000 -> 192.0.2.2:53 */
+	ETH_ARP,
+	N_PKTS
+};
+
+static uint8_t pkt_data[N_PKTS][PKT_BASE_LEN + N_PKTS];
+
+static struct net_if *iface1;
+static struct net_if *iface2;
+
+/* The exported pcapng stream and the packets found in it */
+static uint8_t out[4096];
+static size_t out_len;
+
+struct test_epb {
+	uint32_t ifid;
+	uint32_t caplen;
+	uint32_t len;
+	const uint8_t *data;
+};
+
+static struct test_epb epbs[64];
+static int epb_count;
+static uint16_t link_types[4];
+static int idb_count;
+
+static int net_iface_dev_init(const struct device *dev)
+{
+	return 0;
+}
+
+static void net_iface_init(struct net_if *iface)
+{
+	static uint8_t mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_ETHERNET);
+}
+
+static int sender_iface(const struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static struct dummy_api net_iface_api = {
+	.iface_api.init = net_iface_init,
+	.send = sender_iface,
+};
+
+NET_DEVICE_INIT(net_capture_test, "net_capture_test",
+		net_iface_dev_init, NULL, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&net_iface_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), 1280);
+
+static void eth_fake_iface_init(struct net_if *iface)
+{
+	static uint8_t mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x02 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_ETHERNET);
+
+	ethernet_init(iface);
+}
+
+static int eth_fake_send(const struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static struct ethernet_api eth_fake_api_funcs = {
+	.iface_api.init = eth_fake_iface_init,
+	.send = eth_fake_send,
+};
+
+static int eth_fake_init(const struct device *dev)
+{
+	return 0;
+}
+
+ETH_NET_DEVICE_INIT(eth_fake, "eth_fake", eth_fake_init, NULL, NULL, NULL,
+		    CONFIG_ETH_INIT_PRIORITY, &eth_fake_api_funcs,
+		    NET_ETH_MTU);
+
+static size_t build_ip(uint8_t *buf, sa_family_t family, uint8_t proto,
+		       const void *src, const void *dst, uint16_t src_port,
+		       uint16_t dst_port, uint16_t frag_offset)
+{
+	size_t len;
+
+	if (family == AF_INET) {
+		buf[0] = 0x45;
+		sys_put_be16(frag_offset / 8, &buf[6]);
+		buf[8] = 64;
+		buf[9] = proto;
+		memcpy(&buf[12], src, sizeof(struct in_addr));
+		memcpy(&buf[16], dst, sizeof(struct in_addr));
+		len = sizeof(struct net_ipv4_hdr);
+	} else {
+		buf[0] = 0x60;
+		buf[6] = proto;
+		buf[7] = 64;
+		memcpy(&buf[8], src, sizeof(struct in6_addr));
+		memcpy(&buf[24], dst, sizeof(struct in6_addr));
+		len = sizeof(struct net_ipv6_hdr);
+	}
+
+	sys_put_be16(src_port, &buf[len]);
+	sys_put_be16(dst_port, &buf[len + 2]);
+
+	return len;
+}
+
+static size_t build_eth(uint8_t *buf, uint16_t type)
+{
+	static const uint8_t macs[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x02,
+					0x00, 0x00, 0x5E, 0x00, 0x53, 0x03 };
+
+	memcpy(buf, macs, sizeof(macs));
+	sys_put_be16(type, &buf[12]);
+
+	return sizeof(struct net_eth_hdr);
+}
+
+static void build_pkts(void)
+{
+	uint8_t *buf;
+
+	build_ip(pkt_data[UDP4], AF_INET, IPPROTO_UDP, &my_addr, &peer_addr,
+		 1000, 53, 0);
+	build_ip(pkt_data[TCP4], AF_INET, IPPROTO_TCP, &my_addr, &peer_addr,
+		 1000, 80, 0);
+	build_ip(pkt_data[ICMP4], AF_INET, IPPROTO_ICMP, &other_addr, &my_addr,
+		 0, 0, 0);
+	build_ip(pkt_data[UDP6], AF_INET6, IPPROTO_UDP, &my_addr6,
+		 &peer_addr6, 53, 1000, 0);
+	build_ip(pkt_data[TCP6], AF_INET6, IPPROTO_TCP, &ll_addr6, &my_addr6,
+		 22, 2000, 0);
+	build_ip(pkt_data[ICMP6], AF_INET6, IPPROTO_ICMPV6, &my_addr6,
+		 &peer_addr6, 0, 0, 0);
+	build_ip(pkt_data[FRAG4], AF_INET, IPPROTO_UDP, &my_addr, &peer_addr,
+		 53, 53, 1480);
+
+	buf = pkt_data[ETH_UDP4];
+	buf += build_eth(buf, NET_ETH_PTYPE_VLAN);
+	sys_put_be16(100, buf);
+	sys_put_be16(NET_ETH_PTYPE_IP, buf + 2);
+	build_ip(buf + 4, AF_INET, IPPROTO_UDP, &my_addr, &peer_addr,
+		 1000, 53, 0);
+
+	build_eth(pkt_data[ETH_ARP], NET_ETH_PTYPE_ARP);
+}
+
+static void capture(struct net_if *iface, const uint8_t *data, size_t len)
+{
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(iface, len, AF_UNSPEC, 0, K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	zassert_equal(net_pkt_write(pkt, data, len), 0, "Cannot write pkt");
+
+	net_capture_pkt(iface, pkt);
+
+	net_pkt_unref(pkt);
+}
+
+static void capture_test_pkts(void)
+{
+	int i;
+
+	for (i = 0; i < N_PKTS; i++) {
+		capture(i < ETH_UDP4 ? iface1 : iface2, pkt_data[i],
+			PKT_BASE_LEN + i);
+	}
+}
+
+static int collect_cb(const void *data, size_t len, void *user_data)
+{
+	if (out_len + len > sizeof(out)) {
+		return -ENOSPC;
+	}
+
+	memcpy(out + out_len, data, len);
+	out_len += len;
+
+	return 0;
+}
+
+static void export(void)
+{
+	uint32_t type, len, magic;
+	size_t offset = 0;
+	int ret;
+
+	out_len = 0;
+	epb_count = 0;
+	idb_count = 0;
+
+	ret = net_capture_ring_export(collect_cb, NULL);
+	zassert_true(ret >= 0, "Export failed (%d)", ret);
+
+	while (offset < out_len) {
+		zassert_true(offset + 12 <= out_len, "Truncated block");
+
+		memcpy(&type, &out[offset], sizeof(type));
+		memcpy(&len, &out[offset + 4], sizeof(len));
+
+		zassert_true(len >= 12 && len % 4 == 0 &&
+			     offset + len <= out_len,
+			     "Invalid block length %u", len);
+		zassert_mem_equal(&out[offset + len - 4], &len, sizeof(len),
+				  "Block length mismatch");
+
+		if (offset == 0) {
+			zassert_equal(type, 0x0A0D0D0A, "No section header");
+
+			memcpy(&magic, &out[offset + 8], sizeof(magic));
+			zassert_equal(magic, 0x1A2B3C4D, "Invalid magic");
+		} else if (type == 1) {
+			zassert_true(idb_count < ARRAY_SIZE(link_types),
+				     "Too many interfaces");
+
+			memcpy(&link_types[idb_count++], &out[offset + 8],
+			       sizeof(link_types[0]));
+		} else if (type == 6) {
+			struct test_epb *epb = &epbs[epb_count++];
+
+			zassert_true(epb_count <= ARRAY_SIZE(epbs),
+				     "Too many packets");
+
+			memcpy(&epb->ifid, &out[offset + 8], 4);
+			memcpy(&epb->caplen, &out[offset + 20], 4);
+			memcpy(&epb->len, &out[offset + 24], 4);
+			epb->data = &out[offset + 28];
+
+			zassert_equal(len, 32 + ROUND_UP(epb->caplen, 4),
+				      "Invalid packet block length");
+			zassert_true(epb->ifid < idb_count,
+				     "Unknown interface %u", epb->ifid);
+		} else {
+			zassert_unreachable("Unknown block type %u", type);
+		}
+
+		offset += len;
+	}
+
+	zassert_equal(epb_count, ret, "Exported %d packets, found %d",
+		      ret, epb_count);
+}
+
+static void test_capture_setup(void)
+{
+	struct net_if_addr *ifaddr;
+
+	iface1 = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	iface2 = net_if_get_first_by_type(&NET_L2_GET_NAME(ETHERNET));
+
+	zassert_not_null(iface1, "No dummy interface");
+	zassert_not_null(iface2, "No ethernet interface");
+
+	ifaddr = net_if_ipv4_addr_add(iface1, &my_addr, NET_ADDR_MANUAL, 0);
+	zassert_not_null(ifaddr, "Cannot add IPv4 address");
+
+	net_if_ipv4_set_netmask(iface1, &netmask);
+
+	build_pkts();
+}
+
+static void test_capture_filter_syntax(void)
+{
+	static const char * const valid[] = {
+		"",
+		"  udp ",
+		"ip or ip6 or arp",
+		"tcp and not port 22",
+		"src port 1 or dst port 65535",
+		"not src host 192.0.2.1",
+		"dst host 2001:db8::1 and icmp6",
+		"net 192.0.2.0/24 or net 2001:db8::/32",
+		"net 0.0.0.0/0",
+	};
+	static const char * const invalid[] = {
+		"udp and",
+		"or udp",
+		"udp tcp",
+		"udp or or tcp",
+		"not",
+		"port",
+		"port 0",
+		"port 65536",
+		"port 53x",
+		"src udp",
+		"dst",
+		"host 192.0.2.1/24",
+		"host 2001:db8::g",
+		"net 192.0.2.0/33",
+		"net 2001:db8::/129",
+		"net 192.0.2.0/",
+		"ethernet",
+		"host 2001:0db8:0000:0000:0000:0000:0000:0000:0001/128",
+	};
+	int i, ret;
+
+	for (i = 0; i < ARRAY_SIZE(valid); i++) {
+		ret = net_capture_ring_filter(valid[i]);
+		zassert_equal(ret, 0, "Filter \"%s\" failed (%d)",
+			      valid[i], ret);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(invalid); i++) {
+		ret = net_capture_ring_filter(invalid[i]);
+		zassert_equal(ret, -EINVAL, "Filter \"%s\" accepted (%d)",
+			      invalid[i], ret);
+	}
+
+	ret = net_capture_ring_filter("ip and udp and port 53 and not arp "
+				      "and ip6");
+	zassert_equal(ret, -ENOMEM, "Too long filter accepted (%d)", ret);
+
+	zassert_equal(net_capture_ring_filter(NULL), 0, "Cannot clear filter");
+}
+
+static void test_capture_filter(void)
+{
+	static const struct {
+		const char *filter;
+		uint32_t captured;
+	} tests[] = {
+		{ "", BIT_MASK(N_PKTS) },
+		{ "udp", BIT(UDP4) | BIT(UDP6) | BIT(FRAG4) | BIT(ETH_UDP4) },
+		{ "dst port 53", BIT(UDP4) | BIT(ETH_UDP4) },
+		{ "src port 53", BIT(UDP6) },
+		{ "port 53", BIT(UDP4) | BIT(UDP6) | BIT(ETH_UDP4) },
+		{ "tcp or icmp", BIT(TCP4) | BIT(ICMP4) | BIT(TCP6) },
+		{ "icmp6", BIT(ICMP6) },
+		{ "ip", BIT(UDP4) | BIT(TCP4) | BIT(ICMP4) | BIT(FRAG4) |
+			BIT(ETH_UDP4) },
+		{ "ip6", BIT(UDP6) | BIT(TCP6) | BIT(ICMP6) },
+		{ "arp", BIT(ETH_ARP) },
+		{ "not host 192.0.2.1", BIT(UDP6) | BIT(TCP6) | BIT(ICMP6) |
+			BIT(ETH_ARP) },
+		{ "dst host 192.0.2.1", BIT(ICMP4) },
+		{ "net 2001:db8::/32 and not icmp6", BIT(UDP6) | BIT(TCP6) },
+		{ "src net fe80::/10", BIT(TCP6) },
+		{ "net 192.0.2.0/25", BIT(UDP4) | BIT(TCP4) | BIT(ICMP4) |
+			BIT(FRAG4) | BIT(ETH_UDP4) },
+		{ "net 192.0.2.128/25", 0 },
+		{ "udp and port 53 or tcp and port 22", BIT(UDP4) | BIT(UDP6) |
+			BIT(ETH_UDP4) | BIT(TCP6) },
+	};
+	struct net_capture_ring_stats stats;
+	uint32_t captured;
+	int i, j, ret;
+
+	ret = net_capture_ring_start(NULL, 0);
+	zassert_equal(ret, 0, "Cannot start capture (%d)", ret);
+
+	for (i = 0; i < ARRAY_SIZE(tests); i++) {
+		net_capture_ring_clear();
+
+		ret = net_capture_ring_filter(tests[i].filter);
+		zassert_equal(ret, 0, "Filter \"%s\" failed (%d)",
+			      tests[i].filter, ret);
+
+		capture_test_pkts();
+		export();
+
+		captured = 0U;
+
+		for (j = 0; j < epb_count; j++) {
+			captured |= BIT(epbs[j].len - PKT_BASE_LEN);
+
+			zassert_equal(epbs[j].caplen, epbs[j].len,
+				      "Packet truncated");
+			zassert_mem_equal(epbs[j].data,
+					  pkt_data[epbs[j].len - PKT_BASE_LEN],
+					  epbs[j].len, "Invalid data");
+		}
+
+		zassert_equal(captured, tests[i].captured,
+			      "Filter \"%s\" captured 0x%x, not 0x%x",
+			      tests[i].filter, captured, tests[i].captured);
+
+		net_capture_ring_stats(&stats);
+		zassert_equal(stats.captured, epb_count, "Invalid stats");
+		zassert_equal(stats.filtered, N_PKTS - epb_count,
+			      "Invalid stats");
+	}
+
+	zassert_equal(idb_count, 2, "Expected 2 interfaces, got %d",
+		      idb_count);
+	zassert_equal(link_types[net_if_get_by_iface(iface1) - 1],
+		      LINKTYPE_RAW, "Invalid link type");
+	zassert_equal(link_types[net_if_get_by_iface(iface2) - 1],
+		      LINKTYPE_ETHERNET, "Invalid link type");
+
+	/* Capture only one interface */
+	net_capture_ring_clear();
+	net_capture_ring_filter(NULL);
+
+	ret = net_capture_ring_start(iface2, 0);
+	zassert_equal(ret, 0, "Cannot start capture (%d)", ret);
+
+	capture_test_pkts();
+	export();
+
+	zassert_equal(epb_count, 2, "Captured %d packets", epb_count);
+	zassert_equal(epbs[0].ifid, net_if_get_by_iface(iface2) - 1,
+		      "Invalid interface");
+
+	/* Nothing is captured once stopped */
+	net_capture_ring_clear();
+	net_capture_ring_stop();
+
+	capture_test_pkts();
+	export();
+
+	zassert_equal(epb_count, 0, "Captured %d packets", epb_count);
+}
+
+static void test_capture_ring(void)
+{
+	struct net_capture_ring_stats stats;
+	uint8_t data[200];
+	uint32_t seq;
+	int i, ret;
+
+	(void)memset(data, 0, sizeof(data));
+	build_ip(data, AF_INET, IPPROTO_UDP, &my_addr, &peer_addr,
+		 TEST_PORT, TEST_PORT, 0);
+
+	ret = net_capture_ring_start(NULL, UINT16_MAX);
+	zassert_equal(ret, -EINVAL, "Snaplen larger than the ring accepted");
+
+	net_capture_ring_clear();
+
+	ret = net_capture_ring_start(iface1, 64);
+	zassert_equal(ret, 0, "Cannot start capture (%d)", ret);
+
+	/* Packets of 32 to 200 bytes, several times the ring size */
+	for (seq = 0; seq < 64; seq++) {
+		sys_put_be32(seq, &data[28]);
+		capture(iface1, data, 32 + seq * 37 % 169);
+	}
+
+	net_capture_ring_stats(&stats);
+
+	zassert_equal(stats.captured, 64, "Captured %u", stats.captured);
+	zassert_true(stats.overwritten > 0, "Ring did not wrap");
+	zassert_equal(stats.count + stats.overwritten, 64, "Packets lost");
+	zassert_true(stats.used <= stats.size, "Ring overflow");
+	/* At most one record of space is lost when the ring wraps */
+	zassert_true(stats.used + 2 * (16 + 64) > stats.size,
+		     "Ring not filled");
+
+	export();
+
+	zassert_equal(epb_count, stats.count, "Exported %d of %u",
+		      epb_count, stats.count);
+
+	/* The newest packets, oldest first */
+	for (i = 0; i < epb_count; i++) {
+		seq = 64 - epb_count + i;
+
+		zassert_equal(epbs[i].len, 32 + seq * 37 % 169,
+			      "Invalid length");
+		zassert_equal(epbs[i].caplen, MIN(epbs[i].len, 64),
+			      "Invalid snaplen");
+		zassert_equal(sys_get_be32(&epbs[i].data[28]), seq,
+			      "Packet %d is not %u", i, seq);
+	}
+
+	net_capture_ring_stop();
+	net_capture_ring_clear();
+
+	net_capture_ring_stats(&stats);
+	zassert_equal(stats.count + stats.used + stats.captured, 0,
+		      "Ring not cleared");
+}
+
+static void test_capture_stack(void)
+{
+	struct sockaddr_in peer = {
+		.sin_family = AF_INET,
+		.sin_port = htons(TEST_PORT),
+		.sin_addr = peer_addr,
+	};
+	struct sockaddr_in local = {
+		.sin_family = AF_INET,
+		.sin_port = htons(TEST_PORT),
+		.sin_addr = my_addr,
+	};
+	struct net_context *ctx;
+	struct net_pkt *pkt;
+	uint8_t data[64];
+	size_t len;
+	int ret;
+
+	ret = net_capture_ring_filter("udp and port 4242");
+	zassert_equal(ret, 0, "Cannot set filter (%d)", ret);
+
+	ret = net_capture_ring_start(NULL, 0);
+	zassert_equal(ret, 0, "Cannot start capture (%d)", ret);
+
+	/* Sent packet */
+	ret = net_context_get(AF_INET, SOCK_DGRAM, IPPROTO_UDP, &ctx);
+	zassert_equal(ret, 0, "Cannot get context (%d)", ret);
+
+	ret = net_context_bind(ctx, (struct sockaddr *)&local, sizeof(local));
+	zassert_equal(ret, 0, "Cannot bind context (%d)", ret);
+
+	ret = net_context_sendto(ctx, "capture", 7, (struct sockaddr *)&peer,
+				 sizeof(peer), NULL, K_NO_WAIT, NULL);
+	zassert_equal(ret, 7, "Cannot send (%d)", ret);
+
+	net_context_put(ctx);
+
+	/* Received packet */
+	(void)memset(data, 0, sizeof(data));
+	len = build_ip(data, AF_INET, IPPROTO_UDP, &peer_addr, &my_addr,
+		       TEST_PORT, TEST_PORT, 0);
+
+	pkt = net_pkt_alloc_with_buffer(iface1, sizeof(data), AF_UNSPEC, 0,
+					K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	net_pkt_write(pkt, data, sizeof(data));
+	net_pkt_cursor_init(pkt);
+
+	ret = net_recv_data(iface1, pkt);
+	zassert_equal(ret, 0, "Cannot receive (%d)", ret);
+
+	k_sleep(K_MSEC(100));
+
+	net_capture_ring_stop();
+
+	export();
+
+	zassert_equal(epb_count, 2, "Captured %d packets", epb_count);
+
+	/* The packets are sent and received by different threads */
+	if (memcmp(&epbs[0].data[16], &my_addr, sizeof(my_addr)) == 0) {
+		epbs[2] = epbs[0];
+		epbs[0] = epbs[1];
+		epbs[1] = epbs[2];
+	}
+
+	zassert_mem_equal(&epbs[0].data[16], &peer_addr, sizeof(peer_addr),
+			  "Sent packet not captured");
+	zassert_equal(sys_get_be16(&epbs[0].data[len + 2]), TEST_PORT,
+		      "Sent packet not captured");
+	zassert_mem_equal(&epbs[1].data[16], &my_addr, sizeof(my_addr),
+			  "Received packet not captured");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_capture_test,
+			 ztest_unit_test(test_capture_setup),
+			 ztest_unit_test(test_capture_filter_syntax),
+			 ztest_unit_test(test_capture_filter),
+			 ztest_unit_test(test_capture_ring),
+			 ztest_unit_test(test_capture_stack));
+
+	ztest_run_test_suite(net_capture_test);
+}
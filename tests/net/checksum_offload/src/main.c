@@ -928,6 +928,177 @@ static void test_rx_chksum_offload_enabled_test_v4(void)
 	k_sleep(K_MSEC(10));
 }
 
+static uint32_t chksum_seed = 1U;
+
+static uint32_t chksum_rand(void)
+{
+	/* Same packets on every run */
+	chksum_seed = chksum_seed * 1103515245U + 12345U;
+
+	return chksum_seed >> 8;
+}
+
+/* Straightforward RFC 1071 checksum of the pseudo header and payload */
+static uint16_t ref_chksum(const uint8_t *data, size_t hdr_len,
+			   size_t len, uint8_t proto)
+{
+	size_t addr_len = hdr_len == NET_IPV4H_LEN ?
+		2 * sizeof(struct in_addr) : 2 * sizeof(struct in6_addr);
+	uint32_t sum = len - hdr_len + proto;
+	size_t i;
+
+	for (i = hdr_len - addr_len; i < hdr_len; i += 2) {
+		sum += (data[i] << 8) + data[i + 1];
+	}
+
+	for (i = hdr_len; i < len; i++) {
+		sum += (i - hdr_len) % 2 ? data[i] : data[i] << 8;
+	}
+
+	while (sum >> 16) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	sum = (sum == 0U) ? 0xffff : htons(sum);
+
+	return ~sum;
+}
+
+static struct net_pkt *chksum_pkt(const uint8_t *data, size_t size,
+				  size_t hdr_len, int frags, size_t *len)
+{
+	struct net_pkt *pkt;
+	struct net_buf *buf;
+	size_t pos = 0, frag_len, reserve;
+
+	pkt = net_pkt_alloc(K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	net_pkt_set_family(pkt, hdr_len == NET_IPV4H_LEN ? AF_INET : AF_INET6);
+	net_pkt_set_ip_hdr_len(pkt, hdr_len);
+
+	/* Fragments of random length starting at random alignments, the
+	 * first one holding the whole IP header.
+	 */
+	while (frags-- && pos < size) {
+		buf = net_pkt_get_reserve_tx_data(K_NO_WAIT);
+		zassert_not_null(buf, "Cannot allocate buffer");
+
+		reserve = chksum_rand() % 4;
+		net_buf_reserve(buf, reserve);
+
+		frag_len = 1 + chksum_rand() % (net_buf_tailroom(buf) - 1);
+		if (!pos) {
+			frag_len = MAX(frag_len, hdr_len);
+		}
+
+		frag_len = MIN(frag_len, size - pos);
+
+		memcpy(net_buf_add(buf, frag_len), data + pos, frag_len);
+		net_pkt_append_buffer(pkt, buf);
+
+		pos += frag_len;
+	}
+
+	*len = pos;
+
+	return pkt;
+}
+
+static void test_chksum_kernel(void)
+{
+	static uint8_t data[6 * CONFIG_NET_BUF_DATA_SIZE];
+	static const uint8_t protos[] = {
+		IPPROTO_UDP, IPPROTO_TCP, IPPROTO_ICMPV6
+	};
+	struct net_pkt *pkt;
+	size_t hdr_len, len, i;
+	uint16_t chksum;
+	uint8_t proto;
+	int round;
+
+	for (round = 0; round < 1000; round++) {
+		hdr_len = round % 2 ? NET_IPV6H_LEN : NET_IPV4H_LEN;
+		proto = protos[round % ARRAY_SIZE(protos)];
+
+		for (i = 0; i < sizeof(data); i++) {
+			/* Some runs of ones to check the carries */
+			data[i] = round % 3 ? chksum_rand() : 0xff;
+		}
+
+		pkt = chksum_pkt(data, sizeof(data), hdr_len,
+				 1 + chksum_rand() % 6, &len);
+
+		chksum = net_calc_chksum(pkt, proto);
+
+		zassert_equal(chksum, ref_chksum(data, hdr_len, len, proto),
+			      "Round %d: invalid checksum 0x%04x for %zu bytes",
+			      round, chksum, len);
+
+		net_pkt_unref(pkt);
+	}
+}
+
+static void test_chksum_incremental(void)
+{
+	struct net_ipv4_hdr hdr;
+	struct net_pkt *pkt;
+	uint16_t chksum, word;
+	size_t len;
+	int round;
+
+	for (round = 0; round < 1000; round++) {
+		uint8_t data[NET_IPV4H_LEN];
+		struct in_addr addr;
+		uint16_t total;
+
+		for (len = 0; len < sizeof(data); len++) {
+			data[len] = chksum_rand();
+		}
+
+		data[0] = 0x45;
+		memcpy(&hdr, data, sizeof(hdr));
+
+		pkt = chksum_pkt(data, sizeof(data), NET_IPV4H_LEN, 1, &len);
+
+		/* Header checksum computed from scratch */
+		NET_IPV4_HDR(pkt)->chksum = 0U;
+		hdr.chksum = net_calc_chksum_ipv4(pkt);
+
+		/* TTL decrement, updating the word it shares with the
+		 * protocol.
+		 */
+		word = UNALIGNED_GET((uint16_t *)&hdr.ttl);
+		hdr.ttl--;
+		chksum = net_chksum_update16(hdr.chksum, word,
+					     UNALIGNED_GET((uint16_t *)&hdr.ttl));
+
+		/* New total length */
+		total = htons(chksum_rand());
+		chksum = net_chksum_update16(chksum, hdr.len, total);
+		hdr.len = total;
+
+		/* Address rewrite */
+		addr.s_addr = chksum_rand() << 8 | (chksum_rand() & 0xff);
+		chksum = net_chksum_update32(chksum, hdr.dst.s_addr,
+					     addr.s_addr);
+		net_ipaddr_copy(&hdr.dst, &addr);
+
+		hdr.chksum = 0U;
+		memcpy(NET_IPV4_HDR(pkt), &hdr, sizeof(hdr));
+
+		zassert_equal(chksum, net_calc_chksum_ipv4(pkt),
+			      "Round %d: invalid checksum update", round);
+
+		/* The updated header is valid */
+		NET_IPV4_HDR(pkt)->chksum = chksum;
+		zassert_equal(net_calc_chksum_ipv4(pkt), 0U,
+			      "Round %d: header not valid", round);
+
+		net_pkt_unref(pkt);
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(net_chksum_offload_test,
@@ -940,7 +1111,9 @@ void test_main(void)
 			 ztest_unit_test(test_rx_chksum_offload_disabled_test_v6),
 			 ztest_unit_test(test_rx_chksum_offload_disabled_test_v4),
 			 ztest_unit_test(test_rx_chksum_offload_enabled_test_v6),
-			 ztest_unit_test(test_rx_chksum_offload_enabled_test_v4)
+			 ztest_unit_test(test_rx_chksum_offload_enabled_test_v4),
+			 ztest_unit_test(test_chksum_kernel),
+			 ztest_unit_test(test_chksum_incremental)
 			 );
 
 	ztest_run_test_suite(net_chksum_offload_test);
@@ -0,0 +1,563 @@
+/* main.c - Application main entry point */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_IPV4_LOG_LEVEL);
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/printk.h>
+#include <linker/sections.h>
+#include <random/rand32.h>
+
+#include <ztest.h>
+
+#include <net/ethernet.h>
+#include <net/dummy.h>
+#include <net/buf.h>
+#include <net/net_ip.h>
+#include <net/net_if.h>
+
+#define NET_LOG_ENABLED 1
+#include "net_private.h"
+
+#include "icmpv4.h"
+#include "ipv4.h"
+#include "udp_internal.h"
+
+static struct in_addr my_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+
+#define LOCAL_PORT 4242
+#define PEER_PORT 4343
+
+/* Payload of the fragmented UDP datagram sent by the peer */
+#define RECV_DATA_LEN 92
+#define RECV_DATAGRAM_LEN (sizeof(struct net_udp_hdr) + RECV_DATA_LEN)
+
+/* Payload of the UDP datagram we send, it needs three fragments */
+#define SEND_DATA_LEN 1300
+#define SEND_FRAG_LEN ((NET_IPV4_MTU - sizeof(struct net_ipv4_hdr)) & ~7)
+#define SEND_FRAG_COUNT 3
+
+#define MAX_SENT_PKTS 8
+
+#define WAIT_TIME K_SECONDS(1)
+#define NO_DATA_WAIT_TIME K_MSEC(100)
+
+#define ALLOC_TIMEOUT K_MSEC(500)
+
+static struct net_if *iface1;
+
+static uint8_t recv_datagram[RECV_DATAGRAM_LEN];
+
+static struct net_pkt *sent_pkts[MAX_SENT_PKTS];
+static int sent_count;
+static struct k_sem wait_sent;
+
+static struct k_sem wait_data;
+static size_t recv_len;
+static bool recv_data_ok;
+
+struct net_if_test {
+	uint8_t mac_addr[sizeof(struct net_eth_addr)];
+};
+
+static int net_iface_dev_init(const struct device *dev)
+{
+	return 0;
+}
+
+static uint8_t *net_iface_get_mac(const struct device *dev)
+{
+	struct net_if_test *data = dev->data;
+
+	if (data->mac_addr[2] == 0x00) {
+		/* 00-00-5E-00-53-xx Documentation RFC 7042 */
+		data->mac_addr[0] = 0x00;
+		data->mac_addr[1] = 0x00;
+		data->mac_addr[2] = 0x5E;
+		data->mac_addr[3] = 0x00;
+		data->mac_addr[4] = 0x53;
+		data->mac_addr[5] = sys_rand32_get();
+	}
+
+	return data->mac_addr;
+}
+
+static void net_iface_init(struct net_if *iface)
+{
+	uint8_t *mac = net_iface_get_mac(net_if_get_device(iface));
+
+	net_if_set_link_addr(iface, mac, sizeof(struct net_eth_addr),
+			     NET_LINK_ETHERNET);
+}
+
+/* Keep the sent packets so that the tests can verify them */
+static int sender_iface(const struct device *dev, struct net_pkt *pkt)
+{
+	if (!pkt->buffer) {
+		NET_DBG("No data to send!");
+		return -ENODATA;
+	}
+
+	if (sent_count >= MAX_SENT_PKTS) {
+		return 0;
+	}
+
+	/* The dummy L2 releases the packet once it has been sent */
+	sent_pkts[sent_count++] = net_pkt_ref(pkt);
+	k_sem_give(&wait_sent);
+
+	return 0;
+}
+
+static void release_sent_pkts(void)
+{
+	int i;
+
+	for (i = 0; i < sent_count; i++) {
+		net_pkt_unref(sent_pkts[i]);
+		sent_pkts[i] = NULL;
+	}
+
+	sent_count = 0;
+	k_sem_reset(&wait_sent);
+}
+
+struct net_if_test net_iface1_data;
+
+static struct dummy_api net_iface_api = {
+	.iface_api.init = net_iface_init,
+	.send = sender_iface,
+};
+
+NET_DEVICE_INIT_INSTANCE(net_iface1_test,
+			 "iface1",
+			 iface1,
+			 net_iface_dev_init,
+			 NULL,
+			 &net_iface1_data,
+			 NULL,
+			 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+			 &net_iface_api,
+			 DUMMY_L2,
+			 NET_L2_GET_CTX_TYPE(DUMMY_L2),
+			 127);
+
+static enum net_verdict udp_data_received(struct net_conn *conn,
+					  struct net_pkt *pkt,
+					  union net_ip_header *ip_hdr,
+					  union net_proto_header *proto_hdr,
+					  void *user_data)
+{
+	uint8_t data[RECV_DATA_LEN];
+
+	NET_DBG("Data %p received", pkt);
+
+	recv_len = net_pkt_get_len(pkt);
+
+	net_pkt_cursor_init(pkt);
+
+	recv_data_ok = recv_len == sizeof(struct net_ipv4_hdr) +
+				   RECV_DATAGRAM_LEN &&
+		       !net_pkt_skip(pkt, sizeof(struct net_ipv4_hdr) +
+				     sizeof(struct net_udp_hdr)) &&
+		       !net_pkt_read(pkt, data, sizeof(data)) &&
+		       !memcmp(data, recv_datagram + sizeof(struct net_udp_hdr),
+			       sizeof(data));
+
+	net_pkt_unref(pkt);
+
+	k_sem_give(&wait_data);
+
+	return NET_OK;
+}
+
+static void setup_udp_handler(void)
+{
+	static struct net_conn_handle *handle;
+	struct sockaddr remote_addr = { 0 };
+	struct sockaddr local_addr = { 0 };
+	int ret;
+
+	net_ipaddr_copy(&net_sin(&local_addr)->sin_addr, &my_addr);
+	local_addr.sa_family = AF_INET;
+
+	net_ipaddr_copy(&net_sin(&remote_addr)->sin_addr, &peer_addr);
+	remote_addr.sa_family = AF_INET;
+
+	ret = net_udp_register(AF_INET, &remote_addr, &local_addr,
+			       PEER_PORT, LOCAL_PORT, NULL, udp_data_received,
+			       NULL, &handle);
+	zassert_equal(ret, 0, "Cannot register UDP handler");
+}
+
+static void pending_cb(struct net_ipv4_reassembly *reass, void *user_data)
+{
+	int *count = user_data;
+
+	(*count)++;
+}
+
+static int pending_reassemblies(void)
+{
+	int count = 0;
+
+	net_ipv4_frag_foreach(pending_cb, &count);
+
+	return count;
+}
+
+/* Create a fragment of recv_datagram sent by the peer */
+static struct net_pkt *create_fragment(uint16_t id, uint16_t offset,
+				       uint16_t len, bool more)
+{
+	struct net_ipv4_hdr hdr = { 0 };
+	struct net_pkt *pkt;
+	uint16_t flag;
+
+	pkt = net_pkt_alloc_with_buffer(iface1, sizeof(hdr) + len, AF_UNSPEC,
+					0, ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "Cannot allocate fragment");
+
+	flag = offset / 8U;
+	if (more) {
+		flag |= NET_IPV4_MF << 13;
+	}
+
+	hdr.vhl = 0x45;
+	hdr.len = htons(sizeof(hdr) + len);
+	hdr.id[0] = id >> 8;
+	hdr.id[1] = id;
+	hdr.offset[0] = flag >> 8;
+	hdr.offset[1] = flag;
+	hdr.ttl = 64U;
+	hdr.proto = IPPROTO_UDP;
+	net_ipaddr_copy(&hdr.src, &peer_addr);
+	net_ipaddr_copy(&hdr.dst, &my_addr);
+
+	zassert_equal(net_pkt_write(pkt, &hdr, sizeof(hdr)), 0,
+		      "IPv4 header append failed");
+	zassert_equal(net_pkt_write(pkt, recv_datagram + offset, len), 0,
+		      "IPv4 payload append failed");
+
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(hdr));
+	net_pkt_set_ipv4_opts_len(pkt, 0);
+
+	NET_IPV4_HDR(pkt)->chksum = net_calc_chksum_ipv4(pkt);
+
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_cursor_init(pkt);
+
+	return pkt;
+}
+
+static enum net_verdict recv_fragment(uint16_t id, uint16_t offset,
+				      uint16_t len, bool more)
+{
+	struct net_pkt *pkt = create_fragment(id, offset, len, more);
+	enum net_verdict verdict;
+
+	verdict = net_ipv4_input(pkt);
+	if (verdict == NET_DROP) {
+		net_pkt_unref(pkt);
+	}
+
+	return verdict;
+}
+
+static void test_setup(void)
+{
+	struct net_if_addr *ifaddr;
+	struct net_udp_hdr *udp_hdr;
+	int i;
+
+	k_sem_init(&wait_sent, 0, UINT_MAX);
+	k_sem_init(&wait_data, 0, UINT_MAX);
+
+	iface1 = net_if_get_by_index(1);
+	zassert_not_null(iface1, "Interface 1");
+
+	ifaddr = net_if_ipv4_addr_add(iface1, &my_addr, NET_ADDR_MANUAL, 0);
+	zassert_not_null(ifaddr, "Cannot add IPv4 address");
+
+	net_if_set_mtu(iface1, NET_IPV4_MTU);
+	net_if_up(iface1);
+
+	udp_hdr = (struct net_udp_hdr *)recv_datagram;
+	udp_hdr->src_port = htons(PEER_PORT);
+	udp_hdr->dst_port = htons(LOCAL_PORT);
+	udp_hdr->len = htons(RECV_DATAGRAM_LEN);
+
+	for (i = sizeof(struct net_udp_hdr); i < RECV_DATAGRAM_LEN; i++) {
+		recv_datagram[i] = i;
+	}
+
+	setup_udp_handler();
+}
+
+static void test_send_ipv4_fragment(void)
+{
+	size_t total_len = 0;
+	struct net_pkt *pkt;
+	uint16_t id = 0U;
+	int ret, i;
+
+	pkt = net_pkt_alloc_with_buffer(iface1, SEND_DATA_LEN, AF_INET,
+					IPPROTO_UDP, ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "Cannot allocate packet");
+
+	ret = net_ipv4_create(pkt, &my_addr, &peer_addr);
+	zassert_equal(ret, 0, "Cannot create IPv4 header");
+
+	ret = net_udp_create(pkt, htons(LOCAL_PORT), htons(PEER_PORT));
+	zassert_equal(ret, 0, "Cannot create UDP header");
+
+	for (i = 0; i < SEND_DATA_LEN; i++) {
+		zassert_equal(net_pkt_write_u8(pkt, i), 0,
+			      "Cannot write payload");
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_ipv4_finalize(pkt, IPPROTO_UDP);
+
+	ret = net_send_data(pkt);
+	zassert_equal(ret, 0, "Cannot send packet (%d)", ret);
+
+	for (i = 0; i < SEND_FRAG_COUNT; i++) {
+		zassert_equal(k_sem_take(&wait_sent, WAIT_TIME), 0,
+			      "Fragment %d not sent", i);
+	}
+
+	zassert_equal(sent_count, SEND_FRAG_COUNT, "Invalid fragment count");
+
+	for (i = 0; i < sent_count; i++) {
+		struct net_pkt *frag = sent_pkts[i];
+		struct net_ipv4_hdr *hdr = NET_IPV4_HDR(frag);
+		uint16_t flag = (hdr->offset[0] << 8) | hdr->offset[1];
+		size_t payload_len = net_pkt_get_len(frag) - sizeof(*hdr);
+		bool last = i == SEND_FRAG_COUNT - 1;
+
+		if (i == 0) {
+			id = (hdr->id[0] << 8) | hdr->id[1];
+		}
+
+		zassert_equal(ntohs(hdr->len), net_pkt_get_len(frag),
+			      "Invalid length in fragment %d", i);
+		zassert_true(net_pkt_get_len(frag) <= NET_IPV4_MTU,
+			     "Fragment %d does not fit the MTU", i);
+		zassert_equal((hdr->id[0] << 8) | hdr->id[1], id,
+			      "Invalid id in fragment %d", i);
+		zassert_equal((flag & NET_IPV4_FRAGH_OFFSET_MASK) * 8U,
+			      total_len, "Invalid offset in fragment %d", i);
+		zassert_equal(!!(flag & (NET_IPV4_MF << 13)), !last,
+			      "Invalid MF bit in fragment %d", i);
+		zassert_true(last || payload_len == SEND_FRAG_LEN,
+			     "Invalid payload length in fragment %d", i);
+		zassert_equal(net_calc_chksum_ipv4(frag), 0,
+			      "Invalid header checksum in fragment %d", i);
+
+		total_len += payload_len;
+	}
+
+	zassert_equal(total_len, sizeof(struct net_udp_hdr) + SEND_DATA_LEN,
+		      "Invalid total payload length");
+
+	release_sent_pkts();
+}
+
+static void test_send_ipv4_fragment_small_mtu(void)
+{
+	struct net_pkt *pkt;
+	int ret, i;
+
+	pkt = net_pkt_alloc_with_buffer(iface1, SEND_DATA_LEN, AF_INET,
+					IPPROTO_UDP, ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "Cannot allocate packet");
+
+	ret = net_ipv4_create(pkt, &my_addr, &peer_addr);
+	zassert_equal(ret, 0, "Cannot create IPv4 header");
+
+	ret = net_udp_create(pkt, htons(LOCAL_PORT), htons(PEER_PORT));
+	zassert_equal(ret, 0, "Cannot create UDP header");
+
+	for (i = 0; i < SEND_DATA_LEN; i++) {
+		zassert_equal(net_pkt_write_u8(pkt, i), 0,
+			      "Cannot write payload");
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_ipv4_finalize(pkt, IPPROTO_UDP);
+
+	/* Below the minimum IPv4 MTU nothing may be sent */
+	net_if_set_mtu(iface1, 60);
+
+	ret = net_send_data(pkt);
+	zassert_true(ret < 0, "Packet sent with too small MTU");
+	zassert_equal(k_sem_take(&wait_sent, K_MSEC(100)), -EAGAIN,
+		      "Fragment sent with too small MTU");
+	zassert_equal(sent_count, 0, "Invalid fragment count");
+
+	net_if_set_mtu(iface1, NET_IPV4_MTU);
+	net_pkt_unref(pkt);
+}
+
+static void test_send_ipv4_dont_fragment(void)
+{
+	struct net_pkt *pkt;
+	int ret, i;
+
+	pkt = net_pkt_alloc_with_buffer(iface1, SEND_DATA_LEN, AF_INET,
+					IPPROTO_UDP, ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "Cannot allocate packet");
+
+	ret = net_ipv4_create_full(pkt, &my_addr, &peer_addr, 0U, 0U,
+				   NET_IPV4_DF, 0U, 0U);
+	zassert_equal(ret, 0, "Cannot create IPv4 header");
+
+	ret = net_udp_create(pkt, htons(LOCAL_PORT), htons(PEER_PORT));
+	zassert_equal(ret, 0, "Cannot create UDP header");
+
+	for (i = 0; i < SEND_DATA_LEN; i++) {
+		zassert_equal(net_pkt_write_u8(pkt, i), 0,
+			      "Cannot write payload");
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_ipv4_finalize(pkt, IPPROTO_UDP);
+
+	/* The sender is told that the packet does not fit */
+	ret = net_send_data(pkt);
+	zassert_equal(ret, -EMSGSIZE, "Packet with DF set sent (%d)", ret);
+	zassert_equal(k_sem_take(&wait_sent, K_MSEC(100)), -EAGAIN,
+		      "Fragment sent with DF set");
+	zassert_equal(sent_count, 0, "Invalid fragment count");
+
+	net_pkt_unref(pkt);
+}
+
+static void test_recv_ipv4_fragment(void)
+{
+	recv_data_ok = false;
+
+	zassert_equal(recv_fragment(1, 0, 32, true), NET_OK,
+		      "Fragment 1 not accepted");
+	zassert_equal(recv_fragment(1, 32, 32, true), NET_OK,
+		      "Fragment 2 not accepted");
+	zassert_equal(pending_reassemblies(), 1, "Reassembly not pending");
+	zassert_equal(recv_fragment(1, 64, RECV_DATAGRAM_LEN - 64, false),
+		      NET_OK, "Fragment 3 not accepted");
+
+	zassert_equal(k_sem_take(&wait_data, WAIT_TIME), 0,
+		      "Datagram not received");
+	zassert_true(recv_data_ok, "Invalid reassembled data (%zd bytes)",
+		     recv_len);
+	zassert_equal(pending_reassemblies(), 0, "Reassembly still pending");
+}
+
+static void test_recv_ipv4_fragment_out_of_order(void)
+{
+	recv_data_ok = false;
+
+	zassert_equal(recv_fragment(2, 64, RECV_DATAGRAM_LEN - 64, false),
+		      NET_OK, "Fragment 3 not accepted");
+	zassert_equal(recv_fragment(2, 32, 32, true), NET_OK,
+		      "Fragment 2 not accepted");
+	zassert_equal(recv_fragment(2, 0, 32, true), NET_OK,
+		      "Fragment 1 not accepted");
+
+	zassert_equal(k_sem_take(&wait_data, WAIT_TIME), 0,
+		      "Datagram not received");
+	zassert_true(recv_data_ok, "Invalid reassembled data (%zd bytes)",
+		     recv_len);
+	zassert_equal(pending_reassemblies(), 0, "Reassembly still pending");
+}
+
+static void test_recv_ipv4_fragment_overlap(void)
+{
+	zassert_equal(recv_fragment(3, 0, 32, true), NET_OK,
+		      "Fragment 1 not accepted");
+	zassert_equal(recv_fragment(3, 16, 32, true), NET_DROP,
+		      "Overlapping fragment accepted");
+	zassert_equal(pending_reassemblies(), 0, "Reassembly still pending");
+
+	/* The rest of the datagram must not be delivered */
+	zassert_equal(recv_fragment(3, 48, RECV_DATAGRAM_LEN - 48, false),
+		      NET_OK, "Last fragment not accepted");
+	zassert_not_equal(k_sem_take(&wait_data, NO_DATA_WAIT_TIME), 0,
+			  "Datagram received");
+}
+
+static void test_recv_ipv4_fragment_too_many(void)
+{
+	int pending = pending_reassemblies();
+	int i;
+
+	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT; i++) {
+		zassert_equal(recv_fragment(4, i * 8, 8, true), NET_OK,
+			      "Fragment %d not accepted", i);
+	}
+
+	zassert_equal(recv_fragment(4, i * 8, 8, true), NET_DROP,
+		      "Too many fragments accepted");
+	zassert_equal(pending_reassemblies(), pending,
+		      "Reassembly still pending");
+}
+
+static void test_recv_ipv4_fragment_timeout(void)
+{
+	struct net_icmp_hdr *icmp_hdr;
+
+	/* Get rid of the reassembly left by the overlap test */
+	k_sleep(K_MSEC(CONFIG_NET_IPV4_FRAGMENT_TIMEOUT * MSEC_PER_SEC +
+		       100));
+	release_sent_pkts();
+
+	zassert_equal(recv_fragment(5, 0, 32, true), NET_OK,
+		      "Fragment 1 not accepted");
+	zassert_equal(pending_reassemblies(), 1, "Reassembly not pending");
+
+	zassert_equal(k_sem_take(&wait_sent, K_MSEC(
+			CONFIG_NET_IPV4_FRAGMENT_TIMEOUT * MSEC_PER_SEC +
+			500)), 0, "ICMPv4 error not sent");
+	zassert_equal(pending_reassemblies(), 0, "Reassembly still pending");
+
+	zassert_equal(NET_IPV4_HDR(sent_pkts[0])->proto, IPPROTO_ICMP,
+		      "Not an ICMPv4 packet");
+
+	icmp_hdr = (struct net_icmp_hdr *)(sent_pkts[0]->buffer->data +
+					   sizeof(struct net_ipv4_hdr));
+	zassert_equal(icmp_hdr->type, NET_ICMPV4_TIME_EXCEEDED,
+		      "Invalid ICMPv4 type %d", icmp_hdr->type);
+	zassert_equal(icmp_hdr->code, NET_ICMPV4_TIME_EXCEEDED_REASSEMBLY,
+		      "Invalid ICMPv4 code %d", icmp_hdr->code);
+
+	release_sent_pkts();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_ipv4_fragment_test,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_send_ipv4_fragment),
+			 ztest_unit_test(test_send_ipv4_fragment_small_mtu),
+			 ztest_unit_test(test_send_ipv4_dont_fragment),
+			 ztest_unit_test(test_recv_ipv4_fragment),
+			 ztest_unit_test(test_recv_ipv4_fragment_out_of_order),
+			 ztest_unit_test(test_recv_ipv4_fragment_overlap),
+			 ztest_unit_test(test_recv_ipv4_fragment_too_many),
+			 ztest_unit_test(test_recv_ipv4_fragment_timeout)
+			 );
+
+	ztest_run_test_suite(net_ipv4_fragment_test);
+}
@@ -202,17 +202,15 @@ static void prepare_ra_message(struct net_pkt *pkt)
 static struct net_icmp_hdr *get_icmp_hdr(struct net_pkt *pkt)
 {
 	NET_PKT_DATA_ACCESS_CONTIGUOUS_DEFINE(icmp_access, struct net_icmp_hdr);
-	/* First frag is the ll header */
-	struct net_buf *bak = pkt->buffer;
 	struct net_pkt_cursor backup;
 	struct net_icmp_hdr *hdr;
 
-	pkt->buffer = bak->frags;
-
 	net_pkt_cursor_backup(pkt, &backup);
 	net_pkt_cursor_init(pkt);
 
-	if (net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) +
+	/* The packet starts with the ll header */
+	if (net_pkt_skip(pkt, sizeof(struct net_eth_hdr) +
+			 net_pkt_ip_hdr_len(pkt) +
 			 net_pkt_ipv6_ext_len(pkt))) {
 		hdr = NULL;
 		goto out;
@@ -221,8 +219,6 @@ static struct net_icmp_hdr *get_icmp_hdr(struct net_pkt *pkt)
 	hdr = (struct net_icmp_hdr *)net_pkt_get_data(pkt, &icmp_access);
 
 out:
-	pkt->buffer = bak;
-
 	net_pkt_cursor_restore(pkt, &backup);
 
 	return hdr;
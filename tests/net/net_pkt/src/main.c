@@ -18,6 +18,7 @@
 
 static uint8_t mac_addr[sizeof(struct net_eth_addr)];
 static struct net_if *eth_if;
+static struct net_if *fake_if;
 static uint8_t small_buffer[512];
 
 /************************\
@@ -39,11 +40,27 @@ static void fake_dev_iface_init(struct net_if *iface)
 	net_if_set_link_addr(iface, mac_addr, 6, NET_LINK_ETHERNET);
 
 	eth_if = iface;
+	fake_if = iface;
 }
 
+/* What a driver that needs the frame in one contiguous buffer would do */
+static int tx_frags;
+static int tx_copied;
+static bool tx_fail;
+
 static int fake_dev_send(const struct device *dev, struct net_pkt *pkt)
 {
-	return 0;
+	struct net_buf *buf;
+
+	tx_frags = 0;
+
+	for (buf = pkt->buffer; buf; buf = buf->frags) {
+		tx_frags++;
+	}
+
+	tx_copied = tx_frags > 1 ? net_pkt_get_len(pkt) : 0;
+
+	return tx_fail ? -EIO : 0;
 }
 
 int fake_dev_init(const struct device *dev)
@@ -1058,6 +1075,126 @@ void test_net_pkt_remove_tail(void)
 	net_pkt_unref(pkt);
 }
 
+static struct net_pkt *prepare_udp_pkt(size_t len)
+{
+	static const uint8_t addrs[] = { 192, 0, 2, 1, 255, 255, 255, 255 };
+	uint8_t hdr[NET_IPV4UDPH_LEN] = { 0x45 };
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(fake_if, len - NET_IPV4UDPH_LEN,
+					AF_INET, IPPROTO_UDP, K_NO_WAIT);
+	zassert_not_null(pkt, "Pkt not allocated");
+
+	sys_put_be16(len, &hdr[2]);
+	hdr[8] = 64U;
+	hdr[9] = IPPROTO_UDP;
+	memcpy(&hdr[12], addrs, sizeof(addrs));
+	sys_put_be16(4242, &hdr[20]);
+	sys_put_be16(4242, &hdr[22]);
+	sys_put_be16(len - NET_IPV4H_LEN, &hdr[24]);
+
+	zassert_equal(net_pkt_write(pkt, hdr, sizeof(hdr)), 0, "Write failed");
+	zassert_equal(net_pkt_write(pkt, small_buffer,
+				    len - sizeof(hdr)), 0, "Write failed");
+
+	net_pkt_lladdr_src(pkt)->addr = net_if_get_link_addr(fake_if)->addr;
+	net_pkt_lladdr_src(pkt)->len = net_if_get_link_addr(fake_if)->len;
+
+	return pkt;
+}
+
+void test_net_pkt_l2_headroom(void)
+{
+	static const size_t sizes[] = { 36, 64, 100, 300, 1500 };
+	struct net_pkt *pkt;
+	size_t len;
+	int i, ret;
+
+#if !defined(CONFIG_NET_L2_ETHERNET)
+	ztest_test_skip();
+#endif
+
+	for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+		len = sizes[i];
+		pkt = prepare_udp_pkt(len);
+
+		ret = net_if_l2(fake_if)->send(fake_if, pkt);
+		zassert_equal(ret, len + L2_HDR_SIZE, "Send failed (%d)", ret);
+
+		TC_PRINT("%4zu bytes datagram: %d buffers, %d bytes copied\n",
+			 len, tx_frags, tx_copied);
+
+		if (!IS_ENABLED(CONFIG_NET_PKT_L2_HEADROOM)) {
+			zassert_true(tx_frags > 1, "Header not in its own buffer");
+		} else if (IS_ENABLED(CONFIG_NET_BUF_VARIABLE_DATA_SIZE) ||
+			   len + ROUND_UP(L2_HDR_SIZE, 4) <= CONFIG_NET_BUF_DATA_SIZE) {
+			zassert_equal(tx_frags, 1, "Frame not in one buffer");
+			zassert_equal(tx_copied, 0, "Frame copied");
+		}
+	}
+
+	/* The header is removed if the driver fails to send the packet */
+	tx_fail = true;
+	pkt = prepare_udp_pkt(64);
+	net_pkt_ref(pkt);
+
+	ret = net_if_l2(fake_if)->send(fake_if, pkt);
+	zassert_equal(ret, -EIO, "Send did not fail (%d)", ret);
+	zassert_equal(net_pkt_get_len(pkt), 64, "Header not removed");
+	zassert_equal(pkt->buffer->data[0], 0x45, "Header not removed");
+
+	net_pkt_unref(pkt);
+	tx_fail = false;
+}
+
+void test_net_pkt_rx_iface_reserve(void)
+{
+	const int reserve = CONFIG_NET_PKT_RX_IFACE_RESERVE;
+	struct net_pkt *pkts[CONFIG_NET_PKT_RX_COUNT];
+	struct net_if *other = NULL;
+	int n_ifaces = 0;
+	int count, i;
+
+	if (reserve == 0) {
+		ztest_test_skip();
+	}
+
+	STRUCT_SECTION_FOREACH(net_if, iface) {
+		n_ifaces++;
+
+		if (iface != fake_if) {
+			other = iface;
+		}
+	}
+
+	/* One interface gets what the others have not reserved */
+	for (count = 0; count < ARRAY_SIZE(pkts); count++) {
+		pkts[count] = net_pkt_rx_alloc_on_iface(fake_if, K_NO_WAIT);
+		if (!pkts[count]) {
+			break;
+		}
+	}
+
+	zassert_equal(count, CONFIG_NET_PKT_RX_COUNT - (n_ifaces - 1) * reserve,
+		      "Wrong number of packets (%d)", count);
+
+	/* The others still get theirs */
+	for (i = 0; other && i < reserve; i++) {
+		pkts[count] = net_pkt_rx_alloc_on_iface(other, K_NO_WAIT);
+		zassert_not_null(pkts[count], "Reserved packet not allocated");
+		count++;
+	}
+
+	while (count--) {
+		net_pkt_unref(pkts[count]);
+	}
+
+	/* Freed packets are given back to the interface */
+	pkts[0] = net_pkt_rx_alloc_on_iface(fake_if, K_NO_WAIT);
+	zassert_not_null(pkts[0], "Packet not allocated");
+	net_pkt_unref(pkts[0]);
+}
+
 void test_main(void)
 {
 	eth_if = net_if_get_default();
@@ -1074,7 +1211,9 @@ void test_main(void)
 			 ztest_unit_test(test_net_pkt_headroom),
 			 ztest_unit_test(test_net_pkt_headroom_copy),
 			 ztest_unit_test(test_net_pkt_get_contiguous_len),
-			 ztest_unit_test(test_net_pkt_remove_tail)
+			 ztest_unit_test(test_net_pkt_remove_tail),
+			 ztest_unit_test(test_net_pkt_l2_headroom),
+			 ztest_unit_test(test_net_pkt_rx_iface_reserve)
 		);
 
 	ztest_run_test_suite(net_pkt_tests);
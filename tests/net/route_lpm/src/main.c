@@ -0,0 +1,551 @@
+/* main.c - Application main entry point */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_ROUTE_LOG_LEVEL);
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/printk.h>
+#include <linker/sections.h>
+#include <random/rand32.h>
+
+#include <ztest.h>
+
+#include <net/ethernet.h>
+#include <net/dummy.h>
+#include <net/net_ip.h>
+#include <net/net_if.h>
+#include <net/net_mgmt.h>
+#include <net/net_event.h>
+
+#define NET_LOG_ENABLED 1
+#include "net_private.h"
+#include "ipv6.h"
+#include "route.h"
+
+#define WAIT_TIME K_MSEC(500)
+
+/* Random prefixes and lookups compared with a linear search */
+#define RANDOM_ROUNDS 3
+#define RANDOM_LOOKUPS 2000
+
+static struct in6_addr nexthop6 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+static struct in_addr iface1_addr = { { { 192, 0, 2, 10 } } };
+static struct in_addr iface2_addr = { { { 198, 51, 100, 10 } } };
+static struct in_addr netmask = { { { 255, 255, 255, 0 } } };
+
+static struct net_if *iface1;
+static struct net_if *iface2;
+
+static struct net_mgmt_event_callback mgmt_cb;
+static struct k_sem wait_event;
+static uint32_t last_event;
+static struct net_event_ipv4_route last_info;
+
+static uint32_t seed = 1U;
+
+struct net_if_test {
+	uint8_t mac_addr[sizeof(struct net_eth_addr)];
+};
+
+static int net_iface_dev_init(const struct device *dev)
+{
+	return 0;
+}
+
+static uint8_t *net_iface_get_mac(const struct device *dev)
+{
+	struct net_if_test *data = dev->data;
+
+	if (data->mac_addr[2] == 0x00) {
+		/* 00-00-5E-00-53-xx Documentation RFC 7042 */
+		data->mac_addr[0] = 0x00;
+		data->mac_addr[1] = 0x00;
+		data->mac_addr[2] = 0x5E;
+		data->mac_addr[3] = 0x00;
+		data->mac_addr[4] = 0x53;
+		data->mac_addr[5] = sys_rand32_get();
+	}
+
+	return data->mac_addr;
+}
+
+static void net_iface_init(struct net_if *iface)
+{
+	uint8_t *mac = net_iface_get_mac(net_if_get_device(iface));
+
+	net_if_set_link_addr(iface, mac, sizeof(struct net_eth_addr),
+			     NET_LINK_ETHERNET);
+}
+
+static int sender_iface(const struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+struct net_if_test net_iface1_data;
+struct net_if_test net_iface2_data;
+
+static struct dummy_api net_iface_api = {
+	.iface_api.init = net_iface_init,
+	.send = sender_iface,
+};
+
+NET_DEVICE_INIT_INSTANCE(net_iface1_test,
+			 "iface1",
+			 iface1,
+			 net_iface_dev_init,
+			 NULL,
+			 &net_iface1_data,
+			 NULL,
+			 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+			 &net_iface_api,
+			 DUMMY_L2,
+			 NET_L2_GET_CTX_TYPE(DUMMY_L2),
+			 127);
+
+NET_DEVICE_INIT_INSTANCE(net_iface2_test,
+			 "iface2",
+			 iface2,
+			 net_iface_dev_init,
+			 NULL,
+			 &net_iface2_data,
+			 NULL,
+			 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+			 &net_iface_api,
+			 DUMMY_L2,
+			 NET_L2_GET_CTX_TYPE(DUMMY_L2),
+			 127);
+
+static void route_event_handler(struct net_mgmt_event_callback *cb,
+				uint32_t mgmt_event, struct net_if *iface)
+{
+	if (mgmt_event != NET_EVENT_IPV4_ROUTE_ADD &&
+	    mgmt_event != NET_EVENT_IPV4_ROUTE_DEL) {
+		return;
+	}
+
+	last_event = mgmt_event;
+	memcpy(&last_info, cb->info, sizeof(last_info));
+
+	k_sem_give(&wait_event);
+}
+
+static uint32_t test_rand(void)
+{
+	/* Deterministic, so that a failure can be reproduced */
+	seed = seed * 1103515245U + 12345U;
+
+	return seed >> 8;
+}
+
+static struct net_route_entry *add6(const char *prefix, uint8_t len)
+{
+	struct net_route_entry *route;
+	struct in6_addr addr;
+
+	zassert_equal(net_addr_pton(AF_INET6, prefix, &addr), 0,
+		      "Invalid address %s", prefix);
+
+	route = net_route_add(iface1, &addr, len, &nexthop6);
+	zassert_not_null(route, "Cannot add route to %s/%d", prefix, len);
+
+	return route;
+}
+
+static struct net_route_entry *lookup6(struct net_if *iface, const char *dst)
+{
+	struct in6_addr addr;
+
+	zassert_equal(net_addr_pton(AF_INET6, dst, &addr), 0,
+		      "Invalid address %s", dst);
+
+	return net_route_lookup(iface, &addr);
+}
+
+static struct net_route_entry_ipv4 *add4(struct net_if *iface,
+					 const char *prefix, uint8_t len,
+					 const char *gw)
+{
+	struct net_route_entry_ipv4 *route;
+	struct in_addr addr, gw_addr;
+
+	zassert_equal(net_addr_pton(AF_INET, prefix, &addr), 0,
+		      "Invalid address %s", prefix);
+
+	if (gw) {
+		zassert_equal(net_addr_pton(AF_INET, gw, &gw_addr), 0,
+			      "Invalid address %s", gw);
+	}
+
+	route = net_route_ipv4_add(iface, &addr, len, gw ? &gw_addr : NULL);
+	zassert_not_null(route, "Cannot add route to %s/%d", prefix, len);
+
+	return route;
+}
+
+static struct net_route_entry_ipv4 *lookup4(struct net_if *iface,
+					    const char *dst)
+{
+	struct in_addr addr;
+
+	zassert_equal(net_addr_pton(AF_INET, dst, &addr), 0,
+		      "Invalid address %s", dst);
+
+	return net_route_ipv4_lookup(iface, &addr);
+}
+
+static void test_setup(void)
+{
+	struct net_linkaddr lladdr = {
+		.addr = net_iface2_data.mac_addr,
+		.len = sizeof(struct net_eth_addr),
+		.type = NET_LINK_ETHERNET,
+	};
+
+	k_sem_init(&wait_event, 0, UINT_MAX);
+
+	iface1 = net_if_get_by_index(1);
+	iface2 = net_if_get_by_index(2);
+	zassert_not_null(iface1, "Interface 1");
+	zassert_not_null(iface2, "Interface 2");
+
+	zassert_not_null(net_if_ipv4_addr_add(iface1, &iface1_addr,
+					      NET_ADDR_MANUAL, 0),
+			 "Cannot add IPv4 address");
+	zassert_not_null(net_if_ipv4_addr_add(iface2, &iface2_addr,
+					      NET_ADDR_MANUAL, 0),
+			 "Cannot add IPv4 address");
+	net_if_ipv4_set_netmask(iface1, &netmask);
+	net_if_ipv4_set_netmask(iface2, &netmask);
+
+	/* The routes need the nexthop in the neighbor cache */
+	zassert_not_null(net_ipv6_nbr_add(iface1, &nexthop6, &lladdr, false,
+					  NET_IPV6_NBR_STATE_REACHABLE),
+			 "Cannot add neighbor");
+
+	net_mgmt_init_event_callback(&mgmt_cb, route_event_handler,
+				     NET_EVENT_IPV4_ROUTE_ADD |
+				     NET_EVENT_IPV4_ROUTE_DEL);
+	net_mgmt_add_event_callback(&mgmt_cb);
+}
+
+static void test_ipv6_lpm(void)
+{
+	struct net_route_entry *p32, *p48, *p64, *host;
+
+	p32 = add6("2001:db8::", 32);
+	p48 = add6("2001:db8:1::", 48);
+	p64 = add6("2001:db8:1:2::", 64);
+	host = add6("2001:db8:1:2::5", 128);
+
+	zassert_not_equal(p32, p48, "Prefix merged with a shorter one");
+
+	zassert_equal_ptr(lookup6(iface1, "2001:db8:1:2::5"), host, "/128");
+	zassert_equal_ptr(lookup6(iface1, "2001:db8:1:2::6"), p64, "/64");
+	zassert_equal_ptr(lookup6(iface1, "2001:db8:1:3::1"), p48, "/48");
+	zassert_equal_ptr(lookup6(iface1, "2001:db8:2::1"), p32, "/32");
+	zassert_is_null(lookup6(iface1, "2001:db9::1"), "No route");
+	zassert_is_null(lookup6(iface2, "2001:db8:1:2::5"), "Other iface");
+	zassert_equal_ptr(lookup6(NULL, "2001:db8:1:2::6"), p64, "Any iface");
+
+	zassert_equal(net_route_del(p48), 0, "Cannot delete /48");
+
+	zassert_equal_ptr(lookup6(iface1, "2001:db8:1:3::1"), p32, "/32");
+	zassert_equal_ptr(lookup6(iface1, "2001:db8:1:2::6"), p64, "/64");
+	zassert_equal_ptr(lookup6(iface1, "2001:db8:1:2::5"), host, "/128");
+
+	zassert_equal(net_route_del(host), 0, "Cannot delete /128");
+	zassert_equal(net_route_del(p64), 0, "Cannot delete /64");
+
+	zassert_equal_ptr(lookup6(iface1, "2001:db8:1:2::5"), p32, "/32");
+
+	zassert_equal(net_route_del(p32), 0, "Cannot delete /32");
+
+	zassert_is_null(lookup6(iface1, "2001:db8:1:2::5"), "Routes left");
+}
+
+static void route_count_cb(struct net_route_entry_ipv4 *entry,
+			   void *user_data)
+{
+	(*(int *)user_data)++;
+}
+
+static void test_ipv4_lpm(void)
+{
+	struct net_route_entry_ipv4 *def, *p8, *p16, *p24, *route;
+	int count = 0;
+
+	def = add4(iface1, "0.0.0.0", 0, "192.0.2.254");
+	p8 = add4(iface1, "10.0.0.0", 8, "192.0.2.1");
+	p16 = add4(iface1, "10.1.0.0", 16, "192.0.2.2");
+	p24 = add4(iface2, "10.1.2.0", 24, NULL);
+
+	zassert_equal_ptr(lookup4(NULL, "10.1.2.3"), p24, "/24");
+	zassert_equal_ptr(lookup4(NULL, "10.1.3.3"), p16, "/16");
+	zassert_equal_ptr(lookup4(NULL, "10.2.3.3"), p8, "/8");
+	zassert_equal_ptr(lookup4(NULL, "11.2.3.3"), def, "/0");
+	zassert_equal_ptr(lookup4(iface1, "10.1.2.3"), p16, "iface1");
+	zassert_is_null(lookup4(iface2, "10.1.3.3"), "iface2");
+
+	zassert_true(net_ipv4_is_addr_unspecified(&p24->gw), "Gateway set");
+
+	/* The host bits are ignored, this is the same prefix */
+	route = add4(iface2, "10.1.2.77", 24, "198.51.100.1");
+	zassert_equal_ptr(route, p24, "Route not updated");
+	zassert_equal(p24->addr.s4_addr[3], 0, "Host bits kept");
+	zassert_equal(p24->gw.s4_addr[3], 1, "Gateway not updated");
+
+	zassert_is_null(net_route_ipv4_add(iface1, &p24->addr, 33, NULL),
+			"Invalid prefix length");
+
+	zassert_equal(net_route_ipv4_foreach(route_count_cb, &count), 4,
+		      "Invalid number of routes");
+	zassert_equal(count, 4, "Callback not called for each route");
+
+	zassert_equal(net_route_ipv4_del(p16), 0, "Cannot delete /16");
+	zassert_equal(net_route_ipv4_del(p16), -EINVAL, "Deleted twice");
+
+	zassert_equal_ptr(lookup4(NULL, "10.1.3.3"), p8, "/8");
+	zassert_equal_ptr(lookup4(NULL, "10.1.2.3"), p24, "/24");
+
+	zassert_equal(net_route_ipv4_del(def), 0, "Cannot delete /0");
+	zassert_is_null(lookup4(NULL, "11.2.3.3"), "Default route left");
+
+	zassert_equal(net_route_ipv4_del(p8), 0, "Cannot delete /8");
+	zassert_equal(net_route_ipv4_del(p24), 0, "Cannot delete /24");
+
+	zassert_is_null(lookup4(NULL, "10.1.2.3"), "Routes left");
+}
+
+static void test_ipv4_events(void)
+{
+	struct net_route_entry_ipv4 *route;
+
+	/* Let the events of the previous tests be handled first */
+	k_msleep(100);
+	k_sem_reset(&wait_event);
+
+	route = add4(iface1, "203.0.113.0", 24, "192.0.2.1");
+
+	zassert_equal(k_sem_take(&wait_event, WAIT_TIME), 0, "No add event");
+	zassert_equal(last_event, NET_EVENT_IPV4_ROUTE_ADD, "Invalid event");
+	zassert_true(net_ipv4_addr_cmp(&last_info.addr, &route->addr),
+		     "Invalid prefix");
+	zassert_true(net_ipv4_addr_cmp(&last_info.gw, &route->gw),
+		     "Invalid gateway");
+	zassert_equal(last_info.prefix_len, 24, "Invalid prefix length");
+
+	zassert_equal(net_route_ipv4_del(route), 0, "Cannot delete route");
+
+	zassert_equal(k_sem_take(&wait_event, WAIT_TIME), 0, "No del event");
+	zassert_equal(last_event, NET_EVENT_IPV4_ROUTE_DEL, "Invalid event");
+	zassert_equal(last_info.prefix_len, 24, "Invalid prefix length");
+}
+
+static void test_ipv4_select_iface(void)
+{
+	struct net_route_entry_ipv4 *route;
+	struct in_addr dst;
+
+	net_addr_pton(AF_INET, "203.0.113.5", &dst);
+
+	zassert_equal_ptr(net_if_ipv4_select_src_iface(&dst),
+			  net_if_get_default(), "Not the default iface");
+
+	route = add4(iface2, "203.0.113.0", 24, "198.51.100.1");
+
+	zassert_equal_ptr(net_if_ipv4_select_src_iface(&dst), iface2,
+			  "Route not used");
+
+	/* The network of an interface comes first */
+	net_addr_pton(AF_INET, "192.0.2.5", &dst);
+	zassert_equal_ptr(net_if_ipv4_select_src_iface(&dst), iface1,
+			  "Route preferred over the interface network");
+
+	zassert_equal(net_route_ipv4_del(route), 0, "Cannot delete route");
+}
+
+/* Random address starting with the given prefix */
+static void random_addr(uint8_t *addr, const uint8_t *prefix,
+			uint8_t prefix_len, int size)
+{
+	int i;
+
+	for (i = 0; i < size; i++) {
+		uint8_t rand = test_rand();
+
+		if (prefix_len >= (i + 1) * 8) {
+			addr[i] = prefix[i];
+		} else if (prefix_len > i * 8) {
+			uint8_t mask = 0xff << (8 - prefix_len % 8);
+
+			addr[i] = (prefix[i] & mask) | (rand & ~mask);
+		} else {
+			addr[i] = rand;
+		}
+	}
+}
+
+struct random_route {
+	void *entry;
+	uint8_t addr[sizeof(struct in6_addr)];
+	uint8_t prefix_len;
+};
+
+/* Longest of the prefixes that addr starts with, the linear way */
+static void *random_lookup(struct random_route *routes, int count,
+			   const uint8_t *addr)
+{
+	void *found = NULL;
+	int i, longest = -1;
+
+	for (i = 0; i < count; i++) {
+		if (routes[i].entry && routes[i].prefix_len > longest &&
+		    net_ipv6_is_prefix(addr, routes[i].addr,
+				       routes[i].prefix_len)) {
+			found = routes[i].entry;
+			longest = routes[i].prefix_len;
+		}
+	}
+
+	return found;
+}
+
+static void random_check(struct random_route *routes, int count,
+			 bool ipv6)
+{
+	uint8_t addr[sizeof(struct in6_addr)];
+	struct random_route *route;
+	void *found;
+	int i;
+
+	for (i = 0; i < RANDOM_LOOKUPS; i++) {
+		/* Close to some route, so that many lookups match */
+		route = &routes[test_rand() % count];
+
+		if (ipv6) {
+			random_addr(addr, route->addr,
+				    test_rand() % (route->prefix_len + 1),
+				    sizeof(struct in6_addr));
+			found = net_route_lookup(iface1,
+						 (struct in6_addr *)addr);
+		} else {
+			random_addr(addr, route->addr,
+				    test_rand() % (route->prefix_len + 1),
+				    sizeof(struct in_addr));
+			found = net_route_ipv4_lookup(iface1,
+						      (struct in_addr *)addr);
+		}
+
+		zassert_equal_ptr(found, random_lookup(routes, count, addr),
+				  "Lookup %d does not match", i);
+	}
+}
+
+static void random_test(int count, bool ipv6)
+{
+	static struct random_route routes[MAX(CONFIG_NET_MAX_ROUTES,
+					      CONFIG_NET_IPV4_MAX_ROUTES)];
+	static const uint8_t base[sizeof(struct in6_addr)] = { 0x20, 0x01, 0x0d,
+							  0xb8 };
+	int round, i, j;
+
+	for (round = 0; round < RANDOM_ROUNDS; round++) {
+		for (i = 0; i < count; i++) {
+			routes[i].entry = NULL;
+
+			if (ipv6) {
+				routes[i].prefix_len = 32 + test_rand() % 97;
+				random_addr(routes[i].addr, base, 32,
+					    sizeof(struct in6_addr));
+				routes[i].entry = net_route_add(
+					iface1,
+					(struct in6_addr *)routes[i].addr,
+					routes[i].prefix_len, &nexthop6);
+			} else {
+				routes[i].prefix_len = test_rand() % 33;
+				random_addr(routes[i].addr, base, 0,
+					    sizeof(struct in_addr));
+				routes[i].entry = net_route_ipv4_add(
+					iface1,
+					(struct in_addr *)routes[i].addr,
+					routes[i].prefix_len, NULL);
+			}
+
+			zassert_not_null(routes[i].entry,
+					 "Round %d: cannot add route %d",
+					 round, i);
+
+			/* Adding the same prefix again updates the route */
+			for (j = 0; j < i; j++) {
+				if (routes[j].entry == routes[i].entry) {
+					routes[i].entry = NULL;
+				}
+			}
+		}
+
+		random_check(routes, count, ipv6);
+
+		for (i = round % 2; i < count; i += 2) {
+			if (!routes[i].entry) {
+				continue;
+			}
+
+			zassert_equal(ipv6 ? net_route_del(routes[i].entry) :
+				      net_route_ipv4_del(routes[i].entry), 0,
+				      "Cannot delete route %d", i);
+			routes[i].entry = NULL;
+		}
+
+		random_check(routes, count, ipv6);
+
+		for (i = 0; i < count; i++) {
+			if (!routes[i].entry) {
+				continue;
+			}
+
+			zassert_equal(ipv6 ? net_route_del(routes[i].entry) :
+				      net_route_ipv4_del(routes[i].entry), 0,
+				      "Cannot delete route %d", i);
+			routes[i].entry = NULL;
+		}
+
+		random_check(routes, count, ipv6);
+	}
+}
+
+static void test_ipv6_random(void)
+{
+	random_test(CONFIG_NET_MAX_ROUTES, true);
+}
+
+static void test_ipv4_random(void)
+{
+	random_test(CONFIG_NET_IPV4_MAX_ROUTES, false);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_route_lpm_test,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_ipv6_lpm),
+			 ztest_unit_test(test_ipv4_lpm),
+			 ztest_unit_test(test_ipv4_events),
+			 ztest_unit_test(test_ipv4_select_iface),
+			 ztest_unit_test(test_ipv6_random),
+			 ztest_unit_test(test_ipv4_random)
+			 );
+
+	ztest_run_test_suite(net_route_lpm_test);
+}
@@ -0,0 +1,310 @@
+/* main.c - Application main entry point */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_CORE_LOG_LEVEL);
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/printk.h>
+#include <linker/sections.h>
+#include <random/rand32.h>
+
+#include <ztest.h>
+
+#include <net/ethernet.h>
+#include <net/dummy.h>
+#include <net/buf.h>
+#include <net/net_ip.h>
+#include <net/net_if.h>
+
+#define NET_LOG_ENABLED 1
+#include "net_private.h"
+#include "net_stats.h"
+
+#include "ipv4.h"
+#include "udp_internal.h"
+
+static struct in_addr my_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+
+#define LOCAL_PORT 4242
+#define PEER_PORT 4343
+
+#define HDRS_LEN (sizeof(struct net_ipv4_hdr) + sizeof(struct net_udp_hdr))
+
+/* Payload of each datagram: the flow index and its sequence number */
+#define DATA_LEN 2
+
+#define N_FLOWS 16
+#define PKTS_PER_FLOW 4
+
+#define WAIT_TIME K_SECONDS(1)
+
+#define ALLOC_TIMEOUT K_MSEC(500)
+
+static struct net_if *iface1;
+
+/* Next sequence number expected from each flow */
+static uint8_t next_seq[N_FLOWS];
+static int recv_count;
+static bool out_of_order;
+static struct k_sem wait_recv;
+
+struct net_if_test {
+	uint8_t mac_addr[sizeof(struct net_eth_addr)];
+};
+
+static int net_iface_dev_init(const struct device *dev)
+{
+	return 0;
+}
+
+static uint8_t *net_iface_get_mac(const struct device *dev)
+{
+	struct net_if_test *data = dev->data;
+
+	if (data->mac_addr[2] == 0x00) {
+		/* 00-00-5E-00-53-xx Documentation RFC 7042 */
+		data->mac_addr[0] = 0x00;
+		data->mac_addr[1] = 0x00;
+		data->mac_addr[2] = 0x5E;
+		data->mac_addr[3] = 0x00;
+		data->mac_addr[4] = 0x53;
+		data->mac_addr[5] = sys_rand32_get();
+	}
+
+	return data->mac_addr;
+}
+
+static void net_iface_init(struct net_if *iface)
+{
+	uint8_t *mac = net_iface_get_mac(net_if_get_device(iface));
+
+	net_if_set_link_addr(iface, mac, sizeof(struct net_eth_addr),
+			     NET_LINK_ETHERNET);
+}
+
+static int sender_iface(const struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+struct net_if_test net_iface1_data;
+
+static struct dummy_api net_iface_api = {
+	.iface_api.init = net_iface_init,
+	.send = sender_iface,
+};
+
+NET_DEVICE_INIT_INSTANCE(net_iface1_test,
+			 "iface1",
+			 iface1,
+			 net_iface_dev_init,
+			 NULL,
+			 &net_iface1_data,
+			 NULL,
+			 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+			 &net_iface_api,
+			 DUMMY_L2,
+			 NET_L2_GET_CTX_TYPE(DUMMY_L2),
+			 127);
+
+static enum net_verdict udp_handler(struct net_conn *conn,
+				    struct net_pkt *pkt,
+				    union net_ip_header *ip_hdr,
+				    union net_proto_header *proto_hdr,
+				    void *user_data)
+{
+	uint8_t data[DATA_LEN];
+
+	net_pkt_cursor_init(pkt);
+
+	if (net_pkt_skip(pkt, HDRS_LEN) == 0 &&
+	    net_pkt_read(pkt, data, sizeof(data)) == 0 &&
+	    data[0] < N_FLOWS) {
+		if (data[1] != next_seq[data[0]]) {
+			out_of_order = true;
+		}
+
+		next_seq[data[0]] = data[1] + 1;
+		recv_count++;
+	}
+
+	net_pkt_unref(pkt);
+	k_sem_give(&wait_recv);
+
+	return NET_OK;
+}
+
+/* Create a datagram of the given flow, which is the peer port offset */
+static struct net_pkt *create_datagram(uint8_t flow, uint8_t seq,
+				       uint16_t frag)
+{
+	struct net_ipv4_hdr hdr = { 0 };
+	struct net_udp_hdr udp_hdr = { 0 };
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface1, HDRS_LEN + DATA_LEN,
+					   AF_UNSPEC, 0, ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "Cannot allocate datagram");
+
+	hdr.vhl = 0x45;
+	hdr.len = htons(HDRS_LEN + DATA_LEN);
+	hdr.ttl = 64U;
+	hdr.proto = IPPROTO_UDP;
+	sys_put_be16(frag, hdr.offset);
+	net_ipaddr_copy(&hdr.src, &peer_addr);
+	net_ipaddr_copy(&hdr.dst, &my_addr);
+
+	udp_hdr.src_port = htons(PEER_PORT + flow);
+	udp_hdr.dst_port = htons(LOCAL_PORT);
+	udp_hdr.len = htons(sizeof(udp_hdr) + DATA_LEN);
+
+	zassert_equal(net_pkt_write(pkt, &hdr, sizeof(hdr)), 0,
+		      "IPv4 header append failed");
+	zassert_equal(net_pkt_write(pkt, &udp_hdr, sizeof(udp_hdr)), 0,
+		      "UDP header append failed");
+	zassert_equal(net_pkt_write_u8(pkt, flow), 0, "Cannot write payload");
+	zassert_equal(net_pkt_write_u8(pkt, seq), 0, "Cannot write payload");
+
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(hdr));
+	net_pkt_set_ipv4_opts_len(pkt, 0);
+
+	NET_IPV4_HDR(pkt)->chksum = net_calc_chksum_ipv4(pkt);
+	((struct net_udp_hdr *)(pkt->buffer->data + sizeof(hdr)))->chksum =
+		net_calc_chksum_udp(pkt);
+
+	net_pkt_cursor_init(pkt);
+
+	return pkt;
+}
+
+static int flow2tc(uint8_t flow, uint16_t frag)
+{
+	struct net_pkt *pkt = create_datagram(flow, 0, frag);
+	int tc;
+
+	tc = net_rx_flow2tc(iface1, pkt);
+	zassert_equal(pkt->cursor.pos, pkt->buffer->data, "Cursor moved");
+
+	net_pkt_unref(pkt);
+
+	return tc;
+}
+
+static void test_setup(void)
+{
+	struct net_conn_handle *handle;
+	struct sockaddr_in local = {
+		.sin_family = AF_INET,
+	};
+	struct net_if_addr *ifaddr;
+	int ret;
+
+	k_sem_init(&wait_recv, 0, UINT_MAX);
+
+	iface1 = net_if_get_by_index(1);
+	zassert_not_null(iface1, "Interface 1");
+
+	ifaddr = net_if_ipv4_addr_add(iface1, &my_addr, NET_ADDR_MANUAL, 0);
+	zassert_not_null(ifaddr, "Cannot add IPv4 address");
+
+	net_ipaddr_copy(&local.sin_addr, &my_addr);
+
+	ret = net_udp_register(AF_INET, NULL, (struct sockaddr *)&local, 0,
+			       LOCAL_PORT, NULL, udp_handler, NULL, &handle);
+	zassert_equal(ret, 0, "Cannot register UDP handler (%d)", ret);
+}
+
+static void test_flow_hash(void)
+{
+	bool used[NET_TC_RX_COUNT] = { false };
+	int i, tc, queues = 0;
+
+	for (i = 0; i < N_FLOWS; i++) {
+		tc = flow2tc(i, 0U);
+		zassert_true(tc >= 0 && tc < NET_TC_RX_COUNT,
+			     "Invalid queue %d", tc);
+		zassert_equal(flow2tc(i, 0U), tc, "Flow %d moved", i);
+
+		if (!used[tc]) {
+			used[tc] = true;
+			queues++;
+		}
+	}
+
+	zassert_true(queues > 1, "All the flows in one queue");
+}
+
+static void test_fragment_hash(void)
+{
+	uint16_t frag = NET_IPV4_MF << 13;
+	int i;
+
+	/* The ports of a fragment are not looked at, whatever they are */
+	for (i = 1; i < N_FLOWS; i++) {
+		zassert_equal(flow2tc(i, frag), flow2tc(0, frag),
+			      "Fragment %d hashed on its ports", i);
+	}
+}
+
+static void test_flow_order(void)
+{
+	net_stats_t before[NET_TC_RX_COUNT], expected[NET_TC_RX_COUNT];
+	struct net_pkt *pkt;
+	int i, seq, ret;
+
+	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+		before[i] = GET_STAT(iface1, tc.recv[i].pkts);
+		expected[i] = 0;
+	}
+
+	for (i = 0; i < N_FLOWS; i++) {
+		expected[flow2tc(i, 0U)] += PKTS_PER_FLOW;
+	}
+
+	for (seq = 0; seq < PKTS_PER_FLOW; seq++) {
+		for (i = 0; i < N_FLOWS; i++) {
+			pkt = create_datagram(i, seq, 0U);
+
+			ret = net_recv_data(iface1, pkt);
+			zassert_equal(ret, 0, "Cannot receive (%d)", ret);
+		}
+	}
+
+	for (i = 0; i < N_FLOWS * PKTS_PER_FLOW; i++) {
+		zassert_equal(k_sem_take(&wait_recv, WAIT_TIME), 0,
+			      "Datagram %d not received", i);
+	}
+
+	zassert_equal(recv_count, N_FLOWS * PKTS_PER_FLOW,
+		      "Invalid datagrams");
+	zassert_false(out_of_order, "Flow reordered");
+
+	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+		zassert_equal(GET_STAT(iface1, tc.recv[i].pkts) - before[i],
+			      expected[i], "Queue %d: invalid count", i);
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_rx_rss_test,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_flow_hash),
+			 ztest_unit_test(test_fragment_hash),
+			 ztest_unit_test(test_flow_order)
+			 );
+
+	ztest_run_test_suite(net_rx_rss_test);
+}
@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <ztest_assert.h>
+
+#include <net/socket.h>
+#include <net/net_if.h>
+#include <net/net_mgmt.h>
+#include <net/net_stats.h>
+
+#include "../../socket_helpers.h"
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 9898
+
+/* How long a packet may take to go through the loopback interface */
+#define RX_TIMEOUT 100
+
+#define DGRAM_LEN 64
+#define N_DGRAMS 10
+#define UDP_RCVBUF (3 * DGRAM_LEN)
+
+#define CHUNK_LEN 128
+#define TCP_RCVBUF 512
+#define TCP_SNDBUF 512
+
+static uint8_t data[CHUNK_LEN];
+
+static struct net_stats_buf_limits get_stats(void)
+{
+	struct net_stats_buf_limits stats;
+	int ret;
+
+	ret = net_mgmt(NET_REQUEST_STATS_GET_BUF_LIMITS, net_if_get_default(),
+		       &stats, sizeof(stats));
+	zassert_equal(ret, 0, "Cannot get the statistics (%d)", ret);
+
+	return stats;
+}
+
+static int get_int_opt(int sock, int opt)
+{
+	socklen_t optlen = sizeof(int);
+	int optval = -1;
+	int res;
+
+	res = getsockopt(sock, SOL_SOCKET, opt, &optval, &optlen);
+	zassert_equal(res, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(optlen, sizeof(int), "wrong length");
+
+	return optval;
+}
+
+static void set_int_opt(int sock, int opt, int optval)
+{
+	int res;
+
+	res = setsockopt(sock, SOL_SOCKET, opt, &optval, sizeof(optval));
+	zassert_equal(res, 0, "setsockopt failed (%d)", errno);
+}
+
+static int udp_sock(int port)
+{
+	struct sockaddr_in6 addr;
+	int sock, res;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, port, &sock,
+			    &addr);
+
+	res = bind(sock, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(res, 0, "bind failed (%d)", errno);
+
+	return sock;
+}
+
+/* Read what is queued, without waiting */
+static int drain(int sock)
+{
+	uint8_t buf[CHUNK_LEN];
+	int total = 0;
+	int res;
+
+	while ((res = recv(sock, buf, sizeof(buf), MSG_DONTWAIT)) > 0) {
+		total += res;
+	}
+
+	zassert_equal(errno, EAGAIN, "recv failed (%d)", errno);
+
+	return total;
+}
+
+static void tcp_pair(int *client, int *accepted, int rcvbuf)
+{
+	static int pairs;
+	struct sockaddr_in6 c_addr, s_addr;
+	int server, res;
+
+	/* A new client port, the previous connection may not be gone */
+	prepare_sock_tcp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR,
+			    CLIENT_PORT + pairs++, client, &c_addr);
+	prepare_sock_tcp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &server, &s_addr);
+
+	/* The accepted socket inherits the option */
+	if (rcvbuf) {
+		set_int_opt(server, SO_RCVBUF, rcvbuf);
+	}
+
+	res = bind(server, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed (%d)", errno);
+	res = listen(server, 1);
+	zassert_equal(res, 0, "listen failed (%d)", errno);
+
+	res = bind(*client, (struct sockaddr *)&c_addr, sizeof(c_addr));
+	zassert_equal(res, 0, "bind failed (%d)", errno);
+	res = connect(*client, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed (%d)", errno);
+
+	*accepted = accept(server, NULL, NULL);
+	zassert_true(*accepted >= 0, "accept failed (%d)", errno);
+
+	if (rcvbuf) {
+		zassert_equal(get_int_opt(*accepted, SO_RCVBUF), rcvbuf,
+			      "option not inherited");
+	}
+
+	zassert_equal(close(server), 0, "close failed");
+
+	res = fcntl(*client, F_SETFL, O_NONBLOCK);
+	zassert_equal(res, 0, "fcntl failed (%d)", errno);
+}
+
+static void tcp_close(int client, int accepted)
+{
+	zassert_equal(close(client), 0, "close failed");
+	zassert_equal(close(accepted), 0, "close failed");
+
+	/* Let the connection terminate */
+	k_msleep(RX_TIMEOUT);
+}
+
+/* Send until the peer or the send buffer holds the data back, letting
+ * the ACKs in between if asked to.
+ */
+static int fill(int sock, bool wait_acks)
+{
+	int total = 0;
+	int retries = 0;
+	int res;
+
+	while (retries < 5) {
+		res = send(sock, data, sizeof(data), 0);
+		if (res < 0) {
+			zassert_equal(errno, EAGAIN, "send failed (%d)", errno);
+
+			if (!wait_acks) {
+				break;
+			}
+
+			retries++;
+			k_msleep(RX_TIMEOUT / 5);
+			continue;
+		}
+
+		zassert_equal(res, sizeof(data), "partial send");
+		total += res;
+		retries = 0;
+
+		if (wait_acks) {
+			k_msleep(RX_TIMEOUT / 10);
+		}
+	}
+
+	return total;
+}
+
+void test_options(void)
+{
+	int optval = 1024;
+	int sock, res;
+
+	sock = udp_sock(SERVER_PORT);
+
+	zassert_equal(get_int_opt(sock, SO_RCVBUF), 0, "not unlimited");
+	zassert_equal(get_int_opt(sock, SO_SNDBUF), 0, "not unlimited");
+
+	set_int_opt(sock, SO_RCVBUF, 1000);
+	set_int_opt(sock, SO_SNDBUF, 2000);
+	zassert_equal(get_int_opt(sock, SO_RCVBUF), 1000, "option not set");
+	zassert_equal(get_int_opt(sock, SO_SNDBUF), 2000, "option not set");
+
+	optval = -1;
+	res = setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &optval, sizeof(optval));
+	zassert_equal(res, -1, "negative size accepted");
+	zassert_equal(errno, EINVAL, "wrong errno (%d)", errno);
+
+	res = setsockopt(sock, SOL_SOCKET, SO_SNDBUF, &optval, 1);
+	zassert_equal(res, -1, "wrong length accepted");
+	zassert_equal(errno, EINVAL, "wrong errno (%d)", errno);
+
+	zassert_equal(close(sock), 0, "close failed");
+}
+
+void test_udp_rcvbuf(void)
+{
+	struct net_stats_buf_limits before, after;
+	struct sockaddr_in6 addr = { 0 };
+	int slow, fast, client;
+	int i, res, slow_len, fast_len;
+
+	slow = udp_sock(SERVER_PORT);
+	fast = udp_sock(SERVER_PORT + 1);
+	client = udp_sock(CLIENT_PORT);
+
+	set_int_opt(slow, SO_RCVBUF, UDP_RCVBUF);
+
+	before = get_stats();
+
+	addr.sin6_family = AF_INET6;
+	zassert_equal(inet_pton(AF_INET6, CONFIG_NET_CONFIG_MY_IPV6_ADDR,
+				&addr.sin6_addr), 1, "inet_pton failed");
+
+	/* The slow reader does not read in between, the fast one is not
+	 * held back by it.
+	 */
+	for (i = 0; i < N_DGRAMS; i++) {
+		addr.sin6_port = htons(SERVER_PORT);
+		res = sendto(client, data, DGRAM_LEN, 0,
+			     (struct sockaddr *)&addr, sizeof(addr));
+		zassert_equal(res, DGRAM_LEN, "sendto failed (%d)", errno);
+
+		addr.sin6_port = htons(SERVER_PORT + 1);
+		res = sendto(client, data, DGRAM_LEN, 0,
+			     (struct sockaddr *)&addr, sizeof(addr));
+		zassert_equal(res, DGRAM_LEN, "sendto failed (%d)", errno);
+
+		k_msleep(RX_TIMEOUT / 10);
+		fast_len = drain(fast);
+		zassert_equal(fast_len, DGRAM_LEN, "fast reader lost data");
+	}
+
+	k_msleep(RX_TIMEOUT);
+
+	slow_len = drain(slow);
+	after = get_stats();
+
+	TC_PRINT("slow reader got %d of %d datagrams, %u dropped\n",
+		 slow_len / DGRAM_LEN, N_DGRAMS,
+		 after.rcvbuf_drop - before.rcvbuf_drop);
+
+	zassert_equal(slow_len, UDP_RCVBUF, "wrong amount of data queued");
+	zassert_equal(after.rcvbuf_drop - before.rcvbuf_drop,
+		      N_DGRAMS - UDP_RCVBUF / DGRAM_LEN, "wrong drop count");
+
+	/* Reading makes room again */
+	addr.sin6_port = htons(SERVER_PORT);
+	for (i = 0; i < UDP_RCVBUF / DGRAM_LEN; i++) {
+		res = sendto(client, data, DGRAM_LEN, 0,
+			     (struct sockaddr *)&addr, sizeof(addr));
+		zassert_equal(res, DGRAM_LEN, "sendto failed (%d)", errno);
+	}
+
+	k_msleep(RX_TIMEOUT);
+	zassert_equal(drain(slow), UDP_RCVBUF, "wrong amount of data queued");
+
+	zassert_equal(close(slow), 0, "close failed");
+	zassert_equal(close(fast), 0, "close failed");
+	zassert_equal(close(client), 0, "close failed");
+}
+
+void test_tcp_rcvbuf(void)
+{
+	struct net_stats_buf_limits before, after;
+	int client, accepted;
+	int sent, received;
+
+	tcp_pair(&client, &accepted, TCP_RCVBUF);
+
+	before = get_stats();
+
+	/* The peer stops sending once the window is closed */
+	sent = fill(client, true);
+	after = get_stats();
+
+	TC_PRINT("%d bytes sent to a %d bytes receive buffer\n", sent,
+		 TCP_RCVBUF);
+
+	zassert_true(sent >= TCP_RCVBUF, "window closed early");
+	zassert_true(sent < 2 * TCP_RCVBUF, "window not closed");
+	zassert_true(after.rcvwnd_zero > before.rcvwnd_zero,
+		     "zero window not counted");
+
+	/* Reading opens the window again */
+	received = drain(accepted);
+	k_msleep(RX_TIMEOUT);
+	received += drain(accepted);
+	zassert_equal(received, sent, "data lost");
+
+	sent = fill(client, true);
+	zassert_true(sent >= TCP_RCVBUF, "window not opened");
+	zassert_true(sent < 2 * TCP_RCVBUF, "window not closed");
+	k_msleep(RX_TIMEOUT);
+	received = drain(accepted);
+	k_msleep(RX_TIMEOUT);
+	received += drain(accepted);
+	zassert_equal(received, sent, "data lost");
+
+	tcp_close(client, accepted);
+}
+
+void test_tcp_sndbuf(void)
+{
+	struct net_stats_buf_limits before, after;
+	int client, accepted;
+	int sent;
+
+	tcp_pair(&client, &accepted, 0);
+	set_int_opt(client, SO_SNDBUF, TCP_SNDBUF);
+
+	before = get_stats();
+
+	/* Nothing is acknowledged while this thread does not sleep */
+	sent = fill(client, false);
+	after = get_stats();
+
+	zassert_equal(sent, TCP_SNDBUF, "send buffer not full (%d)", sent);
+	zassert_equal(after.sndbuf_full - before.sndbuf_full, 1,
+		      "full send buffer not counted");
+
+	k_msleep(RX_TIMEOUT);
+	zassert_equal(drain(accepted), sent, "data lost");
+
+	/* The acknowledged data is no longer counted */
+	sent = fill(client, false);
+	zassert_equal(sent, TCP_SNDBUF, "send buffer not emptied (%d)", sent);
+	k_msleep(RX_TIMEOUT);
+	zassert_equal(drain(accepted), sent, "data lost");
+
+	tcp_close(client, accepted);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_buf_limits,
+			 ztest_unit_test(test_options),
+			 ztest_unit_test(test_udp_rcvbuf),
+			 ztest_unit_test(test_tcp_rcvbuf),
+			 ztest_unit_test(test_tcp_sndbuf));
+
+	ztest_run_test_suite(socket_buf_limits);
+}
@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <stdio.h>
+#include <ztest_assert.h>
+
+#include <net/socket.h>
+
+#include "../../socket_helpers.h"
+
+#define TEST_STR_SMALL "test"
+
+#define CLIENT_PORT 9898
+#define SERVER_PORT 4242
+#define SERVER_PORT2 4243
+#define TCP_SERVER_PORT 4244
+
+/* How long a datagram may take to go through the loopback interface */
+#define RX_TIMEOUT 100
+
+static int c_sock, s_sock, s_sock2;
+static struct sockaddr_in6 c_addr, s_addr, s_addr2;
+
+static void setup(void)
+{
+	int res;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &c_sock, &c_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &s_sock, &s_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT2,
+			    &s_sock2, &s_addr2);
+
+	res = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = bind(s_sock2, (struct sockaddr *)&s_addr2, sizeof(s_addr2));
+	zassert_equal(res, 0, "bind failed");
+}
+
+static void teardown(void)
+{
+	zassert_equal(close(c_sock), 0, "close failed");
+	zassert_equal(close(s_sock), 0, "close failed");
+	zassert_equal(close(s_sock2), 0, "close failed");
+}
+
+static void send_to(struct sockaddr_in6 *addr)
+{
+	ssize_t len;
+
+	len = sendto(c_sock, TEST_STR_SMALL, sizeof(TEST_STR_SMALL) - 1, 0,
+		     (struct sockaddr *)addr, sizeof(*addr));
+	zassert_equal(len, sizeof(TEST_STR_SMALL) - 1, "sendto failed");
+}
+
+static void recv_from(int sock)
+{
+	char buf[10];
+	ssize_t len;
+
+	len = recv(sock, buf, sizeof(buf), MSG_DONTWAIT);
+	zassert_equal(len, sizeof(TEST_STR_SMALL) - 1, "recv failed");
+}
+
+static void add_sock(int epfd, int sock, uint32_t events)
+{
+	struct epoll_event ev = {
+		.events = events,
+		.data.fd = sock,
+	};
+
+	zassert_equal(epoll_ctl(epfd, EPOLL_CTL_ADD, sock, &ev), 0,
+		      "epoll_ctl failed (%d)", errno);
+}
+
+static void check_wait(int epfd, int timeout, int sock, uint32_t events)
+{
+	struct epoll_event ev[3];
+	int res;
+
+	res = epoll_wait(epfd, ev, ARRAY_SIZE(ev), timeout);
+
+	if (sock < 0) {
+		zassert_equal(res, 0, "unexpected events");
+		return;
+	}
+
+	zassert_equal(res, 1, "expected one event, got %d", res);
+	zassert_equal(ev[0].data.fd, sock, "wrong socket");
+	zassert_equal(ev[0].events, events, "wrong events");
+}
+
+void test_level_triggered(void)
+{
+	int epfd;
+
+	setup();
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	add_sock(epfd, s_sock, EPOLLIN);
+	add_sock(epfd, s_sock2, EPOLLIN);
+
+	check_wait(epfd, 0, -1, 0);
+
+	send_to(&s_addr2);
+	check_wait(epfd, RX_TIMEOUT, s_sock2, EPOLLIN);
+
+	/* Still readable, so reported again */
+	check_wait(epfd, 0, s_sock2, EPOLLIN);
+
+	recv_from(s_sock2);
+	check_wait(epfd, 0, -1, 0);
+
+	zassert_equal(close(epfd), 0, "close failed");
+
+	teardown();
+}
+
+void test_edge_triggered(void)
+{
+	int epfd;
+
+	setup();
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	add_sock(epfd, s_sock, EPOLLIN | EPOLLET);
+
+	send_to(&s_addr);
+	check_wait(epfd, RX_TIMEOUT, s_sock, EPOLLIN);
+
+	/* Data is pending but nothing new arrived */
+	check_wait(epfd, 0, -1, 0);
+
+	send_to(&s_addr);
+	check_wait(epfd, RX_TIMEOUT, s_sock, EPOLLIN);
+
+	recv_from(s_sock);
+	recv_from(s_sock);
+
+	zassert_equal(close(epfd), 0, "close failed");
+
+	teardown();
+}
+
+void test_oneshot(void)
+{
+	struct epoll_event ev = {
+		.events = EPOLLIN | EPOLLONESHOT,
+		.data.fd = s_sock,
+	};
+	int epfd;
+
+	setup();
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	add_sock(epfd, s_sock, ev.events);
+
+	send_to(&s_addr);
+	check_wait(epfd, RX_TIMEOUT, s_sock, EPOLLIN);
+
+	/* Disabled after the first report */
+	send_to(&s_addr);
+	check_wait(epfd, RX_TIMEOUT, -1, 0);
+
+	/* Re-arming reports the pending data */
+	zassert_equal(epoll_ctl(epfd, EPOLL_CTL_MOD, s_sock, &ev), 0,
+		      "epoll_ctl failed");
+	check_wait(epfd, 0, s_sock, EPOLLIN);
+
+	recv_from(s_sock);
+	recv_from(s_sock);
+
+	zassert_equal(close(epfd), 0, "close failed");
+
+	teardown();
+}
+
+void test_epollout(void)
+{
+	int epfd;
+
+	setup();
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	add_sock(epfd, c_sock, EPOLLIN | EPOLLOUT);
+	check_wait(epfd, 0, c_sock, EPOLLOUT);
+
+	zassert_equal(close(epfd), 0, "close failed");
+
+	teardown();
+}
+
+void test_ctl_errors(void)
+{
+	struct epoll_event ev = { .events = EPOLLIN };
+	struct epoll_event events[1];
+	int epfd, epfd2;
+
+	setup();
+
+	zassert_equal(epoll_create1(1), -1, "");
+	zassert_equal(errno, EINVAL, "");
+	zassert_equal(epoll_create(0), -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	epfd = epoll_create(1);
+	zassert_true(epfd >= 0, "epoll_create failed");
+	epfd2 = epoll_create1(0);
+	zassert_true(epfd2 >= 0, "epoll_create1 failed");
+
+	/* No more instances */
+	zassert_equal(epoll_create1(0), -1, "");
+	zassert_equal(errno, ENOMEM, "");
+
+	add_sock(epfd, s_sock, EPOLLIN);
+	zassert_equal(epoll_ctl(epfd, EPOLL_CTL_ADD, s_sock, &ev), -1, "");
+	zassert_equal(errno, EEXIST, "");
+
+	zassert_equal(epoll_ctl(epfd, EPOLL_CTL_MOD, c_sock, &ev), -1, "");
+	zassert_equal(errno, ENOENT, "");
+	zassert_equal(epoll_ctl(epfd, EPOLL_CTL_DEL, c_sock, NULL), -1, "");
+	zassert_equal(errno, ENOENT, "");
+	zassert_equal(epoll_ctl(epfd, 42, s_sock, &ev), -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	/* Not an epoll instance */
+	zassert_equal(epoll_ctl(s_sock, EPOLL_CTL_ADD, c_sock, &ev), -1, "");
+	zassert_equal(errno, EINVAL, "");
+	zassert_equal(epoll_wait(s_sock, events, 1, 0), -1, "");
+	zassert_equal(errno, EINVAL, "");
+	zassert_equal(epoll_wait(epfd, events, 0, 0), -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	/* Only sockets can be watched */
+	zassert_equal(epoll_ctl(epfd, EPOLL_CTL_ADD, epfd, &ev), -1, "");
+	zassert_equal(errno, EINVAL, "");
+	zassert_equal(epoll_ctl(epfd, EPOLL_CTL_ADD, epfd2, &ev), -1, "");
+	zassert_equal(errno, EPERM, "");
+	zassert_equal(epoll_ctl(epfd, EPOLL_CTL_ADD, 1234, &ev), -1, "");
+	zassert_equal(errno, EBADF, "");
+
+	/* Registrations are shared by the instances */
+	add_sock(epfd, s_sock2, EPOLLIN);
+	add_sock(epfd2, s_sock, EPOLLIN);
+	add_sock(epfd2, s_sock2, EPOLLIN);
+	zassert_equal(epoll_ctl(epfd2, EPOLL_CTL_ADD, c_sock, &ev), -1, "");
+	zassert_equal(errno, ENOMEM, "");
+
+	/* Closing the instance frees its registrations */
+	zassert_equal(close(epfd2), 0, "close failed");
+	add_sock(epfd, c_sock, EPOLLIN);
+
+	zassert_equal(epoll_ctl(epfd, EPOLL_CTL_DEL, s_sock, NULL), 0, "");
+	send_to(&s_addr);
+	check_wait(epfd, RX_TIMEOUT, -1, 0);
+	recv_from(s_sock);
+
+	zassert_equal(close(epfd), 0, "close failed");
+
+	teardown();
+}
+
+void test_close_unregisters(void)
+{
+	int epfd;
+
+	setup();
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	add_sock(epfd, c_sock, EPOLLOUT);
+	add_sock(epfd, s_sock, EPOLLIN);
+	add_sock(epfd, s_sock2, EPOLLIN);
+
+	send_to(&s_addr);
+	zassert_equal(close(c_sock), 0, "close failed");
+	zassert_equal(close(s_sock), 0, "close failed");
+
+	/* Neither the closed writable socket nor the closed one with
+	 * pending data are reported.
+	 */
+	check_wait(epfd, RX_TIMEOUT, -1, 0);
+
+	/* Their registrations were released */
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &c_sock, &c_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &s_sock, &s_addr);
+	add_sock(epfd, c_sock, EPOLLIN);
+	add_sock(epfd, s_sock, EPOLLIN);
+
+	zassert_equal(close(epfd), 0, "close failed");
+
+	teardown();
+}
+
+static void send_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	send_to(&s_addr);
+}
+
+static K_WORK_DELAYABLE_DEFINE(send_work, send_work_handler);
+
+void test_wait_blocks(void)
+{
+	uint32_t tstamp;
+	int epfd;
+
+	setup();
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	add_sock(epfd, s_sock, EPOLLIN);
+
+	tstamp = k_uptime_get_32();
+	check_wait(epfd, 50, -1, 0);
+	zassert_true(k_uptime_get_32() - tstamp >= 50, "returned too early");
+
+	k_work_schedule(&send_work, K_MSEC(50));
+
+	tstamp = k_uptime_get_32();
+	check_wait(epfd, -1, s_sock, EPOLLIN);
+	zassert_true(k_uptime_get_32() - tstamp >= 40, "returned too early");
+
+	recv_from(s_sock);
+
+	zassert_equal(close(epfd), 0, "close failed");
+
+	teardown();
+}
+
+/* Returns a listening socket, a client connected to it and the accepted
+ * socket, the listener being registered with epfd.
+ */
+static void tcp_connect(int epfd, int *l_sock, int *cl_sock, int *a_sock)
+{
+	struct sockaddr_in6 l_addr, cl_addr;
+
+	prepare_sock_tcp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, TCP_SERVER_PORT,
+			    l_sock, &l_addr);
+	prepare_sock_tcp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, 0,
+			    cl_sock, &cl_addr);
+
+	zassert_equal(bind(*l_sock, (struct sockaddr *)&l_addr,
+			   sizeof(l_addr)), 0, "bind failed");
+	zassert_equal(listen(*l_sock, 1), 0, "listen failed");
+
+	add_sock(epfd, *l_sock, EPOLLIN);
+	check_wait(epfd, 0, -1, 0);
+
+	zassert_equal(connect(*cl_sock, (struct sockaddr *)&l_addr,
+			      sizeof(l_addr)), 0, "connect failed");
+
+	/* A pending connection makes the listener readable */
+	check_wait(epfd, RX_TIMEOUT, *l_sock, EPOLLIN);
+
+	*a_sock = accept(*l_sock, NULL, NULL);
+	zassert_true(*a_sock >= 0, "accept failed");
+}
+
+void test_tcp_accept(void)
+{
+	int l_sock, cl_sock, a_sock;
+	int epfd;
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	tcp_connect(epfd, &l_sock, &cl_sock, &a_sock);
+
+	/* Nothing left to accept */
+	check_wait(epfd, 0, -1, 0);
+
+	zassert_equal(close(epfd), 0, "close failed");
+	zassert_equal(close(a_sock), 0, "close failed");
+	zassert_equal(close(cl_sock), 0, "close failed");
+	zassert_equal(close(l_sock), 0, "close failed");
+}
+
+void test_tcp_hup(void)
+{
+	int l_sock, cl_sock, a_sock;
+	char buf[10];
+	ssize_t len;
+	int epfd;
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	tcp_connect(epfd, &l_sock, &cl_sock, &a_sock);
+
+	zassert_equal(epoll_ctl(epfd, EPOLL_CTL_DEL, l_sock, NULL), 0,
+		      "epoll_ctl failed");
+	add_sock(epfd, a_sock, EPOLLIN);
+	check_wait(epfd, 0, -1, 0);
+
+	len = send(cl_sock, TEST_STR_SMALL, sizeof(TEST_STR_SMALL) - 1, 0);
+	zassert_equal(len, sizeof(TEST_STR_SMALL) - 1, "send failed");
+	check_wait(epfd, RX_TIMEOUT, a_sock, EPOLLIN);
+	recv_from(a_sock);
+
+	/* The peer closing is reported once the data was read */
+	zassert_equal(close(cl_sock), 0, "close failed");
+	check_wait(epfd, RX_TIMEOUT, a_sock, EPOLLIN | EPOLLHUP);
+
+	len = recv(a_sock, buf, sizeof(buf), MSG_DONTWAIT);
+	zassert_equal(len, 0, "expected end of file");
+
+	/* Still reported, as the socket stays closed */
+	check_wait(epfd, 0, a_sock, EPOLLIN | EPOLLHUP);
+
+	zassert_equal(close(epfd), 0, "close failed");
+	zassert_equal(close(a_sock), 0, "close failed");
+	zassert_equal(close(l_sock), 0, "close failed");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_epoll,
+			 ztest_unit_test(test_level_triggered),
+			 ztest_unit_test(test_edge_triggered),
+			 ztest_unit_test(test_oneshot),
+			 ztest_unit_test(test_epollout),
+			 ztest_unit_test(test_ctl_errors),
+			 ztest_unit_test(test_close_unregisters),
+			 ztest_unit_test(test_wait_blocks),
+			 ztest_unit_test(test_tcp_accept),
+			 ztest_unit_test(test_tcp_hup));
+
+	ztest_run_test_suite(socket_epoll);
+}
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <stdio.h>
+#include <ztest_assert.h>
+
+#include <net/socket.h>
+
+#include "../../socket_helpers.h"
+
+#define TEST_STR_SMALL "test"
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 9898
+
+#define N_SERVERS 2
+#define N_CLIENTS 8
+
+/* How long a packet may take to go through the loopback interface */
+#define RX_TIMEOUT 100
+
+static void set_reuseport(int sock)
+{
+	int optval = 1;
+	socklen_t optlen = sizeof(optval);
+	int res;
+
+	res = setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &optval,
+			 sizeof(optval));
+	zassert_equal(res, 0, "setsockopt failed (%d)", errno);
+
+	optval = 0;
+	res = getsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &optval, &optlen);
+	zassert_equal(res, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(optval, 1, "option not set");
+}
+
+static int server_sock(int type, bool reuseport)
+{
+	struct sockaddr_in6 addr;
+	int sock;
+
+	if (type == SOCK_DGRAM) {
+		prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR,
+				    SERVER_PORT, &sock, &addr);
+	} else {
+		prepare_sock_tcp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR,
+				    SERVER_PORT, &sock, &addr);
+	}
+
+	if (reuseport) {
+		set_reuseport(sock);
+	}
+
+	if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		close(sock);
+		return -1;
+	}
+
+	return sock;
+}
+
+static int client_sock(int type, int idx, struct sockaddr_in6 *s_addr)
+{
+	struct sockaddr_in6 addr;
+	int sock, res;
+
+	if (type == SOCK_DGRAM) {
+		prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR,
+				    CLIENT_PORT + idx, &sock, &addr);
+	} else {
+		prepare_sock_tcp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR,
+				    CLIENT_PORT + idx, &sock, &addr);
+	}
+
+	res = bind(sock, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(res, 0, "bind failed");
+
+	memcpy(s_addr, &addr, sizeof(addr));
+	s_addr->sin6_port = htons(SERVER_PORT);
+
+	return sock;
+}
+
+static void test_bind_conflict(int type)
+{
+	int s1, s2;
+
+	s1 = server_sock(type, false);
+	zassert_true(s1 >= 0, "bind failed");
+	if (type == SOCK_STREAM) {
+		zassert_equal(listen(s1, 1), 0, "listen failed");
+	}
+
+	/* Both sockets have to set the option */
+	s2 = server_sock(type, true);
+	if (type == SOCK_STREAM && s2 >= 0) {
+		zassert_not_equal(listen(s2, 1), 0, "listen succeeded");
+		zassert_equal(close(s2), 0, "close failed");
+	} else {
+		zassert_true(s2 < 0, "bind succeeded");
+	}
+
+	zassert_equal(close(s1), 0, "close failed");
+}
+
+void test_udp_bind_conflict(void)
+{
+	test_bind_conflict(SOCK_DGRAM);
+}
+
+void test_tcp_bind_conflict(void)
+{
+	test_bind_conflict(SOCK_STREAM);
+}
+
+void test_udp_spread(void)
+{
+	int servers[N_SERVERS], clients[N_CLIENTS];
+	int owner[N_CLIENTS];
+	struct sockaddr_in6 s_addr, src;
+	struct zsock_pollfd pfds[N_SERVERS];
+	int received[N_SERVERS] = { 0 };
+	int i, j, round, res;
+
+	for (i = 0; i < N_SERVERS; i++) {
+		servers[i] = server_sock(SOCK_DGRAM, true);
+		zassert_true(servers[i] >= 0, "bind failed (%d)", errno);
+		pfds[i].fd = servers[i];
+		pfds[i].events = POLLIN;
+	}
+
+	for (i = 0; i < N_CLIENTS; i++) {
+		clients[i] = client_sock(SOCK_DGRAM, i, &s_addr);
+		owner[i] = -1;
+	}
+
+	/* Each client sends twice, and hits the same server both times */
+	for (round = 0; round < 2; round++) {
+		for (i = 0; i < N_CLIENTS; i++) {
+			res = sendto(clients[i], TEST_STR_SMALL,
+				     sizeof(TEST_STR_SMALL) - 1, 0,
+				     (struct sockaddr *)&s_addr,
+				     sizeof(s_addr));
+			zassert_equal(res, sizeof(TEST_STR_SMALL) - 1,
+				      "sendto failed");
+
+			res = poll(pfds, N_SERVERS, RX_TIMEOUT);
+			zassert_equal(res, 1, "one server should get it");
+
+			for (j = 0; j < N_SERVERS; j++) {
+				socklen_t addrlen = sizeof(src);
+				char buf[8];
+
+				if (!(pfds[j].revents & POLLIN)) {
+					continue;
+				}
+
+				res = recvfrom(servers[j], buf, sizeof(buf),
+					       0, (struct sockaddr *)&src,
+					       &addrlen);
+				zassert_equal(res, sizeof(TEST_STR_SMALL) - 1,
+					      "recvfrom failed");
+				zassert_equal(ntohs(src.sin6_port),
+					      CLIENT_PORT + i, "wrong client");
+
+				if (owner[i] < 0) {
+					owner[i] = j;
+				}
+
+				zassert_equal(owner[i], j, "flow moved");
+				received[j]++;
+			}
+		}
+	}
+
+	for (j = 0; j < N_SERVERS; j++) {
+		zassert_true(received[j] > 0, "server %d got nothing", j);
+		zassert_equal(close(servers[j]), 0, "close failed");
+	}
+
+	for (i = 0; i < N_CLIENTS; i++) {
+		zassert_equal(close(clients[i]), 0, "close failed");
+	}
+}
+
+void test_tcp_spread(void)
+{
+	int servers[N_SERVERS], clients[N_CLIENTS], accepted[N_CLIENTS];
+	struct zsock_pollfd pfds[N_SERVERS];
+	int counts[N_SERVERS] = { 0 };
+	struct sockaddr_in6 s_addr;
+	int i, j, res, total = 0;
+
+	for (i = 0; i < N_SERVERS; i++) {
+		servers[i] = server_sock(SOCK_STREAM, true);
+		zassert_true(servers[i] >= 0, "bind failed (%d)", errno);
+		zassert_equal(listen(servers[i], N_CLIENTS), 0,
+			      "listen failed (%d)", errno);
+		pfds[i].fd = servers[i];
+		pfds[i].events = POLLIN;
+	}
+
+	for (i = 0; i < N_CLIENTS; i++) {
+		clients[i] = client_sock(SOCK_STREAM, i, &s_addr);
+
+		res = connect(clients[i], (struct sockaddr *)&s_addr,
+			      sizeof(s_addr));
+		zassert_equal(res, 0, "connect failed (%d)", errno);
+	}
+
+	while (total < N_CLIENTS) {
+		res = poll(pfds, N_SERVERS, RX_TIMEOUT);
+		zassert_true(res > 0, "missing connections");
+
+		for (j = 0; j < N_SERVERS && total < N_CLIENTS; j++) {
+			if (!(pfds[j].revents & POLLIN)) {
+				continue;
+			}
+
+			accepted[total] = accept(servers[j], NULL, NULL);
+			zassert_true(accepted[total] >= 0, "accept failed");
+			counts[j]++;
+			total++;
+		}
+	}
+
+	for (j = 0; j < N_SERVERS; j++) {
+		zassert_true(counts[j] > 0, "server %d got nothing", j);
+	}
+
+	for (i = 0; i < N_CLIENTS; i++) {
+		zassert_equal(close(clients[i]), 0, "close failed");
+		zassert_equal(close(accepted[i]), 0, "close failed");
+	}
+
+	for (j = 0; j < N_SERVERS; j++) {
+		zassert_equal(close(servers[j]), 0, "close failed");
+	}
+
+	/* Let the connections terminate */
+	k_msleep(RX_TIMEOUT);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_reuseport,
+			 ztest_unit_test(test_udp_bind_conflict),
+			 ztest_unit_test(test_tcp_bind_conflict),
+			 ztest_unit_test(test_udp_spread),
+			 ztest_unit_test(test_tcp_spread));
+
+	ztest_run_test_suite(socket_reuseport);
+}
@@ -10,6 +10,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <ztest_assert.h>
 #include <fcntl.h>
 #include <net/socket.h>
+#include <net/net_pkt.h>
 
 #include "../../socket_helpers.h"
 
@@ -937,6 +938,78 @@ void test_socket_permission(void)
 #endif /* CONFIG_USERSPACE */
 }
 
+void test_v4_zc(void)
+{
+	/* Test zero-copy send and receive on a ipv4 stream socket. */
+	static uint8_t data[300], rx[sizeof(data)];
+	struct net_buf *frags = NULL;
+	struct sockaddr_in c_saddr;
+	struct sockaddr_in s_saddr;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	int c_sock, s_sock, new_sock;
+	size_t len, i;
+	ssize_t ret;
+
+	for (i = 0; i < sizeof(data); i++) {
+		data[i] = i;
+	}
+
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &c_sock, &c_saddr);
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &s_sock, &s_saddr);
+
+	test_bind(s_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_listen(s_sock);
+
+	test_connect(c_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_accept(s_sock, &new_sock, &addr, &addrlen);
+
+	for (len = 0; len < sizeof(data); ) {
+		struct net_buf *frag;
+
+		frag = net_pkt_get_reserve_tx_data(K_NO_WAIT);
+		zassert_not_null(frag, "cannot allocate buffer");
+
+		i = MIN(sizeof(data) - len, net_buf_tailroom(frag));
+		net_buf_add_mem(frag, data + len, i);
+		len += i;
+
+		if (frags) {
+			net_buf_frag_add(frags, frag);
+		} else {
+			frags = frag;
+		}
+	}
+
+	ret = zsock_send_zc(c_sock, frags, 0, NULL, 0);
+	zassert_equal(ret, sizeof(data), "send_zc failed (%d)", errno);
+
+	for (len = 0; len < sizeof(data); len += ret) {
+		ret = zsock_recv_zc(new_sock, &frags, 0, NULL, NULL);
+		zassert_true(ret > 0, "recv_zc failed (%d)", errno);
+		zassert_equal(net_buf_frags_len(frags), ret, "invalid length");
+		zassert_true(len + ret <= sizeof(rx), "too much data");
+
+		net_buf_linearize(rx + len, ret, frags, 0, ret);
+		zsock_recv_zc_release(frags);
+	}
+
+	zassert_mem_equal(rx, data, sizeof(data), "invalid data");
+
+	test_close(c_sock);
+
+	ret = zsock_recv_zc(new_sock, &frags, 0, NULL, NULL);
+	zassert_equal(ret, 0, "expected EOF");
+	zassert_is_null(frags, "no buffers expected");
+
+	test_close(new_sock);
+	test_close(s_sock);
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
 void test_main(void)
 {
 #ifdef CONFIG_USERSPACE
@@ -967,6 +1040,7 @@ void test_main(void)
 		ztest_unit_test(test_so_protocol),
 		ztest_unit_test(test_v4_so_rcvtimeo),
 		ztest_unit_test(test_v6_so_rcvtimeo),
+		ztest_unit_test(test_v4_zc),
 		ztest_unit_test(test_v4_msg_waitall),
 		ztest_unit_test(test_v6_msg_waitall),
 		ztest_user_unit_test(test_socket_permission)
@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_TC_LOG_LEVEL);
+
+#include <stdlib.h>
+#include <fcntl.h>
+#include <ztest_assert.h>
+
+#include <net/socket.h>
+#include <net/net_if.h>
+#include <net/net_mgmt.h>
+#include <net/net_stats.h>
+#include <net/dummy.h>
+
+#include "ipv6.h"
+#include "../../socket_helpers.h"
+
+/* A TCP bulk transfer and a UDP ping-pong share the TX queue in front of
+ * the test interface, which sends at LINK_RATE. The round trip time of the
+ * pings tells how long the packets wait behind the bulk data.
+ */
+
+/* Simulated link speed in kbit/s */
+#define LINK_RATE 4000
+
+#define BULK_PORT 4242
+#define ECHO_PORT 4243
+#define PING_PORT 4244
+
+/* CONFIG_NET_TC_TX_CODEL_TARGET, the default */
+#define TARGET_US 5000
+
+/* The 64 kB window takes some 130 ms to go through the link */
+#define BLOATED_US 100000
+
+/* Let the bulk transfer fill the queue before the pings start */
+#define WARMUP_MS 2000
+#define N_PINGS 50
+#define PING_INTERVAL_MS 20
+#define PING_LEN 32
+
+#define STACK_SIZE 2048
+#define THREAD_PRIO K_PRIO_PREEMPT(8)
+
+static K_THREAD_STACK_DEFINE(bulk_tx_stack, STACK_SIZE);
+static K_THREAD_STACK_DEFINE(bulk_rx_stack, STACK_SIZE);
+static K_THREAD_STACK_DEFINE(echo_stack, STACK_SIZE);
+static struct k_thread bulk_tx_thread;
+static struct k_thread bulk_rx_thread;
+static struct k_thread echo_thread;
+
+static uint8_t data[1024];
+static volatile bool stop;
+static size_t bulk_received;
+
+static void bulk_tx(void *p1, void *p2, void *p3)
+{
+	int sock = POINTER_TO_INT(p1);
+
+	/* The socket does not block, a blocking send would sleep for long
+	 * when the window is full and let the queue drain meanwhile.
+	 */
+	while (!stop) {
+		if (send(sock, data, sizeof(data), 0) < 0) {
+			if (errno != EAGAIN) {
+				break;
+			}
+
+			k_msleep(1);
+		}
+	}
+}
+
+static void bulk_rx(void *p1, void *p2, void *p3)
+{
+	int sock = POINTER_TO_INT(p1);
+	uint8_t buf[512];
+	ssize_t res;
+
+	while ((res = recv(sock, buf, sizeof(buf), 0)) > 0) {
+		bulk_received += res;
+	}
+}
+
+static void echo(void *p1, void *p2, void *p3)
+{
+	int sock = POINTER_TO_INT(p1);
+	struct sockaddr_in6 addr;
+	socklen_t addrlen;
+	uint8_t buf[PING_LEN];
+	ssize_t res;
+
+	while (1) {
+		addrlen = sizeof(addr);
+		res = recvfrom(sock, buf, sizeof(buf), 0,
+			       (struct sockaddr *)&addr, &addrlen);
+		if (res < 0) {
+			break;
+		}
+
+		(void)sendto(sock, buf, res, 0, (struct sockaddr *)&addr,
+			     addrlen);
+	}
+}
+
+static void start(struct k_thread *thread, k_thread_stack_t *stack,
+		  k_thread_entry_t entry, int sock)
+{
+	k_thread_create(thread, stack, STACK_SIZE, entry,
+			INT_TO_POINTER(sock), NULL, NULL, THREAD_PRIO, 0,
+			K_NO_WAIT);
+}
+
+static void bulk_start(int *client, int *accepted)
+{
+	struct sockaddr_in6 c_addr, s_addr;
+	int server, res;
+
+	prepare_sock_tcp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, BULK_PORT + 100,
+			    client, &c_addr);
+	prepare_sock_tcp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, BULK_PORT,
+			    &server, &s_addr);
+
+	res = bind(server, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed (%d)", errno);
+	res = listen(server, 1);
+	zassert_equal(res, 0, "listen failed (%d)", errno);
+
+	res = bind(*client, (struct sockaddr *)&c_addr, sizeof(c_addr));
+	zassert_equal(res, 0, "bind failed (%d)", errno);
+	res = connect(*client, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed (%d)", errno);
+
+	*accepted = accept(server, NULL, NULL);
+	zassert_true(*accepted >= 0, "accept failed (%d)", errno);
+	zassert_equal(close(server), 0, "close failed");
+
+	res = fcntl(*client, F_SETFL, O_NONBLOCK);
+	zassert_equal(res, 0, "fcntl failed (%d)", errno);
+
+	start(&bulk_rx_thread, bulk_rx_stack, bulk_rx, *accepted);
+	start(&bulk_tx_thread, bulk_tx_stack, bulk_tx, *client);
+}
+
+static int udp_sock(int port, struct sockaddr_in6 *addr)
+{
+	int sock, res;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, port, &sock, addr);
+
+	res = bind(sock, (struct sockaddr *)addr, sizeof(*addr));
+	zassert_equal(res, 0, "bind failed (%d)", errno);
+
+	return sock;
+}
+
+static int slow_link_dev_init(const struct device *dev)
+{
+	return 0;
+}
+
+static void slow_link_init(struct net_if *iface)
+{
+	/* RFC 7042, s.2.1.1. address to use in documentation */
+	net_if_set_link_addr(iface, "\x00\x00\x5e\x00\x53\x01", 6,
+			     NET_LINK_DUMMY);
+
+	/* No neighbor to resolve on the other end */
+	net_if_flag_set(iface, NET_IF_POINTOPOINT);
+}
+
+/* Like the loopback interface, but holding the sending thread for the time
+ * each packet takes on the link, so that the TX queue builds up like it
+ * does in front of a real network.
+ */
+static int slow_link_send(const struct device *dev, struct net_pkt *pkt)
+{
+	struct net_pkt *cloned;
+	struct in6_addr addr;
+
+	k_usleep(net_pkt_get_len(pkt) * 8U * 1000U / LINK_RATE);
+
+	/* Swap the addresses so that the receiving side accepts the packet */
+	net_ipaddr_copy(&addr, &NET_IPV6_HDR(pkt)->src);
+	net_ipaddr_copy(&NET_IPV6_HDR(pkt)->src, &NET_IPV6_HDR(pkt)->dst);
+	net_ipaddr_copy(&NET_IPV6_HDR(pkt)->dst, &addr);
+
+	/* The sent packet is released by the caller */
+	cloned = net_pkt_clone(pkt, K_MSEC(100));
+	if (!cloned) {
+		return -ENOMEM;
+	}
+
+	if (net_recv_data(net_pkt_iface(cloned), cloned) < 0) {
+		net_pkt_unref(cloned);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+static struct dummy_api slow_link_api = {
+	.iface_api.init = slow_link_init,
+	.send = slow_link_send,
+};
+
+NET_DEVICE_INIT(slow_link, "slow_link", slow_link_dev_init, NULL, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &slow_link_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), 536);
+
+static int cmp_u32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+void test_latency_under_load(void)
+{
+	struct sockaddr_in6 echo_addr, ping_addr;
+	uint32_t rtt[N_PINGS], start_time;
+	uint8_t buf[PING_LEN];
+	int client, accepted, echo_sock, ping_sock;
+	int i, res, lost = 0;
+	size_t received;
+	int64_t elapsed;
+
+	echo_sock = udp_sock(ECHO_PORT, &echo_addr);
+	ping_sock = udp_sock(PING_PORT, &ping_addr);
+	start(&echo_thread, echo_stack, echo, echo_sock);
+
+	res = setsockopt(ping_sock, SOL_SOCKET, SO_RCVTIMEO,
+			 &(struct timeval){ .tv_sec = 1 },
+			 sizeof(struct timeval));
+	zassert_equal(res, 0, "setsockopt failed (%d)", errno);
+
+	bulk_start(&client, &accepted);
+
+	k_msleep(WARMUP_MS);
+	received = bulk_received;
+	elapsed = k_uptime_get();
+
+	for (i = 0; i < N_PINGS; i++) {
+		start_time = k_cycle_get_32();
+
+		res = sendto(ping_sock, data, PING_LEN, 0,
+			     (struct sockaddr *)&echo_addr, sizeof(echo_addr));
+		zassert_equal(res, PING_LEN, "sendto failed (%d)", errno);
+
+		res = recv(ping_sock, buf, sizeof(buf), 0);
+		rtt[i] = k_cyc_to_us_floor32(k_cycle_get_32() - start_time);
+
+		if (res != PING_LEN) {
+			lost++;
+		}
+
+		k_msleep(PING_INTERVAL_MS);
+	}
+
+	received = bulk_received - received;
+	elapsed = k_uptime_get() - elapsed;
+
+	qsort(rtt, N_PINGS, sizeof(rtt[0]), cmp_u32);
+
+	TC_PRINT("ping rtt median %u us, max %u us, %d lost\n",
+		 rtt[N_PINGS / 2], rtt[N_PINGS - 1], lost);
+	TC_PRINT("bulk %u kbit/s over a %u kbit/s link\n",
+		 (uint32_t)(received * 8U / elapsed), LINK_RATE);
+
+	zassert_equal(lost, 0, "pings lost");
+	zassert_true(received * 8U / elapsed > LINK_RATE / 2,
+		     "bulk transfer held back");
+
+#if defined(CONFIG_NET_TC_TX_CODEL)
+	struct net_stats_tx_queue stats;
+
+	res = net_mgmt(NET_REQUEST_STATS_GET_TX_QUEUE, net_if_get_default(),
+		       &stats, sizeof(stats));
+	zassert_equal(res, 0, "Cannot get the statistics (%d)", res);
+
+	TC_PRINT("queue delay avg %u us, max %u us, %u codel drops, "
+		 "%u overlimit drops\n",
+		 (uint32_t)(stats.delay.sum / stats.delay.count),
+		 stats.delay_max, stats.codel_drop, stats.overlimit_drop);
+
+	zassert_true(stats.codel_drop > 0, "no drops");
+	zassert_equal(stats.overlimit_drop, 0, "queue full");
+
+	if (CONFIG_NET_TC_TX_CODEL_FLOWS > 1) {
+		/* The pings do not wait behind the bulk data */
+		zassert_true(rtt[N_PINGS / 2] < TARGET_US,
+			     "pings delayed");
+	} else {
+		/* The bulk transfer backs off */
+		zassert_true(rtt[N_PINGS / 2] < BLOATED_US / 2,
+			     "queue not kept short");
+	}
+#else
+	/* Without the queue management, the bulk data fills the queue */
+	zassert_true(rtt[N_PINGS / 2] > BLOATED_US, "no queue built up");
+#endif
+
+	stop = true;
+	zassert_equal(close(client), 0, "close failed");
+	k_msleep(100);
+	zassert_equal(close(accepted), 0, "close failed");
+	zassert_equal(close(echo_sock), 0, "close failed");
+	zassert_equal(close(ping_sock), 0, "close failed");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_tx_codel,
+			 ztest_unit_test(test_latency_under_load));
+
+	ztest_run_test_suite(socket_tx_codel);
+}
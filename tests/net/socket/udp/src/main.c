@@ -14,6 +14,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 
 #include <net/socket.h>
 #include <net/ethernet.h>
+#include <net/net_pkt.h>
 
 #include "ipv6.h"
 #include "../../socket_helpers.h"
@@ -1212,6 +1213,258 @@ void test_v6_msg_trunc(void)
 		       (struct sockaddr *)&server_addr, sizeof(server_addr));
 }
 
+#define MMSG_COUNT 3
+
+static void test_mmsg(int sock_c, int sock_s, struct sockaddr *addr_c,
+		      socklen_t addrlen_c, struct sockaddr *addr_s,
+		      socklen_t addrlen_s)
+{
+	static const char * const data[MMSG_COUNT] = {
+		TEST_STR_SMALL, TEST_STR2, TEST_STR_SMALL
+	};
+	struct mmsghdr msgs[MMSG_COUNT + 1];
+	struct iovec iov[MMSG_COUNT + 1][2];
+	struct sockaddr_in6 src[MMSG_COUNT + 1];
+	char buf[MMSG_COUNT + 1][2][16];
+	int rv, i;
+
+	rv = bind(sock_s, addr_s, addrlen_s);
+	zassert_equal(rv, 0, "server bind failed");
+
+	rv = bind(sock_c, addr_c, addrlen_c);
+	zassert_equal(rv, 0, "client bind failed");
+
+	/* Send all the datagrams with a single call */
+	memset(msgs, 0, sizeof(msgs));
+
+	for (i = 0; i < MMSG_COUNT; i++) {
+		iov[i][0].iov_base = (void *)data[i];
+		iov[i][0].iov_len = strlen(data[i]);
+
+		msgs[i].msg_hdr.msg_name = addr_s;
+		msgs[i].msg_hdr.msg_namelen = addrlen_s;
+		msgs[i].msg_hdr.msg_iov = iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	rv = sendmmsg(sock_c, msgs, MMSG_COUNT, 0);
+	zassert_equal(rv, MMSG_COUNT, "sendmmsg failed (%d)", errno);
+
+	for (i = 0; i < MMSG_COUNT; i++) {
+		zassert_equal(msgs[i].msg_len, strlen(data[i]),
+			      "invalid msg_len %d", i);
+	}
+
+	/* Receive them scattered over two buffers, the long one is
+	 * truncated. With MSG_WAITFORONE, the call returns once the
+	 * pending datagrams have been received.
+	 */
+	memset(msgs, 0, sizeof(msgs));
+	memset(buf, 0, sizeof(buf));
+
+	for (i = 0; i < MMSG_COUNT + 1; i++) {
+		iov[i][0].iov_base = buf[i][0];
+		iov[i][0].iov_len = 2;
+		iov[i][1].iov_base = buf[i][1];
+		iov[i][1].iov_len = sizeof(buf[i][1]);
+
+		msgs[i].msg_hdr.msg_name = &src[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(src[i]);
+		msgs[i].msg_hdr.msg_iov = iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 2;
+	}
+
+	k_msleep(100);
+
+	rv = recvmmsg(sock_s, msgs, MMSG_COUNT + 1, MSG_WAITFORONE);
+	zassert_equal(rv, MMSG_COUNT, "recvmmsg failed (%d)", errno);
+
+	for (i = 0; i < MMSG_COUNT; i++) {
+		size_t len = MIN(strlen(data[i]), 2 + sizeof(buf[i][1]));
+
+		zassert_equal(msgs[i].msg_len, len, "invalid msg_len %d", i);
+		zassert_mem_equal(buf[i][0], data[i], 2, "invalid data %d", i);
+		zassert_mem_equal(buf[i][1], data[i] + 2, len - 2,
+				  "invalid data %d", i);
+		zassert_equal(msgs[i].msg_hdr.msg_namelen, addrlen_c,
+			      "invalid msg_namelen %d", i);
+		zassert_equal(net_sin((struct sockaddr *)&src[i])->sin_port,
+			      net_sin(addr_c)->sin_port,
+			      "invalid source port %d", i);
+		zassert_equal(!!(msgs[i].msg_hdr.msg_flags & MSG_TRUNC),
+			      len < strlen(data[i]), "invalid MSG_TRUNC %d", i);
+	}
+
+	/* Nothing left */
+	rv = recvmmsg(sock_s, msgs, MMSG_COUNT, MSG_DONTWAIT);
+	zassert_equal(rv, -1, "recvmmsg should have failed");
+	zassert_equal(errno, EAGAIN, "incorrect errno value");
+
+	rv = close(sock_c);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(sock_s);
+	zassert_equal(rv, 0, "close failed");
+}
+
+void test_v4_mmsg(void)
+{
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, CLIENT_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	test_mmsg(client_sock, server_sock,
+		  (struct sockaddr *)&client_addr, sizeof(client_addr),
+		  (struct sockaddr *)&server_addr, sizeof(server_addr));
+}
+
+void test_v6_mmsg(void)
+{
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in6 client_addr;
+	struct sockaddr_in6 server_addr;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	test_mmsg(client_sock, server_sock,
+		  (struct sockaddr *)&client_addr, sizeof(client_addr),
+		  (struct sockaddr *)&server_addr, sizeof(server_addr));
+}
+
+static struct net_buf *zc_frags(const char *data, size_t len)
+{
+	struct net_buf *frags = NULL;
+
+	while (len > 0) {
+		struct net_buf *frag;
+		size_t frag_len;
+
+		frag = net_pkt_get_reserve_tx_data(K_NO_WAIT);
+		zassert_not_null(frag, "cannot allocate buffer");
+
+		frag_len = MIN(len, net_buf_tailroom(frag));
+		net_buf_add_mem(frag, data, frag_len);
+
+		if (frags) {
+			net_buf_frag_add(frags, frag);
+		} else {
+			frags = frag;
+		}
+
+		data += frag_len;
+		len -= frag_len;
+	}
+
+	return frags;
+}
+
+static void test_zc(int sock_c, int sock_s, struct sockaddr *addr_c,
+		    socklen_t addrlen_c, struct sockaddr *addr_s,
+		    socklen_t addrlen_s)
+{
+	struct sockaddr_in6 src;
+	socklen_t srclen = sizeof(src);
+	struct net_buf *frags;
+	int rv;
+
+	rv = bind(sock_s, addr_s, addrlen_s);
+	zassert_equal(rv, 0, "server bind failed");
+
+	rv = bind(sock_c, addr_c, addrlen_c);
+	zassert_equal(rv, 0, "client bind failed");
+
+	/* The datagram is sent straight from a chain of buffers */
+	frags = zc_frags(TEST_STR2, STRLEN(TEST_STR2));
+	zassert_not_null(frags->frags, "expected a chain of buffers");
+
+	rv = zsock_send_zc(sock_c, frags, 0, addr_s, addrlen_s);
+	zassert_equal(rv, STRLEN(TEST_STR2), "send_zc failed (%d)", errno);
+
+	/* And received without copying out of the stack buffers */
+	rv = zsock_recv_zc(sock_s, &frags, 0, (struct sockaddr *)&src,
+			   &srclen);
+	zassert_equal(rv, STRLEN(TEST_STR2), "recv_zc failed (%d)", errno);
+	zassert_not_null(frags, "no buffers received");
+	zassert_equal(net_buf_frags_len(frags), STRLEN(TEST_STR2),
+		      "invalid length");
+	zassert_equal(srclen, addrlen_c, "invalid addrlen");
+	zassert_equal(net_sin((struct sockaddr *)&src)->sin_port,
+		      net_sin(addr_c)->sin_port, "invalid source port");
+
+	memset(rx_buf, 0, sizeof(rx_buf));
+	net_buf_linearize(rx_buf, sizeof(rx_buf), frags, 0,
+			  STRLEN(TEST_STR2));
+	zassert_mem_equal(rx_buf, TEST_STR2, STRLEN(TEST_STR2),
+			  "invalid data");
+
+	zsock_recv_zc_release(frags);
+
+	/* A failed send leaves the buffers with the caller */
+	frags = zc_frags(TEST_STR_SMALL, STRLEN(TEST_STR_SMALL));
+
+	rv = zsock_send_zc(sock_c, frags, 0, addr_s, 1);
+	zassert_equal(rv, -1, "send_zc should have failed");
+	zassert_equal(errno, EINVAL, "incorrect errno value");
+	zassert_equal(frags->ref, 1, "buffer should still be owned");
+	zassert_is_null(frags->frags, "buffer should be untouched");
+
+	net_buf_unref(frags);
+
+	/* Nothing left */
+	rv = zsock_recv_zc(sock_s, &frags, MSG_DONTWAIT, NULL, NULL);
+	zassert_equal(rv, -1, "recv_zc should have failed");
+	zassert_equal(errno, EAGAIN, "incorrect errno value");
+	zassert_is_null(frags, "no buffers expected");
+
+	rv = close(sock_c);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(sock_s);
+	zassert_equal(rv, 0, "close failed");
+}
+
+void test_v4_zc(void)
+{
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, CLIENT_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	test_zc(client_sock, server_sock,
+		(struct sockaddr *)&client_addr, sizeof(client_addr),
+		(struct sockaddr *)&server_addr, sizeof(server_addr));
+}
+
+void test_v6_zc(void)
+{
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in6 client_addr;
+	struct sockaddr_in6 server_addr;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	test_zc(client_sock, server_sock,
+		(struct sockaddr *)&client_addr, sizeof(client_addr),
+		(struct sockaddr *)&server_addr, sizeof(server_addr));
+}
+
 void test_main(void)
 {
 	k_thread_system_pool_assign(k_current_get());
@@ -1242,7 +1495,13 @@ void test_main(void)
 			 ztest_unit_test(test_v6_sendmsg_with_txtime),
 			 ztest_user_unit_test(test_v6_sendmsg_with_txtime),
 			 ztest_unit_test(test_v4_msg_trunc),
-			 ztest_unit_test(test_v6_msg_trunc)
+			 ztest_unit_test(test_v6_msg_trunc),
+			 ztest_unit_test(test_v4_mmsg),
+			 ztest_user_unit_test(test_v4_mmsg),
+			 ztest_unit_test(test_v6_mmsg),
+			 ztest_user_unit_test(test_v6_mmsg),
+			 ztest_unit_test(test_v4_zc),
+			 ztest_unit_test(test_v6_zc)
 		);
 
 	ztest_run_test_suite(socket_udp);
@@ -30,7 +30,8 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_TCP_LOG_LEVEL);
 #include "ipv4.h"
 #include "ipv6.h"
 #include "tcp2.h"
-#include "tcp2_priv.h"
+#include "tcp_internal.h"
+#include "tcp2_cc.h"
 #include "net_stats.h"
 
 #include <ztest.h>
@@ -125,6 +126,9 @@ static void handle_syn_resend(void);
 static void handle_client_fin_wait_2_test(sa_family_t af, struct tcphdr *th);
 static void handle_client_closing_test(sa_family_t af, struct tcphdr *th);
 static void handle_server_recv_out_of_order(struct net_pkt *pkt);
+static void handle_client_cc_test(struct net_pkt *pkt, struct tcphdr *th);
+static size_t cc_peer_options(uint8_t flags, uint8_t *opts);
+static uint16_t cc_peer_window(uint8_t flags);
 
 static void verify_flags(struct tcphdr *th, uint8_t flags,
 			 const char *fun, int line)
@@ -189,7 +193,7 @@ NET_DEVICE_INIT(net_tcp_test, "net_tcp_test",
 		&net_tcp_context_data, NULL,
 		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
 		&net_tcp_if_api, DUMMY_L2,
-		NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), NET_IPV6_MTU);
 
 static void test_sem_give(void)
 {
@@ -213,6 +217,11 @@ static uint8_t tcp_options[20] = {
 	0x01, /* NOP */
 	0x03, 0x03, 0x07 /* Win scale*/ };
 
+/* Small segments so that the congestion window spans many of them */
+#define CC_MSS 100
+#define CC_WINDOW 1280
+#define CC_WSCALE 2
+
 static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 					      uint16_t src_port,
 					      uint16_t dst_port,
@@ -221,6 +230,7 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 					      size_t len)
 {
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
+	uint8_t cc_opts[TCPOPT_MAX_LEN];
 	struct net_pkt *pkt;
 	struct tcphdr *th;
 	uint8_t opts_len = 0;
@@ -228,6 +238,8 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 
 	if ((test_case_no == 4U) && (flags & SYN)) {
 		opts_len = sizeof(tcp_options);
+	} else if (test_case_no == 10U) {
+		opts_len = cc_peer_options(flags, cc_opts);
 	}
 
 	/* Allocate buffer */
@@ -262,14 +274,14 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 	th->th_sport = src_port;
 	th->th_dport = dst_port;
 
-	if ((test_case_no == 4U) && (flags & SYN)) {
-		th->th_off = 10U;
+	th->th_off = 5U + opts_len / 4U;
+	th->th_flags = flags;
+
+	if (test_case_no == 10U) {
+		th->th_win = htons(cc_peer_window(flags));
 	} else {
-		th->th_off = 5U;
+		th->th_win = NET_IPV6_MTU;
 	}
-
-	th->th_flags = flags;
-	th->th_win = NET_IPV6_MTU;
 	th->th_seq = htonl(seq);
 
 	if (ACK & flags) {
@@ -287,6 +299,11 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 		if (ret < 0) {
 			goto fail;
 		}
+	} else if (opts_len) {
+		ret = net_pkt_write(pkt, cc_opts, opts_len);
+		if (ret < 0) {
+			goto fail;
+		}
 	}
 
 	if (data && len) {
@@ -420,6 +437,9 @@ static int tester_send(const struct device *dev, struct net_pkt *pkt)
 	case 9:
 		handle_server_recv_out_of_order(pkt);
 		break;
+	case 10:
+		handle_client_cc_test(pkt, &th);
+		break;
 	default:
 		zassert_true(false, "Undefined test case");
 	}
@@ -1484,7 +1504,1358 @@ static void test_server_timeout_out_of_order_data(void)
 	net_tcp_put(ooo_ctx);
 }
 
-/** Test case main entry */
+/* Peer of the congestion control tests. In manual mode the test case
+ * sends the ACKs, otherwise the peer acknowledges every data segment
+ * itself, dropping every drop_every'th one to simulate a lossy link.
+ * With options the peer uses window scaling, timestamps and SACK.
+ */
+#define CC_OOO_MAX 16
+#define CC_SACK_MAX 3 /* Fit next to the timestamps */
+
+static struct {
+	uint16_t port;
+	uint32_t expected;
+	uint32_t snd_max;
+	uint32_t segs;
+	uint32_t acks;
+	uint32_t rexmits;
+	uint32_t rexmit_seq;
+	uint32_t drop_every;
+	uint32_t dropped;
+	bool options;
+	uint32_t tsval;
+	uint32_t ts_recent;
+	uint32_t ts_echo;
+	int sack_count;
+	struct tcp_sack_block sack[CC_SACK_MAX];
+	/* Options of the SYN sent by the stack */
+	uint16_t syn_mss;
+	int syn_wscale;
+	bool syn_sack_perm;
+	bool syn_ts;
+	/* SACK block of the last segment sent by the stack */
+	int rx_sack_count;
+	struct tcp_sack_block rx_sack;
+	int ooo_count;
+	struct {
+		uint32_t seq;
+		uint32_t len;
+	} ooo[CC_OOO_MAX];
+} cc_peer;
+
+/* MSS announced in the SYN of the peer */
+static uint16_t cc_syn_mss = CC_MSS;
+
+static size_t cc_peer_options(uint8_t flags, uint8_t *opts)
+{
+	size_t len = 0;
+	int i;
+
+	if (flags & SYN) {
+		opts[len++] = TCPOPT_MAXSEG;
+		opts[len++] = 4U;
+		UNALIGNED_PUT(htons(cc_syn_mss), (uint16_t *)(opts + len));
+		len += 2U;
+
+		if (!cc_peer.options) {
+			return len;
+		}
+
+		opts[len++] = TCPOPT_NOP;
+		opts[len++] = TCPOPT_WINDOW;
+		opts[len++] = 3U;
+		opts[len++] = CC_WSCALE;
+		opts[len++] = TCPOPT_SACK_PERM;
+		opts[len++] = 2U;
+	} else if (cc_peer.options) {
+		opts[len++] = TCPOPT_NOP;
+		opts[len++] = TCPOPT_NOP;
+	} else {
+		return 0;
+	}
+
+	opts[len++] = TCPOPT_TIMESTAMP;
+	opts[len++] = TCPOPT_TIMESTAMP_LEN;
+	cc_peer.tsval++;
+	UNALIGNED_PUT(htonl(cc_peer.tsval), (uint32_t *)(opts + len));
+	UNALIGNED_PUT(htonl(cc_peer.ts_recent), (uint32_t *)(opts + len + 4));
+	len += 8U;
+
+	if (cc_peer.sack_count == 0 || (flags & SYN)) {
+		return len;
+	}
+
+	opts[len++] = TCPOPT_NOP;
+	opts[len++] = TCPOPT_NOP;
+	opts[len++] = TCPOPT_SACK;
+	opts[len++] = 2U + cc_peer.sack_count * 8U;
+
+	for (i = 0; i < cc_peer.sack_count; i++) {
+		UNALIGNED_PUT(htonl(cc_peer.sack[i].left),
+			      (uint32_t *)(opts + len));
+		UNALIGNED_PUT(htonl(cc_peer.sack[i].right),
+			      (uint32_t *)(opts + len + 4));
+		len += 8U;
+	}
+
+	return len;
+}
+
+static uint16_t cc_peer_window(uint8_t flags)
+{
+	if (cc_peer.options && !(flags & SYN)) {
+		return CC_WINDOW >> CC_WSCALE;
+	}
+
+	return CC_WINDOW;
+}
+
+static void cc_peer_parse_options(struct net_pkt *pkt, struct tcphdr *th)
+{
+	uint8_t opts[TCPOPT_MAX_LEN];
+	int len = th->th_off * 4U - sizeof(struct tcphdr);
+	int i, opt_len;
+
+	cc_peer.rx_sack_count = 0;
+
+	if (len <= 0) {
+		return;
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt) +
+		     sizeof(struct tcphdr));
+	zassert_equal(net_pkt_read(pkt, opts, len), 0, "Cannot read options");
+	net_pkt_cursor_init(pkt);
+
+	for (i = 0; i < len; i += opt_len) {
+		if (opts[i] == TCPOPT_END) {
+			break;
+		}
+
+		if (opts[i] == TCPOPT_NOP) {
+			opt_len = 1;
+			continue;
+		}
+
+		opt_len = opts[i + 1];
+		zassert_true(opt_len >= 2 && i + opt_len <= len,
+			     "Invalid option %u length %d", opts[i], opt_len);
+
+		switch (opts[i]) {
+		case TCPOPT_MAXSEG:
+			cc_peer.syn_mss = ntohs(UNALIGNED_GET(
+				(uint16_t *)(opts + i + 2)));
+			break;
+		case TCPOPT_WINDOW:
+			cc_peer.syn_wscale = opts[i + 2];
+			break;
+		case TCPOPT_SACK_PERM:
+			cc_peer.syn_sack_perm = true;
+			break;
+		case TCPOPT_TIMESTAMP:
+			cc_peer.syn_ts |= (th->th_flags & SYN) != 0U;
+			cc_peer.ts_echo = ntohl(UNALIGNED_GET(
+				(uint32_t *)(opts + i + 6)));
+			cc_peer.ts_recent = ntohl(UNALIGNED_GET(
+				(uint32_t *)(opts + i + 2)));
+			break;
+		case TCPOPT_SACK:
+			cc_peer.rx_sack_count = (opt_len - 2) / 8;
+			cc_peer.rx_sack.left = ntohl(UNALIGNED_GET(
+				(uint32_t *)(opts + i + 2)));
+			cc_peer.rx_sack.right = ntohl(UNALIGNED_GET(
+				(uint32_t *)(opts + i + 6)));
+			break;
+		}
+	}
+}
+
+/* Report the queued out-of-order segments, coalesced */
+static void cc_peer_sack_from_ooo(void)
+{
+	struct tcp_sack_block *sack = cc_peer.sack;
+	uint32_t left, right;
+	int i, j;
+
+	cc_peer.sack_count = 0;
+
+	for (i = 0; i < cc_peer.ooo_count; i++) {
+		left = cc_peer.ooo[i].seq;
+		right = left + cc_peer.ooo[i].len;
+
+		for (j = 0; j < cc_peer.sack_count; j++) {
+			if (sack[j].right == left) {
+				sack[j].right = right;
+				break;
+			} else if (sack[j].left == right) {
+				sack[j].left = left;
+				break;
+			}
+		}
+
+		if (j == cc_peer.sack_count && j < CC_SACK_MAX) {
+			sack[j].left = left;
+			sack[j].right = right;
+			cc_peer.sack_count++;
+		}
+	}
+}
+
+static void cc_peer_receive(uint32_t data_seq, uint32_t len)
+{
+	bool found;
+	int i;
+
+	if (net_tcp_seq_greater(data_seq, cc_peer.expected)) {
+		for (i = 0; i < cc_peer.ooo_count; i++) {
+			if (cc_peer.ooo[i].seq == data_seq) {
+				return;
+			}
+		}
+
+		if (cc_peer.ooo_count < CC_OOO_MAX) {
+			cc_peer.ooo[cc_peer.ooo_count].seq = data_seq;
+			cc_peer.ooo[cc_peer.ooo_count].len = len;
+			cc_peer.ooo_count++;
+		}
+
+		return;
+	}
+
+	if (data_seq != cc_peer.expected) {
+		return;
+	}
+
+	cc_peer.expected += len;
+
+	/* Pull in the queued segments that are now in order */
+	do {
+		found = false;
+
+		for (i = 0; i < cc_peer.ooo_count; i++) {
+			if (net_tcp_seq_greater(cc_peer.ooo[i].seq,
+						cc_peer.expected)) {
+				continue;
+			}
+
+			if (net_tcp_seq_greater(cc_peer.ooo[i].seq +
+						cc_peer.ooo[i].len,
+						cc_peer.expected)) {
+				cc_peer.expected = cc_peer.ooo[i].seq +
+						   cc_peer.ooo[i].len;
+				found = true;
+			}
+
+			cc_peer.ooo[i] = cc_peer.ooo[--cc_peer.ooo_count];
+			i--;
+		}
+	} while (found);
+}
+
+static void handle_client_cc_test(struct net_pkt *pkt, struct tcphdr *th)
+{
+	uint32_t data_seq = ntohl(th->th_seq);
+	struct net_pkt *reply;
+	uint32_t len;
+	int ret;
+
+	len = net_pkt_get_len(pkt) - net_pkt_ip_hdr_len(pkt) -
+	      net_pkt_ip_opts_len(pkt) - th->th_off * 4U;
+
+	cc_peer_parse_options(pkt, th);
+
+	switch (t_state) {
+	case T_SYN:
+		test_verify_flags(th, SYN);
+		cc_peer.port = th->th_sport;
+		seq = 0U;
+		ack = data_seq + 1U;
+		reply = prepare_syn_ack_packet(AF_INET, htons(MY_PORT),
+					       cc_peer.port);
+		t_state = T_SYN_ACK;
+		break;
+	case T_SYN_ACK:
+		test_verify_flags(th, ACK);
+		seq++;
+		cc_peer.expected = ack;
+		cc_peer.snd_max = ack;
+		t_state = T_DATA;
+		test_sem_give();
+		return;
+	case T_DATA:
+		if (th->th_flags & FIN) {
+			ack = data_seq + len + 1U;
+			reply = prepare_fin_ack_packet(AF_INET, htons(MY_PORT),
+						       cc_peer.port);
+			t_state = T_FIN_ACK;
+			break;
+		}
+
+		if (len == 0U) {
+			cc_peer.acks++;
+			return;
+		}
+
+		cc_peer.segs++;
+
+		if (net_tcp_seq_greater(data_seq + len, cc_peer.snd_max)) {
+			cc_peer.snd_max = data_seq + len;
+		} else {
+			cc_peer.rexmits++;
+			cc_peer.rexmit_seq = data_seq;
+		}
+
+		if (cc_peer.drop_every == 0U) {
+			return;
+		}
+
+		if ((cc_peer.segs % cc_peer.drop_every) == 0U) {
+			cc_peer.dropped++;
+			return;
+		}
+
+		cc_peer_receive(data_seq, len);
+
+		if (cc_peer.options) {
+			cc_peer_sack_from_ooo();
+		}
+
+		ack = cc_peer.expected;
+		reply = prepare_ack_packet(AF_INET, htons(MY_PORT),
+					   cc_peer.port);
+		if (!reply) {
+			/* Same as a lost ACK */
+			return;
+		}
+		break;
+	case T_FIN_ACK:
+		test_verify_flags(th, ACK);
+		test_sem_give();
+		return;
+	default:
+		zassert_true(false, "%s unexpected state", __func__);
+		return;
+	}
+
+	ret = net_recv_data(iface, reply);
+	if (ret < 0) {
+		zassert_true(false, "%s failed", __func__);
+	}
+}
+
+static struct net_context *cc_connect(bool options)
+{
+	struct net_context *ctx;
+	int ret;
+
+	memset(&cc_peer, 0, sizeof(cc_peer));
+	cc_peer.options = options;
+	cc_peer.syn_wscale = -1;
+	t_state = T_SYN;
+	test_case_no = 10;
+	seq = ack = 0;
+
+	ret = net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &ctx);
+	if (ret < 0) {
+		zassert_true(false, "Failed to get net_context");
+	}
+
+	net_context_ref(ctx);
+
+	ret = net_context_connect(ctx, (struct sockaddr *)&peer_addr_s,
+				  sizeof(struct sockaddr_in),
+				  NULL,
+				  K_MSEC(100), NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to connect to peer");
+	}
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	return ctx;
+}
+
+static void cc_send(struct net_context *ctx, size_t len)
+{
+	size_t sent = 0;
+	int ret;
+
+	/* A packet carries at most one MTU worth of data */
+	while (sent < len) {
+		ret = net_context_send(ctx, lorem_ipsum + sent, len - sent,
+				       NULL, K_NO_WAIT, NULL);
+		zassert_true(ret > 0, "Failed to send data to peer (%d)", ret);
+		sent += ret;
+	}
+
+	/* Let the segments go out */
+	k_msleep(10);
+}
+
+static void cc_ack(uint32_t ack_seq)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	ack = ack_seq;
+
+	pkt = prepare_ack_packet(AF_INET, htons(MY_PORT), cc_peer.port);
+	zassert_not_null(pkt, "Cannot create pkt");
+
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "recv data failed (%d)", ret);
+
+	/* Let the stack process the ACK and send more */
+	k_msleep(5);
+}
+
+static void cc_ack_all(struct net_context *ctx)
+{
+	struct tcp *conn = ctx->tcp;
+	int i;
+
+	for (i = 0; i < 100 && conn->send_data_total > 0; i++) {
+		cc_ack(cc_peer.snd_max);
+	}
+
+	zassert_equal(conn->send_data_total, 0, "Data left unacked");
+	cc_peer.expected = cc_peer.snd_max;
+}
+
+static void cc_close(struct net_context *ctx)
+{
+	net_tcp_put(ctx);
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	k_sleep(K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY));
+
+	/* Drop the reference taken in cc_connect() */
+	net_context_unref(ctx);
+}
+
+static uint32_t cc_loss_ssthresh(uint32_t cwnd, uint32_t flight)
+{
+	if (IS_ENABLED(CONFIG_NET_TCP_CC_DEFAULT_CUBIC)) {
+		return MAX(cwnd * 7U / 10U, 2U * CC_MSS);
+	}
+
+	return MAX(flight / 2U, 2U * CC_MSS);
+}
+
+/* The initial window is four segments and every ACK of a full segment
+ * grows it by one segment in slow start.
+ */
+static void test_congestion_slow_start(void)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+	uint32_t start;
+	int i;
+
+	ctx = cc_connect(false);
+	conn = ctx->tcp;
+
+	zassert_equal(conn->cc.cwnd, 4U * CC_MSS, "Initial window %u",
+		      conn->cc.cwnd);
+
+	cc_send(ctx, 12U * CC_MSS);
+
+	zassert_equal(cc_peer.segs, 4, "Sent %u segments, expected 4",
+		      cc_peer.segs);
+
+	start = cc_peer.expected;
+
+	for (i = 1; i <= 4; i++) {
+		cc_ack(start + i * CC_MSS);
+	}
+
+	zassert_equal(conn->cc.cwnd, 8U * CC_MSS, "Window %u after slow start",
+		      conn->cc.cwnd);
+	zassert_equal(cc_peer.segs, 12, "Sent %u segments, expected 12",
+		      cc_peer.segs);
+	zassert_equal(cc_peer.rexmits, 0, "Unexpected retransmission");
+
+	cc_ack_all(ctx);
+	cc_close(ctx);
+}
+
+/* Three duplicate ACKs trigger a retransmission of the missing segment
+ * and fast recovery, the ACK of all data sent ends it.
+ */
+static void test_congestion_fast_retransmit(void)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+	uint32_t rexmit, ssthresh;
+	int i;
+
+	ctx = cc_connect(false);
+	conn = ctx->tcp;
+
+	cc_send(ctx, 8U * CC_MSS);
+
+	zassert_equal(cc_peer.segs, 4, "Sent %u segments, expected 4",
+		      cc_peer.segs);
+
+	ssthresh = cc_loss_ssthresh(conn->cc.cwnd, conn->unacked_len);
+	rexmit = GET_STAT(iface, tcp.rexmit);
+
+	/* The first segment is lost, the other three are duplicate ACKed */
+	for (i = 0; i < 2; i++) {
+		cc_ack(cc_peer.expected);
+	}
+
+	zassert_equal(cc_peer.rexmits, 0, "Retransmitted too early");
+
+	cc_ack(cc_peer.expected);
+
+	zassert_equal(cc_peer.rexmits, 1, "No fast retransmit");
+	zassert_equal(cc_peer.rexmit_seq, cc_peer.expected,
+		      "Wrong segment retransmitted");
+	zassert_equal(GET_STAT(iface, tcp.rexmit), rexmit + 1,
+		      "Retransmission not counted");
+	zassert_true(conn->cc.in_recovery, "Not in fast recovery");
+	zassert_equal(conn->cc.ssthresh, ssthresh, "ssthresh %u, expected %u",
+		      conn->cc.ssthresh, ssthresh);
+	zassert_equal(conn->cc.cwnd, ssthresh + 3U * CC_MSS,
+		      "Window %u not inflated", conn->cc.cwnd);
+
+	/* Acknowledging everything sent so far ends the recovery */
+	cc_ack(cc_peer.snd_max);
+
+	zassert_false(conn->cc.in_recovery, "Still in fast recovery");
+	zassert_true(conn->cc.cwnd <= ssthresh, "Window %u above ssthresh",
+		     conn->cc.cwnd);
+
+	cc_ack_all(ctx);
+	zassert_equal(cc_peer.rexmits, 1, "Unexpected retransmission");
+
+	cc_close(ctx);
+}
+
+/* A retransmission timeout collapses the window to one segment */
+static void test_congestion_rto(void)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+	uint32_t ssthresh;
+
+	ctx = cc_connect(false);
+	conn = ctx->tcp;
+
+	cc_send(ctx, 4U * CC_MSS);
+
+	ssthresh = cc_loss_ssthresh(conn->cc.cwnd, conn->unacked_len);
+
+	k_msleep(CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT + 50);
+
+	zassert_true(cc_peer.rexmits >= 1, "No retransmission");
+	zassert_equal(conn->cc.cwnd, CC_MSS, "Window %u after timeout",
+		      conn->cc.cwnd);
+	zassert_equal(conn->cc.ssthresh, ssthresh, "ssthresh %u, expected %u",
+		      conn->cc.ssthresh, ssthresh);
+
+	cc_ack_all(ctx);
+
+	zassert_equal(conn->cc.cwnd, 2U * CC_MSS, "Window %u after ACK",
+		      conn->cc.cwnd);
+
+	cc_close(ctx);
+}
+
+/* Bulk transfer over a link losing every twentieth segment */
+static void cc_lossy_transfer(bool options)
+{
+	const size_t total = 32 * 1024;
+	const size_t chunk = 256;
+	struct net_context *ctx;
+	struct tcp *conn;
+	uint32_t rexmit, start, end, elapsed;
+	size_t sent = 0;
+	int ret;
+
+	ctx = cc_connect(options);
+	conn = ctx->tcp;
+
+	rexmit = GET_STAT(iface, tcp.rexmit);
+	start = k_uptime_get_32();
+	end = cc_peer.expected + total;
+
+	cc_peer.drop_every = 20U;
+
+	while (sent < total) {
+		zassert_true(k_uptime_get_32() - start < 10 * MSEC_PER_SEC,
+			     "Transfer stalled at %zu bytes", sent);
+
+		ret = net_context_send(ctx, lorem_ipsum,
+				       MIN(chunk, total - sent), NULL,
+				       K_NO_WAIT, NULL);
+		if (ret == -EAGAIN || ret == -ENOBUFS || ret == -ENOMEM) {
+			k_msleep(1);
+			continue;
+		}
+
+		zassert_true(ret > 0, "Failed to send data to peer (%d)", ret);
+		sent += ret;
+	}
+
+	while (cc_peer.expected != end) {
+		zassert_true(k_uptime_get_32() - start < 10 * MSEC_PER_SEC,
+			     "Transfer did not complete");
+		k_msleep(1);
+	}
+
+	elapsed = MAX(k_uptime_get_32() - start, 1U);
+	rexmit = GET_STAT(iface, tcp.rexmit) - rexmit;
+
+	TC_PRINT("%s%s: %zu bytes in %u ms (%u kB/s), %u segments, "
+		 "%u dropped, %u retransmitted\n",
+		 conn->cc.ops->name, conn->sack_ok ? "+sack" : "", total,
+		 elapsed,
+		 (uint32_t)(total / elapsed), cc_peer.segs, cc_peer.dropped,
+		 rexmit);
+
+	zassert_true(rexmit >= cc_peer.dropped - 1U,
+		     "Lost segments not retransmitted");
+	zassert_true(rexmit < 2U * cc_peer.dropped,
+		     "Too many retransmissions (%u for %u lost)", rexmit,
+		     cc_peer.dropped);
+
+	cc_peer.drop_every = 0U;
+	cc_close(ctx);
+}
+
+static void test_congestion_lossy_link(void)
+{
+	cc_lossy_transfer(false);
+}
+
+static bool cc_options_enabled(void)
+{
+	return IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE) &&
+	       IS_ENABLED(CONFIG_NET_TCP_TIMESTAMPS) &&
+	       IS_ENABLED(CONFIG_NET_TCP_SACK);
+}
+
+/* The SYN offers all the options and the ones the peer also sent are
+ * used for the connection.
+ */
+static void test_options_negotiation(void)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+	uint32_t tsval;
+
+	if (!cc_options_enabled()) {
+		ztest_test_skip();
+		return;
+	}
+
+	ctx = cc_connect(true);
+	conn = ctx->tcp;
+
+	zassert_not_equal(cc_peer.syn_mss, 0, "No MSS in SYN");
+	zassert_equal(cc_peer.syn_wscale, 0, "Window scale %d in SYN",
+		      cc_peer.syn_wscale);
+	zassert_true(cc_peer.syn_sack_perm, "No SACK permitted in SYN");
+	zassert_true(cc_peer.syn_ts, "No timestamps in SYN");
+
+	zassert_true(conn->wscale_ok, "Window scaling not enabled");
+	zassert_equal(conn->snd_wscale, CC_WSCALE, "Send shift %u",
+		      conn->snd_wscale);
+	zassert_equal(conn->rcv_wscale, 0, "Receive shift %u",
+		      conn->rcv_wscale);
+	zassert_true(conn->ts_ok, "Timestamps not enabled");
+	zassert_true(conn->sack_ok, "SACK not enabled");
+	zassert_equal(conn_mss(conn), CC_MSS - TCPOPT_TIMESTAMP_SPACE,
+		      "MSS %u does not leave room for timestamps",
+		      conn_mss(conn));
+
+	/* The window of the peer is scaled */
+	cc_ack(cc_peer.expected);
+	zassert_equal(conn->send_win, CC_WINDOW, "Send window %u",
+		      conn->send_win);
+
+	/* Data segments echo the latest timestamp of the peer */
+	tsval = cc_peer.tsval;
+	cc_send(ctx, conn_mss(conn));
+	zassert_equal(cc_peer.segs, 1, "Sent %u segments", cc_peer.segs);
+	zassert_equal(cc_peer.ts_echo, tsval, "Echoed %u, expected %u",
+		      cc_peer.ts_echo, tsval);
+
+	/* And the ACK of it gives a round-trip time measurement */
+	conn->rtt = UINT32_MAX;
+	cc_ack_all(ctx);
+	zassert_true(conn->rtt < 100, "RTT %u ms", conn->rtt);
+
+	cc_close(ctx);
+}
+
+/* A zero MSS from the peer is raised to the minimum, the data still goes
+ * out in segments of that size.
+ */
+static void test_options_tiny_mss(void)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+
+	cc_syn_mss = 0U;
+	ctx = cc_connect(cc_options_enabled());
+	cc_syn_mss = CC_MSS;
+	conn = ctx->tcp;
+
+	zassert_equal(conn_mss(conn), TCP_MIN_MSS, "MSS %u", conn_mss(conn));
+	zassert_equal(conn->cc.cwnd, 4U * TCP_MIN_MSS, "Initial window %u",
+		      conn->cc.cwnd);
+
+	cc_send(ctx, 4U * TCP_MIN_MSS);
+	zassert_equal(cc_peer.snd_max - cc_peer.expected, 4U * TCP_MIN_MSS,
+		      "Sent %u bytes", cc_peer.snd_max - cc_peer.expected);
+
+	cc_ack_all(ctx);
+	cc_close(ctx);
+}
+
+/* Hook of the TCP stack to intercept the segments going out */
+extern int (*tcp_send_cb)(struct net_pkt *pkt);
+
+static int fail_send(struct net_pkt *pkt)
+{
+	net_pkt_unref(pkt);
+
+	return -EIO;
+}
+
+/* When the data cannot be sent, the caller still owns the buffers it
+ * gave to net_context_send_buf().
+ */
+static void test_send_buf_error(void)
+{
+	struct net_context *ctx;
+	struct net_buf *frags;
+	struct tcp *conn;
+	int ret;
+
+	ctx = cc_connect(false);
+
+	frags = net_pkt_get_reserve_tx_data(K_NO_WAIT);
+	zassert_not_null(frags, "Cannot allocate buffer");
+	net_buf_add_mem(frags, lorem_ipsum, 10U);
+
+	tcp_send_cb = fail_send;
+	ret = net_context_send_buf(ctx, frags, NULL, 0, NULL, K_NO_WAIT,
+				   NULL);
+	tcp_send_cb = NULL;
+
+	zassert_equal(ret, -EIO, "Send did not fail (%d)", ret);
+	zassert_equal(frags->ref, 1U, "Buffer reference %u", frags->ref);
+	zassert_equal(frags->len, 10U, "Buffer length %u", frags->len);
+
+	conn = ctx->tcp;
+	if (conn) {
+		zassert_is_null(conn->send_data->buffer, "Buffer still queued");
+		net_tcp_put(ctx);
+	}
+
+	net_buf_unref(frags);
+	net_context_unref(ctx);
+}
+
+/* Segments with an older timestamp than the last one are dropped */
+static void test_options_paws(void)
+{
+	struct net_context *ctx;
+	struct net_pkt *pkt;
+	struct tcp *conn;
+	uint32_t rcv_nxt, acks;
+	int ret;
+
+	if (!cc_options_enabled()) {
+		ztest_test_skip();
+		return;
+	}
+
+	ctx = cc_connect(true);
+	conn = ctx->tcp;
+	ctx->recv_cb = test_tcp_recv_cb;
+
+	rcv_nxt = conn->ack;
+	acks = cc_peer.acks;
+
+	/* A duplicate from the past */
+	cc_peer.tsval -= 1000U;
+	pkt = prepare_data_packet(AF_INET, htons(MY_PORT), cc_peer.port,
+				  lorem_ipsum, 10U);
+	zassert_not_null(pkt, "Cannot create pkt");
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "recv data failed (%d)", ret);
+	k_msleep(5);
+
+	zassert_equal(conn->ack, rcv_nxt, "Old segment accepted");
+	zassert_equal(cc_peer.acks, acks + 1U, "Old segment not acked");
+
+	/* The same data with a current timestamp */
+	cc_peer.tsval += 1000U;
+	pkt = prepare_data_packet(AF_INET, htons(MY_PORT), cc_peer.port,
+				  lorem_ipsum, 10U);
+	zassert_not_null(pkt, "Cannot create pkt");
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "recv data failed (%d)", ret);
+	k_msleep(5);
+
+	zassert_equal(conn->ack, rcv_nxt + 10U, "Segment not accepted");
+	seq += 10U;
+
+	cc_close(ctx);
+}
+
+/* An RST resets the connection whatever its timestamp */
+static void test_options_paws_rst(void)
+{
+	struct net_context *ctx;
+	struct net_pkt *pkt;
+	int rst_before, rsterr_before;
+	int ret;
+
+	if (!cc_options_enabled()) {
+		ztest_test_skip();
+		return;
+	}
+
+	ctx = cc_connect(true);
+
+	rst_before = GET_STAT(iface, tcp.rst);
+	rsterr_before = GET_STAT(iface, tcp.rsterr);
+
+	cc_peer.tsval -= 1000U;
+	pkt = prepare_rst_packet(AF_INET, htons(MY_PORT), cc_peer.port);
+	zassert_not_null(pkt, "Cannot create pkt");
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "recv data failed (%d)", ret);
+	k_msleep(5);
+
+	zassert_equal(GET_STAT(iface, tcp.rst), rst_before + 1,
+		      "RST with an old timestamp not accepted");
+	zassert_equal(GET_STAT(iface, tcp.rsterr), rsterr_before,
+		      "RST with an old timestamp rejected");
+	zassert_equal(cc_peer.acks, 0U, "RST acked");
+
+	net_tcp_put(ctx);
+	net_context_unref(ctx);
+}
+
+/* Out-of-order data is reported to the sender in a SACK block */
+static void test_options_sack_receive(void)
+{
+	struct net_context *ctx;
+	struct net_pkt *pkt;
+	struct tcp *conn;
+	uint32_t rcv_nxt;
+	int ret;
+
+	if (!cc_options_enabled() || CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT == 0) {
+		ztest_test_skip();
+		return;
+	}
+
+	ctx = cc_connect(true);
+	conn = ctx->tcp;
+	ctx->recv_cb = test_tcp_recv_cb;
+
+	rcv_nxt = conn->ack;
+
+	/* The first 10 bytes are lost */
+	seq = rcv_nxt + 10U;
+	pkt = prepare_data_packet(AF_INET, htons(MY_PORT), cc_peer.port,
+				  lorem_ipsum + 10, 10U);
+	zassert_not_null(pkt, "Cannot create pkt");
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "recv data failed (%d)", ret);
+	k_msleep(5);
+
+	zassert_equal(cc_peer.rx_sack_count, 1, "No SACK block in the ACK");
+	zassert_equal(cc_peer.rx_sack.left, rcv_nxt + 10U,
+		      "SACK block starts at %u", cc_peer.rx_sack.left);
+	zassert_equal(cc_peer.rx_sack.right, rcv_nxt + 20U,
+		      "SACK block ends at %u", cc_peer.rx_sack.right);
+
+	/* Filling the hole acks everything without SACK blocks */
+	seq = rcv_nxt;
+	pkt = prepare_data_packet(AF_INET, htons(MY_PORT), cc_peer.port,
+				  lorem_ipsum, 10U);
+	zassert_not_null(pkt, "Cannot create pkt");
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "recv data failed (%d)", ret);
+	k_msleep(5);
+
+	zassert_equal(conn->ack, rcv_nxt + 20U, "Queued data not acked");
+	zassert_equal(cc_peer.rx_sack_count, 0, "Unexpected SACK block");
+	seq += 20U;
+
+	cc_close(ctx);
+}
+
+/* Two segments of a window are lost, SACK lets the sender retransmit
+ * both of them in one round trip and nothing else.
+ */
+static void test_options_sack_recovery(void)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+	uint32_t s[14];
+	uint32_t mss;
+	int i;
+
+	if (!cc_options_enabled()) {
+		ztest_test_skip();
+		return;
+	}
+
+	ctx = cc_connect(true);
+	conn = ctx->tcp;
+	mss = conn_mss(conn);
+
+	/* s[i] is the start of the i'th segment, counting from 1 */
+	for (i = 1; i < ARRAY_SIZE(s); i++) {
+		s[i] = cc_peer.expected + (i - 1) * mss;
+	}
+
+	/* Slow start opens the window to segments 5 - 12 */
+	cc_send(ctx, 12U * mss);
+	for (i = 2; i <= 5; i++) {
+		cc_ack(s[i]);
+	}
+
+	zassert_equal(cc_peer.segs, 12, "Sent %u segments, expected 12",
+		      cc_peer.segs);
+
+	/* Segments 5 and 8 are lost */
+	cc_peer.sack_count = 1;
+	cc_peer.sack[0].left = s[6];
+	cc_peer.sack[0].right = s[7];
+	cc_ack(s[5]);
+
+	cc_peer.sack[0].right = s[8];
+	cc_ack(s[5]);
+
+	cc_peer.sack_count = 2;
+	cc_peer.sack[0].left = s[9];
+	cc_peer.sack[0].right = s[10];
+	cc_peer.sack[1].left = s[6];
+	cc_peer.sack[1].right = s[8];
+	cc_ack(s[5]);
+
+	zassert_true(conn->cc.in_recovery, "Not in fast recovery");
+	zassert_equal(cc_peer.rexmits, 1, "No fast retransmit");
+	zassert_equal(cc_peer.rexmit_seq, s[5], "Wrong segment retransmitted");
+
+	/* The next duplicate ACK retransmits the other hole */
+	cc_peer.sack[0].right = s[11];
+	cc_ack(s[5]);
+
+	zassert_equal(cc_peer.rexmits, 2, "Second hole not retransmitted");
+	zassert_equal(cc_peer.rexmit_seq, s[8], "Wrong segment retransmitted");
+
+	/* No more holes */
+	cc_peer.sack[0].right = s[13];
+	cc_ack(s[5]);
+
+	cc_peer.sack_count = 1;
+	cc_peer.sack[0].left = s[9];
+	cc_peer.sack[0].right = s[13];
+	cc_ack(s[8]);
+
+	zassert_equal(cc_peer.rexmits, 2, "Unneeded retransmission");
+
+	cc_peer.sack_count = 0;
+	cc_ack(s[13]);
+
+	zassert_false(conn->cc.in_recovery, "Still in fast recovery");
+	zassert_equal(conn->send_data_total, 0, "Data left unacked");
+	zassert_equal(cc_peer.rexmits, 2, "Unneeded retransmission");
+
+	cc_peer.expected = cc_peer.snd_max;
+	cc_close(ctx);
+}
+
+static void test_options_lossy_link(void)
+{
+	if (!cc_options_enabled()) {
+		ztest_test_skip();
+		return;
+	}
+
+	cc_lossy_transfer(true);
+}
+
+/** Test case main entry */
+/* The first RTT sample sets SRTT to it and RTTVAR to half of it */
+static void test_rtt_estimation(void)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+	uint32_t rtt;
+
+	ctx = cc_connect(false);
+	conn = ctx->tcp;
+
+	zassert_equal(conn->srtt, 0U, "RTT measured before sending data");
+	zassert_equal(conn->rto, CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT,
+		      "Initial RTO %u", conn->rto);
+
+	cc_send(ctx, CC_MSS);
+	k_msleep(40);
+	cc_ack(cc_peer.snd_max);
+
+	rtt = conn->rtt;
+	zassert_true(rtt >= 40U && rtt <= 100U, "RTT %u ms", rtt);
+	zassert_equal(conn->srtt >> 3, rtt, "SRTT %u, RTT %u",
+		      conn->srtt >> 3, rtt);
+	zassert_equal(conn->rto,
+		      CLAMP(3U * rtt, CONFIG_NET_TCP_MIN_RETRANSMISSION_TIMEOUT,
+			    CONFIG_NET_TCP_MAX_RETRANSMISSION_TIMEOUT),
+		      "RTO %u ms", conn->rto);
+
+	cc_close(ctx);
+}
+
+static uint32_t cc_wait_rexmits(uint32_t count, uint32_t timeout)
+{
+	uint32_t start = k_uptime_get_32();
+
+	while (cc_peer.rexmits < count &&
+	       k_uptime_get_32() - start < timeout) {
+		k_msleep(5);
+	}
+
+	zassert_equal(cc_peer.rexmits, count, "%u retransmissions, expected %u",
+		      cc_peer.rexmits, count);
+
+	return k_uptime_get_32() - start;
+}
+
+/* Every timeout doubles the RTO, and retransmitted data gives no RTT
+ * sample (Karn's algorithm).
+ */
+static void test_rto_backoff(void)
+{
+	const uint32_t rto = CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
+	struct net_context *ctx;
+	struct tcp *conn;
+	uint32_t timeouts, elapsed;
+
+	ctx = cc_connect(false);
+	conn = ctx->tcp;
+
+	timeouts = GET_STAT(iface, tcp.rto);
+
+	cc_send(ctx, CC_MSS);
+
+	/* cc_send() already waited 10 ms */
+	elapsed = cc_wait_rexmits(1, 2U * rto) + 10U;
+	zassert_true(elapsed >= rto - 20U && elapsed <= rto + 20U,
+		     "First retransmission after %u ms", elapsed);
+	zassert_equal(conn->rto, 2U * rto, "RTO %u after a timeout",
+		      conn->rto);
+
+	elapsed = cc_wait_rexmits(2, 4U * rto);
+	zassert_true(elapsed >= 2U * rto - 20U && elapsed <= 2U * rto + 20U,
+		     "Second retransmission after %u ms", elapsed);
+	zassert_equal(conn->rto, 4U * rto, "RTO %u after two timeouts",
+		      conn->rto);
+	zassert_equal(GET_STAT(iface, tcp.rto), timeouts + 2,
+		      "Timeouts not counted");
+
+	cc_ack_all(ctx);
+
+	zassert_equal(conn->srtt, 0U, "RTT sampled from retransmitted data");
+	zassert_equal(conn->rto, 4U * rto, "RTO %u not kept backed off",
+		      conn->rto);
+
+	/* Data sent for the first time is timed again */
+	cc_send(ctx, CC_MSS);
+	cc_ack_all(ctx);
+
+	zassert_not_equal(conn->srtt, 0U, "No RTT sample from new data");
+	zassert_true(conn->rto < 4U * rto, "RTO %u not recomputed",
+		     conn->rto);
+
+	cc_close(ctx);
+}
+
+/* The peer sends len bytes and acknowledges all the data it has seen */
+static void cc_peer_send(size_t len)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	ack = cc_peer.snd_max;
+
+	pkt = prepare_data_packet(AF_INET, htons(MY_PORT), cc_peer.port,
+				  lorem_ipsum, len);
+	zassert_not_null(pkt, "Cannot create pkt");
+
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "recv data failed (%d)", ret);
+
+	seq += len;
+
+	k_msleep(5);
+}
+
+/* Use up the ACKs sent without delay at the start of a connection */
+static void cc_quickacks_consume(struct tcp *conn)
+{
+	uint32_t acks;
+	int n = conn->quickacks;
+
+	zassert_true(n > 0, "No quick ACKs after connection setup");
+
+	while (n--) {
+		acks = cc_peer.acks;
+		cc_peer_send(10);
+		zassert_equal(cc_peer.acks, acks + 1, "Quick ACK not sent");
+	}
+
+	zassert_equal(conn->quickacks, 0, "Quick ACKs left");
+}
+
+/* ACKs of small segments are delayed, every second full-sized segment
+ * is acked at once.
+ */
+static void test_delayed_ack(void)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+	uint32_t acks;
+	uint16_t mss;
+	int i;
+
+	if (CONFIG_NET_TCP_DELAYED_ACK_TIMEOUT == 0) {
+		ztest_test_skip();
+		return;
+	}
+
+	ctx = cc_connect(false);
+	conn = ctx->tcp;
+	mss = net_tcp_get_recv_mss(conn);
+
+	cc_quickacks_consume(conn);
+
+	acks = cc_peer.acks;
+	cc_peer_send(10);
+
+	zassert_equal(cc_peer.acks, acks, "ACK not delayed");
+
+	k_msleep(CONFIG_NET_TCP_DELAYED_ACK_TIMEOUT + 20);
+
+	zassert_equal(cc_peer.acks, acks + 1, "Delayed ACK not sent");
+
+	acks = cc_peer.acks;
+	for (i = 0; i < 10; i++) {
+		cc_peer_send(mss);
+	}
+
+	zassert_equal(cc_peer.acks, acks + 5, "%u ACKs for 10 segments",
+		      cc_peer.acks - acks);
+
+	cc_close(ctx);
+}
+
+/* The response to a request carries the ACK of the request, no pure
+ * ACKs are sent.
+ */
+static void test_delayed_ack_piggyback(void)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+	uint32_t acks;
+	int i;
+
+	if (CONFIG_NET_TCP_DELAYED_ACK_TIMEOUT == 0) {
+		ztest_test_skip();
+		return;
+	}
+
+	ctx = cc_connect(false);
+	conn = ctx->tcp;
+
+	cc_quickacks_consume(conn);
+
+	acks = cc_peer.acks;
+
+	for (i = 0; i < 5; i++) {
+		cc_peer_send(10);
+		cc_send(ctx, 20);
+	}
+
+	k_msleep(CONFIG_NET_TCP_DELAYED_ACK_TIMEOUT + 20);
+
+	zassert_equal(cc_peer.segs, 5, "Sent %u segments, expected 5",
+		      cc_peer.segs);
+	zassert_equal(cc_peer.acks, acks, "%u pure ACKs sent",
+		      cc_peer.acks - acks);
+	zassert_equal(conn->rcv_unacked, 0, "Data left unacked");
+
+	cc_ack_all(ctx);
+	cc_close(ctx);
+}
+
+static void cc_recv_cb(struct net_context *context, struct net_pkt *pkt,
+		       union net_ip_header *ip_hdr,
+		       union net_proto_header *proto_hdr,
+		       int status, void *user_data)
+{
+	if (pkt) {
+		net_pkt_unref(pkt);
+	}
+}
+
+/* A gap in the received data is acked immediately once it is filled */
+static void test_delayed_ack_gap(void)
+{
+	const uint8_t *data = lorem_ipsum;
+	struct net_context *ctx;
+	struct net_pkt *pkt;
+	struct tcp *conn;
+	uint32_t acks;
+	int ret;
+
+	if (CONFIG_NET_TCP_DELAYED_ACK_TIMEOUT == 0 ||
+	    CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT == 0) {
+		ztest_test_skip();
+		return;
+	}
+
+	ctx = cc_connect(false);
+	conn = ctx->tcp;
+
+	ret = net_context_recv(ctx, cc_recv_cb, K_NO_WAIT, NULL);
+	zassert_equal(ret, 0, "Cannot set recv callback (%d)", ret);
+
+	cc_quickacks_consume(conn);
+
+	/* The first 10 bytes are lost */
+	seq += 10U;
+	pkt = prepare_data_packet(AF_INET, htons(MY_PORT), cc_peer.port,
+				  data + 10, 10U);
+	zassert_not_null(pkt, "Cannot create pkt");
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "recv data failed (%d)", ret);
+	seq -= 10U;
+	k_msleep(5);
+
+	zassert_true(conn->quickacks > 0, "Not in quick ACK mode");
+
+	acks = cc_peer.acks;
+	cc_peer_send(10);
+	seq += 10U;
+
+	zassert_equal(cc_peer.acks, acks + 1, "Gap not acked immediately");
+	zassert_equal(conn->ack, seq, "ACK %u, expected %u", conn->ack, seq);
+
+	cc_close(ctx);
+}
+
+static void cc_set_option(struct net_context *ctx,
+			  enum net_context_option option, int value)
+{
+	size_t len = sizeof(int);
+	int ret, got;
+
+	ret = net_context_set_option(ctx, option, &value, sizeof(value));
+	zassert_equal(ret, 0, "Cannot set option %d (%d)", option, ret);
+
+	ret = net_context_get_option(ctx, option, &got, &len);
+	zassert_equal(ret, 0, "Cannot get option %d (%d)", option, ret);
+	zassert_equal(len, sizeof(got), "Wrong option length");
+	zassert_equal(got, value, "Option %d is %d, expected %d", option,
+		      got, value);
+}
+
+/* Small segments are held back while data is unacked, unless
+ * TCP_NODELAY is set.
+ */
+static void test_nagle(void)
+{
+	struct net_context *ctx;
+	uint32_t start;
+	int i;
+
+	ctx = cc_connect(false);
+	start = cc_peer.snd_max;
+
+	for (i = 0; i < 5; i++) {
+		cc_send(ctx, 10);
+	}
+
+	zassert_equal(cc_peer.segs, 1, "Sent %u segments, expected 1",
+		      cc_peer.segs);
+
+	/* The ACK lets out everything held back in one segment */
+	cc_ack(cc_peer.snd_max);
+
+	zassert_equal(cc_peer.segs, 2, "Sent %u segments, expected 2",
+		      cc_peer.segs);
+	zassert_equal(cc_peer.snd_max - start, 50U, "Sent %u bytes",
+		      cc_peer.snd_max - start);
+
+	cc_ack_all(ctx);
+
+	cc_set_option(ctx, NET_OPT_TCP_NODELAY, 1);
+
+	for (i = 0; i < 5; i++) {
+		cc_send(ctx, 10);
+	}
+
+	zassert_equal(cc_peer.segs, 7, "Sent %u segments, expected 7",
+		      cc_peer.segs);
+
+	cc_ack_all(ctx);
+	cc_close(ctx);
+}
+
+/* With TCP_CORK only full-sized segments are sent until it is cleared */
+static void test_cork(void)
+{
+	struct net_context *ctx;
+	uint32_t start;
+	int i;
+
+	ctx = cc_connect(false);
+	start = cc_peer.snd_max;
+
+	cc_set_option(ctx, NET_OPT_TCP_CORK, 1);
+
+	for (i = 0; i < 3; i++) {
+		cc_send(ctx, 10);
+	}
+
+	zassert_equal(cc_peer.segs, 0, "Sent %u segments while corked",
+		      cc_peer.segs);
+
+	cc_send(ctx, CC_MSS);
+
+	zassert_equal(cc_peer.segs, 1, "Sent %u segments, expected 1",
+		      cc_peer.segs);
+	zassert_equal(cc_peer.snd_max - start, CC_MSS, "Sent %u bytes",
+		      cc_peer.snd_max - start);
+
+	cc_set_option(ctx, NET_OPT_TCP_CORK, 0);
+	k_msleep(5);
+
+	zassert_equal(cc_peer.segs, 2, "Sent %u segments, expected 2",
+		      cc_peer.segs);
+	zassert_equal(cc_peer.snd_max - start, CC_MSS + 30U, "Sent %u bytes",
+		      cc_peer.snd_max - start);
+
+	cc_ack_all(ctx);
+	cc_close(ctx);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_tcp_fn,
@@ -1499,7 +2870,26 @@ void test_main(void)
 			 ztest_unit_test(test_client_closing_ipv6),
 			 ztest_unit_test(test_client_invalid_rst),
 			 ztest_unit_test(test_server_recv_out_of_order_data),
-			 ztest_unit_test(test_server_timeout_out_of_order_data)
+			 ztest_unit_test(test_server_timeout_out_of_order_data),
+			 ztest_unit_test(test_congestion_slow_start),
+			 ztest_unit_test(test_congestion_fast_retransmit),
+			 ztest_unit_test(test_congestion_rto),
+			 ztest_unit_test(test_congestion_lossy_link),
+			 ztest_unit_test(test_send_buf_error),
+			 ztest_unit_test(test_options_negotiation),
+			 ztest_unit_test(test_options_tiny_mss),
+			 ztest_unit_test(test_options_paws),
+			 ztest_unit_test(test_options_paws_rst),
+			 ztest_unit_test(test_options_sack_receive),
+			 ztest_unit_test(test_options_sack_recovery),
+			 ztest_unit_test(test_options_lossy_link),
+			 ztest_unit_test(test_rtt_estimation),
+			 ztest_unit_test(test_rto_backoff),
+			 ztest_unit_test(test_delayed_ack),
+			 ztest_unit_test(test_delayed_ack_piggyback),
+			 ztest_unit_test(test_delayed_ack_gap),
+			 ztest_unit_test(test_nagle),
+			 ztest_unit_test(test_cork)
 			 );
 
 	ztest_run_test_suite(test_tcp_fn);
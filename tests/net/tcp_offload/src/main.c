@@ -0,0 +1,470 @@
+/* main.c - Application main entry point */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/printk.h>
+#include <sys/byteorder.h>
+#include <linker/sections.h>
+#include <random/rand32.h>
+
+#include <ztest.h>
+
+#include <net/ethernet.h>
+#include <net/dummy.h>
+#include <net/buf.h>
+#include <net/net_ip.h>
+#include <net/net_if.h>
+
+#define NET_LOG_ENABLED 1
+#include "net_private.h"
+
+#include "ipv4.h"
+#include "tcp_internal.h"
+
+static struct in_addr my_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+
+#define LOCAL_PORT 4242
+#define PEER_PORT 4343
+
+#define TCP_HDR_LEN sizeof(struct net_tcp_hdr)
+#define HDRS_LEN (sizeof(struct net_ipv4_hdr) + TCP_HDR_LEN)
+
+/* Payload of the packet we send, it needs four segments */
+#define SEND_MSS 500
+#define SEND_DATA_LEN (3 * SEND_MSS + 100)
+#define SEND_SEG_COUNT 4
+#define SEND_SEQ 1000U
+
+/* Payload of each segment sent by the peer */
+#define RECV_DATA_LEN 100
+#define RECV_SEQ 5000U
+
+#define MAX_SENT_PKTS 8
+
+#define WAIT_TIME K_SECONDS(1)
+
+#define ALLOC_TIMEOUT K_MSEC(500)
+
+static struct net_if *iface1;
+
+static struct net_pkt *sent_pkts[MAX_SENT_PKTS];
+static int sent_count;
+static struct k_sem wait_sent;
+
+static struct net_tcp_gro gro;
+
+struct net_if_test {
+	uint8_t mac_addr[sizeof(struct net_eth_addr)];
+};
+
+static int net_iface_dev_init(const struct device *dev)
+{
+	return 0;
+}
+
+static uint8_t *net_iface_get_mac(const struct device *dev)
+{
+	struct net_if_test *data = dev->data;
+
+	if (data->mac_addr[2] == 0x00) {
+		/* 00-00-5E-00-53-xx Documentation RFC 7042 */
+		data->mac_addr[0] = 0x00;
+		data->mac_addr[1] = 0x00;
+		data->mac_addr[2] = 0x5E;
+		data->mac_addr[3] = 0x00;
+		data->mac_addr[4] = 0x53;
+		data->mac_addr[5] = sys_rand32_get();
+	}
+
+	return data->mac_addr;
+}
+
+static void net_iface_init(struct net_if *iface)
+{
+	uint8_t *mac = net_iface_get_mac(net_if_get_device(iface));
+
+	net_if_set_link_addr(iface, mac, sizeof(struct net_eth_addr),
+			     NET_LINK_ETHERNET);
+}
+
+/* Keep the sent packets so that the tests can verify them */
+static int sender_iface(const struct device *dev, struct net_pkt *pkt)
+{
+	if (!pkt->buffer) {
+		NET_DBG("No data to send!");
+		return -ENODATA;
+	}
+
+	if (sent_count >= MAX_SENT_PKTS) {
+		return 0;
+	}
+
+	/* The dummy L2 releases the packet once it has been sent */
+	sent_pkts[sent_count++] = net_pkt_ref(pkt);
+	k_sem_give(&wait_sent);
+
+	return 0;
+}
+
+static void release_sent_pkts(void)
+{
+	int i;
+
+	for (i = 0; i < sent_count; i++) {
+		net_pkt_unref(sent_pkts[i]);
+		sent_pkts[i] = NULL;
+	}
+
+	sent_count = 0;
+	k_sem_reset(&wait_sent);
+}
+
+struct net_if_test net_iface1_data;
+
+static struct dummy_api net_iface_api = {
+	.iface_api.init = net_iface_init,
+	.send = sender_iface,
+};
+
+NET_DEVICE_INIT_INSTANCE(net_iface1_test,
+			 "iface1",
+			 iface1,
+			 net_iface_dev_init,
+			 NULL,
+			 &net_iface1_data,
+			 NULL,
+			 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+			 &net_iface_api,
+			 DUMMY_L2,
+			 NET_L2_GET_CTX_TYPE(DUMMY_L2),
+			 127);
+
+static void tcp_hdr_init(struct net_tcp_hdr *hdr, uint16_t src_port,
+			 uint16_t dst_port, uint32_t seq, uint8_t flags)
+{
+	memset(hdr, 0, sizeof(*hdr));
+
+	hdr->src_port = htons(src_port);
+	hdr->dst_port = htons(dst_port);
+	sys_put_be32(seq, hdr->seq);
+	sys_put_be32(1U, hdr->ack);
+	hdr->offset = (TCP_HDR_LEN / 4U) << 4;
+	hdr->flags = flags;
+	hdr->wnd[0] = 0x10;
+}
+
+/* Create a segment sent by the peer, its payload bytes are the low byte
+ * of their sequence number.
+ */
+static struct net_pkt *create_segment(uint16_t src_port, uint32_t seq,
+				      uint8_t flags)
+{
+	struct net_ipv4_hdr hdr = { 0 };
+	struct net_tcp_hdr tcp_hdr;
+	struct net_pkt *pkt;
+	int i;
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface1, HDRS_LEN + RECV_DATA_LEN,
+					   AF_UNSPEC, 0, ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "Cannot allocate segment");
+
+	hdr.vhl = 0x45;
+	hdr.len = htons(HDRS_LEN + RECV_DATA_LEN);
+	hdr.offset[0] = NET_IPV4_DF << 5;
+	hdr.ttl = 64U;
+	hdr.proto = IPPROTO_TCP;
+	net_ipaddr_copy(&hdr.src, &peer_addr);
+	net_ipaddr_copy(&hdr.dst, &my_addr);
+
+	tcp_hdr_init(&tcp_hdr, src_port, LOCAL_PORT, seq, flags);
+
+	zassert_equal(net_pkt_write(pkt, &hdr, sizeof(hdr)), 0,
+		      "IPv4 header append failed");
+	zassert_equal(net_pkt_write(pkt, &tcp_hdr, sizeof(tcp_hdr)), 0,
+		      "TCP header append failed");
+
+	for (i = 0; i < RECV_DATA_LEN; i++) {
+		zassert_equal(net_pkt_write_u8(pkt, seq + i), 0,
+			      "Cannot write payload");
+	}
+
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(hdr));
+	net_pkt_set_ipv4_opts_len(pkt, 0);
+
+	NET_IPV4_HDR(pkt)->chksum = net_calc_chksum_ipv4(pkt);
+	((struct net_tcp_hdr *)(pkt->buffer->data + sizeof(hdr)))->chksum =
+		net_calc_chksum_tcp(pkt);
+
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_cursor_init(pkt);
+
+	return pkt;
+}
+
+static struct net_pkt *gro_recv(uint16_t src_port, uint32_t seq,
+				uint8_t flags, enum net_verdict expected)
+{
+	struct net_pkt *pkt = create_segment(src_port, seq, flags);
+	struct net_pkt *flush;
+	enum net_verdict verdict;
+
+	verdict = net_tcp_gro_receive(&gro, pkt, &flush);
+	zassert_equal(verdict, expected, "Unexpected verdict %d", verdict);
+
+	if (verdict != NET_OK) {
+		net_pkt_unref(pkt);
+	}
+
+	return flush;
+}
+
+/* Check a coalesced packet and release it */
+static void check_coalesced(struct net_pkt *pkt, uint32_t seq, int segs,
+			    uint8_t flags)
+{
+	size_t len = segs * RECV_DATA_LEN;
+	struct net_tcp_hdr *tcp_hdr;
+	uint8_t data;
+	int i;
+
+	zassert_not_null(pkt, "No coalesced packet");
+	zassert_true(net_pkt_is_tcp_gro(pkt), "Checksums not verified");
+	zassert_equal(net_pkt_get_len(pkt), HDRS_LEN + len,
+		      "Invalid length %zu", net_pkt_get_len(pkt));
+	zassert_equal(ntohs(NET_IPV4_HDR(pkt)->len), HDRS_LEN + len,
+		      "Invalid IPv4 length");
+	zassert_equal(net_calc_chksum_ipv4(pkt), 0,
+		      "Invalid IPv4 header checksum");
+
+	tcp_hdr = (struct net_tcp_hdr *)(pkt->buffer->data +
+					 sizeof(struct net_ipv4_hdr));
+	zassert_equal(sys_get_be32(tcp_hdr->seq), seq, "Invalid seq");
+	zassert_equal(tcp_hdr->flags, flags, "Invalid flags 0x%x",
+		      tcp_hdr->flags);
+
+	net_pkt_cursor_init(pkt);
+	zassert_equal(net_pkt_skip(pkt, HDRS_LEN), 0, "Cannot skip headers");
+
+	for (i = 0; i < len; i++) {
+		zassert_equal(net_pkt_read_u8(pkt, &data), 0,
+			      "Cannot read payload");
+		zassert_equal(data, (uint8_t)(seq + i),
+			      "Invalid payload at %d", i);
+	}
+
+	net_pkt_unref(pkt);
+}
+
+static void test_setup(void)
+{
+	struct net_if_addr *ifaddr;
+
+	k_sem_init(&wait_sent, 0, UINT_MAX);
+
+	iface1 = net_if_get_by_index(1);
+	zassert_not_null(iface1, "Interface 1");
+
+	ifaddr = net_if_ipv4_addr_add(iface1, &my_addr, NET_ADDR_MANUAL, 0);
+	zassert_not_null(ifaddr, "Cannot add IPv4 address");
+
+	net_if_up(iface1);
+}
+
+static void test_gso_segment(void)
+{
+	struct net_tcp_hdr tcp_hdr;
+	size_t total_len = 0;
+	struct net_pkt *pkt;
+	int ret, i;
+
+	/* Larger than the MTU, only TCP packets built for GSO may be */
+	pkt = net_pkt_alloc_with_buffer(iface1, TCP_HDR_LEN + SEND_DATA_LEN,
+					AF_INET, IPPROTO_TCP, ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "Cannot allocate packet");
+
+	ret = net_ipv4_create(pkt, &my_addr, &peer_addr);
+	zassert_equal(ret, 0, "Cannot create IPv4 header");
+
+	tcp_hdr_init(&tcp_hdr, LOCAL_PORT, PEER_PORT, SEND_SEQ, PSH | ACK);
+	zassert_equal(net_pkt_write(pkt, &tcp_hdr, sizeof(tcp_hdr)), 0,
+		      "Cannot create TCP header");
+
+	for (i = 0; i < SEND_DATA_LEN; i++) {
+		zassert_equal(net_pkt_write_u8(pkt, i), 0,
+			      "Cannot write payload");
+	}
+
+	net_pkt_set_gso_size(pkt, SEND_MSS);
+
+	net_pkt_cursor_init(pkt);
+	net_ipv4_finalize(pkt, IPPROTO_TCP);
+
+	ret = net_send_data(pkt);
+	zassert_equal(ret, 0, "Cannot send packet (%d)", ret);
+
+	for (i = 0; i < SEND_SEG_COUNT; i++) {
+		zassert_equal(k_sem_take(&wait_sent, WAIT_TIME), 0,
+			      "Segment %d not sent", i);
+	}
+
+	zassert_equal(sent_count, SEND_SEG_COUNT, "Invalid segment count");
+
+	for (i = 0; i < sent_count; i++) {
+		struct net_pkt *seg = sent_pkts[i];
+		struct net_tcp_hdr *hdr;
+		size_t payload_len = net_pkt_get_len(seg) - HDRS_LEN;
+		bool last = i == SEND_SEG_COUNT - 1;
+		uint8_t data;
+		int j;
+
+		hdr = (struct net_tcp_hdr *)(seg->buffer->data +
+					     sizeof(struct net_ipv4_hdr));
+
+		zassert_equal(net_pkt_gso_size(seg), 0,
+			      "Segment %d not split", i);
+		zassert_equal(ntohs(NET_IPV4_HDR(seg)->len),
+			      net_pkt_get_len(seg),
+			      "Invalid length in segment %d", i);
+		zassert_true(last || payload_len == SEND_MSS,
+			     "Invalid payload length in segment %d", i);
+		zassert_equal(sys_get_be32(hdr->seq), SEND_SEQ + total_len,
+			      "Invalid seq in segment %d", i);
+		zassert_equal(hdr->flags, last ? (PSH | ACK) : ACK,
+			      "Invalid flags in segment %d", i);
+		zassert_equal(net_calc_chksum_ipv4(seg), 0,
+			      "Invalid header checksum in segment %d", i);
+		zassert_equal(net_calc_chksum_tcp(seg), 0,
+			      "Invalid TCP checksum in segment %d", i);
+
+		net_pkt_set_overwrite(seg, true);
+		net_pkt_cursor_init(seg);
+		zassert_equal(net_pkt_skip(seg, HDRS_LEN), 0,
+			      "Cannot skip headers");
+
+		for (j = 0; j < payload_len; j++) {
+			zassert_equal(net_pkt_read_u8(seg, &data), 0,
+				      "Cannot read payload");
+			zassert_equal(data, (uint8_t)(total_len + j),
+				      "Invalid payload in segment %d", i);
+		}
+
+		total_len += payload_len;
+	}
+
+	zassert_equal(total_len, SEND_DATA_LEN, "Invalid total length");
+
+	release_sent_pkts();
+}
+
+static void test_gro_coalesce(void)
+{
+	zassert_is_null(gro_recv(PEER_PORT, RECV_SEQ, ACK, NET_OK),
+			"Segment 1 not held back");
+	zassert_is_null(gro_recv(PEER_PORT, RECV_SEQ + RECV_DATA_LEN, ACK,
+				 NET_OK), "Segment 2 not coalesced");
+	zassert_is_null(gro_recv(PEER_PORT, RECV_SEQ + 2 * RECV_DATA_LEN,
+				 PSH | ACK, NET_OK),
+			"Segment 3 not coalesced");
+
+	check_coalesced(net_tcp_gro_flush(&gro), RECV_SEQ, 3, PSH | ACK);
+	zassert_is_null(net_tcp_gro_flush(&gro), "Packet still held back");
+}
+
+static void test_gro_max_segs(void)
+{
+	struct net_pkt *flush;
+	int i;
+
+	for (i = 0; i < CONFIG_NET_TCP_GRO_MAX_SEGS - 1; i++) {
+		zassert_is_null(gro_recv(PEER_PORT,
+					 RECV_SEQ + i * RECV_DATA_LEN, ACK,
+					 NET_OK),
+				"Segment %d not coalesced", i);
+	}
+
+	flush = gro_recv(PEER_PORT, RECV_SEQ + i * RECV_DATA_LEN, ACK, NET_OK);
+	check_coalesced(flush, RECV_SEQ, CONFIG_NET_TCP_GRO_MAX_SEGS, ACK);
+	zassert_is_null(net_tcp_gro_flush(&gro), "Packet still held back");
+}
+
+static void test_gro_out_of_order(void)
+{
+	struct net_pkt *flush;
+
+	zassert_is_null(gro_recv(PEER_PORT, RECV_SEQ, ACK, NET_OK),
+			"Segment 1 not held back");
+
+	/* A gap, the held back segment has to go first */
+	flush = gro_recv(PEER_PORT, RECV_SEQ + 2 * RECV_DATA_LEN, ACK, NET_OK);
+	check_coalesced(flush, RECV_SEQ, 1, ACK);
+
+	check_coalesced(net_tcp_gro_flush(&gro),
+			RECV_SEQ + 2 * RECV_DATA_LEN, 1, ACK);
+}
+
+static void test_gro_other_flow(void)
+{
+	struct net_pkt *flush;
+
+	zassert_is_null(gro_recv(PEER_PORT, RECV_SEQ, ACK, NET_OK),
+			"Segment 1 not held back");
+
+	flush = gro_recv(PEER_PORT + 1, RECV_SEQ + RECV_DATA_LEN, ACK, NET_OK);
+	check_coalesced(flush, RECV_SEQ, 1, ACK);
+
+	check_coalesced(net_tcp_gro_flush(&gro), RECV_SEQ + RECV_DATA_LEN, 1,
+			ACK);
+}
+
+static void test_gro_not_eligible(void)
+{
+	struct net_pkt *pkt, *flush;
+
+	zassert_is_null(gro_recv(PEER_PORT, RECV_SEQ, ACK, NET_OK),
+			"Segment 1 not held back");
+
+	/* Passed up as is, after the held back one */
+	flush = gro_recv(PEER_PORT, RECV_SEQ + RECV_DATA_LEN, FIN | ACK,
+			 NET_CONTINUE);
+	check_coalesced(flush, RECV_SEQ, 1, ACK);
+
+	/* Same for a corrupted segment */
+	pkt = create_segment(PEER_PORT, RECV_SEQ, ACK);
+	pkt->buffer->data[pkt->buffer->len - 1] ^= 0xff;
+
+	zassert_equal(net_tcp_gro_receive(&gro, pkt, &flush), NET_CONTINUE,
+		      "Corrupted segment coalesced");
+	zassert_is_null(flush, "Nothing was held back");
+	zassert_false(net_pkt_is_tcp_gro(pkt), "Checksum marked as verified");
+
+	net_pkt_unref(pkt);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_tcp_offload_test,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_gso_segment),
+			 ztest_unit_test(test_gro_coalesce),
+			 ztest_unit_test(test_gro_max_segs),
+			 ztest_unit_test(test_gro_out_of_order),
+			 ztest_unit_test(test_gro_other_flow),
+			 ztest_unit_test(test_gro_not_eligible)
+			 );
+
+	ztest_run_test_suite(net_tcp_offload_test);
+}
@@ -494,19 +494,22 @@ void test_mode_size_str_with_2strings(void)
 			   1 /* accept one string pointer*/,
 			   domain, source, level,
 			   NULL, 0, TEST_STR, prefix, "sufix");
-	zassert_equal(mode, EXP_MODE(RUNTIME),
+	zassert_equal(mode, Z_LOG_MSG2_STATIC_STRINGS ?
+			EXP_MODE(FROM_STACK) : EXP_MODE(RUNTIME),
 			"Unexpected creation mode");
 	Z_LOG_MSG2_CREATE2(0, mode,
 			   1 /* accept one string pointer*/,
 			   domain, source, level,
 			   NULL, 0, TEST_STR, prefix, "sufix");
-	zassert_equal(mode, EXP_MODE(RUNTIME),
+	zassert_equal(mode, Z_LOG_MSG2_STATIC_STRINGS ?
+			EXP_MODE(FROM_STACK) : EXP_MODE(RUNTIME),
 			"Unexpected creation mode");
 
 	/* Calculate expected message length. Message consists of:
 	 * - header
 	 * - package: header + fmt pointer + 2 pointers (on some platforms
-	 *   strings are included in the package)
+	 *   strings are included in the package, format string is included
+	 *   only when it is packaged at runtime)
 	 *
 	 * Message size is rounded up to the required alignment.
 	 */
@@ -514,8 +517,10 @@ void test_mode_size_str_with_2strings(void)
 			 /* package */4 * sizeof(const char *);
 	if (TEST_LOG_MSG2_RW_STRINGS) {
 		exp_len += strlen("sufix") + 2 /* null + header */ +
-			  strlen(prefix) + 2 /* null + header */+
-			  strlen(TEST_STR) + 2 /* null + header */;
+			  strlen(prefix) + 2 /* null + header */;
+		if (mode == Z_LOG_MSG2_MODE_RUNTIME) {
+			exp_len += strlen(TEST_STR) + 2 /* null + header */;
+		}
 	}
 
 	exp_len = ROUND_UP(exp_len, Z_LOG_MSG2_ALIGNMENT) / sizeof(int);
@@ -524,6 +529,36 @@ void test_mode_size_str_with_2strings(void)
 	get_msg_validate_length(exp_len);
 }
 
+void test_mode_size_str_too_long(void)
+{
+	static const uint8_t domain = 3;
+	static const uint8_t level = 2;
+	const void *source = (const void *)123;
+	char str[Z_LOG_MSG2_MAX_PACKAGE_LEN + 1];
+	union log_msg2_generic *msg;
+	int mode;
+
+	if (!Z_LOG_MSG2_STATIC_STRINGS) {
+		ztest_test_skip();
+	}
+
+	test_init();
+	(void)z_log_dropped_read_and_clear();
+
+	memset(str, 'a', sizeof(str) - 1);
+	str[sizeof(str) - 1] = '\0';
+
+	/* Appended string does not fit in the package length field. */
+	Z_LOG_MSG2_CREATE2(1, mode, 0, domain, source, level,
+			   NULL, 0, "%s", str);
+	zassert_equal(mode, EXP_MODE(FROM_STACK), "Unexpected creation mode");
+	zassert_equal(z_log_dropped_read_and_clear(), 1,
+		      "Expected dropped message");
+
+	msg = z_log_msg2_claim();
+	zassert_equal(msg, NULL, "Expected no pending messages");
+}
+
 static log_timestamp_t timestamp_get_inc(void)
 {
 	return timestamp++;
@@ -616,6 +651,7 @@ void test_main(void)
 		ztest_unit_test(test_mode_size_data_only),
 		ztest_unit_test(test_mode_size_plain_str_data),
 		ztest_unit_test(test_mode_size_str_with_2strings),
+		ztest_unit_test(test_mode_size_str_too_long),
 		ztest_unit_test(test_saturate),
 		ztest_unit_test(test_log_msg2_put_trace),
 		ztest_unit_test(test_log_msg2_put_trace_ptr)
@@ -106,6 +106,10 @@
 #define PACKAGE_FLAGS CBPRINTF_PACKAGE_ADD_STRING_IDXS
 #endif
 
+#if (VIA_TWISTER & 0x4000) != 0
+#define CONFIG_CBPRINTF_FAST_CONVERSION 1
+#endif
+
 #endif /* VIA_TWISTER */
 
 /* Can't use IS_ENABLED on symbols that don't start with CONFIG_